@@ -387,6 +387,7 @@ let package = Package(
         "internal/platform/implementation/ios/Tests",
         "internal/platform/implementation/ios/Mediums/Ble/Sockets/Tests",
         "internal/platform/implementation/windows",
+        "internal/platform/implementation/linux",
         "third_party",
         "CONTRIBUTING.md",
         "LICENSE",
@@ -427,6 +428,8 @@ let package = Package(
         "connections/implementation/wifi_hotspot_test.cc",
         "connections/implementation/analytics/analytics_recorder_test.cc",
         "connections/implementation/analytics/throughput_recorder_test.cc",
+        "connections/implementation/analytics/link_quality_estimator_test.cc",
+        "connections/implementation/analytics/stage_histograms_test.cc",
         "connections/implementation/mediums/ble_v2_test.cc",
         "connections/implementation/mediums/ble_v2/bloom_filter_test.cc",
         "connections/implementation/mediums/ble_v2/ble_packet_test.cc",
@@ -453,6 +456,20 @@ let package = Package(
         "connections/implementation/pcp_manager_test.cc",
         "connections/implementation/ble_advertisement_test.cc",
         "connections/implementation/base_endpoint_channel_test.cc",
+        "connections/implementation/adaptive_chunk_sizer_test.cc",
+        "connections/implementation/block_delta_test.cc",
+        "connections/implementation/chunk_compression_test.cc",
+        "connections/implementation/chunk_read_ahead_test.cc",
+        "connections/implementation/chunk_write_behind_test.cc",
+        "connections/implementation/delta_basis_test.cc",
+        "connections/implementation/endpoint_reader_pool_test.cc",
+        "connections/implementation/endpoint_reader_pool_linux_test.cc",
+        "connections/implementation/fan_out_sender_test.cc",
+        "connections/implementation/frame_cipher_test.cc",
+        "connections/implementation/keep_alive_scheduler_test.cc",
+        "connections/implementation/payload_callback_queue_test.cc",
+        "connections/implementation/payload_scheduler_test.cc",
+        "connections/implementation/rcu_pointer_test.cc",
         "connections/core_test.cc",
         "connections/status_test.cc",
         "connections/payload_test.cc",
@@ -508,6 +525,11 @@ let package = Package(
         "internal/platform/bluetooth_adapter_test.cc",
         "internal/platform/byte_utils_test.cc",
         "internal/platform/direct_executor_test.cc",
+        // benchmarks
+        "connections/implementation/base_endpoint_channel_benchmark.cc",
+        "connections/implementation/chunk_compression_benchmark.cc",
+        "connections/implementation/endpoint_reader_pool_benchmark.cc",
+        "connections/implementation/mediums/ble_v2/discovered_peripheral_tracker_benchmark.cc",
         // simulation
         "connections/implementation/offline_simulation_user.cc",
         "connections/implementation/simulation_user.cc",
@@ -536,6 +558,9 @@ let package = Package(
         .headerSearchPath("compiled_proto/"),
         .define("NO_WEBRTC"),
         .define("NEARBY_SWIFTPM"),
+      ],
+      linkerSettings: [
+        .linkedLibrary("z"),
       ]
     ),
     .target(
@@ -77,7 +77,11 @@ constexpr ConnectionResponseFrame::ConnectionResponseFrame(
   : handshake_data_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , status_(0)
   , response_(0)
-{}
+
+  , supports_aead_frame_cipher_(false)
+  , supports_payload_compression_(false)
+  , supports_delta_transfer_(false)
+  , supports_chunked_bytes_payloads_(false){}
 struct ConnectionResponseFrameDefaultTypeInternal {
   constexpr ConnectionResponseFrameDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -119,9 +123,23 @@ struct PayloadTransferFrame_PayloadChunkDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_PayloadChunkDefaultTypeInternal _PayloadTransferFrame_PayloadChunk_default_instance_;
+constexpr PayloadTransferFrame_BlockSignatures::PayloadTransferFrame_BlockSignatures(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : blocks_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , block_size_(0){}
+struct PayloadTransferFrame_BlockSignaturesDefaultTypeInternal {
+  constexpr PayloadTransferFrame_BlockSignaturesDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~PayloadTransferFrame_BlockSignaturesDefaultTypeInternal() {}
+  union {
+    PayloadTransferFrame_BlockSignatures _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_BlockSignaturesDefaultTypeInternal _PayloadTransferFrame_BlockSignatures_default_instance_;
 constexpr PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
-  : offset_(int64_t{0})
+  : block_signatures_(nullptr)
+  , offset_(int64_t{0})
   , event_(0)
 {}
 struct PayloadTransferFrame_ControlMessageDefaultTypeInternal {
@@ -257,7 +275,8 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT BandwidthUpgradeNegotiationFram
 constexpr BandwidthUpgradeNegotiationFrame_ClientIntroduction::BandwidthUpgradeNegotiationFrame_ClientIntroduction(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : endpoint_id_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
-  , supports_disabling_encryption_(false){}
+  , supports_disabling_encryption_(false)
+  , supports_make_before_break_(false){}
 struct BandwidthUpgradeNegotiationFrame_ClientIntroductionDefaultTypeInternal {
   constexpr BandwidthUpgradeNegotiationFrame_ClientIntroductionDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -268,7 +287,8 @@ struct BandwidthUpgradeNegotiationFrame_ClientIntroductionDefaultTypeInternal {
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT BandwidthUpgradeNegotiationFrame_ClientIntroductionDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_ClientIntroduction_default_instance_;
 constexpr BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck(
-  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized){}
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : supports_make_before_break_(false){}
 struct BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal {
   constexpr BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -278,11 +298,24 @@ struct BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_ClientIntroductionAck_default_instance_;
+constexpr BandwidthUpgradeNegotiationFrame_LastWriteInfo::BandwidthUpgradeNegotiationFrame_LastWriteInfo(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : make_before_break_(false){}
+struct BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal {
+  constexpr BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal() {}
+  union {
+    BandwidthUpgradeNegotiationFrame_LastWriteInfo _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_LastWriteInfo_default_instance_;
 constexpr BandwidthUpgradeNegotiationFrame::BandwidthUpgradeNegotiationFrame(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : upgrade_path_info_(nullptr)
   , client_introduction_(nullptr)
   , client_introduction_ack_(nullptr)
+  , last_write_info_(nullptr)
   , event_type_(0)
 {}
 struct BandwidthUpgradeNegotiationFrameDefaultTypeInternal {
@@ -830,23 +863,35 @@ constexpr int PayloadTransferFrame_PayloadHeader::PayloadType_ARRAYSIZE;
 bool PayloadTransferFrame_PayloadChunk_Flags_IsValid(int value) {
   switch (value) {
     case 1:
+    case 2:
+    case 4:
+    case 8:
       return true;
     default:
       return false;
   }
 }
 
-static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PayloadChunk_Flags_strings[1] = {};
+static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PayloadChunk_Flags_strings[4] = {};
 
 static const char PayloadTransferFrame_PayloadChunk_Flags_names[] =
-  "LAST_CHUNK";
+  "COMPRESSED"
+  "DELTA"
+  "LAST_CHUNK"
+  "MORE_CHUNKS";
 
 static const ::PROTOBUF_NAMESPACE_ID::internal::EnumEntry PayloadTransferFrame_PayloadChunk_Flags_entries[] = {
-  { {PayloadTransferFrame_PayloadChunk_Flags_names + 0, 10}, 1 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 0, 10}, 4 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 10, 5}, 8 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 15, 10}, 1 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 25, 11}, 2 },
 };
 
 static const int PayloadTransferFrame_PayloadChunk_Flags_entries_by_number[] = {
-  0, // 1 -> LAST_CHUNK
+  2, // 1 -> LAST_CHUNK
+  3, // 2 -> MORE_CHUNKS
+  0, // 4 -> COMPRESSED
+  1, // 8 -> DELTA
 };
 
 const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(
@@ -855,12 +900,12 @@ const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(
       ::PROTOBUF_NAMESPACE_ID::internal::InitializeEnumStrings(
           PayloadTransferFrame_PayloadChunk_Flags_entries,
           PayloadTransferFrame_PayloadChunk_Flags_entries_by_number,
-          1, PayloadTransferFrame_PayloadChunk_Flags_strings);
+          4, PayloadTransferFrame_PayloadChunk_Flags_strings);
   (void) dummy;
   int idx = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumName(
       PayloadTransferFrame_PayloadChunk_Flags_entries,
       PayloadTransferFrame_PayloadChunk_Flags_entries_by_number,
-      1, value);
+      4, value);
   return idx == -1 ? ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString() :
                      PayloadTransferFrame_PayloadChunk_Flags_strings[idx].get();
 }
@@ -868,7 +913,7 @@ bool PayloadTransferFrame_PayloadChunk_Flags_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_PayloadChunk_Flags* value) {
   int int_value;
   bool success = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumValue(
-      PayloadTransferFrame_PayloadChunk_Flags_entries, 1, name, &int_value);
+      PayloadTransferFrame_PayloadChunk_Flags_entries, 4, name, &int_value);
   if (success) {
     *value = static_cast<PayloadTransferFrame_PayloadChunk_Flags>(int_value);
   }
@@ -876,6 +921,9 @@ bool PayloadTransferFrame_PayloadChunk_Flags_Parse(
 }
 #if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::LAST_CHUNK;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::MORE_CHUNKS;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::COMPRESSED;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::DELTA;
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::Flags_MIN;
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::Flags_MAX;
 constexpr int PayloadTransferFrame_PayloadChunk::Flags_ARRAYSIZE;
@@ -885,29 +933,37 @@ bool PayloadTransferFrame_ControlMessage_EventType_IsValid(int value) {
     case 0:
     case 1:
     case 2:
+    case 3:
+    case 4:
       return true;
     default:
       return false;
   }
 }
 
-static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_ControlMessage_EventType_strings[3] = {};
+static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_ControlMessage_EventType_strings[5] = {};
 
 static const char PayloadTransferFrame_ControlMessage_EventType_names[] =
   "PAYLOAD_CANCELED"
+  "PAYLOAD_DELTA_OFFER"
+  "PAYLOAD_DELTA_SIGNATURES"
   "PAYLOAD_ERROR"
   "UNKNOWN_EVENT_TYPE";
 
 static const ::PROTOBUF_NAMESPACE_ID::internal::EnumEntry PayloadTransferFrame_ControlMessage_EventType_entries[] = {
   { {PayloadTransferFrame_ControlMessage_EventType_names + 0, 16}, 2 },
-  { {PayloadTransferFrame_ControlMessage_EventType_names + 16, 13}, 1 },
-  { {PayloadTransferFrame_ControlMessage_EventType_names + 29, 18}, 0 },
+  { {PayloadTransferFrame_ControlMessage_EventType_names + 16, 19}, 3 },
+  { {PayloadTransferFrame_ControlMessage_EventType_names + 35, 24}, 4 },
+  { {PayloadTransferFrame_ControlMessage_EventType_names + 59, 13}, 1 },
+  { {PayloadTransferFrame_ControlMessage_EventType_names + 72, 18}, 0 },
 };
 
 static const int PayloadTransferFrame_ControlMessage_EventType_entries_by_number[] = {
-  2, // 0 -> UNKNOWN_EVENT_TYPE
-  1, // 1 -> PAYLOAD_ERROR
+  4, // 0 -> UNKNOWN_EVENT_TYPE
+  3, // 1 -> PAYLOAD_ERROR
   0, // 2 -> PAYLOAD_CANCELED
+  1, // 3 -> PAYLOAD_DELTA_OFFER
+  2, // 4 -> PAYLOAD_DELTA_SIGNATURES
 };
 
 const std::string& PayloadTransferFrame_ControlMessage_EventType_Name(
@@ -916,12 +972,12 @@ const std::string& PayloadTransferFrame_ControlMessage_EventType_Name(
       ::PROTOBUF_NAMESPACE_ID::internal::InitializeEnumStrings(
           PayloadTransferFrame_ControlMessage_EventType_entries,
           PayloadTransferFrame_ControlMessage_EventType_entries_by_number,
-          3, PayloadTransferFrame_ControlMessage_EventType_strings);
+          5, PayloadTransferFrame_ControlMessage_EventType_strings);
   (void) dummy;
   int idx = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumName(
       PayloadTransferFrame_ControlMessage_EventType_entries,
       PayloadTransferFrame_ControlMessage_EventType_entries_by_number,
-      3, value);
+      5, value);
   return idx == -1 ? ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString() :
                      PayloadTransferFrame_ControlMessage_EventType_strings[idx].get();
 }
@@ -929,7 +985,7 @@ bool PayloadTransferFrame_ControlMessage_EventType_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_ControlMessage_EventType* value) {
   int int_value;
   bool success = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumValue(
-      PayloadTransferFrame_ControlMessage_EventType_entries, 3, name, &int_value);
+      PayloadTransferFrame_ControlMessage_EventType_entries, 5, name, &int_value);
   if (success) {
     *value = static_cast<PayloadTransferFrame_ControlMessage_EventType>(int_value);
   }
@@ -939,6 +995,8 @@ bool PayloadTransferFrame_ControlMessage_EventType_Parse(
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::UNKNOWN_EVENT_TYPE;
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::PAYLOAD_ERROR;
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::PAYLOAD_CANCELED;
+constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::PAYLOAD_DELTA_OFFER;
+constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::PAYLOAD_DELTA_SIGNATURES;
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::EventType_MIN;
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::EventType_MAX;
 constexpr int PayloadTransferFrame_ControlMessage::EventType_ARRAYSIZE;
@@ -2667,6 +2725,18 @@ class ConnectionResponseFrame::_Internal {
   static void set_has_response(HasBits* has_bits) {
     (*has_bits)[0] |= 4u;
   }
+  static void set_has_supports_aead_frame_cipher(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
+  }
+  static void set_has_supports_payload_compression(HasBits* has_bits) {
+    (*has_bits)[0] |= 16u;
+  }
+  static void set_has_supports_delta_transfer(HasBits* has_bits) {
+    (*has_bits)[0] |= 32u;
+  }
+  static void set_has_supports_chunked_bytes_payloads(HasBits* has_bits) {
+    (*has_bits)[0] |= 64u;
+  }
 };
 
 ConnectionResponseFrame::ConnectionResponseFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -2691,8 +2761,8 @@ ConnectionResponseFrame::ConnectionResponseFrame(const ConnectionResponseFrame&
       GetArenaForAllocation());
   }
   ::memcpy(&status_, &from.status_,
-    static_cast<size_t>(reinterpret_cast<char*>(&response_) -
-    reinterpret_cast<char*>(&status_)) + sizeof(response_));
+    static_cast<size_t>(reinterpret_cast<char*>(&supports_chunked_bytes_payloads_) -
+    reinterpret_cast<char*>(&status_)) + sizeof(supports_chunked_bytes_payloads_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.ConnectionResponseFrame)
 }
 
@@ -2703,8 +2773,8 @@ handshake_data_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStr
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
     reinterpret_cast<char*>(&status_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&response_) -
-    reinterpret_cast<char*>(&status_)) + sizeof(response_));
+    0, static_cast<size_t>(reinterpret_cast<char*>(&supports_chunked_bytes_payloads_) -
+    reinterpret_cast<char*>(&status_)) + sizeof(supports_chunked_bytes_payloads_));
 }
 
 ConnectionResponseFrame::~ConnectionResponseFrame() {
@@ -2739,10 +2809,10 @@ void ConnectionResponseFrame::Clear() {
   if (cached_has_bits & 0x00000001u) {
     handshake_data_.ClearNonDefaultToEmpty();
   }
-  if (cached_has_bits & 0x00000006u) {
+  if (cached_has_bits & 0x0000007eu) {
     ::memset(&status_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&response_) -
-        reinterpret_cast<char*>(&status_)) + sizeof(response_));
+        reinterpret_cast<char*>(&supports_chunked_bytes_payloads_) -
+        reinterpret_cast<char*>(&status_)) + sizeof(supports_chunked_bytes_payloads_));
   }
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
@@ -2786,6 +2856,42 @@ const char* ConnectionResponseFrame::_InternalParse(const char* ptr, ::PROTOBUF_
         } else
           goto handle_unusual;
         continue;
+      // optional bool supports_aead_frame_cipher = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _Internal::set_has_supports_aead_frame_cipher(&has_bits);
+          supports_aead_frame_cipher_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bool supports_payload_compression = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _Internal::set_has_supports_payload_compression(&has_bits);
+          supports_payload_compression_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bool supports_delta_transfer = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _Internal::set_has_supports_delta_transfer(&has_bits);
+          supports_delta_transfer_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bool supports_chunked_bytes_payloads = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _Internal::set_has_supports_chunked_bytes_payloads(&has_bits);
+          supports_chunked_bytes_payloads_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -2836,6 +2942,30 @@ uint8_t* ConnectionResponseFrame::_InternalSerialize(
       3, this->_internal_response(), target);
   }
 
+  // optional bool supports_aead_frame_cipher = 4;
+  if (cached_has_bits & 0x00000008u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(4, this->_internal_supports_aead_frame_cipher(), target);
+  }
+
+  // optional bool supports_payload_compression = 5;
+  if (cached_has_bits & 0x00000010u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(5, this->_internal_supports_payload_compression(), target);
+  }
+
+  // optional bool supports_delta_transfer = 6;
+  if (cached_has_bits & 0x00000020u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(6, this->_internal_supports_delta_transfer(), target);
+  }
+
+  // optional bool supports_chunked_bytes_payloads = 7;
+  if (cached_has_bits & 0x00000040u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(7, this->_internal_supports_chunked_bytes_payloads(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -2853,7 +2983,7 @@ size_t ConnectionResponseFrame::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000007u) {
+  if (cached_has_bits & 0x0000007fu) {
     // optional bytes handshake_data = 2;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -2872,6 +3002,26 @@ size_t ConnectionResponseFrame::ByteSizeLong() const {
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_response());
     }
 
+    // optional bool supports_aead_frame_cipher = 4;
+    if (cached_has_bits & 0x00000008u) {
+      total_size += 1 + 1;
+    }
+
+    // optional bool supports_payload_compression = 5;
+    if (cached_has_bits & 0x00000010u) {
+      total_size += 1 + 1;
+    }
+
+    // optional bool supports_delta_transfer = 6;
+    if (cached_has_bits & 0x00000020u) {
+      total_size += 1 + 1;
+    }
+
+    // optional bool supports_chunked_bytes_payloads = 7;
+    if (cached_has_bits & 0x00000040u) {
+      total_size += 1 + 1;
+    }
+
   }
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
@@ -2894,7 +3044,7 @@ void ConnectionResponseFrame::MergeFrom(const ConnectionResponseFrame& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x00000007u) {
+  if (cached_has_bits & 0x0000007fu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_handshake_data(from._internal_handshake_data());
     }
@@ -2904,6 +3054,18 @@ void ConnectionResponseFrame::MergeFrom(const ConnectionResponseFrame& from) {
     if (cached_has_bits & 0x00000004u) {
       response_ = from.response_;
     }
+    if (cached_has_bits & 0x00000008u) {
+      supports_aead_frame_cipher_ = from.supports_aead_frame_cipher_;
+    }
+    if (cached_has_bits & 0x00000010u) {
+      supports_payload_compression_ = from.supports_payload_compression_;
+    }
+    if (cached_has_bits & 0x00000020u) {
+      supports_delta_transfer_ = from.supports_delta_transfer_;
+    }
+    if (cached_has_bits & 0x00000040u) {
+      supports_chunked_bytes_payloads_ = from.supports_chunked_bytes_payloads_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
@@ -2932,8 +3094,8 @@ void ConnectionResponseFrame::InternalSwap(ConnectionResponseFrame* other) {
       &other->handshake_data_, rhs_arena
   );
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, response_)
-      + sizeof(ConnectionResponseFrame::response_)
+      PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, supports_chunked_bytes_payloads_)
+      + sizeof(ConnectionResponseFrame::supports_chunked_bytes_payloads_)
       - PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, status_)>(
           reinterpret_cast<char*>(&status_),
           reinterpret_cast<char*>(&other->status_));
@@ -3623,19 +3785,272 @@ std::string PayloadTransferFrame_PayloadChunk::GetTypeName() const {
 }
 
 
+// ===================================================================
+
+class PayloadTransferFrame_BlockSignatures::_Internal {
+ public:
+  using HasBits = decltype(std::declval<PayloadTransferFrame_BlockSignatures>()._has_bits_);
+  static void set_has_blocks(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_block_size(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+};
+
+PayloadTransferFrame_BlockSignatures::PayloadTransferFrame_BlockSignatures(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+}
+PayloadTransferFrame_BlockSignatures::PayloadTransferFrame_BlockSignatures(const PayloadTransferFrame_BlockSignatures& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  blocks_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    blocks_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_blocks()) {
+    blocks_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_blocks(), 
+      GetArenaForAllocation());
+  }
+  block_size_ = from.block_size_;
+  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+}
+
+inline void PayloadTransferFrame_BlockSignatures::SharedCtor() {
+blocks_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  blocks_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+block_size_ = 0;
+}
+
+PayloadTransferFrame_BlockSignatures::~PayloadTransferFrame_BlockSignatures() {
+  // @@protoc_insertion_point(destructor:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void PayloadTransferFrame_BlockSignatures::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  blocks_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+void PayloadTransferFrame_BlockSignatures::ArenaDtor(void* object) {
+  PayloadTransferFrame_BlockSignatures* _this = reinterpret_cast< PayloadTransferFrame_BlockSignatures* >(object);
+  (void)_this;
+}
+void PayloadTransferFrame_BlockSignatures::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void PayloadTransferFrame_BlockSignatures::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void PayloadTransferFrame_BlockSignatures::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    blocks_.ClearNonDefaultToEmpty();
+  }
+  block_size_ = 0;
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* PayloadTransferFrame_BlockSignatures::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional int32 block_size = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_block_size(&has_bits);
+          block_size_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bytes blocks = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_blocks();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* PayloadTransferFrame_BlockSignatures::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional int32 block_size = 1;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(1, this->_internal_block_size(), target);
+  }
+
+  // optional bytes blocks = 2;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_blocks(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  return target;
+}
+
+size_t PayloadTransferFrame_BlockSignatures::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    // optional bytes blocks = 2;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_blocks());
+    }
+
+    // optional int32 block_size = 1;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_block_size());
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void PayloadTransferFrame_BlockSignatures::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const PayloadTransferFrame_BlockSignatures*>(
+      &from));
+}
+
+void PayloadTransferFrame_BlockSignatures::MergeFrom(const PayloadTransferFrame_BlockSignatures& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      _internal_set_blocks(from._internal_blocks());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      block_size_ = from.block_size_;
+    }
+    _has_bits_[0] |= cached_has_bits;
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void PayloadTransferFrame_BlockSignatures::CopyFrom(const PayloadTransferFrame_BlockSignatures& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool PayloadTransferFrame_BlockSignatures::IsInitialized() const {
+  return true;
+}
+
+void PayloadTransferFrame_BlockSignatures::InternalSwap(PayloadTransferFrame_BlockSignatures* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &blocks_, lhs_arena,
+      &other->blocks_, rhs_arena
+  );
+  swap(block_size_, other->block_size_);
+}
+
+std::string PayloadTransferFrame_BlockSignatures::GetTypeName() const {
+  return "location.nearby.connections.PayloadTransferFrame.BlockSignatures";
+}
+
+
 // ===================================================================
 
 class PayloadTransferFrame_ControlMessage::_Internal {
  public:
   using HasBits = decltype(std::declval<PayloadTransferFrame_ControlMessage>()._has_bits_);
   static void set_has_event(HasBits* has_bits) {
-    (*has_bits)[0] |= 2u;
+    (*has_bits)[0] |= 4u;
   }
   static void set_has_offset(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures& block_signatures(const PayloadTransferFrame_ControlMessage* msg);
+  static void set_has_block_signatures(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
 };
 
+const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures&
+PayloadTransferFrame_ControlMessage::_Internal::block_signatures(const PayloadTransferFrame_ControlMessage* msg) {
+  return *msg->block_signatures_;
+}
 PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
@@ -3649,6 +4064,11 @@ PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(const P
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
       _has_bits_(from._has_bits_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  if (from._internal_has_block_signatures()) {
+    block_signatures_ = new ::location::nearby::connections::PayloadTransferFrame_BlockSignatures(*from.block_signatures_);
+  } else {
+    block_signatures_ = nullptr;
+  }
   ::memcpy(&offset_, &from.offset_,
     static_cast<size_t>(reinterpret_cast<char*>(&event_) -
     reinterpret_cast<char*>(&offset_)) + sizeof(event_));
@@ -3657,9 +4077,9 @@ PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(const P
 
 inline void PayloadTransferFrame_ControlMessage::SharedCtor() {
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
-    reinterpret_cast<char*>(&offset_) - reinterpret_cast<char*>(this)),
+    reinterpret_cast<char*>(&block_signatures_) - reinterpret_cast<char*>(this)),
     0, static_cast<size_t>(reinterpret_cast<char*>(&event_) -
-    reinterpret_cast<char*>(&offset_)) + sizeof(event_));
+    reinterpret_cast<char*>(&block_signatures_)) + sizeof(event_));
 }
 
 PayloadTransferFrame_ControlMessage::~PayloadTransferFrame_ControlMessage() {
@@ -3671,6 +4091,7 @@ PayloadTransferFrame_ControlMessage::~PayloadTransferFrame_ControlMessage() {
 
 inline void PayloadTransferFrame_ControlMessage::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (this != internal_default_instance()) delete block_signatures_;
 }
 
 void PayloadTransferFrame_ControlMessage::ArenaDtor(void* object) {
@@ -3690,7 +4111,11 @@ void PayloadTransferFrame_ControlMessage::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000001u) {
+    GOOGLE_DCHECK(block_signatures_ != nullptr);
+    block_signatures_->Clear();
+  }
+  if (cached_has_bits & 0x00000006u) {
     ::memset(&offset_, 0, static_cast<size_t>(
         reinterpret_cast<char*>(&event_) -
         reinterpret_cast<char*>(&offset_)) + sizeof(event_));
@@ -3728,6 +4153,14 @@ const char* PayloadTransferFrame_ControlMessage::_InternalParse(const char* ptr,
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.connections.PayloadTransferFrame.BlockSignatures block_signatures = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ctx->ParseMessage(_internal_mutable_block_signatures(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -3760,18 +4193,26 @@ uint8_t* PayloadTransferFrame_ControlMessage::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional .location.nearby.connections.PayloadTransferFrame.ControlMessage.EventType event = 1;
-  if (cached_has_bits & 0x00000002u) {
+  if (cached_has_bits & 0x00000004u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       1, this->_internal_event(), target);
   }
 
   // optional int64 offset = 2;
-  if (cached_has_bits & 0x00000001u) {
+  if (cached_has_bits & 0x00000002u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(2, this->_internal_offset(), target);
   }
 
+  // optional .location.nearby.connections.PayloadTransferFrame.BlockSignatures block_signatures = 3;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        3, _Internal::block_signatures(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -3789,14 +4230,21 @@ size_t PayloadTransferFrame_ControlMessage::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
-    // optional int64 offset = 2;
+  if (cached_has_bits & 0x00000007u) {
+    // optional .location.nearby.connections.PayloadTransferFrame.BlockSignatures block_signatures = 3;
     if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *block_signatures_);
+    }
+
+    // optional int64 offset = 2;
+    if (cached_has_bits & 0x00000002u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_offset());
     }
 
     // optional .location.nearby.connections.PayloadTransferFrame.ControlMessage.EventType event = 1;
-    if (cached_has_bits & 0x00000002u) {
+    if (cached_has_bits & 0x00000004u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_event());
     }
@@ -3823,11 +4271,14 @@ void PayloadTransferFrame_ControlMessage::MergeFrom(const PayloadTransferFrame_C
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
-      offset_ = from.offset_;
+      _internal_mutable_block_signatures()->::location::nearby::connections::PayloadTransferFrame_BlockSignatures::MergeFrom(from._internal_block_signatures());
     }
     if (cached_has_bits & 0x00000002u) {
+      offset_ = from.offset_;
+    }
+    if (cached_has_bits & 0x00000004u) {
       event_ = from.event_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -3853,9 +4304,9 @@ void PayloadTransferFrame_ControlMessage::InternalSwap(PayloadTransferFrame_Cont
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
       PROTOBUF_FIELD_OFFSET(PayloadTransferFrame_ControlMessage, event_)
       + sizeof(PayloadTransferFrame_ControlMessage::event_)
-      - PROTOBUF_FIELD_OFFSET(PayloadTransferFrame_ControlMessage, offset_)>(
-          reinterpret_cast<char*>(&offset_),
-          reinterpret_cast<char*>(&other->offset_));
+      - PROTOBUF_FIELD_OFFSET(PayloadTransferFrame_ControlMessage, block_signatures_)>(
+          reinterpret_cast<char*>(&block_signatures_),
+          reinterpret_cast<char*>(&other->block_signatures_));
 }
 
 std::string PayloadTransferFrame_ControlMessage::GetTypeName() const {
@@ -6544,6 +6995,9 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction::_Internal {
   static void set_has_supports_disabling_encryption(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
+  static void set_has_supports_make_before_break(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
 };
 
 BandwidthUpgradeNegotiationFrame_ClientIntroduction::BandwidthUpgradeNegotiationFrame_ClientIntroduction(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -6567,7 +7021,9 @@ BandwidthUpgradeNegotiationFrame_ClientIntroduction::BandwidthUpgradeNegotiation
     endpoint_id_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_endpoint_id(), 
       GetArenaForAllocation());
   }
-  supports_disabling_encryption_ = from.supports_disabling_encryption_;
+  ::memcpy(&supports_disabling_encryption_, &from.supports_disabling_encryption_,
+    static_cast<size_t>(reinterpret_cast<char*>(&supports_make_before_break_) -
+    reinterpret_cast<char*>(&supports_disabling_encryption_)) + sizeof(supports_make_before_break_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroduction)
 }
 
@@ -6576,7 +7032,10 @@ endpoint_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString
 #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
   endpoint_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-supports_disabling_encryption_ = false;
+::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
+    reinterpret_cast<char*>(&supports_disabling_encryption_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&supports_make_before_break_) -
+    reinterpret_cast<char*>(&supports_disabling_encryption_)) + sizeof(supports_make_before_break_));
 }
 
 BandwidthUpgradeNegotiationFrame_ClientIntroduction::~BandwidthUpgradeNegotiationFrame_ClientIntroduction() {
@@ -6611,7 +7070,9 @@ void BandwidthUpgradeNegotiationFrame_ClientIntroduction::Clear() {
   if (cached_has_bits & 0x00000001u) {
     endpoint_id_.ClearNonDefaultToEmpty();
   }
-  supports_disabling_encryption_ = false;
+  ::memset(&supports_disabling_encryption_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&supports_make_before_break_) -
+      reinterpret_cast<char*>(&supports_disabling_encryption_)) + sizeof(supports_make_before_break_));
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
@@ -6641,6 +7102,15 @@ const char* BandwidthUpgradeNegotiationFrame_ClientIntroduction::_InternalParse(
         } else
           goto handle_unusual;
         continue;
+      // optional bool supports_make_before_break = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_supports_make_before_break(&has_bits);
+          supports_make_before_break_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -6684,6 +7154,12 @@ uint8_t* BandwidthUpgradeNegotiationFrame_ClientIntroduction::_InternalSerialize
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(2, this->_internal_supports_disabling_encryption(), target);
   }
 
+  // optional bool supports_make_before_break = 3;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(3, this->_internal_supports_make_before_break(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -6701,7 +7177,7 @@ size_t BandwidthUpgradeNegotiationFrame_ClientIntroduction::ByteSizeLong() const
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     // optional string endpoint_id = 1;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -6714,6 +7190,11 @@ size_t BandwidthUpgradeNegotiationFrame_ClientIntroduction::ByteSizeLong() const
       total_size += 1 + 1;
     }
 
+    // optional bool supports_make_before_break = 3;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += 1 + 1;
+    }
+
   }
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
@@ -6736,13 +7217,16 @@ void BandwidthUpgradeNegotiationFrame_ClientIntroduction::MergeFrom(const Bandwi
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_endpoint_id(from._internal_endpoint_id());
     }
     if (cached_has_bits & 0x00000002u) {
       supports_disabling_encryption_ = from.supports_disabling_encryption_;
     }
+    if (cached_has_bits & 0x00000004u) {
+      supports_make_before_break_ = from.supports_make_before_break_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
@@ -6770,7 +7254,12 @@ void BandwidthUpgradeNegotiationFrame_ClientIntroduction::InternalSwap(Bandwidth
       &endpoint_id_, lhs_arena,
       &other->endpoint_id_, rhs_arena
   );
-  swap(supports_disabling_encryption_, other->supports_disabling_encryption_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(BandwidthUpgradeNegotiationFrame_ClientIntroduction, supports_make_before_break_)
+      + sizeof(BandwidthUpgradeNegotiationFrame_ClientIntroduction::supports_make_before_break_)
+      - PROTOBUF_FIELD_OFFSET(BandwidthUpgradeNegotiationFrame_ClientIntroduction, supports_disabling_encryption_)>(
+          reinterpret_cast<char*>(&supports_disabling_encryption_),
+          reinterpret_cast<char*>(&other->supports_disabling_encryption_));
 }
 
 std::string BandwidthUpgradeNegotiationFrame_ClientIntroduction::GetTypeName() const {
@@ -6782,6 +7271,10 @@ std::string BandwidthUpgradeNegotiationFrame_ClientIntroduction::GetTypeName() c
 
 class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_Internal {
  public:
+  using HasBits = decltype(std::declval<BandwidthUpgradeNegotiationFrame_ClientIntroductionAck>()._has_bits_);
+  static void set_has_supports_make_before_break(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
 };
 
 BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -6791,19 +7284,22 @@ BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::BandwidthUpgradeNegotiat
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
   }
-  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
 }
 BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck(const BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& from)
-  : ::PROTOBUF_NAMESPACE_ID::MessageLite() {
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
-  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  supports_make_before_break_ = from.supports_make_before_break_;
+  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
 }
 
 inline void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::SharedCtor() {
+supports_make_before_break_ = false;
 }
 
 BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::~BandwidthUpgradeNegotiationFrame_ClientIntroductionAck() {
-  // @@protoc_insertion_point(destructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  // @@protoc_insertion_point(destructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   if (GetArenaForAllocation() != nullptr) return;
   SharedDtor();
   _internal_metadata_.Delete<std::string>();
@@ -6824,19 +7320,36 @@ void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::SetCachedSize(int s
 }
 
 void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::Clear() {
-// @@protoc_insertion_point(message_clear_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+// @@protoc_insertion_point(message_clear_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  supports_make_before_break_ = false;
+  _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
 
 const char* BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
 #define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
   while (!ctx->Done(&ptr)) {
     uint32_t tag;
     ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional bool supports_make_before_break = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_supports_make_before_break(&has_bits);
+          supports_make_before_break_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
     if ((tag == 0) || ((tag & 7) == 4)) {
       CHK_(ptr);
       ctx->SetLastTag(tag);
@@ -6849,6 +7362,7 @@ const char* BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_InternalPar
     CHK_(ptr != nullptr);
   }  // while
 message_done:
+  _has_bits_.Or(has_bits);
   return ptr;
 failure:
   ptr = nullptr;
@@ -6858,26 +7372,39 @@ failure:
 
 uint8_t* BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_InternalSerialize(
     uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
-  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  cached_has_bits = _has_bits_[0];
+  // optional bool supports_make_before_break = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(1, this->_internal_supports_make_before_break(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
   }
-  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   return target;
 }
 
 size_t BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::ByteSizeLong() const {
-// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   size_t total_size = 0;
 
   uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // optional bool supports_make_before_break = 1;
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    total_size += 1 + 1;
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
   }
@@ -6893,16 +7420,19 @@ void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::CheckTypeAndMergeFr
 }
 
 void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::MergeFrom(const BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& from) {
-// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   GOOGLE_DCHECK_NE(&from, this);
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  if (from._internal_has_supports_make_before_break()) {
+    _internal_set_supports_make_before_break(from._internal_supports_make_before_break());
+  }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
 }
 
 void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::CopyFrom(const BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& from) {
-// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
   if (&from == this) return;
   Clear();
   MergeFrom(from);
@@ -6915,10 +7445,199 @@ bool BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::IsInitialized() con
 void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::InternalSwap(BandwidthUpgradeNegotiationFrame_ClientIntroductionAck* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  swap(supports_make_before_break_, other->supports_make_before_break_);
 }
 
 std::string BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::GetTypeName() const {
-  return "location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck";
+  return "location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck";
+}
+
+
+// ===================================================================
+
+class BandwidthUpgradeNegotiationFrame_LastWriteInfo::_Internal {
+ public:
+  using HasBits = decltype(std::declval<BandwidthUpgradeNegotiationFrame_LastWriteInfo>()._has_bits_);
+  static void set_has_make_before_break(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+};
+
+BandwidthUpgradeNegotiationFrame_LastWriteInfo::BandwidthUpgradeNegotiationFrame_LastWriteInfo(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+}
+BandwidthUpgradeNegotiationFrame_LastWriteInfo::BandwidthUpgradeNegotiationFrame_LastWriteInfo(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  make_before_break_ = from.make_before_break_;
+  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+}
+
+inline void BandwidthUpgradeNegotiationFrame_LastWriteInfo::SharedCtor() {
+make_before_break_ = false;
+}
+
+BandwidthUpgradeNegotiationFrame_LastWriteInfo::~BandwidthUpgradeNegotiationFrame_LastWriteInfo() {
+  // @@protoc_insertion_point(destructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void BandwidthUpgradeNegotiationFrame_LastWriteInfo::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::ArenaDtor(void* object) {
+  BandwidthUpgradeNegotiationFrame_LastWriteInfo* _this = reinterpret_cast< BandwidthUpgradeNegotiationFrame_LastWriteInfo* >(object);
+  (void)_this;
+}
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  make_before_break_ = false;
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* BandwidthUpgradeNegotiationFrame_LastWriteInfo::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional bool make_before_break = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_make_before_break(&has_bits);
+          make_before_break_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* BandwidthUpgradeNegotiationFrame_LastWriteInfo::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional bool make_before_break = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(1, this->_internal_make_before_break(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  return target;
+}
+
+size_t BandwidthUpgradeNegotiationFrame_LastWriteInfo::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // optional bool make_before_break = 1;
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    total_size += 1 + 1;
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const BandwidthUpgradeNegotiationFrame_LastWriteInfo*>(
+      &from));
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::MergeFrom(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  if (from._internal_has_make_before_break()) {
+    _internal_set_make_before_break(from._internal_make_before_break());
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::CopyFrom(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool BandwidthUpgradeNegotiationFrame_LastWriteInfo::IsInitialized() const {
+  return true;
+}
+
+void BandwidthUpgradeNegotiationFrame_LastWriteInfo::InternalSwap(BandwidthUpgradeNegotiationFrame_LastWriteInfo* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  swap(make_before_break_, other->make_before_break_);
+}
+
+std::string BandwidthUpgradeNegotiationFrame_LastWriteInfo::GetTypeName() const {
+  return "location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo";
 }
 
 
@@ -6928,7 +7647,7 @@ class BandwidthUpgradeNegotiationFrame::_Internal {
  public:
   using HasBits = decltype(std::declval<BandwidthUpgradeNegotiationFrame>()._has_bits_);
   static void set_has_event_type(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+    (*has_bits)[0] |= 16u;
   }
   static const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo& upgrade_path_info(const BandwidthUpgradeNegotiationFrame* msg);
   static void set_has_upgrade_path_info(HasBits* has_bits) {
@@ -6942,6 +7661,10 @@ class BandwidthUpgradeNegotiationFrame::_Internal {
   static void set_has_client_introduction_ack(HasBits* has_bits) {
     (*has_bits)[0] |= 4u;
   }
+  static const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo& last_write_info(const BandwidthUpgradeNegotiationFrame* msg);
+  static void set_has_last_write_info(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
+  }
 };
 
 const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo&
@@ -6956,6 +7679,10 @@ const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIn
 BandwidthUpgradeNegotiationFrame::_Internal::client_introduction_ack(const BandwidthUpgradeNegotiationFrame* msg) {
   return *msg->client_introduction_ack_;
 }
+const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo&
+BandwidthUpgradeNegotiationFrame::_Internal::last_write_info(const BandwidthUpgradeNegotiationFrame* msg) {
+  return *msg->last_write_info_;
+}
 BandwidthUpgradeNegotiationFrame::BandwidthUpgradeNegotiationFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
@@ -6984,6 +7711,11 @@ BandwidthUpgradeNegotiationFrame::BandwidthUpgradeNegotiationFrame(const Bandwid
   } else {
     client_introduction_ack_ = nullptr;
   }
+  if (from._internal_has_last_write_info()) {
+    last_write_info_ = new ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo(*from.last_write_info_);
+  } else {
+    last_write_info_ = nullptr;
+  }
   event_type_ = from.event_type_;
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.BandwidthUpgradeNegotiationFrame)
 }
@@ -7007,6 +7739,7 @@ inline void BandwidthUpgradeNegotiationFrame::SharedDtor() {
   if (this != internal_default_instance()) delete upgrade_path_info_;
   if (this != internal_default_instance()) delete client_introduction_;
   if (this != internal_default_instance()) delete client_introduction_ack_;
+  if (this != internal_default_instance()) delete last_write_info_;
 }
 
 void BandwidthUpgradeNegotiationFrame::ArenaDtor(void* object) {
@@ -7026,7 +7759,7 @@ void BandwidthUpgradeNegotiationFrame::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000007u) {
+  if (cached_has_bits & 0x0000000fu) {
     if (cached_has_bits & 0x00000001u) {
       GOOGLE_DCHECK(upgrade_path_info_ != nullptr);
       upgrade_path_info_->Clear();
@@ -7039,6 +7772,10 @@ void BandwidthUpgradeNegotiationFrame::Clear() {
       GOOGLE_DCHECK(client_introduction_ack_ != nullptr);
       client_introduction_ack_->Clear();
     }
+    if (cached_has_bits & 0x00000008u) {
+      GOOGLE_DCHECK(last_write_info_ != nullptr);
+      last_write_info_->Clear();
+    }
   }
   event_type_ = 0;
   _has_bits_.Clear();
@@ -7089,6 +7826,14 @@ const char* BandwidthUpgradeNegotiationFrame::_InternalParse(const char* ptr, ::
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.LastWriteInfo last_write_info = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr = ctx->ParseMessage(_internal_mutable_last_write_info(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -7121,7 +7866,7 @@ uint8_t* BandwidthUpgradeNegotiationFrame::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.EventType event_type = 1;
-  if (cached_has_bits & 0x00000008u) {
+  if (cached_has_bits & 0x00000010u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       1, this->_internal_event_type(), target);
@@ -7151,6 +7896,14 @@ uint8_t* BandwidthUpgradeNegotiationFrame::_InternalSerialize(
         4, _Internal::client_introduction_ack(this), target, stream);
   }
 
+  // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.LastWriteInfo last_write_info = 5;
+  if (cached_has_bits & 0x00000008u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        5, _Internal::last_write_info(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -7168,7 +7921,7 @@ size_t BandwidthUpgradeNegotiationFrame::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.UpgradePathInfo upgrade_path_info = 2;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -7190,8 +7943,15 @@ size_t BandwidthUpgradeNegotiationFrame::ByteSizeLong() const {
           *client_introduction_ack_);
     }
 
-    // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.EventType event_type = 1;
+    // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.LastWriteInfo last_write_info = 5;
     if (cached_has_bits & 0x00000008u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *last_write_info_);
+    }
+
+    // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.EventType event_type = 1;
+    if (cached_has_bits & 0x00000010u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_event_type());
     }
@@ -7218,7 +7978,7 @@ void BandwidthUpgradeNegotiationFrame::MergeFrom(const BandwidthUpgradeNegotiati
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_mutable_upgrade_path_info()->::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo::MergeFrom(from._internal_upgrade_path_info());
     }
@@ -7229,6 +7989,9 @@ void BandwidthUpgradeNegotiationFrame::MergeFrom(const BandwidthUpgradeNegotiati
       _internal_mutable_client_introduction_ack()->::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::MergeFrom(from._internal_client_introduction_ack());
     }
     if (cached_has_bits & 0x00000008u) {
+      _internal_mutable_last_write_info()->::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo::MergeFrom(from._internal_last_write_info());
+    }
+    if (cached_has_bits & 0x00000010u) {
       event_type_ = from.event_type_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -9782,6 +10545,9 @@ template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFra
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_PayloadChunk* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_PayloadChunk >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_PayloadChunk >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_BlockSignatures >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_BlockSignatures >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_ControlMessage* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_ControlMessage >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_ControlMessage >(arena);
 }
@@ -9806,6 +10572,9 @@ template<> PROTOBUF_NOINLINE ::location::nearby::connections::BandwidthUpgradeNe
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials* Arena::CreateMaybeMessage< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* Arena::CreateMaybeMessage< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo* Arena::CreateMaybeMessage< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo >(arena);
 }
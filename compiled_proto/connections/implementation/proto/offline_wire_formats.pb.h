@@ -45,7 +45,7 @@ struct TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fforma
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::AuxiliaryParseTableField aux[]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[29]
+  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[31]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
   static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
@@ -66,6 +66,9 @@ extern BandwidthUpgradeNegotiationFrame_ClientIntroductionDefaultTypeInternal _B
 class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck;
 struct BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal;
 extern BandwidthUpgradeNegotiationFrame_ClientIntroductionAckDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_ClientIntroductionAck_default_instance_;
+class BandwidthUpgradeNegotiationFrame_LastWriteInfo;
+struct BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal;
+extern BandwidthUpgradeNegotiationFrame_LastWriteInfoDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_LastWriteInfo_default_instance_;
 class BandwidthUpgradeNegotiationFrame_UpgradePathInfo;
 struct BandwidthUpgradeNegotiationFrame_UpgradePathInfoDefaultTypeInternal;
 extern BandwidthUpgradeNegotiationFrame_UpgradePathInfoDefaultTypeInternal _BandwidthUpgradeNegotiationFrame_UpgradePathInfo_default_instance_;
@@ -117,6 +120,9 @@ extern PairedKeyEncryptionFrameDefaultTypeInternal _PairedKeyEncryptionFrame_def
 class PayloadTransferFrame;
 struct PayloadTransferFrameDefaultTypeInternal;
 extern PayloadTransferFrameDefaultTypeInternal _PayloadTransferFrame_default_instance_;
+class PayloadTransferFrame_BlockSignatures;
+struct PayloadTransferFrame_BlockSignaturesDefaultTypeInternal;
+extern PayloadTransferFrame_BlockSignaturesDefaultTypeInternal _PayloadTransferFrame_BlockSignatures_default_instance_;
 class PayloadTransferFrame_ControlMessage;
 struct PayloadTransferFrame_ControlMessageDefaultTypeInternal;
 extern PayloadTransferFrame_ControlMessageDefaultTypeInternal _PayloadTransferFrame_ControlMessage_default_instance_;
@@ -149,6 +155,7 @@ template<> ::location::nearby::connections::AvailableChannels* Arena::CreateMayb
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroduction* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroduction>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck>(Arena*);
+template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials>(Arena*);
@@ -166,6 +173,7 @@ template<> ::location::nearby::connections::MediumMetadata* Arena::CreateMaybeMe
 template<> ::location::nearby::connections::OfflineFrame* Arena::CreateMaybeMessage<::location::nearby::connections::OfflineFrame>(Arena*);
 template<> ::location::nearby::connections::PairedKeyEncryptionFrame* Arena::CreateMaybeMessage<::location::nearby::connections::PairedKeyEncryptionFrame>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame>(Arena*);
+template<> ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_BlockSignatures>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_ControlMessage* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_ControlMessage>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_PayloadChunk* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_PayloadChunk>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_PayloadHeader>(Arena*);
@@ -293,11 +301,14 @@ inline const std::string& PayloadTransferFrame_PayloadHeader_PayloadType_Name(T
 bool PayloadTransferFrame_PayloadHeader_PayloadType_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_PayloadHeader_PayloadType* value);
 enum PayloadTransferFrame_PayloadChunk_Flags : int {
-  PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK = 1
+  PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK = 1,
+  PayloadTransferFrame_PayloadChunk_Flags_MORE_CHUNKS = 2,
+  PayloadTransferFrame_PayloadChunk_Flags_COMPRESSED = 4,
+  PayloadTransferFrame_PayloadChunk_Flags_DELTA = 8
 };
 bool PayloadTransferFrame_PayloadChunk_Flags_IsValid(int value);
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MIN = PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
-constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX = PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX = PayloadTransferFrame_PayloadChunk_Flags_DELTA;
 constexpr int PayloadTransferFrame_PayloadChunk_Flags_Flags_ARRAYSIZE = PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX + 1;
 
 const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(PayloadTransferFrame_PayloadChunk_Flags value);
@@ -313,11 +324,13 @@ bool PayloadTransferFrame_PayloadChunk_Flags_Parse(
 enum PayloadTransferFrame_ControlMessage_EventType : int {
   PayloadTransferFrame_ControlMessage_EventType_UNKNOWN_EVENT_TYPE = 0,
   PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_ERROR = 1,
-  PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_CANCELED = 2
+  PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_CANCELED = 2,
+  PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_DELTA_OFFER = 3,
+  PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_DELTA_SIGNATURES = 4
 };
 bool PayloadTransferFrame_ControlMessage_EventType_IsValid(int value);
 constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage_EventType_EventType_MIN = PayloadTransferFrame_ControlMessage_EventType_UNKNOWN_EVENT_TYPE;
-constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage_EventType_EventType_MAX = PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_CANCELED;
+constexpr PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage_EventType_EventType_MAX = PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_DELTA_SIGNATURES;
 constexpr int PayloadTransferFrame_ControlMessage_EventType_EventType_ARRAYSIZE = PayloadTransferFrame_ControlMessage_EventType_EventType_MAX + 1;
 
 const std::string& PayloadTransferFrame_ControlMessage_EventType_Name(PayloadTransferFrame_ControlMessage_EventType value);
@@ -1445,6 +1458,10 @@ class ConnectionResponseFrame final :
     kHandshakeDataFieldNumber = 2,
     kStatusFieldNumber = 1,
     kResponseFieldNumber = 3,
+    kSupportsAeadFrameCipherFieldNumber = 4,
+    kSupportsPayloadCompressionFieldNumber = 5,
+    kSupportsDeltaTransferFieldNumber = 6,
+    kSupportsChunkedBytesPayloadsFieldNumber = 7,
   };
   // optional bytes handshake_data = 2;
   bool has_handshake_data() const;
@@ -1490,6 +1507,58 @@ class ConnectionResponseFrame final :
   void _internal_set_response(::location::nearby::connections::ConnectionResponseFrame_ResponseStatus value);
   public:
 
+  // optional bool supports_aead_frame_cipher = 4;
+  bool has_supports_aead_frame_cipher() const;
+  private:
+  bool _internal_has_supports_aead_frame_cipher() const;
+  public:
+  void clear_supports_aead_frame_cipher();
+  bool supports_aead_frame_cipher() const;
+  void set_supports_aead_frame_cipher(bool value);
+  private:
+  bool _internal_supports_aead_frame_cipher() const;
+  void _internal_set_supports_aead_frame_cipher(bool value);
+  public:
+
+  // optional bool supports_payload_compression = 5;
+  bool has_supports_payload_compression() const;
+  private:
+  bool _internal_has_supports_payload_compression() const;
+  public:
+  void clear_supports_payload_compression();
+  bool supports_payload_compression() const;
+  void set_supports_payload_compression(bool value);
+  private:
+  bool _internal_supports_payload_compression() const;
+  void _internal_set_supports_payload_compression(bool value);
+  public:
+
+  // optional bool supports_delta_transfer = 6;
+  bool has_supports_delta_transfer() const;
+  private:
+  bool _internal_has_supports_delta_transfer() const;
+  public:
+  void clear_supports_delta_transfer();
+  bool supports_delta_transfer() const;
+  void set_supports_delta_transfer(bool value);
+  private:
+  bool _internal_supports_delta_transfer() const;
+  void _internal_set_supports_delta_transfer(bool value);
+  public:
+
+  // optional bool supports_chunked_bytes_payloads = 7;
+  bool has_supports_chunked_bytes_payloads() const;
+  private:
+  bool _internal_has_supports_chunked_bytes_payloads() const;
+  public:
+  void clear_supports_chunked_bytes_payloads();
+  bool supports_chunked_bytes_payloads() const;
+  void set_supports_chunked_bytes_payloads(bool value);
+  private:
+  bool _internal_supports_chunked_bytes_payloads() const;
+  void _internal_set_supports_chunked_bytes_payloads(bool value);
+  public:
+
   // @@protoc_insertion_point(class_scope:location.nearby.connections.ConnectionResponseFrame)
  private:
   class _Internal;
@@ -1502,6 +1571,10 @@ class ConnectionResponseFrame final :
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr handshake_data_;
   int32_t status_;
   int response_;
+  bool supports_aead_frame_cipher_;
+  bool supports_payload_compression_;
+  bool supports_delta_transfer_;
+  bool supports_chunked_bytes_payloads_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
 // -------------------------------------------------------------------
@@ -1876,6 +1949,12 @@ class PayloadTransferFrame_PayloadChunk final :
   typedef PayloadTransferFrame_PayloadChunk_Flags Flags;
   static constexpr Flags LAST_CHUNK =
     PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
+  static constexpr Flags MORE_CHUNKS =
+    PayloadTransferFrame_PayloadChunk_Flags_MORE_CHUNKS;
+  static constexpr Flags COMPRESSED =
+    PayloadTransferFrame_PayloadChunk_Flags_COMPRESSED;
+  static constexpr Flags DELTA =
+    PayloadTransferFrame_PayloadChunk_Flags_DELTA;
   static inline bool Flags_IsValid(int value) {
     return PayloadTransferFrame_PayloadChunk_Flags_IsValid(value);
   }
@@ -1964,6 +2043,168 @@ class PayloadTransferFrame_PayloadChunk final :
 };
 // -------------------------------------------------------------------
 
+class PayloadTransferFrame_BlockSignatures final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.PayloadTransferFrame.BlockSignatures) */ {
+ public:
+  inline PayloadTransferFrame_BlockSignatures() : PayloadTransferFrame_BlockSignatures(nullptr) {}
+  ~PayloadTransferFrame_BlockSignatures() override;
+  explicit constexpr PayloadTransferFrame_BlockSignatures(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  PayloadTransferFrame_BlockSignatures(const PayloadTransferFrame_BlockSignatures& from);
+  PayloadTransferFrame_BlockSignatures(PayloadTransferFrame_BlockSignatures&& from) noexcept
+    : PayloadTransferFrame_BlockSignatures() {
+    *this = ::std::move(from);
+  }
+
+  inline PayloadTransferFrame_BlockSignatures& operator=(const PayloadTransferFrame_BlockSignatures& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline PayloadTransferFrame_BlockSignatures& operator=(PayloadTransferFrame_BlockSignatures&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const PayloadTransferFrame_BlockSignatures& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const PayloadTransferFrame_BlockSignatures* internal_default_instance() {
+    return reinterpret_cast<const PayloadTransferFrame_BlockSignatures*>(
+               &_PayloadTransferFrame_BlockSignatures_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(PayloadTransferFrame_BlockSignatures& a, PayloadTransferFrame_BlockSignatures& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(PayloadTransferFrame_BlockSignatures* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(PayloadTransferFrame_BlockSignatures* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  PayloadTransferFrame_BlockSignatures* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<PayloadTransferFrame_BlockSignatures>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const PayloadTransferFrame_BlockSignatures& from);
+  void MergeFrom(const PayloadTransferFrame_BlockSignatures& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(PayloadTransferFrame_BlockSignatures* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.connections.PayloadTransferFrame.BlockSignatures";
+  }
+  protected:
+  explicit PayloadTransferFrame_BlockSignatures(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kBlocksFieldNumber = 2,
+    kBlockSizeFieldNumber = 1,
+  };
+  // optional bytes blocks = 2;
+  bool has_blocks() const;
+  private:
+  bool _internal_has_blocks() const;
+  public:
+  void clear_blocks();
+  const std::string& blocks() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_blocks(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_blocks();
+  PROTOBUF_NODISCARD std::string* release_blocks();
+  void set_allocated_blocks(std::string* blocks);
+  private:
+  const std::string& _internal_blocks() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_blocks(const std::string& value);
+  std::string* _internal_mutable_blocks();
+  public:
+
+  // optional int32 block_size = 1;
+  bool has_block_size() const;
+  private:
+  bool _internal_has_block_size() const;
+  public:
+  void clear_block_size();
+  int32_t block_size() const;
+  void set_block_size(int32_t value);
+  private:
+  int32_t _internal_block_size() const;
+  void _internal_set_block_size(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.connections.PayloadTransferFrame.BlockSignatures)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr blocks_;
+  int32_t block_size_;
+  friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
+};
+// -------------------------------------------------------------------
+
 class PayloadTransferFrame_ControlMessage final :
     public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.PayloadTransferFrame.ControlMessage) */ {
  public:
@@ -2010,7 +2251,7 @@ class PayloadTransferFrame_ControlMessage final :
                &_PayloadTransferFrame_ControlMessage_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    6;
+    7;
 
   friend void swap(PayloadTransferFrame_ControlMessage& a, PayloadTransferFrame_ControlMessage& b) {
     a.Swap(&b);
@@ -2081,6 +2322,10 @@ class PayloadTransferFrame_ControlMessage final :
     PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_ERROR;
   static constexpr EventType PAYLOAD_CANCELED =
     PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_CANCELED;
+  static constexpr EventType PAYLOAD_DELTA_OFFER =
+    PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_DELTA_OFFER;
+  static constexpr EventType PAYLOAD_DELTA_SIGNATURES =
+    PayloadTransferFrame_ControlMessage_EventType_PAYLOAD_DELTA_SIGNATURES;
   static inline bool EventType_IsValid(int value) {
     return PayloadTransferFrame_ControlMessage_EventType_IsValid(value);
   }
@@ -2105,9 +2350,28 @@ class PayloadTransferFrame_ControlMessage final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kBlockSignaturesFieldNumber = 3,
     kOffsetFieldNumber = 2,
     kEventFieldNumber = 1,
   };
+  // optional .location.nearby.connections.PayloadTransferFrame.BlockSignatures block_signatures = 3;
+  bool has_block_signatures() const;
+  private:
+  bool _internal_has_block_signatures() const;
+  public:
+  void clear_block_signatures();
+  const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures& block_signatures() const;
+  PROTOBUF_NODISCARD ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* release_block_signatures();
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* mutable_block_signatures();
+  void set_allocated_block_signatures(::location::nearby::connections::PayloadTransferFrame_BlockSignatures* block_signatures);
+  private:
+  const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures& _internal_block_signatures() const;
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* _internal_mutable_block_signatures();
+  public:
+  void unsafe_arena_set_allocated_block_signatures(
+      ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* block_signatures);
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* unsafe_arena_release_block_signatures();
+
   // optional int64 offset = 2;
   bool has_offset() const;
   private:
@@ -2143,6 +2407,7 @@ class PayloadTransferFrame_ControlMessage final :
   typedef void DestructorSkippable_;
   ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* block_signatures_;
   int64_t offset_;
   int event_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
@@ -2195,7 +2460,7 @@ class PayloadTransferFrame final :
                &_PayloadTransferFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    7;
+    8;
 
   friend void swap(PayloadTransferFrame& a, PayloadTransferFrame& b) {
     a.Swap(&b);
@@ -2261,6 +2526,7 @@ class PayloadTransferFrame final :
 
   typedef PayloadTransferFrame_PayloadHeader PayloadHeader;
   typedef PayloadTransferFrame_PayloadChunk PayloadChunk;
+  typedef PayloadTransferFrame_BlockSignatures BlockSignatures;
   typedef PayloadTransferFrame_ControlMessage ControlMessage;
 
   typedef PayloadTransferFrame_PacketType PacketType;
@@ -2429,7 +2695,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials fi
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    8;
+    9;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials& b) {
     a.Swap(&b);
@@ -2647,7 +2913,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    9;
+    10;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket& b) {
     a.Swap(&b);
@@ -2809,7 +3075,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials fina
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    10;
+    11;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials& b) {
     a.Swap(&b);
@@ -2976,7 +3242,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials fina
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    11;
+    12;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials& b) {
     a.Swap(&b);
@@ -3163,7 +3429,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials fin
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials& b) {
     a.Swap(&b);
@@ -3360,7 +3626,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials& b) {
     a.Swap(&b);
@@ -3527,7 +3793,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    15;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo& b) {
     a.Swap(&b);
@@ -3868,7 +4134,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction final :
                &_BandwidthUpgradeNegotiationFrame_ClientIntroduction_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    16;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_ClientIntroduction& a, BandwidthUpgradeNegotiationFrame_ClientIntroduction& b) {
     a.Swap(&b);
@@ -3937,6 +4203,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction final :
   enum : int {
     kEndpointIdFieldNumber = 1,
     kSupportsDisablingEncryptionFieldNumber = 2,
+    kSupportsMakeBeforeBreakFieldNumber = 3,
   };
   // optional string endpoint_id = 1;
   bool has_endpoint_id() const;
@@ -3969,6 +4236,19 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction final :
   void _internal_set_supports_disabling_encryption(bool value);
   public:
 
+  // optional bool supports_make_before_break = 3;
+  bool has_supports_make_before_break() const;
+  private:
+  bool _internal_has_supports_make_before_break() const;
+  public:
+  void clear_supports_make_before_break();
+  bool supports_make_before_break() const;
+  void set_supports_make_before_break(bool value);
+  private:
+  bool _internal_supports_make_before_break() const;
+  void _internal_set_supports_make_before_break(bool value);
+  public:
+
   // @@protoc_insertion_point(class_scope:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroduction)
  private:
   class _Internal;
@@ -3980,12 +4260,13 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction final :
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr endpoint_id_;
   bool supports_disabling_encryption_;
+  bool supports_make_before_break_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
 // -------------------------------------------------------------------
 
 class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck final :
-    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck) */ {
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck) */ {
  public:
   inline BandwidthUpgradeNegotiationFrame_ClientIntroductionAck() : BandwidthUpgradeNegotiationFrame_ClientIntroductionAck(nullptr) {}
   ~BandwidthUpgradeNegotiationFrame_ClientIntroductionAck() override;
@@ -4030,7 +4311,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck final :
                &_BandwidthUpgradeNegotiationFrame_ClientIntroductionAck_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    17;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& a, BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& b) {
     a.Swap(&b);
@@ -4080,7 +4361,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck final :
   private:
   friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
   static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
-    return "location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck";
+    return "location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck";
   }
   protected:
   explicit BandwidthUpgradeNegotiationFrame_ClientIntroductionAck(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -4096,14 +4377,174 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck final :
 
   // accessors -------------------------------------------------------
 
-  // @@protoc_insertion_point(class_scope:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroductionAck)
+  enum : int {
+    kSupportsMakeBeforeBreakFieldNumber = 1,
+  };
+  // optional bool supports_make_before_break = 1;
+  bool has_supports_make_before_break() const;
+  private:
+  bool _internal_has_supports_make_before_break() const;
+  public:
+  void clear_supports_make_before_break();
+  bool supports_make_before_break() const;
+  void set_supports_make_before_break(bool value);
+  private:
+  bool _internal_supports_make_before_break() const;
+  void _internal_set_supports_make_before_break(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  bool supports_make_before_break_;
+  friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
+};
+// -------------------------------------------------------------------
+
+class BandwidthUpgradeNegotiationFrame_LastWriteInfo final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo) */ {
+ public:
+  inline BandwidthUpgradeNegotiationFrame_LastWriteInfo() : BandwidthUpgradeNegotiationFrame_LastWriteInfo(nullptr) {}
+  ~BandwidthUpgradeNegotiationFrame_LastWriteInfo() override;
+  explicit constexpr BandwidthUpgradeNegotiationFrame_LastWriteInfo(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  BandwidthUpgradeNegotiationFrame_LastWriteInfo(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from);
+  BandwidthUpgradeNegotiationFrame_LastWriteInfo(BandwidthUpgradeNegotiationFrame_LastWriteInfo&& from) noexcept
+    : BandwidthUpgradeNegotiationFrame_LastWriteInfo() {
+    *this = ::std::move(from);
+  }
+
+  inline BandwidthUpgradeNegotiationFrame_LastWriteInfo& operator=(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline BandwidthUpgradeNegotiationFrame_LastWriteInfo& operator=(BandwidthUpgradeNegotiationFrame_LastWriteInfo&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const BandwidthUpgradeNegotiationFrame_LastWriteInfo& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const BandwidthUpgradeNegotiationFrame_LastWriteInfo* internal_default_instance() {
+    return reinterpret_cast<const BandwidthUpgradeNegotiationFrame_LastWriteInfo*>(
+               &_BandwidthUpgradeNegotiationFrame_LastWriteInfo_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    18;
+
+  friend void swap(BandwidthUpgradeNegotiationFrame_LastWriteInfo& a, BandwidthUpgradeNegotiationFrame_LastWriteInfo& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(BandwidthUpgradeNegotiationFrame_LastWriteInfo* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(BandwidthUpgradeNegotiationFrame_LastWriteInfo* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  BandwidthUpgradeNegotiationFrame_LastWriteInfo* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<BandwidthUpgradeNegotiationFrame_LastWriteInfo>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from);
+  void MergeFrom(const BandwidthUpgradeNegotiationFrame_LastWriteInfo& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(BandwidthUpgradeNegotiationFrame_LastWriteInfo* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo";
+  }
+  protected:
+  explicit BandwidthUpgradeNegotiationFrame_LastWriteInfo(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMakeBeforeBreakFieldNumber = 1,
+  };
+  // optional bool make_before_break = 1;
+  bool has_make_before_break() const;
+  private:
+  bool _internal_has_make_before_break() const;
+  public:
+  void clear_make_before_break();
+  bool make_before_break() const;
+  void set_make_before_break(bool value);
+  private:
+  bool _internal_make_before_break() const;
+  void _internal_set_make_before_break(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo)
  private:
   class _Internal;
 
   template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  bool make_before_break_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
 // -------------------------------------------------------------------
@@ -4154,7 +4595,7 @@ class BandwidthUpgradeNegotiationFrame final :
                &_BandwidthUpgradeNegotiationFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    17;
+    19;
 
   friend void swap(BandwidthUpgradeNegotiationFrame& a, BandwidthUpgradeNegotiationFrame& b) {
     a.Swap(&b);
@@ -4221,6 +4662,7 @@ class BandwidthUpgradeNegotiationFrame final :
   typedef BandwidthUpgradeNegotiationFrame_UpgradePathInfo UpgradePathInfo;
   typedef BandwidthUpgradeNegotiationFrame_ClientIntroduction ClientIntroduction;
   typedef BandwidthUpgradeNegotiationFrame_ClientIntroductionAck ClientIntroductionAck;
+  typedef BandwidthUpgradeNegotiationFrame_LastWriteInfo LastWriteInfo;
 
   typedef BandwidthUpgradeNegotiationFrame_EventType EventType;
   static constexpr EventType UNKNOWN_EVENT_TYPE =
@@ -4264,6 +4706,7 @@ class BandwidthUpgradeNegotiationFrame final :
     kUpgradePathInfoFieldNumber = 2,
     kClientIntroductionFieldNumber = 3,
     kClientIntroductionAckFieldNumber = 4,
+    kLastWriteInfoFieldNumber = 5,
     kEventTypeFieldNumber = 1,
   };
   // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.UpgradePathInfo upgrade_path_info = 2;
@@ -4320,6 +4763,24 @@ class BandwidthUpgradeNegotiationFrame final :
       ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck* client_introduction_ack);
   ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck* unsafe_arena_release_client_introduction_ack();
 
+  // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.LastWriteInfo last_write_info = 5;
+  bool has_last_write_info() const;
+  private:
+  bool _internal_has_last_write_info() const;
+  public:
+  void clear_last_write_info();
+  const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo& last_write_info() const;
+  PROTOBUF_NODISCARD ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* release_last_write_info();
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* mutable_last_write_info();
+  void set_allocated_last_write_info(::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* last_write_info);
+  private:
+  const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo& _internal_last_write_info() const;
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* _internal_mutable_last_write_info();
+  public:
+  void unsafe_arena_set_allocated_last_write_info(
+      ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* last_write_info);
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* unsafe_arena_release_last_write_info();
+
   // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.EventType event_type = 1;
   bool has_event_type() const;
   private:
@@ -4345,6 +4806,7 @@ class BandwidthUpgradeNegotiationFrame final :
   ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_UpgradePathInfo* upgrade_path_info_;
   ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroduction* client_introduction_;
   ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_ClientIntroductionAck* client_introduction_ack_;
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* last_write_info_;
   int event_type_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
@@ -4396,7 +4858,7 @@ class KeepAliveFrame final :
                &_KeepAliveFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    18;
+    20;
 
   friend void swap(KeepAliveFrame& a, KeepAliveFrame& b) {
     a.Swap(&b);
@@ -4538,7 +5000,7 @@ class DisconnectionFrame final :
                &_DisconnectionFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    19;
+    21;
 
   friend void swap(DisconnectionFrame& a, DisconnectionFrame& b) {
     a.Swap(&b);
@@ -4662,7 +5124,7 @@ class PairedKeyEncryptionFrame final :
                &_PairedKeyEncryptionFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    20;
+    22;
 
   friend void swap(PairedKeyEncryptionFrame& a, PairedKeyEncryptionFrame& b) {
     a.Swap(&b);
@@ -4809,7 +5271,7 @@ class MediumMetadata final :
                &_MediumMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    21;
+    23;
 
   friend void swap(MediumMetadata& a, MediumMetadata& b) {
     a.Swap(&b);
@@ -5136,7 +5598,7 @@ class AvailableChannels final :
                &_AvailableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    22;
+    24;
 
   friend void swap(AvailableChannels& a, AvailableChannels& b) {
     a.Swap(&b);
@@ -5287,7 +5749,7 @@ class WifiDirectCliUsableChannels final :
                &_WifiDirectCliUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    23;
+    25;
 
   friend void swap(WifiDirectCliUsableChannels& a, WifiDirectCliUsableChannels& b) {
     a.Swap(&b);
@@ -5438,7 +5900,7 @@ class WifiLanUsableChannels final :
                &_WifiLanUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    24;
+    26;
 
   friend void swap(WifiLanUsableChannels& a, WifiLanUsableChannels& b) {
     a.Swap(&b);
@@ -5589,7 +6051,7 @@ class WifiAwareUsableChannels final :
                &_WifiAwareUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    25;
+    27;
 
   friend void swap(WifiAwareUsableChannels& a, WifiAwareUsableChannels& b) {
     a.Swap(&b);
@@ -5740,7 +6202,7 @@ class WifiHotspotStaUsableChannels final :
                &_WifiHotspotStaUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    26;
+    28;
 
   friend void swap(WifiHotspotStaUsableChannels& a, WifiHotspotStaUsableChannels& b) {
     a.Swap(&b);
@@ -5891,7 +6353,7 @@ class LocationHint final :
                &_LocationHint_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    27;
+    29;
 
   friend void swap(LocationHint& a, LocationHint& b) {
     a.Swap(&b);
@@ -6053,7 +6515,7 @@ class LocationStandard final :
                &_LocationStandard_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    28;
+    30;
 
   friend void swap(LocationStandard& a, LocationStandard& b) {
     a.Swap(&b);
@@ -7676,6 +8138,118 @@ inline void ConnectionResponseFrame::set_response(::location::nearby::connection
   // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.response)
 }
 
+// optional bool supports_aead_frame_cipher = 4;
+inline bool ConnectionResponseFrame::_internal_has_supports_aead_frame_cipher() const {
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_supports_aead_frame_cipher() const {
+  return _internal_has_supports_aead_frame_cipher();
+}
+inline void ConnectionResponseFrame::clear_supports_aead_frame_cipher() {
+  supports_aead_frame_cipher_ = false;
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline bool ConnectionResponseFrame::_internal_supports_aead_frame_cipher() const {
+  return supports_aead_frame_cipher_;
+}
+inline bool ConnectionResponseFrame::supports_aead_frame_cipher() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.supports_aead_frame_cipher)
+  return _internal_supports_aead_frame_cipher();
+}
+inline void ConnectionResponseFrame::_internal_set_supports_aead_frame_cipher(bool value) {
+  _has_bits_[0] |= 0x00000008u;
+  supports_aead_frame_cipher_ = value;
+}
+inline void ConnectionResponseFrame::set_supports_aead_frame_cipher(bool value) {
+  _internal_set_supports_aead_frame_cipher(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.supports_aead_frame_cipher)
+}
+
+// optional bool supports_payload_compression = 5;
+inline bool ConnectionResponseFrame::_internal_has_supports_payload_compression() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_supports_payload_compression() const {
+  return _internal_has_supports_payload_compression();
+}
+inline void ConnectionResponseFrame::clear_supports_payload_compression() {
+  supports_payload_compression_ = false;
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline bool ConnectionResponseFrame::_internal_supports_payload_compression() const {
+  return supports_payload_compression_;
+}
+inline bool ConnectionResponseFrame::supports_payload_compression() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.supports_payload_compression)
+  return _internal_supports_payload_compression();
+}
+inline void ConnectionResponseFrame::_internal_set_supports_payload_compression(bool value) {
+  _has_bits_[0] |= 0x00000010u;
+  supports_payload_compression_ = value;
+}
+inline void ConnectionResponseFrame::set_supports_payload_compression(bool value) {
+  _internal_set_supports_payload_compression(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.supports_payload_compression)
+}
+
+// optional bool supports_delta_transfer = 6;
+inline bool ConnectionResponseFrame::_internal_has_supports_delta_transfer() const {
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_supports_delta_transfer() const {
+  return _internal_has_supports_delta_transfer();
+}
+inline void ConnectionResponseFrame::clear_supports_delta_transfer() {
+  supports_delta_transfer_ = false;
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline bool ConnectionResponseFrame::_internal_supports_delta_transfer() const {
+  return supports_delta_transfer_;
+}
+inline bool ConnectionResponseFrame::supports_delta_transfer() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.supports_delta_transfer)
+  return _internal_supports_delta_transfer();
+}
+inline void ConnectionResponseFrame::_internal_set_supports_delta_transfer(bool value) {
+  _has_bits_[0] |= 0x00000020u;
+  supports_delta_transfer_ = value;
+}
+inline void ConnectionResponseFrame::set_supports_delta_transfer(bool value) {
+  _internal_set_supports_delta_transfer(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.supports_delta_transfer)
+}
+
+// optional bool supports_chunked_bytes_payloads = 7;
+inline bool ConnectionResponseFrame::_internal_has_supports_chunked_bytes_payloads() const {
+  bool value = (_has_bits_[0] & 0x00000040u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_supports_chunked_bytes_payloads() const {
+  return _internal_has_supports_chunked_bytes_payloads();
+}
+inline void ConnectionResponseFrame::clear_supports_chunked_bytes_payloads() {
+  supports_chunked_bytes_payloads_ = false;
+  _has_bits_[0] &= ~0x00000040u;
+}
+inline bool ConnectionResponseFrame::_internal_supports_chunked_bytes_payloads() const {
+  return supports_chunked_bytes_payloads_;
+}
+inline bool ConnectionResponseFrame::supports_chunked_bytes_payloads() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.supports_chunked_bytes_payloads)
+  return _internal_supports_chunked_bytes_payloads();
+}
+inline void ConnectionResponseFrame::_internal_set_supports_chunked_bytes_payloads(bool value) {
+  _has_bits_[0] |= 0x00000040u;
+  supports_chunked_bytes_payloads_ = value;
+}
+inline void ConnectionResponseFrame::set_supports_chunked_bytes_payloads(bool value) {
+  _internal_set_supports_chunked_bytes_payloads(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.supports_chunked_bytes_payloads)
+}
+
 // -------------------------------------------------------------------
 
 // PayloadTransferFrame_PayloadHeader
@@ -8062,11 +8636,112 @@ inline void PayloadTransferFrame_PayloadChunk::set_allocated_body(std::string* b
 
 // -------------------------------------------------------------------
 
+// PayloadTransferFrame_BlockSignatures
+
+// optional bytes blocks = 2;
+inline bool PayloadTransferFrame_BlockSignatures::_internal_has_blocks() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_BlockSignatures::has_blocks() const {
+  return _internal_has_blocks();
+}
+inline void PayloadTransferFrame_BlockSignatures::clear_blocks() {
+  blocks_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline const std::string& PayloadTransferFrame_BlockSignatures::blocks() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.BlockSignatures.blocks)
+  return _internal_blocks();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void PayloadTransferFrame_BlockSignatures::set_blocks(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000001u;
+ blocks_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.BlockSignatures.blocks)
+}
+inline std::string* PayloadTransferFrame_BlockSignatures::mutable_blocks() {
+  std::string* _s = _internal_mutable_blocks();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.BlockSignatures.blocks)
+  return _s;
+}
+inline const std::string& PayloadTransferFrame_BlockSignatures::_internal_blocks() const {
+  return blocks_.Get();
+}
+inline void PayloadTransferFrame_BlockSignatures::_internal_set_blocks(const std::string& value) {
+  _has_bits_[0] |= 0x00000001u;
+  blocks_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_BlockSignatures::_internal_mutable_blocks() {
+  _has_bits_[0] |= 0x00000001u;
+  return blocks_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_BlockSignatures::release_blocks() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.BlockSignatures.blocks)
+  if (!_internal_has_blocks()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000001u;
+  auto* p = blocks_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (blocks_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    blocks_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void PayloadTransferFrame_BlockSignatures::set_allocated_blocks(std::string* blocks) {
+  if (blocks != nullptr) {
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  blocks_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), blocks,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (blocks_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    blocks_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.BlockSignatures.blocks)
+}
+
+// optional int32 block_size = 1;
+inline bool PayloadTransferFrame_BlockSignatures::_internal_has_block_size() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_BlockSignatures::has_block_size() const {
+  return _internal_has_block_size();
+}
+inline void PayloadTransferFrame_BlockSignatures::clear_block_size() {
+  block_size_ = 0;
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline int32_t PayloadTransferFrame_BlockSignatures::_internal_block_size() const {
+  return block_size_;
+}
+inline int32_t PayloadTransferFrame_BlockSignatures::block_size() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.BlockSignatures.block_size)
+  return _internal_block_size();
+}
+inline void PayloadTransferFrame_BlockSignatures::_internal_set_block_size(int32_t value) {
+  _has_bits_[0] |= 0x00000002u;
+  block_size_ = value;
+}
+inline void PayloadTransferFrame_BlockSignatures::set_block_size(int32_t value) {
+  _internal_set_block_size(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.BlockSignatures.block_size)
+}
+
+// -------------------------------------------------------------------
+
 // PayloadTransferFrame_ControlMessage
 
 // optional .location.nearby.connections.PayloadTransferFrame.ControlMessage.EventType event = 1;
 inline bool PayloadTransferFrame_ControlMessage::_internal_has_event() const {
-  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
   return value;
 }
 inline bool PayloadTransferFrame_ControlMessage::has_event() const {
@@ -8074,7 +8749,7 @@ inline bool PayloadTransferFrame_ControlMessage::has_event() const {
 }
 inline void PayloadTransferFrame_ControlMessage::clear_event() {
   event_ = 0;
-  _has_bits_[0] &= ~0x00000002u;
+  _has_bits_[0] &= ~0x00000004u;
 }
 inline ::location::nearby::connections::PayloadTransferFrame_ControlMessage_EventType PayloadTransferFrame_ControlMessage::_internal_event() const {
   return static_cast< ::location::nearby::connections::PayloadTransferFrame_ControlMessage_EventType >(event_);
@@ -8085,7 +8760,7 @@ inline ::location::nearby::connections::PayloadTransferFrame_ControlMessage_Even
 }
 inline void PayloadTransferFrame_ControlMessage::_internal_set_event(::location::nearby::connections::PayloadTransferFrame_ControlMessage_EventType value) {
   assert(::location::nearby::connections::PayloadTransferFrame_ControlMessage_EventType_IsValid(value));
-  _has_bits_[0] |= 0x00000002u;
+  _has_bits_[0] |= 0x00000004u;
   event_ = value;
 }
 inline void PayloadTransferFrame_ControlMessage::set_event(::location::nearby::connections::PayloadTransferFrame_ControlMessage_EventType value) {
@@ -8095,7 +8770,7 @@ inline void PayloadTransferFrame_ControlMessage::set_event(::location::nearby::c
 
 // optional int64 offset = 2;
 inline bool PayloadTransferFrame_ControlMessage::_internal_has_offset() const {
-  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
   return value;
 }
 inline bool PayloadTransferFrame_ControlMessage::has_offset() const {
@@ -8103,7 +8778,7 @@ inline bool PayloadTransferFrame_ControlMessage::has_offset() const {
 }
 inline void PayloadTransferFrame_ControlMessage::clear_offset() {
   offset_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000001u;
+  _has_bits_[0] &= ~0x00000002u;
 }
 inline int64_t PayloadTransferFrame_ControlMessage::_internal_offset() const {
   return offset_;
@@ -8113,7 +8788,7 @@ inline int64_t PayloadTransferFrame_ControlMessage::offset() const {
   return _internal_offset();
 }
 inline void PayloadTransferFrame_ControlMessage::_internal_set_offset(int64_t value) {
-  _has_bits_[0] |= 0x00000001u;
+  _has_bits_[0] |= 0x00000002u;
   offset_ = value;
 }
 inline void PayloadTransferFrame_ControlMessage::set_offset(int64_t value) {
@@ -8121,6 +8796,96 @@ inline void PayloadTransferFrame_ControlMessage::set_offset(int64_t value) {
   // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.ControlMessage.offset)
 }
 
+// optional .location.nearby.connections.PayloadTransferFrame.BlockSignatures block_signatures = 3;
+inline bool PayloadTransferFrame_ControlMessage::_internal_has_block_signatures() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  PROTOBUF_ASSUME(!value || block_signatures_ != nullptr);
+  return value;
+}
+inline bool PayloadTransferFrame_ControlMessage::has_block_signatures() const {
+  return _internal_has_block_signatures();
+}
+inline void PayloadTransferFrame_ControlMessage::clear_block_signatures() {
+  if (block_signatures_ != nullptr) block_signatures_->Clear();
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures& PayloadTransferFrame_ControlMessage::_internal_block_signatures() const {
+  const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* p = block_signatures_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures&>(
+      ::location::nearby::connections::_PayloadTransferFrame_BlockSignatures_default_instance_);
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_BlockSignatures& PayloadTransferFrame_ControlMessage::block_signatures() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.ControlMessage.block_signatures)
+  return _internal_block_signatures();
+}
+inline void PayloadTransferFrame_ControlMessage::unsafe_arena_set_allocated_block_signatures(
+    ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* block_signatures) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(block_signatures_);
+  }
+  block_signatures_ = block_signatures;
+  if (block_signatures) {
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.connections.PayloadTransferFrame.ControlMessage.block_signatures)
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* PayloadTransferFrame_ControlMessage::release_block_signatures() {
+  _has_bits_[0] &= ~0x00000001u;
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* temp = block_signatures_;
+  block_signatures_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* PayloadTransferFrame_ControlMessage::unsafe_arena_release_block_signatures() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.ControlMessage.block_signatures)
+  _has_bits_[0] &= ~0x00000001u;
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* temp = block_signatures_;
+  block_signatures_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* PayloadTransferFrame_ControlMessage::_internal_mutable_block_signatures() {
+  _has_bits_[0] |= 0x00000001u;
+  if (block_signatures_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_BlockSignatures>(GetArenaForAllocation());
+    block_signatures_ = p;
+  }
+  return block_signatures_;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* PayloadTransferFrame_ControlMessage::mutable_block_signatures() {
+  ::location::nearby::connections::PayloadTransferFrame_BlockSignatures* _msg = _internal_mutable_block_signatures();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.ControlMessage.block_signatures)
+  return _msg;
+}
+inline void PayloadTransferFrame_ControlMessage::set_allocated_block_signatures(::location::nearby::connections::PayloadTransferFrame_BlockSignatures* block_signatures) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete block_signatures_;
+  }
+  if (block_signatures) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::connections::PayloadTransferFrame_BlockSignatures>::GetOwningArena(block_signatures);
+    if (message_arena != submessage_arena) {
+      block_signatures = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, block_signatures, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  block_signatures_ = block_signatures;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.ControlMessage.block_signatures)
+}
+
 // -------------------------------------------------------------------
 
 // PayloadTransferFrame
@@ -10227,17 +10992,105 @@ inline void BandwidthUpgradeNegotiationFrame_ClientIntroduction::set_supports_di
   // @@protoc_insertion_point(field_set:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroduction.supports_disabling_encryption)
 }
 
+// optional bool supports_make_before_break = 3;
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroduction::_internal_has_supports_make_before_break() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroduction::has_supports_make_before_break() const {
+  return _internal_has_supports_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroduction::clear_supports_make_before_break() {
+  supports_make_before_break_ = false;
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroduction::_internal_supports_make_before_break() const {
+  return supports_make_before_break_;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroduction::supports_make_before_break() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroduction.supports_make_before_break)
+  return _internal_supports_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroduction::_internal_set_supports_make_before_break(bool value) {
+  _has_bits_[0] |= 0x00000004u;
+  supports_make_before_break_ = value;
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroduction::set_supports_make_before_break(bool value) {
+  _internal_set_supports_make_before_break(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.BandwidthUpgradeNegotiationFrame.ClientIntroduction.supports_make_before_break)
+}
+
 // -------------------------------------------------------------------
 
 // BandwidthUpgradeNegotiationFrame_ClientIntroductionAck
 
+// optional bool supports_make_before_break = 1;
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_internal_has_supports_make_before_break() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::has_supports_make_before_break() const {
+  return _internal_has_supports_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::clear_supports_make_before_break() {
+  supports_make_before_break_ = false;
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_internal_supports_make_before_break() const {
+  return supports_make_before_break_;
+}
+inline bool BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::supports_make_before_break() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck.supports_make_before_break)
+  return _internal_supports_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::_internal_set_supports_make_before_break(bool value) {
+  _has_bits_[0] |= 0x00000001u;
+  supports_make_before_break_ = value;
+}
+inline void BandwidthUpgradeNegotiationFrame_ClientIntroductionAck::set_supports_make_before_break(bool value) {
+  _internal_set_supports_make_before_break(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.BandwidthUpgradeNegotiationFrame_ClientIntroductionAck.supports_make_before_break)
+}
+
+// -------------------------------------------------------------------
+
+// BandwidthUpgradeNegotiationFrame_LastWriteInfo
+
+// optional bool make_before_break = 1;
+inline bool BandwidthUpgradeNegotiationFrame_LastWriteInfo::_internal_has_make_before_break() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool BandwidthUpgradeNegotiationFrame_LastWriteInfo::has_make_before_break() const {
+  return _internal_has_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_LastWriteInfo::clear_make_before_break() {
+  make_before_break_ = false;
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline bool BandwidthUpgradeNegotiationFrame_LastWriteInfo::_internal_make_before_break() const {
+  return make_before_break_;
+}
+inline bool BandwidthUpgradeNegotiationFrame_LastWriteInfo::make_before_break() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo.make_before_break)
+  return _internal_make_before_break();
+}
+inline void BandwidthUpgradeNegotiationFrame_LastWriteInfo::_internal_set_make_before_break(bool value) {
+  _has_bits_[0] |= 0x00000001u;
+  make_before_break_ = value;
+}
+inline void BandwidthUpgradeNegotiationFrame_LastWriteInfo::set_make_before_break(bool value) {
+  _internal_set_make_before_break(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.BandwidthUpgradeNegotiationFrame_LastWriteInfo.make_before_break)
+}
+
 // -------------------------------------------------------------------
 
 // BandwidthUpgradeNegotiationFrame
 
 // optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.EventType event_type = 1;
 inline bool BandwidthUpgradeNegotiationFrame::_internal_has_event_type() const {
-  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
   return value;
 }
 inline bool BandwidthUpgradeNegotiationFrame::has_event_type() const {
@@ -10245,7 +11098,7 @@ inline bool BandwidthUpgradeNegotiationFrame::has_event_type() const {
 }
 inline void BandwidthUpgradeNegotiationFrame::clear_event_type() {
   event_type_ = 0;
-  _has_bits_[0] &= ~0x00000008u;
+  _has_bits_[0] &= ~0x00000010u;
 }
 inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventType BandwidthUpgradeNegotiationFrame::_internal_event_type() const {
   return static_cast< ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventType >(event_type_);
@@ -10256,7 +11109,7 @@ inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventTy
 }
 inline void BandwidthUpgradeNegotiationFrame::_internal_set_event_type(::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventType value) {
   assert(::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventType_IsValid(value));
-  _has_bits_[0] |= 0x00000008u;
+  _has_bits_[0] |= 0x00000010u;
   event_type_ = value;
 }
 inline void BandwidthUpgradeNegotiationFrame::set_event_type(::location::nearby::connections::BandwidthUpgradeNegotiationFrame_EventType value) {
@@ -10534,6 +11387,96 @@ inline void BandwidthUpgradeNegotiationFrame::set_allocated_client_introduction_
   // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.BandwidthUpgradeNegotiationFrame.client_introduction_ack)
 }
 
+// optional .location.nearby.connections.BandwidthUpgradeNegotiationFrame.LastWriteInfo last_write_info = 5;
+inline bool BandwidthUpgradeNegotiationFrame::_internal_has_last_write_info() const {
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  PROTOBUF_ASSUME(!value || last_write_info_ != nullptr);
+  return value;
+}
+inline bool BandwidthUpgradeNegotiationFrame::has_last_write_info() const {
+  return _internal_has_last_write_info();
+}
+inline void BandwidthUpgradeNegotiationFrame::clear_last_write_info() {
+  if (last_write_info_ != nullptr) last_write_info_->Clear();
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo& BandwidthUpgradeNegotiationFrame::_internal_last_write_info() const {
+  const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* p = last_write_info_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo&>(
+      ::location::nearby::connections::_BandwidthUpgradeNegotiationFrame_LastWriteInfo_default_instance_);
+}
+inline const ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo& BandwidthUpgradeNegotiationFrame::last_write_info() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.BandwidthUpgradeNegotiationFrame.last_write_info)
+  return _internal_last_write_info();
+}
+inline void BandwidthUpgradeNegotiationFrame::unsafe_arena_set_allocated_last_write_info(
+    ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* last_write_info) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(last_write_info_);
+  }
+  last_write_info_ = last_write_info;
+  if (last_write_info) {
+    _has_bits_[0] |= 0x00000008u;
+  } else {
+    _has_bits_[0] &= ~0x00000008u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.connections.BandwidthUpgradeNegotiationFrame.last_write_info)
+}
+inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* BandwidthUpgradeNegotiationFrame::release_last_write_info() {
+  _has_bits_[0] &= ~0x00000008u;
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* temp = last_write_info_;
+  last_write_info_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* BandwidthUpgradeNegotiationFrame::unsafe_arena_release_last_write_info() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.BandwidthUpgradeNegotiationFrame.last_write_info)
+  _has_bits_[0] &= ~0x00000008u;
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* temp = last_write_info_;
+  last_write_info_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* BandwidthUpgradeNegotiationFrame::_internal_mutable_last_write_info() {
+  _has_bits_[0] |= 0x00000008u;
+  if (last_write_info_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo>(GetArenaForAllocation());
+    last_write_info_ = p;
+  }
+  return last_write_info_;
+}
+inline ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* BandwidthUpgradeNegotiationFrame::mutable_last_write_info() {
+  ::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* _msg = _internal_mutable_last_write_info();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.BandwidthUpgradeNegotiationFrame.last_write_info)
+  return _msg;
+}
+inline void BandwidthUpgradeNegotiationFrame::set_allocated_last_write_info(::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo* last_write_info) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete last_write_info_;
+  }
+  if (last_write_info) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::connections::BandwidthUpgradeNegotiationFrame_LastWriteInfo>::GetOwningArena(last_write_info);
+    if (message_arena != submessage_arena) {
+      last_write_info = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, last_write_info, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000008u;
+  } else {
+    _has_bits_[0] &= ~0x00000008u;
+  }
+  last_write_info_ = last_write_info;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.BandwidthUpgradeNegotiationFrame.last_write_info)
+}
+
 // -------------------------------------------------------------------
 
 // KeepAliveFrame
@@ -181,6 +181,7 @@ constexpr ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnec
   : sent_payload_()
   , received_payload_()
   , connection_token_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , link_quality_(nullptr)
   , duration_millis_(int64_t{0})
   , medium_(0)
 
@@ -196,6 +197,23 @@ struct ConnectionsLog_EstablishedConnectionDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_EstablishedConnectionDefaultTypeInternal _ConnectionsLog_EstablishedConnection_default_instance_;
+constexpr ConnectionsLog_LinkQuality::ConnectionsLog_LinkQuality(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : throughput_samples_(int64_t{0})
+  , rtt_millis_(int64_t{0})
+  , rtt_samples_(int64_t{0})
+  , upgrade_setup_millis_(int64_t{0})
+  , upgrade_setup_samples_(int64_t{0})
+  , throughput_kbps_(0){}
+struct ConnectionsLog_LinkQualityDefaultTypeInternal {
+  constexpr ConnectionsLog_LinkQualityDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~ConnectionsLog_LinkQualityDefaultTypeInternal() {}
+  union {
+    ConnectionsLog_LinkQuality _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_LinkQualityDefaultTypeInternal _ConnectionsLog_LinkQuality_default_instance_;
 constexpr ConnectionsLog_Payload::ConnectionsLog_Payload(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : duration_millis_(int64_t{0})
@@ -3612,22 +3630,30 @@ class ConnectionsLog_EstablishedConnection::_Internal {
  public:
   using HasBits = decltype(std::declval<ConnectionsLog_EstablishedConnection>()._has_bits_);
   static void set_has_duration_millis(HasBits* has_bits) {
-    (*has_bits)[0] |= 2u;
+    (*has_bits)[0] |= 4u;
   }
   static void set_has_medium(HasBits* has_bits) {
-    (*has_bits)[0] |= 4u;
+    (*has_bits)[0] |= 8u;
   }
   static void set_has_disconnection_reason(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+    (*has_bits)[0] |= 16u;
   }
   static void set_has_client_flow_id(HasBits* has_bits) {
-    (*has_bits)[0] |= 16u;
+    (*has_bits)[0] |= 32u;
   }
   static void set_has_connection_token(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
+  static const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality& link_quality(const ConnectionsLog_EstablishedConnection* msg);
+  static void set_has_link_quality(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
 };
 
+const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality&
+ConnectionsLog_EstablishedConnection::_Internal::link_quality(const ConnectionsLog_EstablishedConnection* msg) {
+  return *msg->link_quality_;
+}
 ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnection(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned),
@@ -3653,6 +3679,11 @@ ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnection(const
     connection_token_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_connection_token(), 
       GetArenaForAllocation());
   }
+  if (from._internal_has_link_quality()) {
+    link_quality_ = new ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality(*from.link_quality_);
+  } else {
+    link_quality_ = nullptr;
+  }
   ::memcpy(&duration_millis_, &from.duration_millis_,
     static_cast<size_t>(reinterpret_cast<char*>(&client_flow_id_) -
     reinterpret_cast<char*>(&duration_millis_)) + sizeof(client_flow_id_));
@@ -3665,9 +3696,9 @@ connection_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyS
   connection_token_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
-    reinterpret_cast<char*>(&duration_millis_) - reinterpret_cast<char*>(this)),
+    reinterpret_cast<char*>(&link_quality_) - reinterpret_cast<char*>(this)),
     0, static_cast<size_t>(reinterpret_cast<char*>(&client_flow_id_) -
-    reinterpret_cast<char*>(&duration_millis_)) + sizeof(client_flow_id_));
+    reinterpret_cast<char*>(&link_quality_)) + sizeof(client_flow_id_));
 }
 
 ConnectionsLog_EstablishedConnection::~ConnectionsLog_EstablishedConnection() {
@@ -3680,6 +3711,7 @@ ConnectionsLog_EstablishedConnection::~ConnectionsLog_EstablishedConnection() {
 inline void ConnectionsLog_EstablishedConnection::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   connection_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (this != internal_default_instance()) delete link_quality_;
 }
 
 void ConnectionsLog_EstablishedConnection::ArenaDtor(void* object) {
@@ -3701,10 +3733,16 @@ void ConnectionsLog_EstablishedConnection::Clear() {
   sent_payload_.Clear();
   received_payload_.Clear();
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000001u) {
-    connection_token_.ClearNonDefaultToEmpty();
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      connection_token_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      GOOGLE_DCHECK(link_quality_ != nullptr);
+      link_quality_->Clear();
+    }
   }
-  if (cached_has_bits & 0x0000001eu) {
+  if (cached_has_bits & 0x0000003cu) {
     ::memset(&duration_millis_, 0, static_cast<size_t>(
         reinterpret_cast<char*>(&client_flow_id_) -
         reinterpret_cast<char*>(&duration_millis_)) + sizeof(client_flow_id_));
@@ -3799,6 +3837,14 @@ const char* ConnectionsLog_EstablishedConnection::_InternalParse(const char* ptr
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.analytics.proto.ConnectionsLog.LinkQuality link_quality = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 74)) {
+          ptr = ctx->ParseMessage(_internal_mutable_link_quality(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -3831,13 +3877,13 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional int64 duration_millis = 1;
-  if (cached_has_bits & 0x00000002u) {
+  if (cached_has_bits & 0x00000004u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(1, this->_internal_duration_millis(), target);
   }
 
   // optional .location.nearby.proto.connections.Medium medium = 2;
-  if (cached_has_bits & 0x00000004u) {
+  if (cached_has_bits & 0x00000008u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       2, this->_internal_medium(), target);
@@ -3860,14 +3906,14 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
   }
 
   // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
-  if (cached_has_bits & 0x00000008u) {
+  if (cached_has_bits & 0x00000010u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       5, this->_internal_disconnection_reason(), target);
   }
 
   // optional int64 client_flow_id = 6;
-  if (cached_has_bits & 0x00000010u) {
+  if (cached_has_bits & 0x00000020u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(6, this->_internal_client_flow_id(), target);
   }
@@ -3878,6 +3924,14 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
         7, this->_internal_connection_token(), target);
   }
 
+  // optional .location.nearby.analytics.proto.ConnectionsLog.LinkQuality link_quality = 9;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        9, _Internal::link_quality(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -3909,7 +3963,7 @@ size_t ConnectionsLog_EstablishedConnection::ByteSizeLong() const {
   }
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000001fu) {
+  if (cached_has_bits & 0x0000003fu) {
     // optional string connection_token = 7;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -3917,25 +3971,32 @@ size_t ConnectionsLog_EstablishedConnection::ByteSizeLong() const {
           this->_internal_connection_token());
     }
 
-    // optional int64 duration_millis = 1;
+    // optional .location.nearby.analytics.proto.ConnectionsLog.LinkQuality link_quality = 9;
     if (cached_has_bits & 0x00000002u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *link_quality_);
+    }
+
+    // optional int64 duration_millis = 1;
+    if (cached_has_bits & 0x00000004u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_duration_millis());
     }
 
     // optional .location.nearby.proto.connections.Medium medium = 2;
-    if (cached_has_bits & 0x00000004u) {
+    if (cached_has_bits & 0x00000008u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_medium());
     }
 
     // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
-    if (cached_has_bits & 0x00000008u) {
+    if (cached_has_bits & 0x00000010u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_disconnection_reason());
     }
 
     // optional int64 client_flow_id = 6;
-    if (cached_has_bits & 0x00000010u) {
+    if (cached_has_bits & 0x00000020u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_client_flow_id());
     }
 
@@ -3963,20 +4024,23 @@ void ConnectionsLog_EstablishedConnection::MergeFrom(const ConnectionsLog_Establ
   sent_payload_.MergeFrom(from.sent_payload_);
   received_payload_.MergeFrom(from.received_payload_);
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000001fu) {
+  if (cached_has_bits & 0x0000003fu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_connection_token(from._internal_connection_token());
     }
     if (cached_has_bits & 0x00000002u) {
-      duration_millis_ = from.duration_millis_;
+      _internal_mutable_link_quality()->::location::nearby::analytics::proto::ConnectionsLog_LinkQuality::MergeFrom(from._internal_link_quality());
     }
     if (cached_has_bits & 0x00000004u) {
-      medium_ = from.medium_;
+      duration_millis_ = from.duration_millis_;
     }
     if (cached_has_bits & 0x00000008u) {
-      disconnection_reason_ = from.disconnection_reason_;
+      medium_ = from.medium_;
     }
     if (cached_has_bits & 0x00000010u) {
+      disconnection_reason_ = from.disconnection_reason_;
+    }
+    if (cached_has_bits & 0x00000020u) {
       client_flow_id_ = from.client_flow_id_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -4011,9 +4075,9 @@ void ConnectionsLog_EstablishedConnection::InternalSwap(ConnectionsLog_Establish
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
       PROTOBUF_FIELD_OFFSET(ConnectionsLog_EstablishedConnection, client_flow_id_)
       + sizeof(ConnectionsLog_EstablishedConnection::client_flow_id_)
-      - PROTOBUF_FIELD_OFFSET(ConnectionsLog_EstablishedConnection, duration_millis_)>(
-          reinterpret_cast<char*>(&duration_millis_),
-          reinterpret_cast<char*>(&other->duration_millis_));
+      - PROTOBUF_FIELD_OFFSET(ConnectionsLog_EstablishedConnection, link_quality_)>(
+          reinterpret_cast<char*>(&link_quality_),
+          reinterpret_cast<char*>(&other->link_quality_));
 }
 
 std::string ConnectionsLog_EstablishedConnection::GetTypeName() const {
@@ -4021,6 +4085,344 @@ std::string ConnectionsLog_EstablishedConnection::GetTypeName() const {
 }
 
 
+// ===================================================================
+
+class ConnectionsLog_LinkQuality::_Internal {
+ public:
+  using HasBits = decltype(std::declval<ConnectionsLog_LinkQuality>()._has_bits_);
+  static void set_has_throughput_kbps(HasBits* has_bits) {
+    (*has_bits)[0] |= 32u;
+  }
+  static void set_has_throughput_samples(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_rtt_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static void set_has_rtt_samples(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+  static void set_has_upgrade_setup_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
+  }
+  static void set_has_upgrade_setup_samples(HasBits* has_bits) {
+    (*has_bits)[0] |= 16u;
+  }
+};
+
+ConnectionsLog_LinkQuality::ConnectionsLog_LinkQuality(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+}
+ConnectionsLog_LinkQuality::ConnectionsLog_LinkQuality(const ConnectionsLog_LinkQuality& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  ::memcpy(&throughput_samples_, &from.throughput_samples_,
+    static_cast<size_t>(reinterpret_cast<char*>(&throughput_kbps_) -
+    reinterpret_cast<char*>(&throughput_samples_)) + sizeof(throughput_kbps_));
+  // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+}
+
+inline void ConnectionsLog_LinkQuality::SharedCtor() {
+::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
+    reinterpret_cast<char*>(&throughput_samples_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&throughput_kbps_) -
+    reinterpret_cast<char*>(&throughput_samples_)) + sizeof(throughput_kbps_));
+}
+
+ConnectionsLog_LinkQuality::~ConnectionsLog_LinkQuality() {
+  // @@protoc_insertion_point(destructor:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void ConnectionsLog_LinkQuality::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+}
+
+void ConnectionsLog_LinkQuality::ArenaDtor(void* object) {
+  ConnectionsLog_LinkQuality* _this = reinterpret_cast< ConnectionsLog_LinkQuality* >(object);
+  (void)_this;
+}
+void ConnectionsLog_LinkQuality::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void ConnectionsLog_LinkQuality::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void ConnectionsLog_LinkQuality::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x0000003fu) {
+    ::memset(&throughput_samples_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&throughput_kbps_) -
+        reinterpret_cast<char*>(&throughput_samples_)) + sizeof(throughput_kbps_));
+  }
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* ConnectionsLog_LinkQuality::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional int32 throughput_kbps = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_throughput_kbps(&has_bits);
+          throughput_kbps_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 throughput_samples = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _Internal::set_has_throughput_samples(&has_bits);
+          throughput_samples_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 rtt_millis = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_rtt_millis(&has_bits);
+          rtt_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 rtt_samples = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _Internal::set_has_rtt_samples(&has_bits);
+          rtt_samples_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 upgrade_setup_millis = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _Internal::set_has_upgrade_setup_millis(&has_bits);
+          upgrade_setup_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 upgrade_setup_samples = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _Internal::set_has_upgrade_setup_samples(&has_bits);
+          upgrade_setup_samples_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ConnectionsLog_LinkQuality::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional int32 throughput_kbps = 1;
+  if (cached_has_bits & 0x00000020u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(1, this->_internal_throughput_kbps(), target);
+  }
+
+  // optional int64 throughput_samples = 2;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(2, this->_internal_throughput_samples(), target);
+  }
+
+  // optional int64 rtt_millis = 3;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(3, this->_internal_rtt_millis(), target);
+  }
+
+  // optional int64 rtt_samples = 4;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(4, this->_internal_rtt_samples(), target);
+  }
+
+  // optional int64 upgrade_setup_millis = 5;
+  if (cached_has_bits & 0x00000008u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(5, this->_internal_upgrade_setup_millis(), target);
+  }
+
+  // optional int64 upgrade_setup_samples = 6;
+  if (cached_has_bits & 0x00000010u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(6, this->_internal_upgrade_setup_samples(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  return target;
+}
+
+size_t ConnectionsLog_LinkQuality::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x0000003fu) {
+    // optional int64 throughput_samples = 2;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_throughput_samples());
+    }
+
+    // optional int64 rtt_millis = 3;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_rtt_millis());
+    }
+
+    // optional int64 rtt_samples = 4;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_rtt_samples());
+    }
+
+    // optional int64 upgrade_setup_millis = 5;
+    if (cached_has_bits & 0x00000008u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_upgrade_setup_millis());
+    }
+
+    // optional int64 upgrade_setup_samples = 6;
+    if (cached_has_bits & 0x00000010u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_upgrade_setup_samples());
+    }
+
+    // optional int32 throughput_kbps = 1;
+    if (cached_has_bits & 0x00000020u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_throughput_kbps());
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void ConnectionsLog_LinkQuality::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ConnectionsLog_LinkQuality*>(
+      &from));
+}
+
+void ConnectionsLog_LinkQuality::MergeFrom(const ConnectionsLog_LinkQuality& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x0000003fu) {
+    if (cached_has_bits & 0x00000001u) {
+      throughput_samples_ = from.throughput_samples_;
+    }
+    if (cached_has_bits & 0x00000002u) {
+      rtt_millis_ = from.rtt_millis_;
+    }
+    if (cached_has_bits & 0x00000004u) {
+      rtt_samples_ = from.rtt_samples_;
+    }
+    if (cached_has_bits & 0x00000008u) {
+      upgrade_setup_millis_ = from.upgrade_setup_millis_;
+    }
+    if (cached_has_bits & 0x00000010u) {
+      upgrade_setup_samples_ = from.upgrade_setup_samples_;
+    }
+    if (cached_has_bits & 0x00000020u) {
+      throughput_kbps_ = from.throughput_kbps_;
+    }
+    _has_bits_[0] |= cached_has_bits;
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void ConnectionsLog_LinkQuality::CopyFrom(const ConnectionsLog_LinkQuality& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ConnectionsLog_LinkQuality::IsInitialized() const {
+  return true;
+}
+
+void ConnectionsLog_LinkQuality::InternalSwap(ConnectionsLog_LinkQuality* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ConnectionsLog_LinkQuality, throughput_kbps_)
+      + sizeof(ConnectionsLog_LinkQuality::throughput_kbps_)
+      - PROTOBUF_FIELD_OFFSET(ConnectionsLog_LinkQuality, throughput_samples_)>(
+          reinterpret_cast<char*>(&throughput_samples_),
+          reinterpret_cast<char*>(&other->throughput_samples_));
+}
+
+std::string ConnectionsLog_LinkQuality::GetTypeName() const {
+  return "location.nearby.analytics.proto.ConnectionsLog.LinkQuality";
+}
+
+
 // ===================================================================
 
 class ConnectionsLog_Payload::_Internal {
@@ -7234,6 +7636,9 @@ template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLo
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_Payload* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_Payload >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_Payload >(arena);
 }
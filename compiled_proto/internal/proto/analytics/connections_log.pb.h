@@ -46,7 +46,7 @@ struct TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto {
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::AuxiliaryParseTableField aux[]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[17]
+  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[18]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
   static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
@@ -95,6 +95,9 @@ extern ConnectionsLog_ErrorCodeDefaultTypeInternal _ConnectionsLog_ErrorCode_def
 class ConnectionsLog_EstablishedConnection;
 struct ConnectionsLog_EstablishedConnectionDefaultTypeInternal;
 extern ConnectionsLog_EstablishedConnectionDefaultTypeInternal _ConnectionsLog_EstablishedConnection_default_instance_;
+class ConnectionsLog_LinkQuality;
+struct ConnectionsLog_LinkQualityDefaultTypeInternal;
+extern ConnectionsLog_LinkQualityDefaultTypeInternal _ConnectionsLog_LinkQuality_default_instance_;
 class ConnectionsLog_Payload;
 struct ConnectionsLog_PayloadDefaultTypeInternal;
 extern ConnectionsLog_PayloadDefaultTypeInternal _ConnectionsLog_Payload_default_instance_;
@@ -125,6 +128,7 @@ template<> ::location::nearby::analytics::proto::ConnectionsLog_DiscoveryMetadat
 template<> ::location::nearby::analytics::proto::ConnectionsLog_DiscoveryPhase* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_DiscoveryPhase>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_ErrorCode* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ErrorCode>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection>(Arena*);
+template<> ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_LinkQuality>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_Payload* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_Payload>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_RawUwbRangingEvent* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_RawUwbRangingEvent>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_StrategySession* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_StrategySession>(Arena*);
@@ -2268,6 +2272,7 @@ class ConnectionsLog_EstablishedConnection final :
     kSentPayloadFieldNumber = 3,
     kReceivedPayloadFieldNumber = 4,
     kConnectionTokenFieldNumber = 7,
+    kLinkQualityFieldNumber = 9,
     kDurationMillisFieldNumber = 1,
     kMediumFieldNumber = 2,
     kDisconnectionReasonFieldNumber = 5,
@@ -2327,6 +2332,24 @@ class ConnectionsLog_EstablishedConnection final :
   std::string* _internal_mutable_connection_token();
   public:
 
+  // optional .location.nearby.analytics.proto.ConnectionsLog.LinkQuality link_quality = 9;
+  bool has_link_quality() const;
+  private:
+  bool _internal_has_link_quality() const;
+  public:
+  void clear_link_quality();
+  const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality& link_quality() const;
+  PROTOBUF_NODISCARD ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* release_link_quality();
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* mutable_link_quality();
+  void set_allocated_link_quality(::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* link_quality);
+  private:
+  const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality& _internal_link_quality() const;
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* _internal_mutable_link_quality();
+  public:
+  void unsafe_arena_set_allocated_link_quality(
+      ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* link_quality);
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* unsafe_arena_release_link_quality();
+
   // optional int64 duration_millis = 1;
   bool has_duration_millis() const;
   private:
@@ -2391,6 +2414,7 @@ class ConnectionsLog_EstablishedConnection final :
   ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_Payload > sent_payload_;
   ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_Payload > received_payload_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr connection_token_;
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* link_quality_;
   int64_t duration_millis_;
   int medium_;
   int disconnection_reason_;
@@ -2399,6 +2423,223 @@ class ConnectionsLog_EstablishedConnection final :
 };
 // -------------------------------------------------------------------
 
+class ConnectionsLog_LinkQuality final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.LinkQuality) */ {
+ public:
+  inline ConnectionsLog_LinkQuality() : ConnectionsLog_LinkQuality(nullptr) {}
+  ~ConnectionsLog_LinkQuality() override;
+  explicit constexpr ConnectionsLog_LinkQuality(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ConnectionsLog_LinkQuality(const ConnectionsLog_LinkQuality& from);
+  ConnectionsLog_LinkQuality(ConnectionsLog_LinkQuality&& from) noexcept
+    : ConnectionsLog_LinkQuality() {
+    *this = ::std::move(from);
+  }
+
+  inline ConnectionsLog_LinkQuality& operator=(const ConnectionsLog_LinkQuality& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ConnectionsLog_LinkQuality& operator=(ConnectionsLog_LinkQuality&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const ConnectionsLog_LinkQuality& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ConnectionsLog_LinkQuality* internal_default_instance() {
+    return reinterpret_cast<const ConnectionsLog_LinkQuality*>(
+               &_ConnectionsLog_LinkQuality_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    10;
+
+  friend void swap(ConnectionsLog_LinkQuality& a, ConnectionsLog_LinkQuality& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ConnectionsLog_LinkQuality* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ConnectionsLog_LinkQuality* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ConnectionsLog_LinkQuality* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ConnectionsLog_LinkQuality>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const ConnectionsLog_LinkQuality& from);
+  void MergeFrom(const ConnectionsLog_LinkQuality& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ConnectionsLog_LinkQuality* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.analytics.proto.ConnectionsLog.LinkQuality";
+  }
+  protected:
+  explicit ConnectionsLog_LinkQuality(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kThroughputSamplesFieldNumber = 2,
+    kRttMillisFieldNumber = 3,
+    kRttSamplesFieldNumber = 4,
+    kUpgradeSetupMillisFieldNumber = 5,
+    kUpgradeSetupSamplesFieldNumber = 6,
+    kThroughputKbpsFieldNumber = 1,
+  };
+  // optional int64 throughput_samples = 2;
+  bool has_throughput_samples() const;
+  private:
+  bool _internal_has_throughput_samples() const;
+  public:
+  void clear_throughput_samples();
+  int64_t throughput_samples() const;
+  void set_throughput_samples(int64_t value);
+  private:
+  int64_t _internal_throughput_samples() const;
+  void _internal_set_throughput_samples(int64_t value);
+  public:
+
+  // optional int64 rtt_millis = 3;
+  bool has_rtt_millis() const;
+  private:
+  bool _internal_has_rtt_millis() const;
+  public:
+  void clear_rtt_millis();
+  int64_t rtt_millis() const;
+  void set_rtt_millis(int64_t value);
+  private:
+  int64_t _internal_rtt_millis() const;
+  void _internal_set_rtt_millis(int64_t value);
+  public:
+
+  // optional int64 rtt_samples = 4;
+  bool has_rtt_samples() const;
+  private:
+  bool _internal_has_rtt_samples() const;
+  public:
+  void clear_rtt_samples();
+  int64_t rtt_samples() const;
+  void set_rtt_samples(int64_t value);
+  private:
+  int64_t _internal_rtt_samples() const;
+  void _internal_set_rtt_samples(int64_t value);
+  public:
+
+  // optional int64 upgrade_setup_millis = 5;
+  bool has_upgrade_setup_millis() const;
+  private:
+  bool _internal_has_upgrade_setup_millis() const;
+  public:
+  void clear_upgrade_setup_millis();
+  int64_t upgrade_setup_millis() const;
+  void set_upgrade_setup_millis(int64_t value);
+  private:
+  int64_t _internal_upgrade_setup_millis() const;
+  void _internal_set_upgrade_setup_millis(int64_t value);
+  public:
+
+  // optional int64 upgrade_setup_samples = 6;
+  bool has_upgrade_setup_samples() const;
+  private:
+  bool _internal_has_upgrade_setup_samples() const;
+  public:
+  void clear_upgrade_setup_samples();
+  int64_t upgrade_setup_samples() const;
+  void set_upgrade_setup_samples(int64_t value);
+  private:
+  int64_t _internal_upgrade_setup_samples() const;
+  void _internal_set_upgrade_setup_samples(int64_t value);
+  public:
+
+  // optional int32 throughput_kbps = 1;
+  bool has_throughput_kbps() const;
+  private:
+  bool _internal_has_throughput_kbps() const;
+  public:
+  void clear_throughput_kbps();
+  int32_t throughput_kbps() const;
+  void set_throughput_kbps(int32_t value);
+  private:
+  int32_t _internal_throughput_kbps() const;
+  void _internal_set_throughput_kbps(int32_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.analytics.proto.ConnectionsLog.LinkQuality)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  int64_t throughput_samples_;
+  int64_t rtt_millis_;
+  int64_t rtt_samples_;
+  int64_t upgrade_setup_millis_;
+  int64_t upgrade_setup_samples_;
+  int32_t throughput_kbps_;
+  friend struct ::TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto;
+};
+// -------------------------------------------------------------------
+
 class ConnectionsLog_Payload final :
     public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.Payload) */ {
  public:
@@ -2445,7 +2686,7 @@ class ConnectionsLog_Payload final :
                &_ConnectionsLog_Payload_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    10;
+    11;
 
   friend void swap(ConnectionsLog_Payload& a, ConnectionsLog_Payload& b) {
     a.Swap(&b);
@@ -2662,7 +2903,7 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
                &_ConnectionsLog_BandwidthUpgradeAttempt_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    11;
+    12;
 
   friend void swap(ConnectionsLog_BandwidthUpgradeAttempt& a, ConnectionsLog_BandwidthUpgradeAttempt& b) {
     a.Swap(&b);
@@ -2927,7 +3168,7 @@ class ConnectionsLog_ErrorCode final :
                &_ConnectionsLog_ErrorCode_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(ConnectionsLog_ErrorCode& a, ConnectionsLog_ErrorCode& b) {
     a.Swap(&b);
@@ -3324,7 +3565,7 @@ class ConnectionsLog_AdvertisingMetadata final :
                &_ConnectionsLog_AdvertisingMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(ConnectionsLog_AdvertisingMetadata& a, ConnectionsLog_AdvertisingMetadata& b) {
     a.Swap(&b);
@@ -3511,7 +3752,7 @@ class ConnectionsLog_DiscoveryMetadata final :
                &_ConnectionsLog_DiscoveryMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    15;
 
   friend void swap(ConnectionsLog_DiscoveryMetadata& a, ConnectionsLog_DiscoveryMetadata& b) {
     a.Swap(&b);
@@ -3683,7 +3924,7 @@ class ConnectionsLog_ConnectionAttemptMetadata final :
                &_ConnectionsLog_ConnectionAttemptMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    16;
 
   friend void swap(ConnectionsLog_ConnectionAttemptMetadata& a, ConnectionsLog_ConnectionAttemptMetadata& b) {
     a.Swap(&b);
@@ -4015,7 +4256,7 @@ class ConnectionsLog final :
                &_ConnectionsLog_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    17;
 
   friend void swap(ConnectionsLog& a, ConnectionsLog& b) {
     a.Swap(&b);
@@ -4089,6 +4330,7 @@ class ConnectionsLog final :
   typedef ConnectionsLog_ConnectionRequest ConnectionRequest;
   typedef ConnectionsLog_ConnectionAttempt ConnectionAttempt;
   typedef ConnectionsLog_EstablishedConnection EstablishedConnection;
+  typedef ConnectionsLog_LinkQuality LinkQuality;
   typedef ConnectionsLog_Payload Payload;
   typedef ConnectionsLog_BandwidthUpgradeAttempt BandwidthUpgradeAttempt;
   typedef ConnectionsLog_ErrorCode ErrorCode;
@@ -6185,7 +6427,7 @@ inline void ConnectionsLog_ConnectionAttempt::set_allocated_connection_attempt_m
 
 // optional int64 duration_millis = 1;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_duration_millis() const {
-  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_duration_millis() const {
@@ -6193,7 +6435,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_duration_millis() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_duration_millis() {
   duration_millis_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000002u;
+  _has_bits_[0] &= ~0x00000004u;
 }
 inline int64_t ConnectionsLog_EstablishedConnection::_internal_duration_millis() const {
   return duration_millis_;
@@ -6203,7 +6445,7 @@ inline int64_t ConnectionsLog_EstablishedConnection::duration_millis() const {
   return _internal_duration_millis();
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_duration_millis(int64_t value) {
-  _has_bits_[0] |= 0x00000002u;
+  _has_bits_[0] |= 0x00000004u;
   duration_millis_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_duration_millis(int64_t value) {
@@ -6213,7 +6455,7 @@ inline void ConnectionsLog_EstablishedConnection::set_duration_millis(int64_t va
 
 // optional .location.nearby.proto.connections.Medium medium = 2;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_medium() const {
-  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_medium() const {
@@ -6221,7 +6463,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_medium() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_medium() {
   medium_ = 0;
-  _has_bits_[0] &= ~0x00000004u;
+  _has_bits_[0] &= ~0x00000008u;
 }
 inline ::location::nearby::proto::connections::Medium ConnectionsLog_EstablishedConnection::_internal_medium() const {
   return static_cast< ::location::nearby::proto::connections::Medium >(medium_);
@@ -6232,7 +6474,7 @@ inline ::location::nearby::proto::connections::Medium ConnectionsLog_Established
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_medium(::location::nearby::proto::connections::Medium value) {
   assert(::location::nearby::proto::connections::Medium_IsValid(value));
-  _has_bits_[0] |= 0x00000004u;
+  _has_bits_[0] |= 0x00000008u;
   medium_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_medium(::location::nearby::proto::connections::Medium value) {
@@ -6322,7 +6564,7 @@ ConnectionsLog_EstablishedConnection::received_payload() const {
 
 // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_disconnection_reason() const {
-  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_disconnection_reason() const {
@@ -6330,7 +6572,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_disconnection_reason() con
 }
 inline void ConnectionsLog_EstablishedConnection::clear_disconnection_reason() {
   disconnection_reason_ = 0;
-  _has_bits_[0] &= ~0x00000008u;
+  _has_bits_[0] &= ~0x00000010u;
 }
 inline ::location::nearby::proto::connections::DisconnectionReason ConnectionsLog_EstablishedConnection::_internal_disconnection_reason() const {
   return static_cast< ::location::nearby::proto::connections::DisconnectionReason >(disconnection_reason_);
@@ -6341,7 +6583,7 @@ inline ::location::nearby::proto::connections::DisconnectionReason ConnectionsLo
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_disconnection_reason(::location::nearby::proto::connections::DisconnectionReason value) {
   assert(::location::nearby::proto::connections::DisconnectionReason_IsValid(value));
-  _has_bits_[0] |= 0x00000008u;
+  _has_bits_[0] |= 0x00000010u;
   disconnection_reason_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_disconnection_reason(::location::nearby::proto::connections::DisconnectionReason value) {
@@ -6351,7 +6593,7 @@ inline void ConnectionsLog_EstablishedConnection::set_disconnection_reason(::loc
 
 // optional int64 client_flow_id = 6;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_client_flow_id() const {
-  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_client_flow_id() const {
@@ -6359,7 +6601,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_client_flow_id() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_client_flow_id() {
   client_flow_id_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000010u;
+  _has_bits_[0] &= ~0x00000020u;
 }
 inline int64_t ConnectionsLog_EstablishedConnection::_internal_client_flow_id() const {
   return client_flow_id_;
@@ -6369,7 +6611,7 @@ inline int64_t ConnectionsLog_EstablishedConnection::client_flow_id() const {
   return _internal_client_flow_id();
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_client_flow_id(int64_t value) {
-  _has_bits_[0] |= 0x00000010u;
+  _has_bits_[0] |= 0x00000020u;
   client_flow_id_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_client_flow_id(int64_t value) {
@@ -6446,6 +6688,268 @@ inline void ConnectionsLog_EstablishedConnection::set_allocated_connection_token
   // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.connection_token)
 }
 
+// optional .location.nearby.analytics.proto.ConnectionsLog.LinkQuality link_quality = 9;
+inline bool ConnectionsLog_EstablishedConnection::_internal_has_link_quality() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  PROTOBUF_ASSUME(!value || link_quality_ != nullptr);
+  return value;
+}
+inline bool ConnectionsLog_EstablishedConnection::has_link_quality() const {
+  return _internal_has_link_quality();
+}
+inline void ConnectionsLog_EstablishedConnection::clear_link_quality() {
+  if (link_quality_ != nullptr) link_quality_->Clear();
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality& ConnectionsLog_EstablishedConnection::_internal_link_quality() const {
+  const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* p = link_quality_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality&>(
+      ::location::nearby::analytics::proto::_ConnectionsLog_LinkQuality_default_instance_);
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality& ConnectionsLog_EstablishedConnection::link_quality() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.link_quality)
+  return _internal_link_quality();
+}
+inline void ConnectionsLog_EstablishedConnection::unsafe_arena_set_allocated_link_quality(
+    ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* link_quality) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(link_quality_);
+  }
+  link_quality_ = link_quality;
+  if (link_quality) {
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.link_quality)
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* ConnectionsLog_EstablishedConnection::release_link_quality() {
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* temp = link_quality_;
+  link_quality_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* ConnectionsLog_EstablishedConnection::unsafe_arena_release_link_quality() {
+  // @@protoc_insertion_point(field_release:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.link_quality)
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* temp = link_quality_;
+  link_quality_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* ConnectionsLog_EstablishedConnection::_internal_mutable_link_quality() {
+  _has_bits_[0] |= 0x00000002u;
+  if (link_quality_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_LinkQuality>(GetArenaForAllocation());
+    link_quality_ = p;
+  }
+  return link_quality_;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* ConnectionsLog_EstablishedConnection::mutable_link_quality() {
+  ::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* _msg = _internal_mutable_link_quality();
+  // @@protoc_insertion_point(field_mutable:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.link_quality)
+  return _msg;
+}
+inline void ConnectionsLog_EstablishedConnection::set_allocated_link_quality(::location::nearby::analytics::proto::ConnectionsLog_LinkQuality* link_quality) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete link_quality_;
+  }
+  if (link_quality) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::analytics::proto::ConnectionsLog_LinkQuality>::GetOwningArena(link_quality);
+    if (message_arena != submessage_arena) {
+      link_quality = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, link_quality, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  link_quality_ = link_quality;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.link_quality)
+}
+
+// -------------------------------------------------------------------
+
+// ConnectionsLog_LinkQuality
+
+// optional int32 throughput_kbps = 1;
+inline bool ConnectionsLog_LinkQuality::_internal_has_throughput_kbps() const {
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_throughput_kbps() const {
+  return _internal_has_throughput_kbps();
+}
+inline void ConnectionsLog_LinkQuality::clear_throughput_kbps() {
+  throughput_kbps_ = 0;
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline int32_t ConnectionsLog_LinkQuality::_internal_throughput_kbps() const {
+  return throughput_kbps_;
+}
+inline int32_t ConnectionsLog_LinkQuality::throughput_kbps() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.throughput_kbps)
+  return _internal_throughput_kbps();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_throughput_kbps(int32_t value) {
+  _has_bits_[0] |= 0x00000020u;
+  throughput_kbps_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_throughput_kbps(int32_t value) {
+  _internal_set_throughput_kbps(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.throughput_kbps)
+}
+
+// optional int64 throughput_samples = 2;
+inline bool ConnectionsLog_LinkQuality::_internal_has_throughput_samples() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_throughput_samples() const {
+  return _internal_has_throughput_samples();
+}
+inline void ConnectionsLog_LinkQuality::clear_throughput_samples() {
+  throughput_samples_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline int64_t ConnectionsLog_LinkQuality::_internal_throughput_samples() const {
+  return throughput_samples_;
+}
+inline int64_t ConnectionsLog_LinkQuality::throughput_samples() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.throughput_samples)
+  return _internal_throughput_samples();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_throughput_samples(int64_t value) {
+  _has_bits_[0] |= 0x00000001u;
+  throughput_samples_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_throughput_samples(int64_t value) {
+  _internal_set_throughput_samples(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.throughput_samples)
+}
+
+// optional int64 rtt_millis = 3;
+inline bool ConnectionsLog_LinkQuality::_internal_has_rtt_millis() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_rtt_millis() const {
+  return _internal_has_rtt_millis();
+}
+inline void ConnectionsLog_LinkQuality::clear_rtt_millis() {
+  rtt_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline int64_t ConnectionsLog_LinkQuality::_internal_rtt_millis() const {
+  return rtt_millis_;
+}
+inline int64_t ConnectionsLog_LinkQuality::rtt_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.rtt_millis)
+  return _internal_rtt_millis();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_rtt_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000002u;
+  rtt_millis_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_rtt_millis(int64_t value) {
+  _internal_set_rtt_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.rtt_millis)
+}
+
+// optional int64 rtt_samples = 4;
+inline bool ConnectionsLog_LinkQuality::_internal_has_rtt_samples() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_rtt_samples() const {
+  return _internal_has_rtt_samples();
+}
+inline void ConnectionsLog_LinkQuality::clear_rtt_samples() {
+  rtt_samples_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline int64_t ConnectionsLog_LinkQuality::_internal_rtt_samples() const {
+  return rtt_samples_;
+}
+inline int64_t ConnectionsLog_LinkQuality::rtt_samples() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.rtt_samples)
+  return _internal_rtt_samples();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_rtt_samples(int64_t value) {
+  _has_bits_[0] |= 0x00000004u;
+  rtt_samples_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_rtt_samples(int64_t value) {
+  _internal_set_rtt_samples(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.rtt_samples)
+}
+
+// optional int64 upgrade_setup_millis = 5;
+inline bool ConnectionsLog_LinkQuality::_internal_has_upgrade_setup_millis() const {
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_upgrade_setup_millis() const {
+  return _internal_has_upgrade_setup_millis();
+}
+inline void ConnectionsLog_LinkQuality::clear_upgrade_setup_millis() {
+  upgrade_setup_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline int64_t ConnectionsLog_LinkQuality::_internal_upgrade_setup_millis() const {
+  return upgrade_setup_millis_;
+}
+inline int64_t ConnectionsLog_LinkQuality::upgrade_setup_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.upgrade_setup_millis)
+  return _internal_upgrade_setup_millis();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_upgrade_setup_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000008u;
+  upgrade_setup_millis_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_upgrade_setup_millis(int64_t value) {
+  _internal_set_upgrade_setup_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.upgrade_setup_millis)
+}
+
+// optional int64 upgrade_setup_samples = 6;
+inline bool ConnectionsLog_LinkQuality::_internal_has_upgrade_setup_samples() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_LinkQuality::has_upgrade_setup_samples() const {
+  return _internal_has_upgrade_setup_samples();
+}
+inline void ConnectionsLog_LinkQuality::clear_upgrade_setup_samples() {
+  upgrade_setup_samples_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline int64_t ConnectionsLog_LinkQuality::_internal_upgrade_setup_samples() const {
+  return upgrade_setup_samples_;
+}
+inline int64_t ConnectionsLog_LinkQuality::upgrade_setup_samples() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.upgrade_setup_samples)
+  return _internal_upgrade_setup_samples();
+}
+inline void ConnectionsLog_LinkQuality::_internal_set_upgrade_setup_samples(int64_t value) {
+  _has_bits_[0] |= 0x00000010u;
+  upgrade_setup_samples_ = value;
+}
+inline void ConnectionsLog_LinkQuality::set_upgrade_setup_samples(int64_t value) {
+  _internal_set_upgrade_setup_samples(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.LinkQuality.upgrade_setup_samples)
+}
+
 // -------------------------------------------------------------------
 
 // ConnectionsLog_Payload
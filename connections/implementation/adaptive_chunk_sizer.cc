@@ -0,0 +1,72 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/adaptive_chunk_sizer.h"
+
+#include <algorithm>
+
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+namespace {
+// Weight of the latest measurement in the throughput average.
+constexpr double kThroughputWeight = 0.25;
+}  // namespace
+
+constexpr int AdaptiveChunkSizer::kMinChunkSize;
+constexpr absl::Duration AdaptiveChunkSizer::kTargetChunkDuration;
+
+int AdaptiveChunkSizer::GetChunkSize(proto::connections::Medium medium,
+                                     int max_chunk_size) const {
+  MutexLock lock(&mutex_);
+  auto item = mediums_.find(medium);
+  if (item == mediums_.end() || item->second.chunk_size == 0) {
+    return max_chunk_size;
+  }
+  return std::min(item->second.chunk_size, max_chunk_size);
+}
+
+void AdaptiveChunkSizer::OnChunkSent(proto::connections::Medium medium,
+                                     int size, absl::Duration duration) {
+  if (size <= 0) return;
+  // Too quick to be measured; as good as infinitely fast.
+  duration = std::max(duration, absl::Microseconds(1));
+  double throughput = size / absl::ToDoubleSeconds(duration);
+
+  MutexLock lock(&mutex_);
+  MediumState& state = mediums_[medium];
+  if (state.chunk_size == 0) {
+    state.throughput = throughput;
+    state.chunk_size = size;
+  } else {
+    state.throughput = kThroughputWeight * throughput +
+                       (1 - kThroughputWeight) * state.throughput;
+  }
+
+  double target =
+      state.throughput * absl::ToDoubleSeconds(kTargetChunkDuration);
+  double chunk_size = std::clamp(target, state.chunk_size / 2.0,
+                                 state.chunk_size * 2.0);
+  // Not capped from above; GetChunkSize() does that, against the largest
+  // packet the channels in use can take.
+  state.chunk_size = std::max(static_cast<int>(std::min(chunk_size, 1e9)),
+                              kMinChunkSize);
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,72 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_ADAPTIVE_CHUNK_SIZER_H_
+#define CORE_INTERNAL_ADAPTIVE_CHUNK_SIZER_H_
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/mutex.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Picks the size of outgoing payload chunks for each medium.
+//
+// Small chunks keep progress updates and cancellation responsive on slow
+// links; large chunks keep the per-chunk overhead (framing, encryption, one
+// write per chunk) down on fast ones. The sizer aims for chunks that take
+// about |kTargetChunkDuration| to send: it tracks a moving average of the
+// throughput measured on each medium, and sizes chunks to match, changing the
+// size by at most a factor of two at a time.
+//
+// The time it takes to write a chunk stands in for the round trip time; the
+// channels do not expose anything closer to it.
+class AdaptiveChunkSizer {
+ public:
+  static constexpr int kMinChunkSize = 4 * 1024;
+  static constexpr absl::Duration kTargetChunkDuration =
+      absl::Milliseconds(50);
+
+  // Returns the size of the next chunk to send over |medium|, which is never
+  // more than |max_chunk_size|. Until something has been sent over |medium|,
+  // that is |max_chunk_size|.
+  int GetChunkSize(proto::connections::Medium medium, int max_chunk_size) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Records that sending a chunk of |size| bytes over |medium| took
+  // |duration|.
+  void OnChunkSent(proto::connections::Medium medium, int size,
+                   absl::Duration duration) ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct MediumState {
+    // Moving average, in bytes per second.
+    double throughput = 0;
+    int chunk_size = 0;
+  };
+
+  mutable Mutex mutex_;
+  absl::flat_hash_map<proto::connections::Medium, MediumState> mediums_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_ADAPTIVE_CHUNK_SIZER_H_
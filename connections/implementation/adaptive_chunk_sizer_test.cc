@@ -0,0 +1,116 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/adaptive_chunk_sizer.h"
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+constexpr int kMaxChunkSize = 64 * 1024;
+
+TEST(AdaptiveChunkSizerTest, StartsAtMaxChunkSize) {
+  AdaptiveChunkSizer sizer;
+
+  EXPECT_EQ(sizer.GetChunkSize(Medium::BLUETOOTH, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, ShrinksOnSlowMedium) {
+  AdaptiveChunkSizer sizer;
+
+  // 64KB in a second; a 50ms chunk is ~3.2KB, below the minimum.
+  for (int i = 0; i < 20; ++i) {
+    int size = sizer.GetChunkSize(Medium::BLUETOOTH, kMaxChunkSize);
+    sizer.OnChunkSent(Medium::BLUETOOTH, size,
+                      absl::Seconds(1) * size / kMaxChunkSize);
+  }
+
+  EXPECT_EQ(sizer.GetChunkSize(Medium::BLUETOOTH, kMaxChunkSize),
+            AdaptiveChunkSizer::kMinChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, HalvesAtMostPerChunk) {
+  AdaptiveChunkSizer sizer;
+
+  sizer.OnChunkSent(Medium::BLUETOOTH, kMaxChunkSize, absl::Seconds(10));
+
+  EXPECT_EQ(sizer.GetChunkSize(Medium::BLUETOOTH, kMaxChunkSize),
+            kMaxChunkSize / 2);
+}
+
+TEST(AdaptiveChunkSizerTest, GrowsBackWhenMediumSpeedsUp) {
+  AdaptiveChunkSizer sizer;
+  for (int i = 0; i < 10; ++i) {
+    int size = sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize);
+    sizer.OnChunkSent(Medium::WIFI_LAN, size, absl::Seconds(1));
+  }
+  int slow_size = sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize);
+
+  for (int i = 0; i < 20; ++i) {
+    int size = sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize);
+    sizer.OnChunkSent(Medium::WIFI_LAN, size, absl::Milliseconds(1));
+  }
+
+  EXPECT_LT(slow_size, kMaxChunkSize);
+  EXPECT_EQ(sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, SettlesOnTargetDuration) {
+  AdaptiveChunkSizer sizer;
+  // 400KB/s; 50ms worth of that is 20KB.
+  constexpr double kBytesPerSecond = 400 * 1000;
+
+  for (int i = 0; i < 50; ++i) {
+    int size = sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize);
+    sizer.OnChunkSent(Medium::WIFI_LAN, size,
+                      absl::Seconds(size / kBytesPerSecond));
+  }
+
+  int size = sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize);
+  EXPECT_GE(size, 19 * 1000);
+  EXPECT_LE(size, 21 * 1000);
+}
+
+TEST(AdaptiveChunkSizerTest, KeepsMediumsApart) {
+  AdaptiveChunkSizer sizer;
+
+  sizer.OnChunkSent(Medium::BLUETOOTH, kMaxChunkSize, absl::Seconds(10));
+
+  EXPECT_LT(sizer.GetChunkSize(Medium::BLUETOOTH, kMaxChunkSize),
+            kMaxChunkSize);
+  EXPECT_EQ(sizer.GetChunkSize(Medium::WIFI_LAN, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+TEST(AdaptiveChunkSizerTest, NeverExceedsMaxChunkSize) {
+  AdaptiveChunkSizer sizer;
+
+  sizer.OnChunkSent(Medium::WIFI_LAN, kMaxChunkSize, absl::Milliseconds(1));
+
+  EXPECT_EQ(sizer.GetChunkSize(Medium::WIFI_LAN, 1024), 1024);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
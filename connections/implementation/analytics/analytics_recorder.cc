@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "absl/time/time.h"
+#include "connections/implementation/analytics/link_quality_estimator.h"
 #include "internal/analytics/event_logger.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
@@ -1233,6 +1234,30 @@ void AnalyticsRecorder::LogicalConnection::FinishPhysicalConnection(
       absl::ToUnixMillis(SystemClock::ElapsedRealtime()) -
       established_connection->duration_millis());
 
+  // Estimates without samples are priors, not measurements; leave them out.
+  LinkQualityEstimator::Estimate estimate =
+      LinkQualityEstimator::GetInstance().GetEstimate(
+          established_connection->medium());
+  if (estimate.throughput_samples > 0) {
+    ConnectionsLog::LinkQuality *link_quality =
+        established_connection->mutable_link_quality();
+    link_quality->set_throughput_kbps(estimate.throughput_kbps);
+    link_quality->set_throughput_samples(estimate.throughput_samples);
+  }
+  if (estimate.rtt_samples > 0) {
+    ConnectionsLog::LinkQuality *link_quality =
+        established_connection->mutable_link_quality();
+    link_quality->set_rtt_millis(absl::ToInt64Milliseconds(estimate.rtt));
+    link_quality->set_rtt_samples(estimate.rtt_samples);
+  }
+  if (estimate.upgrade_setup_samples > 0) {
+    ConnectionsLog::LinkQuality *link_quality =
+        established_connection->mutable_link_quality();
+    link_quality->set_upgrade_setup_millis(
+        absl::ToInt64Milliseconds(estimate.upgrade_setup_time));
+    link_quality->set_upgrade_setup_samples(estimate.upgrade_setup_samples);
+  }
+
   // Add any not-yet-finished payloads to this EstablishedConnection.
   std::vector<ConnectionsLog::Payload> in_payloads =
       ResolvePendingPayloads(incoming_payloads_, reason);
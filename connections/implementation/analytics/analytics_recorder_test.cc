@@ -23,6 +23,7 @@
 #include "gtest/gtest.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/connection_attempt_metadata_params.h"
+#include "connections/implementation/analytics/link_quality_estimator.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/error_code_params.h"
 #include "internal/platform/error_code_recorder.h"
@@ -740,6 +741,45 @@ TEST(AnalyticsRecorderTest, UnfinishedEstablishedConnectionsAddedAsUnfinished) {
                 >)pb")));
 }
 
+TEST(AnalyticsRecorderTest, EstablishedConnectionsCarryLinkQuality) {
+  connections::Strategy strategy = connections::Strategy::kP2pStar;
+  std::vector<Medium> mediums = {BLE, BLUETOOTH};
+  std::string endpoint_id = "endpoint_id";
+  std::string connection_token = "connection_token";
+  LinkQualityEstimator::GetInstance().ResetForTesting();
+  LinkQualityEstimator::GetInstance().RecordRtt(BLUETOOTH,
+                                                absl::Milliseconds(40));
+
+  CountDownLatch client_session_done_latch(1);
+  FakeEventLogger event_logger(client_session_done_latch);
+  AnalyticsRecorder analytics_recorder(&event_logger);
+
+  analytics_recorder.OnStartAdvertising(strategy, mediums);
+  analytics_recorder.OnConnectionEstablished(endpoint_id, BLUETOOTH,
+                                             connection_token);
+  analytics_recorder.OnConnectionClosed(endpoint_id, BLUETOOTH, UPGRADED);
+
+  analytics_recorder.LogSession();
+  ASSERT_TRUE(client_session_done_latch.Await(kDefaultTimeout).result());
+  LinkQualityEstimator::GetInstance().ResetForTesting();
+
+  // Only the round trip time has been measured; the rest are left out.
+  EXPECT_THAT(event_logger.GetLoggedClientSession(), Partially(EqualsProto(R"pb(
+                strategy_session <
+                  established_connection <
+                    medium: BLUETOOTH
+                    disconnection_reason: UPGRADED
+                    connection_token: "connection_token"
+                    link_quality < rtt_millis: 40 rtt_samples: 1 >
+                  >
+                >)pb")));
+  EXPECT_FALSE(event_logger.GetLoggedClientSession()
+                   .strategy_session(0)
+                   .established_connection(0)
+                   .link_quality()
+                   .has_throughput_kbps());
+}
+
 TEST(AnalyticsRecorderTest, OutgoingPayloadUpgraded) {
   connections::Strategy strategy = connections::Strategy::kP2pStar;
   std::vector<Medium> mediums = {BLE, BLUETOOTH};
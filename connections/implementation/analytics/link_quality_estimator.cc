@@ -0,0 +1,245 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/link_quality_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "connections/implementation/analytics/throughput_recorder.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+
+namespace {
+// Weight of a new sample in the moving averages. Round trip times are smoothed
+// more, as they are noisier.
+constexpr double kThroughputWeight = 0.25;
+constexpr double kRttWeight = 0.125;
+constexpr double kUpgradeSetupWeight = 0.25;
+// Round trips taken on the current link by the upgrade protocol, on top of
+// setting up the upgraded channel.
+constexpr int kUpgradeRoundTrips = 3;
+
+double Average(double average, double sample, double weight,
+               std::int64_t samples) {
+  return samples == 0 ? sample : average + weight * (sample - average);
+}
+
+absl::Duration Average(absl::Duration average, absl::Duration sample,
+                       double weight, std::int64_t samples) {
+  return samples == 0 ? sample : average + weight * (sample - average);
+}
+}  // namespace
+
+LinkQualityEstimator& LinkQualityEstimator::GetInstance() {
+  static LinkQualityEstimator* instance = new LinkQualityEstimator();
+  return *instance;
+}
+
+void LinkQualityEstimator::RecordThroughput(Medium medium, std::int64_t bytes,
+                                            absl::Duration duration) {
+  if (bytes < kMinThroughputSampleBytes || duration <= absl::ZeroDuration()) {
+    return;
+  }
+  int throughput_kbps = ThroughputRecorder::CalculateThroughputKBps(
+      bytes, absl::ToInt64Milliseconds(duration));
+  MutexLock lock(&mutex_);
+  Estimate& estimate = estimates_[medium];
+  estimate.medium = medium;
+  estimate.throughput_kbps = std::lround(
+      Average(estimate.throughput_kbps, throughput_kbps, kThroughputWeight,
+              estimate.throughput_samples));
+  ++estimate.throughput_samples;
+}
+
+void LinkQualityEstimator::RecordRtt(Medium medium, absl::Duration rtt) {
+  if (rtt < absl::ZeroDuration()) return;
+  MutexLock lock(&mutex_);
+  Estimate& estimate = estimates_[medium];
+  estimate.medium = medium;
+  estimate.rtt = Average(estimate.rtt, rtt, kRttWeight, estimate.rtt_samples);
+  ++estimate.rtt_samples;
+}
+
+void LinkQualityEstimator::RecordUpgradeSetupTime(Medium medium,
+                                                  absl::Duration duration) {
+  if (duration < absl::ZeroDuration()) return;
+  MutexLock lock(&mutex_);
+  Estimate& estimate = estimates_[medium];
+  estimate.medium = medium;
+  estimate.upgrade_setup_time =
+      Average(estimate.upgrade_setup_time, duration, kUpgradeSetupWeight,
+              estimate.upgrade_setup_samples);
+  ++estimate.upgrade_setup_samples;
+}
+
+void LinkQualityEstimator::OnProbeSent(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  // An earlier probe still unacked is taken as lost.
+  probes_sent_[endpoint_id] = SystemClock::ElapsedRealtime();
+}
+
+void LinkQualityEstimator::OnProbeAcked(const std::string& endpoint_id,
+                                        Medium medium) {
+  absl::Time sent;
+  {
+    MutexLock lock(&mutex_);
+    auto item = probes_sent_.find(endpoint_id);
+    if (item == probes_sent_.end()) return;
+    sent = item->second;
+    probes_sent_.erase(item);
+  }
+  RecordRtt(medium, SystemClock::ElapsedRealtime() - sent);
+}
+
+void LinkQualityEstimator::ForgetEndpoint(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  probes_sent_.erase(endpoint_id);
+}
+
+LinkQualityEstimator::Estimate LinkQualityEstimator::GetEstimate(
+    Medium medium) const {
+  MutexLock lock(&mutex_);
+  return GetEstimateLocked(medium);
+}
+
+std::vector<LinkQualityEstimator::Estimate> LinkQualityEstimator::GetSnapshot()
+    const {
+  MutexLock lock(&mutex_);
+  std::vector<Estimate> snapshot;
+  snapshot.reserve(estimates_.size());
+  for (const auto& item : estimates_) {
+    snapshot.push_back(GetEstimateLocked(item.first));
+  }
+  std::sort(snapshot.begin(), snapshot.end(),
+            [](const Estimate& a, const Estimate& b) {
+              return a.medium < b.medium;
+            });
+  return snapshot;
+}
+
+double LinkQualityEstimator::GetExpectedUpgradeGain(
+    Medium current, Medium candidate, absl::Duration horizon) const {
+  Estimate current_estimate;
+  Estimate candidate_estimate;
+  {
+    MutexLock lock(&mutex_);
+    current_estimate = GetEstimateLocked(current);
+    candidate_estimate = GetEstimateLocked(candidate);
+  }
+  double horizon_seconds = absl::ToDoubleSeconds(horizon);
+  double stay_kb = current_estimate.throughput_kbps * horizon_seconds;
+  if (stay_kb <= 0) return std::numeric_limits<double>::infinity();
+
+  double setup_seconds = std::min(
+      absl::ToDoubleSeconds(candidate_estimate.upgrade_setup_time +
+                            kUpgradeRoundTrips * current_estimate.rtt),
+      horizon_seconds);
+  double upgrade_kb =
+      current_estimate.throughput_kbps * setup_seconds +
+      candidate_estimate.throughput_kbps * (horizon_seconds - setup_seconds);
+  return upgrade_kb / stay_kb;
+}
+
+void LinkQualityEstimator::ResetForTesting() {
+  MutexLock lock(&mutex_);
+  estimates_.clear();
+  probes_sent_.clear();
+}
+
+LinkQualityEstimator::Estimate LinkQualityEstimator::GetPrior(Medium medium) {
+  Estimate prior;
+  prior.medium = medium;
+  switch (medium) {
+    case Medium::BLUETOOTH:
+      prior.throughput_kbps = 150;
+      prior.rtt = absl::Milliseconds(40);
+      prior.upgrade_setup_time = absl::Seconds(3);
+      break;
+    case Medium::BLE:
+    case Medium::BLE_L2CAP:
+      prior.throughput_kbps = 10;
+      prior.rtt = absl::Milliseconds(100);
+      prior.upgrade_setup_time = absl::Seconds(5);
+      break;
+    case Medium::WIFI_LAN:
+      prior.throughput_kbps = 5000;
+      prior.rtt = absl::Milliseconds(10);
+      prior.upgrade_setup_time = absl::Seconds(1);
+      break;
+    case Medium::WIFI_HOTSPOT:
+      prior.throughput_kbps = 4000;
+      prior.rtt = absl::Milliseconds(10);
+      prior.upgrade_setup_time = absl::Seconds(8);
+      break;
+    case Medium::WIFI_DIRECT:
+      prior.throughput_kbps = 5000;
+      prior.rtt = absl::Milliseconds(10);
+      prior.upgrade_setup_time = absl::Seconds(6);
+      break;
+    case Medium::WIFI_AWARE:
+      prior.throughput_kbps = 2500;
+      prior.rtt = absl::Milliseconds(20);
+      prior.upgrade_setup_time = absl::Seconds(5);
+      break;
+    case Medium::WEB_RTC:
+      prior.throughput_kbps = 1000;
+      prior.rtt = absl::Milliseconds(80);
+      prior.upgrade_setup_time = absl::Seconds(4);
+      break;
+    case Medium::USB:
+      prior.throughput_kbps = 10000;
+      prior.rtt = absl::Milliseconds(5);
+      prior.upgrade_setup_time = absl::Seconds(1);
+      break;
+    default:
+      prior.throughput_kbps = 100;
+      prior.rtt = absl::Milliseconds(100);
+      prior.upgrade_setup_time = absl::Seconds(5);
+      break;
+  }
+  return prior;
+}
+
+LinkQualityEstimator::Estimate LinkQualityEstimator::GetEstimateLocked(
+    Medium medium) const {
+  Estimate estimate = GetPrior(medium);
+  auto item = estimates_.find(medium);
+  if (item == estimates_.end()) return estimate;
+  const Estimate& measured = item->second;
+  if (measured.throughput_samples > 0) {
+    estimate.throughput_kbps = measured.throughput_kbps;
+    estimate.throughput_samples = measured.throughput_samples;
+  }
+  if (measured.rtt_samples > 0) {
+    estimate.rtt = measured.rtt;
+    estimate.rtt_samples = measured.rtt_samples;
+  }
+  if (measured.upgrade_setup_samples > 0) {
+    estimate.upgrade_setup_time = measured.upgrade_setup_time;
+    estimate.upgrade_setup_samples = measured.upgrade_setup_samples;
+  }
+  return estimate;
+}
+
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,108 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_LINK_QUALITY_ESTIMATOR_H_
+#define NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_LINK_QUALITY_ESTIMATOR_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/mutex.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+
+// Per-medium estimates of what links to remote devices deliver, for the whole
+// process: their throughput, as measured by ThroughputRecorder on payload
+// transfers; their round trip time, as measured by KeepAlive probes the remote
+// device acks; and how long setting up an upgraded channel takes.
+//
+// Estimates are exponentially weighted moving averages of the samples. For
+// mediums without samples, a fixed prior is returned instead.
+class LinkQualityEstimator {
+ public:
+  using Medium = location::nearby::proto::connections::Medium;
+
+  struct Estimate {
+    Medium medium = Medium::UNKNOWN_MEDIUM;
+    int throughput_kbps = 0;
+    std::int64_t throughput_samples = 0;
+    absl::Duration rtt = absl::ZeroDuration();
+    std::int64_t rtt_samples = 0;
+    absl::Duration upgrade_setup_time = absl::ZeroDuration();
+    std::int64_t upgrade_setup_samples = 0;
+  };
+
+  // Smaller transfers are bound by latency more than by throughput, and are
+  // not used as throughput samples.
+  static constexpr std::int64_t kMinThroughputSampleBytes = 64 * 1024;
+
+  static LinkQualityEstimator& GetInstance();
+
+  void RecordThroughput(Medium medium, std::int64_t bytes,
+                        absl::Duration duration) ABSL_LOCKS_EXCLUDED(mutex_);
+  void RecordRtt(Medium medium, absl::Duration rtt)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void RecordUpgradeSetupTime(Medium medium, absl::Duration duration)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // A KeepAlive probe was written to |endpoint_id|; its ack, read off a
+  // |medium| channel, yields a round trip time sample.
+  void OnProbeSent(const std::string& endpoint_id) ABSL_LOCKS_EXCLUDED(mutex_);
+  void OnProbeAcked(const std::string& endpoint_id, Medium medium)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void ForgetEndpoint(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  Estimate GetEstimate(Medium medium) const ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the estimates of the mediums that something was recorded for.
+  std::vector<Estimate> GetSnapshot() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns how many times more data is expected to be transferred within
+  // |horizon| by upgrading from |current| to |candidate| than by staying on
+  // |current|. |current| is still used while the upgrade is set up.
+  double GetExpectedUpgradeGain(Medium current, Medium candidate,
+                                absl::Duration horizon) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  void ResetForTesting() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // This is a singleton object, for which destructor will never be called.
+  LinkQualityEstimator() = default;
+  ~LinkQualityEstimator() = default;
+
+  static Estimate GetPrior(Medium medium);
+  Estimate GetEstimateLocked(Medium medium) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable Mutex mutex_;
+  // Only holds measured values; see GetEstimateLocked().
+  absl::flat_hash_map<Medium, Estimate> estimates_ ABSL_GUARDED_BY(mutex_);
+  // Endpoint ID -> when its unacked KeepAlive probe was written.
+  absl::flat_hash_map<std::string, absl::Time> probes_sent_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
+
+#endif  // NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_LINK_QUALITY_ESTIMATOR_H_
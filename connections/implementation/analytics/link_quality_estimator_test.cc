@@ -0,0 +1,109 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/link_quality_estimator.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using Estimate = LinkQualityEstimator::Estimate;
+
+constexpr char kEndpointId[] = "ABCD";
+constexpr absl::Duration kHorizon = absl::Seconds(30);
+
+class LinkQualityEstimatorTest : public ::testing::Test {
+ protected:
+  LinkQualityEstimatorTest() { estimator_.ResetForTesting(); }
+  ~LinkQualityEstimatorTest() override { estimator_.ResetForTesting(); }
+
+  LinkQualityEstimator& estimator_ = LinkQualityEstimator::GetInstance();
+};
+
+TEST_F(LinkQualityEstimatorTest, FallsBackToPriorWithoutSamples) {
+  Estimate estimate = estimator_.GetEstimate(Medium::WIFI_LAN);
+
+  EXPECT_EQ(estimate.throughput_samples, 0);
+  EXPECT_GT(estimate.throughput_kbps, 0);
+  EXPECT_TRUE(estimator_.GetSnapshot().empty());
+}
+
+TEST_F(LinkQualityEstimatorTest, AveragesThroughputSamples) {
+  // 1 MB/s, then 2 MB/s.
+  estimator_.RecordThroughput(Medium::WIFI_LAN, 1024 * 1024, absl::Seconds(1));
+  EXPECT_EQ(estimator_.GetEstimate(Medium::WIFI_LAN).throughput_kbps, 1024);
+  estimator_.RecordThroughput(Medium::WIFI_LAN, 2048 * 1024, absl::Seconds(1));
+
+  Estimate estimate = estimator_.GetEstimate(Medium::WIFI_LAN);
+  EXPECT_EQ(estimate.throughput_samples, 2);
+  EXPECT_EQ(estimate.throughput_kbps, 1024 + 256);
+  std::vector<Estimate> snapshot = estimator_.GetSnapshot();
+  ASSERT_EQ(snapshot.size(), 1u);
+  EXPECT_EQ(snapshot[0].medium, Medium::WIFI_LAN);
+}
+
+TEST_F(LinkQualityEstimatorTest, IgnoresSmallTransfers) {
+  estimator_.RecordThroughput(
+      Medium::WIFI_LAN, LinkQualityEstimator::kMinThroughputSampleBytes - 1,
+      absl::Seconds(10));
+
+  EXPECT_EQ(estimator_.GetEstimate(Medium::WIFI_LAN).throughput_samples, 0);
+}
+
+TEST_F(LinkQualityEstimatorTest, TimesAckedProbes) {
+  estimator_.OnProbeAcked(kEndpointId, Medium::BLUETOOTH);
+  EXPECT_EQ(estimator_.GetEstimate(Medium::BLUETOOTH).rtt_samples, 0);
+
+  estimator_.OnProbeSent(kEndpointId);
+  estimator_.OnProbeAcked(kEndpointId, Medium::BLUETOOTH);
+  // A second ack for the same probe is not a sample.
+  estimator_.OnProbeAcked(kEndpointId, Medium::BLUETOOTH);
+
+  EXPECT_EQ(estimator_.GetEstimate(Medium::BLUETOOTH).rtt_samples, 1);
+}
+
+TEST_F(LinkQualityEstimatorTest, ExpectsGainFromFasterMedium) {
+  estimator_.RecordThroughput(Medium::BLUETOOTH, 150 * 1024, absl::Seconds(1));
+  estimator_.RecordThroughput(Medium::WIFI_LAN, 5000 * 1024,
+                              absl::Seconds(1));
+
+  EXPECT_GT(estimator_.GetExpectedUpgradeGain(Medium::BLUETOOTH,
+                                              Medium::WIFI_LAN, kHorizon),
+            10);
+}
+
+TEST_F(LinkQualityEstimatorTest, ExpectsNoGainFromSlowSetup) {
+  estimator_.RecordThroughput(Medium::BLUETOOTH, 150 * 1024, absl::Seconds(1));
+  estimator_.RecordThroughput(Medium::WIFI_HOTSPOT, 300 * 1024,
+                              absl::Seconds(1));
+  estimator_.RecordUpgradeSetupTime(Medium::WIFI_HOTSPOT, absl::Seconds(20));
+
+  // Twice as fast, but only for the last third of the horizon.
+  EXPECT_LT(estimator_.GetExpectedUpgradeGain(Medium::BLUETOOTH,
+                                              Medium::WIFI_HOTSPOT, kHorizon),
+            1.5);
+}
+
+}  // namespace
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
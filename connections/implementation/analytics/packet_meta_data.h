@@ -73,27 +73,37 @@ struct PacketMetaData {
     socket_io_end_time = SystemClock::ElapsedRealtime();
   }
 
-  int64_t GetEncryptionTimeInMillis() {
+  absl::Duration GetEncryptionTime() const {
     if (encryption_end_time > encryption_start_time) {
-      return absl::ToInt64Milliseconds(encryption_end_time -
-                                       encryption_start_time);
+      return encryption_end_time - encryption_start_time;
     }
-    return 0L;
+    return absl::ZeroDuration();
   }
 
-  int64_t GetFileIoTimeInMillis() {
+  absl::Duration GetFileIoTime() const {
     if (file_io_end_time > file_io_start_time) {
-      return absl::ToInt64Milliseconds(file_io_end_time - file_io_start_time);
+      return file_io_end_time - file_io_start_time;
     }
-    return 0L;
+    return absl::ZeroDuration();
   }
 
-  int64_t GetSocketIoTimeInMillis() {
+  absl::Duration GetSocketIoTime() const {
     if (socket_io_end_time > socket_io_start_time) {
-      return absl::ToInt64Milliseconds(socket_io_end_time -
-                                       socket_io_start_time);
+      return socket_io_end_time - socket_io_start_time;
     }
-    return 0L;
+    return absl::ZeroDuration();
+  }
+
+  int64_t GetEncryptionTimeInMillis() {
+    return absl::ToInt64Milliseconds(GetEncryptionTime());
+  }
+
+  int64_t GetFileIoTimeInMillis() {
+    return absl::ToInt64Milliseconds(GetFileIoTime());
+  }
+
+  int64_t GetSocketIoTimeInMillis() {
+    return absl::ToInt64Milliseconds(GetSocketIoTime());
   }
 };
 
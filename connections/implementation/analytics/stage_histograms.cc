@@ -0,0 +1,197 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/stage_histograms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <type_traits>
+
+#include "absl/numeric/bits.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxExponent;
+constexpr int LatencyHistogram::kNumBuckets;
+constexpr int StageHistograms::kNumStages;
+
+int LatencyHistogram::GetBucket(std::int64_t nanos) {
+  if (nanos < kSubBuckets) return std::max<std::int64_t>(nanos, 0);
+  auto value = static_cast<std::uint64_t>(nanos);
+  int exponent = 63 - absl::countl_zero(value);
+  if (exponent > kMaxExponent) return kNumBuckets - 1;
+  int sub_bucket = (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+  return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+}
+
+std::int64_t LatencyHistogram::GetBucketLowerBound(int bucket) {
+  if (bucket < kSubBuckets) return bucket;
+  int exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+  int sub_bucket = bucket % kSubBuckets;
+  return static_cast<std::int64_t>(kSubBuckets + sub_bucket)
+         << (exponent - kSubBucketBits);
+}
+
+void LatencyHistogram::Record(absl::Duration duration) {
+  std::int64_t nanos = std::max<std::int64_t>(
+      absl::ToInt64Nanoseconds(duration), 0);
+  buckets_[GetBucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+  sum_nanos_.fetch_add(nanos, std::memory_order_relaxed);
+  std::int64_t max = max_nanos_.load(std::memory_order_relaxed);
+  while (nanos > max && !max_nanos_.compare_exchange_weak(
+                            max, nanos, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  // Not atomic as a whole; a snapshot taken while chunks are being recorded
+  // may be off by those chunks.
+  Snapshot snapshot;
+  snapshot.buckets.reserve(kNumBuckets);
+  for (const auto& bucket : buckets_) {
+    std::int64_t count = bucket.load(std::memory_order_relaxed);
+    snapshot.buckets.push_back(count);
+    snapshot.count += count;
+  }
+  snapshot.sum_nanos = sum_nanos_.load(std::memory_order_relaxed);
+  snapshot.max_nanos = max_nanos_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  sum_nanos_.store(0, std::memory_order_relaxed);
+  max_nanos_.store(0, std::memory_order_relaxed);
+}
+
+absl::Duration LatencyHistogram::Snapshot::GetMean() const {
+  if (count == 0) return absl::ZeroDuration();
+  return absl::Nanoseconds(sum_nanos / count);
+}
+
+absl::Duration LatencyHistogram::Snapshot::GetPercentile(
+    double percentile) const {
+  if (count == 0) return absl::ZeroDuration();
+  auto rank = static_cast<std::int64_t>(
+      std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * count));
+  rank = std::max<std::int64_t>(rank, 1);
+  std::int64_t seen = 0;
+  for (int bucket = 0; bucket < static_cast<int>(buckets.size()); ++bucket) {
+    seen += buckets[bucket];
+    if (seen >= rank) {
+      std::int64_t upper_bound = bucket + 1 < kNumBuckets
+                                     ? GetBucketLowerBound(bucket + 1) - 1
+                                     : max_nanos;
+      return absl::Nanoseconds(std::min(upper_bound, max_nanos));
+    }
+  }
+  return absl::Nanoseconds(max_nanos);
+}
+
+StageHistograms& StageHistograms::GetInstance() {
+  static std::aligned_storage_t<sizeof(StageHistograms),
+                                alignof(StageHistograms)>
+      storage;
+  static StageHistograms* instance = new (&storage) StageHistograms();
+  return *instance;
+}
+
+int StageHistograms::GetIndex(const Key& key) {
+  int medium = std::clamp(static_cast<int>(key.medium), 0, kNumMediums - 1);
+  int payload_type = static_cast<int>(key.payload_type);
+  return ((static_cast<int>(key.stage) * kNumMediums + medium) *
+              kNumPayloadTypes +
+          payload_type) *
+             2 +
+         (key.is_incoming ? 1 : 0);
+}
+
+StageHistograms::Key StageHistograms::GetKey(int index) {
+  Key key;
+  key.is_incoming = index % 2 == 1;
+  index /= 2;
+  key.payload_type = static_cast<connections::PayloadType>(index %
+                                                           kNumPayloadTypes);
+  index /= kNumPayloadTypes;
+  key.medium = static_cast<location::nearby::proto::connections::Medium>(
+      index % kNumMediums);
+  key.stage = static_cast<Stage>(index / kNumMediums);
+  return key;
+}
+
+void StageHistograms::Record(const Key& key, absl::Duration duration) {
+  std::atomic<LatencyHistogram*>& slot = histograms_[GetIndex(key)];
+  LatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+  if (histogram == nullptr) {
+    auto* created = new LatencyHistogram();
+    if (slot.compare_exchange_strong(histogram, created,
+                                     std::memory_order_acq_rel)) {
+      histogram = created;
+    } else {
+      // Another thread got there first; |histogram| now holds its histogram.
+      delete created;
+    }
+  }
+  histogram->Record(duration);
+}
+
+void StageHistograms::Record(
+    location::nearby::proto::connections::Medium medium,
+    connections::PayloadType payload_type, bool is_incoming,
+    const PacketMetaData& packet_meta_data) {
+  Record({Stage::kFileIo, medium, payload_type, is_incoming},
+         packet_meta_data.GetFileIoTime());
+  Record({Stage::kEncryption, medium, payload_type, is_incoming},
+         packet_meta_data.GetEncryptionTime());
+  Record({Stage::kSocketIo, medium, payload_type, is_incoming},
+         packet_meta_data.GetSocketIoTime());
+}
+
+std::vector<StageHistograms::Entry> StageHistograms::GetSnapshot() const {
+  std::vector<Entry> entries;
+  for (int index = 0; index < kNumKeys; ++index) {
+    LatencyHistogram* histogram =
+        histograms_[index].load(std::memory_order_acquire);
+    if (histogram == nullptr) continue;
+    LatencyHistogram::Snapshot snapshot = histogram->GetSnapshot();
+    if (snapshot.count == 0) continue;
+    entries.push_back({GetKey(index), std::move(snapshot)});
+  }
+  return entries;
+}
+
+LatencyHistogram::Snapshot StageHistograms::GetSnapshot(const Key& key) const {
+  LatencyHistogram* histogram =
+      histograms_[GetIndex(key)].load(std::memory_order_acquire);
+  if (histogram == nullptr) return {};
+  return histogram->GetSnapshot();
+}
+
+void StageHistograms::ResetForTesting() {
+  for (auto& slot : histograms_) {
+    LatencyHistogram* histogram = slot.load(std::memory_order_acquire);
+    if (histogram != nullptr) histogram->Reset();
+  }
+}
+
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
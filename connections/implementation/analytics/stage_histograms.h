@@ -0,0 +1,142 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_STAGE_HISTOGRAMS_H_
+#define NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_STAGE_HISTOGRAMS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "connections/payload_type.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+
+// A histogram of durations with nanosecond resolution.
+//
+// Buckets are log-linear: every power of two is split into 8 buckets, so a
+// recorded duration is off by at most 12.5%. Durations past ~18 minutes all
+// land in the last bucket. Recording is a handful of relaxed atomic adds; no
+// lock is taken.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxExponent = 40;
+  static constexpr int kNumBuckets =
+      (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+  struct Snapshot {
+    std::int64_t count = 0;
+    std::int64_t sum_nanos = 0;
+    std::int64_t max_nanos = 0;
+    // Indexed by bucket; see GetBucketLowerBound().
+    std::vector<std::int64_t> buckets;
+
+    absl::Duration GetMean() const;
+    // Returns the upper bound of the bucket holding the |percentile|th
+    // duration, |percentile| being in [0, 100].
+    absl::Duration GetPercentile(double percentile) const;
+  };
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void Record(absl::Duration duration);
+  Snapshot GetSnapshot() const;
+  void Reset();
+
+  static int GetBucket(std::int64_t nanos);
+  static std::int64_t GetBucketLowerBound(int bucket);
+
+ private:
+  std::atomic<std::int64_t> sum_nanos_{0};
+  std::atomic<std::int64_t> max_nanos_{0};
+  std::array<std::atomic<std::int64_t>, kNumBuckets> buckets_{};
+};
+
+// Per-stage latency histograms of payload chunks (and of connection setup),
+// kept per medium, payload type and direction, for the whole process.
+//
+// Histograms are allocated the first time something is recorded for their
+// key, and live as long as the process.
+class StageHistograms {
+ public:
+  enum class Stage {
+    kFileIo = 0,
+    // Decryption, for incoming chunks.
+    kEncryption = 1,
+    kSocketIo = 2,
+    // Establishing the channel of an outgoing connection, from the request
+    // on. Recorded for the medium that connected, with PayloadType::kUnknown.
+    kConnect = 3,
+  };
+  static constexpr int kNumStages = 4;
+
+  struct Key {
+    Stage stage;
+    location::nearby::proto::connections::Medium medium;
+    connections::PayloadType payload_type;
+    bool is_incoming;
+  };
+
+  struct Entry {
+    Key key;
+    LatencyHistogram::Snapshot histogram;
+  };
+
+  static StageHistograms& GetInstance();
+
+  void Record(const Key& key, absl::Duration duration);
+  // Records the time |packet_meta_data| spent in each stage.
+  void Record(location::nearby::proto::connections::Medium medium,
+              connections::PayloadType payload_type, bool is_incoming,
+              const PacketMetaData& packet_meta_data);
+
+  // Returns the histograms that something was recorded into.
+  std::vector<Entry> GetSnapshot() const;
+  // Returns the histogram for |key|; it is empty if nothing was recorded.
+  LatencyHistogram::Snapshot GetSnapshot(const Key& key) const;
+
+  void ResetForTesting();
+
+ private:
+  static constexpr int kNumMediums =
+      location::nearby::proto::connections::Medium_ARRAYSIZE;
+  static constexpr int kNumPayloadTypes = 4;
+  static constexpr int kNumKeys =
+      kNumStages * kNumMediums * kNumPayloadTypes * 2;
+
+  // This is a singleton object, for which destructor will never be called.
+  StageHistograms() = default;
+  ~StageHistograms() = default;
+
+  static int GetIndex(const Key& key);
+  static Key GetKey(int index);
+
+  std::array<std::atomic<LatencyHistogram*>, kNumKeys> histograms_{};
+};
+
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
+
+#endif  // NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_STAGE_HISTOGRAMS_H_
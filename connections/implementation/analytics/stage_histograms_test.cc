@@ -0,0 +1,177 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/stage_histograms.h"
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/throughput_recorder.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace analytics {
+namespace {
+
+using ::location::nearby::connections::PayloadType;
+using ::location::nearby::proto::connections::Medium;
+using Stage = StageHistograms::Stage;
+
+TEST(LatencyHistogramTest, BucketsAreContiguous) {
+  for (int bucket = 1; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+    std::int64_t lower_bound = LatencyHistogram::GetBucketLowerBound(bucket);
+    EXPECT_EQ(LatencyHistogram::GetBucket(lower_bound), bucket);
+    EXPECT_EQ(LatencyHistogram::GetBucket(lower_bound - 1), bucket - 1);
+  }
+}
+
+TEST(LatencyHistogramTest, KeepsSubMillisecondDurations) {
+  LatencyHistogram histogram;
+
+  histogram.Record(absl::Microseconds(20));
+  histogram.Record(absl::Microseconds(30));
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 2);
+  EXPECT_EQ(snapshot.sum_nanos, 50 * 1000);
+  EXPECT_EQ(snapshot.max_nanos, 30 * 1000);
+  EXPECT_EQ(snapshot.GetMean(), absl::Microseconds(25));
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketPrecision) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 100; ++i) {
+    histogram.Record(absl::Microseconds(i));
+  }
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  absl::Duration p50 = snapshot.GetPercentile(50);
+  absl::Duration p99 = snapshot.GetPercentile(99);
+  EXPECT_GE(p50, absl::Microseconds(50));
+  EXPECT_LE(p50, absl::Microseconds(50) * 1.125);
+  EXPECT_GE(p99, absl::Microseconds(99));
+  EXPECT_LE(p99, absl::Microseconds(100));
+  EXPECT_EQ(snapshot.GetPercentile(100), absl::Microseconds(100));
+}
+
+TEST(LatencyHistogramTest, ClampsHugeDurations) {
+  LatencyHistogram histogram;
+
+  histogram.Record(absl::Hours(10));
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.buckets.back(), 1);
+  EXPECT_EQ(snapshot.GetPercentile(50), absl::Hours(10));
+}
+
+TEST(LatencyHistogramTest, CountsRecordsFromManyThreads) {
+  LatencyHistogram histogram;
+  constexpr int kThreads = 8;
+  constexpr int kRecordsPerThread = 10000;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&histogram, i]() {
+      for (int j = 0; j < kRecordsPerThread; ++j) {
+        histogram.Record(absl::Nanoseconds(i * 1000 + j));
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(histogram.GetSnapshot().count, kThreads * kRecordsPerThread);
+  EXPECT_EQ(histogram.GetSnapshot().max_nanos,
+            (kThreads - 1) * 1000 + kRecordsPerThread - 1);
+}
+
+TEST(StageHistogramsTest, RecordsEachStageOfAPacket) {
+  StageHistograms& histograms = StageHistograms::GetInstance();
+  histograms.ResetForTesting();
+  PacketMetaData packet_meta_data;
+  absl::Time start = absl::UnixEpoch();
+  packet_meta_data.file_io_start_time = start;
+  packet_meta_data.file_io_end_time = start + absl::Microseconds(100);
+  packet_meta_data.encryption_start_time = start;
+  packet_meta_data.encryption_end_time = start + absl::Microseconds(200);
+  packet_meta_data.socket_io_start_time = start;
+  packet_meta_data.socket_io_end_time = start + absl::Microseconds(300);
+
+  histograms.Record(Medium::WIFI_LAN, PayloadType::kFile,
+                    /*is_incoming=*/false, packet_meta_data);
+
+  EXPECT_EQ(histograms
+                .GetSnapshot({Stage::kFileIo, Medium::WIFI_LAN,
+                              PayloadType::kFile, false})
+                .sum_nanos,
+            100 * 1000);
+  EXPECT_EQ(histograms
+                .GetSnapshot({Stage::kEncryption, Medium::WIFI_LAN,
+                              PayloadType::kFile, false})
+                .sum_nanos,
+            200 * 1000);
+  EXPECT_EQ(histograms
+                .GetSnapshot({Stage::kSocketIo, Medium::WIFI_LAN,
+                              PayloadType::kFile, false})
+                .sum_nanos,
+            300 * 1000);
+  EXPECT_EQ(histograms
+                .GetSnapshot({Stage::kSocketIo, Medium::WIFI_LAN,
+                              PayloadType::kFile, true})
+                .count,
+            0);
+}
+
+TEST(StageHistogramsTest, SnapshotListsRecordedKeys) {
+  StageHistograms& histograms = StageHistograms::GetInstance();
+  histograms.ResetForTesting();
+
+  histograms.Record({Stage::kSocketIo, Medium::BLUETOOTH, PayloadType::kBytes,
+                     /*is_incoming=*/true},
+                    absl::Microseconds(5));
+
+  std::vector<StageHistograms::Entry> entries = histograms.GetSnapshot();
+  ASSERT_EQ(entries.size(), 1);
+  EXPECT_EQ(entries[0].key.stage, Stage::kSocketIo);
+  EXPECT_EQ(entries[0].key.medium, Medium::BLUETOOTH);
+  EXPECT_EQ(entries[0].key.payload_type, PayloadType::kBytes);
+  EXPECT_TRUE(entries[0].key.is_incoming);
+  EXPECT_EQ(entries[0].histogram.count, 1);
+}
+
+TEST(StageHistogramsTest, ThroughputRecorderFeedsHistograms) {
+  StageHistograms& histograms = StageHistograms::GetInstance();
+  histograms.ResetForTesting();
+  ThroughputRecorder recorder(/*payload_id=*/1);
+  recorder.Start(PayloadType::kStream, /*is_incoming=*/true);
+  PacketMetaData packet_meta_data;
+  packet_meta_data.packet_size = 1024;
+  absl::Time start = absl::UnixEpoch();
+  packet_meta_data.socket_io_start_time = start;
+  packet_meta_data.socket_io_end_time = start + absl::Microseconds(250);
+
+  recorder.OnFrameReceived(Medium::WIFI_LAN, packet_meta_data);
+
+  LatencyHistogram::Snapshot snapshot = histograms.GetSnapshot(
+      {Stage::kSocketIo, Medium::WIFI_LAN, PayloadType::kStream, true});
+  EXPECT_EQ(snapshot.count, 1);
+  EXPECT_EQ(snapshot.max_nanos, 250 * 1000);
+}
+
+}  // namespace
+}  // namespace analytics
+}  // namespace nearby
+}  // namespace location
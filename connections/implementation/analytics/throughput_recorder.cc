@@ -14,9 +14,12 @@
 
 #include "connections/implementation/analytics/throughput_recorder.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
+#include "connections/implementation/analytics/link_quality_estimator.h"
+#include "connections/implementation/analytics/stage_histograms.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 namespace location {
@@ -29,6 +32,8 @@ constexpr int kKbInBytes = 1024;
 constexpr int kSecInMs = 1000;
 }  // namespace
 
+constexpr int ThroughputRecorder::kNumMediums;
+
 ThroughputRecorder::ThroughputRecorder(int64_t payload_id)
     : payload_id_(payload_id) {}
 
@@ -53,14 +58,17 @@ void ThroughputRecorder::Start(PayloadType payload_type,
   }
 
   start_timestamp_ = SystemClock::ElapsedRealtime();
-  payload_type_ = payload_type;
   is_incoming_ = is_incoming;
+  // Published last: frames are only recorded once it is set.
+  payload_type_.store(payload_type, std::memory_order_release);
   // Add packetLostAlarm later
 }
 
 bool ThroughputRecorder::Stop() {
   NEARBY_LOGS(INFO) << "Stop TP profiling for payload_id:" << payload_id_;
-  if (payload_type_ == PayloadType::kUnknown) {
+  const PayloadType payload_type =
+      payload_type_.load(std::memory_order_acquire);
+  if (payload_type == PayloadType::kUnknown) {
     NEARBY_LOGS(INFO) << "Ignore ThroughputRecorder::stop as it never start";
     return false;
   }
@@ -69,55 +77,78 @@ bool ThroughputRecorder::Stop() {
     // Add packetLostAlarm stop process later
     absl::Time stop_timestamp = SystemClock::ElapsedRealtime();
     int64_t total_byte_size = 0;
-    int medium_size = throughputs_.size();
+    int medium_size = GetThroughputsSize();
 
     // The worse case is the socket/connect blocking the write request, never
     // got return when writing a frame out, it would get a very good data rate
     // for this case. e.g. use 60 seconds to send a file and failed, the counter
     // only get the duration as 30 seconds because the last write request
     // blocked.
-    if (!success_) {
-      if (!throughputs_.empty()) {
-        for (auto& tp : throughputs_) {
-          tp.second.SetLastTimestamp(stop_timestamp);
-        }
+    const bool success = success_;
+    if (!success) {
+      for (auto& tp : throughputs_) {
+        if (tp.IsStarted()) tp.SetLastTimestamp(stop_timestamp);
       }
     }
 
     // calculate throughput by medium
     for (auto& tp : throughputs_) {
-      tp.second.dump();
-      total_byte_size += tp.second.GetTotalByteSize();
+      if (!tp.IsStarted()) continue;
+      tp.dump();
+      total_byte_size += tp.GetTotalByteSize();
+      tp.Reset();
     }
 
-    throughputs_.clear();
-
     int64_t total_millis =
         absl::ToInt64Milliseconds(stop_timestamp - start_timestamp_);
-    throughput_kbps_ = CalculateThroughputKBps(total_byte_size, total_millis);
-    int throughput_mbps = CalculateThroughputMBps(throughput_kbps_);
+    const int throughput_kbps =
+        CalculateThroughputKBps(total_byte_size, total_millis);
+    throughput_kbps_ = throughput_kbps;
+    int throughput_mbps = CalculateThroughputMBps(throughput_kbps);
 
     // calculate overall throughput if there are multiple mediums
     if (medium_size > 1) {
-      if (throughput_kbps_ != kDefaultThroughoutKbps) {
+      if (throughput_kbps != kDefaultThroughoutKbps) {
         std::string dump_content = absl::StrFormat(
             "%s %s data(%d bytes) %s, overall used %d milliseconds, "
             "throughput "
             "is %d MB/s (%d KB/s), File IO takes %d ms, %s takes %d "
             "ms, "
             "Socket IO takes %d ms",
-            is_incoming_ ? "Received" : "Sent", ToString(payload_type_),
-            total_byte_size, success_ ? "SUCCEEDED" : "FAILED", total_millis,
-            throughput_mbps, throughput_kbps_, file_io_time_,
-            is_incoming_ ? "Decryption" : "Encryption", encryption_time_,
-            socket_io_time_);
+            is_incoming_ ? "Received" : "Sent", ToString(payload_type),
+            total_byte_size, success ? "SUCCEEDED" : "FAILED", total_millis,
+            throughput_mbps, throughput_kbps, file_io_time_.load(),
+            is_incoming_ ? "Decryption" : "Encryption",
+            encryption_time_.load(), socket_io_time_.load());
         NEARBY_LOGS(INFO) << dump_content;
       }
     }
+
+    if (is_scheduled_) {
+      NEARBY_LOGS(INFO) << absl::StrFormat(
+          "Scheduled %d chunks of payload_id:%d at priority %d, weight %d; "
+          "waited at most %d ms for a turn",
+          scheduling_.chunks_sent, payload_id_, scheduling_.priority,
+          scheduling_.weight,
+          absl::ToInt64Milliseconds(scheduling_.longest_wait));
+    }
   }
   return true;
 }
 
+void ThroughputRecorder::RecordScheduling(const Scheduling& scheduling) {
+  MutexLock lock(&mutex_);
+  is_scheduled_ = true;
+  scheduling_ = scheduling;
+}
+
+bool ThroughputRecorder::GetScheduling(Scheduling* scheduling) {
+  MutexLock lock(&mutex_);
+  if (!is_scheduled_) return false;
+  *scheduling = scheduling_;
+  return true;
+}
+
 int ThroughputRecorder::CalculateThroughputKBps(int64_t total_byte_size,
                                                 int64_t total_millis) {
   if (total_millis > 0) {
@@ -130,110 +161,145 @@ int ThroughputRecorder::CalculateThroughputMBps(int throughputKBps) {
   return throughputKBps / kKbInBytes;
 }
 
+void ThroughputRecorder::Throughput::Start(Medium medium,
+                                           absl::Time start_timestamp,
+                                           PayloadType payload_type,
+                                           bool is_incoming) {
+  if (IsStarted()) return;
+  // Whoever starts the books concurrently stores the same values.
+  medium_.store(medium, std::memory_order_relaxed);
+  payload_type_.store(payload_type, std::memory_order_relaxed);
+  is_incoming_.store(is_incoming, std::memory_order_relaxed);
+  int64_t unset = 0;
+  start_timestamp_micros_.compare_exchange_strong(
+      unset, std::max<int64_t>(absl::ToUnixMicros(start_timestamp), 1),
+      std::memory_order_release);
+}
+
+bool ThroughputRecorder::Throughput::IsStarted() const {
+  return start_timestamp_micros_.load(std::memory_order_acquire) != 0;
+}
+
+void ThroughputRecorder::Throughput::Reset() {
+  start_timestamp_micros_.store(0, std::memory_order_relaxed);
+  total_byte_size_.store(0, std::memory_order_relaxed);
+  last_timestamp_micros_.store(0, std::memory_order_relaxed);
+  file_io_time_.store(0, std::memory_order_relaxed);
+  encryption_time_.store(0, std::memory_order_relaxed);
+  socket_io_time_.store(0, std::memory_order_relaxed);
+}
+
 void ThroughputRecorder::Throughput::Add(int frame_size,
                                          int64_t file_io_time,
                                          int64_t encryption_time,
                                          int64_t socket_io_time) {
-  total_byte_size_ += frame_size;
+  total_byte_size_.fetch_add(frame_size, std::memory_order_relaxed);
   // reset the last timestamp
-  last_timestamp_ = SystemClock::ElapsedRealtime();
-  file_io_time_ += file_io_time;
-  encryption_time_ += encryption_time;
-  socket_io_time_ += socket_io_time;
+  SetLastTimestamp(SystemClock::ElapsedRealtime());
+  file_io_time_.fetch_add(file_io_time, std::memory_order_relaxed);
+  encryption_time_.fetch_add(encryption_time, std::memory_order_relaxed);
+  socket_io_time_.fetch_add(socket_io_time, std::memory_order_relaxed);
 }
 
 bool ThroughputRecorder::Throughput::dump() {
+  const Medium medium = medium_.load(std::memory_order_relaxed);
+  const bool is_incoming = is_incoming_.load(std::memory_order_relaxed);
+  const int64_t total_byte_size = GetTotalByteSize();
+  const int64_t file_io_time = file_io_time_.load(std::memory_order_relaxed);
+  const int64_t encryption_time =
+      encryption_time_.load(std::memory_order_relaxed);
+  const int64_t socket_io_time =
+      socket_io_time_.load(std::memory_order_relaxed);
   int64_t total_millis =
-      absl::ToInt64Milliseconds(last_timestamp_ - start_timestamp_);
-  int throughput_kbps = CalculateThroughputKBps(total_byte_size_, total_millis);
+      (last_timestamp_micros_.load(std::memory_order_relaxed) -
+       start_timestamp_micros_.load(std::memory_order_acquire)) /
+      1000;
+  LinkQualityEstimator::GetInstance().RecordThroughput(
+      medium, total_byte_size, absl::Milliseconds(total_millis));
+  int throughput_kbps = CalculateThroughputKBps(total_byte_size, total_millis);
   if (throughput_kbps == kDefaultThroughoutKbps) {
     return false;
   }
   int throughpu_mbps = CalculateThroughputMBps(throughput_kbps);
-  int64_t other =
-      total_millis - file_io_time_ - encryption_time_ - socket_io_time_;
+  int64_t other = total_millis - file_io_time - encryption_time - socket_io_time;
   std::string dump_content = absl::StrFormat(
       "%s %s data(%ld bytes) via %s used %ld milliseconds, throughput is %d "
       "MB/s (%d KB/s), File IO takes %ld ms, %s takes %ld ms, "
       "Socket IO takes %ld ms, "
       "Other takes %ld ms",
-      is_incoming_ ? "Received" : "Sent", ToString(payload_type_),
-      total_byte_size_, proto::connections::Medium_Name(medium_), total_millis,
-      throughpu_mbps, throughput_kbps, file_io_time_,
-      is_incoming_ ? "Decryption" : "Encryption", encryption_time_,
-      socket_io_time_, other);
+      is_incoming ? "Received" : "Sent",
+      ToString(payload_type_.load(std::memory_order_relaxed)), total_byte_size,
+      proto::connections::Medium_Name(medium), total_millis, throughpu_mbps,
+      throughput_kbps, file_io_time, is_incoming ? "Decryption" : "Encryption",
+      encryption_time, socket_io_time, other);
   NEARBY_LOGS(INFO) << dump_content;
   return true;
 }
 
 ThroughputRecorder::Throughput& ThroughputRecorder::GetThroughput(
     Medium medium, int64_t duration_millis) {
-  MutexLock lock(&mutex_);
-  auto it = throughputs_.find(medium);
-  if (it == throughputs_.end()) {
-    auto throughput = new Throughput(
+  if (medium < 0 || medium >= kNumMediums) {
+    medium = Medium::UNKNOWN_MEDIUM;
+  }
+  Throughput& throughput = throughputs_[medium];
+  if (!throughput.IsStarted()) {
+    throughput.Start(
         medium,
         SystemClock::ElapsedRealtime() - absl::Milliseconds(duration_millis),
-        payload_type_, is_incoming_);
-    throughputs_.emplace(medium, std::move(*throughput));
-    delete throughput;
-    return throughputs_.find(medium)->second;
+        payload_type_.load(std::memory_order_acquire), is_incoming_);
   }
-  return it->second;
+  return throughput;
 }
 
 int ThroughputRecorder::GetThroughputsSize() {
-  MutexLock lock(&mutex_);
-  return throughputs_.size();
+  int size = 0;
+  for (const auto& throughput : throughputs_) {
+    if (throughput.IsStarted()) ++size;
+  }
+  return size;
 }
 
 int ThroughputRecorder::GetThroughputKbps() { return throughput_kbps_; }
 
 int64_t ThroughputRecorder::GetDurationMillis() {
-  return duration_millis_;
+  return duration_millis_.load(std::memory_order_relaxed);
 }
 
 void ThroughputRecorder::OnFrameSent(Medium medium,
                                      PacketMetaData& packetMetaData) {
-  if (payload_type_ == PayloadType::kUnknown) {
-    NEARBY_LOGS(INFO) << "PayloadType is invalid, return";
-    return;
-  }
-
-  duration_millis_ = packetMetaData.GetEncryptionTimeInMillis() +
-                     packetMetaData.GetFileIoTimeInMillis() +
-                     packetMetaData.GetSocketIoTimeInMillis();
-
-  GetThroughput(medium, duration_millis_)
-      .Add(packetMetaData.packet_size, packetMetaData.GetFileIoTimeInMillis(),
-           packetMetaData.GetEncryptionTimeInMillis(),
-           packetMetaData.GetSocketIoTimeInMillis());
-  CalculateDurationTimes(packetMetaData);
+  OnFrame(medium, packetMetaData);
 }
 
 void ThroughputRecorder::OnFrameReceived(Medium medium,
                                          PacketMetaData& packetMetaData) {
-  if (payload_type_ == PayloadType::kUnknown) {
+  // Add packetLostAlarm process later
+  OnFrame(medium, packetMetaData);
+}
+
+void ThroughputRecorder::OnFrame(Medium medium,
+                                 PacketMetaData& packetMetaData) {
+  const PayloadType payload_type =
+      payload_type_.load(std::memory_order_acquire);
+  if (payload_type == PayloadType::kUnknown) {
     NEARBY_LOGS(INFO) << "PayloadType is invalid, return";
     return;
   }
 
-  // Add packetLostAlarm process later
-  duration_millis_ = packetMetaData.GetEncryptionTimeInMillis() +
-                     packetMetaData.GetFileIoTimeInMillis() +
-                     packetMetaData.GetSocketIoTimeInMillis();
-
-  GetThroughput(medium, duration_millis_)
-      .Add(packetMetaData.packet_size, packetMetaData.GetFileIoTimeInMillis(),
-           packetMetaData.GetEncryptionTimeInMillis(),
-           packetMetaData.GetSocketIoTimeInMillis());
-  CalculateDurationTimes(packetMetaData);
-}
-
-void ThroughputRecorder::CalculateDurationTimes(PacketMetaData packetMetaData) {
-  encryption_time_ += packetMetaData.GetEncryptionTimeInMillis();
-  socket_io_time_ += packetMetaData.GetSocketIoTimeInMillis();
-  file_io_time_ += packetMetaData.GetFileIoTimeInMillis();
+  StageHistograms::GetInstance().Record(medium, payload_type, is_incoming_,
+                                        packetMetaData);
+  const int64_t file_io_time = packetMetaData.GetFileIoTimeInMillis();
+  const int64_t encryption_time = packetMetaData.GetEncryptionTimeInMillis();
+  const int64_t socket_io_time = packetMetaData.GetSocketIoTimeInMillis();
+  const int64_t duration_millis =
+      encryption_time + file_io_time + socket_io_time;
+  duration_millis_.store(duration_millis, std::memory_order_relaxed);
+
+  GetThroughput(medium, duration_millis)
+      .Add(packetMetaData.packet_size, file_io_time, encryption_time,
+           socket_io_time);
+  encryption_time_.fetch_add(encryption_time, std::memory_order_relaxed);
+  socket_io_time_.fetch_add(socket_io_time, std::memory_order_relaxed);
+  file_io_time_.fetch_add(file_io_time, std::memory_order_relaxed);
 }
 
 std::string ThroughputRecorder::ToString(PayloadType type) {
@@ -258,6 +324,9 @@ void ThroughputRecorderContainer::Shutdown() {
   for (auto& throughput_recorder : throughput_recorders_) {
     NEARBY_LOGS(INFO) << "Stop instance: " << throughput_recorder.second;
     throughput_recorder.second->Stop();
+  }
+  generation_.fetch_add(1, std::memory_order_release);
+  for (auto& throughput_recorder : throughput_recorders_) {
     delete throughput_recorder.second;
   }
   throughput_recorders_.clear();
@@ -265,17 +334,32 @@ void ThroughputRecorderContainer::Shutdown() {
 
 ThroughputRecorder* ThroughputRecorderContainer::GetTPRecorder(
     const int64_t payload_id) {
+  struct CachedRecorder {
+    const ThroughputRecorderContainer* container = nullptr;
+    int64_t payload_id = 0;
+    std::uint64_t generation = 0;
+    ThroughputRecorder* recorder = nullptr;
+  };
+  static thread_local CachedRecorder cached;
+  if (cached.container == this && cached.payload_id == payload_id &&
+      cached.generation == generation_.load(std::memory_order_acquire)) {
+    return cached.recorder;
+  }
+
   MutexLock lock(&mutex_);
+  ThroughputRecorder* recorder;
   auto it = throughput_recorders_.find(payload_id);
   if (it == throughput_recorders_.end()) {
-    auto instance = new ThroughputRecorder(payload_id);
-    NEARBY_LOGS(INFO) << "Add ThroughputRecorder instance : " << instance
+    recorder = new ThroughputRecorder(payload_id);
+    NEARBY_LOGS(INFO) << "Add ThroughputRecorder instance : " << recorder
                       << " for payload_id:" << payload_id;
-    throughput_recorders_.emplace(payload_id, instance);
-    return instance;
+    throughput_recorders_.emplace(payload_id, recorder);
+  } else {
+    recorder = it->second;
   }
-
-  return it->second;
+  cached = {this, payload_id, generation_.load(std::memory_order_relaxed),
+            recorder};
+  return recorder;
 }
 
 void ThroughputRecorderContainer::StopTPRecorder(
@@ -286,6 +370,7 @@ void ThroughputRecorderContainer::StopTPRecorder(
     NEARBY_LOGS(INFO) << "Found and stop/delete ThroughputRecorder instance : "
                       << &(it->second) << " for payload_id:" << payload_id;
     it->second->Stop();
+    generation_.fetch_add(1, std::memory_order_release);
     delete it->second;
     throughput_recorders_.erase(payload_id);
     return;
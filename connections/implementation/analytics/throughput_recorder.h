@@ -15,10 +15,13 @@
 #ifndef NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_THROUGHPUT_RECORDER_H_
 #define NEARBY_CONNECTIONS_IMPLEMENTATION_ANALYTICS_THROUGHPUT_RECORDER_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
 #include "connections/payload_type.h"
 #include "internal/platform/mutex.h"
@@ -31,6 +34,12 @@ namespace analytics {
 using Medium = location::nearby::proto::connections::Medium;
 using PayloadType = connections::PayloadType;
 
+// Records how fast the frames of one payload are sent or received, by
+// medium.
+//
+// Frames are recorded on the hot path, possibly from several threads at
+// once, so recording takes no locks: the books of each medium are a fixed
+// slot of atomic counters.
 class ThroughputRecorder {
  public:
   explicit ThroughputRecorder(int64_t payload_id);
@@ -46,62 +55,94 @@ class ThroughputRecorder {
    public:
     Throughput() = default;
     ~Throughput() = default;
-    Throughput(Medium medium, absl::Time start_timestamp,
-               PayloadType payload_type, bool is_incoming)
-        : medium_(medium),
-          start_timestamp_(start_timestamp),
-          payload_type_(payload_type),
-          is_incoming_(is_incoming) {}
+    Throughput(const Throughput&) = delete;
+    Throughput& operator=(const Throughput&) = delete;
+
+    // Starts the books at |start_timestamp|, unless they are started
+    // already.
+    void Start(Medium medium, absl::Time start_timestamp,
+               PayloadType payload_type, bool is_incoming);
+    bool IsStarted() const;
+    // Clears the books, so that they can be started again.
+    void Reset();
 
     void Add(int frame_size, int64_t file_io_time,
              int64_t encryption_time, int64_t socket_io_time);
 
     void SetLastTimestamp(absl::Time time_stamp) {
-      last_timestamp_ = time_stamp;
+      last_timestamp_micros_.store(absl::ToUnixMicros(time_stamp),
+                                   std::memory_order_relaxed);
     }
 
-    int64_t GetTotalByteSize() { return total_byte_size_; }
+    int64_t GetTotalByteSize() const {
+      return total_byte_size_.load(std::memory_order_relaxed);
+    }
 
     bool dump();
 
    private:
-    Medium medium_;
-    absl::Time start_timestamp_;
-    PayloadType payload_type_;
-    int64_t total_byte_size_ = 0;
-    absl::Time last_timestamp_;
-    bool is_incoming_ = false;
-    int64_t file_io_time_ = 0;
-    int64_t encryption_time_ = 0;
-    int64_t socket_io_time_ = 0;
+    std::atomic<Medium> medium_{Medium::UNKNOWN_MEDIUM};
+    // Microseconds since the Unix epoch; 0 until started.
+    std::atomic<int64_t> start_timestamp_micros_{0};
+    std::atomic<PayloadType> payload_type_{PayloadType::kUnknown};
+    std::atomic<int64_t> total_byte_size_{0};
+    std::atomic<int64_t> last_timestamp_micros_{0};
+    std::atomic<bool> is_incoming_{false};
+    std::atomic<int64_t> file_io_time_{0};
+    std::atomic<int64_t> encryption_time_{0};
+    std::atomic<int64_t> socket_io_time_{0};
   };
 
-  Throughput& GetThroughput(Medium medium, int64_t duration_millis)
-      ABSL_LOCKS_EXCLUDED(mutex_);
-  int GetThroughputsSize() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the books of |medium|, starting them |duration_millis| ago if
+  // this is the first frame over it.
+  Throughput& GetThroughput(Medium medium, int64_t duration_millis);
+  int GetThroughputsSize();
   int GetThroughputKbps();
   int64_t GetDurationMillis();
   void OnFrameSent(Medium medium, PacketMetaData& packetMetaData);
   void OnFrameReceived(Medium medium, PacketMetaData& packetMetaData);
   void MarkAsSuccess() { success_ = true; }
 
+  // How the chunks of an outgoing payload were scheduled among those of the
+  // other payloads being sent (see connections::PayloadScheduler).
+  struct Scheduling {
+    int32_t priority = 0;
+    int32_t weight = 0;
+    int64_t chunks_sent = 0;
+    // The longest the payload waited for its turn.
+    absl::Duration longest_wait = absl::ZeroDuration();
+  };
+  // Records |scheduling|, for Stop() to report.
+  void RecordScheduling(const Scheduling& scheduling)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns false if no scheduling was recorded.
+  bool GetScheduling(Scheduling* scheduling) ABSL_LOCKS_EXCLUDED(mutex_);
+
  private:
-  void CalculateDurationTimes(PacketMetaData packetMetaData);
+  static constexpr int kNumMediums =
+      ::location::nearby::proto::connections::Medium_ARRAYSIZE;
+
+  void OnFrame(Medium medium, PacketMetaData& packetMetaData);
   static std::string ToString(PayloadType type);
 
+  // Serializes Stop(); recording does not take it.
   Mutex mutex_;
   int64_t payload_id_;
+  // Written by Start() before |payload_type_| is published.
   absl::Time start_timestamp_;
-  PayloadType payload_type_ = PayloadType::kUnknown;
   bool is_incoming_ = false;
-  absl::flat_hash_map<Medium, Throughput> throughputs_ ABSL_GUARDED_BY(mutex_);
-  bool success_ = false;
-
-  int64_t file_io_time_ = 0;
-  int64_t encryption_time_ = 0;
-  int64_t socket_io_time_ = 0;
-  int64_t duration_millis_ = 0;
-  int throughput_kbps_;
+  std::atomic<PayloadType> payload_type_{PayloadType::kUnknown};
+  // Indexed by medium.
+  std::array<Throughput, kNumMediums> throughputs_;
+  std::atomic<bool> success_{false};
+  bool is_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+  Scheduling scheduling_ ABSL_GUARDED_BY(mutex_);
+
+  std::atomic<int64_t> file_io_time_{0};
+  std::atomic<int64_t> encryption_time_{0};
+  std::atomic<int64_t> socket_io_time_{0};
+  std::atomic<int64_t> duration_millis_{0};
+  std::atomic<int> throughput_kbps_{0};
 };
 
 class ThroughputRecorderContainer {
@@ -113,6 +154,8 @@ class ThroughputRecorderContainer {
   static ThroughputRecorderContainer& GetInstance();
   void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Called for every frame, so the recorder looked up last is remembered per
+  // thread, and found again without taking |mutex_|.
   ThroughputRecorder* GetTPRecorder(const int64_t payload_id)
       ABSL_LOCKS_EXCLUDED(mutex_);
   void StopTPRecorder(const int64_t payload_id)
@@ -130,6 +173,9 @@ class ThroughputRecorderContainer {
   Mutex mutex_;
   absl::flat_hash_map<int64_t, ThroughputRecorder*> throughput_recorders_
       ABSL_GUARDED_BY(mutex_);
+  // Bumped, under |mutex_|, before a recorder is deleted; recorders
+  // remembered at an older generation are looked up again.
+  std::atomic<std::uint64_t> generation_{0};
 };
 
 }  // namespace analytics
@@ -14,6 +14,9 @@
 
 #include "connections/implementation/analytics/throughput_recorder.h"
 
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
@@ -84,10 +87,58 @@ TEST_F(ThroughputRecorderTest, OnFrameSentSaveTransferredSize) {
   TPRecorder->OnFrameSent(proto::connections::BLE, packet_meta_data);
   TPRecorder->OnFrameSent(proto::connections::BLE, packet_meta_data);
 
-  auto throughput = TPRecorder->GetThroughput(proto::connections::BLE, 0);
+  auto& throughput = TPRecorder->GetThroughput(proto::connections::BLE, 0);
   EXPECT_EQ(throughput.GetTotalByteSize(), kFrameSize * 3);
 }
 
+TEST_F(ThroughputRecorderTest, OnFrameSentFromManyThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kFramesPerThread = 1000;
+  tp_recorder_container_.GetTPRecorder(kPayloadIdA)
+      ->Start(PayloadType::kFile, /*isIncoming=*/false);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([this, i]() {
+      PacketMetaData packet_meta_data;
+      packet_meta_data.SetPacketSize(kFrameSize);
+      auto medium =
+          i % 2 ? proto::connections::BLE : proto::connections::WIFI_LAN;
+      for (int frame = 0; frame < kFramesPerThread; ++frame) {
+        tp_recorder_container_.GetTPRecorder(kPayloadIdA)
+            ->OnFrameSent(medium, packet_meta_data);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
+  EXPECT_EQ(TPRecorder->GetThroughputsSize(), 2);
+  EXPECT_EQ(
+      TPRecorder->GetThroughput(proto::connections::BLE, 0).GetTotalByteSize(),
+      static_cast<int64_t>(kFrameSize) * kFramesPerThread * kThreads / 2);
+  EXPECT_EQ(TPRecorder->GetThroughput(proto::connections::WIFI_LAN, 0)
+                .GetTotalByteSize(),
+            static_cast<int64_t>(kFrameSize) * kFramesPerThread * kThreads / 2);
+}
+
+TEST_F(ThroughputRecorderTest, StoppedRecorderIsNotReturnedAgain) {
+  auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
+  TPRecorder->Start(PayloadType::kFile, /*isIncoming=*/false);
+  PacketMetaData packet_meta_data;
+  packet_meta_data.SetPacketSize(kFrameSize);
+  TPRecorder->OnFrameSent(proto::connections::BLE, packet_meta_data);
+
+  tp_recorder_container_.StopTPRecorder(kPayloadIdA);
+  EXPECT_EQ(tp_recorder_container_.GetSize(), 0);
+
+  // A fresh recorder, rather than the one remembered by this thread.
+  EXPECT_EQ(
+      tp_recorder_container_.GetTPRecorder(kPayloadIdA)->GetThroughputsSize(),
+      0);
+  EXPECT_EQ(tp_recorder_container_.GetSize(), 1);
+}
+
 TEST_F(ThroughputRecorderTest, OnIgnoreUnkownPaylaodType) {
   auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
   TPRecorder->Start(PayloadType::kUnknown, /*isIncoming=*/false);
@@ -101,6 +152,25 @@ TEST_F(ThroughputRecorderTest, OnIgnoreUnkownPaylaodType) {
   EXPECT_EQ(TPRecorder->GetThroughputsSize(), 0);
 }
 
+TEST_F(ThroughputRecorderTest, RecordsScheduling) {
+  auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
+  TPRecorder->Start(PayloadType::kFile, /*isIncoming=*/false);
+  ThroughputRecorder::Scheduling scheduling;
+  EXPECT_FALSE(TPRecorder->GetScheduling(&scheduling));
+
+  TPRecorder->RecordScheduling({.priority = 2,
+                                .weight = 3,
+                                .chunks_sent = 10,
+                                .longest_wait = absl::Milliseconds(40)});
+
+  ASSERT_TRUE(TPRecorder->GetScheduling(&scheduling));
+  EXPECT_EQ(scheduling.priority, 2);
+  EXPECT_EQ(scheduling.weight, 3);
+  EXPECT_EQ(scheduling.chunks_sent, 10);
+  EXPECT_EQ(scheduling.longest_wait, absl::Milliseconds(40));
+  EXPECT_TRUE(TPRecorder->Stop());
+}
+
 TEST_P(ThroughputRecorderTest, OnFrameSentStopAndDump) {
   auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
   TPRecorder->Start(PayloadType::kFile, /*isIncoming=*/false);
@@ -202,7 +272,7 @@ TEST_F(ThroughputRecorderTest, OnFrameReceivedCheckDurationMillis) {
 
 TEST_F(ThroughputRecorderTest, OnTPRecorderNotStarted) {
   auto TPRecorder = tp_recorder_container_.GetTPRecorder(kPayloadIdA);
-  auto throughput = TPRecorder->GetThroughput(proto::connections::BLE, 0);
+  auto& throughput = TPRecorder->GetThroughput(proto::connections::BLE, 0);
   EXPECT_FALSE(throughput.dump());
 }
 
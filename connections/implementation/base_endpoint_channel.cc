@@ -18,11 +18,13 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "connections/implementation/offline_frames.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
@@ -55,41 +57,6 @@ ByteArray IntToBytes(std::int32_t value) {
   return ByteArray(int_bytes, sizeof(int_bytes));
 }
 
-ExceptionOr<ByteArray> ReadExactly(InputStream* reader, std::int64_t size) {
-  ByteArray buffer(size);
-  std::int64_t current_pos = 0;
-
-  while (current_pos < size) {
-    ExceptionOr<ByteArray> read_bytes = reader->Read(size - current_pos);
-    if (!read_bytes.ok()) {
-      return read_bytes;
-    }
-    ByteArray result = read_bytes.result();
-
-    if (result.Empty()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Empty result when reading bytes.";
-      return ExceptionOr<ByteArray>(Exception::kIo);
-    }
-
-    buffer.CopyAt(current_pos, result);
-    current_pos += result.size();
-  }
-
-  return ExceptionOr<ByteArray>(std::move(buffer));
-}
-
-ExceptionOr<std::int32_t> ReadInt(InputStream* reader) {
-  ExceptionOr<ByteArray> read_bytes = ReadExactly(reader, sizeof(std::int32_t));
-  if (!read_bytes.ok()) {
-    return ExceptionOr<std::int32_t>(read_bytes.exception());
-  }
-  return ExceptionOr<std::int32_t>(BytesToInt(std::move(read_bytes.result())));
-}
-
-Exception WriteInt(OutputStream* writer, std::int32_t value) {
-  return writer->Write(IntToBytes(value));
-}
-
 }  // namespace
 
 BaseEndpointChannel::BaseEndpointChannel(const std::string& service_id,
@@ -129,42 +96,63 @@ ExceptionOr<ByteArray> BaseEndpointChannel::Read() {
 
 ExceptionOr<ByteArray> BaseEndpointChannel::Read(
     PacketMetaData& packet_meta_data) {
+  return ReadFrame(packet_meta_data, /*blocking=*/true);
+}
+
+ExceptionOr<ByteArray> BaseEndpointChannel::TryRead(
+    PacketMetaData& packet_meta_data) {
+  return ReadFrame(packet_meta_data, /*blocking=*/false);
+}
+
+ExceptionOr<ByteArray> BaseEndpointChannel::ReadFrame(
+    PacketMetaData& packet_meta_data, bool blocking) {
   ByteArray result;
   {
     MutexLock lock(&reader_mutex_);
 
     packet_meta_data.StartSocketIo();
-    ExceptionOr<std::int32_t> read_int = ReadInt(reader_);
-    if (!read_int.ok()) {
-      return ExceptionOr<ByteArray>(read_int.exception());
+    ExceptionOr<bool> complete = ReadPendingFrameLocked(blocking);
+    if (!complete.ok()) {
+      ResetPendingFrameLocked();
+      return ExceptionOr<ByteArray>(complete.exception());
     }
-
-    if (read_int.result() < 0 || read_int.result() > kMaxAllowedReadBytes) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Read an invalid number of bytes: "
-                           << read_int.result();
-      return ExceptionOr<ByteArray>(Exception::kIo);
-    }
-
-    ExceptionOr<ByteArray> read_bytes = ReadExactly(reader_, read_int.result());
-    if (!read_bytes.ok()) {
-      return read_bytes;
+    if (!complete.result()) {
+      return ExceptionOr<ByteArray>(Exception::kTimeout);
     }
     packet_meta_data.StopSocketIo();
-    packet_meta_data.SetPacketSize(read_int.result() + sizeof(std::int32_t));
-    result = std::move(read_bytes.result());
+    packet_meta_data.SetPacketSize(pending_frame_size_ + sizeof(std::int32_t));
+    result = ByteArray::Concat(pending_parts_);
+    ResetPendingFrameLocked();
   }
 
   {
-    MutexLock crypto_lock(&crypto_mutex_);
-    if (IsEncryptionEnabledLocked()) {
+    MutexLock crypto_lock(&decrypt_mutex_);
+    if (decrypt_context_ != nullptr) {
       // If encryption is enabled, decode the message.
-      std::string input(std::move(result));
+      ByteArray input = std::move(result);
+      bool decrypted = false;
       packet_meta_data.StartEncryption();
-      std::unique_ptr<std::string> decrypted_data =
-          crypto_context_->DecodeMessageFromPeer(input);
-      if (decrypted_data) {
-        result = ByteArray(std::move(*decrypted_data));
+      if (decrypt_cipher_ != nullptr) {
+        // Large frames are opened in place; they can not be a KEEP_ALIVE.
+        ExceptionOr<ByteArray> opened =
+            input.size() <= kMaxUnencryptedKeepAliveSize
+                ? decrypt_cipher_->Open(input)
+                : decrypt_cipher_->Open(std::move(input));
+        if (opened.ok()) {
+          result = std::move(opened.result());
+          decrypted = true;
+        }
       } else {
+        std::string scratch;
+        std::unique_ptr<std::string> decrypted_data =
+            decrypt_context_->DecodeMessageFromPeer(input.AsString(&scratch));
+        if (decrypted_data) {
+          ByteCopyCounter::Record(decrypted_data->size());
+          result = ByteArray(std::move(*decrypted_data));
+          decrypted = true;
+        }
+      }
+      if (!decrypted) {
         // It could be a protocol race, where remote party sends a KEEP_ALIVE
         // before encryption is setup on their side, and we receive it after
         // we switched to encryption mode.
@@ -172,13 +160,13 @@ ExceptionOr<ByteArray> BaseEndpointChannel::Read(
         // and let it through if it is, otherwise message is erased.
         // TODO(apolyudov): verify this happens at most once per session.
         result = {};
-        auto parsed = parser::FromBytes(ByteArray(input));
+        auto parsed = parser::FromBytes(input);
         if (parsed.ok()) {
           if (parser::GetFrameType(parsed.result()) == V1Frame::KEEP_ALIVE) {
             NEARBY_LOGS(INFO)
                 << __func__
                 << ": Read unencrypted KEEP_ALIVE on encrypted channel.";
-            result = ByteArray(input);
+            result = std::move(input);
           } else {
             NEARBY_LOGS(WARNING)
                 << __func__ << ": Read unexpected unencrypted frame of type "
@@ -201,7 +189,51 @@ ExceptionOr<ByteArray> BaseEndpointChannel::Read(
     MutexLock lock(&last_read_mutex_);
     last_read_timestamp_ = SystemClock::ElapsedRealtime();
   }
-  return ExceptionOr<ByteArray>(result);
+  return ExceptionOr<ByteArray>(std::move(result));
+}
+
+ExceptionOr<bool> BaseEndpointChannel::ReadPendingFrameLocked(bool blocking) {
+  while (true) {
+    // The length prefix comes first, then that many bytes of frame.
+    std::int64_t size = pending_frame_size_ < 0 ? sizeof(std::int32_t)
+                                                : pending_frame_size_;
+    if (pending_frame_size_ >= 0 && pending_bytes_ == size) {
+      return ExceptionOr<bool>(true);
+    }
+    if (!blocking && !reader_->IsReadable()) {
+      return ExceptionOr<bool>(false);
+    }
+
+    ExceptionOr<ByteArray> read_bytes = reader_->Read(size - pending_bytes_);
+    if (!read_bytes.ok()) {
+      return ExceptionOr<bool>(read_bytes.exception());
+    }
+    if (read_bytes.result().Empty()) {
+      NEARBY_LOGS(WARNING) << __func__ << ": Empty result when reading bytes.";
+      return ExceptionOr<bool>(Exception::kIo);
+    }
+    pending_bytes_ += read_bytes.result().size();
+    pending_parts_.push_back(std::move(read_bytes.result()));
+
+    if (pending_frame_size_ < 0 && pending_bytes_ == size) {
+      std::int32_t frame_size = BytesToInt(ByteArray::Concat(pending_parts_));
+      if (frame_size < 0 || frame_size > kMaxAllowedReadBytes) {
+        NEARBY_LOGS(WARNING) << __func__
+                             << ": Read an invalid number of bytes: "
+                             << frame_size;
+        return ExceptionOr<bool>(Exception::kIo);
+      }
+      pending_frame_size_ = frame_size;
+      pending_bytes_ = 0;
+      pending_parts_.clear();
+    }
+  }
+}
+
+void BaseEndpointChannel::ResetPendingFrameLocked() {
+  pending_frame_size_ = -1;
+  pending_bytes_ = 0;
+  pending_parts_.clear();
 }
 
 Exception BaseEndpointChannel::Write(const ByteArray& data) {
@@ -211,6 +243,22 @@ Exception BaseEndpointChannel::Write(const ByteArray& data) {
 
 Exception BaseEndpointChannel::Write(const ByteArray& data,
                                      PacketMetaData& packet_meta_data) {
+  return WriteFrame(data, packet_meta_data, FrameKind::kOrdinary);
+}
+
+Exception BaseEndpointChannel::WriteLast(const ByteArray& data) {
+  PacketMetaData packet_meta_data;
+  return WriteFrame(data, packet_meta_data, FrameKind::kLast);
+}
+
+Exception BaseEndpointChannel::WriteUnencrypted(const ByteArray& data) {
+  PacketMetaData packet_meta_data;
+  return WriteFrame(data, packet_meta_data, FrameKind::kUnencrypted);
+}
+
+Exception BaseEndpointChannel::WriteFrame(const ByteArray& data,
+                                          PacketMetaData& packet_meta_data,
+                                          FrameKind kind) {
   {
     MutexLock pause_lock(&is_paused_mutex_);
     if (is_paused_) {
@@ -218,60 +266,68 @@ Exception BaseEndpointChannel::Write(const ByteArray& data,
     }
   }
 
-  ByteArray encrypted_data;
-  const ByteArray* data_to_write = &data;
+  OutgoingFrame frame;
   {
-    // Holding both mutexes is necessary to prevent the keep alive and payload
-    // threads from writing encrypted messages out of order which causes a
-    // failure to decrypt on the reader side. However we need to release the
-    // crypto lock after encrypting to ensure read decryption is not blocked.
-    MutexLock lock(&writer_mutex_);
-    {
-      MutexLock crypto_lock(&crypto_mutex_);
-      if (IsEncryptionEnabledLocked()) {
-        // If encryption is enabled, encode the message.
-        packet_meta_data.StartEncryption();
-        std::unique_ptr<std::string> encrypted =
-            crypto_context_->EncodeMessageToPeer(std::string(data));
-        packet_meta_data.StopEncryption();
-        if (!encrypted) {
-          NEARBY_LOGS(WARNING) << __func__ << ": Failed to encrypt data.";
-          return {Exception::kIo};
-        }
-        encrypted_data = ByteArray(std::move(*encrypted));
-        data_to_write = &encrypted_data;
+    // Frames are queued in the order they are encrypted in, and written in
+    // queue order. This keeps the keep alive and payload threads from writing
+    // encrypted messages out of order, which causes a failure to decrypt on
+    // the reader side, without holding the crypto lock while writing.
+    MutexLock crypto_lock(&encrypt_mutex_);
+    if (kind != FrameKind::kUnencrypted && last_write_queued_) {
+      NEARBY_LOGS(WARNING) << __func__
+                           << ": Refusing to write after the last write on "
+                           << channel_name_;
+      return {Exception::kIo};
+    }
+    if (kind == FrameKind::kUnencrypted) {
+      frame.bytes = data;
+    } else if (encrypt_cipher_ != nullptr) {
+      packet_meta_data.StartEncryption();
+      ExceptionOr<ByteArray> sealed = encrypt_cipher_->Seal(data);
+      packet_meta_data.StopEncryption();
+      if (!sealed.ok()) {
+        NEARBY_LOGS(WARNING) << __func__ << ": Failed to encrypt data.";
+        return {Exception::kIo};
+      }
+      frame.bytes = std::move(sealed.result());
+    } else if (encrypt_context_ != nullptr) {
+      // If encryption is enabled, encode the message.
+      std::string scratch;
+      packet_meta_data.StartEncryption();
+      std::unique_ptr<std::string> encrypted =
+          encrypt_context_->EncodeMessageToPeer(data.AsString(&scratch));
+      packet_meta_data.StopEncryption();
+      if (!encrypted) {
+        NEARBY_LOGS(WARNING) << __func__ << ": Failed to encrypt data.";
+        return {Exception::kIo};
       }
+      ByteCopyCounter::Record(encrypted->size());
+      frame.bytes = ByteArray(std::move(*encrypted));
+    } else {
+      frame.bytes = data;
     }
 
-    size_t data_size = data_to_write->size();
-    if (data_size < 0 || data_size > kMaxAllowedReadBytes) {
+    if (frame.bytes.size() > kMaxAllowedReadBytes) {
       NEARBY_LOGS(WARNING) << __func__ << ": Write an invalid number of bytes: "
-                           << data_size;
+                           << frame.bytes.size();
       return {Exception::kIo};
     }
+    if (kind == FrameKind::kLast) last_write_queued_ = true;
+    outgoing_frames_.push_back(&frame);
+  }
 
+  {
+    MutexLock lock(&writer_mutex_);
     packet_meta_data.StartSocketIo();
-    Exception write_exception =
-        WriteInt(writer_, static_cast<std::int32_t>(data_size));
-    if (write_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to write header: "
-                           << write_exception.value;
-      return write_exception;
+    // Unless another writer already wrote our frame along with its own.
+    while (!frame.written) {
+      WriteOutgoingFramesLocked();
     }
-    write_exception = writer_->Write(*data_to_write);
-    if (write_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to write data: "
-                           << write_exception.value;
-      return write_exception;
-    }
-    Exception flush_exception = writer_->Flush();
-    if (flush_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to flush writer: "
-                           << flush_exception.value;
-      return flush_exception;
+    if (frame.result.Raised()) {
+      return frame.result;
     }
     packet_meta_data.StopSocketIo();
-    packet_meta_data.SetPacketSize(data_size + sizeof(std::uint32_t));
+    packet_meta_data.SetPacketSize(frame.bytes.size() + sizeof(std::uint32_t));
   }
 
   {
@@ -281,6 +337,51 @@ Exception BaseEndpointChannel::Write(const ByteArray& data,
   return {Exception::kSuccess};
 }
 
+void BaseEndpointChannel::WriteOutgoingFramesLocked() {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  std::vector<OutgoingFrame*> frames;
+  {
+    MutexLock crypto_lock(&encrypt_mutex_);
+    std::int64_t total_size = 0;
+    while (!outgoing_frames_.empty()) {
+      OutgoingFrame* frame = outgoing_frames_.front();
+      std::int64_t size = frame->bytes.size() + sizeof(std::int32_t);
+      if (!frames.empty() &&
+          (!flags.enable_frame_coalescing ||
+           total_size + size > flags.max_coalesced_frame_bytes)) {
+        break;
+      }
+      frames.push_back(frame);
+      total_size += size;
+      outgoing_frames_.pop_front();
+    }
+  }
+
+  // Each frame is its length followed by its bytes; all of them go out in one
+  // call, so that the medium can send them in as few packets as it is able to.
+  std::vector<ByteArray> parts;
+  parts.reserve(frames.size() * 2);
+  for (const OutgoingFrame* frame : frames) {
+    parts.push_back(IntToBytes(static_cast<std::int32_t>(frame->bytes.size())));
+    parts.push_back(frame->bytes);
+  }
+  Exception exception = writer_->WriteV(parts);
+  if (exception.Raised()) {
+    NEARBY_LOGS(WARNING) << __func__ << ": Failed to write data: "
+                         << exception.value;
+  } else {
+    exception = writer_->Flush();
+    if (exception.Raised()) {
+      NEARBY_LOGS(WARNING) << __func__ << ": Failed to flush writer: "
+                           << exception.value;
+    }
+  }
+  for (OutgoingFrame* frame : frames) {
+    frame->result = exception;
+    frame->written = true;
+  }
+}
+
 void BaseEndpointChannel::Close() {
   {
     // In case channel is paused, resume it first thing.
@@ -334,8 +435,11 @@ void BaseEndpointChannel::Close(
 }
 
 std::string BaseEndpointChannel::GetType() const {
-  MutexLock crypto_lock(&crypto_mutex_);
-  std::string subtype = IsEncryptionEnabledLocked() ? "ENCRYPTED_" : "";
+  std::string subtype;
+  {
+    MutexLock crypto_lock(&encrypt_mutex_);
+    if (encrypt_context_ != nullptr) subtype = "ENCRYPTED_";
+  }
   std::string medium = proto::connections::Medium_Name(
       proto::connections::Medium::UNKNOWN_MEDIUM);
 
@@ -356,14 +460,22 @@ int BaseEndpointChannel::GetMaxTransmitPacketSize() const {
 }
 
 void BaseEndpointChannel::EnableEncryption(
-    std::shared_ptr<EncryptionContext> context) {
-  MutexLock crypto_lock(&crypto_mutex_);
-  crypto_context_ = context;
+    const EncryptionContexts& contexts, std::shared_ptr<FrameCipher> cipher) {
+  MutexLock encrypt_lock(&encrypt_mutex_);
+  MutexLock decrypt_lock(&decrypt_mutex_);
+  encrypt_context_ = contexts.encrypt;
+  decrypt_context_ = contexts.decrypt;
+  encrypt_cipher_ = cipher;
+  decrypt_cipher_ = std::move(cipher);
 }
 
 void BaseEndpointChannel::DisableEncryption() {
-  MutexLock crypto_lock(&crypto_mutex_);
-  crypto_context_.reset();
+  MutexLock encrypt_lock(&encrypt_mutex_);
+  MutexLock decrypt_lock(&decrypt_mutex_);
+  encrypt_context_.reset();
+  decrypt_context_.reset();
+  encrypt_cipher_.reset();
+  decrypt_cipher_.reset();
 }
 
 bool BaseEndpointChannel::IsPaused() const {
@@ -392,6 +504,16 @@ absl::Time BaseEndpointChannel::GetLastWriteTimestamp() const {
   return last_write_timestamp_;
 }
 
+// Do not take reader_mutex_ in the readiness methods: a blocking Read() may be
+// in progress, and the readiness state of the stream is synchronized by the
+// stream itself.
+bool BaseEndpointChannel::IsReadable() { return reader_->IsReadable(); }
+
+bool BaseEndpointChannel::SetReadinessListener(
+    std::function<void()> listener) {
+  return reader_->SetReadinessListener(std::move(listener));
+}
+
 proto::connections::ConnectionTechnology BaseEndpointChannel::GetTechnology()
     const {
   return technology_;
@@ -408,10 +530,6 @@ int BaseEndpointChannel::GetFrequency() const { return frequency_; }
 // Returns the try count of this EndpointChannel.
 int BaseEndpointChannel::GetTryCount() const { return try_count_; }
 
-bool BaseEndpointChannel::IsEncryptionEnabledLocked() const {
-  return crypto_context_ != nullptr;
-}
-
 void BaseEndpointChannel::BlockUntilUnpaused() {
   // For more on how this works, see
   // https://docs.oracle.com/javase/tutorial/essential/concurrency/guardmeth.html
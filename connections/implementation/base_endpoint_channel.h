@@ -16,8 +16,11 @@
 #define CORE_INTERNAL_BASE_ENDPOINT_CHANNEL_H_
 
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
@@ -50,11 +53,15 @@ class BaseEndpointChannel : public EndpointChannel {
   // EndpointChannel:
   ExceptionOr<ByteArray> Read() override;
   ExceptionOr<ByteArray> Read(PacketMetaData& packet_meta_data)
-      ABSL_LOCKS_EXCLUDED(reader_mutex_, crypto_mutex_,
+      ABSL_LOCKS_EXCLUDED(reader_mutex_, decrypt_mutex_,
                           last_read_mutex_) override;
   Exception Write(const ByteArray& data) override;
   Exception Write(const ByteArray& data, PacketMetaData& packet_meta_data)
-      ABSL_LOCKS_EXCLUDED(writer_mutex_, crypto_mutex_) override;
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, encrypt_mutex_) override;
+  Exception WriteLast(const ByteArray& data)
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, encrypt_mutex_) override;
+  Exception WriteUnencrypted(const ByteArray& data)
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, encrypt_mutex_) override;
   void Close() ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
   void Close(proto::connections::DisconnectionReason reason) override;
   std::string GetType() const override;
@@ -65,8 +72,11 @@ class BaseEndpointChannel : public EndpointChannel {
   int GetFrequency() const override;
   int GetTryCount() const override;
   int GetMaxTransmitPacketSize() const override;
-  void EnableEncryption(std::shared_ptr<EncryptionContext> context) override;
-  void DisableEncryption() override;
+  void EnableEncryption(const EncryptionContexts& contexts,
+                        std::shared_ptr<FrameCipher> cipher)
+      ABSL_LOCKS_EXCLUDED(encrypt_mutex_, decrypt_mutex_) override;
+  void DisableEncryption()
+      ABSL_LOCKS_EXCLUDED(encrypt_mutex_, decrypt_mutex_) override;
   bool IsPaused() const ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
   void Pause() ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
   void Resume() ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
@@ -74,6 +84,12 @@ class BaseEndpointChannel : public EndpointChannel {
       ABSL_LOCKS_EXCLUDED(last_read_mutex_) override;
   absl::Time GetLastWriteTimestamp() const
       ABSL_LOCKS_EXCLUDED(last_write_mutex_) override;
+  bool IsReadable() ABSL_NO_THREAD_SAFETY_ANALYSIS override;
+  ExceptionOr<ByteArray> TryRead(PacketMetaData& packet_meta_data)
+      ABSL_LOCKS_EXCLUDED(reader_mutex_, decrypt_mutex_,
+                          last_read_mutex_) override;
+  bool SetReadinessListener(std::function<void()> listener)
+      ABSL_NO_THREAD_SAFETY_ANALYSIS override;
   void SetAnalyticsRecorder(analytics::AnalyticsRecorder* analytics_recorder,
                             const std::string& endpoint_id) override;
 
@@ -84,11 +100,48 @@ class BaseEndpointChannel : public EndpointChannel {
   // Used to sanity check that our frame sizes are reasonable.
   static constexpr std::int32_t kMaxAllowedReadBytes = 1048576;  // 1MB
 
+  // Sealed frames up to this size are opened out of place, so that they can
+  // still be checked for an unencrypted KEEP_ALIVE if they fail to open.
+  static constexpr int kMaxUnencryptedKeepAliveSize = 64;
+
   // The default maximum transmit unit/packet size.
   static constexpr int kDefaultMaxTransmitPacketSize = 65536;  // 64 KB
 
-  bool IsEncryptionEnabledLocked() const
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(crypto_mutex_);
+  // A frame queued by Write().
+  struct OutgoingFrame {
+    ByteArray bytes;
+    // Set under writer_mutex_ once the frame has been written, possibly by
+    // another writer.
+    bool written = false;
+    Exception result = {Exception::kSuccess};
+  };
+
+  enum class FrameKind {
+    kOrdinary,
+    // Refuses the ordinary frames written after it; see WriteLast().
+    kLast,
+    // Bypasses encryption, and is written even after the last frame.
+    kUnencrypted,
+  };
+
+  ExceptionOr<ByteArray> ReadFrame(PacketMetaData& packet_meta_data,
+                                   bool blocking)
+      ABSL_LOCKS_EXCLUDED(reader_mutex_, decrypt_mutex_, last_read_mutex_);
+
+  // Reads the rest of the frame coming in, or, unless |blocking|, as much of
+  // it as |reader_| has without blocking. Returns true once it is all in.
+  ExceptionOr<bool> ReadPendingFrameLocked(bool blocking)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(reader_mutex_);
+  void ResetPendingFrameLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(reader_mutex_);
+
+  Exception WriteFrame(const ByteArray& data, PacketMetaData& packet_meta_data,
+                       FrameKind kind)
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, encrypt_mutex_);
+
+  // Writes the frame at the head of |outgoing_frames_|, along with the ones
+  // queued behind it if frame coalescing is enabled.
+  void WriteOutgoingFramesLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(writer_mutex_)
+      ABSL_LOCKS_EXCLUDED(encrypt_mutex_);
   void UnblockPausedWriter() ABSL_EXCLUSIVE_LOCKS_REQUIRED(is_paused_mutex_);
   void BlockUntilUnpaused() ABSL_EXCLUSIVE_LOCKS_REQUIRED(is_paused_mutex_);
   void CloseIo() ABSL_NO_THREAD_SAFETY_ANALYSIS;
@@ -112,14 +165,38 @@ class BaseEndpointChannel : public EndpointChannel {
   // writes waiting on reads that might potentially block forever.
   Mutex reader_mutex_;
   InputStream* reader_ ABSL_PT_GUARDED_BY(reader_mutex_);
+  // The frame coming in: its size, once the length prefix is in (-1 before),
+  // and the parts of the prefix or of the frame read so far. TryRead() leaves
+  // a frame here which has not fully arrived yet.
+  std::int32_t pending_frame_size_ ABSL_GUARDED_BY(reader_mutex_) = -1;
+  std::int64_t pending_bytes_ ABSL_GUARDED_BY(reader_mutex_) = 0;
+  std::vector<ByteArray> pending_parts_ ABSL_GUARDED_BY(reader_mutex_);
 
   Mutex writer_mutex_;
   OutputStream* writer_ ABSL_PT_GUARDED_BY(writer_mutex_);
 
-  // An encryptor/decryptor. May be null.
-  mutable Mutex crypto_mutex_;
-  std::shared_ptr<EncryptionContext> crypto_context_
-      ABSL_GUARDED_BY(crypto_mutex_) ABSL_PT_GUARDED_BY(crypto_mutex_);
+  // The encryptor/decryptor; null while encryption is disabled. Each
+  // direction holds its own context, or reference to the frame cipher, under
+  // its own lock, which also keeps the frames of that direction in sequence.
+  //
+  // The frame cipher keeps its send and receive state apart (see
+  // frame_cipher.h), and each direction has a context of its own (see
+  // EncryptionContexts), so a frame going out does not wait for one coming in
+  // to be decrypted.
+  mutable Mutex encrypt_mutex_;
+  std::shared_ptr<EncryptionContext> encrypt_context_
+      ABSL_GUARDED_BY(encrypt_mutex_) ABSL_PT_GUARDED_BY(encrypt_mutex_);
+  std::shared_ptr<FrameCipher> encrypt_cipher_ ABSL_GUARDED_BY(encrypt_mutex_);
+  // Frames waiting to be written, in the order they were encrypted in.
+  std::deque<OutgoingFrame*> outgoing_frames_ ABSL_GUARDED_BY(encrypt_mutex_);
+  // Set once WriteLast() queued its frame, in the same critical section, so
+  // that no ordinary frame gets encrypted after it.
+  bool last_write_queued_ ABSL_GUARDED_BY(encrypt_mutex_) = false;
+
+  mutable Mutex decrypt_mutex_;
+  std::shared_ptr<EncryptionContext> decrypt_context_
+      ABSL_GUARDED_BY(decrypt_mutex_) ABSL_PT_GUARDED_BY(decrypt_mutex_);
+  std::shared_ptr<FrameCipher> decrypt_cipher_ ABSL_GUARDED_BY(decrypt_mutex_);
 
   mutable Mutex is_paused_mutex_;
   ConditionVariable is_paused_cond_{&is_paused_mutex_};
@@ -0,0 +1,200 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Measures encrypted frame throughput over a pair of simulated WifiLan
+// sockets, with frames going in one direction only and in both directions at
+// once.
+//
+// The *FrameCipher variants encrypt with the AEAD frame cipher instead of
+// wrapping every frame in a SecureMessage. Only the frame cipher encrypts and
+// decrypts at once, so only BM_DuplexFrameCipher should rise above its one way
+// figure, given a core per direction; BM_Duplex serializes on the connection
+// context. Compare them on a machine with at least four cores.
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "securegcm/d2d_connection_context_v1.h"
+#include "securegcm/ukey2_handshake.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "connections/implementation/frame_cipher.h"
+#include "connections/implementation/wifi_lan_endpoint_channel.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/medium_environment.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/nsd_service_info.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/wifi_lan.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr int kFramesPerDirection = 256;
+
+using EncryptionContext = BaseEndpointChannel::EncryptionContext;
+
+// Runs a UKEY2 handshake in memory, and returns the client and the server
+// contexts.
+std::pair<std::unique_ptr<EncryptionContext>,
+          std::unique_ptr<EncryptionContext>>
+CreateContextPair() {
+  constexpr auto kCipher =
+      securegcm::UKey2Handshake::HandshakeCipher::P256_SHA512;
+  auto client = securegcm::UKey2Handshake::ForInitiator(kCipher);
+  auto server = securegcm::UKey2Handshake::ForResponder(kCipher);
+  server->ParseHandshakeMessage(*client->GetNextHandshakeMessage());
+  client->ParseHandshakeMessage(*server->GetNextHandshakeMessage());
+  server->ParseHandshakeMessage(*client->GetNextHandshakeMessage());
+  client->VerifyHandshake();
+  server->VerifyHandshake();
+  return {client->ToConnectionContext(), server->ToConnectionContext()};
+}
+
+// Two encrypted WifiLan endpoint channels connected to each other. The
+// medium environment has to be running before this is created.
+class ChannelPair {
+ public:
+  explicit ChannelPair(bool frame_cipher) {
+    WifiLanServerSocket server_socket = medium_b_.ListenForService();
+    // Simulated sockets are looked up through the advertisement they are
+    // listening for.
+    NsdServiceInfo service_info;
+    service_info.SetServiceName("service");
+    service_info.SetServiceType("_service._tcp.");
+    service_info.SetIPAddress(server_socket.GetIPAddress());
+    service_info.SetPort(server_socket.GetPort());
+    medium_b_.StartAdvertising(service_info);
+    MediumEnvironment::Instance().Sync();
+    WifiLanSocket socket_a;
+    WifiLanSocket socket_b;
+    {
+      SingleThreadExecutor connect_executor;
+      connect_executor.Execute([this, &server_socket, &socket_a]() {
+        CancellationFlag flag;
+        socket_a = medium_a_.ConnectToService(server_socket.GetIPAddress(),
+                                              server_socket.GetPort(), &flag);
+        if (!socket_a.IsValid()) server_socket.Close();
+      });
+      socket_b = server_socket.Accept();
+    }
+    server_socket.Close();
+    channel_a_ = std::make_unique<WifiLanEndpointChannel>("service", "a",
+                                                          std::move(socket_a));
+    channel_b_ = std::make_unique<WifiLanEndpointChannel>("service", "b",
+                                                          std::move(socket_b));
+    auto contexts = CreateContextPair();
+    std::shared_ptr<FrameCipher> cipher_a;
+    std::shared_ptr<FrameCipher> cipher_b;
+    if (frame_cipher) {
+      cipher_a = FrameCipher::Create(*contexts.first, /*is_client=*/true);
+      cipher_b = FrameCipher::Create(*contexts.second, /*is_client=*/false);
+    }
+    channel_a_->EnableEncryption(
+        EndpointChannel::EncryptionContexts::Split(std::move(contexts.first)),
+        std::move(cipher_a));
+    channel_b_->EnableEncryption(
+        EndpointChannel::EncryptionContexts::Split(std::move(contexts.second)),
+        std::move(cipher_b));
+  }
+
+  ~ChannelPair() {
+    channel_a_->Close();
+    channel_b_->Close();
+  }
+
+  EndpointChannel& a() { return *channel_a_; }
+  EndpointChannel& b() { return *channel_b_; }
+
+ private:
+  WifiLanMedium medium_a_;
+  WifiLanMedium medium_b_;
+  std::unique_ptr<EndpointChannel> channel_a_;
+  std::unique_ptr<EndpointChannel> channel_b_;
+};
+
+// Sends kFramesPerDirection frames from |from| to |to| on |executor|.
+void Transfer(MultiThreadExecutor& executor, EndpointChannel& from,
+              EndpointChannel& to, const ByteArray& frame,
+              CountDownLatch& done) {
+  executor.Execute([&from, &frame, &done]() {
+    for (int i = 0; i < kFramesPerDirection; ++i) {
+      if (from.Write(frame).Raised()) break;
+    }
+    done.CountDown();
+  });
+  executor.Execute([&to, &done]() {
+    for (int i = 0; i < kFramesPerDirection; ++i) {
+      if (!to.Read().ok()) break;
+    }
+    done.CountDown();
+  });
+}
+
+void RunTransfers(benchmark::State& state, bool duplex, bool frame_cipher) {
+  const ByteArray frame(std::string(state.range(0), 'x'));
+  const int directions = duplex ? 2 : 1;
+  MediumEnvironment::Instance().Start();
+  {
+    ChannelPair channels(frame_cipher);
+    MultiThreadExecutor executor(2 * directions);
+    for (auto _ : state) {
+      CountDownLatch done(2 * directions);
+      Transfer(executor, channels.a(), channels.b(), frame, done);
+      if (duplex) Transfer(executor, channels.b(), channels.a(), frame, done);
+      done.Await();
+    }
+  }
+  MediumEnvironment::Instance().Stop();
+  state.SetBytesProcessed(state.iterations() * directions *
+                          kFramesPerDirection * frame.size());
+}
+
+void BM_OneWay(benchmark::State& state) {
+  RunTransfers(state, /*duplex=*/false, /*frame_cipher=*/false);
+}
+
+void BM_Duplex(benchmark::State& state) {
+  RunTransfers(state, /*duplex=*/true, /*frame_cipher=*/false);
+}
+
+void BM_OneWayFrameCipher(benchmark::State& state) {
+  RunTransfers(state, /*duplex=*/false, /*frame_cipher=*/true);
+}
+
+void BM_DuplexFrameCipher(benchmark::State& state) {
+  RunTransfers(state, /*duplex=*/true, /*frame_cipher=*/true);
+}
+
+BENCHMARK(BM_OneWay)->RangeMultiplier(4)->Range(1024, 64 * 1024)->UseRealTime();
+BENCHMARK(BM_Duplex)->RangeMultiplier(4)->Range(1024, 64 * 1024)->UseRealTime();
+BENCHMARK(BM_OneWayFrameCipher)
+    ->RangeMultiplier(4)
+    ->Range(1024, 64 * 1024)
+    ->UseRealTime();
+BENCHMARK(BM_DuplexFrameCipher)
+    ->RangeMultiplier(4)
+    ->Range(1024, 64 * 1024)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+BENCHMARK_MAIN();
@@ -17,18 +17,22 @@
 #include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "securegcm/d2d_connection_context_v1.h"
 #include "securegcm/ukey2_handshake.h"
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "connections/implementation/encryption_runner.h"
+#include "connections/implementation/frame_cipher.h"
 #include "connections/implementation/offline_frames.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/output_stream.h"
 #include "internal/platform/count_down_latch.h"
@@ -36,6 +40,7 @@
 #include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/pipe.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/system_clock.h"
 #include "proto/connections_enums.pb.h"
 
 namespace location {
@@ -46,6 +51,9 @@ namespace {
 using ::location::nearby::proto::connections::DisconnectionReason;
 using ::location::nearby::proto::connections::Medium;
 using EncryptionContext = BaseEndpointChannel::EncryptionContext;
+using EncryptionContexts = BaseEndpointChannel::EncryptionContexts;
+using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
 
 class TestEndpointChannel : public BaseEndpointChannel {
  public:
@@ -96,12 +104,61 @@ std::function<void(const ByteArray&)> MakeDataMonitor(const std::string& label,
   };
 }
 
-std::pair<std::shared_ptr<EncryptionContext>,
-          std::shared_ptr<EncryptionContext>>
-DoDhKeyExchange(BaseEndpointChannel* channel_a,
-                BaseEndpointChannel* channel_b) {
-  std::shared_ptr<EncryptionContext> context_a;
-  std::shared_ptr<EncryptionContext> context_b;
+// Forwards writes to |output|, recording how many parts every WriteV() call
+// had. The first WriteV() call blocks until |release_first_write| is counted
+// down, if given.
+class RecordingOutputStream : public OutputStream {
+ public:
+  explicit RecordingOutputStream(OutputStream* output,
+                                 CountDownLatch* release_first_write = nullptr)
+      : output_(output), release_first_write_(release_first_write) {}
+
+  Exception Write(const ByteArray& data) override {
+    absl::MutexLock lock(&mutex_);
+    ++single_writes_;
+    return output_->Write(data);
+  }
+  Exception WriteV(const std::vector<ByteArray>& data) override {
+    bool first_write;
+    {
+      absl::MutexLock lock(&mutex_);
+      first_write = parts_per_write_.empty();
+      parts_per_write_.push_back(data.size());
+    }
+    if (first_write && release_first_write_ != nullptr) {
+      first_write_started_.CountDown();
+      release_first_write_->Await();
+    }
+    return output_->WriteV(data);
+  }
+  Exception Flush() override { return output_->Flush(); }
+  Exception Close() override { return output_->Close(); }
+
+  void AwaitFirstWrite() { first_write_started_.Await(); }
+  int GetSingleWrites() {
+    absl::MutexLock lock(&mutex_);
+    return single_writes_;
+  }
+  std::vector<int> GetPartsPerWrite() {
+    absl::MutexLock lock(&mutex_);
+    return parts_per_write_;
+  }
+
+ private:
+  OutputStream* output_;
+  CountDownLatch* release_first_write_;
+  CountDownLatch first_write_started_{1};
+  absl::Mutex mutex_;
+  int single_writes_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::vector<int> parts_per_write_ ABSL_GUARDED_BY(mutex_);
+};
+
+// Returns the contexts of both sides, split the way EndpointChannelManager
+// splits them.
+std::pair<EncryptionContexts, EncryptionContexts> DoDhKeyExchange(
+    BaseEndpointChannel* channel_a, BaseEndpointChannel* channel_b) {
+  std::unique_ptr<EncryptionContext> context_a;
+  std::unique_ptr<EncryptionContext> context_b;
   EncryptionRunner crypto_a;
   EncryptionRunner crypto_b;
   ClientProxy proxy_a;
@@ -154,7 +211,8 @@ DoDhKeyExchange(BaseEndpointChannel* channel_a,
               },
       });
   EXPECT_TRUE(latch.Await(absl::Milliseconds(5000)).result());
-  return std::make_pair(std::move(context_a), std::move(context_b));
+  return std::make_pair(EncryptionContexts::Split(std::move(context_a)),
+                        EncryptionContexts::Split(std::move(context_b)));
 }
 
 TEST(BaseEndpointChannelTest, ConstructorDestructorWorks) {
@@ -179,6 +237,115 @@ TEST(BaseEndpointChannelTest, ReadWrite) {
   EXPECT_EQ(rx_message, tx_message);
 }
 
+TEST(BaseEndpointChannelTest, WritesLengthAndFrameInOneCall) {
+  Pipe pipe;
+  RecordingOutputStream output(&pipe.GetOutputStream());
+  TestEndpointChannel channel(&pipe.GetInputStream(), &output);
+
+  ByteArray tx_message{"data message"};
+  EXPECT_FALSE(channel.Write(tx_message).Raised());
+  EXPECT_FALSE(channel.Write(tx_message).Raised());
+
+  EXPECT_EQ(output.GetSingleWrites(), 0);
+  EXPECT_THAT(output.GetPartsPerWrite(), ElementsAre(2, 2));
+  EXPECT_EQ(channel.Read().result(), tx_message);
+  EXPECT_EQ(channel.Read().result(), tx_message);
+}
+
+TEST(BaseEndpointChannelTest, TryReadKeepsPartialFrame) {
+  Pipe pipe;
+  OutputStream& output_stream = pipe.GetOutputStream();
+  TestEndpointChannel channel(&pipe.GetInputStream(), &output_stream);
+  PacketMetaData packet_meta_data;
+
+  // The length prefix of a 12 byte frame, then the frame in two parts.
+  EXPECT_FALSE(output_stream.Write(ByteArray("\0\0\0\x0c", 4)).Raised());
+  EXPECT_TRUE(channel.TryRead(packet_meta_data)
+                  .GetException()
+                  .Raised(Exception::kTimeout));
+  EXPECT_FALSE(output_stream.Write(ByteArray("data ")).Raised());
+  EXPECT_TRUE(channel.TryRead(packet_meta_data)
+                  .GetException()
+                  .Raised(Exception::kTimeout));
+  EXPECT_FALSE(output_stream.Write(ByteArray("message")).Raised());
+  EXPECT_EQ(channel.TryRead(packet_meta_data).result(),
+            ByteArray("data message"));
+
+  // A Read() completes a frame that a TryRead() started.
+  EXPECT_FALSE(output_stream.Write(ByteArray("\0\0\0\x0cnext ", 9)).Raised());
+  EXPECT_TRUE(channel.TryRead(packet_meta_data)
+                  .GetException()
+                  .Raised(Exception::kTimeout));
+  EXPECT_FALSE(output_stream.Write(ByteArray("message")).Raised());
+  EXPECT_EQ(channel.Read().result(), ByteArray("next message"));
+}
+
+TEST(BaseEndpointChannelTest, CoalescesFramesQueuedBehindAWrite) {
+  FeatureFlags::Flags saved_flags = FeatureFlags::GetInstance().GetFlags();
+  FeatureFlags::GetMutableFlagsForTesting().enable_frame_coalescing = true;
+  Pipe pipe;
+  CountDownLatch release_first_write(1);
+  RecordingOutputStream output(&pipe.GetOutputStream(), &release_first_write);
+  TestEndpointChannel channel(&pipe.GetInputStream(), &output);
+  MultiThreadExecutor executor(4);
+
+  executor.Execute([&channel]() { channel.Write(ByteArray{"frame-0"}); });
+  output.AwaitFirstWrite();
+  for (int i = 1; i < 4; ++i) {
+    executor.Execute([&channel, i]() {
+      channel.Write(ByteArray{absl::StrCat("frame-", i)});
+    });
+  }
+  // Let the other frames queue up behind the blocked write.
+  SystemClock::Sleep(absl::Milliseconds(100));
+  release_first_write.CountDown();
+
+  std::vector<std::string> rx_messages;
+  for (int i = 0; i < 4; ++i) {
+    ExceptionOr<ByteArray> rx_message = channel.Read();
+    ASSERT_TRUE(rx_message.ok());
+    rx_messages.push_back(std::string(rx_message.result()));
+  }
+  EXPECT_THAT(rx_messages, UnorderedElementsAre("frame-0", "frame-1",
+                                                "frame-2", "frame-3"));
+  EXPECT_THAT(output.GetPartsPerWrite(), ElementsAre(2, 6));
+  FeatureFlags::GetMutableFlagsForTesting() = saved_flags;
+}
+
+TEST(BaseEndpointChannelTest, PayloadChunksAreCopiedOnceEachWay) {
+  constexpr int kChunkSize = 64 * 1024;
+  constexpr int kNumChunks = 16;
+  Pipe pipe;
+  TestEndpointChannel channel(&pipe.GetInputStream(), &pipe.GetOutputStream());
+  PayloadTransferFrame::PayloadHeader header;
+  header.set_id(1);
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_total_size(kChunkSize * kNumChunks);
+  ByteCopyCounter::Reset();
+
+  for (int i = 0; i < kNumChunks; ++i) {
+    PayloadTransferFrame::PayloadChunk chunk;
+    chunk.set_offset(i * kChunkSize);
+    chunk.set_flags(0);
+    chunk.set_body(std::string(kChunkSize, 'x'));
+    EXPECT_FALSE(
+        channel.Write(parser::ForDataPayloadTransfer(header, std::move(chunk)))
+            .Raised());
+  }
+  for (int i = 0; i < kNumChunks; ++i) {
+    ExceptionOr<ByteArray> bytes = channel.Read();
+    ASSERT_TRUE(bytes.ok());
+    ExceptionOr<OfflineFrame> frame = parser::FromBytes(bytes.result());
+    ASSERT_TRUE(frame.ok());
+    EXPECT_EQ(frame.result().v1().payload_transfer().payload_chunk().body(),
+              std::string(kChunkSize, 'x'));
+  }
+
+  // Serialized on send and parsed on receive, plus framing overhead.
+  EXPECT_LT(ByteCopyCounter::GetCopiesPerMegabyte(kChunkSize * kNumChunks),
+            2.1);
+}
+
 TEST(BaseEndpointChannelTest, NotEncryptedReadWriteCanBeIntercepted) {
   // Not encrypted IO; MITM scenario.
 
@@ -216,6 +383,13 @@ TEST(BaseEndpointChannelTest, NotEncryptedReadWriteCanBeIntercepted) {
 
   // Verify expectations.
   EXPECT_EQ(rx_message, tx_message);
+  // Each direction keeps its own sequence.
+  channel_b.Write(tx_message);
+  channel_b.Write(tx_message);
+  EXPECT_EQ(channel_a.Read().result(), tx_message);
+  EXPECT_EQ(channel_a.Read().result(), tx_message);
+  channel_a.Write(tx_message);
+  EXPECT_EQ(channel_b.Read().result(), tx_message);
   {
     absl::MutexLock lock(&mutex);
     std::string message{tx_message};
@@ -261,10 +435,10 @@ TEST(BaseEndpointChannelTest, EncryptedReadWriteCanNotBeIntercepted) {
 
   // Run DH key exchange; setup encryption contexts for channels.
   auto [context_a, context_b] = DoDhKeyExchange(&channel_a, &channel_b);
-  ASSERT_NE(context_a, nullptr);
-  ASSERT_NE(context_b, nullptr);
-  channel_a.EnableEncryption(context_a);
-  channel_b.EnableEncryption(context_b);
+  ASSERT_NE(context_a.encrypt, nullptr);
+  ASSERT_NE(context_b.encrypt, nullptr);
+  channel_a.EnableEncryption(context_a, /*cipher=*/nullptr);
+  channel_b.EnableEncryption(context_b, /*cipher=*/nullptr);
 
   EXPECT_EQ(channel_a.GetType(), "ENCRYPTED_BLUETOOTH");
   EXPECT_EQ(channel_b.GetType(), "ENCRYPTED_BLUETOOTH");
@@ -276,6 +450,13 @@ TEST(BaseEndpointChannelTest, EncryptedReadWriteCanNotBeIntercepted) {
 
   // Verify expectations.
   EXPECT_EQ(rx_message, tx_message);
+  // Each direction keeps its own sequence.
+  channel_b.Write(tx_message);
+  channel_b.Write(tx_message);
+  EXPECT_EQ(channel_a.Read().result(), tx_message);
+  EXPECT_EQ(channel_a.Read().result(), tx_message);
+  channel_a.Write(tx_message);
+  EXPECT_EQ(channel_b.Read().result(), tx_message);
   {
     absl::MutexLock lock(&mutex);
     std::string message{tx_message};
@@ -288,6 +469,131 @@ TEST(BaseEndpointChannelTest, EncryptedReadWriteCanNotBeIntercepted) {
   channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
 }
 
+TEST(BaseEndpointChannelTest, FrameCipherEncryptsBothDirections) {
+  // Setup test communication environment.
+  Pipe pipe_a;  // channel_a writes to pipe_a, reads from pipe_b.
+  Pipe pipe_b;  // channel_b writes to pipe_b, reads from pipe_a.
+  TestEndpointChannel channel_a(&pipe_b.GetInputStream(),
+                                &pipe_a.GetOutputStream());
+  TestEndpointChannel channel_b(&pipe_a.GetInputStream(),
+                                &pipe_b.GetOutputStream());
+
+  ON_CALL(channel_a, GetMedium).WillByDefault([]() {
+    return Medium::WIFI_LAN;
+  });
+  ON_CALL(channel_b, GetMedium).WillByDefault([]() {
+    return Medium::WIFI_LAN;
+  });
+
+  // Run DH key exchange; |channel_a| is the client.
+  auto [context_a, context_b] = DoDhKeyExchange(&channel_a, &channel_b);
+  ASSERT_NE(context_a.encrypt, nullptr);
+  ASSERT_NE(context_b.encrypt, nullptr);
+  std::shared_ptr<FrameCipher> cipher_a =
+      FrameCipher::Create(*context_a.encrypt, /*is_client=*/true);
+  std::shared_ptr<FrameCipher> cipher_b =
+      FrameCipher::Create(*context_b.encrypt, /*is_client=*/false);
+  channel_a.EnableEncryption(context_a, cipher_a);
+  channel_b.EnableEncryption(context_b, cipher_b);
+
+  EXPECT_EQ(channel_a.GetType(), "ENCRYPTED_WIFI_LAN");
+  EXPECT_EQ(channel_b.GetType(), "ENCRYPTED_WIFI_LAN");
+
+  // Small frames and frames large enough to be opened in place.
+  ByteArray tx_message{"data message"};
+  ByteArray large_message{std::string(64 * 1024, 'x')};
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_FALSE(channel_a.Write(tx_message).Raised());
+    EXPECT_FALSE(channel_a.Write(large_message).Raised());
+    EXPECT_EQ(channel_b.Read().result(), tx_message);
+    EXPECT_EQ(channel_b.Read().result(), large_message);
+
+    EXPECT_FALSE(channel_b.Write(large_message).Raised());
+    EXPECT_EQ(channel_a.Read().result(), large_message);
+  }
+
+  // A channel without the cipher can not read the frames.
+  TestEndpointChannel channel_c(&pipe_a.GetInputStream(),
+                                &pipe_b.GetOutputStream());
+  channel_c.EnableEncryption(context_b, /*cipher=*/nullptr);
+  EXPECT_FALSE(channel_a.Write(tx_message).Raised());
+  ExceptionOr<ByteArray> result = channel_c.Read();
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(result.exception(), Exception::kInvalidProtocolBuffer);
+
+  // Shutdown test environment.
+  channel_a.Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+}
+
+TEST(BaseEndpointChannelTest, RefusesWritesOnPriorChannelAfterLastWrite) {
+  // The prior and the upgraded channel of a make-before-break bandwidth
+  // upgrade, sharing one encryption context per side.
+  Pipe prior_pipe_a;
+  Pipe prior_pipe_b;
+  Pipe upgraded_pipe_a;
+  Pipe upgraded_pipe_b;
+  TestEndpointChannel prior_a(&prior_pipe_b.GetInputStream(),
+                              &prior_pipe_a.GetOutputStream());
+  TestEndpointChannel prior_b(&prior_pipe_a.GetInputStream(),
+                              &prior_pipe_b.GetOutputStream());
+  TestEndpointChannel upgraded_a(&upgraded_pipe_b.GetInputStream(),
+                                 &upgraded_pipe_a.GetOutputStream());
+  TestEndpointChannel upgraded_b(&upgraded_pipe_a.GetInputStream(),
+                                 &upgraded_pipe_b.GetOutputStream());
+  for (TestEndpointChannel* channel :
+       {&prior_a, &prior_b, &upgraded_a, &upgraded_b}) {
+    ON_CALL(*channel, GetMedium).WillByDefault([]() {
+      return Medium::BLUETOOTH;
+    });
+  }
+  auto [context_a, context_b] = DoDhKeyExchange(&prior_a, &prior_b);
+  ASSERT_NE(context_a.encrypt, nullptr);
+  ASSERT_NE(context_b.encrypt, nullptr);
+  prior_a.EnableEncryption(context_a, /*cipher=*/nullptr);
+  prior_b.EnableEncryption(context_b, /*cipher=*/nullptr);
+  upgraded_a.EnableEncryption(context_a, /*cipher=*/nullptr);
+  upgraded_b.EnableEncryption(context_b, /*cipher=*/nullptr);
+  ByteArray tx_message{"data message"};
+  ByteArray last_write = parser::ForBwuLastWrite(/*make_before_break=*/true);
+
+  // A writer still holding on to the prior channel keeps writing to it while
+  // the upgraded channel takes over.
+  SingleThreadExecutor late_writer;
+  CountDownLatch last_write_done(1);
+  CountDownLatch late_writes_done(1);
+  std::vector<Exception> late_results;
+  late_writer.Execute([&]() {
+    last_write_done.Await();
+    late_results.push_back(prior_a.Write(tx_message));
+    prior_a.DisableEncryption();
+    late_results.push_back(prior_a.Write(tx_message));
+    late_writes_done.CountDown();
+  });
+  EXPECT_TRUE(prior_a.Write(tx_message).Ok());
+  EXPECT_TRUE(prior_a.WriteLast(last_write).Ok());
+  last_write_done.CountDown();
+  EXPECT_TRUE(upgraded_a.Write(tx_message).Ok());
+  ASSERT_TRUE(late_writes_done.Await(absl::Seconds(5)).result());
+  EXPECT_TRUE(prior_a.WriteUnencrypted(parser::ForBwuSafeToClose()).Ok());
+
+  // The late writes fail, encrypted or not, and take no turn of the shared
+  // context: the upgraded channel is read in sequence.
+  ASSERT_EQ(late_results.size(), 2u);
+  EXPECT_EQ(late_results[0].value, Exception::kIo);
+  EXPECT_EQ(late_results[1].value, Exception::kIo);
+  EXPECT_EQ(prior_b.Read().result(), tx_message);
+  EXPECT_EQ(prior_b.Read().result(), last_write);
+  EXPECT_EQ(upgraded_b.Read().result(), tx_message);
+  prior_b.DisableEncryption();
+  EXPECT_EQ(prior_b.Read().result(), parser::ForBwuSafeToClose());
+
+  prior_a.Close(DisconnectionReason::UPGRADED);
+  prior_b.Close(DisconnectionReason::UPGRADED);
+  upgraded_a.Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  upgraded_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+}
+
 TEST(BaseEndpointChannelTest, CanBesuspendedAndResumed) {
   // Setup test communication environment.
   Pipe pipe_a;  // channel_a writes to pipe_a, reads from pipe_b.
@@ -378,9 +684,9 @@ TEST(BaseEndpointChannelTest, ReadUnencryptedFrameOnEncryptedChannel) {
   // Run DH key exchange; setup encryption contexts for channels. But only
   // encrypt |channel_b|.
   auto [context_a, context_b] = DoDhKeyExchange(&channel_a, &channel_b);
-  ASSERT_NE(context_a, nullptr);
-  ASSERT_NE(context_b, nullptr);
-  channel_b.EnableEncryption(context_b);
+  ASSERT_NE(context_a.encrypt, nullptr);
+  ASSERT_NE(context_b.encrypt, nullptr);
+  channel_b.EnableEncryption(context_b, /*cipher=*/nullptr);
 
   EXPECT_EQ(channel_a.GetType(), "BLUETOOTH");
   EXPECT_EQ(channel_b.GetType(), "ENCRYPTED_BLUETOOTH");
@@ -399,6 +705,18 @@ TEST(BaseEndpointChannelTest, ReadUnencryptedFrameOnEncryptedChannel) {
   EXPECT_FALSE(result.ok());
   EXPECT_EQ(result.exception(), Exception::kInvalidProtocolBuffer);
 
+  // The same goes for a channel encrypted with the frame cipher.
+  channel_b.EnableEncryption(
+      context_b, FrameCipher::Create(*context_b.encrypt, /*is_client=*/false));
+  channel_a.Write(keep_alive_message);
+  result = channel_b.Read();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.result(), keep_alive_message);
+  channel_a.Write(tx_message);
+  result = channel_b.Read();
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(result.exception(), Exception::kInvalidProtocolBuffer);
+
   // Shutdown test environment.
   channel_a.Close(DisconnectionReason::LOCAL_DISCONNECTION);
   channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
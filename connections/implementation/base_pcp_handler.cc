@@ -28,11 +28,17 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/escaping.h"
 #include "absl/types/span.h"
+#include "connections/implementation/analytics/stage_histograms.h"
+#include "connections/implementation/frame_cipher.h"
 #include "connections/implementation/mediums/utils.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/payload_type.h"
 #include "internal/platform/base64_utils.h"
 #include "internal/platform/bluetooth_utils.h"
+#include "internal/platform/cancellation_flag_listener.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 
 namespace location {
 namespace nearby {
@@ -40,8 +46,65 @@ namespace connections {
 
 using ::securegcm::UKey2Handshake;
 
+namespace {
+
+// The number of endpoints we set up connections with at once.
+int GetConnectionSetupConcurrency() {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  return flags.enable_concurrent_connection_setup
+             ? flags.connection_setup_concurrency
+             : 1;
+}
+
+// Owns a channel on its way from one thread to another. Closes the channel if
+// it is dropped before the channel is taken, eg. by an executor that shuts
+// down with the task that carries it still queued.
+class PendingChannel {
+ public:
+  explicit PendingChannel(std::unique_ptr<EndpointChannel> channel)
+      : channel_(std::move(channel)) {}
+  ~PendingChannel() {
+    if (channel_) channel_->Close();
+  }
+  PendingChannel(const PendingChannel&) = delete;
+  PendingChannel& operator=(const PendingChannel&) = delete;
+
+  EndpointChannel* get() const { return channel_.get(); }
+  std::unique_ptr<EndpointChannel> Take() { return std::move(channel_); }
+
+ private:
+  std::unique_ptr<EndpointChannel> channel_;
+};
+
+}  // namespace
+
 constexpr absl::Duration BasePcpHandler::kConnectionRequestReadTimeout;
 constexpr absl::Duration BasePcpHandler::kRejectedConnectionCloseDelay;
+constexpr int BasePcpHandler::kMaxParallelConnectAttempts;
+
+struct BasePcpHandler::ConnectRace {
+  explicit ConnectRace(
+      std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates)
+      : candidates(std::move(candidates)) {
+    for (size_t i = 0; i < this->candidates.size(); ++i) {
+      cancellation_flags.push_back(std::make_unique<CancellationFlag>());
+    }
+  }
+
+  const std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates;
+  // One per candidate.
+  std::vector<std::unique_ptr<CancellationFlag>> cancellation_flags;
+
+  Mutex mutex;
+  ConditionVariable attempt_done{&mutex};
+  int attempts_running ABSL_GUARDED_BY(mutex) = 0;
+  // Set once ConnectInParallel() returned; later channels are not used.
+  bool decided ABSL_GUARDED_BY(mutex) = false;
+  // The index of the attempt that connected, or -1.
+  int winner ABSL_GUARDED_BY(mutex) = -1;
+  // The result of the winner, or of the last attempt to fail.
+  ConnectImplResult result ABSL_GUARDED_BY(mutex);
+};
 
 BasePcpHandler::BasePcpHandler(Mediums* mediums,
                                EndpointManager* endpoint_manager,
@@ -50,8 +113,16 @@ BasePcpHandler::BasePcpHandler(Mediums* mediums,
     : mediums_(mediums),
       endpoint_manager_(endpoint_manager),
       channel_manager_(channel_manager),
+      connect_executor_(kMaxParallelConnectAttempts *
+                        GetConnectionSetupConcurrency()),
       pcp_(pcp),
-      bwu_manager_(bwu_manager) {}
+      bwu_manager_(bwu_manager) {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_concurrent_connection_setup) {
+    setup_executor_ = std::make_unique<MultiThreadExecutor>(
+        flags.connection_setup_concurrency);
+  }
+}
 
 BasePcpHandler::~BasePcpHandler() {
   NEARBY_LOGS(INFO) << "Initiating shutdown of BasePcpHandler("
@@ -62,6 +133,7 @@ BasePcpHandler::~BasePcpHandler() {
                     << ") is bringing down executors.";
   serial_executor_.Shutdown();
   alarm_executor_.Shutdown();
+  connect_executor_.Shutdown();
   NEARBY_LOGS(INFO) << "BasePcpHandler(" << strategy_.GetName()
                     << ") has shut down.";
 }
@@ -73,6 +145,20 @@ void BasePcpHandler::DisconnectFromEndpointManager() {
   // Unregister ourselves from EPM message dispatcher.
   endpoint_manager_->UnregisterFrameProcessor(V1Frame::CONNECTION_RESPONSE,
                                               this);
+  // Connection attempts off the PCP handler thread may still be running in
+  // ConnectImpl(); they must be done before a derived class goes away.
+  {
+    MutexLock lock(&connect_mutex_);
+    for (CancellationFlag* cancellation_flag : connect_attempts_) {
+      cancellation_flag->Cancel();
+    }
+    while (!connect_attempts_.empty()) {
+      connect_attempt_done_.Wait();
+    }
+  }
+  // With connecting cancelled, what is left of connection setup is bounded by
+  // kConnectionRequestReadTimeout.
+  if (setup_executor_ != nullptr) setup_executor_->Shutdown();
 }
 
 Status BasePcpHandler::StartAdvertising(
@@ -501,7 +587,8 @@ Status BasePcpHandler::RequestConnection(
 
         // If we already have a pending connection, then we shouldn't allow any
         // more outgoing connections to this endpoint.
-        if (pending_connections_.count(endpoint_id)) {
+        if (pending_connections_.count(endpoint_id) ||
+            connecting_endpoints_.contains(endpoint_id)) {
           NEARBY_LOGS(INFO)
               << "In requestConnection(), connection requested with "
                  "endpoint(id="
@@ -545,86 +632,45 @@ Status BasePcpHandler::RequestConnection(
         if (AppendWebRTCEndpoint(endpoint_id, client->GetDiscoveryOptions()))
           NEARBY_LOGS(INFO) << "Appended Web RTC endpoint.";
 
-        auto discovered_endpoints = GetDiscoveredEndpoints(endpoint_id);
-        std::unique_ptr<EndpointChannel> channel;
-        ConnectImplResult connect_impl_result;
-
-        for (auto connect_endpoint : discovered_endpoints) {
-          if (!MediumSupportedByClientOptions(connect_endpoint->medium,
-                                              connection_options))
-            continue;
-          connect_impl_result = ConnectImpl(client, connect_endpoint);
-          if (connect_impl_result.status.Ok()) {
-            channel = std::move(connect_impl_result.endpoint_channel);
-            break;
-          }
-        }
-
-        Medium channel_medium =
-            channel ? channel->GetMedium() : Medium::UNKNOWN_MEDIUM;
-        if (channel == nullptr) {
-          NEARBY_LOGS(INFO)
-              << "Endpoint channel not available: endpoint_id=" << endpoint_id;
-          ProcessPreConnectionInitiationFailure(
-              client, channel_medium, endpoint_id, channel.get(),
-              /* is_incoming = */ false, start_time, connect_impl_result.status,
-              result.get());
-          return;
-        }
-
-        NEARBY_LOGS(INFO)
-            << "In requestConnection(), wrote ConnectionRequestFrame "
-               "to endpoint_id="
-            << endpoint_id;
-
-        ConnectionInfo connection_info =
-            FillConnectionInfo(client, info, connection_options);
-
-        Exception write_exception =
-            WriteConnectionRequestFrame(connection_info, channel.get());
-
-        if (!write_exception.Ok()) {
-          NEARBY_LOGS(INFO) << "Failed to send connection request: endpoint_id="
-                            << endpoint_id;
-          ProcessPreConnectionInitiationFailure(
-              client, channel_medium, endpoint_id, channel.get(),
-              /* is_incoming = */ false, start_time, {Status::kEndpointIoError},
-              result.get());
+        auto candidates = GetConnectCandidates(endpoint_id, connection_options);
+        if (setup_executor_ != nullptr) {
+          // Connect on a thread of our own, and come back to the PCP handler
+          // thread with the channel.
+          connecting_endpoints_.insert(endpoint_id);
+          setup_executor_->Execute(
+              "request-connection-connect",
+              [this, client, &info, connection_options, endpoint_id, result,
+               remote_endpoint_info = endpoint->endpoint_info, start_time,
+               candidates = std::move(candidates)]() mutable {
+                ConnectImplResult connect_impl_result =
+                    ConnectOffPcpHandlerThread(client, endpoint_id,
+                                               std::move(candidates));
+                RunOnPcpHandlerThread(
+                    "request-connection-connected",
+                    [this, client, &info, connection_options, endpoint_id,
+                     result, remote_endpoint_info, start_time,
+                     medium = connect_impl_result.medium,
+                     status = connect_impl_result.status,
+                     pending = std::make_shared<PendingChannel>(std::move(
+                         connect_impl_result.endpoint_channel))]()
+                        RUN_ON_PCP_HANDLER_THREAD() {
+                          connecting_endpoints_.erase(endpoint_id);
+                          OnConnectImplDone(
+                              client, endpoint_id, info, connection_options,
+                              remote_endpoint_info, start_time, result,
+                              {.medium = medium,
+                               .status = status,
+                               .endpoint_channel = pending->Take()});
+                        });
+              });
           return;
         }
-
-        NEARBY_LOGS(INFO) << "Adding connection to pending set: endpoint_id="
-                          << endpoint_id;
-
-        // We've successfully connected to the device, and are now about to jump
-        // on to the EncryptionRunner thread to start running our encryption
-        // protocol. We'll mark ourselves as pending in case we get another call
-        // to RequestConnection or OnIncomingConnection, so that we can cancel
-        // the connection if needed.
-        // Not using designated initializers here since the VS C++ compiler
-        // errors out indicating that MediumSelector<bool> is not an aggregate
-        PendingConnectionInfo pendingConnectionInfo{};
-        pendingConnectionInfo.client = client;
-        pendingConnectionInfo.remote_endpoint_info = endpoint->endpoint_info;
-        pendingConnectionInfo.nonce = connection_info.nonce;
-        pendingConnectionInfo.is_incoming = false;
-        pendingConnectionInfo.start_time = start_time;
-        pendingConnectionInfo.listener = info.listener;
-        pendingConnectionInfo.connection_options = connection_options;
-        pendingConnectionInfo.result = result;
-        pendingConnectionInfo.channel = std::move(channel);
-
-        EndpointChannel* endpoint_channel =
-            pending_connections_
-                .emplace(endpoint_id, std::move(pendingConnectionInfo))
-                .first->second.channel.get();
-
-        NEARBY_LOGS(INFO) << "Initiating secure connection: endpoint_id="
-                          << endpoint_id;
-        // Next, we'll set up encryption. When it's done, our future will return
-        // and RequestConnection() will finish.
-        encryption_runner_.StartClient(client, endpoint_id, endpoint_channel,
-                                       GetResultListener());
+        OnConnectImplDone(
+            client, endpoint_id, info, connection_options,
+            endpoint->endpoint_info, start_time, result,
+            FeatureFlags::GetInstance().GetFlags().enable_parallel_connect
+                ? ConnectInParallel(client, endpoint_id, std::move(candidates))
+                : ConnectSequentially(client, endpoint_id, candidates));
       });
   NEARBY_LOGS(INFO) << "Waiting for connection to complete: endpoint_id="
                     << endpoint_id;
@@ -636,6 +682,264 @@ Status BasePcpHandler::RequestConnection(
   return status;
 }
 
+void BasePcpHandler::OnConnectImplDone(
+    ClientProxy* client, const std::string& endpoint_id,
+    const ConnectionRequestInfo& info,
+    const ConnectionOptions& connection_options,
+    const ByteArray& remote_endpoint_info, absl::Time start_time,
+    const std::shared_ptr<Future<Status>>& result,
+    ConnectImplResult connect_impl_result) {
+  std::unique_ptr<EndpointChannel> channel;
+  if (connect_impl_result.status.Ok()) {
+    channel = std::move(connect_impl_result.endpoint_channel);
+  }
+
+  Medium channel_medium =
+      channel ? channel->GetMedium() : Medium::UNKNOWN_MEDIUM;
+  if (channel != nullptr) {
+    analytics::StageHistograms::GetInstance().Record(
+        {analytics::StageHistograms::Stage::kConnect, channel_medium,
+         PayloadType::kUnknown, /*is_incoming=*/false},
+        SystemClock::ElapsedRealtime() - start_time);
+  }
+  if (channel == nullptr) {
+    NEARBY_LOGS(INFO) << "Endpoint channel not available: endpoint_id="
+                      << endpoint_id;
+    ProcessPreConnectionInitiationFailure(
+        client, channel_medium, endpoint_id, channel.get(),
+        /* is_incoming = */ false, start_time, connect_impl_result.status,
+        result.get());
+    return;
+  }
+
+  // While we were connecting off the PCP handler thread, the endpoint may have
+  // connected to us. We have not sent our connection request yet, so theirs
+  // wins without a tie break.
+  if (pending_connections_.count(endpoint_id)) {
+    NEARBY_LOGS(INFO) << "In requestConnection(), endpoint(id=" << endpoint_id
+                      << ") connected to us while we were connecting to them.";
+    channel->Close();
+    result->Set({Status::kAlreadyConnectedToEndpoint});
+    return;
+  }
+
+  NEARBY_LOGS(INFO) << "In requestConnection(), wrote ConnectionRequestFrame "
+                       "to endpoint_id="
+                    << endpoint_id;
+
+  ConnectionInfo connection_info =
+      FillConnectionInfo(client, info, connection_options);
+
+  Exception write_exception =
+      WriteConnectionRequestFrame(connection_info, channel.get());
+
+  if (!write_exception.Ok()) {
+    NEARBY_LOGS(INFO) << "Failed to send connection request: endpoint_id="
+                      << endpoint_id;
+    ProcessPreConnectionInitiationFailure(
+        client, channel_medium, endpoint_id, channel.get(),
+        /* is_incoming = */ false, start_time, {Status::kEndpointIoError},
+        result.get());
+    return;
+  }
+
+  NEARBY_LOGS(INFO) << "Adding connection to pending set: endpoint_id="
+                    << endpoint_id;
+
+  // We've successfully connected to the device, and are now about to jump on to
+  // the EncryptionRunner thread to start running our encryption protocol. We'll
+  // mark ourselves as pending in case we get another call to RequestConnection
+  // or OnIncomingConnection, so that we can cancel the connection if needed.
+  // Not using designated initializers here since the VS C++ compiler errors
+  // out indicating that MediumSelector<bool> is not an aggregate
+  PendingConnectionInfo pendingConnectionInfo{};
+  pendingConnectionInfo.client = client;
+  pendingConnectionInfo.remote_endpoint_info = remote_endpoint_info;
+  pendingConnectionInfo.nonce = connection_info.nonce;
+  pendingConnectionInfo.is_incoming = false;
+  pendingConnectionInfo.start_time = start_time;
+  pendingConnectionInfo.listener = info.listener;
+  pendingConnectionInfo.connection_options = connection_options;
+  pendingConnectionInfo.result = result;
+  pendingConnectionInfo.channel = std::move(channel);
+
+  EndpointChannel* endpoint_channel =
+      pending_connections_
+          .emplace(endpoint_id, std::move(pendingConnectionInfo))
+          .first->second.channel.get();
+
+  NEARBY_LOGS(INFO) << "Initiating secure connection: endpoint_id="
+                    << endpoint_id;
+  // Next, we'll set up encryption. When it's done, our future will return and
+  // RequestConnection() will finish.
+  encryption_runner_.StartClient(client, endpoint_id, endpoint_channel,
+                                 GetResultListener());
+}
+
+std::vector<std::shared_ptr<BasePcpHandler::DiscoveredEndpoint>>
+BasePcpHandler::GetConnectCandidates(
+    const std::string& endpoint_id,
+    const ConnectionOptions& connection_options) {
+  std::vector<std::shared_ptr<DiscoveredEndpoint>> result;
+  auto it = discovered_endpoints_.equal_range(endpoint_id);
+  for (auto item = it.first; item != it.second; item++) {
+    if (MediumSupportedByClientOptions(item->second->medium,
+                                       connection_options)) {
+      result.push_back(item->second);
+    }
+  }
+  std::sort(result.begin(), result.end(),
+            [this](const std::shared_ptr<DiscoveredEndpoint>& a,
+                   const std::shared_ptr<DiscoveredEndpoint>& b) -> bool {
+              return IsPreferred(*a, *b);
+            });
+  return result;
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::ConnectSequentially(
+    ClientProxy* client, const std::string& endpoint_id,
+    const std::vector<std::shared_ptr<DiscoveredEndpoint>>& candidates) {
+  ConnectImplResult result;
+  for (const auto& candidate : candidates) {
+    result = ConnectImpl(client, candidate.get(),
+                         client->GetCancellationFlag(endpoint_id));
+    if (result.status.Ok()) break;
+  }
+  return result;
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::ConnectInParallel(
+    ClientProxy* client, const std::string& endpoint_id,
+    std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates) {
+  // The attempts that lose the race can only be stopped through their
+  // cancellation flags, which do nothing unless enabled. Without them, losing
+  // attempts would hold the connect threads until their mediums time out.
+  if (candidates.size() < 2 ||
+      !FeatureFlags::GetInstance().GetFlags().enable_cancellation_flag) {
+    return ConnectSequentially(client, endpoint_id, candidates);
+  }
+  auto race = std::make_shared<ConnectRace>(std::move(candidates));
+  const int num_attempts = race->candidates.size();
+
+  // Cancelling the connection request cancels every attempt.
+  CancellationFlag* request_flag = client->GetCancellationFlag(endpoint_id);
+  CancellationFlagListener request_listener(request_flag, [race]() {
+    for (auto& cancellation_flag : race->cancellation_flags) {
+      cancellation_flag->Cancel();
+    }
+  });
+  if (request_flag->Cancelled()) {
+    for (auto& cancellation_flag : race->cancellation_flags) {
+      cancellation_flag->Cancel();
+    }
+  }
+
+  const absl::Duration stagger =
+      FeatureFlags::GetInstance().GetFlags().parallel_connect_stagger;
+  int winner = -1;
+  ConnectImplResult result;
+  {
+    MutexLock lock(&race->mutex);
+    for (int i = 0; i < num_attempts && race->winner < 0; ++i) {
+      if (i > 0) {
+        // Give the attempts in flight a head start, unless they all failed.
+        absl::Time deadline = SystemClock::ElapsedRealtime() + stagger;
+        while (race->winner < 0 && race->attempts_running > 0) {
+          absl::Duration left = deadline - SystemClock::ElapsedRealtime();
+          if (left <= absl::ZeroDuration()) break;
+          race->attempt_done.Wait(left);
+        }
+        if (race->winner >= 0) break;
+      }
+      NEARBY_LOGS(INFO) << "Starting connection attempt over "
+                        << proto::connections::Medium_Name(
+                               race->candidates[i]->medium)
+                        << " to endpoint_id=" << endpoint_id;
+      ++race->attempts_running;
+      connect_executor_.Execute(
+          "connect-attempt", [this, client, race, i]() {
+            RunConnectAttempt(client, race, i);
+          });
+    }
+    while (race->winner < 0 && race->attempts_running > 0) {
+      race->attempt_done.Wait();
+    }
+    race->decided = true;
+    winner = race->winner;
+    result = std::move(race->result);
+  }
+
+  for (int i = 0; i < num_attempts; ++i) {
+    if (i != winner) race->cancellation_flags[i]->Cancel();
+  }
+  return result;
+}
+
+void BasePcpHandler::RunConnectAttempt(ClientProxy* client,
+                                       std::shared_ptr<ConnectRace> race,
+                                       int index) {
+  ConnectImplResult result =
+      RunConnectImpl(client, race->candidates[index].get(),
+                     race->cancellation_flags[index].get());
+
+  MutexLock lock(&race->mutex);
+  --race->attempts_running;
+  if (result.status.Ok() && result.endpoint_channel != nullptr) {
+    if (race->decided || race->winner >= 0) {
+      NEARBY_LOGS(INFO) << "Closing the channel of a connection attempt over "
+                        << proto::connections::Medium_Name(result.medium)
+                        << " that lost the race.";
+      result.endpoint_channel->Close();
+    } else {
+      race->winner = index;
+      race->result = std::move(result);
+    }
+  } else if (race->winner < 0) {
+    race->result = std::move(result);
+  }
+  race->attempt_done.Notify();
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::RunConnectImpl(
+    ClientProxy* client, DiscoveredEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
+  {
+    MutexLock lock(&connect_mutex_);
+    if (stop_.Get()) return {};
+    connect_attempts_.insert(cancellation_flag);
+  }
+  ConnectImplResult result = ConnectImpl(client, endpoint, cancellation_flag);
+  MutexLock lock(&connect_mutex_);
+  connect_attempts_.erase(cancellation_flag);
+  connect_attempt_done_.Notify();
+  return result;
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::ConnectOffPcpHandlerThread(
+    ClientProxy* client, const std::string& endpoint_id,
+    std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates) {
+  // Racing needs enable_cancellation_flag, see ConnectInParallel().
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_parallel_connect && flags.enable_cancellation_flag &&
+      candidates.size() > 1) {
+    return ConnectInParallel(client, endpoint_id, std::move(candidates));
+  }
+  // Same as ConnectSequentially(), but with a flag of our own, so that we can
+  // be cancelled when stopping.
+  CancellationFlag cancellation_flag;
+  CancellationFlag* request_flag = client->GetCancellationFlag(endpoint_id);
+  CancellationFlagListener request_listener(
+      request_flag, [&cancellation_flag]() { cancellation_flag.Cancel(); });
+  if (request_flag->Cancelled()) cancellation_flag.Cancel();
+
+  ConnectImplResult result;
+  for (const auto& candidate : candidates) {
+    result = RunConnectImpl(client, candidate.get(), &cancellation_flag);
+    if (result.status.Ok()) break;
+  }
+  return result;
+}
+
 bool BasePcpHandler::MediumSupportedByClientOptions(
     const proto::connections::Medium& medium,
     const ConnectionOptions& connection_options) const {
@@ -708,6 +1012,9 @@ mediums::WebrtcPeerId BasePcpHandler::CreatePeerIdFromAdvertisement(
 }
 
 bool BasePcpHandler::HasOutgoingConnections(ClientProxy* client) const {
+  if (!connecting_endpoints_.empty()) {
+    return true;
+  }
   for (const auto& item : pending_connections_) {
     auto& connection = item.second;
     if (!connection.is_incoming) {
@@ -822,8 +1129,16 @@ Status BasePcpHandler::AcceptConnection(
           return;
         }
 
+        const auto& flags = FeatureFlags::GetInstance().GetFlags();
+        bool supports_aead_frame_cipher = flags.enable_aead_frame_cipher;
+        bool supports_payload_compression = flags.enable_payload_compression;
+        bool supports_delta_transfer = flags.enable_delta_transfer;
+        // Chunked BYTES payloads are reassembled regardless of the flags.
         Exception write_exception =
-            channel->Write(parser::ForConnectionResponse(Status::kSuccess));
+            channel->Write(parser::ForConnectionResponse(
+                Status::kSuccess, supports_aead_frame_cipher,
+                supports_payload_compression, supports_delta_transfer,
+                /*supports_chunked_bytes_payloads=*/true));
         if (!write_exception.Ok()) {
           NEARBY_LOGS(INFO)
               << "AcceptConnection: failed to send response: endpoint_id="
@@ -835,6 +1150,11 @@ Status BasePcpHandler::AcceptConnection(
 
         NEARBY_LOGS(INFO) << "AcceptConnection: accepting locally: endpoint_id="
                           << endpoint_id;
+        connection_info.local_supports_aead_frame_cipher =
+            supports_aead_frame_cipher;
+        connection_info.local_supports_payload_compression =
+            supports_payload_compression;
+        connection_info.local_supports_delta_transfer = supports_delta_transfer;
         connection_info.LocalEndpointAcceptedConnection(endpoint_id,
                                                         payload_listener);
         EvaluateConnectionResult(client, endpoint_id,
@@ -879,8 +1199,10 @@ Status BasePcpHandler::RejectConnection(ClientProxy* client,
           return;
         }
 
-        Exception write_exception = channel->Write(
-            parser::ForConnectionResponse(Status::kConnectionRejected));
+        Exception write_exception =
+            channel->Write(parser::ForConnectionResponse(
+                Status::kConnectionRejected,
+                /*supports_aead_frame_cipher=*/false));
         if (!write_exception.Ok()) {
           NEARBY_LOGS(INFO)
               << "RejectConnection: failed to send response: endpoint_id="
@@ -939,6 +1261,17 @@ void BasePcpHandler::OnIncomingFrame(OfflineFrame& frame,
               << "OnConnectionResponse: remote accepted; endpoint_id="
               << endpoint_id;
           client->RemoteEndpointAcceptedConnection(endpoint_id);
+          auto it = pending_connections_.find(endpoint_id);
+          if (it != pending_connections_.end()) {
+            it->second.remote_supports_aead_frame_cipher =
+                connection_response.supports_aead_frame_cipher();
+            it->second.remote_supports_payload_compression =
+                connection_response.supports_payload_compression();
+            it->second.remote_supports_delta_transfer =
+                connection_response.supports_delta_transfer();
+            it->second.remote_supports_chunked_bytes_payloads =
+                connection_response.supports_chunked_bytes_payloads();
+          }
         } else {
           NEARBY_LOGS(INFO)
               << "OnConnectionResponse: remote rejected; endpoint_id="
@@ -1108,10 +1441,50 @@ Exception BasePcpHandler::OnIncomingConnection(
     return {Exception::kIo};
   }
 
+  if (setup_executor_ != nullptr) {
+    // Wait for the connection request on a thread of our own, and come back to
+    // the PCP handler thread with it.
+    // Runnables are copyable, so the channel goes along in a shared holder.
+    setup_executor_->Execute(
+        "incoming-connection-read",
+        [this, client, remote_endpoint_info, medium, start_time,
+         pending = std::make_shared<PendingChannel>(std::move(channel))]() {
+          ExceptionOr<OfflineFrame> wrapped_frame =
+              ReadConnectionRequestFrame(pending->get());
+          RunOnPcpHandlerThread(
+              "incoming-connection-read-done",
+              [this, client, remote_endpoint_info, medium, start_time,
+               pending, wrapped_frame]() RUN_ON_PCP_HANDLER_THREAD() {
+                std::unique_ptr<EndpointChannel> channel = pending->Take();
+                if (!client->IsAdvertising()) {
+                  NEARBY_LOGS(WARNING)
+                      << "Ignoring incoming connection on medium "
+                      << proto::connections::Medium_Name(medium)
+                      << " because client=" << client->GetClientId()
+                      << " stopped advertising while we read its request.";
+                  channel->Close();
+                  return;
+                }
+                OnConnectionRequestRead(client, remote_endpoint_info,
+                                        std::move(channel), medium, start_time,
+                                        wrapped_frame);
+              });
+        });
+    return {Exception::kSuccess};
+  }
+
   // Endpoints connecting to us will always tell us about themselves first.
   ExceptionOr<OfflineFrame> wrapped_frame =
       ReadConnectionRequestFrame(channel.get());
+  return OnConnectionRequestRead(client, remote_endpoint_info,
+                                 std::move(channel), medium, start_time,
+                                 std::move(wrapped_frame));
+}
 
+Exception BasePcpHandler::OnConnectionRequestRead(
+    ClientProxy* client, const ByteArray& remote_endpoint_info,
+    std::unique_ptr<EndpointChannel> channel, proto::connections::Medium medium,
+    absl::Time start_time, ExceptionOr<OfflineFrame> wrapped_frame) {
   if (!wrapped_frame.ok()) {
     if (wrapped_frame.exception()) {
       NEARBY_LOGS(ERROR)
@@ -1417,8 +1790,20 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
     CHECK(context);  // there is no way how this can fail, if Verify succeeded.
     // If it did, it's a UKEY2 protocol bug.
 
-    if (!channel_manager_->EncryptChannelForEndpoint(endpoint_id,
-                                                     std::move(context))) {
+    // Both sides make the same choice here: each one uses the frame cipher
+    // if, and only if, both connection responses said they support it.
+    std::unique_ptr<FrameCipher> cipher;
+    if (connection_info.local_supports_aead_frame_cipher &&
+        connection_info.remote_supports_aead_frame_cipher) {
+      cipher = FrameCipher::Create(*context,
+                                   /*is_client=*/!connection_info.is_incoming);
+      CHECK(cipher);  // The session of a verified handshake is never empty.
+      NEARBY_LOGS(INFO) << "Encrypting with AEAD frame cipher; endpoint_id="
+                        << endpoint_id;
+    }
+
+    if (!channel_manager_->EncryptChannelForEndpoint(
+            endpoint_id, std::move(context), std::move(cipher))) {
       response_code = {Status::kEndpointUnknown};
     }
   } else {
@@ -1453,6 +1838,18 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
       channel_manager_->GetChannelForEndpoint(endpoint_id)->GetMedium(),
       connection_info.connection_token);
 
+  if (connection_info.local_supports_payload_compression &&
+      connection_info.remote_supports_payload_compression) {
+    client->EnablePayloadCompression(endpoint_id);
+  }
+  if (connection_info.local_supports_delta_transfer &&
+      connection_info.remote_supports_delta_transfer) {
+    client->EnableDeltaTransfer(endpoint_id);
+  }
+  if (connection_info.remote_supports_chunked_bytes_payloads) {
+    client->EnableChunkedBytesPayloads(endpoint_id);
+  }
+
   // Invoke the client callback to let it know of the connection result.
   client->OnConnectionAccepted(endpoint_id);
 
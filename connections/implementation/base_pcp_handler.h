@@ -24,6 +24,7 @@
 #include "securegcm/ukey2_handshake.h"
 #include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
 #include "connections/implementation/bwu_manager.h"
 #include "connections/implementation/client_proxy.h"
@@ -42,8 +43,12 @@
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/condition_variable.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/future.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/prng.h"
 #include "internal/platform/scheduled_executor.h"
 #include "internal/platform/single_thread_executor.h"
@@ -283,9 +288,12 @@ class BasePcpHandler : public PcpHandler,
                                     const OutOfBandConnectionMetadata& metadata)
       RUN_ON_PCP_HANDLER_THREAD() = 0;
 
-  virtual ConnectImplResult ConnectImpl(ClientProxy* client,
-                                        DiscoveredEndpoint* endpoint)
-      RUN_ON_PCP_HANDLER_THREAD() = 0;
+  // Connects to |endpoint| over its medium, giving up once |cancellation_flag|
+  // is cancelled. May run off the PCP handler thread, concurrently with the
+  // attempts on the other mediums of the endpoint.
+  virtual ConnectImplResult ConnectImpl(
+      ClientProxy* client, DiscoveredEndpoint* endpoint,
+      CancellationFlag* cancellation_flag) = 0;
 
   virtual std::vector<proto::connections::Medium>
   GetConnectionMediumsByPriority() = 0;
@@ -365,6 +373,20 @@ class BasePcpHandler : public PcpHandler,
     // switching to connected state, where Payload may be exchanged.
     std::unique_ptr<securegcm::UKey2Handshake> ukey2;
 
+    // Whether we and the remote endpoint told each other, in our connection
+    // responses, that we support the AEAD frame cipher.
+    bool local_supports_aead_frame_cipher = false;
+    bool remote_supports_aead_frame_cipher = false;
+    // Likewise, whether we support decompressing payload chunks.
+    bool local_supports_payload_compression = false;
+    bool remote_supports_payload_compression = false;
+    // Likewise, whether we support decoding FILE payloads sent as deltas.
+    bool local_supports_delta_transfer = false;
+    bool remote_supports_delta_transfer = false;
+    // Whether the remote endpoint reassembles chunked BYTES payloads; we
+    // always do.
+    bool remote_supports_chunked_bytes_payloads = false;
+
     // Used in AnalyticsRecorder for devices connection tracking.
     std::string connection_token;
   };
@@ -397,6 +419,8 @@ class BasePcpHandler : public PcpHandler,
   static constexpr absl::Duration kRejectedConnectionCloseDelay =
       absl::Seconds(2);
   static constexpr int kConnectionTokenLength = 8;
+  // Bluetooth, BLE, WiFi LAN and WebRTC.
+  static constexpr int kMaxParallelConnectAttempts = 4;
 
   // Returns true if the new endpoint is preferred over the old endpoint.
   bool IsPreferred(const BasePcpHandler::DiscoveredEndpoint& new_endpoint,
@@ -507,8 +531,85 @@ class BasePcpHandler : public PcpHandler,
   void OptionsAllowed(const BooleanMediumSelector& allowed,
                       std::ostringstream& result) const;
 
+  // The attempts of one ConnectInParallel() call.
+  struct ConnectRace;
+
+  // Returns the discovered endpoints for |endpoint_id| that the client allows
+  // to connect over, in order of decreasing preference.
+  std::vector<std::shared_ptr<DiscoveredEndpoint>> GetConnectCandidates(
+      const std::string& endpoint_id,
+      const ConnectionOptions& connection_options) RUN_ON_PCP_HANDLER_THREAD();
+
+  // Tries |candidates| one after the other, until one of them connects.
+  ConnectImplResult ConnectSequentially(
+      ClientProxy* client, const std::string& endpoint_id,
+      const std::vector<std::shared_ptr<DiscoveredEndpoint>>& candidates);
+
+  // Tries |candidates| on |connect_executor_|, starting them in order, one
+  // every parallel_connect_stagger, or as soon as all attempts started so far
+  // have failed. Returns the result of the first one to connect (or of the
+  // last to fail), and cancels the others; a channel they still manage to set
+  // up is closed.
+  ConnectImplResult ConnectInParallel(
+      ClientProxy* client, const std::string& endpoint_id,
+      std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates);
+
+  // Runs the |index|th attempt of |race|.
+  void RunConnectAttempt(ClientProxy* client, std::shared_ptr<ConnectRace> race,
+                         int index) ABSL_LOCKS_EXCLUDED(connect_mutex_);
+
+  // Calls ConnectImpl() off the PCP handler thread, unless we are stopping.
+  // DisconnectFromEndpointManager() cancels |cancellation_flag| and waits for
+  // the call to return.
+  ConnectImplResult RunConnectImpl(ClientProxy* client,
+                                   DiscoveredEndpoint* endpoint,
+                                   CancellationFlag* cancellation_flag)
+      ABSL_LOCKS_EXCLUDED(connect_mutex_);
+
+  // Connects to one of |candidates| on |setup_executor_|, like
+  // RequestConnection() does on the PCP handler thread otherwise.
+  ConnectImplResult ConnectOffPcpHandlerThread(
+      ClientProxy* client, const std::string& endpoint_id,
+      std::vector<std::shared_ptr<DiscoveredEndpoint>> candidates);
+
+  // The rest of RequestConnection(), once a channel to |endpoint_id| has been
+  // set up (or not): sends the connection request and starts UKEY2.
+  void OnConnectImplDone(ClientProxy* client, const std::string& endpoint_id,
+                         const ConnectionRequestInfo& info,
+                         const ConnectionOptions& connection_options,
+                         const ByteArray& remote_endpoint_info,
+                         absl::Time start_time,
+                         const std::shared_ptr<Future<Status>>& result,
+                         ConnectImplResult connect_impl_result)
+      RUN_ON_PCP_HANDLER_THREAD();
+
+  // The rest of OnIncomingConnection(), once the connection request has been
+  // read from |channel| (or not).
+  Exception OnConnectionRequestRead(ClientProxy* client,
+                                    const ByteArray& remote_endpoint_info,
+                                    std::unique_ptr<EndpointChannel> channel,
+                                    proto::connections::Medium medium,
+                                    absl::Time start_time,
+                                    ExceptionOr<OfflineFrame> wrapped_frame)
+      RUN_ON_PCP_HANDLER_THREAD();
+
   ScheduledExecutor alarm_executor_;
   SingleThreadExecutor serial_executor_;
+  // Runs the attempts of ConnectInParallel(); an attempt that lost the race
+  // keeps its thread until its medium gives up.
+  MultiThreadExecutor connect_executor_;
+  Mutex connect_mutex_;
+  ConditionVariable connect_attempt_done_{&connect_mutex_};
+  // The cancellation flags of the ConnectImpl() calls running off the PCP
+  // handler thread.
+  absl::flat_hash_set<CancellationFlag*> connect_attempts_
+      ABSL_GUARDED_BY(connect_mutex_);
+  // Connects and reads connection requests, one endpoint per thread, if
+  // FeatureFlags::enable_concurrent_connection_setup is set.
+  std::unique_ptr<MultiThreadExecutor> setup_executor_;
+  // The endpoints RequestConnection() is connecting to on |setup_executor_|.
+  // They are not in |pending_connections_| yet.
+  absl::flat_hash_set<std::string> connecting_endpoints_;
 
   // A map of endpoint id -> PendingConnectionInfo. Entries in this map imply
   // that there is an active connection to the endpoint and we're waiting for
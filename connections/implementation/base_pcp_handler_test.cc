@@ -17,12 +17,16 @@
 #include <array>
 #include <atomic>
 #include <memory>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "connections/implementation/analytics/stage_histograms.h"
 #include "connections/implementation/base_endpoint_channel.h"
 #include "connections/implementation/bwu_manager.h"
 #include "connections/implementation/client_proxy.h"
@@ -30,11 +34,19 @@
 #include "connections/implementation/offline_frames.h"
 #include "connections/listeners.h"
 #include "connections/params.h"
+#include "connections/payload_type.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/cancellation_flag_listener.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/medium_environment.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
 #include "internal/platform/pipe.h"
+#include "internal/platform/system_clock.h"
 #include "proto/connections_enums.pb.h"
 
 namespace location {
@@ -45,6 +57,7 @@ namespace {
 using ::location::nearby::proto::connections::Medium;
 using ::testing::_;
 using ::testing::AtLeast;
+using ::testing::ElementsAre;
 using ::testing::Invoke;
 using ::testing::MockFunction;
 using ::testing::Return;
@@ -156,7 +169,9 @@ class MockPcpHandler : public BasePcpHandler {
                const OutOfBandConnectionMetadata& metadata),
               (override));
   MOCK_METHOD(ConnectImplResult, ConnectImpl,
-              (ClientProxy * client, DiscoveredEndpoint* endpoint), (override));
+              (ClientProxy * client, DiscoveredEndpoint* endpoint,
+               CancellationFlag* cancellation_flag),
+              (override));
   MOCK_METHOD(proto::connections::Medium, GetDefaultUpgradeMedium, (),
               (override));
 
@@ -369,16 +384,20 @@ class BasePcpHandlerTest
     auto encryption_runner = std::make_unique<EncryptionRunner>();
     auto allowed_mediums = pcp_handler->GetDiscoveryMediums(client);
 
-    EXPECT_CALL(*pcp_handler, ConnectImpl)
-        .WillOnce(Invoke([&channel_a, connect_medium](
-                             ClientProxy* client,
-                             MockPcpHandler::DiscoveredEndpoint* endpoint) {
-          return MockPcpHandler::ConnectImplResult{
-              .medium = connect_medium,
-              .status = {Status::kSuccess},
-              .endpoint_channel = std::move(channel_a),
-          };
-        }));
+    // Without |channel_a|, the caller is expected to set up ConnectImpl().
+    if (channel_a != nullptr) {
+      EXPECT_CALL(*pcp_handler, ConnectImpl)
+          .WillOnce(Invoke([&channel_a, connect_medium](
+                               ClientProxy* client,
+                               MockPcpHandler::DiscoveredEndpoint* endpoint,
+                               CancellationFlag* cancellation_flag) {
+            return MockPcpHandler::ConnectImplResult{
+                .medium = connect_medium,
+                .status = {Status::kSuccess},
+                .endpoint_channel = std::move(channel_a),
+            };
+          }));
+    }
 
     for (const auto& discovered_medium : allowed_mediums) {
       pcp_handler->OnEndpointFound(
@@ -646,7 +665,8 @@ TEST_P(BasePcpHandlerTest, OnIncomingFrameChangesState) {
             Status{Status::kSuccess});
   NEARBY_LOG(INFO, "Simulating remote accept: id=%s", endpoint_id.c_str());
   auto frame =
-      parser::FromBytes(parser::ForConnectionResponse(Status::kSuccess));
+      parser::FromBytes(parser::ForConnectionResponse(
+          Status::kSuccess, /*supports_aead_frame_cipher=*/false));
   pcp_handler.OnIncomingFrame(frame.result(), endpoint_id, &client,
                               connect_medium, packet_meta_data);
   NEARBY_LOGS(INFO) << "Closing connection: id=" << endpoint_id;
@@ -807,6 +827,300 @@ TEST_F(BasePcpHandlerTest, InjectEndpoint) {
   env_.Stop();
 }
 
+TEST_F(BasePcpHandlerTest, ParallelConnectCancelsSlowerMediums) {
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_cancellation_flag = true;
+  feature_flags.enable_parallel_connect = true;
+  feature_flags.parallel_connect_stagger = absl::Milliseconds(50);
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  analytics::StageHistograms::GetInstance().ResetForTesting();
+  std::string endpoint_id{"1234"};
+  ClientProxy client;
+  client.AddCancellationFlag(endpoint_id);
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  StartDiscovery(&client, &pcp_handler,
+                 BooleanMediumSelector{.bluetooth = true, .wifi_lan = true});
+  auto channel_pair = SetupConnection(pipe_a_, pipe_b_, Medium::BLUETOOTH);
+  auto& channel_a = channel_pair.first;
+  auto& channel_b = channel_pair.second;
+  EXPECT_CALL(*channel_a, CloseImpl).Times(1);
+  EXPECT_CALL(*channel_b, CloseImpl).Times(1);
+  EXPECT_CALL(mock_connection_listener_.rejected_cb, Call).Times(AtLeast(0));
+  // WiFi LAN is preferred, but never connects; Bluetooth does.
+  CountDownLatch wifi_lan_cancelled(1);
+  EXPECT_CALL(pcp_handler, ConnectImpl)
+      .Times(2)
+      .WillRepeatedly(Invoke([&](ClientProxy* client,
+                                 MockPcpHandler::DiscoveredEndpoint* endpoint,
+                                 CancellationFlag* cancellation_flag) {
+        if (endpoint->medium == Medium::WIFI_LAN) {
+          CountDownLatch cancelled(1);
+          CancellationFlagListener listener(
+              cancellation_flag, [&cancelled]() { cancelled.CountDown(); });
+          if (cancellation_flag->Cancelled() ||
+              cancelled.Await(absl::Seconds(10)).result()) {
+            wifi_lan_cancelled.CountDown();
+          }
+          return MockPcpHandler::ConnectImplResult{
+              .status = {Status::kWifiLanError},
+          };
+        }
+        return MockPcpHandler::ConnectImplResult{
+            .medium = Medium::BLUETOOTH,
+            .status = {Status::kSuccess},
+            .endpoint_channel = std::move(channel_a),
+        };
+      }));
+
+  RequestConnection(endpoint_id, nullptr, channel_b.get(), &client,
+                    &pcp_handler, Medium::BLUETOOTH);
+
+  EXPECT_TRUE(wifi_lan_cancelled.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(analytics::StageHistograms::GetInstance()
+                .GetSnapshot({analytics::StageHistograms::Stage::kConnect,
+                              Medium::BLUETOOTH, PayloadType::kUnknown, false})
+                .count,
+            1);
+  channel_b->Close();
+  bwu.Shutdown();
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+}
+
+TEST_F(BasePcpHandlerTest, ParallelConnectMovesOnOnceAttemptsFail) {
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_cancellation_flag = true;
+  feature_flags.enable_parallel_connect = true;
+  feature_flags.parallel_connect_stagger = absl::Seconds(10);
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  std::string endpoint_id{"1234"};
+  ClientProxy client;
+  client.AddCancellationFlag(endpoint_id);
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  StartDiscovery(&client, &pcp_handler,
+                 BooleanMediumSelector{.bluetooth = true, .wifi_lan = true});
+  auto channel_pair = SetupConnection(pipe_a_, pipe_b_, Medium::BLUETOOTH);
+  auto& channel_a = channel_pair.first;
+  auto& channel_b = channel_pair.second;
+  EXPECT_CALL(*channel_a, CloseImpl).Times(1);
+  EXPECT_CALL(*channel_b, CloseImpl).Times(1);
+  EXPECT_CALL(mock_connection_listener_.rejected_cb, Call).Times(AtLeast(0));
+  EXPECT_CALL(pcp_handler, ConnectImpl)
+      .Times(2)
+      .WillRepeatedly(Invoke([&](ClientProxy* client,
+                                 MockPcpHandler::DiscoveredEndpoint* endpoint,
+                                 CancellationFlag* cancellation_flag) {
+        if (endpoint->medium == Medium::WIFI_LAN) {
+          return MockPcpHandler::ConnectImplResult{
+              .status = {Status::kWifiLanError},
+          };
+        }
+        return MockPcpHandler::ConnectImplResult{
+            .medium = Medium::BLUETOOTH,
+            .status = {Status::kSuccess},
+            .endpoint_channel = std::move(channel_a),
+        };
+      }));
+
+  // Bluetooth is tried as soon as WiFi LAN failed, not after the stagger.
+  absl::Time start = SystemClock::ElapsedRealtime();
+  RequestConnection(endpoint_id, nullptr, channel_b.get(), &client,
+                    &pcp_handler, Medium::BLUETOOTH);
+  EXPECT_LT(SystemClock::ElapsedRealtime() - start, absl::Seconds(5));
+
+  channel_b->Close();
+  bwu.Shutdown();
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+}
+
+TEST_F(BasePcpHandlerTest, ParallelConnectIsSequentialWithoutCancellation) {
+  // enable_cancellation_flag is left off, so losing attempts could not be
+  // stopped: the mediums must be tried one at a time.
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_parallel_connect = true;
+  feature_flags.parallel_connect_stagger = absl::Milliseconds(10);
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  std::string endpoint_id{"1234"};
+  ClientProxy client;
+  client.AddCancellationFlag(endpoint_id);
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  StartDiscovery(&client, &pcp_handler,
+                 BooleanMediumSelector{.bluetooth = true, .wifi_lan = true});
+  auto channel_pair = SetupConnection(pipe_a_, pipe_b_, Medium::BLUETOOTH);
+  auto& channel_a = channel_pair.first;
+  auto& channel_b = channel_pair.second;
+  EXPECT_CALL(*channel_a, CloseImpl).Times(1);
+  EXPECT_CALL(*channel_b, CloseImpl).Times(1);
+  EXPECT_CALL(mock_connection_listener_.rejected_cb, Call).Times(AtLeast(0));
+  std::atomic_int attempts_running = 0;
+  std::atomic_bool overlapped = false;
+  std::vector<Medium> attempts;
+  EXPECT_CALL(pcp_handler, ConnectImpl)
+      .Times(2)
+      .WillRepeatedly(Invoke([&](ClientProxy* client,
+                                 MockPcpHandler::DiscoveredEndpoint* endpoint,
+                                 CancellationFlag* cancellation_flag) {
+        if (attempts_running++ > 0) overlapped = true;
+        attempts.push_back(endpoint->medium);
+        MockPcpHandler::ConnectImplResult result;
+        if (endpoint->medium == Medium::WIFI_LAN) {
+          // Slower than the stagger.
+          SystemClock::Sleep(absl::Milliseconds(200));
+          result.status = {Status::kWifiLanError};
+        } else {
+          result.medium = Medium::BLUETOOTH;
+          result.status = {Status::kSuccess};
+          result.endpoint_channel = std::move(channel_a);
+        }
+        attempts_running--;
+        return result;
+      }));
+
+  RequestConnection(endpoint_id, nullptr, channel_b.get(), &client,
+                    &pcp_handler, Medium::BLUETOOTH);
+
+  EXPECT_FALSE(overlapped);
+  EXPECT_THAT(attempts, ElementsAre(Medium::WIFI_LAN, Medium::BLUETOOTH));
+  channel_b->Close();
+  bwu.Shutdown();
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+}
+
+TEST_F(BasePcpHandlerTest, ConcurrentConnectionSetupStress) {
+  constexpr int kNumPeers = 10;
+  // How long a connect waits for the others to start. Set up one after the
+  // other, each connect waits this long, in vain.
+  constexpr absl::Duration kOverlapTimeout = absl::Seconds(2);
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_concurrent_connection_setup = true;
+  feature_flags.connection_setup_concurrency = kNumPeers;
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  ClientProxy client;
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  StartDiscovery(&client, &pcp_handler,
+                 BooleanMediumSelector{.bluetooth = true});
+  ConnectionRequestInfo info{
+      .endpoint_info = ByteArray{"ABCD"},
+      .listener = connection_listener_,
+  };
+  ConnectionOptions connection_options{
+      .keep_alive_interval_millis =
+          FeatureFlags::GetInstance().GetFlags().keep_alive_interval_millis,
+      .keep_alive_timeout_millis =
+          FeatureFlags::GetInstance().GetFlags().keep_alive_timeout_millis,
+  };
+  EXPECT_CALL(mock_discovery_listener_.endpoint_found_cb, Call)
+      .Times(kNumPeers);
+  EXPECT_CALL(mock_connection_listener_.initiated_cb, Call).Times(kNumPeers);
+  EXPECT_CALL(pcp_handler, CanSendOutgoingConnection)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(pcp_handler, GetStrategy)
+      .WillRepeatedly(Return(Strategy::kP2pCluster));
+
+  // Each peer runs UKEY2 on its end of a pair of channels.
+  ClientProxy remote_client;
+  EncryptionRunner remote_encryption_runner;
+  std::vector<std::unique_ptr<Pipe>> pipes;
+  std::vector<std::unique_ptr<MockEndpointChannel>> remote_channels;
+  Mutex mutex;
+  absl::flat_hash_map<std::string, std::unique_ptr<MockEndpointChannel>>
+      local_channels;
+  std::vector<std::string> endpoint_ids;
+  for (int i = 0; i < kNumPeers; ++i) {
+    std::string endpoint_id = absl::StrCat("PEER", i);
+    pipes.push_back(std::make_unique<Pipe>());
+    pipes.push_back(std::make_unique<Pipe>());
+    auto channel_pair = SetupConnection(*pipes[2 * i], *pipes[2 * i + 1],
+                                        Medium::BLUETOOTH);
+    EXPECT_CALL(*channel_pair.first, CloseImpl).Times(AtLeast(0));
+    EXPECT_CALL(*channel_pair.second, CloseImpl).Times(AtLeast(0));
+    pcp_handler.OnEndpointFound(
+        &client,
+        std::make_shared<MockDiscoveredEndpoint>(MockDiscoveredEndpoint{
+            {
+                endpoint_id,
+                info.endpoint_info,
+                "service",
+                Medium::BLUETOOTH,
+                WebRtcState::kUndefined,
+            },
+            MockContext{},
+        }));
+    remote_encryption_runner.StartServer(&remote_client, endpoint_id,
+                                         channel_pair.second.get(), {});
+    local_channels[endpoint_id] = std::move(channel_pair.first);
+    remote_channels.push_back(std::move(channel_pair.second));
+    endpoint_ids.push_back(endpoint_id);
+  }
+  // Every connect stays in progress until all of them are.
+  CountDownLatch all_connecting(kNumPeers);
+  std::atomic_int overlapping_connects = 0;
+  EXPECT_CALL(pcp_handler, ConnectImpl)
+      .Times(kNumPeers)
+      .WillRepeatedly(Invoke([&](ClientProxy* client,
+                                 MockPcpHandler::DiscoveredEndpoint* endpoint,
+                                 CancellationFlag* cancellation_flag) {
+        all_connecting.CountDown();
+        if (all_connecting.Await(kOverlapTimeout).result()) {
+          ++overlapping_connects;
+        }
+        MutexLock lock(&mutex);
+        return MockPcpHandler::ConnectImplResult{
+            .medium = Medium::BLUETOOTH,
+            .status = {Status::kSuccess},
+            .endpoint_channel =
+                std::move(local_channels[endpoint->endpoint_id]),
+        };
+      }));
+
+  MultiThreadExecutor requesters(kNumPeers);
+  CountDownLatch all_connected(kNumPeers);
+  for (const std::string& endpoint_id : endpoint_ids) {
+    requesters.Execute([&, endpoint_id]() {
+      EXPECT_EQ(pcp_handler.RequestConnection(&client, endpoint_id, info,
+                                              connection_options),
+                Status{Status::kSuccess});
+      all_connected.CountDown();
+    });
+  }
+  EXPECT_TRUE(
+      all_connected.Await(kNumPeers * kOverlapTimeout + absl::Seconds(10))
+          .result());
+  EXPECT_EQ(overlapping_connects, kNumPeers);
+
+  requesters.Shutdown();
+  for (auto& channel : remote_channels) channel->Close();
+  bwu.Shutdown();
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -0,0 +1,310 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/block_delta.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+#include "internal/platform/crypto.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace block_delta {
+
+namespace {
+// Bytes per block in BlockSignatures::blocks: the rolling checksum, then the
+// strong checksum, both little endian.
+constexpr std::size_t kPackedSignatureSize = 4 + 8;
+constexpr std::uint32_t kChecksumMask = 0xffff;
+
+void AppendLittleEndian(std::string& out, std::uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; ++i) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+std::uint64_t ReadLittleEndian(const char* in, int bytes) {
+  std::uint64_t value = 0;
+  for (int i = 0; i < bytes; ++i) {
+    value |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(in[i]))
+             << (8 * i);
+  }
+  return value;
+}
+
+void AppendVarint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+bool ConsumeVarint(absl::string_view& in, std::uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && !in.empty(); shift += 7) {
+    auto byte = static_cast<std::uint8_t>(in.front());
+    in.remove_prefix(1);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+}  // namespace
+
+void RollingChecksum::Reset(absl::string_view block) {
+  a_ = 0;
+  b_ = 0;
+  size_ = block.size();
+  for (std::size_t i = 0; i < block.size(); ++i) {
+    auto byte = static_cast<std::uint8_t>(block[i]);
+    a_ += byte;
+    b_ += (size_ - i) * byte;
+  }
+  a_ &= kChecksumMask;
+  b_ &= kChecksumMask;
+}
+
+void RollingChecksum::Roll(char out, char in) {
+  auto out_byte = static_cast<std::uint8_t>(out);
+  auto in_byte = static_cast<std::uint8_t>(in);
+  a_ = (a_ - out_byte + in_byte) & kChecksumMask;
+  b_ = (b_ - size_ * out_byte + a_) & kChecksumMask;
+}
+
+std::uint64_t StrongChecksum(absl::string_view block) {
+  ByteArray hash = Crypto::Sha256(block);
+  if (hash.size() < 8) return 0;
+  return ReadLittleEndian(hash.data(), 8);
+}
+
+std::int32_t ChooseBlockSize(std::int64_t basis_size) {
+  auto block_size =
+      static_cast<std::int64_t>(std::sqrt(static_cast<double>(basis_size)));
+  block_size = (block_size + 1023) / 1024 * 1024;
+  block_size = std::max(block_size, (basis_size + kMaxBlocks - 1) / kMaxBlocks);
+  return static_cast<std::int32_t>(std::clamp<std::int64_t>(
+      block_size, kMinBlockSize, kMaxBlockSize));
+}
+
+PayloadTransferFrame::BlockSignatures SignaturesToProto(
+    const Signatures& signatures) {
+  PayloadTransferFrame::BlockSignatures proto;
+  proto.set_block_size(signatures.block_size);
+  std::string blocks;
+  blocks.reserve(signatures.blocks.size() * kPackedSignatureSize);
+  for (const BlockSignature& block : signatures.blocks) {
+    AppendLittleEndian(blocks, block.rolling_checksum, 4);
+    AppendLittleEndian(blocks, block.strong_checksum, 8);
+  }
+  proto.set_blocks(std::move(blocks));
+  return proto;
+}
+
+ExceptionOr<Signatures> SignaturesFromProto(
+    const PayloadTransferFrame::BlockSignatures& proto) {
+  const std::string& blocks = proto.blocks();
+  if (proto.block_size() <= 0 || proto.block_size() > kMaxBlockSize ||
+      blocks.size() % kPackedSignatureSize != 0 ||
+      blocks.size() / kPackedSignatureSize > kMaxBlocks) {
+    return ExceptionOr<Signatures>(Exception::kInvalidProtocolBuffer);
+  }
+
+  Signatures signatures;
+  signatures.block_size = proto.block_size();
+  signatures.blocks.reserve(blocks.size() / kPackedSignatureSize);
+  for (std::size_t i = 0; i < blocks.size(); i += kPackedSignatureSize) {
+    BlockSignature block;
+    block.rolling_checksum =
+        static_cast<std::uint32_t>(ReadLittleEndian(&blocks[i], 4));
+    block.strong_checksum = ReadLittleEndian(&blocks[i + 4], 8);
+    signatures.blocks.push_back(block);
+  }
+  return ExceptionOr<Signatures>(std::move(signatures));
+}
+
+SignatureBuilder::SignatureBuilder(std::int32_t block_size) {
+  signatures_.block_size = block_size;
+}
+
+void SignatureBuilder::Update(const ByteArray& data) {
+  const std::size_t block_size = signatures_.block_size;
+  absl::string_view rest(data.data(), data.size());
+  if (!partial_block_.empty()) {
+    std::size_t size = std::min(block_size - partial_block_.size(), rest.size());
+    partial_block_.append(rest.data(), size);
+    rest.remove_prefix(size);
+    if (partial_block_.size() < block_size) return;
+    AddBlock(partial_block_);
+    partial_block_.clear();
+  }
+  while (rest.size() >= block_size) {
+    AddBlock(rest.substr(0, block_size));
+    rest.remove_prefix(block_size);
+  }
+  partial_block_.assign(rest.data(), rest.size());
+}
+
+Signatures SignatureBuilder::Finish() {
+  partial_block_.clear();
+  return std::move(signatures_);
+}
+
+void SignatureBuilder::AddBlock(absl::string_view block) {
+  if (signatures_.blocks.size() >= kMaxBlocks) return;
+  RollingChecksum checksum;
+  checksum.Reset(block);
+  signatures_.blocks.push_back({checksum.Get(), StrongChecksum(block)});
+}
+
+DeltaEncoder::DeltaEncoder(Signatures signatures)
+    : signatures_(std::move(signatures)), index_filter_(kChecksumMask + 1) {
+  for (std::size_t i = 0; i < signatures_.blocks.size(); ++i) {
+    std::uint32_t checksum = signatures_.blocks[i].rolling_checksum;
+    index_[checksum].push_back(i);
+    index_filter_[checksum & kChecksumMask] = true;
+  }
+}
+
+ByteArray DeltaEncoder::Encode(const ByteArray& data, bool last) {
+  if (finished_) return {};
+
+  std::string delta;
+  pending_.append(data.data(), data.size());
+  const std::size_t block_size = signatures_.block_size;
+  while (true) {
+    if (!checksum_valid_) {
+      if (pending_.size() - position_ < block_size) break;
+      checksum_.Reset(absl::string_view(pending_).substr(position_, block_size));
+      checksum_valid_ = true;
+      block_checked_ = false;
+    }
+    if (!block_checked_) {
+      if (MatchBlock(delta)) continue;
+      block_checked_ = true;
+    }
+    if (position_ + block_size >= pending_.size()) break;
+    checksum_.Roll(pending_[position_], pending_[position_ + block_size]);
+    ++position_;
+    block_checked_ = false;
+  }
+
+  // Bytes before the block being matched can no longer be part of a match.
+  EncodeLiteral(delta, last ? pending_.size() : position_);
+  FlushCopies(delta);
+  pending_.erase(0, start_);
+  position_ -= start_;
+  start_ = 0;
+  if (last) finished_ = true;
+  return ByteArray(std::move(delta));
+}
+
+bool DeltaEncoder::MatchBlock(std::string& delta) {
+  std::uint32_t checksum = checksum_.Get();
+  if (!index_filter_[checksum & kChecksumMask]) return false;
+  auto item = index_.find(checksum);
+  if (item == index_.end()) return false;
+
+  const std::size_t block_size = signatures_.block_size;
+  std::uint64_t strong_checksum = StrongChecksum(
+      absl::string_view(pending_).substr(position_, block_size));
+  std::int64_t match = -1;
+  for (std::int64_t index : item->second) {
+    if (signatures_.blocks[index].strong_checksum != strong_checksum) continue;
+    match = index;
+    // Prefer the block that extends the current run of copies.
+    if (copy_count_ > 0 && index == copy_start_ + copy_count_) break;
+  }
+  if (match < 0) return false;
+
+  EncodeLiteral(delta, position_);
+  if (copy_count_ > 0 && match != copy_start_ + copy_count_) {
+    FlushCopies(delta);
+  }
+  if (copy_count_ == 0) copy_start_ = match;
+  ++copy_count_;
+  position_ += block_size;
+  start_ = position_;
+  encoded_size_ += block_size;
+  checksum_valid_ = false;
+  return true;
+}
+
+void DeltaEncoder::EncodeLiteral(std::string& delta, std::size_t end) {
+  if (end <= start_) return;
+  FlushCopies(delta);
+  std::size_t size = end - start_;
+  AppendVarint(delta, static_cast<std::uint64_t>(size) << 1);
+  delta.append(pending_, start_, size);
+  encoded_size_ += size;
+  start_ = end;
+}
+
+void DeltaEncoder::FlushCopies(std::string& delta) {
+  if (copy_count_ == 0) return;
+  AppendVarint(delta, (static_cast<std::uint64_t>(copy_count_) << 1) | 1);
+  AppendVarint(delta, copy_start_);
+  copy_count_ = 0;
+}
+
+ExceptionOr<ByteArray> Decode(
+    const ByteArray& delta, std::int32_t block_size, std::int64_t num_blocks,
+    absl::FunctionRef<ExceptionOr<ByteArray>(std::int64_t offset,
+                                             std::int64_t size)>
+        read_basis) {
+  std::string decoded;
+  absl::string_view in(delta.data(), delta.size());
+  while (!in.empty()) {
+    std::uint64_t tag;
+    if (!ConsumeVarint(in, tag)) {
+      return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+    }
+
+    if ((tag & 1) == 0) {
+      std::uint64_t size = tag >> 1;
+      if (size > in.size() || decoded.size() + size > kMaxDecodedSize) {
+        return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+      }
+      decoded.append(in.data(), size);
+      in.remove_prefix(size);
+      continue;
+    }
+
+    std::uint64_t count = tag >> 1;
+    std::uint64_t index;
+    if (!ConsumeVarint(in, index) || count == 0 ||
+        index >= static_cast<std::uint64_t>(num_blocks) ||
+        count > static_cast<std::uint64_t>(num_blocks) - index ||
+        decoded.size() + count * block_size > kMaxDecodedSize) {
+      return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+    }
+    std::int64_t size = count * block_size;
+    ExceptionOr<ByteArray> blocks = read_basis(index * block_size, size);
+    if (!blocks.ok()) return ExceptionOr<ByteArray>(blocks.exception());
+    if (static_cast<std::int64_t>(blocks.result().size()) != size) {
+      return ExceptionOr<ByteArray>(Exception::kIo);
+    }
+    decoded.append(blocks.result().data(), size);
+  }
+  return ExceptionOr<ByteArray>(ByteArray(std::move(decoded)));
+}
+
+}  // namespace block_delta
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,171 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_BLOCK_DELTA_H_
+#define CORE_INTERNAL_BLOCK_DELTA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace block_delta {
+
+// rsync-style delta encoding of a file against a copy of it that the receiver
+// already has (the basis): the receiver signs each full block of the basis,
+// and the sender encodes the file as literal bytes and references to the
+// basis blocks it finds in the file, at any offset.
+//
+// A delta is a sequence of instructions, each starting with a varint tag:
+// - (length << 1): |length| literal bytes follow.
+// - (count << 1) | 1: followed by a varint block index; copies |count| basis
+//   blocks, starting at that one.
+
+constexpr std::int32_t kMinBlockSize = 2 * 1024;
+constexpr std::int32_t kMaxBlockSize = 256 * 1024;
+// Bounds the size of the signatures, which are sent in a single frame. Blocks
+// of larger bases past this are not signed.
+constexpr std::int64_t kMaxBlocks = 64 * 1024;
+// Deltas that would decode to more than this are rejected.
+constexpr std::size_t kMaxDecodedSize = 4 * 1024 * 1024;
+
+// Adler-32-like checksum of a block, which can be rolled over the data one
+// byte at a time.
+class RollingChecksum {
+ public:
+  void Reset(absl::string_view block);
+  // Slides the block by one byte: drops |out| from its front and adds |in| to
+  // its back.
+  void Roll(char out, char in);
+  std::uint32_t Get() const { return (b_ << 16) | a_; }
+
+ private:
+  std::uint32_t a_ = 0;
+  std::uint32_t b_ = 0;
+  std::uint32_t size_ = 0;
+};
+
+// Returns the first 8 bytes of the SHA-256 of |block|.
+std::uint64_t StrongChecksum(absl::string_view block);
+
+struct BlockSignature {
+  std::uint32_t rolling_checksum = 0;
+  std::uint64_t strong_checksum = 0;
+};
+
+struct Signatures {
+  std::int32_t block_size = 0;
+  std::vector<BlockSignature> blocks;
+};
+
+// Returns the block size to sign a basis of |basis_size| bytes with: about
+// its square root, which balances the size of the signatures against the
+// size of the literals sent around each change.
+std::int32_t ChooseBlockSize(std::int64_t basis_size);
+
+PayloadTransferFrame::BlockSignatures SignaturesToProto(
+    const Signatures& signatures);
+// Returns Exception::kInvalidProtocolBuffer if |proto| is malformed.
+ExceptionOr<Signatures> SignaturesFromProto(
+    const PayloadTransferFrame::BlockSignatures& proto);
+
+// Signs a basis that is fed to it in order, in pieces of any size.
+class SignatureBuilder {
+ public:
+  explicit SignatureBuilder(std::int32_t block_size);
+
+  void Update(const ByteArray& data);
+  // Returns the signatures of the full blocks fed to it.
+  Signatures Finish();
+
+ private:
+  void AddBlock(absl::string_view block);
+
+  Signatures signatures_;
+  std::string partial_block_;
+};
+
+// Encodes a file that is fed to it in order, in pieces of any size, against
+// the signatures of a basis. Not thread safe.
+class DeltaEncoder {
+ public:
+  explicit DeltaEncoder(Signatures signatures);
+
+  // Returns a delta of the bytes of the file that are settled once |data| is
+  // fed: up to a block of them is held back, to be matched against the basis
+  // with what comes next. Each delta can be decoded on its own. Pass |last| to
+  // settle the rest of the file.
+  ByteArray Encode(const ByteArray& data, bool last);
+
+  // Returns how many bytes of the file the deltas returned so far cover.
+  std::int64_t GetEncodedSize() const { return encoded_size_; }
+  bool IsFinished() const { return finished_; }
+
+ private:
+  // Returns true if the block at |position_| is a basis block, after
+  // encoding a copy of it.
+  bool MatchBlock(std::string& delta);
+  // Encodes the pending bytes up to |end| as literals.
+  void EncodeLiteral(std::string& delta, std::size_t end);
+  void FlushCopies(std::string& delta);
+
+  Signatures signatures_;
+  // Rolling checksum -> indices of the blocks with that checksum.
+  absl::flat_hash_map<std::uint32_t, std::vector<std::int64_t>> index_;
+  // Cheap filter for index_ lookups: whether any block has a rolling checksum
+  // with these low 16 bits.
+  std::vector<bool> index_filter_;
+
+  // File bytes fed to the encoder, from |start_| on not encoded yet. The
+  // block at |position_| is being matched; bytes before it are literals.
+  std::string pending_;
+  std::size_t start_ = 0;
+  std::size_t position_ = 0;
+  RollingChecksum checksum_;
+  bool checksum_valid_ = false;
+  bool block_checked_ = false;
+  // A run of consecutive basis blocks to copy, not encoded yet.
+  std::int64_t copy_start_ = 0;
+  std::int64_t copy_count_ = 0;
+  std::int64_t encoded_size_ = 0;
+  bool finished_ = false;
+};
+
+// Returns the file bytes |delta| stands for, reading the basis blocks it
+// copies with |read_basis|, which returns |size| bytes of the basis at
+// |offset|. Returns Exception::kInvalidProtocolBuffer if |delta| is
+// malformed, refers to blocks past |num_blocks|, or decodes to more than
+// kMaxDecodedSize.
+ExceptionOr<ByteArray> Decode(
+    const ByteArray& delta, std::int32_t block_size, std::int64_t num_blocks,
+    absl::FunctionRef<ExceptionOr<ByteArray>(std::int64_t offset,
+                                             std::int64_t size)>
+        read_basis);
+
+}  // namespace block_delta
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_BLOCK_DELTA_H_
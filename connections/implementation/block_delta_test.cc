@@ -0,0 +1,180 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/block_delta.h"
+
+#include <random>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace block_delta {
+namespace {
+
+constexpr std::int32_t kBlockSize = kMinBlockSize;
+
+std::string MakeRandom(std::size_t size, int seed = 42) {
+  std::mt19937 generator(seed);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes) byte = static_cast<char>(generator());
+  return bytes;
+}
+
+Signatures Sign(const std::string& basis) {
+  SignatureBuilder builder(kBlockSize);
+  builder.Update(ByteArray(basis));
+  return builder.Finish();
+}
+
+// Encodes |file| against |basis|, feeding it in |piece_size| pieces, and
+// decodes the deltas back. Returns the total size of the deltas.
+std::size_t RoundTrip(const std::string& basis, const std::string& file,
+                      std::size_t piece_size) {
+  Signatures signatures = Sign(basis);
+  const std::int64_t num_blocks = signatures.blocks.size();
+  DeltaEncoder encoder(std::move(signatures));
+  auto read_basis = [&basis](std::int64_t offset,
+                             std::int64_t size) -> ExceptionOr<ByteArray> {
+    return ExceptionOr<ByteArray>(ByteArray(basis.substr(offset, size)));
+  };
+
+  std::string decoded;
+  std::size_t delta_size = 0;
+  for (std::size_t offset = 0; !encoder.IsFinished(); offset += piece_size) {
+    bool last = offset >= file.size();
+    ByteArray delta = encoder.Encode(
+        last ? ByteArray() : ByteArray(file.substr(offset, piece_size)), last);
+    delta_size += delta.size();
+    ExceptionOr<ByteArray> bytes =
+        Decode(delta, kBlockSize, num_blocks, read_basis);
+    EXPECT_TRUE(bytes.ok());
+    decoded += std::string(bytes.result());
+    EXPECT_EQ(encoder.GetEncodedSize(), decoded.size());
+  }
+  EXPECT_EQ(decoded, file);
+  return delta_size;
+}
+
+TEST(BlockDeltaTest, RollingChecksumMatchesReset) {
+  std::string data = MakeRandom(kBlockSize * 2);
+  RollingChecksum rolling;
+  rolling.Reset(absl::string_view(data).substr(0, kBlockSize));
+
+  for (std::size_t i = 1; i <= kBlockSize; ++i) {
+    rolling.Roll(data[i - 1], data[i - 1 + kBlockSize]);
+    RollingChecksum reset;
+    reset.Reset(absl::string_view(data).substr(i, kBlockSize));
+    ASSERT_EQ(rolling.Get(), reset.Get()) << "at " << i;
+  }
+}
+
+TEST(BlockDeltaTest, ChoosesBlockSizeFromBasisSize) {
+  EXPECT_EQ(ChooseBlockSize(0), kMinBlockSize);
+  EXPECT_EQ(ChooseBlockSize(100 * 1024 * 1024), 10 * 1024);
+  EXPECT_EQ(ChooseBlockSize(std::int64_t{1} << 40), kMaxBlockSize);
+}
+
+TEST(BlockDeltaTest, SignaturesSurviveProto) {
+  Signatures signatures = Sign(MakeRandom(kBlockSize * 3 + 100));
+  ASSERT_EQ(signatures.blocks.size(), 3u);
+
+  ExceptionOr<Signatures> parsed =
+      SignaturesFromProto(SignaturesToProto(signatures));
+
+  ASSERT_TRUE(parsed.ok());
+  EXPECT_EQ(parsed.result().block_size, kBlockSize);
+  ASSERT_EQ(parsed.result().blocks.size(), 3u);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(parsed.result().blocks[i].rolling_checksum,
+              signatures.blocks[i].rolling_checksum);
+    EXPECT_EQ(parsed.result().blocks[i].strong_checksum,
+              signatures.blocks[i].strong_checksum);
+  }
+}
+
+TEST(BlockDeltaTest, RejectsMalformedSignatures) {
+  PayloadTransferFrame::BlockSignatures proto;
+  proto.set_block_size(kBlockSize);
+  proto.set_blocks("too short");
+
+  EXPECT_FALSE(SignaturesFromProto(proto).ok());
+}
+
+TEST(BlockDeltaTest, SendsUnchangedFileAsCopies) {
+  std::string file = MakeRandom(kBlockSize * 64);
+
+  EXPECT_LT(RoundTrip(file, file, 4096), file.size() / 100);
+}
+
+TEST(BlockDeltaTest, SendsOnlyChangedBytes) {
+  std::string basis = MakeRandom(kBlockSize * 64);
+  std::string file = basis;
+  file.insert(kBlockSize * 10 + 7, "inserted");
+  file.erase(kBlockSize * 30, 100);
+  file.replace(kBlockSize * 50, 10, "overwrite!");
+
+  // Each change costs up to about two blocks of literals.
+  EXPECT_LT(RoundTrip(basis, file, 4096), 6u * kBlockSize);
+}
+
+TEST(BlockDeltaTest, SendsUnrelatedFileAsLiterals) {
+  std::string basis = MakeRandom(kBlockSize * 8, /*seed=*/1);
+  std::string file = MakeRandom(kBlockSize * 8 + 123, /*seed=*/2);
+
+  EXPECT_GE(RoundTrip(basis, file, 4096), file.size());
+}
+
+TEST(BlockDeltaTest, MatchesAcrossPieces) {
+  std::string basis = MakeRandom(kBlockSize * 16);
+  std::string file = "prefix" + basis;
+
+  // Pieces smaller than a block, and not aligned to them.
+  EXPECT_LT(RoundTrip(basis, file, 1000), file.size() / 100);
+}
+
+TEST(BlockDeltaTest, RejectsCopiesPastBasis) {
+  std::string basis = MakeRandom(kBlockSize * 4);
+  DeltaEncoder encoder(Sign(basis));
+  ByteArray delta = encoder.Encode(ByteArray(basis), /*last=*/true);
+  auto read_basis = [&basis](std::int64_t offset,
+                             std::int64_t size) -> ExceptionOr<ByteArray> {
+    return ExceptionOr<ByteArray>(ByteArray(basis.substr(offset, size)));
+  };
+
+  EXPECT_TRUE(Decode(delta, kBlockSize, 4, read_basis).ok());
+  EXPECT_FALSE(Decode(delta, kBlockSize, 3, read_basis).ok());
+}
+
+TEST(BlockDeltaTest, RejectsTruncatedLiteral) {
+  std::string basis = MakeRandom(kBlockSize);
+  DeltaEncoder encoder(Sign(basis));
+  ByteArray delta = encoder.Encode(ByteArray(std::string(100, 'x')),
+                                   /*last=*/true);
+  auto read_basis = [](std::int64_t, std::int64_t) {
+    return ExceptionOr<ByteArray>(Exception::kIo);
+  };
+
+  EXPECT_FALSE(
+      Decode(delta.Slice(0, delta.size() - 1), kBlockSize, 1, read_basis).ok());
+}
+
+}  // namespace
+}  // namespace block_delta
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -22,6 +22,7 @@
 
 #include "absl/functional/bind_front.h"
 #include "absl/time/time.h"
+#include "connections/implementation/analytics/link_quality_estimator.h"
 #include "connections/implementation/bluetooth_bwu_handler.h"
 #include "connections/implementation/bwu_handler.h"
 #include "connections/implementation/offline_frames.h"
@@ -138,6 +139,9 @@ void BwuManager::Shutdown() {
     if (!channel) continue;
     channel->Close(DisconnectionReason::SHUTDOWN);
   }
+  // Reads of prior channels still being drained fail now that they are
+  // closed.
+  drain_executor_.Shutdown();
 
   CancelAllRetryUpgradeAlarms();
   medium_ = Medium::UNKNOWN_MEDIUM;
@@ -183,6 +187,12 @@ void BwuManager::InitiateBwuForEndpoint(ClientProxy* client,
                       << " with medium "
                       << proto::connections::Medium_Name(proposed_medium);
 
+    if (proposed_medium == Medium::UNKNOWN_MEDIUM) {
+      NEARBY_LOGS(INFO) << "BwuManager has no upgrade medium for endpoint "
+                        << endpoint_id << ", not upgrading.";
+      return;
+    }
+
     if (channel_manager_->isWifiLanConnected() &&
         (proposed_medium == Medium::WIFI_HOTSPOT)) {
       NEARBY_LOGS(INFO)
@@ -345,6 +355,7 @@ void BwuManager::OnEndpointDisconnect(ClientProxy* client,
     retry_delays_.erase(endpoint_id);
     CancelRetryUpgradeAlarm(endpoint_id);
     successfully_upgraded_endpoints_.erase(endpoint_id);
+    make_before_break_endpoints_.erase(endpoint_id);
 
     // Note(nohle): I'm skeptical of the "<= 1", which seems like it should be
     // "== 0". Luckily, we will enable the flag by default, and it won't matter.
@@ -501,7 +512,10 @@ void BwuManager::OnIncomingConnection(
           return;
         }
 
-        if (!WriteClientIntroductionAckFrame(channel)) {
+        bool make_before_break =
+            FeatureFlags::GetInstance().GetFlags().enable_make_before_break_bwu &&
+            introduction.supports_make_before_break();
+        if (!WriteClientIntroductionAckFrame(channel, make_before_break)) {
           // This was never a fully EstablishedConnection, no need to provide a
           // closure reason.
           channel->Close();
@@ -528,6 +542,12 @@ void BwuManager::OnIncomingConnection(
 
         CHECK(client == mapped_client);
 
+        if (make_before_break) {
+          make_before_break_endpoints_.insert(endpoint_id);
+        } else {
+          make_before_break_endpoints_.erase(endpoint_id);
+        }
+
         // The ConnectionAttempt has now succeeded, so record it as such.
         std::unique_ptr<ConnectionAttemptMetadataParams>
             connections_attempt_metadata_params;
@@ -579,6 +599,11 @@ void BwuManager::RunUpgradeProtocol(
   // sequence numbers for writes and reads, and simultaneously sending Payloads
   // on the new channel and control messages on the old channel cause the other
   // side to read messages out of sequence
+  //
+  // Make-before-break, the pause only lasts until LAST_WRITE is written: the
+  // remote device stops reading the old EndpointChannel right after it, and
+  // the rest of the shutdown goes over the old EndpointChannel unencrypted.
+  bool make_before_break = make_before_break_endpoints_.contains(endpoint_id);
   new_channel->Pause();
   auto old_channel = channel_manager_->GetChannelForEndpoint(endpoint_id);
   if (!old_channel) {
@@ -597,8 +622,14 @@ void BwuManager::RunUpgradeProtocol(
 
   // Next, initiate a clean shutdown for the previous EndpointChannel used for
   // this endpoint by telling the remote device that it will not receive any
-  // more writes over that EndpointChannel.
-  if (!old_channel->Write(parser::ForBwuLastWrite()).Ok()) {
+  // more writes over that EndpointChannel. Make-before-break, nothing but the
+  // unencrypted shutdown frames may follow it there: writers that still hold
+  // on to the old EndpointChannel are refused, instead of taking a turn of
+  // the encryption the new one goes on with.
+  ByteArray last_write = parser::ForBwuLastWrite(make_before_break);
+  if (!(make_before_break ? old_channel->WriteLast(last_write)
+                          : old_channel->Write(last_write))
+           .Ok()) {
     NEARBY_LOGS(ERROR)
         << "BwuManager failed to write "
            "BWU_NEGOTIATION.LAST_WRITE_TO_PRIOR_CHANNEL OfflineFrame to "
@@ -613,6 +644,11 @@ void BwuManager::RunUpgradeProtocol(
                           "BWU_NEGOTIATION.LAST_WRITE_TO_PRIOR_CHANNEL "
                           "OfflineFrame while upgrading endpoint "
                        << endpoint_id;
+  if (make_before_break) {
+    std::shared_ptr<EndpointChannel> channel =
+        channel_manager_->GetChannelForEndpoint(endpoint_id);
+    if (channel) channel->Resume();
+  }
 
   // The remainder of this clean shutdown for the previous EndpointChannel will
   // continue when we receive a corresponding
@@ -696,6 +732,9 @@ void BwuManager::ProcessBwuPathAvailableEvent(
   proto::connections::ConnectionAttemptResult connection_attempt_result;
   if (channel != nullptr) {
     connection_attempt_result = proto::connections::RESULT_SUCCESS;
+    analytics::LinkQualityEstimator::GetInstance().RecordUpgradeSetupTime(
+        upgrade_medium,
+        SystemClock::ElapsedRealtime() - connection_attempt_start_time);
   } else if (client->GetCancellationFlag(endpoint_id)->Cancelled()) {
     connection_attempt_result = proto::connections::RESULT_CANCELLED;
     client->GetAnalyticsRecorder().OnBandwidthUpgradeError(
@@ -790,11 +829,16 @@ BwuManager::ProcessBwuPathAvailableEventInternal(
   }
 
   // Write the requisite BANDWIDTH_UPGRADE_NEGOTIATION.CLIENT_INTRODUCTION as
-  // the first OfflineFrame on this new EndpointChannel.
+  // the first OfflineFrame on this new EndpointChannel. Make-before-break is
+  // agreed on in the ack, so it is only offered if one is coming.
+  bool supports_make_before_break =
+      FeatureFlags::GetInstance().GetFlags().enable_make_before_break_bwu &&
+      upgrade_path_info.supports_client_introduction_ack();
   if (!new_channel
            ->Write(parser::ForBwuIntroduction(
                client->GetLocalEndpointId(),
-               upgrade_path_info.supports_disabling_encryption()))
+               upgrade_path_info.supports_disabling_encryption(),
+               supports_make_before_break))
            .Ok()) {
     // This was never a fully EstablishedConnection, no need to provide a
     // closure reason.
@@ -810,8 +854,10 @@ BwuManager::ProcessBwuPathAvailableEventInternal(
     return {};
   }
 
+  make_before_break_endpoints_.erase(endpoint_id);
   if (upgrade_path_info.supports_client_introduction_ack()) {
-    if (!ReadClientIntroductionAckFrame(new_channel.get())) {
+    ClientIntroductionAck ack;
+    if (!ReadClientIntroductionAckFrame(new_channel.get(), ack)) {
       // This was never a fully EstablishedConnection, no need to provide a
       // closure reason.
       new_channel->Close();
@@ -823,6 +869,9 @@ BwuManager::ProcessBwuPathAvailableEventInternal(
 
       return {};
     }
+    if (supports_make_before_break && ack.supports_make_before_break()) {
+      make_before_break_endpoints_.insert(endpoint_id);
+    }
   }
 
   NEARBY_LOGS(INFO) << "BwuManager successfully wrote "
@@ -936,7 +985,8 @@ bool BwuManager::ReadClientIntroductionFrame(EndpointChannel* channel,
   return true;
 }
 
-bool BwuManager::ReadClientIntroductionAckFrame(EndpointChannel* channel) {
+bool BwuManager::ReadClientIntroductionAckFrame(EndpointChannel* channel,
+                                                ClientIntroductionAck& ack) {
   NEARBY_LOGS(INFO) << "ReadClientIntroductionAckFrame with channel name: "
                     << channel->GetName() << ", medium: "
                     << proto::connections::Medium_Name(channel->GetMedium());
@@ -963,14 +1013,18 @@ bool BwuManager::ReadClientIntroductionAckFrame(EndpointChannel* channel) {
   if (frame.v1().bandwidth_upgrade_negotiation().event_type() !=
       BandwidthUpgradeNegotiationFrame::CLIENT_INTRODUCTION_ACK)
     return false;
+  ack = frame.v1().bandwidth_upgrade_negotiation().client_introduction_ack();
   return true;
 }
 
-bool BwuManager::WriteClientIntroductionAckFrame(EndpointChannel* channel) {
+bool BwuManager::WriteClientIntroductionAckFrame(
+    EndpointChannel* channel, bool supports_make_before_break) {
   NEARBY_LOGS(INFO) << "WriteClientIntroductionAckFrame channel name: "
                     << channel->GetName() << ", medium: "
                     << proto::connections::Medium_Name(channel->GetMedium());
-  return channel->Write(parser::ForBwuIntroductionAck()).Ok();
+  return channel
+      ->Write(parser::ForBwuIntroductionAck(supports_make_before_break))
+      .Ok();
 }
 
 void BwuManager::ProcessLastWriteToPriorChannelEvent(
@@ -1001,11 +1055,22 @@ void BwuManager::ProcessLastWriteToPriorChannelEvent(
                     << proto::connections::Medium_Name(
                            previous_endpoint_channel->GetMedium());
 
-  if (!previous_endpoint_channel->Write(parser::ForBwuSafeToClose()).Ok()) {
+  // Make-before-break, both devices already write encrypted frames on the new
+  // EndpointChannel, so the prior one must not advance the shared crypto
+  // context anymore.
+  bool make_before_break = make_before_break_endpoints_.contains(endpoint_id);
+  if (make_before_break) previous_endpoint_channel->DisableEncryption();
+
+  ByteArray safe_to_close = parser::ForBwuSafeToClose();
+  if (!(make_before_break
+            ? previous_endpoint_channel->WriteUnencrypted(safe_to_close)
+            : previous_endpoint_channel->Write(safe_to_close))
+           .Ok()) {
     previous_endpoint_channel->Close(DisconnectionReason::IO_ERROR);
     // Remove this prior EndpointChannel from previous_endpoint_channels to
     // avoid leaks.
     previous_endpoint_channels_.erase(endpoint_id);
+    make_before_break_endpoints_.erase(endpoint_id);
 
     NEARBY_LOGS(ERROR) << "BwuManager failed to write "
                           "BWU_NEGOTIATION.SAFE_TO_CLOSE_PRIOR_CHANNEL "
@@ -1025,7 +1090,90 @@ void BwuManager::ProcessLastWriteToPriorChannelEvent(
   // The upgrade protocol's clean shutdown of the prior EndpointChannel will
   // conclude when we receive a corresponding
   // BANDWIDTH_UPGRADE_NEGOTIATION.SAFE_TO_CLOSE_PRIOR_CHANNEL OfflineFrame
-  // from the remote device.
+  // from the remote device. Make-before-break, the EndpointManager no longer
+  // reads the prior EndpointChannel, so we read that frame ourselves.
+  if (make_before_break) {
+    DrainPriorChannel(client, endpoint_id,
+                      previous_endpoint_channels_[endpoint_id]);
+  }
+}
+
+void BwuManager::DrainPriorChannel(ClientProxy* client,
+                                   const std::string& endpoint_id,
+                                   std::shared_ptr<EndpointChannel> channel) {
+  Runnable drain = [this, client, endpoint_id, channel]() {
+    absl::Duration timeout =
+        FeatureFlags::GetInstance().GetFlags().make_before_break_drain_timeout;
+    CancelableAlarm timeout_alarm(
+        "BwuManager::DrainPriorChannel",
+        [channel, timeout]() {
+          NEARBY_LOGS(ERROR)
+              << "In BwuManager, failed to read the "
+                 "SAFE_TO_CLOSE_PRIOR_CHANNEL frame after "
+              << absl::FormatDuration(timeout)
+              << ". Timing out and closing EndpointChannel "
+              << channel->GetType();
+          channel->Close(DisconnectionReason::IO_ERROR);
+        },
+        timeout, &alarm_executor_);
+    bool safe_to_close = ReadSafeToClosePriorChannelFrame(channel.get());
+    timeout_alarm.Cancel();
+
+    RunOnBwuManagerThread(
+        "bwu-prior-channel-drained",
+        [this, client, endpoint_id, channel, safe_to_close]() {
+          auto item = previous_endpoint_channels_.find(endpoint_id);
+          // Already shut down, eg. on disconnection.
+          if (item == previous_endpoint_channels_.end() ||
+              item->second != channel) {
+            return;
+          }
+          if (safe_to_close) {
+            ProcessSafeToClosePriorChannelEvent(client, endpoint_id);
+            return;
+          }
+
+          // Give up on a clean shutdown of the prior EndpointChannel. The
+          // upgraded one is in use either way.
+          previous_endpoint_channels_.erase(item);
+          make_before_break_endpoints_.erase(endpoint_id);
+          channel->Close(DisconnectionReason::IO_ERROR);
+          client->GetAnalyticsRecorder().OnBandwidthUpgradeError(
+              endpoint_id, proto::connections::RESULT_IO_ERROR,
+              proto::connections::SAFE_TO_CLOSE_PRIOR_CHANNEL);
+          std::shared_ptr<EndpointChannel> current_channel =
+              channel_manager_->GetChannelForEndpoint(endpoint_id);
+          if (current_channel) {
+            client->OnBandwidthChanged(endpoint_id,
+                                       current_channel->GetMedium());
+          }
+          in_progress_upgrades_.erase(endpoint_id);
+        });
+  };
+
+  if (is_single_threaded_for_testing_) {
+    drain();
+    return;
+  }
+  drain_executor_.Execute("bwu-drain-prior-channel", std::move(drain));
+}
+
+bool BwuManager::ReadSafeToClosePriorChannelFrame(EndpointChannel* channel) {
+  while (true) {
+    auto data = channel->Read();
+    if (!data.ok()) return false;
+    auto transfer(parser::FromBytes(data.result()));
+    if (transfer.ok() && transfer.result().has_v1() &&
+        transfer.result().v1().bandwidth_upgrade_negotiation().event_type() ==
+            BandwidthUpgradeNegotiationFrame::SAFE_TO_CLOSE_PRIOR_CHANNEL) {
+      return true;
+    }
+    // Nothing else is expected on the prior EndpointChannel after
+    // LAST_WRITE_TO_PRIOR_CHANNEL.
+    NEARBY_LOGS(WARNING) << "BwuManager skipped a frame while draining "
+                            "EndpointChannel "
+                         << channel->GetName();
+  }
 }
 
 void BwuManager::ProcessSafeToClosePriorChannelEvent(
@@ -1064,7 +1212,7 @@ void BwuManager::ProcessSafeToClosePriorChannelEvent(
   // circumstances so it is necessary to send it unencrypted. This way the
   // serial crypto context does not increment here.
   previous_endpoint_channel->DisableEncryption();
-  previous_endpoint_channel->Write(parser::ForDisconnection());
+  previous_endpoint_channel->WriteUnencrypted(parser::ForDisconnection());
 
   // Attempt to read the disconnect message from the previous channel. We don't
   // care whether we successfully read it or whether we get an exception here.
@@ -1104,6 +1252,7 @@ void BwuManager::ProcessSafeToClosePriorChannelEvent(
   // Report the success to the client
   client->OnBandwidthChanged(endpoint_id, channel->GetMedium());
   in_progress_upgrades_.erase(endpoint_id);
+  make_before_break_endpoints_.erase(endpoint_id);
 }
 
 void BwuManager::ProcessUpgradeFailureEvent(
@@ -1207,6 +1356,53 @@ void BwuManager::RetryUpgradeMediums(ClientProxy* client,
   InitiateBwuForEndpoint(client, endpoint_id, next_medium);
 }
 
+// Returns the medium expected to transfer the most data to the endpoint, or
+// UNKNOWN_MEDIUM if none is worth the cost of upgrading. Ties go to the
+// preferred medium.
+Medium BwuManager::ChooseMeasuredUpgradeMedium(
+    const std::string& endpoint_id,
+    const std::vector<Medium>& available_mediums) const {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  const analytics::LinkQualityEstimator& estimator =
+      analytics::LinkQualityEstimator::GetInstance();
+  Medium current_medium = Medium::UNKNOWN_MEDIUM;
+  channel_manager_->VisitChannelForEndpoint(
+      endpoint_id, [&current_medium](EndpointChannel* channel) {
+        if (channel) current_medium = channel->GetMedium();
+      });
+
+  Medium best_medium = Medium::UNKNOWN_MEDIUM;
+  double best_gain = 0;
+  for (Medium medium : available_mediums) {
+    double gain = estimator.GetExpectedUpgradeGain(current_medium, medium,
+                                                   flags.upgrade_gain_horizon);
+    analytics::LinkQualityEstimator::Estimate estimate =
+        estimator.GetEstimate(medium);
+    NEARBY_LOGS(INFO) << "Upgrade medium "
+                      << proto::connections::Medium_Name(medium)
+                      << " for endpoint " << endpoint_id
+                      << ": throughput_kbps=" << estimate.throughput_kbps
+                      << " (" << estimate.throughput_samples
+                      << " samples), setup_time="
+                      << absl::FormatDuration(estimate.upgrade_setup_time)
+                      << " (" << estimate.upgrade_setup_samples
+                      << " samples), expected gain=" << gain;
+    if (gain > best_gain) {
+      best_medium = medium;
+      best_gain = gain;
+    }
+  }
+
+  if (best_gain < flags.upgrade_min_expected_gain) {
+    NEARBY_LOGS(INFO) << "Declining to upgrade endpoint " << endpoint_id
+                      << " from "
+                      << proto::connections::Medium_Name(current_medium)
+                      << ": the best expected gain is " << best_gain;
+    return Medium::UNKNOWN_MEDIUM;
+  }
+  return best_medium;
+}
+
 std::vector<Medium> BwuManager::StripOutUnavailableMediums(
     const std::vector<Medium>& mediums) const {
   std::vector<Medium> available_mediums;
@@ -1253,7 +1449,13 @@ Medium BwuManager::ChooseBestUpgradeMedium(
     if (!available_mediums.empty()) {
       // Case 1: This is our first time upgrading, and we have at least one
       // supported medium to choose from. Return the first medium in the list,
-      // since they are ordered by preference.
+      // since they are ordered by preference, unless measurements say
+      // otherwise.
+      if (FeatureFlags::GetInstance()
+              .GetFlags()
+              .enable_measured_upgrade_selection) {
+        return ChooseMeasuredUpgradeMedium(endpoint_id, available_mediums);
+      }
       return available_mediums[0];
     }
     // Case 2: This is our first time upgrading, but there are no available
@@ -28,6 +28,7 @@
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_manager.h"
 #include "connections/implementation/mediums/mediums.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/scheduled_executor.h"
 
 namespace location {
@@ -117,6 +118,8 @@ class BwuManager : public EndpointManager::FrameProcessor {
  private:
   static constexpr absl::Duration kReadClientIntroductionFrameTimeout =
       absl::Seconds(5);
+  // Prior channels drained at once after make-before-break upgrades.
+  static constexpr int kMaxConcurrentPriorChannelDrains = 4;
 
   void InitBwuHandlers();
   void RunOnBwuManagerThread(const std::string& name,
@@ -125,9 +128,13 @@ class BwuManager : public EndpointManager::FrameProcessor {
       const std::vector<Medium>& mediums) const;
   Medium ChooseBestUpgradeMedium(const std::string& endpoint_id,
                                  const std::vector<Medium>& mediums) const;
+  Medium ChooseMeasuredUpgradeMedium(
+      const std::string& endpoint_id,
+      const std::vector<Medium>& available_mediums) const;
 
   // BaseBwuHandler
   using ClientIntroduction = BwuNegotiationFrame::ClientIntroduction;
+  using ClientIntroductionAck = BwuNegotiationFrame::ClientIntroductionAck;
 
   // Processes the BwuNegotiationFrames that come over the EndpointChannel on
   // both initiator and responder side of the upgrade.
@@ -173,8 +180,16 @@ class BwuManager : public EndpointManager::FrameProcessor {
                                            const std::string& endpoint_id);
   bool ReadClientIntroductionFrame(EndpointChannel* endpoint_channel,
                                    ClientIntroduction& introduction);
-  bool ReadClientIntroductionAckFrame(EndpointChannel* endpoint_channel);
-  bool WriteClientIntroductionAckFrame(EndpointChannel* endpoint_channel);
+  bool ReadClientIntroductionAckFrame(EndpointChannel* endpoint_channel,
+                                      ClientIntroductionAck& ack);
+  bool WriteClientIntroductionAckFrame(EndpointChannel* endpoint_channel,
+                                       bool supports_make_before_break);
+  // Reads what is left on the prior channel of a make-before-break upgrade in
+  // the background, up to the remote device's SAFE_TO_CLOSE_PRIOR_CHANNEL,
+  // then concludes the upgrade on the BwuManager thread.
+  void DrainPriorChannel(ClientProxy* client, const std::string& endpoint_id,
+                         std::shared_ptr<EndpointChannel> channel);
+  bool ReadSafeToClosePriorChannelFrame(EndpointChannel* endpoint_channel);
   void ProcessEndpointDisconnection(ClientProxy* client,
                                     const std::string& endpoint_id,
                                     CountDownLatch* barrier);
@@ -211,12 +226,17 @@ class BwuManager : public EndpointManager::FrameProcessor {
   EndpointChannelManager* channel_manager_;
   ScheduledExecutor alarm_executor_;
   SingleThreadExecutor serial_executor_;
+  // Runs DrainPriorChannel(), off the BwuManager thread.
+  MultiThreadExecutor drain_executor_{kMaxConcurrentPriorChannelDrains};
   // Stores each upgraded endpoint's previous EndpointChannel (that was
   // displaced in favor of a new EndpointChannel) temporarily, until it can
   // safely be shut down for good in processLastWriteToPriorChannelEvent().
   absl::flat_hash_map<std::string, std::shared_ptr<EndpointChannel>>
       previous_endpoint_channels_;
   absl::flat_hash_set<std::string> successfully_upgraded_endpoints_;
+  // Endpoints whose current upgrade was negotiated make-before-break: their
+  // new EndpointChannel is not paused while the prior one is shut down.
+  absl::flat_hash_set<std::string> make_before_break_endpoints_;
   // Maps endpointId -> ClientProxy for which
   // initiateBwuForEndpoint() has been called but which have not
   // yet completed the upgrade via onIncomingConnection().
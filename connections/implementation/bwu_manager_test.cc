@@ -213,6 +213,52 @@ TEST_P(BwuManagerTestParam, InitiateBwu_Success) {
             old_channel->disconnection_reason());
 }
 
+TEST_P(BwuManagerTestParam, InitiateBwu_MakeBeforeBreak) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_make_before_break_bwu = true;
+  FakeEndpointChannel* initial_channel =
+      CreateInitialEndpoint(kServiceIdA, kEndpointId1, Medium::BLUETOOTH);
+  std::shared_ptr<EndpointChannel> shared_initial_channel =
+      ecm_.GetChannelForEndpoint(std::string(kEndpointId1));
+
+  bwu_manager_->InitiateBwuForEndpoint(&client_, std::string(kEndpointId1),
+                                       Medium::WEB_RTC);
+  FakeEndpointChannel* upgraded_channel =
+      fake_web_rtc_bwu_handler_->NotifyBwuManagerOfIncomingConnection(
+          /*initialize_call_index=*/0u, bwu_manager_.get(),
+          /*supports_make_before_break=*/true);
+  EXPECT_EQ(upgraded_channel,
+            ecm_.GetChannelForEndpoint(std::string(kEndpointId1)).get());
+
+  // The upgraded channel is used right away, while the initial channel is
+  // still open.
+  EXPECT_FALSE(upgraded_channel->IsPaused());
+  EXPECT_FALSE(initial_channel->is_closed());
+  // A writer still holding on to the initial channel is refused once
+  // LAST_WRITE_TO_PRIOR_CHANNEL has been written on it.
+  EXPECT_TRUE(initial_channel->last_write_written());
+  EXPECT_EQ(initial_channel->Write(ByteArray("late")).value, Exception::kIo);
+
+  // After LAST_WRITE_TO_PRIOR_CHANNEL, BwuManager reads the Responder's
+  // SAFE_TO_CLOSE_PRIOR_CHANNEL off the initial channel itself, and shuts it
+  // down.
+  initial_channel->set_read_output(
+      ExceptionOr<ByteArray>(parser::ForBwuSafeToClose()));
+  ExceptionOr<OfflineFrame> last_write_frame =
+      parser::FromBytes(parser::ForBwuLastWrite(/*make_before_break=*/true));
+  bwu_manager_->OnIncomingFrame(last_write_frame.result(),
+                                std::string(kEndpointId1), &client_,
+                                Medium::BLUETOOTH, packet_meta_data_);
+
+  EXPECT_FALSE(upgraded_channel->IsPaused());
+  EXPECT_TRUE(initial_channel->is_closed());
+  EXPECT_EQ(proto::connections::DisconnectionReason::UPGRADED,
+            initial_channel->disconnection_reason());
+  // SAFE_TO_CLOSE_PRIOR_CHANNEL and the disconnection.
+  EXPECT_EQ(initial_channel->unencrypted_writes(), 2);
+  FeatureFlags::GetMutableFlagsForTesting().enable_make_before_break_bwu =
+      false;
+}
+
 TEST_P(BwuManagerTestParam,
        InitiateBwu_Error_DontUpgradeIfAlreadyConenctedOverTheRequestedMedium) {
   CreateInitialEndpoint(kServiceIdA, kEndpointId1, Medium::BLUETOOTH);
@@ -0,0 +1,122 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "zlib.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace chunk_compression {
+
+namespace {
+constexpr std::size_t kEntropySampleSize = 4096;
+// Raw DEFLATE: no zlib header or checksum; frames are authenticated already.
+constexpr int kWindowBits = -15;
+constexpr int kMemLevel = 8;
+}  // namespace
+
+double EstimateEntropy(const ByteArray& chunk) {
+  if (chunk.Empty()) return 0;
+
+  std::array<std::size_t, 256> counts{};
+  std::size_t stride =
+      std::max<std::size_t>(chunk.size() / kEntropySampleSize, 1);
+  std::size_t sampled = 0;
+  for (std::size_t i = 0; i < chunk.size(); i += stride) {
+    ++counts[static_cast<std::uint8_t>(chunk.data()[i])];
+    ++sampled;
+  }
+
+  double entropy = 0;
+  for (std::size_t count : counts) {
+    if (count == 0) continue;
+    double p = static_cast<double>(count) / sampled;
+    entropy -= p * std::log2(p);
+  }
+  return entropy;
+}
+
+ByteArray Compress(const ByteArray& chunk) {
+  if (chunk.size() < kMinCompressedChunkSize ||
+      chunk.size() > kMaxUncompressedChunkSize ||
+      EstimateEntropy(chunk) > kMaxCompressibleEntropy) {
+    return {};
+  }
+
+  z_stream stream{};
+  if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, kWindowBits, kMemLevel,
+                   Z_DEFAULT_STRATEGY) != Z_OK) {
+    return {};
+  }
+  // Only output that saves an eighth of the chunk is of use; deflate() runs
+  // out of room before finishing otherwise.
+  std::string compressed(chunk.size() - chunk.size() / 8, '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.data()));
+  stream.avail_in = chunk.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = compressed.size();
+  int result = deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END) return {};
+
+  return ByteArray(std::move(compressed));
+}
+
+ExceptionOr<ByteArray> Decompress(const ByteArray& chunk) {
+  z_stream stream{};
+  if (inflateInit2(&stream, kWindowBits) != Z_OK) {
+    return ExceptionOr<ByteArray>(Exception::kFailed);
+  }
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.data()));
+  stream.avail_in = chunk.size();
+
+  std::string decompressed;
+  std::size_t capacity = std::min(
+      std::max<std::size_t>(chunk.size() * 4, 4096), kMaxUncompressedChunkSize);
+  int result;
+  while (true) {
+    decompressed.resize(capacity);
+    stream.next_out = reinterpret_cast<Bytef*>(&decompressed[stream.total_out]);
+    stream.avail_out = capacity - stream.total_out;
+    result = inflate(&stream, Z_FINISH);
+    // Out of output space is the only error to retry on, with more of it.
+    if (result != Z_BUF_ERROR || stream.avail_out != 0 ||
+        capacity == kMaxUncompressedChunkSize) {
+      break;
+    }
+    capacity = std::min(capacity * 2, kMaxUncompressedChunkSize);
+  }
+  decompressed.resize(stream.total_out);
+  inflateEnd(&stream);
+  if (result != Z_STREAM_END) {
+    return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+  }
+
+  return ExceptionOr<ByteArray>(ByteArray(std::move(decompressed)));
+}
+
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
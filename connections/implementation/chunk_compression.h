@@ -0,0 +1,58 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CHUNK_COMPRESSION_H_
+#define CORE_INTERNAL_CHUNK_COMPRESSION_H_
+
+#include <cstddef>
+
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace chunk_compression {
+
+// Chunks are compressed one by one, with raw DEFLATE, so that each of them can
+// be decompressed on its own (see PayloadChunk::COMPRESSED).
+
+// Chunks that would decompress to more than this are rejected.
+constexpr std::size_t kMaxUncompressedChunkSize = 1024 * 1024;
+// Chunks smaller than this are not worth compressing.
+constexpr std::size_t kMinCompressedChunkSize = 256;
+// Chunks whose sampled bytes carry more bits of entropy per byte than this are
+// taken to be compressed already (eg. media, archives) and sent as is.
+constexpr double kMaxCompressibleEntropy = 7.5;
+
+// Returns an estimate of the entropy of |chunk|, in bits per byte, from a
+// sample of up to 4 KB of its bytes taken evenly across it.
+double EstimateEntropy(const ByteArray& chunk);
+
+// Returns |chunk| compressed, or an empty ByteArray if compressing it is not
+// worthwhile: if it looks incompressible, or would not shrink by at least an
+// eighth.
+ByteArray Compress(const ByteArray& chunk);
+
+// Returns the decompressed |chunk|, or Exception::kInvalidProtocolBuffer if it
+// is not valid DEFLATE data or decompresses to more than
+// kMaxUncompressedChunkSize.
+ExceptionOr<ByteArray> Decompress(const ByteArray& chunk);
+
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_CHUNK_COMPRESSION_H_
@@ -0,0 +1,82 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_compression.h"
+
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace chunk_compression {
+namespace {
+
+ByteArray MakeText(int lines) {
+  std::string text;
+  for (int i = 0; i < lines; ++i) {
+    absl::StrAppend(&text, R"({"level":"INFO","event":"chunk sent","seq":)", i,
+                    "}\n");
+  }
+  return ByteArray(std::move(text));
+}
+
+ByteArray MakeRandom(std::size_t size) {
+  std::mt19937 generator(42);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes) byte = static_cast<char>(generator());
+  return ByteArray(std::move(bytes));
+}
+
+TEST(ChunkCompressionTest, CompressesText) {
+  ByteArray text = MakeText(1000);
+
+  ByteArray compressed = Compress(text);
+
+  ASSERT_FALSE(compressed.Empty());
+  EXPECT_LT(compressed.size(), text.size() / 4);
+  ExceptionOr<ByteArray> decompressed = Decompress(compressed);
+  ASSERT_TRUE(decompressed.ok());
+  EXPECT_EQ(decompressed.result(), text);
+}
+
+TEST(ChunkCompressionTest, SkipsHighEntropyChunks) {
+  ByteArray random = MakeRandom(64 * 1024);
+
+  EXPECT_GT(EstimateEntropy(random), kMaxCompressibleEntropy);
+  EXPECT_TRUE(Compress(random).Empty());
+}
+
+TEST(ChunkCompressionTest, SkipsSmallChunks) {
+  EXPECT_TRUE(
+      Compress(ByteArray(std::string(kMinCompressedChunkSize - 1, 'a')))
+          .Empty());
+}
+
+TEST(ChunkCompressionTest, RejectsCorruptChunks) {
+  ByteArray compressed = Compress(MakeText(1000));
+  ASSERT_FALSE(compressed.Empty());
+
+  EXPECT_FALSE(Decompress(compressed.Slice(0, compressed.size() / 2)).ok());
+  EXPECT_FALSE(Decompress(ByteArray(std::string("not deflate"))).ok());
+}
+
+}  // namespace
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
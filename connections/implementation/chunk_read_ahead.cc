@@ -0,0 +1,84 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_read_ahead.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+ChunkReadAhead::ChunkReadAhead(InternalPayload* payload, int depth,
+                               int chunk_size)
+    : payload_(payload),
+      depth_(static_cast<size_t>(std::max(depth, 1))),
+      chunk_size_(chunk_size) {
+  reader_.Execute("chunk-read-ahead", [this]() { ReadChunks(); });
+}
+
+ChunkReadAhead::~ChunkReadAhead() {
+  {
+    MutexLock lock(&mutex_);
+    shutdown_ = true;
+    cond_.Notify();
+  }
+  reader_.Shutdown();
+}
+
+ByteArray ChunkReadAhead::GetNextChunk(int chunk_size) {
+  MutexLock lock(&mutex_);
+  chunk_size_ = chunk_size;
+  while (chunks_.empty() && !finished_) {
+    cond_.Wait();
+  }
+  if (chunks_.empty()) return {};
+
+  ByteArray chunk = std::move(chunks_.front());
+  chunks_.pop_front();
+  cond_.Notify();
+  return chunk;
+}
+
+void ChunkReadAhead::ReadChunks() {
+  while (true) {
+    int chunk_size;
+    {
+      MutexLock lock(&mutex_);
+      while (!shutdown_ && chunks_.size() >= depth_) {
+        cond_.Wait();
+      }
+      if (shutdown_) return;
+      chunk_size = chunk_size_;
+    }
+
+    ByteArray chunk = payload_->DetachNextChunk(chunk_size);
+
+    MutexLock lock(&mutex_);
+    bool last_chunk = chunk.Empty();
+    chunks_.push_back(std::move(chunk));
+    cond_.Notify();
+    if (last_chunk) {
+      finished_ = true;
+      return;
+    }
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
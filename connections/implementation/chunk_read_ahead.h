@@ -0,0 +1,76 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CHUNK_READ_AHEAD_H_
+#define CORE_INTERNAL_CHUNK_READ_AHEAD_H_
+
+#include <cstddef>
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "connections/implementation/internal_payload.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Detaches the chunks of an outgoing InternalPayload on a thread of its own,
+// up to |depth| chunks ahead of the sender. This turns sending a payload into
+// a two stage pipeline: while chunk N is serialized, encrypted and written to
+// the endpoints, chunk N+1 is already being read.
+//
+// Chunks are handed out in the order they were detached in, so the offsets the
+// sender keeps track of are unaffected. Reading stops after the first empty
+// chunk, which marks the end of the payload (or a failure to read it).
+class ChunkReadAhead {
+ public:
+  // Starts reading |payload|, which must outlive this object, in chunks of
+  // |chunk_size| bytes.
+  ChunkReadAhead(InternalPayload* payload, int depth, int chunk_size);
+  // Stops reading; blocks while a chunk is being detached.
+  ~ChunkReadAhead();
+
+  // Returns the next chunk, blocking until it has been read. Chunks that have
+  // not been read yet will have |chunk_size| bytes; the chunk size follows the
+  // endpoints' transmit packet size, which may change (eg. after a bandwidth
+  // upgrade).
+  ByteArray GetNextChunk(int chunk_size) ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  void ReadChunks() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  InternalPayload* const payload_;
+  const size_t depth_;
+
+  Mutex mutex_;
+  // Signalled whenever a chunk is added or taken, and on shutdown.
+  ConditionVariable cond_{&mutex_};
+  std::deque<ByteArray> chunks_ ABSL_GUARDED_BY(mutex_);
+  int chunk_size_ ABSL_GUARDED_BY(mutex_);
+  // Set once the last (empty) chunk has been read.
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+
+  SingleThreadExecutor reader_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_CHUNK_READ_AHEAD_H_
@@ -0,0 +1,114 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_read_ahead.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+// Returns |num_chunks| chunks, filled with the chunk's index, and then empty
+// chunks.
+class FakeInternalPayload : public InternalPayload {
+ public:
+  explicit FakeInternalPayload(int num_chunks)
+      : InternalPayload(Payload()), num_chunks_(num_chunks) {}
+
+  PayloadTransferFrame::PayloadHeader::PayloadType GetType() const override {
+    return PayloadTransferFrame::PayloadHeader::FILE;
+  }
+  std::int64_t GetTotalSize() const override { return kIndeterminateSize; }
+  ByteArray DetachNextChunk(int chunk_size) override {
+    int index = detached_++;
+    if (index >= num_chunks_) return {};
+    chunk_sizes_.push_back(chunk_size);
+    return ByteArray(std::string(chunk_size, static_cast<char>('a' + index)));
+  }
+  Exception AttachNextChunk(const ByteArray& chunk) override {
+    return {Exception::kIo};
+  }
+  ExceptionOr<size_t> SkipToOffset(size_t offset) override {
+    return {Exception::kIo};
+  }
+
+  int GetDetachedCount() const { return detached_; }
+  const std::vector<int>& GetChunkSizes() const { return chunk_sizes_; }
+
+ private:
+  const int num_chunks_;
+  std::atomic_int detached_ = 0;
+  std::vector<int> chunk_sizes_;
+};
+
+TEST(ChunkReadAheadTest, ReturnsChunksInOrder) {
+  FakeInternalPayload payload(5);
+  ChunkReadAhead read_ahead(&payload, 2, 4);
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(std::string(read_ahead.GetNextChunk(4)),
+              std::string(4, static_cast<char>('a' + i)));
+  }
+  EXPECT_TRUE(read_ahead.GetNextChunk(4).Empty());
+  // Stays at the end.
+  EXPECT_TRUE(read_ahead.GetNextChunk(4).Empty());
+}
+
+TEST(ChunkReadAheadTest, ReadsNoMoreThanDepthAhead) {
+  FakeInternalPayload payload(10);
+  ChunkReadAhead read_ahead(&payload, 3, 4);
+
+  SystemClock::Sleep(absl::Milliseconds(100));
+  EXPECT_EQ(payload.GetDetachedCount(), 3);
+
+  read_ahead.GetNextChunk(4);
+  SystemClock::Sleep(absl::Milliseconds(100));
+  EXPECT_EQ(payload.GetDetachedCount(), 4);
+}
+
+TEST(ChunkReadAheadTest, FollowsChunkSizeChanges) {
+  FakeInternalPayload payload(4);
+  ChunkReadAhead read_ahead(&payload, 1, 4);
+  SystemClock::Sleep(absl::Milliseconds(50));
+
+  // The first chunk has been read ahead with the old size.
+  EXPECT_EQ(read_ahead.GetNextChunk(8).size(), 4);
+  EXPECT_EQ(read_ahead.GetNextChunk(8).size(), 8);
+  EXPECT_EQ(read_ahead.GetNextChunk(8).size(), 8);
+}
+
+TEST(ChunkReadAheadTest, StopsReadingWhenDestroyed) {
+  FakeInternalPayload payload(10);
+  {
+    ChunkReadAhead read_ahead(&payload, 2, 4);
+    read_ahead.GetNextChunk(4);
+  }
+  int detached = payload.GetDetachedCount();
+  EXPECT_LE(detached, 3);
+  SystemClock::Sleep(absl::Milliseconds(50));
+  EXPECT_EQ(payload.GetDetachedCount(), detached);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
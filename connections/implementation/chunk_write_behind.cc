@@ -0,0 +1,121 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_write_behind.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+ChunkWriteBehind::ChunkWriteBehind(OutputStream& output_stream,
+                                   std::int64_t max_queued_bytes,
+                                   std::int64_t max_write_bytes)
+    : output_stream_(output_stream),
+      max_queued_bytes_(std::max<std::int64_t>(max_queued_bytes, 1)),
+      max_write_bytes_(std::max<std::int64_t>(max_write_bytes, 1)) {}
+
+ChunkWriteBehind::~ChunkWriteBehind() {
+  Finish();
+  writer_.Shutdown();
+}
+
+Exception ChunkWriteBehind::Write(const ByteArray& chunk) {
+  MutexLock lock(&mutex_);
+  // A chunk larger than the queue is let in once the queue is empty.
+  while (error_.Ok() && !finished_ && queued_bytes_ > 0 &&
+         queued_bytes_ + static_cast<std::int64_t>(chunk.size()) >
+             max_queued_bytes_) {
+    cond_.Wait();
+  }
+  if (!error_.Ok()) return error_;
+  if (finished_) return {Exception::kIo};
+
+  chunks_.push_back(chunk);
+  queued_bytes_ += chunk.size();
+  if (!writing_) {
+    writing_ = true;
+    writer_.Execute("chunk-write-behind", [this]() { WriteChunks(); });
+  }
+  return {Exception::kSuccess};
+}
+
+Exception ChunkWriteBehind::Finish() {
+  MutexLock lock(&mutex_);
+  finished_ = true;
+  while (writing_) {
+    cond_.Wait();
+  }
+  return error_;
+}
+
+void ChunkWriteBehind::WriteChunks() {
+  while (true) {
+    ByteArray data;
+    std::int64_t taken_bytes = 0;
+    {
+      MutexLock lock(&mutex_);
+      if (chunks_.empty() || !error_.Ok()) {
+        writing_ = false;
+        cond_.Notify();
+        return;
+      }
+      // Take as many chunks as fit in one write; the first one is taken
+      // whatever its size, and written as is.
+      std::size_t count = 0;
+      for (const ByteArray& chunk : chunks_) {
+        if (count > 0 && taken_bytes + static_cast<std::int64_t>(chunk.size()) >
+                             max_write_bytes_) {
+          break;
+        }
+        taken_bytes += chunk.size();
+        ++count;
+      }
+      if (count == 1) {
+        data = std::move(chunks_.front());
+        chunks_.pop_front();
+      } else {
+        data = ByteArray(static_cast<std::size_t>(taken_bytes));
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+          data.CopyAt(offset, chunks_.front());
+          offset += chunks_.front().size();
+          chunks_.pop_front();
+        }
+      }
+    }
+
+    Exception result = output_stream_.Write(data);
+
+    MutexLock lock(&mutex_);
+    queued_bytes_ -= taken_bytes;
+    if (!result.Ok()) {
+      NEARBY_LOGS(WARNING) << "ChunkWriteBehind failed to write "
+                           << taken_bytes << " bytes: " << result.value;
+      error_ = result;
+      queued_bytes_ = 0;
+      chunks_.clear();
+    }
+    cond_.Notify();
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,80 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CHUNK_WRITE_BEHIND_H_
+#define CORE_INTERNAL_CHUNK_WRITE_BEHIND_H_
+
+#include <cstdint>
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Writes the chunks of an incoming payload to |output_stream| on a thread of
+// its own, so that the endpoint's reader thread does not wait for the disk.
+// This is the counterpart of ChunkReadAhead on the receiving side.
+//
+// Up to |max_queued_bytes| are queued up in memory; Write() blocks while the
+// queue is full. The chunks that queue up while a write is in progress are
+// written out together, in writes of up to |max_write_bytes|.
+class ChunkWriteBehind {
+ public:
+  ChunkWriteBehind(OutputStream& output_stream, std::int64_t max_queued_bytes,
+                   std::int64_t max_write_bytes);
+  // Finishes writing what is queued up.
+  ~ChunkWriteBehind();
+
+  // Queues |chunk| to be written. Returns the error of an earlier write, if
+  // there was one; chunks are not written after an error.
+  Exception Write(const ByteArray& chunk) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Blocks until all the queued chunks are written, and returns the first
+  // error that writing them ran into. Chunks are not accepted afterwards.
+  Exception Finish() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  void WriteChunks() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  OutputStream& output_stream_;
+  const std::int64_t max_queued_bytes_;
+  const std::int64_t max_write_bytes_;
+
+  Mutex mutex_;
+  // Signalled whenever chunks are taken off the queue, and when the writer
+  // runs out of chunks.
+  ConditionVariable cond_{&mutex_};
+  std::deque<ByteArray> chunks_ ABSL_GUARDED_BY(mutex_);
+  std::int64_t queued_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Whether WriteChunks() is scheduled or running.
+  bool writing_ ABSL_GUARDED_BY(mutex_) = false;
+  bool finished_ ABSL_GUARDED_BY(mutex_) = false;
+  Exception error_ ABSL_GUARDED_BY(mutex_) = {Exception::kSuccess};
+
+  SingleThreadExecutor writer_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_CHUNK_WRITE_BEHIND_H_
@@ -0,0 +1,128 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_write_behind.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Records the writes made to it. Writes block until |released| is counted
+// down, and fail once |fail_after| writes were made.
+class FakeOutputStream : public OutputStream {
+ public:
+  explicit FakeOutputStream(CountDownLatch* released = nullptr,
+                            int fail_after = -1)
+      : released_(released), fail_after_(fail_after) {}
+
+  Exception Write(const ByteArray& data) override {
+    if (released_) released_->Await();
+    MutexLock lock(&mutex_);
+    if (fail_after_ >= 0 && static_cast<int>(writes_.size()) >= fail_after_) {
+      return {Exception::kIo};
+    }
+    writes_.push_back(std::string(data));
+    return {Exception::kSuccess};
+  }
+  Exception Flush() override { return {Exception::kSuccess}; }
+  Exception Close() override { return {Exception::kSuccess}; }
+
+  std::vector<std::string> GetWrites() {
+    MutexLock lock(&mutex_);
+    return writes_;
+  }
+
+ private:
+  CountDownLatch* const released_;
+  const int fail_after_;
+  Mutex mutex_;
+  std::vector<std::string> writes_;
+};
+
+TEST(ChunkWriteBehindTest, WritesChunksInOrder) {
+  FakeOutputStream output_stream;
+  ChunkWriteBehind write_behind(output_stream, 1024, 1024);
+
+  EXPECT_TRUE(write_behind.Write(ByteArray("ab")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("cd")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("ef")).Ok());
+  EXPECT_TRUE(write_behind.Finish().Ok());
+
+  std::string written;
+  for (const std::string& write : output_stream.GetWrites()) written += write;
+  EXPECT_EQ(written, "abcdef");
+}
+
+TEST(ChunkWriteBehindTest, CoalescesQueuedChunks) {
+  CountDownLatch released(1);
+  FakeOutputStream output_stream(&released);
+  ChunkWriteBehind write_behind(output_stream, 1024, 6);
+
+  // The first chunk is written on its own; the rest queue up behind it.
+  EXPECT_TRUE(write_behind.Write(ByteArray("ab")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("cd")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("ef")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("gh")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("ij")).Ok());
+  released.CountDown();
+  EXPECT_TRUE(write_behind.Finish().Ok());
+
+  std::vector<std::string> writes = output_stream.GetWrites();
+  std::string written;
+  for (const std::string& write : writes) {
+    EXPECT_LE(write.size(), 6u);
+    written += write;
+  }
+  EXPECT_EQ(written, "abcdefghij");
+  EXPECT_LT(writes.size(), 5u);
+}
+
+TEST(ChunkWriteBehindTest, ReportsWriteErrors) {
+  FakeOutputStream output_stream(nullptr, /*fail_after=*/1);
+  ChunkWriteBehind write_behind(output_stream, 1024, 2);
+
+  EXPECT_TRUE(write_behind.Write(ByteArray("ab")).Ok());
+  EXPECT_TRUE(write_behind.Write(ByteArray("cd")).Ok());
+
+  EXPECT_EQ(write_behind.Finish(), Exception{Exception::kIo});
+  EXPECT_EQ(write_behind.Write(ByteArray("ef")), Exception{Exception::kIo});
+  EXPECT_THAT(output_stream.GetWrites(), ElementsAre("ab"));
+}
+
+TEST(ChunkWriteBehindTest, RejectsChunksAfterFinish) {
+  FakeOutputStream output_stream;
+  ChunkWriteBehind write_behind(output_stream, 1024, 1024);
+
+  EXPECT_TRUE(write_behind.Finish().Ok());
+
+  EXPECT_EQ(write_behind.Write(ByteArray("ab")), Exception{Exception::kIo});
+  EXPECT_TRUE(output_stream.GetWrites().empty());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
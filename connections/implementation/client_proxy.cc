@@ -57,6 +57,11 @@ ClientProxy::ClientProxy(::nearby::analytics::EventLogger* event_logger)
       [this](const ErrorCodeParams& params) {
         analytics_recorder_->OnErrorCode(params);
       });
+  const auto& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_async_payload_callbacks) {
+    callback_queue_ = std::make_unique<PayloadCallbackQueue>(
+        flags.payload_progress_min_interval, flags.payload_progress_min_bytes);
+  }
 }
 
 ClientProxy::~ClientProxy() { Reset(); }
@@ -82,6 +87,56 @@ std::string ClientProxy::GetConnectionToken(const std::string& endpoint_id) {
   return {};
 }
 
+void ClientProxy::EnablePayloadCompression(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+
+  Connection* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->payload_compression = true;
+  }
+}
+
+bool ClientProxy::IsPayloadCompressionEnabled(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  const Connection* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->payload_compression;
+}
+
+void ClientProxy::EnableDeltaTransfer(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+
+  Connection* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->delta_transfer = true;
+  }
+}
+
+bool ClientProxy::IsDeltaTransferEnabled(const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  const Connection* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->delta_transfer;
+}
+
+void ClientProxy::EnableChunkedBytesPayloads(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+
+  Connection* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->chunked_bytes_payloads = true;
+  }
+}
+
+bool ClientProxy::IsChunkedBytesPayloadsEnabled(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  const Connection* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->chunked_bytes_payloads;
+}
+
 std::string ClientProxy::GenerateLocalEndpointId() {
   if (high_vis_mode_) {
     if (!local_high_vis_mode_cache_endpoint_id_.empty()) {
@@ -290,7 +345,9 @@ void ClientProxy::OnConnectionInitiated(
   //
   // Note: we allow devices to connect to an advertiser even after it stops
   // advertising, so no need to check IsAdvertising() here.
-  item.connection_listener.initiated_cb(endpoint_id, info);
+  NotifyConnectionListener(
+      [initiated_cb = item.connection_listener.initiated_cb, endpoint_id,
+       info]() { initiated_cb(endpoint_id, info); });
 
   if (info.is_incoming_connection) {
     // Add CancellationFlag for advertisers once encryption succeeds.
@@ -314,7 +371,10 @@ void ClientProxy::OnConnectionAccepted(const std::string& endpoint_id) {
   // Notify the client.
   Connection* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
-    item->connection_listener.accepted_cb(endpoint_id);
+    NotifyConnectionListener(
+        [accepted_cb = item->connection_listener.accepted_cb, endpoint_id]() {
+          accepted_cb(endpoint_id);
+        });
     item->status = Connection::kConnected;
   }
 }
@@ -333,7 +393,9 @@ void ClientProxy::OnConnectionRejected(const std::string& endpoint_id,
   // Notify the client.
   const Connection* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
-    item->connection_listener.rejected_cb(endpoint_id, status);
+    NotifyConnectionListener(
+        [rejected_cb = item->connection_listener.rejected_cb, endpoint_id,
+         status]() { rejected_cb(endpoint_id, status); });
     OnDisconnected(endpoint_id, false /* notify */);
   }
 }
@@ -344,7 +406,11 @@ void ClientProxy::OnBandwidthChanged(const std::string& endpoint_id,
 
   const Connection* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
-    item->connection_listener.bandwidth_changed_cb(endpoint_id, new_medium);
+    NotifyConnectionListener(
+        [bandwidth_changed_cb = item->connection_listener.bandwidth_changed_cb,
+         endpoint_id, new_medium]() {
+          bandwidth_changed_cb(endpoint_id, new_medium);
+        });
     NEARBY_LOGS(INFO) << "ClientProxy [reporting onBandwidthChanged]: client="
                       << GetClientId() << "; endpoint_id=" << endpoint_id;
   }
@@ -356,7 +422,12 @@ void ClientProxy::OnDisconnected(const std::string& endpoint_id, bool notify) {
   const Connection* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
     if (notify) {
-      item->connection_listener.disconnected_cb({endpoint_id});
+      NotifyConnectionListener(
+          [disconnected_cb = item->connection_listener.disconnected_cb,
+           endpoint_id]() { disconnected_cb(endpoint_id); });
+    }
+    if (callback_queue_ != nullptr) {
+      callback_queue_->ForgetEndpoint(endpoint_id);
     }
     connections_.erase(endpoint_id);
     OnSessionComplete();
@@ -365,6 +436,17 @@ void ClientProxy::OnDisconnected(const std::string& endpoint_id, bool notify) {
   CancelEndpoint(endpoint_id);
 }
 
+void ClientProxy::NotifyConnectionListener(Runnable callback) {
+  if (callback_queue_ != nullptr) {
+    // Queued up with the payload updates, so that the client hears about the
+    // connection and its payloads in the order they happened in: no payload
+    // before the connection is accepted, and none after it is disconnected.
+    callback_queue_->Post(std::move(callback));
+  } else {
+    callback();
+  }
+}
+
 bool ClientProxy::ConnectionStatusMatches(const std::string& endpoint_id,
                                           Connection::Status status) const {
   MutexLock lock(&mutex_);
@@ -600,17 +682,29 @@ void ClientProxy::CancelAllEndpoints() {
 }
 
 void ClientProxy::OnPayload(const std::string& endpoint_id, Payload payload) {
-  MutexLock lock(&mutex_);
+  std::function<void(const std::string&, Payload)> payload_cb;
+  {
+    MutexLock lock(&mutex_);
 
-  if (IsConnectedToEndpoint(endpoint_id)) {
+    if (!IsConnectedToEndpoint(endpoint_id)) return;
     const Connection* item = LookupConnection(endpoint_id);
-    if (item != nullptr) {
-      NEARBY_LOGS(INFO) << "ClientProxy [reporting onPayloadReceived]: client="
-                        << GetClientId() << "; endpoint_id=" << endpoint_id
-                        << " ; payload_id=" << payload.GetId();
+    if (item == nullptr) return;
+    NEARBY_LOGS(INFO) << "ClientProxy [reporting onPayloadReceived]: client="
+                      << GetClientId() << "; endpoint_id=" << endpoint_id
+                      << " ; payload_id=" << payload.GetId();
+    if (callback_queue_ == nullptr) {
       item->payload_listener.payload_cb(endpoint_id, std::move(payload));
+      return;
     }
+    payload_cb = item->payload_listener.payload_cb;
   }
+
+  // Runnables have to be copyable, Payloads are not.
+  auto shared_payload = std::make_shared<Payload>(std::move(payload));
+  callback_queue_->Post([payload_cb = std::move(payload_cb), endpoint_id,
+                         shared_payload]() {
+    payload_cb(endpoint_id, std::move(*shared_payload));
+  });
 }
 
 const ClientProxy::Connection* ClientProxy::LookupConnection(
@@ -632,7 +726,16 @@ void ClientProxy::OnPayloadProgress(const std::string& endpoint_id,
   if (IsConnectedToEndpoint(endpoint_id)) {
     Connection* item = LookupConnection(endpoint_id);
     if (item != nullptr) {
-      item->payload_listener.payload_progress_cb(endpoint_id, info);
+      if (callback_queue_ != nullptr) {
+        callback_queue_->PostProgress(
+            endpoint_id, info,
+            [payload_progress_cb = item->payload_listener.payload_progress_cb,
+             endpoint_id](const PayloadProgressInfo& progress) {
+              payload_progress_cb(endpoint_id, progress);
+            });
+      } else {
+        item->payload_listener.payload_progress_cb(endpoint_id, info);
+      }
 
       if (info.status == PayloadProgressInfo::Status::kInProgress) {
         NEARBY_LOGS(VERBOSE)
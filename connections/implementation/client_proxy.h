@@ -17,12 +17,14 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "connections/advertising_options.h"
 #include "connections/discovery_options.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
+#include "connections/implementation/payload_callback_queue.h"
 #include "connections/listeners.h"
 #include "connections/status.h"
 #include "connections/strategy.h"
@@ -34,6 +36,7 @@
 #include "internal/platform/error_code_recorder.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/prng.h"
+#include "internal/platform/runnable.h"
 // Prefer using absl:: versions of a set and a map; they tend to be more
 // efficient: implementation is using open-addressing hash tables.
 #include "absl/container/flat_hash_map.h"
@@ -68,6 +71,22 @@ class ClientProxy final {
 
   std::string GetConnectionToken(const std::string& endpoint_id);
 
+  // Lets the payload chunks sent to |endpoint_id| be compressed; both sides
+  // agreed to it in their connection responses.
+  void EnablePayloadCompression(const std::string& endpoint_id);
+  bool IsPayloadCompressionEnabled(const std::string& endpoint_id) const;
+
+  // Lets FILE payloads be sent to and from |endpoint_id| as deltas against
+  // the receiver's copy; both sides agreed to it in their connection
+  // responses.
+  void EnableDeltaTransfer(const std::string& endpoint_id);
+  bool IsDeltaTransferEnabled(const std::string& endpoint_id) const;
+
+  // Lets BYTES payloads be sent to |endpoint_id| in chunks; it told us, in
+  // its connection response, that it reassembles them.
+  void EnableChunkedBytesPayloads(const std::string& endpoint_id);
+  bool IsChunkedBytesPayloadsEnabled(const std::string& endpoint_id) const;
+
   // Clears all the runtime state of this client.
   void Reset();
 
@@ -267,6 +286,9 @@ class ClientProxy final {
     DiscoveryOptions discovery_options;
     AdvertisingOptions advertising_options;
     std::string connection_token;
+    bool payload_compression{false};
+    bool delta_transfer{false};
+    bool chunked_bytes_payloads{false};
   };
 
   struct AdvertisingInfo {
@@ -285,6 +307,10 @@ class ClientProxy final {
 
   void RemoveAllEndpoints();
   void OnSessionComplete();
+  // Runs |callback|, which calls a connection listener, on |callback_queue_|
+  // if there is one, after the payload callbacks posted before it; and right
+  // away otherwise.
+  void NotifyConnectionListener(Runnable callback);
   bool ConnectionStatusesContains(const std::string& endpoint_id,
                                   Connection::Status status_to_match) const;
   void AppendConnectionStatus(const std::string& endpoint_id,
@@ -365,6 +391,11 @@ class ClientProxy final {
   // nullptr as no-op.
   std::unique_ptr<analytics::AnalyticsRecorder> analytics_recorder_;
   std::unique_ptr<ErrorCodeRecorder> error_code_recorder_;
+
+  // Calls the payload and connection listeners, when
+  // enable_async_payload_callbacks is set. Declared last so that it is
+  // destroyed, and the callbacks still queued up are run, first.
+  std::unique_ptr<PayloadCallbackQueue> callback_queue_;
 };
 
 }  // namespace connections
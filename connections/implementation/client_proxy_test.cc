@@ -37,6 +37,8 @@ namespace nearby {
 namespace connections {
 namespace {
 
+using ::testing::InSequence;
+using ::testing::InvokeWithoutArgs;
 using ::testing::MockFunction;
 using ::testing::StrictMock;
 
@@ -543,6 +545,34 @@ TEST_F(ClientProxyTest, OnPayloadChangesState) {
   OnPayload(&client2_, advertising_endpoint);
 }
 
+TEST_F(ClientProxyTest, AsyncCallbacksAreCalledInOrder) {
+  FeatureFlags::Flags saved_flags = FeatureFlags::GetInstance().GetFlags();
+  FeatureFlags::GetMutableFlagsForTesting().enable_async_payload_callbacks =
+      true;
+  {
+    FakeEventLogger event_logger;
+    ClientProxy client(&event_logger);
+    InSequence sequence;
+    Endpoint advertising_endpoint =
+        StartAdvertising(&client1_, advertising_connection_listener_);
+    StartDiscovery(&client, discovery_listener_);
+    OnDiscoveryEndpointFound(&client, advertising_endpoint);
+    OnDiscoveryConnectionInitiated(&client, advertising_endpoint);
+    OnDiscoveryConnectionLocalAccepted(&client, advertising_endpoint);
+    OnDiscoveryConnectionRemoteAccepted(&client, advertising_endpoint);
+    OnDiscoveryConnectionAccepted(&client, advertising_endpoint);
+    // A slow payload listener is not overtaken by the connection listener.
+    EXPECT_CALL(mock_discovery_payload_.payload_cb, Call)
+        .WillOnce(InvokeWithoutArgs(
+            []() { absl::SleepFor(absl::Milliseconds(100)); }));
+    client.OnPayload(advertising_endpoint.id, Payload(payload_bytes_));
+    OnDiscoveryBandwidthChanged(&client, advertising_endpoint);
+    OnDiscoveryConnectionDisconnected(&client, advertising_endpoint);
+    // Destroying |client| runs the callbacks still queued up.
+  }
+  FeatureFlags::GetMutableFlagsForTesting() = saved_flags;
+}
+
 TEST_F(ClientProxyTest, OnPayloadProgressChangesState) {
   Endpoint advertising_endpoint =
       StartAdvertising(&client1_, advertising_connection_listener_);
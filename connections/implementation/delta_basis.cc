@@ -0,0 +1,138 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/delta_basis.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "internal/platform/implementation/platform.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+namespace {
+constexpr std::int64_t kSignReadSize = 1024 * 1024;
+}  // namespace
+
+constexpr char DeltaBasis::kAsideSuffix[];
+
+std::unique_ptr<DeltaBasis> DeltaBasis::Create(const std::string& file_path) {
+  InputFile file(file_path, 0);
+  std::int64_t size = file.GetTotalSize();
+  std::int32_t block_size = block_delta::ChooseBlockSize(size);
+  if (size < block_size) {
+    file.Close();
+    return nullptr;
+  }
+
+  block_delta::SignatureBuilder builder(block_size);
+  std::int64_t signed_size = 0;
+  while (signed_size < size) {
+    ExceptionOr<ByteArray> data = file.Read(kSignReadSize);
+    if (!data.ok() || data.result().Empty()) break;
+    builder.Update(data.result());
+    signed_size += data.result().size();
+  }
+  file.Close();
+  if (signed_size != size) {
+    NEARBY_LOGS(WARNING) << "DeltaBasis failed to read " << file_path
+                         << " after " << signed_size << " of " << size
+                         << " bytes";
+    return nullptr;
+  }
+
+  return absl::WrapUnique(new DeltaBasis(file_path, size, builder.Finish()));
+}
+
+DeltaBasis::DeltaBasis(std::string file_path, std::int64_t size,
+                       block_delta::Signatures signatures)
+    : size_(size),
+      signatures_(std::move(signatures)),
+      file_path_(std::move(file_path)) {}
+
+DeltaBasis::~DeltaBasis() {
+  MutexLock lock(&mutex_);
+  if (file_) file_->Close();
+  if (moved_aside_ &&
+      !api::ImplementationPlatform::RemoveFile(file_path_)) {
+    NEARBY_LOGS(WARNING) << "DeltaBasis failed to delete " << file_path_;
+  }
+}
+
+bool DeltaBasis::MoveAside(const std::string& aside_path) {
+  MutexLock lock(&mutex_);
+  if (moved_aside_) return true;
+  // An open file can not be renamed everywhere.
+  if (file_) {
+    file_->Close();
+    file_.reset();
+  }
+  if (!api::ImplementationPlatform::RenameFile(file_path_, aside_path)) {
+    NEARBY_LOGS(WARNING) << "DeltaBasis failed to move " << file_path_
+                         << " aside";
+    return false;
+  }
+  file_path_ = aside_path;
+  moved_aside_ = true;
+  return true;
+}
+
+ExceptionOr<ByteArray> DeltaBasis::Decode(const ByteArray& delta) {
+  MutexLock lock(&mutex_);
+  return block_delta::Decode(
+      delta, signatures_.block_size, signatures_.blocks.size(),
+      [this](std::int64_t offset, std::int64_t size)
+          ABSL_NO_THREAD_SAFETY_ANALYSIS { return Read(offset, size); });
+}
+
+ExceptionOr<ByteArray> DeltaBasis::Read(std::int64_t offset,
+                                        std::int64_t size) {
+  if (!file_ || offset < position_) {
+    if (file_) file_->Close();
+    file_ = absl::make_unique<InputFile>(file_path_, size_);
+    position_ = 0;
+  }
+  while (position_ < offset) {
+    ExceptionOr<size_t> skipped = file_->Skip(offset - position_);
+    if (!skipped.ok() || skipped.result() == 0) {
+      return ExceptionOr<ByteArray>(Exception::kIo);
+    }
+    position_ += skipped.result();
+  }
+
+  std::string bytes;
+  while (static_cast<std::int64_t>(bytes.size()) < size) {
+    ExceptionOr<ByteArray> data = file_->Read(size - bytes.size());
+    if (!data.ok() || data.result().Empty()) {
+      return ExceptionOr<ByteArray>(Exception::kIo);
+    }
+    position_ += data.result().size();
+    // Reads of the whole size, the usual case, are returned as they are.
+    if (bytes.empty() &&
+        static_cast<std::int64_t>(data.result().size()) == size) {
+      return data;
+    }
+    bytes.append(data.result().data(), data.result().size());
+  }
+  return ExceptionOr<ByteArray>(ByteArray(std::move(bytes)));
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
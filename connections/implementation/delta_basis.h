@@ -0,0 +1,85 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_DELTA_BASIS_H_
+#define CORE_INTERNAL_DELTA_BASIS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "connections/implementation/block_delta.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/file.h"
+#include "internal/platform/mutex.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// The file that the receiver of a FILE payload wrote when it received that
+// payload before, eg. in an earlier or interrupted transfer of it, for the
+// payload to be sent as a delta against (see block_delta.h).
+//
+// The file is signed where it is. Writing the payload truncates it, so it is
+// moved aside before the payload starts, and deleted once no longer needed;
+// the blocks that deltas refer to are read from wherever it is.
+class DeltaBasis {
+ public:
+  // Ends the names of files moved aside.
+  static constexpr char kAsideSuffix[] = ".basis";
+
+  // Signs the file at |file_path|. Returns null if there is no file at
+  // |file_path| with at least a block in it, or if it could not be read.
+  static std::unique_ptr<DeltaBasis> Create(const std::string& file_path);
+  // Deletes the file, if it was moved aside.
+  ~DeltaBasis();
+
+  const block_delta::Signatures& GetSignatures() const { return signatures_; }
+
+  // Renames the file to |aside_path|, out of the way of the payload that is
+  // written to its path. Returns false if it could not be renamed.
+  bool MoveAside(const std::string& aside_path) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the payload bytes that |delta| stands for.
+  ExceptionOr<ByteArray> Decode(const ByteArray& delta)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  DeltaBasis(std::string file_path, std::int64_t size,
+             block_delta::Signatures signatures);
+
+  // Returns |size| bytes of the file at |offset|.
+  ExceptionOr<ByteArray> Read(std::int64_t offset, std::int64_t size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::int64_t size_;
+  const block_delta::Signatures signatures_;
+
+  Mutex mutex_;
+  std::string file_path_ ABSL_GUARDED_BY(mutex_);
+  bool moved_aside_ ABSL_GUARDED_BY(mutex_) = false;
+  // Reopened to read blocks before |position_|; deltas mostly refer to blocks
+  // in order.
+  std::unique_ptr<InputFile> file_ ABSL_GUARDED_BY(mutex_);
+  std::int64_t position_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_DELTA_BASIS_H_
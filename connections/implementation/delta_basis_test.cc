@@ -0,0 +1,112 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/delta_basis.h"
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "internal/platform/file.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr std::int32_t kBlockSize = block_delta::kMinBlockSize;
+constexpr int kNumBlocks = 8;
+
+std::string MakeRandom(std::size_t size) {
+  std::mt19937 generator(42);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes) byte = static_cast<char>(generator());
+  return bytes;
+}
+
+void WriteFile(const std::string& path, const std::string& contents) {
+  OutputFile file(path);
+  EXPECT_TRUE(file.Write(ByteArray(contents)).Ok());
+  EXPECT_TRUE(file.Close().Ok());
+}
+
+std::int64_t GetFileSize(const std::string& path) {
+  InputFile file(path, 0);
+  std::int64_t size = file.GetTotalSize();
+  file.Close();
+  return size;
+}
+
+class DeltaBasisTest : public ::testing::Test {
+ protected:
+  std::string path_ = absl::StrCat(::testing::TempDir(), "/delta_basis_test");
+  std::string aside_path_ = path_ + DeltaBasis::kAsideSuffix;
+};
+
+TEST_F(DeltaBasisTest, NeedsAFullBlock) {
+  WriteFile(path_, std::string(kBlockSize - 1, 'x'));
+
+  EXPECT_EQ(DeltaBasis::Create(path_), nullptr);
+  EXPECT_EQ(DeltaBasis::Create(path_ + ".missing"), nullptr);
+}
+
+TEST_F(DeltaBasisTest, DecodesFromFileMovedAside) {
+  std::string basis = MakeRandom(kBlockSize * kNumBlocks);
+  WriteFile(path_, basis);
+  std::unique_ptr<DeltaBasis> delta_basis = DeltaBasis::Create(path_);
+  ASSERT_NE(delta_basis, nullptr);
+  ASSERT_EQ(delta_basis->GetSignatures().blocks.size(), kNumBlocks);
+  // The incoming payload truncates the file, once it is out of the way.
+  ASSERT_TRUE(delta_basis->MoveAside(aside_path_));
+  WriteFile(path_, "");
+
+  // The blocks in reverse order, so that the file is read backwards.
+  std::string file;
+  for (int i = kNumBlocks - 1; i >= 0; --i) {
+    file += basis.substr(i * kBlockSize, kBlockSize);
+  }
+  block_delta::DeltaEncoder encoder(delta_basis->GetSignatures());
+  ByteArray delta = encoder.Encode(ByteArray(file), /*last=*/true);
+  ExceptionOr<ByteArray> decoded = delta_basis->Decode(delta);
+
+  EXPECT_LT(delta.size(), 64u);
+  ASSERT_TRUE(decoded.ok());
+  EXPECT_EQ(std::string(decoded.result()), file);
+}
+
+TEST_F(DeltaBasisTest, DeletesOnlyFileMovedAside) {
+  WriteFile(path_, MakeRandom(kBlockSize * kNumBlocks));
+  std::unique_ptr<DeltaBasis> delta_basis = DeltaBasis::Create(path_);
+  ASSERT_NE(delta_basis, nullptr);
+  // Signed in place, not copied.
+  EXPECT_LT(GetFileSize(aside_path_), 0);
+
+  delta_basis.reset();
+  EXPECT_EQ(GetFileSize(path_), kBlockSize * kNumBlocks);
+
+  delta_basis = DeltaBasis::Create(path_);
+  ASSERT_NE(delta_basis, nullptr);
+  ASSERT_TRUE(delta_basis->MoveAside(aside_path_));
+  EXPECT_EQ(GetFileSize(aside_path_), kBlockSize * kNumBlocks);
+  delta_basis.reset();
+
+  EXPECT_LT(GetFileSize(aside_path_), 0);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -26,6 +26,7 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 
 namespace location {
@@ -353,8 +354,17 @@ class ClientRunnable final {
 
 }  // namespace
 
+EncryptionRunner::EncryptionRunner() {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_concurrent_connection_setup) {
+    handshake_executor_ = std::make_unique<MultiThreadExecutor>(
+        flags.connection_setup_concurrency);
+  }
+}
+
 EncryptionRunner::~EncryptionRunner() {
   // Stop all the ongoing Runnables (as gracefully as possible).
+  if (handshake_executor_ != nullptr) handshake_executor_->Shutdown();
   client_executor_.Shutdown();
   server_executor_.Shutdown();
   alarm_executor_.Shutdown();
@@ -364,7 +374,9 @@ void EncryptionRunner::StartServer(
     ClientProxy* client, const std::string& endpoint_id,
     EndpointChannel* endpoint_channel,
     EncryptionRunner::ResultListener&& listener) {
-  server_executor_.Execute(
+  SubmittableExecutor* executor = &server_executor_;
+  if (handshake_executor_ != nullptr) executor = handshake_executor_.get();
+  executor->Execute(
       "encryption-server",
       [runnable{ServerRunnable(client, &alarm_executor_, endpoint_id,
                                endpoint_channel, std::move(listener))}]() {
@@ -376,7 +388,9 @@ void EncryptionRunner::StartClient(
     ClientProxy* client, const std::string& endpoint_id,
     EndpointChannel* endpoint_channel,
     EncryptionRunner::ResultListener&& listener) {
-  client_executor_.Execute(
+  SubmittableExecutor* executor = &client_executor_;
+  if (handshake_executor_ != nullptr) executor = handshake_executor_.get();
+  executor->Execute(
       "encryption-client",
       [runnable{ClientRunnable(client, &alarm_executor_, endpoint_id,
                                endpoint_channel, std::move(listener))}]() {
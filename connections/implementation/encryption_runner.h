@@ -15,6 +15,7 @@
 #ifndef CORE_INTERNAL_ENCRYPTION_RUNNER_H_
 #define CORE_INTERNAL_ENCRYPTION_RUNNER_H_
 
+#include <memory>
 #include <string>
 
 #include "securegcm/ukey2_handshake.h"
@@ -22,6 +23,7 @@
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/listeners.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/scheduled_executor.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -36,7 +38,7 @@ namespace connections {
 // indefinite connection to us.
 class EncryptionRunner {
  public:
-  EncryptionRunner() = default;
+  EncryptionRunner();
   ~EncryptionRunner();
 
   struct ResultListener {
@@ -77,6 +79,9 @@ class EncryptionRunner {
   ScheduledExecutor alarm_executor_;
   SingleThreadExecutor server_executor_;
   SingleThreadExecutor client_executor_;
+  // Runs both server and client handshakes, for several endpoints at once, if
+  // FeatureFlags::enable_concurrent_connection_setup is set.
+  std::unique_ptr<MultiThreadExecutor> handshake_executor_;
 };
 
 }  // namespace connections
@@ -56,6 +56,10 @@ class FakeEndpointChannel : public EndpointChannel {
     write_timestamp_ = SystemClock::ElapsedRealtime();
     return out_ ? out_->Write(data) : Exception{Exception::kIo};
   }
+  Exception WriteLast(const ByteArray& data) override { return Write(data); }
+  Exception WriteUnencrypted(const ByteArray& data) override {
+    return Write(data);
+  }
   void Close() override {
     if (in_) in_->Close();
     if (out_) out_->Close();
@@ -77,13 +81,21 @@ class FakeEndpointChannel : public EndpointChannel {
   std::string GetName() const override { return "fake-channel"; }
   Medium GetMedium() const override { return Medium::BLE; }
   int GetMaxTransmitPacketSize() const override { return 512; }
-  void EnableEncryption(std::shared_ptr<EncryptionContext> context) override {}
+  void EnableEncryption(const EncryptionContexts& contexts,
+                        std::shared_ptr<FrameCipher> cipher) override {}
   void DisableEncryption() override {}
   bool IsPaused() const override { return false; }
   void Pause() override {}
   void Resume() override {}
   absl::Time GetLastReadTimestamp() const override { return read_timestamp_; }
   absl::Time GetLastWriteTimestamp() const override { return write_timestamp_; }
+  bool IsReadable() override { return false; }
+  ExceptionOr<ByteArray> TryRead(PacketMetaData& packet_meta_data) override {
+    return {Exception::kTimeout};
+  }
+  bool SetReadinessListener(std::function<void()> listener) override {
+    return false;
+  }
   void SetAnalyticsRecorder(analytics::AnalyticsRecorder* analytics_recorder,
                             const std::string& endpoint_id) override {}
 
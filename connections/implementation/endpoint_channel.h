@@ -16,11 +16,15 @@
 #define CORE_INTERNAL_ENDPOINT_CHANNEL_H_
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "securegcm/d2d_connection_context_v1.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
+#include "connections/implementation/frame_cipher.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/mutex.h"
@@ -37,6 +41,27 @@ class EndpointChannel {
 
   using EncryptionContext = ::securegcm::D2DConnectionContextV1;
 
+  // A context for each direction of an encrypted channel, so that a frame
+  // going out never waits for one coming in to be decoded: the one only
+  // encodes, the other only decodes. The channels that replace this one carry
+  // on with the same contexts.
+  struct EncryptionContexts {
+    // Splits |context| into one for each direction. Returns nulls if it can
+    // not be cloned.
+    static EncryptionContexts Split(std::unique_ptr<EncryptionContext> context) {
+      if (context == nullptr) return {};
+      std::unique_ptr<std::string> session = context->SaveSession();
+      if (session == nullptr) return {};
+      std::shared_ptr<EncryptionContext> decrypt =
+          EncryptionContext::FromSavedSession(*session);
+      if (decrypt == nullptr) return {};
+      return {std::move(context), std::move(decrypt)};
+    }
+
+    std::shared_ptr<EncryptionContext> encrypt;
+    std::shared_ptr<EncryptionContext> decrypt;
+  };
+
   virtual ExceptionOr<ByteArray>
   Read() = 0;  // throws Exception::IO, Exception::INTERRUPTED
 
@@ -47,6 +72,20 @@ class EndpointChannel {
   virtual Exception Write(
       const ByteArray& data,
       PacketMetaData& packet_meta_data) = 0;  // throws Exception::IO
+
+  // Writes |data| as the last ordinary frame on this EndpointChannel: Write()
+  // fails with Exception::kIo from then on. The prior channel of a
+  // make-before-break bandwidth upgrade shares its encryption with the one
+  // that replaced it; a frame written there late, by a writer still holding on
+  // to it, would take a turn of that encryption, or go out in the clear once
+  // encryption is disabled.
+  virtual Exception WriteLast(
+      const ByteArray& data) = 0;  // throws Exception::IO
+
+  // Writes |data| unencrypted, even after WriteLast(). Used for the frames
+  // that shut down the prior channel of a bandwidth upgrade.
+  virtual Exception WriteUnencrypted(
+      const ByteArray& data) = 0;  // throws Exception::IO
   // Closes this EndpointChannel, without tracking the closure in analytics.
 
   virtual void Close() = 0;
@@ -83,8 +122,10 @@ class EndpointChannel {
   // transport.
   virtual int GetMaxTransmitPacketSize() const = 0;
 
-  // Enables encryption on the EndpointChannel.
-  virtual void EnableEncryption(std::shared_ptr<EncryptionContext> context) = 0;
+  // Enables encryption on the EndpointChannel. Frames are sealed with
+  // |cipher| if it is set, and wrapped by |contexts| otherwise.
+  virtual void EnableEncryption(const EncryptionContexts& contexts,
+                                std::shared_ptr<FrameCipher> cipher) = 0;
 
   // Disables encryption on the EndpointChannel.
   virtual void DisableEncryption() = 0;
@@ -107,6 +148,22 @@ class EndpointChannel {
   // writes have occurred.
   virtual absl::Time GetLastWriteTimestamp() const = 0;
 
+  // Returns true if a Read() would find data (or the end of the stream) in the
+  // underlying transport instead of blocking on it.
+  virtual bool IsReadable() = 0;
+
+  // Like Read(), but only reads what the underlying transport has without
+  // blocking (see IsReadable()). While the next frame has not fully arrived,
+  // returns Exception::kTimeout and keeps the bytes read so far; the call that
+  // reads the rest of the frame returns it, as does a Read().
+  virtual ExceptionOr<ByteArray> TryRead(PacketMetaData& packet_meta_data) = 0;
+
+  // Installs |listener| to be called whenever the underlying transport may
+  // have become readable; nullptr removes it. Returns false if the medium can
+  // not signal readiness, in which case the channel has to be serviced by a
+  // dedicated blocking reader.
+  virtual bool SetReadinessListener(std::function<void()> listener) = 0;
+
   // Sets the AnalyticsRecorder instance for analytics.
   virtual void SetAnalyticsRecorder(
       analytics::AnalyticsRecorder* analytics_recorder,
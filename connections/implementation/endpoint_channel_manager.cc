@@ -23,6 +23,7 @@
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 
 namespace location {
 namespace nearby {
@@ -36,6 +37,7 @@ EndpointChannelManager::~EndpointChannelManager() {
   NEARBY_LOG(INFO, "Initiating shutdown of EndpointChannelManager.");
   MutexLock lock(&mutex_);
   channel_state_.DestroyAll();
+  PublishChannelsLocked();
   NEARBY_LOG(INFO, "EndpointChannelManager has shut down.");
 }
 
@@ -48,6 +50,7 @@ void EndpointChannelManager::RegisterChannelForEndpoint(
                     << channel->GetType() << " to endpoint " << endpoint_id;
   SetActiveEndpointChannel(client, endpoint_id, std::move(channel),
                            true /* enable_encryption */);
+  PublishChannelsLocked();
 
   NEARBY_LOG(INFO, "Registered channel: id=%s", endpoint_id.c_str());
 }
@@ -65,30 +68,58 @@ void EndpointChannelManager::ReplaceChannelForEndpoint(
   }
   SetActiveEndpointChannel(client, endpoint_id, std::move(channel),
                            enable_encryption);
+  PublishChannelsLocked();
 }
 
 bool EndpointChannelManager::EncryptChannelForEndpoint(
-    const std::string& endpoint_id,
-    std::unique_ptr<EncryptionContext> context) {
+    const std::string& endpoint_id, std::unique_ptr<EncryptionContext> context,
+    std::unique_ptr<FrameCipher> cipher) {
   MutexLock lock(&mutex_);
 
-  channel_state_.UpdateEncryptionContextForEndpoint(endpoint_id,
-                                                    std::move(context));
+  channel_state_.UpdateEncryptionContextForEndpoint(
+      endpoint_id, std::move(context), std::move(cipher));
   auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
   return channel_state_.EncryptChannel(endpoint);
 }
 
 std::shared_ptr<EndpointChannel> EndpointChannelManager::GetChannelForEndpoint(
-    const std::string& endpoint_id) {
-  MutexLock lock(&mutex_);
-
-  auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
-  if (endpoint == nullptr) {
+    const std::string& endpoint_id) const {
+  auto channels = channels_.Read();
+  auto item = channels->find(endpoint_id);
+  if (item == channels->end()) {
     NEARBY_LOGS(INFO) << "No channel info for endpoint " << endpoint_id;
     return {};
   }
 
-  return endpoint->channel;
+  return item->second;
+}
+
+void EndpointChannelManager::VisitChannelForEndpoint(
+    const std::string& endpoint_id,
+    absl::FunctionRef<void(EndpointChannel*)> visitor) const {
+  auto channels = channels_.Read();
+  auto item = channels->find(endpoint_id);
+  visitor(item != channels->end() ? item->second.get() : nullptr);
+}
+
+bool EndpointChannelManager::WaitForChannelReplacement(
+    const std::string& endpoint_id, const EndpointChannel* channel,
+    absl::Duration timeout) {
+  absl::Time deadline = SystemClock::ElapsedRealtime() + timeout;
+  MutexLock lock(&mutex_);
+  while (true) {
+    std::shared_ptr<EndpointChannel> current =
+        GetChannelForEndpoint(endpoint_id);
+    if (current.get() != channel) return current != nullptr;
+    absl::Duration remaining = deadline - SystemClock::ElapsedRealtime();
+    if (remaining <= absl::ZeroDuration()) return false;
+    channels_changed_.Wait(remaining);
+  }
+}
+
+void EndpointChannelManager::PublishChannelsLocked() {
+  channels_.Update(channel_state_.GetChannels());
+  channels_changed_.Notify();
 }
 
 void EndpointChannelManager::SetActiveEndpointChannel(
@@ -120,13 +151,25 @@ bool EndpointChannelManager::isWifiLanConnected() const {
 bool EndpointChannelManager::ChannelState::EncryptChannel(
     EndpointChannelManager::ChannelState::EndpointData* endpoint) {
   if (endpoint != nullptr && endpoint->channel != nullptr &&
-      endpoint->context != nullptr) {
-    endpoint->channel->EnableEncryption(endpoint->context);
+      endpoint->IsEncrypted()) {
+    endpoint->channel->EnableEncryption(endpoint->contexts, endpoint->cipher);
     return true;
   }
   return false;
 }
 
+std::unique_ptr<EndpointChannelManager::ChannelTable>
+EndpointChannelManager::ChannelState::GetChannels() const {
+  auto channels = std::make_unique<ChannelTable>();
+  channels->reserve(endpoints_.size());
+  for (const auto& item : endpoints_) {
+    if (item.second.channel != nullptr) {
+      channels->emplace(item.first, item.second.channel);
+    }
+  }
+  return channels;
+}
+
 EndpointChannelManager::ChannelState::EndpointData*
 EndpointChannelManager::ChannelState::LookupEndpointData(
     const std::string& endpoint_id) {
@@ -141,10 +184,13 @@ void EndpointChannelManager::ChannelState::UpdateChannelForEndpoint(
 }
 
 void EndpointChannelManager::ChannelState::UpdateEncryptionContextForEndpoint(
-    const std::string& endpoint_id,
-    std::unique_ptr<EncryptionContext> context) {
+    const std::string& endpoint_id, std::unique_ptr<EncryptionContext> context,
+    std::unique_ptr<FrameCipher> cipher) {
   // Create EndpointData instance, if necessary, and populate crypto context.
-  endpoints_[endpoint_id].context = std::move(context);
+  EndpointData& endpoint = endpoints_[endpoint_id];
+  endpoint.contexts =
+      EndpointChannel::EncryptionContexts::Split(std::move(context));
+  endpoint.cipher = std::move(cipher);
 }
 
 bool EndpointChannelManager::ChannelState::RemoveEndpoint(
@@ -193,6 +239,7 @@ bool EndpointChannelManager::UnregisterChannelForEndpoint(
           proto::connections::DisconnectionReason::LOCAL_DISCONNECTION)) {
     return false;
   }
+  PublishChannelsLocked();
 
   NEARBY_LOGS(INFO)
       << "EndpointChannelManager unregistered channel for endpoint "
@@ -20,8 +20,13 @@
 
 #include "securegcm/d2d_connection_context_v1.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/time/time.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
+#include "connections/implementation/frame_cipher.h"
+#include "connections/implementation/rcu_pointer.h"
+#include "internal/platform/condition_variable.h"
 #include "internal/platform/mutex.h"
 
 namespace location {
@@ -42,6 +47,13 @@ namespace connections {
 
 // Manages the communication channels to all the remote endpoints with which we
 // are interacting.
+//
+// Channels are looked up far more often than they change, so lookups do not
+// take |mutex_|: every change publishes a new snapshot of the endpoint to
+// channel table, which readers see through an RcuPointer. A snapshot (and the
+// channels it refers to) outlives every lookup that started while it was
+// current, so a channel swapped out by a bandwidth upgrade stays valid for
+// the writes already in flight on it.
 class EndpointChannelManager final {
  public:
   using EncryptionContext = EndpointChannel::EncryptionContext;
@@ -65,8 +77,12 @@ class EndpointChannelManager final {
                                  bool enable_encryption)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Encrypts the channels of an endpoint with |context|, from now on, split
+  // into one for each direction. If |cipher| is set, frames are sealed with it
+  // instead; see FrameCipher. Returns false if |context| could not be split.
   bool EncryptChannelForEndpoint(const std::string& endpoint_id,
-                                 std::unique_ptr<EncryptionContext> context)
+                                 std::unique_ptr<EncryptionContext> context,
+                                 std::unique_ptr<FrameCipher> cipher)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
   // NOTE(shared_ptr<> usage):
@@ -86,8 +102,26 @@ class EndpointChannelManager final {
   // If EndpointChannelManager replaces the current channel, and any (or both)
   // EndpointManager methods that use a channel are running, it is better to
   // have a shared ownership.
+  //
+  // Does not block on registrations or replacements in progress.
   std::shared_ptr<EndpointChannel> GetChannelForEndpoint(
-      const std::string& endpoint_id) ABSL_LOCKS_EXCLUDED(mutex_);
+      const std::string& endpoint_id) const;
+
+  // Runs |visitor| with the current channel of |endpoint_id|, or with nullptr
+  // if there is none, without taking a lock or a reference on the channel.
+  // For short, non-blocking queries: |visitor| must not keep the pointer, nor
+  // call back into EndpointChannelManager.
+  void VisitChannelForEndpoint(
+      const std::string& endpoint_id,
+      absl::FunctionRef<void(EndpointChannel*)> visitor) const;
+
+  // Waits until the channel of |endpoint_id| is no longer |channel|, for at
+  // most |timeout|. Returns true if another channel took its place; false if
+  // the endpoint has no channel anymore, or on timeout.
+  bool WaitForChannelReplacement(const std::string& endpoint_id,
+                                 const EndpointChannel* channel,
+                                 absl::Duration timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Returns true if 'endpoint_id' actually had a registered EndpointChannel.
   // IOW, a return of false signifies a no-op.
@@ -100,6 +134,10 @@ class EndpointChannelManager final {
   bool isWifiLanConnected() const ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
+  // Endpoint ID -> channel, as published to lookups.
+  using ChannelTable =
+      absl::flat_hash_map<std::string, std::shared_ptr<EndpointChannel>>;
+
   // Tracks channel state for all endpoints. This includes what EndpointChannel
   // the endpoint is currently using and whether or not the EndpointChannel has
   // been encrypted yet.
@@ -115,11 +153,13 @@ class EndpointChannelManager final {
         }
       }
 
-      // True if we have a 'context' for the endpoint.
-      bool IsEncrypted() const { return context != nullptr; }
+      // True if we have 'contexts' for the endpoint.
+      bool IsEncrypted() const { return contexts.encrypt != nullptr; }
 
       std::shared_ptr<EndpointChannel> channel;
-      std::shared_ptr<EncryptionContext> context;
+      EndpointChannel::EncryptionContexts contexts;
+      // Null unless both sides support the frame cipher.
+      std::shared_ptr<FrameCipher> cipher;
       proto::connections::DisconnectionReason disconnect_reason =
           proto::connections::DisconnectionReason::UNKNOWN_DISCONNECTION_REASON;
     };
@@ -139,11 +179,12 @@ class EndpointChannelManager final {
     void UpdateChannelForEndpoint(const std::string& endpoint_id,
                                   std::unique_ptr<EndpointChannel> channel);
 
-    // Stores a new EncryptionContext for the endpoint.
-    // Prevoius one is destroyed, if it existed.
+    // Stores a new EncryptionContext and FrameCipher for the endpoint.
+    // Prevoius ones are destroyed, if they existed.
     void UpdateEncryptionContextForEndpoint(
         const std::string& endpoint_id,
-        std::unique_ptr<EncryptionContext> context);
+        std::unique_ptr<EncryptionContext> context,
+        std::unique_ptr<FrameCipher> cipher);
 
     // Removes all knowledge of this endpoint, cleaning up as necessary.
     // Returns false if the endpoint was not found.
@@ -151,6 +192,8 @@ class EndpointChannelManager final {
                         proto::connections::DisconnectionReason reason);
 
     bool EncryptChannel(EndpointData* endpoint);
+    // Returns the current channel of every endpoint that has one.
+    std::unique_ptr<ChannelTable> GetChannels() const;
     int GetConnectedEndpointsCount() const { return endpoints_.size(); }
     bool isWifiLanConnected() const;
 
@@ -166,8 +209,16 @@ class EndpointChannelManager final {
                                 bool enable_encryption)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Publishes the channels in |channel_state_| to lookups. Returns once no
+  // lookup can see the previous snapshot anymore.
+  void PublishChannelsLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   mutable Mutex mutex_;
+  // Notified whenever a new snapshot of the channels is published.
+  ConditionVariable channels_changed_{&mutex_};
   ChannelState channel_state_ ABSL_GUARDED_BY(mutex_);
+  // Written under |mutex_|; read without it.
+  RcuPointer<ChannelTable> channels_{std::make_unique<ChannelTable>()};
 };
 
 }  // namespace connections
@@ -14,10 +14,12 @@
 
 #include "connections/implementation/endpoint_channel_manager.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "securegcm/d2d_connection_context_v1.h"
 #include "securegcm/ukey2_handshake.h"
@@ -203,13 +205,15 @@ TEST(BaseEndpointChannelManagerTest, RegisterChannelEncryptedReadwrite) {
 
   EndpointChannelManager ecm_a;
   ecm_a.EncryptChannelForEndpoint(std::string(kEndpointId),
-                                  std::move(context.first));
+                                  std::move(context.first),
+                                  /*cipher=*/nullptr);
   ecm_a.RegisterChannelForEndpoint(&proxy_a, std::string(kEndpointId),
                                    std::move(channel_a));
 
   EndpointChannelManager ecm_b;
   ecm_b.EncryptChannelForEndpoint(std::string(kEndpointId),
-                                  std::move(context.second));
+                                  std::move(context.second),
+                                  /*cipher=*/nullptr);
   ecm_b.RegisterChannelForEndpoint(&proxy_b, std::string(kEndpointId),
                                    std::move(channel_b));
 
@@ -274,13 +278,15 @@ TEST(BaseEndpointChannelManagerTest, ReplaceChannelNoEncrypted) {
 
   EndpointChannelManager ecm_a;
   ecm_a.EncryptChannelForEndpoint(std::string(kEndpointId),
-                                  std::move(context.first));
+                                  std::move(context.first),
+                                  /*cipher=*/nullptr);
   ecm_a.ReplaceChannelForEndpoint(&proxy_a, std::string(kEndpointId),
                                   std::move(channel_a), false);
 
   EndpointChannelManager ecm_b;
   ecm_b.EncryptChannelForEndpoint(std::string(kEndpointId),
-                                  std::move(context.second));
+                                  std::move(context.second),
+                                  /*cipher=*/nullptr);
   ecm_b.ReplaceChannelForEndpoint(&proxy_b, std::string(kEndpointId),
                                   std::move(channel_b), false);
 
@@ -292,6 +298,102 @@ TEST(BaseEndpointChannelManagerTest, ReplaceChannelNoEncrypted) {
   channel_b_raw->Close(DisconnectionReason::REMOTE_DISCONNECTION);
 }
 
+TEST(BaseEndpointChannelManagerTest, LookupsSeeEveryReplacedChannel) {
+  constexpr int kReplacements = 200;
+  ClientProxy proxy;
+  std::vector<std::unique_ptr<Pipe>> pipes;
+  for (int i = 0; i <= kReplacements; ++i) {
+    pipes.push_back(std::make_unique<Pipe>());
+  }
+  auto make_channel = [&pipes](int i) {
+    auto channel = std::make_unique<testing::NiceMock<MockEndpointChannel>>(
+        &pipes[i]->GetInputStream(), &pipes[i]->GetOutputStream());
+    ON_CALL(*channel, GetMedium).WillByDefault([]() {
+      return Medium::WIFI_LAN;
+    });
+    return channel;
+  };
+  EndpointChannelManager ecm;
+  ecm.RegisterChannelForEndpoint(&proxy, std::string(kEndpointId),
+                                 make_channel(0));
+
+  std::atomic_bool done = false;
+  std::atomic_int lookups = 0;
+  std::atomic_int misses = 0;
+  MultiThreadExecutor executor(2);
+  CountDownLatch readers_done(2);
+  for (int i = 0; i < 2; ++i) {
+    executor.Execute([&]() {
+      while (!done) {
+        std::shared_ptr<EndpointChannel> channel =
+            ecm.GetChannelForEndpoint(std::string(kEndpointId));
+        if (channel == nullptr || channel->GetMedium() != Medium::WIFI_LAN) {
+          ++misses;
+        }
+        ecm.VisitChannelForEndpoint(
+            std::string(kEndpointId), [&misses](EndpointChannel* channel) {
+              if (channel == nullptr ||
+                  channel->GetMedium() != Medium::WIFI_LAN) {
+                ++misses;
+              }
+            });
+        ++lookups;
+      }
+      readers_done.CountDown();
+    });
+  }
+
+  for (int i = 1; i <= kReplacements; ++i) {
+    ecm.ReplaceChannelForEndpoint(&proxy, std::string(kEndpointId),
+                                  make_channel(i), false);
+  }
+  done = true;
+  EXPECT_TRUE(readers_done.Await(absl::Seconds(5)).result());
+
+  EXPECT_GT(lookups, 0);
+  EXPECT_EQ(misses, 0);
+  EXPECT_EQ(ecm.GetConnectedEndpointsCount(), 1);
+  EXPECT_TRUE(ecm.UnregisterChannelForEndpoint(std::string(kEndpointId)));
+  EXPECT_EQ(ecm.GetChannelForEndpoint(std::string(kEndpointId)), nullptr);
+}
+
+TEST(BaseEndpointChannelManagerTest, WaitForChannelReplacement) {
+  ClientProxy proxy;
+  Pipe pipe_a;
+  Pipe pipe_b;
+  auto channel_a = std::make_unique<testing::NiceMock<MockEndpointChannel>>(
+      &pipe_a.GetInputStream(), &pipe_a.GetOutputStream());
+  auto channel_b = std::make_unique<testing::NiceMock<MockEndpointChannel>>(
+      &pipe_b.GetInputStream(), &pipe_b.GetOutputStream());
+  EndpointChannel* channel_a_raw = channel_a.get();
+  EndpointChannelManager ecm;
+  ecm.RegisterChannelForEndpoint(&proxy, std::string(kEndpointId),
+                                 std::move(channel_a));
+
+  // Times out while the channel stays the same.
+  EXPECT_FALSE(ecm.WaitForChannelReplacement(
+      std::string(kEndpointId), channel_a_raw, absl::Milliseconds(10)));
+
+  MultiThreadExecutor executor(1);
+  CountDownLatch replaced(1);
+  executor.Execute([&]() {
+    EXPECT_TRUE(ecm.WaitForChannelReplacement(
+        std::string(kEndpointId), channel_a_raw, absl::Seconds(5)));
+    replaced.CountDown();
+  });
+  ecm.ReplaceChannelForEndpoint(&proxy, std::string(kEndpointId),
+                                std::move(channel_b), false);
+  EXPECT_TRUE(replaced.Await(absl::Seconds(5)).result());
+
+  // The endpoint going away ends the wait too, with nothing to move on to.
+  std::shared_ptr<EndpointChannel> channel_b_shared =
+      ecm.GetChannelForEndpoint(std::string(kEndpointId));
+  EXPECT_TRUE(ecm.UnregisterChannelForEndpoint(std::string(kEndpointId)));
+  EXPECT_FALSE(ecm.WaitForChannelReplacement(std::string(kEndpointId),
+                                             channel_b_shared.get(),
+                                             absl::Seconds(5)));
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "connections/implementation/analytics/link_quality_estimator.h"
 #include "connections/implementation/analytics/throughput_recorder.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/offline_frames.h"
@@ -28,6 +29,7 @@
 #include "connections/implementation/service_id_constants.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 
@@ -37,6 +39,7 @@ namespace connections {
 
 constexpr absl::Duration EndpointManager::kProcessEndpointDisconnectionTimeout;
 constexpr absl::Time EndpointManager::kInvalidTimestamp;
+constexpr absl::Duration EndpointManager::kMaxKeepAliveAckDelay;
 
 class EndpointManager::LockedFrameProcessor {
  public:
@@ -169,59 +172,113 @@ ExceptionOr<bool> EndpointManager::HandleData(
   // a replacement for this endpoint since we last checked with the
   // EndpointChannelManager.
   while (true) {
-    PacketMetaData packet_meta_data;
-    ExceptionOr<ByteArray> bytes = endpoint_channel->Read(packet_meta_data);
-    if (!bytes.ok()) {
-      NEARBY_LOG(INFO, "Stop reading on read-time exception: %d",
-                 bytes.exception());
+    ExceptionOr<bool> result =
+        HandleFrame(endpoint_id, client, endpoint_channel);
+    if (!result.ok()) {
+      return result;
+    }
+  }
+}
+
+ExceptionOr<bool> EndpointManager::HandleFrame(
+    const std::string& endpoint_id, ClientProxy* client,
+    EndpointChannel* endpoint_channel, absl::Duration* replacement_timeout) {
+  PacketMetaData packet_meta_data;
+  ExceptionOr<ByteArray> bytes =
+      replacement_timeout != nullptr
+          ? endpoint_channel->TryRead(packet_meta_data)
+          : endpoint_channel->Read(packet_meta_data);
+  if (!bytes.ok()) {
+    // The frame has not fully arrived yet; nothing to stop for.
+    if (replacement_timeout != nullptr &&
+        bytes.GetException().Raised(Exception::kTimeout)) {
       return ExceptionOr<bool>(bytes.exception());
     }
-    ExceptionOr<OfflineFrame> wrapped_frame = parser::FromBytes(bytes.result());
-    if (!wrapped_frame.ok()) {
-      if (wrapped_frame.GetException().Raised(
-              Exception::kInvalidProtocolBuffer)) {
-        NEARBY_LOG(INFO, "Failed to decode; endpoint=%s; channel=%s; skip",
-                   endpoint_id.c_str(), endpoint_channel->GetType().c_str());
-        continue;
-      } else {
-        NEARBY_LOG(INFO, "Stop reading on parse-time exception: %d",
-                   wrapped_frame.exception());
-        return ExceptionOr<bool>(wrapped_frame.exception());
-      }
+    NEARBY_LOG(INFO, "Stop reading on read-time exception: %d",
+               bytes.exception());
+    return ExceptionOr<bool>(bytes.exception());
+  }
+  ExceptionOr<OfflineFrame> wrapped_frame = parser::FromBytes(bytes.result());
+  if (!wrapped_frame.ok()) {
+    if (wrapped_frame.GetException().Raised(
+            Exception::kInvalidProtocolBuffer)) {
+      NEARBY_LOG(INFO, "Failed to decode; endpoint=%s; channel=%s; skip",
+                 endpoint_id.c_str(), endpoint_channel->GetType().c_str());
+      return ExceptionOr<bool>(true);
+    } else {
+      NEARBY_LOG(INFO, "Stop reading on parse-time exception: %d",
+                 wrapped_frame.exception());
+      return ExceptionOr<bool>(wrapped_frame.exception());
     }
-    OfflineFrame& frame = wrapped_frame.result();
-
-    // Route the incoming offlineFrame to its registered processor.
-    V1Frame::FrameType frame_type = parser::GetFrameType(frame);
-    LockedFrameProcessor frame_processor = GetFrameProcessor(frame_type);
-    if (!frame_processor) {
-      // report messages without handlers, except KEEP_ALIVE, which has
-      // no explicit handler.
-      if (frame_type == V1Frame::KEEP_ALIVE) {
-        NEARBY_LOG(INFO, "KeepAlive message for endpoint %s",
-                   endpoint_id.c_str());
-      } else if (frame_type == V1Frame::DISCONNECTION) {
-        NEARBY_LOG(INFO, "Disconnect message for endpoint %s",
-                   endpoint_id.c_str());
-        endpoint_channel->Close();
-      } else {
-        NEARBY_LOGS(ERROR) << "Unhandled message: endpoint_id=" << endpoint_id
-                           << ", frame type="
-                           << V1Frame::FrameType_Name(frame_type);
+  }
+  OfflineFrame& frame = wrapped_frame.result();
+
+  // Route the incoming offlineFrame to its registered processor.
+  V1Frame::FrameType frame_type = parser::GetFrameType(frame);
+  LockedFrameProcessor frame_processor = GetFrameProcessor(frame_type);
+  if (!frame_processor) {
+    // report messages without handlers, except KEEP_ALIVE, which has
+    // no explicit handler.
+    if (frame_type == V1Frame::KEEP_ALIVE) {
+      NEARBY_LOG(INFO, "KeepAlive message for endpoint %s",
+                 endpoint_id.c_str());
+      if (enable_keep_alive_rtt_probes_) {
+        if (frame.v1().keep_alive().ack()) {
+          analytics::LinkQualityEstimator::GetInstance().OnProbeAcked(
+              endpoint_id, endpoint_channel->GetMedium());
+        } else {
+          // Not written from here, so that reading does not wait for the
+          // write; and written to the current channel, which the ack may
+          // have to go to if the probe came in over one being replaced.
+          PostKeepAliveWrite(client, endpoint_id, /*ack=*/true,
+                             kMaxKeepAliveAckDelay);
+        }
       }
-      continue;
+    } else if (frame_type == V1Frame::DISCONNECTION) {
+      NEARBY_LOG(INFO, "Disconnect message for endpoint %s",
+                 endpoint_id.c_str());
+      endpoint_channel->Close();
+    } else {
+      NEARBY_LOGS(ERROR) << "Unhandled message: endpoint_id=" << endpoint_id
+                         << ", frame type="
+                         << V1Frame::FrameType_Name(frame_type);
     }
+    return ExceptionOr<bool>(true);
+  }
 
-    frame_processor->OnIncomingFrame(frame, endpoint_id, client,
-                                     endpoint_channel->GetMedium(),
-                                     packet_meta_data);
+  frame_processor->OnIncomingFrame(frame, endpoint_id, client,
+                                   endpoint_channel->GetMedium(),
+                                   packet_meta_data);
+
+  // After a make-before-break LAST_WRITE, the remote device writes on the
+  // upgraded channel only. Move on to it as soon as it is ours too, and leave
+  // the rest of the prior channel to BwuManager, which drains it.
+  if (frame_type == V1Frame::BANDWIDTH_UPGRADE_NEGOTIATION) {
+    const auto& bwu_frame = frame.v1().bandwidth_upgrade_negotiation();
+    if (bwu_frame.event_type() ==
+            BandwidthUpgradeNegotiationFrame::LAST_WRITE_TO_PRIOR_CHANNEL &&
+        bwu_frame.last_write_info().make_before_break()) {
+      absl::Duration drain_timeout = FeatureFlags::GetInstance()
+                                         .GetFlags()
+                                         .make_before_break_drain_timeout;
+      if (replacement_timeout != nullptr) {
+        *replacement_timeout = drain_timeout;
+      } else if (!channel_manager_->WaitForChannelReplacement(
+                     endpoint_id, endpoint_channel, drain_timeout)) {
+        NEARBY_LOGS(WARNING)
+            << "Upgraded channel did not take over in time; endpoint_id="
+            << endpoint_id;
+      }
+      return ExceptionOr<bool>(Exception::kIo);
+    }
   }
+  return ExceptionOr<bool>(true);
 }
 
-ExceptionOr<bool> EndpointManager::HandleKeepAlive(
+ExceptionOr<absl::Duration> EndpointManager::HandleKeepAlive(
+    ClientProxy* client, const std::string& endpoint_id,
     EndpointChannel* endpoint_channel, absl::Duration keep_alive_interval,
-    absl::Duration keep_alive_timeout, Mutex* keep_alive_waiter_mutex,
-    ConditionVariable* keep_alive_waiter) {
+    absl::Duration keep_alive_timeout) {
   // Check if it has been too long since we received a frame from our endpoint.
   absl::Time last_read_time = endpoint_channel->GetLastReadTimestamp();
   absl::Duration duration_until_timeout =
@@ -230,13 +287,13 @@ ExceptionOr<bool> EndpointManager::HandleKeepAlive(
           : last_read_time + keep_alive_timeout -
                 SystemClock::ElapsedRealtime();
   if (duration_until_timeout <= absl::ZeroDuration()) {
-    return ExceptionOr<bool>(false);
+    return ExceptionOr<absl::Duration>(Exception::kTimeout);
   }
 
-  // If we haven't written anything to the endpoint for a while, attempt to send
-  // the KeepAlive frame over the endpoint channel. If the write fails, our
-  // super class will loop back around and try our luck again in case there's
-  // been a replacement for this endpoint.
+  // If we haven't written anything to the endpoint for a while, have the
+  // KeepAlive frame sent. A paused channel holds writes until the bandwidth
+  // upgrade that paused it is done, and the remote device knows to expect
+  // silence meanwhile, so it is skipped until the next check.
   absl::Time last_write_time = endpoint_channel->GetLastWriteTimestamp();
   absl::Duration duration_until_write_keep_alive =
       last_write_time == kInvalidTimestamp
@@ -244,24 +301,101 @@ ExceptionOr<bool> EndpointManager::HandleKeepAlive(
           : last_write_time + keep_alive_interval -
                 SystemClock::ElapsedRealtime();
   if (duration_until_write_keep_alive <= absl::ZeroDuration()) {
-    Exception write_exception = endpoint_channel->Write(parser::ForKeepAlive());
-    if (!write_exception.Ok()) {
-      return ExceptionOr<bool>(write_exception);
+    if (!endpoint_channel->IsPaused()) {
+      PostKeepAliveWrite(client, endpoint_id, /*ack=*/false,
+                         keep_alive_interval);
     }
     duration_until_write_keep_alive = keep_alive_interval;
   }
 
-  absl::Duration wait_for =
-      std::min(duration_until_timeout, duration_until_write_keep_alive);
+  return ExceptionOr<absl::Duration>(
+      std::min(duration_until_timeout, duration_until_write_keep_alive));
+}
+
+void EndpointManager::PostKeepAliveWrite(ClientProxy* client,
+                                         const std::string& endpoint_id,
+                                         bool ack, absl::Duration max_delay) {
+  MutexLock lock(&keep_alive_writes_mutex_);
+  // No writer once the endpoint is gone.
+  auto writer = keep_alive_writers_.find(endpoint_id);
+  if (writer == keep_alive_writers_.end()) return;
+  // The one still waiting, or being written, does just as well.
+  if (!keep_alive_writes_.insert({endpoint_id, ack}).second) return;
+  const absl::Time deadline = SystemClock::ElapsedRealtime() + max_delay;
+  writer->second->Execute(
+      "keep-alive-write", [this, client, endpoint_id, ack, deadline]() {
+        // The channel may have been replaced since the write was posted.
+        std::shared_ptr<EndpointChannel> channel =
+            channel_manager_->GetChannelForEndpoint(endpoint_id);
+        // A write that waited out the interval, behind a blocked write, is
+        // dropped; the next check posts a fresh one.
+        if (channel != nullptr && !channel->IsPaused() &&
+            SystemClock::ElapsedRealtime() <= deadline) {
+          Exception exception = channel->Write(parser::ForKeepAlive(ack));
+          if (exception.Ok()) {
+            if (enable_keep_alive_rtt_probes_ && !ack) {
+              analytics::LinkQualityEstimator::GetInstance().OnProbeSent(
+                  endpoint_id);
+            }
+          } else if (exception.Raised(Exception::kIo)) {
+            // Unless the channel has been replaced in the meantime, there is
+            // no usable channel left.
+            std::shared_ptr<EndpointChannel> current =
+                channel_manager_->GetChannelForEndpoint(endpoint_id);
+            if (current == nullptr ||
+                current->GetMedium() == channel->GetMedium()) {
+              NEARBY_LOGS(INFO) << "KeepAlive write failed for endpoint "
+                                << endpoint_id;
+              DiscardEndpoint(client, endpoint_id);
+            }
+          }
+        }
+        MutexLock lock(&keep_alive_writes_mutex_);
+        keep_alive_writes_.erase({endpoint_id, ack});
+      });
+}
+
+void EndpointManager::RemoveKeepAliveWriter(const std::string& endpoint_id) {
+  std::unique_ptr<SingleThreadExecutor> writer;
   {
-    MutexLock lock(keep_alive_waiter_mutex);
-    Exception wait_exception = keep_alive_waiter->Wait(wait_for);
-    if (!wait_exception.Ok()) {
-      return ExceptionOr<bool>(wait_exception);
-    }
+    MutexLock lock(&keep_alive_writes_mutex_);
+    auto item = keep_alive_writers_.find(endpoint_id);
+    if (item == keep_alive_writers_.end()) return;
+    writer = std::move(item->second);
+    keep_alive_writers_.erase(item);
   }
+  // Waits for the write in progress, if any; the channel has been
+  // unregistered, so it fails shortly.
+  writer->Shutdown();
+  // Writes dropped by the shutdown must not hold up those to an endpoint
+  // registered under the same ID later.
+  MutexLock lock(&keep_alive_writes_mutex_);
+  keep_alive_writes_.erase({endpoint_id, false});
+  keep_alive_writes_.erase({endpoint_id, true});
+}
 
-  return ExceptionOr<bool>(true);
+absl::Duration EndpointManager::CheckKeepAlive(
+    ClientProxy* client, const std::string& endpoint_id,
+    absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout) {
+  // The channel may have been replaced since the last check (for example,
+  // when we upgrade from Bluetooth to Wifi).
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    NEARBY_LOG(INFO, "Endpoint channel is nullptr, bail out.");
+  } else {
+    ExceptionOr<absl::Duration> wait_for =
+        HandleKeepAlive(client, endpoint_id, channel.get(),
+                        keep_alive_interval, keep_alive_timeout);
+    if (wait_for.ok()) {
+      return wait_for.result();
+    }
+    NEARBY_LOGS(INFO) << "KeepAlive timed out for endpoint " << endpoint_id;
+  }
+  // Always clear out all state related to this endpoint once it is no longer
+  // alive.
+  DiscardEndpoint(client, endpoint_id);
+  return absl::InfiniteDuration();
 }
 
 bool operator==(const EndpointManager::FrameProcessor& lhs,
@@ -279,7 +413,25 @@ bool operator<(const EndpointManager::FrameProcessor& lhs,
 }
 
 EndpointManager::EndpointManager(EndpointChannelManager* manager)
-    : channel_manager_(manager) {}
+    : channel_manager_(manager) {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  enable_keep_alive_rtt_probes_ = flags.enable_keep_alive_rtt_probes;
+  if (flags.enable_endpoint_reader_pool) {
+    reader_pool_ =
+        std::make_unique<EndpointReaderPool>(flags.endpoint_reader_pool_size);
+  }
+  if (flags.enable_parallel_fan_out) {
+    fan_out_sender_ = std::make_unique<FanOutSender>(
+        [manager](const std::string& endpoint_id) {
+          return manager->GetChannelForEndpoint(endpoint_id);
+        },
+        [manager](const std::string& endpoint_id,
+                  absl::FunctionRef<void(EndpointChannel*)> visitor) {
+          manager->VisitChannelForEndpoint(endpoint_id, visitor);
+        },
+        flags.fan_out_max_lagging_frames);
+  }
+}
 
 EndpointManager::~EndpointManager() {
   NEARBY_LOG(INFO, "Initiating shutdown of EndpointManager.");
@@ -292,6 +444,17 @@ EndpointManager::~EndpointManager() {
   });
   latch.Await();
 
+  // The channels are closed by now, so a KeepAlive write still blocked on one
+  // fails shortly.
+  absl::flat_hash_map<std::string, std::unique_ptr<SingleThreadExecutor>>
+      keep_alive_writers;
+  {
+    MutexLock lock(&keep_alive_writes_mutex_);
+    keep_alive_writers.swap(keep_alive_writers_);
+  }
+  for (auto& item : keep_alive_writers) {
+    item.second->Shutdown();
+  }
   NEARBY_LOG(INFO, "Bringing down control thread");
   serial_executor_.Shutdown();
   NEARBY_LOG(INFO, "EndpointManager is down");
@@ -366,6 +529,13 @@ void EndpointManager::RemoveEndpointState(const std::string& endpoint_id) {
   } else {
     NEARBY_LOGS(INFO) << "EndpointState not found for endpoint " << endpoint_id;
   }
+  if (fan_out_sender_) {
+    fan_out_sender_->RemoveEndpoint(endpoint_id);
+  }
+  RemoveKeepAliveWriter(endpoint_id);
+  if (enable_keep_alive_rtt_probes_) {
+    analytics::LinkQualityEstimator::GetInstance().ForgetEndpoint(endpoint_id);
+  }
 }
 
 void EndpointManager::RegisterEndpoint(
@@ -414,30 +584,27 @@ void EndpointManager::RegisterEndpoint(
 
     EndpointState& endpoint_state =
         endpoints_
-            .emplace(endpoint_id, EndpointState(endpoint_id, channel_manager_))
+            .emplace(endpoint_id,
+                     EndpointState(endpoint_id, channel_manager_,
+                                   reader_pool_.get(), &keep_alive_scheduler_))
             .first->second;
 
     NEARBY_LOGS(INFO) << "Starting workers: endpoint " << endpoint_id;
-    // For every endpoint, there's normally only one Read handler instance
-    // running on a dedicated thread. This instance reads data from the
-    // endpoint and delegates incoming frames to various FrameProcessors.
-    // Once the frame has been properly handled, it starts reading again for
-    // the next frame. If the handler fails its read and no other
-    // EndpointChannels are available for this endpoint, a disconnection
-    // will be initiated.
-    endpoint_state.StartEndpointReader([this, client, endpoint_id]() {
-      EndpointChannelLoopRunnable(
-          "Read", client, endpoint_id,
-          [this, client, endpoint_id](EndpointChannel* channel) {
-            return HandleData(endpoint_id, client, channel);
-          });
-    });
-
-    // For every endpoint, there's only one KeepAliveManager instance running on
-    // a dedicated thread. This instance will periodically send out a ping* to
+    // Before the reader, which may have to write KeepAlive acks.
+    {
+      MutexLock lock(&keep_alive_writes_mutex_);
+      keep_alive_writers_.emplace(endpoint_id,
+                                  std::make_unique<SingleThreadExecutor>());
+    }
+    StartEndpointReader(endpoint_state, client, endpoint_id);
+
+    // For every endpoint, there's one KeepAlive check scheduled on the shared
+    // KeepAliveScheduler. This check will periodically send out a ping* to
     // the endpoint while listening for an incoming pong**. If it fails to send
     // the ping, or if no pong is heard within keep_alive_timeout, it initiates
-    // a disconnection.
+    // a disconnection. The ping itself is written on a writer thread of the
+    // endpoint's own, so that a blocked write holds up neither the check nor
+    // the writes to other endpoints.
     //
     // (*) Bluetooth requires a constant outgoing stream of messages. If
     // there's silence, Android will break the socket. This is why we ping.
@@ -447,18 +614,10 @@ void EndpointManager::RegisterEndpoint(
     NEARBY_LOGS(VERBOSE) << "EndpointManager enabling KeepAlive for endpoint "
                          << endpoint_id;
     endpoint_state.StartEndpointKeepAliveManager(
-        [this, client, endpoint_id, keep_alive_interval, keep_alive_timeout](
-            Mutex* keep_alive_waiter_mutex,
-            ConditionVariable* keep_alive_waiter) {
-          EndpointChannelLoopRunnable(
-              "KeepAliveManager", client, endpoint_id,
-              [this, keep_alive_interval, keep_alive_timeout,
-               keep_alive_waiter_mutex,
-               keep_alive_waiter](EndpointChannel* channel) {
-                return HandleKeepAlive(
-                    channel, keep_alive_interval, keep_alive_timeout,
-                    keep_alive_waiter_mutex, keep_alive_waiter);
-              });
+        [this, client, endpoint_id, keep_alive_interval,
+         keep_alive_timeout]() {
+          return CheckKeepAlive(client, endpoint_id, keep_alive_interval,
+                                keep_alive_timeout);
         });
     NEARBY_LOGS(INFO) << "Registering endpoint " << endpoint_id
                       << ", workers started and notifying client.";
@@ -472,6 +631,68 @@ void EndpointManager::RegisterEndpoint(
   latch.Await();
 }
 
+void EndpointManager::StartEndpointReader(EndpointState& endpoint_state,
+                                          ClientProxy* client,
+                                          const std::string& endpoint_id) {
+  // With the reader pool, the endpoint is read by whichever pool worker is
+  // free when its channel becomes readable. Frames are still read and
+  // dispatched one at a time, in order, same as on a dedicated thread.
+  bool pooled = endpoint_state.StartPooledEndpointReader({
+      .get_channel_cb =
+          [this, endpoint_id]() {
+            return channel_manager_->GetChannelForEndpoint(endpoint_id);
+          },
+      .read_frame_cb =
+          [this, client, endpoint_id](EndpointChannel* channel,
+                                      absl::Duration* replacement_timeout) {
+            return HandleFrame(endpoint_id, client, channel,
+                               replacement_timeout);
+          },
+      .stopped_cb =
+          [this, client, endpoint_id]() {
+            // Always clear out all state related to this endpoint once there
+            // is nothing left to read from.
+            DiscardEndpoint(client, endpoint_id);
+          },
+      .fallback_cb =
+          [this, client, endpoint_id]() {
+            RunOnEndpointManagerThread(
+                "fallback-endpoint-reader", [this, client, endpoint_id]() {
+                  auto item = endpoints_.find(endpoint_id);
+                  if (item == endpoints_.end() ||
+                      item->second.HasDedicatedReader() ||
+                      reader_pool_->IsRegistered(endpoint_id)) {
+                    return;
+                  }
+                  StartDedicatedEndpointReader(item->second, client,
+                                               endpoint_id);
+                });
+          },
+  });
+  if (!pooled) {
+    StartDedicatedEndpointReader(endpoint_state, client, endpoint_id);
+  }
+}
+
+void EndpointManager::StartDedicatedEndpointReader(
+    EndpointState& endpoint_state, ClientProxy* client,
+    const std::string& endpoint_id) {
+  // For every endpoint, there's normally only one Read handler instance
+  // running on a dedicated thread. This instance reads data from the
+  // endpoint and delegates incoming frames to various FrameProcessors.
+  // Once the frame has been properly handled, it starts reading again for
+  // the next frame. If the handler fails its read and no other
+  // EndpointChannels are available for this endpoint, a disconnection
+  // will be initiated.
+  endpoint_state.StartEndpointReader([this, client, endpoint_id]() {
+    EndpointChannelLoopRunnable(
+        "Read", client, endpoint_id,
+        [this, client, endpoint_id](EndpointChannel* channel) {
+          return HandleData(endpoint_id, client, channel);
+        });
+  });
+}
+
 void EndpointManager::UnregisterEndpoint(ClientProxy* client,
                                          const std::string& endpoint_id) {
   NEARBY_LOGS(INFO) << "UnregisterEndpoint for endpoint " << endpoint_id;
@@ -486,29 +707,46 @@ void EndpointManager::UnregisterEndpoint(ClientProxy* client,
 }
 
 int EndpointManager::GetMaxTransmitPacketSize(const std::string& endpoint_id) {
-  std::shared_ptr<EndpointChannel> channel =
-      channel_manager_->GetChannelForEndpoint(endpoint_id);
-  if (channel == nullptr) {
-    return 0;
-  }
+  int size = 0;
+  channel_manager_->VisitChannelForEndpoint(
+      endpoint_id, [&size](EndpointChannel* channel) {
+        if (channel != nullptr) size = channel->GetMaxTransmitPacketSize();
+      });
+  return size;
+}
 
-  return channel->GetMaxTransmitPacketSize();
+proto::connections::Medium EndpointManager::GetMedium(
+    const std::string& endpoint_id) {
+  proto::connections::Medium medium =
+      proto::connections::Medium::UNKNOWN_MEDIUM;
+  channel_manager_->VisitChannelForEndpoint(
+      endpoint_id, [&medium](EndpointChannel* channel) {
+        if (channel != nullptr) medium = channel->GetMedium();
+      });
+  return medium;
 }
 
 std::vector<std::string> EndpointManager::SendPayloadChunk(
     const PayloadTransferFrame::PayloadHeader& payload_header,
-    const PayloadTransferFrame::PayloadChunk& payload_chunk,
+    PayloadTransferFrame::PayloadChunk payload_chunk,
     const std::vector<std::string>& endpoint_ids,
-    PacketMetaData& packet_meta_data) {
+    PacketMetaData& packet_meta_data,
+    FanOutSender::FrameWrittenCallback on_written,
+    WrittenChannels* written_channels) {
+  std::int64_t offset = payload_chunk.offset();
+  // Nothing may be left in flight once the last chunk has been sent.
+  bool last_chunk =
+      payload_chunk.flags() & PayloadTransferFrame::PayloadChunk::LAST_CHUNK;
   ByteArray bytes =
-      parser::ForDataPayloadTransfer(payload_header, payload_chunk);
+      parser::ForDataPayloadTransfer(payload_header, std::move(payload_chunk));
 
   return SendTransferFrameBytes(
       endpoint_ids, bytes, payload_header.id(),
-      /*offset=*/payload_chunk.offset(),
+      /*offset=*/offset,
       /*packet_type=*/
       PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::DATA),
-      packet_meta_data);
+      packet_meta_data, /*wait_for_all=*/last_chunk, std::move(on_written),
+      written_channels);
 }
 
 // Designed to run asynchronously. It is called from IO thread pools, and
@@ -535,7 +773,7 @@ std::vector<std::string> EndpointManager::SendControlMessage(
       /*offset=*/control.offset(),
       /*packet_type=*/
       PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::CONTROL),
-      packet_meta_data);
+      packet_meta_data, /*wait_for_all=*/true);
 }
 
 // @EndpointManagerThread
@@ -551,7 +789,7 @@ void EndpointManager::RemoveEndpoint(ClientProxy* client,
       channel ? channel->GetServiceId() : std::string(kUnknownServiceId);
 
   // Unregistering from channel_manager_ will also serve to terminate
-  // the dedicated handler and KeepAlive threads we started when we registered
+  // the endpoint reader and KeepAlive check we started when we registered
   // this endpoint.
   if (channel_manager_->UnregisterChannelForEndpoint(endpoint_id)) {
     // Notify all frame processors of the disconnection immediately and wait
@@ -625,13 +863,31 @@ CountDownLatch EndpointManager::NotifyFrameProcessorsOnEndpointDisconnect(
 std::vector<std::string> EndpointManager::SendTransferFrameBytes(
     const std::vector<std::string>& endpoint_ids, const ByteArray& bytes,
     std::int64_t payload_id, std::int64_t offset,
-    const std::string& packet_type, PacketMetaData& packet_meta_data) {
+    const std::string& packet_type, PacketMetaData& packet_meta_data,
+    bool wait_for_all, FanOutSender::FrameWrittenCallback on_written,
+    WrittenChannels* written_channels) {
+  if (fan_out_sender_) {
+    return fan_out_sender_->Send(endpoint_ids, bytes, payload_id,
+                                 packet_meta_data, wait_for_all,
+                                 std::move(on_written));
+  }
+
+  // A frame sent on its own looks its channels up afresh.
+  WrittenChannels unshared;
+  auto& channels =
+      (written_channels ? written_channels : &unshared)->channels_;
   std::vector<std::string> failed_endpoint_ids;
   for (const std::string& endpoint_id : endpoint_ids) {
-    std::shared_ptr<EndpointChannel> channel =
-        channel_manager_->GetChannelForEndpoint(endpoint_id);
-
+    std::shared_ptr<EndpointChannel>& cached = channels[endpoint_id];
+    bool current = false;
+    channel_manager_->VisitChannelForEndpoint(
+        endpoint_id, [&current, &cached](EndpointChannel* channel) {
+          current = channel == cached.get();
+        });
+    if (!current) cached = channel_manager_->GetChannelForEndpoint(endpoint_id);
+    EndpointChannel* channel = cached.get();
     if (channel == nullptr) {
+      channels.erase(endpoint_id);
       // We no longer know about this endpoint (it was either explicitly
       // unregistered, or a read/write error made us unregister it internally).
       NEARBY_LOGS(ERROR) << "EndpointManager failed to find EndpointChannel "
@@ -653,6 +909,7 @@ std::vector<std::string> EndpointManager::SendTransferFrameBytes(
     analytics::ThroughputRecorderContainer::GetInstance()
         .GetTPRecorder(payload_id)
         ->OnFrameSent(channel->GetMedium(), packet_meta_data);
+    if (on_written) on_written(endpoint_id);
   }
 
   return failed_endpoint_ids;
@@ -668,25 +925,35 @@ EndpointManager::EndpointState::~EndpointState() {
     channel_manager_->UnregisterChannelForEndpoint(endpoint_id_);
   }
 
-  // Make sure the KeepAlive thread isn't blocking shutdown.
-  if (keep_alive_waiter_mutex_ && keep_alive_waiter_) {
-    MutexLock lock(keep_alive_waiter_mutex_.get());
-    keep_alive_waiter_->Notify();
+  // The channel is closed by now, so a pool worker still reading from it will
+  // bail out shortly; wait for that to happen.
+  if (reader_pool_) {
+    reader_pool_->Unregister(endpoint_id_);
+  }
+
+  // Drop the KeepAlive check, waiting for it if it is running right now.
+  if (keep_alive_scheduler_) {
+    keep_alive_scheduler_->Cancel(endpoint_id_);
   }
 }
 
 void EndpointManager::EndpointState::StartEndpointReader(Runnable&& runnable) {
-  reader_thread_.Execute("reader", std::move(runnable));
+  if (!reader_thread_) {
+    reader_thread_ = std::make_unique<SingleThreadExecutor>();
+  }
+  reader_thread_->Execute("reader", std::move(runnable));
+}
+
+bool EndpointManager::EndpointState::StartPooledEndpointReader(
+    EndpointReaderPool::Handlers handlers) {
+  if (!reader_pool_) return false;
+  return reader_pool_->Register(endpoint_id_, std::move(handlers));
 }
 
 void EndpointManager::EndpointState::StartEndpointKeepAliveManager(
-    std::function<void(Mutex*, ConditionVariable*)> runnable) {
-  keep_alive_thread_.Execute(
-      "keep-alive",
-      [runnable, keep_alive_waiter_mutex = keep_alive_waiter_mutex_.get(),
-       keep_alive_waiter = keep_alive_waiter_.get()]() {
-        runnable(keep_alive_waiter_mutex, keep_alive_waiter);
-      });
+    KeepAliveScheduler::Task check) {
+  keep_alive_scheduler_->Schedule(endpoint_id_, absl::ZeroDuration(),
+                                  std::move(check));
 }
 
 void EndpointManager::RunOnEndpointManagerThread(const std::string& name,
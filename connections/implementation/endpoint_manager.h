@@ -30,11 +30,15 @@
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
+#include "connections/implementation/endpoint_reader_pool.h"
+#include "connections/implementation/fan_out_sender.h"
+#include "connections/implementation/keep_alive_scheduler.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/listeners.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -59,6 +63,15 @@ namespace connections {
 // chunks) originates on one of those threads before control is transferred over
 // to PayloadManager::ProcessFrame() (still running on that
 // same dedicated reader thread).
+//
+// When FeatureFlags::enable_endpoint_reader_pool is set, endpoints whose
+// channels can signal readiness are instead read by the workers of a shared
+// EndpointReaderPool; everything said above about the dedicated reader thread
+// then applies to the pool worker that services the endpoint.
+//
+// When FeatureFlags::enable_parallel_fan_out is set, the frames of outgoing
+// payloads are written to each endpoint by a FanOutSender, so the writer
+// thread only waits for the fastest of the endpoints it is sending to.
 
 using analytics::PacketMetaData;
 
@@ -93,6 +106,17 @@ class EndpointManager {
                                       CountDownLatch barrier) = 0;
   };
 
+  // The channels that the chunks of an outgoing payload were last written to.
+  // One still current is written to again without copying its shared_ptr;
+  // holding it keeps its address from being taken by another channel. Kept by
+  // the sender of the payload, so the channels are let go with it.
+  class WrittenChannels {
+   private:
+    friend class EndpointManager;
+    absl::flat_hash_map<std::string, std::shared_ptr<EndpointChannel>>
+        channels_;
+  };
+
   explicit EndpointManager(EndpointChannelManager* manager);
   ~EndpointManager();
 
@@ -122,14 +146,22 @@ class EndpointManager {
   // transport.
   int GetMaxTransmitPacketSize(const std::string& endpoint_id);
 
+  // Returns the medium of the endpoint's current channel, or UNKNOWN_MEDIUM.
+  proto::connections::Medium GetMedium(const std::string& endpoint_id);
+
   // Returns the list of endpoints to which sending this chunk failed.
+  // |on_written| is called for each endpoint once it has written the chunk,
+  // which, with |fan_out_sender_|, may be after this returns. The chunks of a
+  // payload are best sent with the same |written_channels|.
   //
   // Invoked from the PayloadManager's sendPayload() method.
   std::vector<std::string> SendPayloadChunk(
       const PayloadTransferFrame::PayloadHeader& payload_header,
-      const PayloadTransferFrame::PayloadChunk& payload_chunk,
+      PayloadTransferFrame::PayloadChunk payload_chunk,
       const std::vector<std::string>& endpoint_ids,
-      PacketMetaData& packet_meta_data);
+      PacketMetaData& packet_meta_data,
+      FanOutSender::FrameWrittenCallback on_written = nullptr,
+      WrittenChannels* written_channels = nullptr);
   std::vector<std::string> SendControlMessage(
       const PayloadTransferFrame::PayloadHeader& payload_header,
       const PayloadTransferFrame::ControlMessage& control_message,
@@ -140,7 +172,7 @@ class EndpointManager {
   //    a) We failed to read from the endpoint in its dedicated reader thread.
   //    b) We failed to write to the endpoint in PayloadManager.
   //    c) The connection was rejected in PCPHandler.
-  //    d) The dedicated KeepAlive thread exceeded its period of inactivity.
+  //    d) The KeepAlive check exceeded its period of inactivity.
   // Or in the numerous other cases where a failure occurred and we no longer
   // believe the endpoint is in a healthy state.
   //
@@ -154,12 +186,13 @@ class EndpointManager {
   class EndpointState {
    public:
     EndpointState(const std::string& endpoint_id,
-                  EndpointChannelManager* channel_manager)
+                  EndpointChannelManager* channel_manager,
+                  EndpointReaderPool* reader_pool,
+                  KeepAliveScheduler* keep_alive_scheduler)
         : endpoint_id_{endpoint_id},
           channel_manager_{channel_manager},
-          keep_alive_waiter_mutex_{std::make_unique<Mutex>()},
-          keep_alive_waiter_{std::make_unique<ConditionVariable>(
-              keep_alive_waiter_mutex_.get())} {}
+          reader_pool_{reader_pool},
+          keep_alive_scheduler_{keep_alive_scheduler} {}
 
     EndpointState(const EndpointState&) = delete;
     // The default move constructor would not reset |channel_manager_|, for
@@ -168,32 +201,30 @@ class EndpointManager {
     EndpointState(EndpointState&& other)
         : endpoint_id_{std::move(other.endpoint_id_)},
           channel_manager_{std::exchange(other.channel_manager_, nullptr)},
+          reader_pool_{std::exchange(other.reader_pool_, nullptr)},
           reader_thread_{std::move(other.reader_thread_)},
-          keep_alive_waiter_mutex_{
-              std::exchange(other.keep_alive_waiter_mutex_, nullptr)},
-          keep_alive_waiter_{std::exchange(other.keep_alive_waiter_, nullptr)},
-          keep_alive_thread_{std::move(other.keep_alive_thread_)} {}
+          keep_alive_scheduler_{
+              std::exchange(other.keep_alive_scheduler_, nullptr)} {}
     EndpointState& operator=(const EndpointState&) = delete;
     EndpointState&& operator=(EndpointState&&) = delete;
     ~EndpointState();
 
     void StartEndpointReader(Runnable&& runnable);
-    void StartEndpointKeepAliveManager(
-        std::function<void(Mutex*, ConditionVariable*)> runnable);
+    // Hands the endpoint over to the shared reader pool, if there is one.
+    // Returns false if the endpoint has to be read on a dedicated thread.
+    bool StartPooledEndpointReader(EndpointReaderPool::Handlers handlers);
+    bool HasDedicatedReader() const { return reader_thread_ != nullptr; }
+    // Runs |check| on the shared keep-alive scheduler, first right away and
+    // then after whatever delay it returns.
+    void StartEndpointKeepAliveManager(KeepAliveScheduler::Task check);
 
    private:
     const std::string endpoint_id_;
     EndpointChannelManager* channel_manager_;
-    SingleThreadExecutor reader_thread_;
-
-    // Use a condition variable so we can wait on the thread but still be able
-    // to wake it up before shutting down. We don't want to just sleep and risk
-    // blocking shutdown. Note: Create the mutex/condition variable on the heap
-    // so raw pointers sent to HandleKeepAlive() aren't invalidated during
-    // std::move operations.
-    mutable std::unique_ptr<Mutex> keep_alive_waiter_mutex_;
-    std::unique_ptr<ConditionVariable> keep_alive_waiter_;
-    SingleThreadExecutor keep_alive_thread_;
+    EndpointReaderPool* reader_pool_;
+    // Only created if the endpoint is not serviced by |reader_pool_|.
+    std::unique_ptr<SingleThreadExecutor> reader_thread_;
+    KeepAliveScheduler* keep_alive_scheduler_;
   };
 
   // RAII accessor for FrameProcessor
@@ -218,11 +249,46 @@ class EndpointManager {
                                ClientProxy* client_proxy,
                                EndpointChannel* endpoint_channel);
 
-  ExceptionOr<bool> HandleKeepAlive(EndpointChannel* endpoint_channel,
-                                    absl::Duration keep_alive_interval,
-                                    absl::Duration keep_alive_timeout,
-                                    Mutex* keep_alive_waiter_mutex,
-                                    ConditionVariable* keep_alive_waiter);
+  // Reads a single frame from |endpoint_channel| and routes it to its
+  // registered FrameProcessor. With |replacement_timeout| set, as for the
+  // reader pool, the read does not block (see EndpointChannel::TryRead()), and
+  // a wait for the channel to be replaced is not done here but reported
+  // through |*replacement_timeout|.
+  ExceptionOr<bool> HandleFrame(const std::string& endpoint_id,
+                                ClientProxy* client_proxy,
+                                EndpointChannel* endpoint_channel,
+                                absl::Duration* replacement_timeout = nullptr);
+
+  // Has a KeepAlive frame sent if it is time to, and returns the delay until
+  // the endpoint needs to be looked at again. Fails with Exception::kTimeout
+  // if nothing has been read from the endpoint for |keep_alive_timeout|.
+  ExceptionOr<absl::Duration> HandleKeepAlive(
+      ClientProxy* client, const std::string& endpoint_id,
+      EndpointChannel* endpoint_channel, absl::Duration keep_alive_interval,
+      absl::Duration keep_alive_timeout);
+
+  // Writes a KeepAlive frame, or its |ack|, to the current channel of the
+  // endpoint on its keep-alive writer, unless one is already on its way, or it
+  // can not be written within |max_delay|. Discards the endpoint if the write
+  // fails and the channel has not been replaced, like a failed read does.
+  void PostKeepAliveWrite(ClientProxy* client, const std::string& endpoint_id,
+                          bool ack, absl::Duration max_delay)
+      ABSL_LOCKS_EXCLUDED(keep_alive_writes_mutex_);
+
+  // Shuts down the keep-alive writer of the endpoint, once its channel is
+  // gone.
+  // @EndpointManagerThread
+  void RemoveKeepAliveWriter(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(keep_alive_writes_mutex_);
+
+  // Runs HandleKeepAlive() against the current channel of the endpoint.
+  // Discards the endpoint, and returns absl::InfiniteDuration(), once it has
+  // timed out or has no channel left.
+  // @KeepAliveScheduler
+  absl::Duration CheckKeepAlive(ClientProxy* client,
+                                const std::string& endpoint_id,
+                                absl::Duration keep_alive_interval,
+                                absl::Duration keep_alive_timeout);
 
   // Waits for a given endpoint EndpointChannelLoopRunnable() workers to
   // terminate.
@@ -236,6 +302,17 @@ class EndpointManager {
       const std::string& endpoint_id,
       std::function<ExceptionOr<bool>(EndpointChannel*)> handler);
 
+  // Starts reading from the endpoint, on the reader pool if possible.
+  // @EndpointManagerThread
+  void StartEndpointReader(EndpointState& endpoint_state, ClientProxy* client,
+                           const std::string& endpoint_id);
+
+  // Starts reading from the endpoint on its own dedicated thread.
+  // @EndpointManagerThread
+  void StartDedicatedEndpointReader(EndpointState& endpoint_state,
+                                    ClientProxy* client,
+                                    const std::string& endpoint_id);
+
   static void WaitForLatch(const std::string& method_name,
                            CountDownLatch* latch);
   static void WaitForLatch(const std::string& method_name,
@@ -244,10 +321,12 @@ class EndpointManager {
   static constexpr absl::Duration kProcessEndpointDisconnectionTimeout =
       absl::Milliseconds(2000);
   static constexpr absl::Time kInvalidTimestamp = absl::InfinitePast();
+  // A later ack would make for a misleading round trip time sample.
+  static constexpr absl::Duration kMaxKeepAliveAckDelay = absl::Seconds(1);
 
   // It should be noted that this method may be called multiple times (because
   // invoking this method closes the endpoint channel, which causes the
-  // dedicated reader and KeepAlive threads to terminate, which in turn leads to
+  // endpoint reader and KeepAlive check to terminate, which in turn leads to
   // this method being called), but that's alright because the implementation of
   // this method is idempotent.
   // @EndpointManagerThread
@@ -262,11 +341,15 @@ class EndpointManager {
       ClientProxy* client, const std::string& service_id,
       const std::string& endpoint_id);
 
+  // With |fan_out_sender_|, waits for all endpoints to write the frame only if
+  // |wait_for_all| is set.
   std::vector<std::string> SendTransferFrameBytes(
       const std::vector<std::string>& endpoint_ids,
       const ByteArray& payload_transfer_frame_bytes, std::int64_t payload_id,
       std::int64_t offset, const std::string& packet_type,
-      PacketMetaData& packet_meta_data);
+      PacketMetaData& packet_meta_data, bool wait_for_all,
+      FanOutSender::FrameWrittenCallback on_written = nullptr,
+      WrittenChannels* written_channels = nullptr);
 
   // Executes all jobs sequentially, on a serial_executor_.
   void RunOnEndpointManagerThread(const std::string& name, Runnable runnable);
@@ -277,6 +360,30 @@ class EndpointManager {
   absl::flat_hash_map<V1Frame::FrameType, FrameProcessorWithMutex>
       frame_processors_ ABSL_GUARDED_BY(frame_processors_lock_);
 
+  // Shared readers, if FeatureFlags::enable_endpoint_reader_pool is set.
+  // Must outlive |endpoints_|.
+  std::unique_ptr<EndpointReaderPool> reader_pool_;
+
+  // Tracks the keep-alive deadlines of all endpoints. Must outlive
+  // |endpoints_|.
+  KeepAliveScheduler keep_alive_scheduler_;
+
+  Mutex keep_alive_writes_mutex_;
+  // Write the KeepAlive frames, off the scheduler workers. One per endpoint,
+  // so that a write blocked on one endpoint holds up no other endpoint's.
+  absl::flat_hash_map<std::string, std::unique_ptr<SingleThreadExecutor>>
+      keep_alive_writers_ ABSL_GUARDED_BY(keep_alive_writes_mutex_);
+  // Endpoint ID and ack flag of the KeepAlive frames waiting on
+  // |keep_alive_writers_|.
+  absl::flat_hash_set<std::pair<std::string, bool>> keep_alive_writes_
+      ABSL_GUARDED_BY(keep_alive_writes_mutex_);
+
+  // Per-endpoint writers, if FeatureFlags::enable_parallel_fan_out is set.
+  std::unique_ptr<FanOutSender> fan_out_sender_;
+
+  // FeatureFlags::enable_keep_alive_rtt_probes, read once.
+  bool enable_keep_alive_rtt_probes_ = false;
+
   // We keep track of all registered channel endpoints here.
   absl::flat_hash_map<std::string, EndpointState> endpoints_;
 
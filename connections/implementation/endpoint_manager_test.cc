@@ -17,6 +17,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,7 @@
 #include "connections/implementation/offline_frames.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/pipe.h"
@@ -58,6 +60,9 @@ class MockEndpointChannel : public EndpointChannel {
   MOCK_METHOD(Exception, Write,
               (const ByteArray& data, PacketMetaData& packet_meta_data),
               (override));
+  MOCK_METHOD(Exception, WriteLast, (const ByteArray& data), (override));
+  MOCK_METHOD(Exception, WriteUnencrypted, (const ByteArray& data),
+              (override));
   MOCK_METHOD(void, Close, (), (override));
   MOCK_METHOD(void, Close, (DisconnectionReason reason), (override));
   MOCK_METHOD(proto::connections::ConnectionTechnology, GetTechnology, (),
@@ -72,13 +77,20 @@ class MockEndpointChannel : public EndpointChannel {
   MOCK_METHOD(Medium, GetMedium, (), (const override));
   MOCK_METHOD(int, GetMaxTransmitPacketSize, (), (const override));
   MOCK_METHOD(void, EnableEncryption,
-              (std::shared_ptr<EncryptionContext> context), (override));
+              (const EncryptionContexts& contexts,
+               std::shared_ptr<FrameCipher> cipher),
+              (override));
   MOCK_METHOD(void, DisableEncryption, (), (override));
   MOCK_METHOD(bool, IsPaused, (), (const override));
   MOCK_METHOD(void, Pause, (), (override));
   MOCK_METHOD(void, Resume, (), (override));
   MOCK_METHOD(absl::Time, GetLastReadTimestamp, (), (const override));
   MOCK_METHOD(absl::Time, GetLastWriteTimestamp, (), (const override));
+  MOCK_METHOD(bool, IsReadable, (), (override));
+  MOCK_METHOD(ExceptionOr<ByteArray>, TryRead,
+              (PacketMetaData & packet_meta_data), (override));
+  MOCK_METHOD(bool, SetReadinessListener, (std::function<void()> listener),
+              (override));
   MOCK_METHOD(void, SetAnalyticsRecorder,
               (analytics::AnalyticsRecorder*, const std::string&), (override));
 
@@ -113,7 +125,9 @@ class MockFrameProcessor : public EndpointManager::FrameProcessor {
 class EndpointManagerTest : public ::testing::Test {
  protected:
   void RegisterEndpoint(std::unique_ptr<MockEndpointChannel> channel,
-                        bool should_close = true) {
+                        bool should_close = true,
+                        EndpointManager* endpoint_manager = nullptr) {
+    if (endpoint_manager == nullptr) endpoint_manager = &em_;
     CountDownLatch done(1);
     if (should_close) {
       ON_CALL(*channel, Close(_))
@@ -126,8 +140,9 @@ class EndpointManagerTest : public ::testing::Test {
     EXPECT_CALL(*channel, GetLastWriteTimestamp())
         .WillRepeatedly(Return(start_time_));
     EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(1);
-    em_.RegisterEndpoint(&client_, endpoint_id_, info_, connection_options_,
-                         std::move(channel), listener_, connection_token);
+    endpoint_manager->RegisterEndpoint(&client_, endpoint_id_, info_,
+                                       connection_options_, std::move(channel),
+                                       listener_, connection_token);
     if (should_close) {
       EXPECT_TRUE(done.Await(absl::Milliseconds(1000)).result());
     }
@@ -300,6 +315,283 @@ TEST_F(EndpointManagerTest, SingleReadOnInvalidPayload) {
   RegisterEndpoint(std::move(endpoint_channel));
 }
 
+TEST_F(EndpointManagerTest, KeepAliveTimeoutDisconnectsEndpoint) {
+  connection_options_.keep_alive_interval_millis = 20;
+  connection_options_.keep_alive_timeout_millis = 200;
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  // Shared with the channel, which outlives the test body.
+  auto closed = std::make_shared<CountDownLatch>(1);
+  auto keep_alives = std::make_shared<std::atomic_int>(0);
+  // Nothing is ever read from the endpoint, so only KeepAlive frames are
+  // written until the timeout hits.
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillRepeatedly([closed](PacketMetaData& packet_meta_data) {
+        closed->Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly([keep_alives](const ByteArray& data) {
+        (*keep_alives)++;
+        return Exception{Exception::kSuccess};
+      });
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly([closed](DisconnectionReason reason) {
+        closed->CountDown();
+      });
+  RegisterEndpoint(std::move(endpoint_channel), false);
+
+  EXPECT_TRUE(closed->Await(absl::Seconds(2)).result());
+  EXPECT_GT(*keep_alives, 0);
+}
+
+TEST_F(EndpointManagerTest, KeepAliveTimesOutWhileWriteIsBlocked) {
+  connection_options_.keep_alive_interval_millis = 20;
+  connection_options_.keep_alive_timeout_millis = 200;
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  auto closed = std::make_shared<CountDownLatch>(1);
+  auto keep_alives = std::make_shared<std::atomic_int>(0);
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillRepeatedly([closed](PacketMetaData& packet_meta_data) {
+        closed->Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  // The first KeepAlive write blocks until the channel is closed; the ones
+  // that follow must wait for it rather than pile up.
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly([closed, keep_alives](const ByteArray& data) {
+        ExceptionOr<OfflineFrame> frame = parser::FromBytes(data);
+        if (frame.ok() &&
+            parser::GetFrameType(frame.result()) == V1Frame::KEEP_ALIVE) {
+          (*keep_alives)++;
+          closed->Await();
+        }
+        return Exception{Exception::kIo};
+      });
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly([closed](DisconnectionReason reason) {
+        closed->CountDown();
+      });
+  RegisterEndpoint(std::move(endpoint_channel), false);
+
+  EXPECT_TRUE(closed->Await(absl::Seconds(2)).result());
+  EXPECT_EQ(*keep_alives, 1);
+}
+
+TEST_F(EndpointManagerTest, KeepAliveIsNotHeldUpByStalledEndpoints) {
+  connection_options_.keep_alive_interval_millis = 20;
+  connection_options_.keep_alive_timeout_millis = 1000;
+  auto all_closed = std::make_shared<CountDownLatch>(3);
+  auto written = std::make_shared<CountDownLatch>(1);
+  // The KeepAlive writes to the first endpoints block until their channels
+  // are closed; the last endpoint must get its KeepAlive written regardless.
+  for (const std::string endpoint_id : {"stalled_1", "stalled_2", "healthy"}) {
+    bool stalled = endpoint_id != "healthy";
+    auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+    auto closed = std::make_shared<CountDownLatch>(1);
+    auto was_closed = std::make_shared<std::atomic_bool>(false);
+    EXPECT_CALL(*endpoint_channel, Read(_))
+        .WillRepeatedly([closed](PacketMetaData& packet_meta_data) {
+          closed->Await();
+          return ExceptionOr<ByteArray>(Exception::kIo);
+        });
+    EXPECT_CALL(*endpoint_channel, Write(_))
+        .WillRepeatedly([closed, written, stalled](const ByteArray& data) {
+          ExceptionOr<OfflineFrame> frame = parser::FromBytes(data);
+          if (!frame.ok() ||
+              parser::GetFrameType(frame.result()) != V1Frame::KEEP_ALIVE) {
+            return Exception{Exception::kIo};
+          }
+          if (stalled) {
+            closed->Await();
+            return Exception{Exception::kIo};
+          }
+          written->CountDown();
+          return Exception{Exception::kSuccess};
+        });
+    EXPECT_CALL(*endpoint_channel, Close(_))
+        .WillRepeatedly([closed, was_closed,
+                         all_closed](DisconnectionReason reason) {
+          if (!was_closed->exchange(true)) {
+            closed->CountDown();
+            all_closed->CountDown();
+          }
+        });
+    endpoint_id_ = endpoint_id;
+    RegisterEndpoint(std::move(endpoint_channel), false);
+  }
+
+  EXPECT_TRUE(written->Await(absl::Milliseconds(500)).result());
+  EXPECT_TRUE(all_closed->Await(absl::Seconds(5)).result());
+}
+
+TEST_F(EndpointManagerTest, KeepAliveAckIsWrittenOffReaderThread) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_keep_alive_rtt_probes = true;
+  EndpointManager endpoint_manager(&ecm_);
+  connection_options_.keep_alive_interval_millis = 20;
+  connection_options_.keep_alive_timeout_millis = 200;
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  auto closed = std::make_shared<CountDownLatch>(1);
+  auto acked = std::make_shared<CountDownLatch>(1);
+  auto reader_thread = std::make_shared<std::thread::id>();
+  auto ack_thread = std::make_shared<std::thread::id>();
+  // The reader reads one KeepAlive frame, and then waits for the channel to
+  // be closed; so the ack can only be written if it is not written by it.
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillOnce([reader_thread](PacketMetaData& packet_meta_data) {
+        *reader_thread = std::this_thread::get_id();
+        return ExceptionOr<ByteArray>(parser::ForKeepAlive());
+      })
+      .WillRepeatedly([closed](PacketMetaData& packet_meta_data) {
+        closed->Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly([acked, ack_thread](const ByteArray& data) {
+        ExceptionOr<OfflineFrame> frame = parser::FromBytes(data);
+        if (frame.ok() &&
+            parser::GetFrameType(frame.result()) == V1Frame::KEEP_ALIVE &&
+            frame.result().v1().keep_alive().ack()) {
+          *ack_thread = std::this_thread::get_id();
+          acked->CountDown();
+        }
+        return Exception{Exception::kSuccess};
+      });
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly([closed](DisconnectionReason reason) {
+        closed->CountDown();
+      });
+  RegisterEndpoint(std::move(endpoint_channel), false, &endpoint_manager);
+
+  EXPECT_TRUE(acked->Await(absl::Seconds(2)).result());
+  EXPECT_NE(*ack_thread, *reader_thread);
+  EXPECT_TRUE(closed->Await(absl::Seconds(2)).result());
+  FeatureFlags::GetMutableFlagsForTesting().enable_keep_alive_rtt_probes =
+      false;
+}
+
+TEST_F(EndpointManagerTest, PooledReaderDispatchesFramesAndDisconnects) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_endpoint_reader_pool = true;
+  EndpointManager endpoint_manager(&ecm_);
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  auto connect_request = std::make_unique<MockFrameProcessor>();
+  ConnectionInfo connection_info{
+      "endpoint_id",
+      ByteArray{"endpoint_name"},
+      1234 /*nonce*/,
+      false /*supports_5_ghz*/,
+      "" /*bssid*/,
+      2412 /*ap_frequency*/,
+      "8xqT" /*ip_address in 4 bytes format*/,
+      std::vector<Medium>{Medium::BLE} /*supported_mediums*/,
+      0 /*keep_alive_interval_millis*/,
+      0 /*keep_alive_timeout_millis*/};
+
+  auto read_data = parser::ForConnectionRequest(connection_info);
+  EXPECT_CALL(*connect_request, OnIncomingFrame);
+  EXPECT_CALL(*connect_request, OnEndpointDisconnect);
+  // The channel is always readable, so the pool reads it right away; the
+  // second read fails, and since there is no replacement channel, the
+  // endpoint is disconnected.
+  EXPECT_CALL(*endpoint_channel, SetReadinessListener(_))
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(*endpoint_channel, IsReadable()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*endpoint_channel, TryRead(_))
+      .WillOnce(Return(ExceptionOr<ByteArray>(read_data)))
+      .WillRepeatedly(Return(ExceptionOr<ByteArray>(Exception::kIo)));
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  endpoint_manager.RegisterFrameProcessor(V1Frame::CONNECTION_REQUEST,
+                                          connect_request.get());
+  processors_.emplace_back(std::move(connect_request));
+  RegisterEndpoint(std::move(endpoint_channel), true, &endpoint_manager);
+  FeatureFlags::GetMutableFlagsForTesting().enable_endpoint_reader_pool = false;
+}
+
+TEST_F(EndpointManagerTest, FanOutSenderWritesPayloadChunks) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_parallel_fan_out = true;
+  EndpointManager endpoint_manager(&ecm_);
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  PayloadTransferFrame::PayloadHeader header;
+  header.set_id(12345);
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_total_size(5);
+  PayloadTransferFrame::PayloadChunk chunk;
+  chunk.set_offset(0);
+  chunk.set_flags(0);
+  chunk.set_body("bytes");
+  PayloadTransferFrame::PayloadChunk last_chunk;
+  last_chunk.set_offset(5);
+  last_chunk.set_flags(PayloadTransferFrame::PayloadChunk::LAST_CHUNK);
+
+  ON_CALL(*endpoint_channel, Read(_))
+      .WillByDefault([channel = endpoint_channel.get()]() {
+        absl::SleepFor(absl::Milliseconds(100));
+        if (channel->IsClosed()) return ExceptionOr<ByteArray>(Exception::kIo);
+        return ExceptionOr<ByteArray>(ByteArray{});
+      });
+  ON_CALL(*endpoint_channel, Close(_))
+      .WillByDefault([channel = endpoint_channel.get()](
+                         DisconnectionReason reason) { channel->DoClose(); });
+  EXPECT_CALL(*endpoint_channel, Write(_, _))
+      .Times(2)
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+
+  RegisterEndpoint(std::move(endpoint_channel), false, &endpoint_manager);
+  PacketMetaData packet_meta_data;
+  EXPECT_EQ(endpoint_manager.SendPayloadChunk(
+                header, chunk, std::vector{endpoint_id_}, packet_meta_data),
+            std::vector<std::string>{});
+  EXPECT_EQ(endpoint_manager.SendPayloadChunk(header, last_chunk,
+                                              std::vector{endpoint_id_},
+                                              packet_meta_data),
+            std::vector<std::string>{});
+  endpoint_manager.UnregisterEndpoint(&client_, endpoint_id_);
+  FeatureFlags::GetMutableFlagsForTesting().enable_parallel_fan_out = false;
+}
+
+TEST_F(EndpointManagerTest, WrittenChannelsAreNotWrittenToOnceGone) {
+  EndpointManager endpoint_manager(&ecm_);
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  PayloadTransferFrame::PayloadHeader header;
+  header.set_id(12345);
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_total_size(10);
+  PayloadTransferFrame::PayloadChunk chunk;
+  chunk.set_offset(0);
+  chunk.set_flags(0);
+  chunk.set_body("bytes");
+
+  ON_CALL(*endpoint_channel, Read(_))
+      .WillByDefault([channel = endpoint_channel.get()]() {
+        absl::SleepFor(absl::Milliseconds(100));
+        if (channel->IsClosed()) return ExceptionOr<ByteArray>(Exception::kIo);
+        return ExceptionOr<ByteArray>(ByteArray{});
+      });
+  ON_CALL(*endpoint_channel, Close(_))
+      .WillByDefault([channel = endpoint_channel.get()](
+                         DisconnectionReason reason) { channel->DoClose(); });
+  // Only the two chunks.
+  EXPECT_CALL(*endpoint_channel, Write(_, _))
+      .Times(2)
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+
+  RegisterEndpoint(std::move(endpoint_channel), false, &endpoint_manager);
+  PacketMetaData packet_meta_data;
+  EndpointManager::WrittenChannels written_channels;
+  for (int i = 0; i < 2; ++i) {
+    chunk.set_offset(i * 5);
+    EXPECT_EQ(endpoint_manager.SendPayloadChunk(
+                  header, chunk, std::vector{endpoint_id_}, packet_meta_data,
+                  nullptr, &written_channels),
+              std::vector<std::string>{});
+  }
+  endpoint_manager.UnregisterEndpoint(&client_, endpoint_id_);
+  EXPECT_EQ(endpoint_manager.SendPayloadChunk(
+                header, chunk, std::vector{endpoint_id_}, packet_meta_data,
+                nullptr, &written_channels),
+            std::vector{endpoint_id_});
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -0,0 +1,305 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/endpoint_reader_pool.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+constexpr int EndpointReaderPool::kMaxFramesPerTurn;
+constexpr absl::Duration EndpointReaderPool::kReplacementPollInterval;
+
+EndpointReaderPool::EndpointReaderPool(int num_workers)
+    : executor_(num_workers) {
+  NEARBY_LOGS(INFO) << "EndpointReaderPool started with " << num_workers
+                    << " workers.";
+}
+
+EndpointReaderPool::~EndpointReaderPool() {
+  std::vector<std::string> endpoint_ids;
+  {
+    MutexLock lock(&mutex_);
+    for (const auto& item : entries_) {
+      endpoint_ids.push_back(item.first);
+    }
+  }
+  for (const auto& endpoint_id : endpoint_ids) {
+    Unregister(endpoint_id);
+  }
+  alarm_executor_.Shutdown();
+  executor_.Shutdown();
+}
+
+bool EndpointReaderPool::Register(const std::string& endpoint_id,
+                                  Handlers handlers) {
+  auto entry = std::make_shared<Entry>();
+  entry->endpoint_id = endpoint_id;
+  entry->handlers = std::move(handlers);
+  std::shared_ptr<EndpointChannel> channel = entry->handlers.get_channel_cb();
+  if (channel == nullptr || !Attach(entry, std::move(channel))) {
+    NEARBY_LOGS(INFO) << "EndpointReaderPool can not service endpoint "
+                      << endpoint_id << "; channel does not signal readiness.";
+    return false;
+  }
+
+  MutexLock lock(&mutex_);
+  entries_[endpoint_id] = entry;
+  // Look at the channel once, in case data arrived before the listener was
+  // installed.
+  if (entry->scheduled) {
+    entry->pending = true;
+  } else {
+    ScheduleLocked(entry);
+  }
+  return true;
+}
+
+void EndpointReaderPool::Unregister(const std::string& endpoint_id) {
+  std::shared_ptr<Entry> entry;
+  {
+    MutexLock lock(&mutex_);
+    auto item = entries_.find(endpoint_id);
+    if (item == entries_.end()) return;
+    entry = item->second;
+    entries_.erase(item);
+    entry->stopped = true;
+    while (entry->running) {
+      worker_done_.Wait();
+    }
+  }
+  Detach(entry.get());
+  NEARBY_LOGS(INFO) << "EndpointReaderPool unregistered endpoint "
+                    << endpoint_id;
+}
+
+bool EndpointReaderPool::IsRegistered(const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+  return entries_.contains(endpoint_id);
+}
+
+int EndpointReaderPool::GetEndpointCount() const {
+  MutexLock lock(&mutex_);
+  return entries_.size();
+}
+
+void EndpointReaderPool::OnReadable(const std::weak_ptr<Entry>& weak_entry) {
+  std::shared_ptr<Entry> entry = weak_entry.lock();
+  if (entry == nullptr) return;
+
+  MutexLock lock(&mutex_);
+  if (entry->stopped) return;
+  if (entry->scheduled) {
+    entry->pending = true;
+    return;
+  }
+  ScheduleLocked(std::move(entry));
+}
+
+void EndpointReaderPool::ScheduleLocked(std::shared_ptr<Entry> entry) {
+  entry->scheduled = true;
+  executor_.Execute("endpoint-reader",
+                    [this, entry]() { RunEntry(entry); });
+}
+
+void EndpointReaderPool::RunEntry(std::shared_ptr<Entry> entry) {
+  bool awaited_replacement = false;
+  {
+    MutexLock lock(&mutex_);
+    if (entry->stopped) {
+      entry->scheduled = false;
+      return;
+    }
+    entry->running = true;
+    entry->pending = false;
+    awaited_replacement = entry->awaiting_replacement;
+    entry->awaiting_replacement = false;
+  }
+
+  enum class Outcome { kIdle, kYield, kStopped, kFallback, kAwaitReplacement };
+  Outcome outcome = Outcome::kIdle;
+  absl::Duration replacement_timeout = absl::ZeroDuration();
+  if (awaited_replacement) {
+    RebindResult rebind_result = Rebind(entry);
+    if (rebind_result != RebindResult::kRebound) {
+      outcome = rebind_result == RebindResult::kFallback ? Outcome::kFallback
+                                                         : Outcome::kStopped;
+    }
+  }
+  int frames = 0;
+  while (outcome == Outcome::kIdle && entry->channel->IsReadable()) {
+    if (frames++ == kMaxFramesPerTurn) {
+      outcome = Outcome::kYield;
+      break;
+    }
+    ExceptionOr<bool> keep_using_channel = entry->handlers.read_frame_cb(
+        entry->channel.get(), &replacement_timeout);
+    if (keep_using_channel.ok() && keep_using_channel.result()) continue;
+
+    Exception exception = keep_using_channel.GetException();
+    // The rest of the frame is yet to arrive; the channel holds on to what
+    // was read of it until then.
+    if (exception.Raised(Exception::kTimeout)) break;
+
+    // Same recovery rules as EndpointManager::EndpointChannelLoopRunnable():
+    // an IO error or an invalid frame makes us look for a replacement channel
+    // on a different medium; anything else ends the endpoint.
+    if (exception.Raised(Exception::kInvalidProtocolBuffer) ||
+        exception.Raised(Exception::kIo)) {
+      if (replacement_timeout > absl::ZeroDuration()) {
+        outcome = Outcome::kAwaitReplacement;
+        break;
+      }
+      RebindResult rebind_result = Rebind(entry);
+      if (rebind_result == RebindResult::kRebound) continue;
+      outcome = rebind_result == RebindResult::kFallback ? Outcome::kFallback
+                                                         : Outcome::kStopped;
+      break;
+    }
+    outcome = Outcome::kStopped;
+    break;
+  }
+
+  if (outcome == Outcome::kAwaitReplacement) {
+    // Nothing more is read from the channel being replaced.
+    entry->channel->SetReadinessListener(nullptr);
+  }
+
+  bool finished = false;
+  {
+    MutexLock lock(&mutex_);
+    entry->running = false;
+    if (entry->stopped) {
+      // Unregister() owns the entry now, and will detach the channel.
+      entry->scheduled = false;
+    } else if (outcome == Outcome::kStopped ||
+               outcome == Outcome::kFallback) {
+      entry->stopped = true;
+      entry->scheduled = false;
+      auto item = entries_.find(entry->endpoint_id);
+      if (item != entries_.end() && item->second == entry) {
+        entries_.erase(item);
+      }
+      finished = true;
+    } else if (outcome == Outcome::kAwaitReplacement) {
+      // Stays scheduled until the wait is over, and then rebinds.
+      entry->awaiting_replacement = true;
+      AwaitReplacementLocked(entry, entry->channel.get(),
+                             SystemClock::ElapsedRealtime() +
+                                 replacement_timeout);
+    } else if (outcome == Outcome::kYield || entry->pending) {
+      ScheduleLocked(entry);
+    } else {
+      entry->scheduled = false;
+    }
+    worker_done_.Notify();
+  }
+
+  if (finished) {
+    Detach(entry.get());
+    if (outcome == Outcome::kFallback) {
+      NEARBY_LOGS(INFO) << "EndpointReaderPool hands endpoint "
+                        << entry->endpoint_id << " over to a dedicated reader.";
+      if (entry->handlers.fallback_cb) entry->handlers.fallback_cb();
+    } else {
+      NEARBY_LOGS(INFO) << "EndpointReaderPool stopped reading endpoint "
+                        << entry->endpoint_id;
+      if (entry->handlers.stopped_cb) entry->handlers.stopped_cb();
+    }
+  }
+}
+
+void EndpointReaderPool::AwaitReplacementLocked(std::weak_ptr<Entry> weak_entry,
+                                                const EndpointChannel* channel,
+                                                absl::Time deadline) {
+  alarm_executor_.Schedule(
+      [this, weak_entry, channel, deadline]() {
+        CheckReplacement(weak_entry, channel, deadline);
+      },
+      kReplacementPollInterval);
+}
+
+void EndpointReaderPool::CheckReplacement(
+    const std::weak_ptr<Entry>& weak_entry, const EndpointChannel* channel,
+    absl::Time deadline) {
+  std::shared_ptr<Entry> entry = weak_entry.lock();
+  if (entry == nullptr) return;
+  // |channel| is only compared against, never used: the worker that gets the
+  // entry next owns it.
+  bool replaced = entry->handlers.get_channel_cb().get() != channel;
+
+  MutexLock lock(&mutex_);
+  if (entry->stopped) return;
+  if (replaced || SystemClock::ElapsedRealtime() >= deadline) {
+    ScheduleLocked(std::move(entry));
+    return;
+  }
+  AwaitReplacementLocked(weak_entry, channel, deadline);
+}
+
+EndpointReaderPool::RebindResult EndpointReaderPool::Rebind(
+    const std::shared_ptr<Entry>& entry) {
+  proto::connections::Medium last_failed_medium = entry->channel->GetMedium();
+  std::shared_ptr<EndpointChannel> channel = entry->handlers.get_channel_cb();
+  if (channel == nullptr) {
+    NEARBY_LOGS(INFO) << "Endpoint channel is nullptr, bail out.";
+    return RebindResult::kStopped;
+  }
+  // If there's not a new EndpointChannel for this endpoint, there's nothing
+  // more to do here.
+  if (channel->GetMedium() == last_failed_medium) {
+    NEARBY_LOGS(INFO)
+        << "No new endpoint channel is found after a failure; medium="
+        << proto::connections::Medium_Name(last_failed_medium);
+    return RebindResult::kStopped;
+  }
+  Detach(entry.get());
+  if (!Attach(entry, std::move(channel))) {
+    return RebindResult::kFallback;
+  }
+  return RebindResult::kRebound;
+}
+
+bool EndpointReaderPool::Attach(const std::shared_ptr<Entry>& entry,
+                                std::shared_ptr<EndpointChannel> channel) {
+  // The channel has to be in place before the listener may fire.
+  entry->channel = std::move(channel);
+  std::weak_ptr<Entry> weak_entry = entry;
+  if (!entry->channel->SetReadinessListener(
+          [this, weak_entry]() { OnReadable(weak_entry); })) {
+    entry->channel.reset();
+    return false;
+  }
+  return true;
+}
+
+void EndpointReaderPool::Detach(Entry* entry) {
+  if (entry->channel == nullptr) return;
+  entry->channel->SetReadinessListener(nullptr);
+  entry->channel.reset();
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
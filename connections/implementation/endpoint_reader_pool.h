@@ -0,0 +1,161 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_ENDPOINT_READER_POOL_H_
+#define CORE_INTERNAL_ENDPOINT_READER_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/implementation/endpoint_channel.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Services reads for many endpoints on a fixed number of worker threads.
+//
+// Instead of parking one blocked thread per endpoint in EndpointChannel::Read,
+// every registered endpoint installs a readiness listener on its channel, and
+// is handed to a worker only once the channel reports data (or end of stream).
+// The worker then reads and dispatches frames for as long as the channel stays
+// readable, up to a fairness budget, and goes back to waiting for the next
+// notification. This keeps the number of reader threads flat regardless of the
+// number of connected endpoints.
+//
+// Workers never block on an endpoint: a frame which has only partly arrived
+// is kept by its channel (see EndpointChannel::TryRead()) until the rest of it
+// is readable, and an endpoint whose channel is about to be replaced waits for
+// the replacement off the pool.
+class EndpointReaderPool {
+ public:
+  struct Handlers {
+    // Returns the channel currently associated with the endpoint, or nullptr
+    // if there is none. Called again whenever reading from the current channel
+    // fails, since the channel may have been replaced (eg. after a bandwidth
+    // upgrade), and polled while waiting for a replacement. Must not block.
+    std::function<std::shared_ptr<EndpointChannel>()> get_channel_cb;
+    // Reads and dispatches the next frame from |channel| without blocking on
+    // it: Exception::kTimeout means the frame has not fully arrived yet (see
+    // EndpointChannel::TryRead()), and the endpoint goes back to waiting for
+    // readiness. Otherwise follows the contract of EndpointManager handlers:
+    // returning an exception or false stops servicing of the channel. Before
+    // returning Exception::kIo for a channel which is about to be replaced,
+    // sets |*replacement_timeout| to how long to wait for the replacement.
+    std::function<ExceptionOr<bool>(EndpointChannel* channel,
+                                    absl::Duration* replacement_timeout)>
+        read_frame_cb;
+    // Called once, on a pool worker, when the endpoint is no longer serviced
+    // because it ran out of usable channels. Not called after Unregister().
+    std::function<void()> stopped_cb;
+    // Called once, on a pool worker, when the replacement channel of the
+    // endpoint can not signal readiness. The caller is expected to continue
+    // reading the endpoint on a dedicated thread.
+    std::function<void()> fallback_cb;
+  };
+
+  explicit EndpointReaderPool(int num_workers);
+  ~EndpointReaderPool();
+
+  // Starts servicing the channel returned by |handlers.get_channel_cb|.
+  // Returns false if the channel can not signal readiness, in which case the
+  // endpoint is not registered and must be read on a dedicated thread.
+  bool Register(const std::string& endpoint_id, Handlers handlers)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Stops servicing the endpoint, blocking while a worker is still reading
+  // from it. Must not be called from a pool worker.
+  void Unregister(const std::string& endpoint_id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns true if the endpoint is currently serviced by the pool.
+  bool IsRegistered(const std::string& endpoint_id) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of endpoints currently serviced by the pool.
+  int GetEndpointCount() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // Maximum number of frames read from one endpoint before the worker yields
+  // to other ready endpoints.
+  static constexpr int kMaxFramesPerTurn = 16;
+  // How often an endpoint waiting for a replacement channel looks for it.
+  static constexpr absl::Duration kReplacementPollInterval =
+      absl::Milliseconds(10);
+
+  struct Entry {
+    std::string endpoint_id;
+    Handlers handlers;
+    // Only accessed by the worker which owns the entry (running == true), or
+    // by whoever removed the entry from the pool.
+    std::shared_ptr<EndpointChannel> channel;
+    // True from the moment the entry is handed to the executor, until the
+    // worker finds the channel not readable anymore.
+    bool scheduled = false;
+    // Set when the channel became readable while scheduled, so the worker
+    // must look at the channel once more before going idle.
+    bool pending = false;
+    // Set while the entry waits for its channel to be replaced; it stays
+    // scheduled meanwhile, without taking up a worker.
+    bool awaiting_replacement = false;
+    bool running = false;
+    bool stopped = false;
+  };
+
+  enum class RebindResult {
+    kRebound,
+    kStopped,
+    kFallback,
+  };
+
+  void OnReadable(const std::weak_ptr<Entry>& weak_entry)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void ScheduleLocked(std::shared_ptr<Entry> entry)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RunEntry(std::shared_ptr<Entry> entry) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Hands the entry back to a worker once |channel| is no longer the current
+  // one of the endpoint, or at |deadline|.
+  void AwaitReplacementLocked(std::weak_ptr<Entry> weak_entry,
+                              const EndpointChannel* channel,
+                              absl::Time deadline)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void CheckReplacement(const std::weak_ptr<Entry>& weak_entry,
+                        const EndpointChannel* channel, absl::Time deadline)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  RebindResult Rebind(const std::shared_ptr<Entry>& entry);
+  bool Attach(const std::shared_ptr<Entry>& entry,
+              std::shared_ptr<EndpointChannel> channel);
+  void Detach(Entry* entry);
+
+  mutable Mutex mutex_;
+  ConditionVariable worker_done_{&mutex_};
+  absl::flat_hash_map<std::string, std::shared_ptr<Entry>> entries_
+      ABSL_GUARDED_BY(mutex_);
+  MultiThreadExecutor executor_;
+  ScheduledExecutor alarm_executor_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_ENDPOINT_READER_POOL_H_
@@ -0,0 +1,192 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares reading N endpoints with one dedicated thread per endpoint (the
+// default EndpointManager behaviour) against EndpointReaderPool.
+//
+// Besides wall time, every run reports the number of live threads in the
+// process and the CPU time consumed by all of them while frames were flowing.
+
+#include <sys/resource.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "connections/implementation/endpoint_reader_pool.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/pipe.h"
+#include "internal/platform/single_thread_executor.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr int kFramesPerEndpoint = 64;
+constexpr int kFrameSize = 512;
+constexpr int kPoolSize = 4;
+
+class PipeEndpointChannel : public BaseEndpointChannel {
+ public:
+  explicit PipeEndpointChannel(Pipe* pipe)
+      : BaseEndpointChannel("service_id", "channel", &pipe->GetInputStream(),
+                            &pipe->GetOutputStream()) {}
+
+  proto::connections::Medium GetMedium() const override {
+    return proto::connections::Medium::WIFI_LAN;
+  }
+
+ private:
+  void CloseImpl() override {}
+};
+
+struct LoopbackEndpoint {
+  LoopbackEndpoint()
+      : pipe(std::make_unique<Pipe>()),
+        channel(std::make_shared<PipeEndpointChannel>(pipe.get())) {}
+
+  std::unique_ptr<Pipe> pipe;
+  std::shared_ptr<EndpointChannel> channel;
+};
+
+int GetThreadCount() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (absl::StartsWith(line, "Threads:")) {
+      int threads = 0;
+      if (absl::SimpleAtoi(line.substr(sizeof("Threads:") - 1), &threads)) {
+        return threads;
+      }
+    }
+  }
+  return 0;
+}
+
+double GetProcessCpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+void WriteFrames(std::vector<LoopbackEndpoint>& endpoints) {
+  ByteArray frame(std::string(kFrameSize, 'x'));
+  for (int i = 0; i < kFramesPerEndpoint; ++i) {
+    for (auto& endpoint : endpoints) {
+      endpoint.channel->Write(frame);
+    }
+  }
+}
+
+void ReportCounters(benchmark::State& state, int threads, double cpu_seconds,
+                    int num_endpoints) {
+  state.counters["threads"] = threads;
+  state.counters["cpu_ms"] =
+      benchmark::Counter(cpu_seconds * 1e3, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * num_endpoints *
+                          kFramesPerEndpoint);
+}
+
+void BM_DedicatedReaders(benchmark::State& state) {
+  const int num_endpoints = state.range(0);
+  int threads = 0;
+  double cpu_seconds = 0;
+  for (auto _ : state) {
+    std::vector<LoopbackEndpoint> endpoints(num_endpoints);
+    std::vector<std::unique_ptr<SingleThreadExecutor>> readers;
+    CountDownLatch frames_read(num_endpoints * kFramesPerEndpoint);
+    for (auto& endpoint : endpoints) {
+      readers.push_back(std::make_unique<SingleThreadExecutor>());
+      EndpointChannel* channel = endpoint.channel.get();
+      readers.back()->Execute([channel, &frames_read]() {
+        while (channel->Read().ok()) {
+          frames_read.CountDown();
+        }
+      });
+    }
+
+    double cpu_start = GetProcessCpuSeconds();
+    WriteFrames(endpoints);
+    frames_read.Await();
+    cpu_seconds += GetProcessCpuSeconds() - cpu_start;
+    threads = GetThreadCount();
+
+    for (auto& endpoint : endpoints) {
+      endpoint.channel->Close();
+    }
+    readers.clear();
+  }
+  ReportCounters(state, threads, cpu_seconds, num_endpoints);
+}
+
+void BM_PooledReaders(benchmark::State& state) {
+  const int num_endpoints = state.range(0);
+  int threads = 0;
+  double cpu_seconds = 0;
+  for (auto _ : state) {
+    std::vector<LoopbackEndpoint> endpoints(num_endpoints);
+    EndpointReaderPool pool(kPoolSize);
+    CountDownLatch frames_read(num_endpoints * kFramesPerEndpoint);
+    for (int i = 0; i < num_endpoints; ++i) {
+      std::shared_ptr<EndpointChannel> channel = endpoints[i].channel;
+      pool.Register(
+          absl::StrCat("endpoint-", i),
+          {
+              .get_channel_cb = [channel]() { return channel; },
+              .read_frame_cb =
+                  [&frames_read](EndpointChannel* channel,
+                                 absl::Duration* replacement_timeout) {
+                    PacketMetaData packet_meta_data;
+                    ExceptionOr<ByteArray> frame =
+                        channel->TryRead(packet_meta_data);
+                    if (!frame.ok()) {
+                      return ExceptionOr<bool>(frame.exception());
+                    }
+                    frames_read.CountDown();
+                    return ExceptionOr<bool>(true);
+                  },
+          });
+    }
+
+    double cpu_start = GetProcessCpuSeconds();
+    WriteFrames(endpoints);
+    frames_read.Await();
+    cpu_seconds += GetProcessCpuSeconds() - cpu_start;
+    threads = GetThreadCount();
+  }
+  ReportCounters(state, threads, cpu_seconds, num_endpoints);
+}
+
+BENCHMARK(BM_DedicatedReaders)
+    ->RangeMultiplier(4)
+    ->Range(4, 256)
+    ->UseRealTime();
+BENCHMARK(BM_PooledReaders)->RangeMultiplier(4)->Range(4, 256)->UseRealTime();
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+BENCHMARK_MAIN();
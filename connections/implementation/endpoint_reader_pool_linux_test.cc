@@ -0,0 +1,151 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs the EndpointReaderPool over the TCP sockets of the Linux platform,
+// which signal readiness with epoll rather than from the writing thread.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "connections/implementation/endpoint_reader_pool.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/implementation/linux/wifi_lan.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+class SocketEndpointChannel : public BaseEndpointChannel {
+ public:
+  explicit SocketEndpointChannel(api::WifiLanSocket* socket)
+      : BaseEndpointChannel("service_id", "channel",
+                            &socket->GetInputStream(),
+                            &socket->GetOutputStream()),
+        socket_(socket) {}
+
+  Medium GetMedium() const override { return Medium::WIFI_LAN; }
+
+ private:
+  void CloseImpl() override { socket_->Close(); }
+
+  api::WifiLanSocket* socket_;
+};
+
+// Both ends of a loopback TCP connection.
+struct Connection {
+  Connection() {
+    auto server_socket = medium.ListenForService(0);
+    std::thread acceptor([&]() { accepted = server_socket->Accept(); });
+    CancellationFlag flag;
+    connected = medium.ConnectToService(server_socket->GetIPAddress(),
+                                        server_socket->GetPort(), &flag);
+    acceptor.join();
+    writer = std::make_shared<SocketEndpointChannel>(connected.get());
+    reader = std::make_shared<SocketEndpointChannel>(accepted.get());
+  }
+
+  linux_platform::WifiLanMedium medium;
+  std::unique_ptr<api::WifiLanSocket> connected;
+  std::unique_ptr<api::WifiLanSocket> accepted;
+  std::shared_ptr<EndpointChannel> writer;
+  std::shared_ptr<EndpointChannel> reader;
+};
+
+class EndpointReaderPoolLinuxTest : public ::testing::Test {
+ protected:
+  EndpointReaderPool::Handlers MakeHandlers(
+      std::shared_ptr<EndpointChannel> channel, CountDownLatch* frames_read,
+      CountDownLatch* stopped) {
+    return {
+        .get_channel_cb = [channel]() { return channel; },
+        .read_frame_cb =
+            [this, frames_read](EndpointChannel* channel,
+                                absl::Duration* replacement_timeout) {
+              PacketMetaData packet_meta_data;
+              ExceptionOr<ByteArray> frame = channel->TryRead(packet_meta_data);
+              if (!frame.ok()) return ExceptionOr<bool>(frame.exception());
+              {
+                absl::MutexLock lock(&mutex_);
+                frames_.push_back(std::string(frame.result()));
+              }
+              frames_read->CountDown();
+              return ExceptionOr<bool>(true);
+            },
+        .stopped_cb = [stopped]() { stopped->CountDown(); },
+    };
+  }
+
+  int CountFrames(const std::string& frame) {
+    absl::MutexLock lock(&mutex_);
+    return std::count(frames_.begin(), frames_.end(), frame);
+  }
+
+  absl::Mutex mutex_;
+  std::vector<std::string> frames_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST_F(EndpointReaderPoolLinuxTest, ReadsSocketsWithoutDedicatedThreads) {
+  constexpr int kConnections = 8;
+  constexpr int kFramesPerConnection = 50;
+  std::vector<std::unique_ptr<Connection>> connections;
+  for (int i = 0; i < kConnections; ++i) {
+    connections.push_back(std::make_unique<Connection>());
+    ASSERT_NE(connections.back()->accepted, nullptr);
+  }
+  EndpointReaderPool pool(2);
+  CountDownLatch frames_read(kConnections * kFramesPerConnection);
+  CountDownLatch stopped(kConnections);
+
+  for (int i = 0; i < kConnections; ++i) {
+    ASSERT_TRUE(pool.Register(
+        absl::StrCat("endpoint-", i),
+        MakeHandlers(connections[i]->reader, &frames_read, &stopped)));
+  }
+  for (int frame = 0; frame < kFramesPerConnection; ++frame) {
+    for (int i = 0; i < kConnections; ++i) {
+      EXPECT_TRUE(connections[i]
+                      ->writer->Write(ByteArray(absl::StrCat("frame-", i)))
+                      .Ok());
+    }
+  }
+
+  ASSERT_TRUE(frames_read.Await(absl::Seconds(5)).result());
+  for (int i = 0; i < kConnections; ++i) {
+    EXPECT_EQ(CountFrames(absl::StrCat("frame-", i)), kFramesPerConnection);
+  }
+
+  // A peer that hangs up makes the socket readable too.
+  for (auto& connection : connections) connection->writer->Close();
+  EXPECT_TRUE(stopped.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(pool.GetEndpointCount(), 0);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,299 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/endpoint_reader_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "connections/implementation/fake_endpoint_channel.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+class PipeEndpointChannel : public BaseEndpointChannel {
+ public:
+  explicit PipeEndpointChannel(Pipe* pipe, Medium medium = Medium::WIFI_LAN)
+      : BaseEndpointChannel("service_id", "channel", &pipe->GetInputStream(),
+                            &pipe->GetOutputStream()),
+        medium_(medium) {}
+
+  Medium GetMedium() const override { return medium_; }
+
+ private:
+  void CloseImpl() override {}
+
+  Medium medium_;
+};
+
+// A channel over a Pipe, looped back onto itself: writes are read back.
+struct LoopbackEndpoint {
+  LoopbackEndpoint()
+      : pipe(std::make_unique<Pipe>()),
+        channel(std::make_shared<PipeEndpointChannel>(pipe.get())) {}
+
+  std::unique_ptr<Pipe> pipe;
+  std::shared_ptr<EndpointChannel> channel;
+};
+
+// The length prefix of a |size| byte frame, as BaseEndpointChannel writes it.
+ByteArray FramePrefix(std::int32_t size) {
+  char bytes[] = {static_cast<char>(size >> 24), static_cast<char>(size >> 16),
+                  static_cast<char>(size >> 8), static_cast<char>(size)};
+  return ByteArray(bytes, sizeof(bytes));
+}
+
+// NOTE: Endpoints are declared before the pool in every test, so that their
+// pipes outlive the channels registered with the pool.
+class EndpointReaderPoolTest : public ::testing::Test {
+ protected:
+  static constexpr char kLastFrame[] = "last";
+  static constexpr absl::Duration kReplacementTimeout = absl::Seconds(1);
+
+  EndpointReaderPool::Handlers MakeHandlers(
+      std::shared_ptr<EndpointChannel> channel, CountDownLatch* frames_read,
+      CountDownLatch* stopped = nullptr) {
+    return {
+        .get_channel_cb =
+            [this, channel]() -> std::shared_ptr<EndpointChannel> {
+          absl::MutexLock lock(&mutex_);
+          if (!channel_available_) return nullptr;
+          return replacement_ != nullptr ? replacement_ : channel;
+        },
+        .read_frame_cb =
+            [this, frames_read](EndpointChannel* channel,
+                                absl::Duration* replacement_timeout) {
+              PacketMetaData packet_meta_data;
+              ExceptionOr<ByteArray> frame = channel->TryRead(packet_meta_data);
+              if (!frame.ok()) return ExceptionOr<bool>(frame.exception());
+              // Like a make-before-break LAST_WRITE: nothing more comes over
+              // this channel.
+              if (std::string(frame.result()) == kLastFrame) {
+                *replacement_timeout = kReplacementTimeout;
+                return ExceptionOr<bool>(Exception::kIo);
+              }
+              {
+                absl::MutexLock lock(&mutex_);
+                frames_.push_back(std::string(frame.result()));
+              }
+              frames_read->CountDown();
+              return ExceptionOr<bool>(true);
+            },
+        .stopped_cb =
+            [stopped]() {
+              if (stopped) stopped->CountDown();
+            },
+    };
+  }
+
+  std::vector<std::string> GetFrames() {
+    absl::MutexLock lock(&mutex_);
+    return frames_;
+  }
+
+  void ReplaceChannel(std::shared_ptr<EndpointChannel> channel) {
+    absl::MutexLock lock(&mutex_);
+    replacement_ = std::move(channel);
+  }
+
+  void MakeChannelUnavailable() {
+    absl::MutexLock lock(&mutex_);
+    channel_available_ = false;
+  }
+
+  absl::Mutex mutex_;
+  std::vector<std::string> frames_ ABSL_GUARDED_BY(mutex_);
+  bool channel_available_ ABSL_GUARDED_BY(mutex_) = true;
+  std::shared_ptr<EndpointChannel> replacement_ ABSL_GUARDED_BY(mutex_);
+};
+
+TEST_F(EndpointReaderPoolTest, RejectsChannelWithoutReadinessSupport) {
+  EndpointReaderPool pool(1);
+  CountDownLatch frames_read(1);
+  auto channel =
+      std::make_shared<FakeEndpointChannel>(Medium::BLE, "service_id");
+
+  EXPECT_FALSE(pool.Register("endpoint", MakeHandlers(channel, &frames_read)));
+  EXPECT_FALSE(pool.IsRegistered("endpoint"));
+}
+
+TEST_F(EndpointReaderPoolTest, DispatchesFramesInOrder) {
+  LoopbackEndpoint endpoint;
+  EndpointReaderPool pool(2);
+  CountDownLatch frames_read(3);
+
+  ASSERT_TRUE(
+      pool.Register("endpoint", MakeHandlers(endpoint.channel, &frames_read)));
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray("one")).Ok());
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray("two")).Ok());
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray("three")).Ok());
+
+  EXPECT_TRUE(frames_read.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(GetFrames(), (std::vector<std::string>{"one", "two", "three"}));
+  pool.Unregister("endpoint");
+}
+
+TEST_F(EndpointReaderPoolTest, ReadsFramesWrittenBeforeRegistration) {
+  LoopbackEndpoint endpoint;
+  EndpointReaderPool pool(1);
+  CountDownLatch frames_read(1);
+
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray("early")).Ok());
+  ASSERT_TRUE(
+      pool.Register("endpoint", MakeHandlers(endpoint.channel, &frames_read)));
+
+  EXPECT_TRUE(frames_read.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(GetFrames(), std::vector<std::string>{"early"});
+}
+
+TEST_F(EndpointReaderPoolTest, ServicesMoreEndpointsThanWorkers) {
+  constexpr int kEndpoints = 32;
+  constexpr int kFramesPerEndpoint = 20;
+  std::vector<LoopbackEndpoint> endpoints(kEndpoints);
+  EndpointReaderPool pool(2);
+  CountDownLatch frames_read(kEndpoints * kFramesPerEndpoint);
+
+  for (int i = 0; i < kEndpoints; ++i) {
+    ASSERT_TRUE(pool.Register(absl::StrCat("endpoint-", i),
+                              MakeHandlers(endpoints[i].channel,
+                                           &frames_read)));
+  }
+  EXPECT_EQ(pool.GetEndpointCount(), kEndpoints);
+  for (int frame = 0; frame < kFramesPerEndpoint; ++frame) {
+    for (auto& endpoint : endpoints) {
+      EXPECT_TRUE(endpoint.channel->Write(ByteArray("frame")).Ok());
+    }
+  }
+
+  EXPECT_TRUE(frames_read.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(GetFrames().size(), size_t{kEndpoints * kFramesPerEndpoint});
+}
+
+TEST_F(EndpointReaderPoolTest, StopsWhenChannelClosedAndNotReplaced) {
+  LoopbackEndpoint endpoint;
+  EndpointReaderPool pool(1);
+  CountDownLatch frames_read(1);
+  CountDownLatch stopped(1);
+
+  ASSERT_TRUE(pool.Register(
+      "endpoint", MakeHandlers(endpoint.channel, &frames_read, &stopped)));
+  MakeChannelUnavailable();
+  endpoint.channel->Close();
+
+  EXPECT_TRUE(stopped.Await(absl::Seconds(1)).result());
+  EXPECT_FALSE(pool.IsRegistered("endpoint"));
+}
+
+TEST_F(EndpointReaderPoolTest, UnregisterStopsDispatch) {
+  LoopbackEndpoint endpoint;
+  EndpointReaderPool pool(1);
+  CountDownLatch frames_read(1);
+  CountDownLatch stopped(1);
+
+  ASSERT_TRUE(pool.Register(
+      "endpoint", MakeHandlers(endpoint.channel, &frames_read, &stopped)));
+  pool.Unregister("endpoint");
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray("late")).Ok());
+
+  EXPECT_FALSE(frames_read.Await(absl::Milliseconds(100)).result());
+  EXPECT_FALSE(stopped.Await(absl::Milliseconds(100)).result());
+  EXPECT_TRUE(GetFrames().empty());
+}
+
+TEST_F(EndpointReaderPoolTest, PartialFrameDoesNotHoldUpWorker) {
+  LoopbackEndpoint slow;
+  LoopbackEndpoint fast;
+  EndpointReaderPool pool(1);
+  CountDownLatch first_frame(1);
+  CountDownLatch second_frame(1);
+
+  ASSERT_TRUE(pool.Register("slow", MakeHandlers(slow.channel, &second_frame)));
+  ASSERT_TRUE(pool.Register("fast", MakeHandlers(fast.channel, &first_frame)));
+  OutputStream& slow_output = slow.pipe->GetOutputStream();
+  EXPECT_TRUE(slow_output.Write(FramePrefix(7)).Ok());
+  EXPECT_TRUE(slow_output.Write(ByteArray("par")).Ok());
+  EXPECT_TRUE(fast.channel->Write(ByteArray("other")).Ok());
+
+  EXPECT_TRUE(first_frame.Await(absl::Seconds(1)).result());
+  EXPECT_TRUE(slow_output.Write(ByteArray("tial")).Ok());
+  EXPECT_TRUE(second_frame.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(GetFrames(), (std::vector<std::string>{"other", "partial"}));
+  pool.Unregister("slow");
+  pool.Unregister("fast");
+}
+
+TEST_F(EndpointReaderPoolTest, WaitsForReplacementWithoutHoldingWorker) {
+  LoopbackEndpoint replaced;
+  LoopbackEndpoint other;
+  auto replacement_pipe = std::make_unique<Pipe>();
+  auto replacement = std::make_shared<PipeEndpointChannel>(
+      replacement_pipe.get(), Medium::BLUETOOTH);
+  EndpointReaderPool pool(1);
+  CountDownLatch other_read(1);
+  CountDownLatch replacement_read(1);
+  CountDownLatch stopped(1);
+
+  ASSERT_TRUE(pool.Register(
+      "replaced",
+      MakeHandlers(replaced.channel, &replacement_read, &stopped)));
+  ASSERT_TRUE(pool.Register("other", MakeHandlers(other.channel, &other_read)));
+  EXPECT_TRUE(replaced.channel->Write(ByteArray(kLastFrame)).Ok());
+  EXPECT_TRUE(other.channel->Write(ByteArray("other")).Ok());
+
+  EXPECT_TRUE(other_read.Await(absl::Milliseconds(500)).result());
+  ReplaceChannel(replacement);
+  EXPECT_TRUE(replacement->Write(ByteArray("upgraded")).Ok());
+  EXPECT_TRUE(replacement_read.Await(absl::Seconds(1)).result());
+  EXPECT_FALSE(stopped.Await(absl::Milliseconds(100)).result());
+  EXPECT_EQ(GetFrames(), (std::vector<std::string>{"other", "upgraded"}));
+  pool.Unregister("replaced");
+  pool.Unregister("other");
+}
+
+TEST_F(EndpointReaderPoolTest, StopsWhenReplacementDoesNotArrive) {
+  LoopbackEndpoint endpoint;
+  EndpointReaderPool pool(1);
+  CountDownLatch frames_read(1);
+  CountDownLatch stopped(1);
+
+  ASSERT_TRUE(pool.Register(
+      "endpoint", MakeHandlers(endpoint.channel, &frames_read, &stopped)));
+  EXPECT_TRUE(endpoint.channel->Write(ByteArray(kLastFrame)).Ok());
+
+  EXPECT_FALSE(stopped.Await(kReplacementTimeout / 2).result());
+  EXPECT_TRUE(pool.IsRegistered("endpoint"));
+  EXPECT_TRUE(stopped.Await(kReplacementTimeout * 2).result());
+  EXPECT_FALSE(pool.IsRegistered("endpoint"));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
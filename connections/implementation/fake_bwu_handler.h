@@ -66,7 +66,8 @@ class FakeBwuHandler : public BaseBwuHandler {
   // handle_initialize_calls()[initialize_call_index], and sends it to the
   // BwuManager. Return a pointer to the upgraded channel.
   FakeEndpointChannel* NotifyBwuManagerOfIncomingConnection(
-      size_t initialize_call_index, BwuManager* bwu_manager) {
+      size_t initialize_call_index, BwuManager* bwu_manager,
+      bool supports_make_before_break = false) {
     CHECK_GT(handle_initialize_calls_.size(), initialize_call_index);
 
     // Simulate establishing a connection with the remote device (BWU
@@ -80,7 +81,8 @@ class FakeBwuHandler : public BaseBwuHandler {
     upgraded_channel->set_read_output(
         ExceptionOr<ByteArray>(parser::ForBwuIntroduction(
             *handle_initialize_calls_[initialize_call_index].endpoint_id,
-            false /* supports_disabling_encryption */)));
+            false /* supports_disabling_encryption */,
+            supports_make_before_break)));
     auto connection = std::make_unique<IncomingSocketConnection>();
     connection->channel = std::move(upgraded_channel);
 
@@ -15,6 +15,7 @@
 #ifndef NEARBY_CONNECTIONS_IMPLEMENTATION_FAKE_ENDPOINT_CHANNEL_H_
 #define NEARBY_CONNECTIONS_IMPLEMENTATION_FAKE_ENDPOINT_CHANNEL_H_
 
+#include <functional>
 #include <string>
 
 #include "connections/implementation/endpoint_channel.h"
@@ -45,14 +46,26 @@ class FakeEndpointChannel : public EndpointChannel {
     return read_output_;
   }
   Exception Write(const ByteArray& data) override {
+    if (last_write_written_) return {Exception::kIo};
     write_timestamp_ = SystemClock::ElapsedRealtime();
     return write_output_;
   }
   Exception Write(const ByteArray& data,
                   PacketMetaData& packet_meta_data) override {
+    if (last_write_written_) return {Exception::kIo};
     write_timestamp_ = SystemClock::ElapsedRealtime();
     return write_output_;
   }
+  Exception WriteLast(const ByteArray& data) override {
+    Exception result = Write(data);
+    if (result.Ok()) last_write_written_ = true;
+    return result;
+  }
+  Exception WriteUnencrypted(const ByteArray& data) override {
+    write_timestamp_ = SystemClock::ElapsedRealtime();
+    ++unencrypted_writes_;
+    return write_output_;
+  }
   void Close() override { is_closed_ = true; }
   void Close(proto::connections::DisconnectionReason reason) override {
     is_closed_ = true;
@@ -72,19 +85,30 @@ class FakeEndpointChannel : public EndpointChannel {
   std::string GetName() const override { return "fake-channel-" + service_id_; }
   Medium GetMedium() const override { return medium_; }
   int GetMaxTransmitPacketSize() const override { return 512; }
-  void EnableEncryption(std::shared_ptr<EncryptionContext> context) override {}
+  void EnableEncryption(const EncryptionContexts& contexts,
+                        std::shared_ptr<FrameCipher> cipher) override {}
   void DisableEncryption() override {}
   bool IsPaused() const override { return is_paused_; }
   void Pause() override { is_paused_ = true; }
   void Resume() override { is_paused_ = false; }
   absl::Time GetLastReadTimestamp() const override { return read_timestamp_; }
   absl::Time GetLastWriteTimestamp() const override { return write_timestamp_; }
+  bool IsReadable() override { return false; }
+  ExceptionOr<ByteArray> TryRead(PacketMetaData& packet_meta_data) override {
+    return {Exception::kTimeout};
+  }
+  bool SetReadinessListener(std::function<void()> listener) override {
+    return false;
+  }
   void SetAnalyticsRecorder(analytics::AnalyticsRecorder* analytics_recorder,
                             const std::string& endpoint_id) override {}
 
   void set_read_output(ExceptionOr<ByteArray> output) { read_output_ = output; }
   void set_write_output(Exception output) { write_output_ = output; }
   bool is_closed() const { return is_closed_; }
+  // Whether WriteLast() was called, after which Write() fails.
+  bool last_write_written() const { return last_write_written_; }
+  int unencrypted_writes() const { return unencrypted_writes_; }
   proto::connections::DisconnectionReason disconnection_reason() const {
     return disconnection_reason_;
   }
@@ -97,6 +121,8 @@ class FakeEndpointChannel : public EndpointChannel {
   absl::Time read_timestamp_ = absl::InfinitePast();
   absl::Time write_timestamp_ = absl::InfinitePast();
   bool is_closed_ = false;
+  bool last_write_written_ = false;
+  int unencrypted_writes_ = 0;
   bool is_paused_ = false;
   proto::connections::DisconnectionReason disconnection_reason_;
 };
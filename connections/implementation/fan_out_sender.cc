@@ -0,0 +1,212 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/fan_out_sender.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "connections/implementation/analytics/throughput_recorder.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+FanOutSender::FanOutSender(GetChannelCallback get_channel,
+                           VisitChannelCallback visit_channel,
+                           int max_queued_frames)
+    : get_channel_(std::move(get_channel)),
+      visit_channel_(std::move(visit_channel)),
+      max_queued_frames_(std::max(max_queued_frames, 1)) {}
+
+FanOutSender::~FanOutSender() {
+  absl::flat_hash_map<std::string, std::shared_ptr<EndpointQueue>> queues;
+  {
+    MutexLock lock(&mutex_);
+    for (auto& item : queues_) {
+      item.second->removed = true;
+      DropFramesLocked(item.first, *item.second, absl::nullopt);
+    }
+    queues.swap(queues_);
+  }
+  for (auto& item : queues) {
+    item.second->writer.Shutdown();
+  }
+}
+
+std::vector<std::string> FanOutSender::Send(
+    const std::vector<std::string>& endpoint_ids, const ByteArray& bytes,
+    std::int64_t payload_id, const analytics::PacketMetaData& packet_meta_data,
+    bool wait_for_all, FrameWrittenCallback on_written) {
+  auto frame = std::make_shared<Frame>();
+  frame->bytes = bytes;
+  frame->payload_id = payload_id;
+  frame->packet_meta_data = packet_meta_data;
+  frame->on_written = std::move(on_written);
+  absl::flat_hash_set<std::string> failed_endpoint_ids;
+  std::vector<std::pair<std::string, std::shared_ptr<EndpointQueue>>> queued;
+
+  MutexLock lock(&mutex_);
+  for (const std::string& endpoint_id : endpoint_ids) {
+    bool has_channel = false;
+    visit_channel_(endpoint_id, [&has_channel](EndpointChannel* channel) {
+      has_channel = channel != nullptr;
+    });
+    if (!has_channel) {
+      NEARBY_LOGS(ERROR) << "FanOutSender failed to find EndpointChannel over "
+                            "which to write a frame of Payload "
+                         << payload_id << " to endpoint " << endpoint_id;
+      failed_endpoint_ids.insert(endpoint_id);
+      continue;
+    }
+    std::shared_ptr<EndpointQueue>& queue = queues_[endpoint_id];
+    if (!queue) queue = std::make_shared<EndpointQueue>();
+    if (queue->failed_payload_ids.erase(payload_id) > 0) {
+      failed_endpoint_ids.insert(endpoint_id);
+      continue;
+    }
+    if (static_cast<int>(queue->frames.size()) >= max_queued_frames_) {
+      NEARBY_LOGS(INFO) << "FanOutSender: endpoint " << endpoint_id
+                        << " is lagging " << queue->frames.size()
+                        << " frames behind; failing Payload " << payload_id;
+      DropFramesLocked(endpoint_id, *queue, payload_id);
+      queue->failed_payload_ids.erase(payload_id);
+      failed_endpoint_ids.insert(endpoint_id);
+      continue;
+    }
+
+    queue->frames.push_back(frame);
+    ++frame->pending;
+    queued.emplace_back(endpoint_id, queue);
+    if (!queue->draining) {
+      queue->draining = true;
+      queue->writer.Execute("fan-out-writer", [this, endpoint_id, queue]() {
+        Drain(endpoint_id, queue);
+      });
+    }
+  }
+
+  while (frame->pending > 0 && (wait_for_all || frame->written == 0)) {
+    frame_done_.Wait();
+  }
+
+  // Besides this frame, endpoints that are still writing it may have failed
+  // an earlier one by now.
+  for (auto& item : queued) {
+    if (item.second->failed_payload_ids.erase(payload_id) > 0) {
+      failed_endpoint_ids.insert(item.first);
+    }
+  }
+
+  std::vector<std::string> result;
+  for (const std::string& endpoint_id : endpoint_ids) {
+    if (failed_endpoint_ids.contains(endpoint_id)) result.push_back(endpoint_id);
+  }
+  return result;
+}
+
+void FanOutSender::RemoveEndpoint(const std::string& endpoint_id) {
+  std::shared_ptr<EndpointQueue> queue;
+  {
+    MutexLock lock(&mutex_);
+    auto item = queues_.find(endpoint_id);
+    if (item == queues_.end()) return;
+    queue = std::move(item->second);
+    queues_.erase(item);
+    queue->removed = true;
+    DropFramesLocked(endpoint_id, *queue, absl::nullopt);
+  }
+  queue->writer.Shutdown();
+}
+
+void FanOutSender::Drain(const std::string& endpoint_id,
+                         std::shared_ptr<EndpointQueue> queue) {
+  while (true) {
+    std::shared_ptr<Frame> frame;
+    {
+      MutexLock lock(&mutex_);
+      if (queue->frames.empty() || queue->removed) {
+        queue->draining = false;
+        return;
+      }
+      frame = std::move(queue->frames.front());
+      queue->frames.pop_front();
+    }
+
+    EndpointChannel* channel = GetChannel(endpoint_id, *queue);
+    analytics::PacketMetaData packet_meta_data = frame->packet_meta_data;
+    Exception write_exception =
+        channel ? channel->Write(frame->bytes, packet_meta_data)
+                : Exception{Exception::kIo};
+    if (write_exception.Ok()) {
+      analytics::ThroughputRecorderContainer::GetInstance()
+          .GetTPRecorder(frame->payload_id)
+          ->OnFrameSent(channel->GetMedium(), packet_meta_data);
+      // Before the frame is done, so that a Send() waiting for all endpoints
+      // returns after the last of these.
+      if (frame->on_written) frame->on_written(endpoint_id);
+    }
+
+    MutexLock lock(&mutex_);
+    --frame->pending;
+    if (write_exception.Ok()) {
+      ++frame->written;
+    } else {
+      NEARBY_LOGS(INFO) << "FanOutSender failed to send packet; endpoint_id="
+                        << endpoint_id;
+      // The channel is likely gone; whatever else is queued for the endpoint
+      // would fail the same way.
+      queue->failed_payload_ids.insert(frame->payload_id);
+      DropFramesLocked(endpoint_id, *queue, absl::nullopt);
+    }
+    frame_done_.Notify();
+  }
+}
+
+EndpointChannel* FanOutSender::GetChannel(const std::string& endpoint_id,
+                                         EndpointQueue& queue) {
+  // |queue.channel| keeps its channel alive, so no other channel can have
+  // its address.
+  bool current = false;
+  visit_channel_(endpoint_id, [&current, &queue](EndpointChannel* channel) {
+    current = channel == queue.channel.get();
+  });
+  if (!current) queue.channel = get_channel_(endpoint_id);
+  return queue.channel.get();
+}
+
+void FanOutSender::DropFramesLocked(const std::string& endpoint_id,
+                                    EndpointQueue& queue,
+                                    absl::optional<std::int64_t> payload_id) {
+  auto dropped = std::stable_partition(
+      queue.frames.begin(), queue.frames.end(),
+      [&payload_id](const std::shared_ptr<Frame>& frame) {
+        return payload_id.has_value() && frame->payload_id != *payload_id;
+      });
+  for (auto it = dropped; it != queue.frames.end(); ++it) {
+    --(*it)->pending;
+    queue.failed_payload_ids.insert((*it)->payload_id);
+  }
+  queue.frames.erase(dropped, queue.frames.end());
+  frame_done_.Notify();
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,150 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_FAN_OUT_SENDER_H_
+#define CORE_INTERNAL_FAN_OUT_SENDER_H_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
+#include "absl/types/optional.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "connections/implementation/endpoint_channel.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Writes payload transfer frames to several endpoints in parallel.
+//
+// Every endpoint has a queue of frames and a writer of its own, so a slow
+// endpoint (eg. one on Bluetooth) falls behind on its own instead of holding
+// back the writes to every other endpoint. A frame is serialized once and
+// shared, not copied, between the queues; each endpoint's writer encrypts and
+// writes it to that endpoint's channel.
+//
+// Queues are bounded: an endpoint that has |max_queued_frames| frames waiting
+// when another one is sent is considered to be lagging, and the payload being
+// sent is failed for it.
+//
+// Each writer keeps a reference to the channel it writes to, and only checks,
+// through |visit_channel|, that it is still the current one; so writing a
+// frame copies no shared_ptr of the channel.
+class FanOutSender {
+ public:
+  using GetChannelCallback = std::function<std::shared_ptr<EndpointChannel>(
+      const std::string& endpoint_id)>;
+  // Runs |visitor| with the current channel of |endpoint_id|, or nullptr; as
+  // EndpointChannelManager::VisitChannelForEndpoint() does.
+  using VisitChannelCallback = std::function<void(
+      const std::string& endpoint_id,
+      absl::FunctionRef<void(EndpointChannel*)> visitor)>;
+  // Called on the writer of |endpoint_id| once it has written a frame.
+  using FrameWrittenCallback =
+      std::function<void(const std::string& endpoint_id)>;
+
+  FanOutSender(GetChannelCallback get_channel,
+               VisitChannelCallback visit_channel, int max_queued_frames);
+  ~FanOutSender();
+
+  // Queues |bytes|, a frame of payload |payload_id|, for each of
+  // |endpoint_ids|. Returns the endpoints to which the payload can no longer be
+  // sent: those that do not have a channel, are lagging, or failed to write a
+  // frame.
+  //
+  // Unless |wait_for_all| is set, returns as soon as the first endpoint has
+  // written the frame; write failures of the others are returned by a later
+  // call. With |wait_for_all|, returns once every endpoint is done with the
+  // frame (and all frames queued before it).
+  //
+  // Since the endpoints write the frame at their own pace, |on_written| is
+  // called for each one that does, possibly after Send() has returned; but
+  // before it returns, with |wait_for_all|.
+  std::vector<std::string> Send(
+      const std::vector<std::string>& endpoint_ids, const ByteArray& bytes,
+      std::int64_t payload_id,
+      const analytics::PacketMetaData& packet_meta_data, bool wait_for_all,
+      FrameWrittenCallback on_written = nullptr) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops the frames queued for |endpoint_id|, and waits for a write in
+  // progress to return.
+  void RemoveEndpoint(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Frame {
+    ByteArray bytes;
+    std::int64_t payload_id;
+    analytics::PacketMetaData packet_meta_data;
+    FrameWrittenCallback on_written;
+    // Number of endpoints that have yet to write the frame.
+    int pending = 0;
+    int written = 0;
+  };
+
+  struct EndpointQueue {
+    std::deque<std::shared_ptr<Frame>> frames;
+    // Set while a Drain() task is scheduled on |writer|.
+    bool draining = false;
+    // Payloads that failed to be written to the endpoint, and have yet to be
+    // reported as such by Send().
+    absl::flat_hash_set<std::int64_t> failed_payload_ids;
+    // Set once the endpoint has been removed.
+    bool removed = false;
+    // The channel last written to; only used by |writer|.
+    std::shared_ptr<EndpointChannel> channel;
+    SingleThreadExecutor writer;
+  };
+
+  // Writes the frames queued for |endpoint_id| until the queue is empty.
+  void Drain(const std::string& endpoint_id,
+             std::shared_ptr<EndpointQueue> queue) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the current channel of |endpoint_id|, reusing |queue.channel| if
+  // it is still the one. Called on |queue.writer|.
+  EndpointChannel* GetChannel(const std::string& endpoint_id,
+                              EndpointQueue& queue);
+  // Drops the frames of |payload_id| (or all frames, if it is not set) from
+  // |queue|, failing their payloads for |endpoint_id|.
+  void DropFramesLocked(const std::string& endpoint_id, EndpointQueue& queue,
+                        absl::optional<std::int64_t> payload_id)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const GetChannelCallback get_channel_;
+  const VisitChannelCallback visit_channel_;
+  const int max_queued_frames_;
+
+  Mutex mutex_;
+  // Signalled whenever an endpoint is done with a frame.
+  ConditionVariable frame_done_{&mutex_};
+  absl::flat_hash_map<std::string, std::shared_ptr<EndpointQueue>> queues_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_FAN_OUT_SENDER_H_
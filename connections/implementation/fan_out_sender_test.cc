@@ -0,0 +1,224 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/fan_out_sender.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "connections/implementation/fake_endpoint_channel.h"
+#include "internal/platform/count_down_latch.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr std::int64_t kPayloadId = 1;
+
+// Counts the frames written to it; writes block while the channel is held.
+class CountingEndpointChannel : public FakeEndpointChannel {
+ public:
+  CountingEndpointChannel()
+      : FakeEndpointChannel(Medium::WIFI_LAN, "service") {}
+
+  Exception Write(const ByteArray& data,
+                  PacketMetaData& packet_meta_data) override {
+    if (held_) {
+      writing_.CountDown();
+      released_.Await();
+    }
+    ++frames_written_;
+    return FakeEndpointChannel::Write(data, packet_meta_data);
+  }
+
+  void Hold() { held_ = true; }
+  void Release() { released_.CountDown(); }
+  // Waits for a write to block on the held channel.
+  void AwaitWriting() { writing_.Await(); }
+  int GetFramesWritten() const { return frames_written_; }
+
+ private:
+  std::atomic_bool held_ = false;
+  CountDownLatch writing_{1};
+  CountDownLatch released_{1};
+  std::atomic_int frames_written_ = 0;
+};
+
+class FanOutSenderTest : public ::testing::Test {
+ protected:
+  static constexpr int kMaxQueuedFrames = 4;
+
+  FanOutSenderTest()
+      : sender_(
+            [this](const std::string& endpoint_id) {
+              auto item = channels_.find(endpoint_id);
+              return item != channels_.end()
+                         ? item->second
+                         : std::shared_ptr<CountingEndpointChannel>();
+            },
+            [this](const std::string& endpoint_id,
+                   absl::FunctionRef<void(EndpointChannel*)> visitor) {
+              auto item = channels_.find(endpoint_id);
+              visitor(item != channels_.end() ? item->second.get() : nullptr);
+            },
+            kMaxQueuedFrames) {
+    channels_["fast"] = std::make_shared<CountingEndpointChannel>();
+    channels_["slow"] = std::make_shared<CountingEndpointChannel>();
+  }
+
+  std::vector<std::string> Send(const std::vector<std::string>& endpoint_ids,
+                                std::int64_t payload_id = kPayloadId,
+                                bool wait_for_all = false) {
+    return sender_.Send(endpoint_ids, ByteArray("frame"), payload_id,
+                        analytics::PacketMetaData(), wait_for_all);
+  }
+
+  absl::flat_hash_map<std::string, std::shared_ptr<CountingEndpointChannel>>
+      channels_;
+  FanOutSender sender_;
+};
+
+TEST_F(FanOutSenderTest, WritesFrameToAllEndpoints) {
+  EXPECT_THAT(Send({"fast", "slow"}, kPayloadId, /*wait_for_all=*/true),
+              IsEmpty());
+
+  EXPECT_EQ(channels_["fast"]->GetFramesWritten(), 1);
+  EXPECT_EQ(channels_["slow"]->GetFramesWritten(), 1);
+}
+
+TEST_F(FanOutSenderTest, ReportsFrameAsWrittenByEachEndpoint) {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, int> frames_written;
+  auto on_written = [&](const std::string& endpoint_id) {
+    absl::MutexLock lock(&mutex);
+    ++frames_written[endpoint_id];
+  };
+  auto count_written = [&](const std::string& endpoint_id) {
+    absl::MutexLock lock(&mutex);
+    return frames_written[endpoint_id];
+  };
+  channels_["slow"]->Hold();
+
+  EXPECT_THAT(sender_.Send({"fast", "slow"}, ByteArray("frame"), kPayloadId,
+                           analytics::PacketMetaData(),
+                           /*wait_for_all=*/false, on_written),
+              IsEmpty());
+  channels_["slow"]->AwaitWriting();
+  EXPECT_EQ(count_written("fast"), 1);
+  EXPECT_EQ(count_written("slow"), 0);
+
+  channels_["slow"]->Release();
+  EXPECT_THAT(sender_.Send({"fast", "slow"}, ByteArray("frame"), kPayloadId,
+                           analytics::PacketMetaData(),
+                           /*wait_for_all=*/true, on_written),
+              IsEmpty());
+  EXPECT_EQ(count_written("fast"), 2);
+  EXPECT_EQ(count_written("slow"), 2);
+}
+
+TEST_F(FanOutSenderTest, WritesToReplacedChannel) {
+  EXPECT_THAT(Send({"fast"}, kPayloadId, /*wait_for_all=*/true), IsEmpty());
+  auto replaced = channels_["fast"];
+  channels_["fast"] = std::make_shared<CountingEndpointChannel>();
+
+  EXPECT_THAT(Send({"fast"}, kPayloadId, /*wait_for_all=*/true), IsEmpty());
+
+  EXPECT_EQ(replaced->GetFramesWritten(), 1);
+  EXPECT_EQ(channels_["fast"]->GetFramesWritten(), 1);
+}
+
+TEST_F(FanOutSenderTest, FailsEndpointWithoutChannel) {
+  EXPECT_THAT(Send({"fast", "unknown"}), ElementsAre("unknown"));
+}
+
+TEST_F(FanOutSenderTest, SlowEndpointDoesNotHoldBackOthers) {
+  channels_["slow"]->Hold();
+
+  for (int i = 0; i < kMaxQueuedFrames; ++i) {
+    EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+  }
+  channels_["slow"]->AwaitWriting();
+  EXPECT_EQ(channels_["fast"]->GetFramesWritten(), kMaxQueuedFrames);
+  EXPECT_EQ(channels_["slow"]->GetFramesWritten(), 0);
+
+  channels_["slow"]->Release();
+  EXPECT_THAT(Send({"fast", "slow"}, kPayloadId, /*wait_for_all=*/true),
+              IsEmpty());
+  EXPECT_EQ(channels_["slow"]->GetFramesWritten(), kMaxQueuedFrames + 1);
+}
+
+TEST_F(FanOutSenderTest, LaggingEndpointFailsPayload) {
+  channels_["slow"]->Hold();
+
+  // One frame is being written, the others are queued.
+  EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+  channels_["slow"]->AwaitWriting();
+  for (int i = 0; i < kMaxQueuedFrames; ++i) {
+    EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+  }
+  EXPECT_THAT(Send({"fast", "slow"}), ElementsAre("slow"));
+
+  // The queued frames of the failed payload were dropped; other payloads
+  // still go through.
+  channels_["slow"]->Release();
+  EXPECT_THAT(Send({"fast", "slow"}, kPayloadId + 1, /*wait_for_all=*/true),
+              IsEmpty());
+  EXPECT_EQ(channels_["slow"]->GetFramesWritten(), 2);
+  EXPECT_EQ(channels_["fast"]->GetFramesWritten(), kMaxQueuedFrames + 3);
+}
+
+TEST_F(FanOutSenderTest, ReportsWriteFailure) {
+  channels_["slow"]->set_write_output(Exception{Exception::kIo});
+
+  EXPECT_THAT(Send({"fast", "slow"}, kPayloadId, /*wait_for_all=*/true),
+              ElementsAre("slow"));
+}
+
+TEST_F(FanOutSenderTest, ReportsWriteFailureOfEarlierFrame) {
+  channels_["slow"]->Hold();
+  channels_["slow"]->set_write_output(Exception{Exception::kIo});
+  EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+
+  channels_["slow"]->Release();
+  // The next call may find the write still in progress; waiting for all
+  // endpoints settles it.
+  std::vector<std::string> failed =
+      Send({"fast", "slow"}, kPayloadId, /*wait_for_all=*/true);
+  EXPECT_THAT(failed, ElementsAre("slow"));
+}
+
+TEST_F(FanOutSenderTest, RemoveEndpointFailsQueuedFrames) {
+  channels_["slow"]->Hold();
+  EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+  EXPECT_THAT(Send({"fast", "slow"}), IsEmpty());
+
+  channels_["slow"]->Release();
+  sender_.RemoveEndpoint("slow");
+  EXPECT_LE(channels_["slow"]->GetFramesWritten(), 2);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
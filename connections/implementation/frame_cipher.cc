@@ -0,0 +1,120 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/frame_cipher.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/types/span.h"
+#include "internal/crypto/hkdf.h"
+#include "internal/platform/logging.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+namespace {
+
+constexpr int kKeySize = 32;
+constexpr int kNonceSize = 12;
+constexpr char kKeySalt[] = "Nearby Connections frame cipher";
+constexpr char kClientKeyInfo[] = "client to server";
+constexpr char kServerKeyInfo[] = "server to client";
+
+absl::Span<const std::uint8_t> AsBytes(const ByteArray& bytes) {
+  return absl::MakeConstSpan(
+      reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+}
+
+absl::Span<const std::uint8_t> AsBytes(const std::string& bytes) {
+  return absl::MakeConstSpan(
+      reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size());
+}
+
+std::string GetNonce(std::uint64_t counter) {
+  // Four zero bytes followed by the counter, in network byte order.
+  std::string nonce(kNonceSize, '\0');
+  for (int i = kNonceSize - 1; i >= kNonceSize - 8; --i) {
+    nonce[i] = static_cast<char>(counter & 0xFF);
+    counter >>= 8;
+  }
+  return nonce;
+}
+
+}  // namespace
+
+constexpr int FrameCipher::kOverhead;
+
+std::unique_ptr<FrameCipher> FrameCipher::Create(
+    securegcm::D2DConnectionContextV1& context, bool is_client) {
+  std::unique_ptr<std::string> session_unique = context.GetSessionUnique();
+  if (session_unique == nullptr || session_unique->empty()) {
+    NEARBY_LOGS(WARNING) << __func__ << ": No UKEY2 session to key from.";
+    return nullptr;
+  }
+  std::string client_key =
+      crypto::HkdfSha256(*session_unique, kKeySalt, kClientKeyInfo, kKeySize);
+  std::string server_key =
+      crypto::HkdfSha256(*session_unique, kKeySalt, kServerKeyInfo, kKeySize);
+  if (is_client) {
+    return std::unique_ptr<FrameCipher>(
+        new FrameCipher(std::move(client_key), std::move(server_key)));
+  }
+  return std::unique_ptr<FrameCipher>(
+      new FrameCipher(std::move(server_key), std::move(client_key)));
+}
+
+FrameCipher::FrameCipher(std::string send_key, std::string receive_key)
+    : send_key_(std::move(send_key)), receive_key_(std::move(receive_key)) {
+  send_aead_.Init(&send_key_);
+  receive_aead_.Init(&receive_key_);
+}
+
+ExceptionOr<ByteArray> FrameCipher::Seal(const ByteArray& frame) {
+  std::string nonce = GetNonce(send_counter_.fetch_add(1));
+  // Sealed straight into the outgoing buffer; the frame is not copied.
+  ByteArray sealed(frame.size() + kOverhead);
+  absl::optional<size_t> size = send_aead_.Seal(
+      AsBytes(frame), AsBytes(nonce), {},
+      absl::MakeSpan(reinterpret_cast<std::uint8_t*>(sealed.data()),
+                     sealed.size()));
+  if (!size) {
+    return ExceptionOr<ByteArray>(Exception::kIo);
+  }
+  return ExceptionOr<ByteArray>(sealed.Slice(0, *size));
+}
+
+ExceptionOr<ByteArray> FrameCipher::Open(ByteArray sealed) {
+  if (sealed.size() < kOverhead) {
+    return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+  }
+  std::string nonce = GetNonce(receive_counter_);
+  // Copies the frame first if its storage is shared.
+  std::uint8_t* data = reinterpret_cast<std::uint8_t*>(sealed.data());
+  absl::optional<size_t> size = receive_aead_.Open(
+      absl::MakeConstSpan(data, sealed.size()), AsBytes(nonce), {},
+      absl::MakeSpan(data, sealed.size()));
+  if (!size) {
+    return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+  }
+  ++receive_counter_;
+  return ExceptionOr<ByteArray>(sealed.Slice(0, *size));
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,85 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_FRAME_CIPHER_H_
+#define CORE_INTERNAL_FRAME_CIPHER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "securegcm/d2d_connection_context_v1.h"
+#include "internal/crypto/aead.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Encrypts the frames of an endpoint with AES-256-GCM, as a cheaper
+// alternative to wrapping each of them in a SecureMessage with the UKEY2
+// connection context.
+//
+// Each direction has a key of its own, derived from the UKEY2 session, and a
+// frame counter that serves as the nonce. Neither side sends its counter: like
+// the sequence numbers of the connection context, both sides advance them in
+// frame order. A cipher is shared by all the channels of an endpoint, so that
+// a channel taking over from another one carries on with its counters instead
+// of reusing nonces.
+//
+// Seal() and Open() may run concurrently with each other. Calls to Open() must
+// be serialized, since frames have to be opened in the order they were sealed.
+class FrameCipher {
+ public:
+  // Bytes a sealed frame is longer than the frame.
+  static constexpr int kOverhead = 16;
+
+  // Returns a cipher for the session of |context|, or nullptr if the keys can
+  // not be derived. Both sides of the connection must agree on who is the
+  // client; that is the side that sent the connection request.
+  static std::unique_ptr<FrameCipher> Create(
+      securegcm::D2DConnectionContextV1& context, bool is_client);
+
+  FrameCipher(const FrameCipher&) = delete;
+  FrameCipher& operator=(const FrameCipher&) = delete;
+
+  // Returns |frame| sealed under the next send nonce.
+  ExceptionOr<ByteArray> Seal(const ByteArray& frame);
+
+  // Returns the frame sealed in |sealed|, opened under the next receive
+  // nonce. The frame is opened in place, unless the storage of |sealed| is
+  // shared, in which case it is copied first; on failure, the receive nonce is
+  // not used up.
+  ExceptionOr<ByteArray> Open(ByteArray sealed);
+
+ private:
+  FrameCipher(std::string send_key, std::string receive_key);
+
+  // Aead keeps a reference to its key.
+  const std::string send_key_;
+  const std::string receive_key_;
+  crypto::Aead send_aead_{crypto::Aead::AES_256_GCM};
+  crypto::Aead receive_aead_{crypto::Aead::AES_256_GCM};
+  // Atomic, so that two channels sealing at once never share a nonce.
+  std::atomic<std::uint64_t> send_counter_{0};
+  std::uint64_t receive_counter_ = 0;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_FRAME_CIPHER_H_
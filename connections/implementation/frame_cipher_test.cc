@@ -0,0 +1,160 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/frame_cipher.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "securegcm/d2d_connection_context_v1.h"
+#include "securegcm/ukey2_handshake.h"
+#include "gtest/gtest.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using EncryptionContext = securegcm::D2DConnectionContextV1;
+
+// Runs a UKEY2 handshake in memory, and returns the client and the server
+// contexts.
+std::pair<std::unique_ptr<EncryptionContext>,
+          std::unique_ptr<EncryptionContext>>
+CreateContextPair() {
+  constexpr auto kCipher =
+      securegcm::UKey2Handshake::HandshakeCipher::P256_SHA512;
+  auto client = securegcm::UKey2Handshake::ForInitiator(kCipher);
+  auto server = securegcm::UKey2Handshake::ForResponder(kCipher);
+  server->ParseHandshakeMessage(*client->GetNextHandshakeMessage());
+  client->ParseHandshakeMessage(*server->GetNextHandshakeMessage());
+  server->ParseHandshakeMessage(*client->GetNextHandshakeMessage());
+  client->VerifyHandshake();
+  server->VerifyHandshake();
+  return {client->ToConnectionContext(), server->ToConnectionContext()};
+}
+
+class FrameCipherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    auto [client_context, server_context] = CreateContextPair();
+    ASSERT_NE(client_context, nullptr);
+    ASSERT_NE(server_context, nullptr);
+    client_ = FrameCipher::Create(*client_context, /*is_client=*/true);
+    server_ = FrameCipher::Create(*server_context, /*is_client=*/false);
+    ASSERT_NE(client_, nullptr);
+    ASSERT_NE(server_, nullptr);
+  }
+
+  std::unique_ptr<FrameCipher> client_;
+  std::unique_ptr<FrameCipher> server_;
+};
+
+TEST_F(FrameCipherTest, OpensWhatThePeerSealed) {
+  ByteArray frame("frame from the client");
+  ExceptionOr<ByteArray> sealed = client_->Seal(frame);
+  ASSERT_TRUE(sealed.ok());
+  EXPECT_EQ(sealed.result().size(), frame.size() + FrameCipher::kOverhead);
+  EXPECT_EQ(std::string(sealed.result()).find(std::string(frame)),
+            std::string::npos);
+
+  ExceptionOr<ByteArray> opened = server_->Open(sealed.result());
+  ASSERT_TRUE(opened.ok());
+  EXPECT_EQ(opened.result(), frame);
+
+  ByteArray reply("frame from the server");
+  sealed = server_->Seal(reply);
+  ASSERT_TRUE(sealed.ok());
+  opened = client_->Open(std::move(sealed.result()));
+  ASSERT_TRUE(opened.ok());
+  EXPECT_EQ(opened.result(), reply);
+}
+
+TEST_F(FrameCipherTest, SealsEveryFrameUnderANewNonce) {
+  ByteArray frame("frame");
+  ExceptionOr<ByteArray> first = client_->Seal(frame);
+  ExceptionOr<ByteArray> second = client_->Seal(frame);
+  ASSERT_TRUE(first.ok());
+  ASSERT_TRUE(second.ok());
+  EXPECT_NE(first.result(), second.result());
+
+  // Frames open in the order they were sealed in only.
+  EXPECT_FALSE(server_->Open(second.result()).ok());
+  EXPECT_TRUE(server_->Open(first.result()).ok());
+  EXPECT_TRUE(server_->Open(second.result()).ok());
+}
+
+TEST_F(FrameCipherTest, DoesNotOpenTamperedFrame) {
+  ExceptionOr<ByteArray> sealed = client_->Seal(ByteArray("frame"));
+  ASSERT_TRUE(sealed.ok());
+  ByteArray tampered = sealed.result();
+  tampered.data()[0] ^= 1;
+
+  ExceptionOr<ByteArray> opened = server_->Open(tampered);
+  EXPECT_FALSE(opened.ok());
+  EXPECT_EQ(opened.exception(), Exception::kInvalidProtocolBuffer);
+  // The failed attempt did not use up the nonce.
+  EXPECT_TRUE(server_->Open(sealed.result()).ok());
+}
+
+TEST_F(FrameCipherTest, DoesNotOpenOwnFrames) {
+  // The directions are keyed separately, so a reflected frame does not open.
+  ExceptionOr<ByteArray> sealed = client_->Seal(ByteArray("frame"));
+  ASSERT_TRUE(sealed.ok());
+  EXPECT_FALSE(client_->Open(sealed.result()).ok());
+}
+
+TEST_F(FrameCipherTest, DoesNotOpenTruncatedFrame) {
+  EXPECT_FALSE(server_->Open(ByteArray("short")).ok());
+}
+
+TEST_F(FrameCipherTest, SealsEmptyFrame) {
+  ExceptionOr<ByteArray> sealed = client_->Seal(ByteArray());
+  ASSERT_TRUE(sealed.ok());
+  ExceptionOr<ByteArray> opened = server_->Open(sealed.result());
+  ASSERT_TRUE(opened.ok());
+  EXPECT_TRUE(opened.result().Empty());
+}
+
+TEST_F(FrameCipherTest, OpensInPlaceWithoutCopying) {
+  ByteArray frame(std::string(64 * 1024, 'x'));
+  ByteCopyCounter::Reset();
+  ExceptionOr<ByteArray> sealed = client_->Seal(frame);
+  ASSERT_TRUE(sealed.ok());
+  ExceptionOr<ByteArray> opened = server_->Open(std::move(sealed.result()));
+  ASSERT_TRUE(opened.ok());
+
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 0);
+  EXPECT_EQ(opened.result(), frame);
+}
+
+TEST(FrameCipherRoleTest, SidesMustAgreeOnTheClient) {
+  auto [context_a, context_b] = CreateContextPair();
+  std::unique_ptr<FrameCipher> cipher_a =
+      FrameCipher::Create(*context_a, /*is_client=*/true);
+  std::unique_ptr<FrameCipher> cipher_b =
+      FrameCipher::Create(*context_b, /*is_client=*/true);
+
+  ExceptionOr<ByteArray> sealed = cipher_a->Seal(ByteArray("frame"));
+  ASSERT_TRUE(sealed.ok());
+  EXPECT_FALSE(cipher_b->Open(sealed.result()).ok());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -16,6 +16,7 @@
 #define CORE_INTERNAL_INTERNAL_PAYLOAD_H_
 
 #include <cstdint>
+#include <string>
 
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/payload.h"
@@ -95,6 +96,15 @@ class InternalPayload {
   // early, e.g. after being cancelled or having no more recipients left.
   virtual void Close() {}
 
+  // Returns true if the Payload can be handed to the client. Incoming payloads
+  // are handed over with their first chunk, except for a BYTES payload that is
+  // sent in several chunks; it is only handed over once it is complete.
+  virtual bool IsReadyForClient() const { return true; }
+
+  // Returns the path that an incoming FILE payload is written to, or an empty
+  // string if it is not written to a path of its own.
+  virtual std::string GetFilePath() const { return {}; }
+
  protected:
   Payload payload_;
   // We're caching the payload ID here because the backing payload will be
@@ -15,11 +15,13 @@
 #include "connections/implementation/internal_payload_factory.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/memory/memory.h"
+#include "connections/implementation/chunk_write_behind.h"
 #include "connections/implementation/offline_frames_validator.h"
 #include "connections/payload.h"
 #include "internal/platform/byte_array.h"
@@ -40,12 +42,16 @@ namespace connections {
 
 namespace {
 
+// The largest BYTES payload that is reassembled from chunks; it is held in
+// memory whole.
+constexpr std::int64_t kMaxChunkedBytesPayloadSize = 64 * 1024 * 1024;
+
 class BytesInternalPayload : public InternalPayload {
  public:
-  explicit BytesInternalPayload(Payload payload)
+  BytesInternalPayload(Payload payload, bool chunked)
       : InternalPayload(std::move(payload)),
         total_size_(payload_.AsBytes().size()),
-        detached_only_chunk_(false) {}
+        chunked_(chunked) {}
 
   PayloadTransferFrame::PayloadHeader::PayloadType GetType() const override {
     return PayloadTransferFrame::PayloadHeader::BYTES;
@@ -54,14 +60,25 @@ class BytesInternalPayload : public InternalPayload {
   std::int64_t GetTotalSize() const override { return total_size_; }
 
   // Relinquishes ownership of the payload_; retrieves and returns the stored
-  // ByteArray.
+  // ByteArray, either whole or, if chunking is enabled, in slices of
+  // |chunk_size| bytes.
   ByteArray DetachNextChunk(int chunk_size) override {
-    if (detached_only_chunk_) {
-      return {};
+    if (!detached_) {
+      detached_ = true;
+      bytes_ = std::move(payload_).AsBytes();
+    }
+    if (!chunked_) {
+      return std::move(bytes_);
     }
 
-    detached_only_chunk_ = true;
-    return std::move(payload_).AsBytes();
+    if (next_chunk_offset_ >= bytes_.size()) {
+      bytes_ = ByteArray();
+      return {};
+    }
+    // Slices share the payload's storage; nothing is copied.
+    ByteArray chunk = bytes_.Slice(next_chunk_offset_, chunk_size);
+    next_chunk_offset_ += chunk.size();
+    return chunk;
   }
 
   // Does nothing.
@@ -79,7 +96,59 @@ class BytesInternalPayload : public InternalPayload {
   // moved to another owner during the lifetime of an incoming
   // InternalPayload.
   const std::int64_t total_size_;
-  bool detached_only_chunk_;
+  const bool chunked_;
+  bool detached_ = false;
+  ByteArray bytes_;
+  size_t next_chunk_offset_ = 0;
+};
+
+// Reassembles a BYTES payload that was sent in more than one chunk. The
+// payload is only handed to the client once all of its bytes have arrived.
+class IncomingChunkedBytesInternalPayload : public InternalPayload {
+ public:
+  IncomingChunkedBytesInternalPayload(Payload::Id payload_id,
+                                      std::int64_t total_size)
+      : InternalPayload(Payload(payload_id, ByteArray())),
+        total_size_(total_size),
+        bytes_(total_size) {}
+
+  PayloadTransferFrame::PayloadHeader::PayloadType GetType() const override {
+    return PayloadTransferFrame::PayloadHeader::BYTES;
+  }
+
+  std::int64_t GetTotalSize() const override { return total_size_; }
+
+  ByteArray DetachNextChunk(int chunk_size) override { return {}; }
+
+  Exception AttachNextChunk(const ByteArray& chunk) override {
+    // The empty last chunk follows the one that completed the payload.
+    if (chunk.Empty()) return {Exception::kSuccess};
+
+    if (received_ + static_cast<std::int64_t>(chunk.size()) > total_size_) {
+      NEARBY_LOGS(WARNING) << "Incoming bytes payload " << payload_id_
+                           << " overflows its total size of " << total_size_;
+      return {Exception::kIo};
+    }
+    std::memcpy(bytes_.data() + received_, chunk.data(), chunk.size());
+    ByteCopyCounter::Record(chunk.size());
+    received_ += chunk.size();
+    if (received_ == total_size_) {
+      payload_ = Payload(payload_id_, std::move(bytes_));
+    }
+    return {Exception::kSuccess};
+  }
+
+  ExceptionOr<size_t> SkipToOffset(size_t offset) override {
+    NEARBY_LOGS(WARNING) << "Bytes payload does not support offsets";
+    return {Exception::kIo};
+  }
+
+  bool IsReadyForClient() const override { return received_ == total_size_; }
+
+ private:
+  const std::int64_t total_size_;
+  ByteArray bytes_;
+  std::int64_t received_ = 0;
 };
 
 class OutgoingStreamInternalPayload : public InternalPayload {
@@ -253,11 +322,19 @@ class OutgoingFileInternalPayload : public InternalPayload {
 
 class IncomingFileInternalPayload : public InternalPayload {
  public:
-  IncomingFileInternalPayload(Payload payload, OutputFile output_file,
-                              std::int64_t total_size)
+  IncomingFileInternalPayload(Payload payload, std::string file_path,
+                              OutputFile output_file, std::int64_t total_size)
       : InternalPayload(std::move(payload)),
+        file_path_(std::move(file_path)),
         output_file_(std::move(output_file)),
-        total_size_(total_size) {}
+        total_size_(total_size) {
+    const auto& flags = FeatureFlags::GetInstance().GetFlags();
+    if (flags.enable_file_write_behind) {
+      write_behind_ = std::make_unique<ChunkWriteBehind>(
+          output_file_.GetOutputStream(), flags.file_write_behind_queue_bytes,
+          flags.file_write_behind_write_bytes);
+    }
+  }
 
   PayloadTransferFrame::PayloadHeader::PayloadType GetType() const override {
     return PayloadTransferFrame::PayloadHeader::FILE;
@@ -265,15 +342,20 @@ class IncomingFileInternalPayload : public InternalPayload {
 
   std::int64_t GetTotalSize() const override { return total_size_; }
 
+  std::string GetFilePath() const override { return file_path_; }
+
   ByteArray DetachNextChunk(int chunk_size) override { return {}; }
 
   Exception AttachNextChunk(const ByteArray& chunk) override {
     if (chunk.Empty()) {
-      // Received null last chunk for incoming payload.
+      // Received null last chunk for incoming payload. The file must be
+      // complete before the payload is reported as such.
+      Exception result = FinishWrites();
       output_file_.Close();
-      return {Exception::kSuccess};
+      return result;
     }
 
+    if (write_behind_) return write_behind_->Write(chunk);
     return output_file_.Write(chunk);
   }
 
@@ -283,11 +365,22 @@ class IncomingFileInternalPayload : public InternalPayload {
     return {Exception::kIo};
   }
 
-  void Close() override { output_file_.Close(); }
+  void Close() override {
+    FinishWrites();
+    output_file_.Close();
+  }
 
  private:
+  Exception FinishWrites() {
+    if (!write_behind_) return {Exception::kSuccess};
+    return write_behind_->Finish();
+  }
+
+  const std::string file_path_;
   OutputFile output_file_;
   const std::int64_t total_size_;
+  // Writes to |output_file_|, if enabled; must be destroyed before it.
+  std::unique_ptr<ChunkWriteBehind> write_behind_;
 };
 
 }  // namespace
@@ -296,10 +389,11 @@ using location::nearby::api::ImplementationPlatform;
 using location::nearby::api::OSName;
 
 std::unique_ptr<InternalPayload> CreateOutgoingInternalPayload(
-    Payload payload) {
+    Payload payload, bool chunk_bytes) {
   switch (payload.GetType()) {
     case PayloadType::kBytes:
-      return absl::make_unique<BytesInternalPayload>(std::move(payload));
+      return absl::make_unique<BytesInternalPayload>(std::move(payload),
+                                                     chunk_bytes);
 
     case PayloadType::kFile: {
       return absl::make_unique<OutgoingFileInternalPayload>(std::move(payload));
@@ -335,8 +429,23 @@ std::unique_ptr<InternalPayload> CreateIncomingInternalPayload(
   const Payload::Id payload_id = frame.payload_header().id();
   switch (frame.payload_header().type()) {
     case PayloadTransferFrame::PayloadHeader::BYTES: {
+      // A chunked payload is reassembled as the rest of its chunks arrive.
+      std::int64_t total_size = frame.payload_header().total_size();
+      if ((frame.payload_chunk().flags() &
+           PayloadTransferFrame::PayloadChunk::MORE_CHUNKS) != 0 &&
+          total_size > static_cast<std::int64_t>(
+                           frame.payload_chunk().body().size())) {
+        if (total_size > kMaxChunkedBytesPayloadSize) {
+          NEARBY_LOGS(WARNING) << "Incoming bytes payload " << payload_id
+                               << " is too large: " << total_size;
+          return {};
+        }
+        return absl::make_unique<IncomingChunkedBytesInternalPayload>(
+            payload_id, total_size);
+      }
       return absl::make_unique<BytesInternalPayload>(
-          Payload(payload_id, ByteArray(frame.payload_chunk().body())));
+          Payload(payload_id, ByteArray(frame.payload_chunk().body())),
+          /*chunked=*/false);
     }
 
     case PayloadTransferFrame::PayloadHeader::STREAM: {
@@ -387,12 +496,12 @@ std::unique_ptr<InternalPayload> CreateIncomingInternalPayload(
       if (ImplementationPlatform::GetCurrentOS() == OSName::kChromeOS) {
         return absl::make_unique<IncomingFileInternalPayload>(
             Payload(payload_id, InputFile(payload_id, total_size)),
-            OutputFile(payload_id), total_size);
+            /*file_path=*/std::string(), OutputFile(payload_id), total_size);
       } else {
         return absl::make_unique<IncomingFileInternalPayload>(
             Payload(payload_id, parent_folder, file_name,
                     InputFile(file_path, total_size)),
-            OutputFile(file_path), total_size);
+            file_path, OutputFile(file_path), total_size);
       }
     }
     default:
@@ -22,8 +22,11 @@ namespace location {
 namespace nearby {
 namespace connections {
 
-// Creates an InternalPayload representing an outgoing Payload.
-std::unique_ptr<InternalPayload> CreateOutgoingInternalPayload(Payload payload);
+// Creates an InternalPayload representing an outgoing Payload. A BYTES
+// payload is detached in chunks only if |chunk_bytes| is set, which every
+// receiver must have agreed to.
+std::unique_ptr<InternalPayload> CreateOutgoingInternalPayload(
+    Payload payload, bool chunk_bytes = false);
 
 // Creates an InternalPayload representing an incoming Payload from a remote
 // endpoint.
@@ -23,6 +23,7 @@
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/implementation/offline_frames.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/pipe.h"
 
 namespace location {
@@ -218,6 +219,76 @@ TEST(InternalPayloadFactoryTest,
   EXPECT_EQ(contents_after_skip, ByteArray("6789"));
 }
 
+TEST(InternalPayloadFactoryTest, ChunkedBytePayloadIsDetachedInSlices) {
+  std::unique_ptr<InternalPayload> internal_payload =
+      CreateOutgoingInternalPayload(Payload{ByteArray("0123456789")},
+                                    /*chunk_bytes=*/true);
+  EXPECT_NE(internal_payload, nullptr);
+
+  EXPECT_EQ(internal_payload->DetachNextChunk(4), ByteArray("0123"));
+  EXPECT_EQ(internal_payload->DetachNextChunk(4), ByteArray("4567"));
+  EXPECT_EQ(internal_payload->DetachNextChunk(4), ByteArray("89"));
+  EXPECT_TRUE(internal_payload->DetachNextChunk(4).Empty());
+}
+
+TEST(InternalPayloadFactoryTest, BytePayloadIsDetachedWholeUnlessChunked) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_bytes_payload_chunking =
+      true;
+  std::unique_ptr<InternalPayload> internal_payload =
+      CreateOutgoingInternalPayload(Payload{ByteArray("0123456789")});
+  EXPECT_NE(internal_payload, nullptr);
+
+  EXPECT_EQ(internal_payload->DetachNextChunk(4), ByteArray("0123456789"));
+  FeatureFlags::GetMutableFlagsForTesting().enable_bytes_payload_chunking =
+      false;
+}
+
+TEST(InternalPayloadFactoryTest, ChunkedByteMessageIsReassembled) {
+  PayloadTransferFrame frame;
+  frame.set_packet_type(PayloadTransferFrame::DATA);
+  auto& header = *frame.mutable_payload_header();
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_id(12345);
+  header.set_total_size(10);
+  auto& payload_chunk = *frame.mutable_payload_chunk();
+  payload_chunk.set_offset(0);
+  payload_chunk.set_body("0123");
+  payload_chunk.set_flags(PayloadTransferFrame::PayloadChunk::MORE_CHUNKS);
+  std::unique_ptr<InternalPayload> internal_payload =
+      CreateIncomingInternalPayload(frame);
+  EXPECT_NE(internal_payload, nullptr);
+
+  EXPECT_FALSE(internal_payload->IsReadyForClient());
+  EXPECT_FALSE(internal_payload->AttachNextChunk(ByteArray("0123")).Raised());
+  EXPECT_FALSE(internal_payload->AttachNextChunk(ByteArray("456")).Raised());
+  EXPECT_FALSE(internal_payload->IsReadyForClient());
+  EXPECT_FALSE(internal_payload->AttachNextChunk(ByteArray("789")).Raised());
+  EXPECT_TRUE(internal_payload->IsReadyForClient());
+  EXPECT_FALSE(internal_payload->AttachNextChunk(ByteArray()).Raised());
+  Payload payload = internal_payload->ReleasePayload();
+  EXPECT_EQ(payload.GetId(), 12345);
+  EXPECT_EQ(payload.AsBytes(), ByteArray("0123456789"));
+}
+
+TEST(InternalPayloadFactoryTest, ChunkedByteMessageRejectsOverflow) {
+  PayloadTransferFrame frame;
+  frame.set_packet_type(PayloadTransferFrame::DATA);
+  auto& header = *frame.mutable_payload_header();
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_id(12345);
+  header.set_total_size(6);
+  auto& payload_chunk = *frame.mutable_payload_chunk();
+  payload_chunk.set_offset(0);
+  payload_chunk.set_body("0123");
+  payload_chunk.set_flags(PayloadTransferFrame::PayloadChunk::MORE_CHUNKS);
+  std::unique_ptr<InternalPayload> internal_payload =
+      CreateIncomingInternalPayload(frame);
+  EXPECT_NE(internal_payload, nullptr);
+
+  EXPECT_FALSE(internal_payload->AttachNextChunk(ByteArray("0123")).Raised());
+  EXPECT_TRUE(internal_payload->AttachNextChunk(ByteArray("456")).Raised());
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -0,0 +1,268 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/keep_alive_scheduler.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+constexpr absl::Duration KeepAliveScheduler::kDefaultResolution;
+constexpr int KeepAliveScheduler::kSlotBits;
+constexpr int KeepAliveScheduler::kSlotsPerLevel;
+constexpr int KeepAliveScheduler::kSlotMask;
+constexpr int KeepAliveScheduler::kLevels;
+constexpr std::int64_t KeepAliveScheduler::kMaxDelta;
+constexpr int KeepAliveScheduler::kNumWorkers;
+
+KeepAliveScheduler::KeepAliveScheduler(absl::Duration resolution)
+    : resolution_(resolution), origin_(SystemClock::ElapsedRealtime()) {}
+
+KeepAliveScheduler::~KeepAliveScheduler() {
+  {
+    MutexLock lock(&mutex_);
+    shutdown_ = true;
+    for (auto& item : timers_) {
+      item.second->cancelled = true;
+    }
+    timers_.clear();
+    for (auto& level : wheel_) {
+      for (auto& slot : level) {
+        slot.clear();
+      }
+    }
+    timers_per_level_.fill(0);
+  }
+  alarm_executor_.Shutdown();
+  workers_.Shutdown();
+}
+
+bool KeepAliveScheduler::Schedule(const std::string& id, absl::Duration delay,
+                                  Task task) {
+  MutexLock lock(&mutex_);
+  if (shutdown_ || timers_.contains(id)) return false;
+
+  // Catch up with the clock first, so the new timer is placed relative to
+  // the present.
+  DispatchDueTimersLocked(GetCurrentTick());
+  auto timer = std::make_shared<Timer>();
+  timer->id = id;
+  timer->task = std::move(task);
+  timer->expiry_tick = std::max(ToExpiryTick(delay), current_tick_ + 1);
+  timers_.emplace(id, timer);
+  InsertLocked(std::move(timer));
+  ScheduleWakeupLocked();
+  return true;
+}
+
+void KeepAliveScheduler::Cancel(const std::string& id) {
+  MutexLock lock(&mutex_);
+  auto item = timers_.find(id);
+  if (item == timers_.end()) return;
+  std::shared_ptr<Timer> timer = item->second;
+  timers_.erase(item);
+  timer->cancelled = true;
+  if (timer->in_wheel) RemoveLocked(*timer);
+  while (timer->running) {
+    timer_done_.Wait();
+  }
+}
+
+bool KeepAliveScheduler::IsScheduled(const std::string& id) const {
+  MutexLock lock(&mutex_);
+  return timers_.contains(id);
+}
+
+std::int64_t KeepAliveScheduler::GetWakeupCount() const {
+  MutexLock lock(&mutex_);
+  return wakeup_count_;
+}
+
+std::int64_t KeepAliveScheduler::GetCurrentTick() const {
+  return (SystemClock::ElapsedRealtime() - origin_) / resolution_;
+}
+
+std::int64_t KeepAliveScheduler::ToExpiryTick(absl::Duration delay) const {
+  absl::Duration deadline =
+      SystemClock::ElapsedRealtime() + std::max(delay, absl::ZeroDuration()) -
+      origin_;
+  absl::Duration remainder;
+  std::int64_t tick = absl::IDivDuration(deadline, resolution_, &remainder);
+  return remainder > absl::ZeroDuration() ? tick + 1 : tick;
+}
+
+void KeepAliveScheduler::InsertLocked(std::shared_ptr<Timer> timer) {
+  // Due timers go into the next slot to be looked at; while cascading, that
+  // is the slot of the current tick.
+  std::int64_t tick = std::max(timer->expiry_tick, current_tick_);
+  std::int64_t delta = tick - current_tick_;
+  if (delta > kMaxDelta) {
+    // Parked at the far end of the wheel; re-inserted when it gets there.
+    delta = kMaxDelta;
+    tick = current_tick_ + kMaxDelta;
+  }
+  int level = 0;
+  while (level < kLevels - 1 &&
+         delta >= (std::int64_t{1} << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  timer->level = level;
+  timer->slot = (tick >> (kSlotBits * level)) & kSlotMask;
+  Slot& slot = wheel_[level][timer->slot];
+  timer->position = slot.insert(slot.end(), timer);
+  timer->in_wheel = true;
+  ++timers_per_level_[level];
+}
+
+void KeepAliveScheduler::RemoveLocked(Timer& timer) {
+  wheel_[timer.level][timer.slot].erase(timer.position);
+  timer.in_wheel = false;
+  --timers_per_level_[timer.level];
+}
+
+void KeepAliveScheduler::CascadeLocked(int level, int slot) {
+  Slot timers;
+  timers.swap(wheel_[level][slot]);
+  timers_per_level_[level] -= timers.size();
+  for (auto& timer : timers) {
+    timer->in_wheel = false;
+    InsertLocked(std::move(timer));
+  }
+}
+
+void KeepAliveScheduler::AdvanceLocked(
+    std::int64_t tick, std::list<std::shared_ptr<Timer>>& expired) {
+  while (current_tick_ < tick) {
+    // Skip over ticks with nothing to do.
+    std::int64_t next_tick = GetNextWakeupTickLocked();
+    if (next_tick < 0 || next_tick > tick) {
+      current_tick_ = tick;
+      return;
+    }
+    current_tick_ = next_tick;
+
+    for (int level = kLevels - 1; level > 0; --level) {
+      std::int64_t level_mask = (std::int64_t{1} << (kSlotBits * level)) - 1;
+      if ((current_tick_ & level_mask) == 0) {
+        CascadeLocked(level,
+                      (current_tick_ >> (kSlotBits * level)) & kSlotMask);
+      }
+    }
+
+    Slot timers;
+    timers.swap(wheel_[0][current_tick_ & kSlotMask]);
+    timers_per_level_[0] -= timers.size();
+    for (auto& timer : timers) {
+      timer->in_wheel = false;
+      if (timer->expiry_tick > current_tick_) {
+        InsertLocked(std::move(timer));
+      } else {
+        expired.push_back(std::move(timer));
+      }
+    }
+  }
+}
+
+std::int64_t KeepAliveScheduler::GetNextWakeupTickLocked() const {
+  std::int64_t next_tick = -1;
+  if (timers_per_level_[0] > 0) {
+    for (int i = 1; i <= kSlotsPerLevel; ++i) {
+      std::int64_t tick = current_tick_ + i;
+      if (!wheel_[0][tick & kSlotMask].empty()) {
+        next_tick = tick;
+        break;
+      }
+    }
+  }
+  for (int level = 1; level < kLevels; ++level) {
+    if (timers_per_level_[level] == 0) continue;
+    // A slot on this level is due when the lower levels wrap around onto it.
+    int shift = kSlotBits * level;
+    std::int64_t base = current_tick_ >> shift;
+    for (int i = 1; i <= kSlotsPerLevel; ++i) {
+      if (!wheel_[level][(base + i) & kSlotMask].empty()) {
+        std::int64_t tick = (base + i) << shift;
+        if (next_tick < 0 || tick < next_tick) next_tick = tick;
+        break;
+      }
+    }
+  }
+  return next_tick;
+}
+
+void KeepAliveScheduler::ScheduleWakeupLocked() {
+  std::int64_t tick = GetNextWakeupTickLocked();
+  if (tick < 0) return;
+  // An earlier wakeup will schedule this one once it is done.
+  if (!pending_wakeups_.empty() && *pending_wakeups_.begin() <= tick) return;
+  pending_wakeups_.insert(tick);
+  absl::Duration delay =
+      origin_ + resolution_ * tick - SystemClock::ElapsedRealtime();
+  alarm_executor_.Schedule([this, tick]() { OnWakeup(tick); },
+                           std::max(delay, absl::ZeroDuration()));
+}
+
+void KeepAliveScheduler::OnWakeup(std::int64_t tick) {
+  MutexLock lock(&mutex_);
+  pending_wakeups_.erase(tick);
+  if (shutdown_) return;
+  ++wakeup_count_;
+
+  // Timers may fire a little ahead of the clock; they are due regardless.
+  DispatchDueTimersLocked(std::max(tick, GetCurrentTick()));
+  ScheduleWakeupLocked();
+}
+
+void KeepAliveScheduler::DispatchDueTimersLocked(std::int64_t tick) {
+  std::list<std::shared_ptr<Timer>> expired;
+  AdvanceLocked(tick, expired);
+  for (auto& timer : expired) {
+    timer->running = true;
+    workers_.Execute("keep-alive",
+                     [this, timer]() mutable { RunTimer(std::move(timer)); });
+  }
+}
+
+void KeepAliveScheduler::RunTimer(std::shared_ptr<Timer> timer) {
+  absl::Duration delay = timer->task();
+
+  MutexLock lock(&mutex_);
+  timer->running = false;
+  if (!timer->cancelled && !shutdown_) {
+    if (delay == absl::InfiniteDuration()) {
+      NEARBY_LOGS(VERBOSE) << "KeepAliveScheduler dropped timer " << timer->id;
+      auto item = timers_.find(timer->id);
+      if (item != timers_.end() && item->second == timer) timers_.erase(item);
+    } else {
+      DispatchDueTimersLocked(GetCurrentTick());
+      timer->expiry_tick = std::max(ToExpiryTick(delay), current_tick_ + 1);
+      InsertLocked(timer);
+      ScheduleWakeupLocked();
+    }
+  }
+  timer_done_.Notify();
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,149 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_KEEP_ALIVE_SCHEDULER_H_
+#define CORE_INTERNAL_KEEP_ALIVE_SCHEDULER_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Runs the keep-alive checks of all endpoints off a single hierarchical timing
+// wheel.
+//
+// Every endpoint owns one timer. The wheel only wakes up when a timer is due
+// (or when a far away timer has to be moved to a finer level of the wheel), so
+// idle endpoints cost neither a thread nor periodic wakeups. Due timers are run
+// on a small pool of workers, which tasks must not block: a task hands
+// anything that can block, like a write to a congested channel, off to a
+// thread of its own.
+//
+// Deadlines are rounded up to the wheel resolution; timers never fire early.
+class KeepAliveScheduler {
+ public:
+  // Runs the check; returns the delay until it is to be run again, or
+  // absl::InfiniteDuration() to drop the timer.
+  using Task = std::function<absl::Duration()>;
+
+  static constexpr absl::Duration kDefaultResolution = absl::Milliseconds(100);
+
+  explicit KeepAliveScheduler(absl::Duration resolution = kDefaultResolution);
+  ~KeepAliveScheduler();
+
+  // Runs |task| for |id| after |delay|, and then again after whatever delay it
+  // returns. Returns false if a timer with that id already exists.
+  bool Schedule(const std::string& id, absl::Duration delay, Task task)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops the timer for |id|, blocking while its task is running. Must not be
+  // called from within a task.
+  void Cancel(const std::string& id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns true if a timer for |id| exists.
+  bool IsScheduled(const std::string& id) const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of times the wheel woke up to look for due timers.
+  std::int64_t GetWakeupCount() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // Each level has 64 slots; a slot on level N spans 64^N ticks. With the
+  // default resolution, the wheel covers about 19 days before it has to clamp
+  // (and later re-insert) a deadline.
+  static constexpr int kSlotBits = 6;
+  static constexpr int kSlotsPerLevel = 1 << kSlotBits;
+  static constexpr int kSlotMask = kSlotsPerLevel - 1;
+  static constexpr int kLevels = 4;
+  static constexpr std::int64_t kMaxDelta =
+      (std::int64_t{1} << (kSlotBits * kLevels)) - 1;
+  static constexpr int kNumWorkers = 2;
+
+  struct Timer;
+  using Slot = std::list<std::shared_ptr<Timer>>;
+
+  struct Timer {
+    std::string id;
+    Task task;
+    std::int64_t expiry_tick = 0;
+    // Position in the wheel, valid while |in_wheel|.
+    int level = 0;
+    int slot = 0;
+    Slot::iterator position;
+    bool in_wheel = false;
+    bool running = false;
+    bool cancelled = false;
+  };
+
+  std::int64_t GetCurrentTick() const;
+  std::int64_t ToExpiryTick(absl::Duration delay) const;
+  void InsertLocked(std::shared_ptr<Timer> timer)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RemoveLocked(Timer& timer) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void CascadeLocked(int level, int slot) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves the wheel forward to |tick|, collecting the timers that are due.
+  void AdvanceLocked(std::int64_t tick,
+                     std::list<std::shared_ptr<Timer>>& expired)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Advances the wheel to |tick| and hands due timers to the workers.
+  void DispatchDueTimersLocked(std::int64_t tick)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns the earliest tick at which the wheel has work to do, or -1.
+  std::int64_t GetNextWakeupTickLocked() const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void ScheduleWakeupLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void OnWakeup(std::int64_t tick) ABSL_LOCKS_EXCLUDED(mutex_);
+  void RunTimer(std::shared_ptr<Timer> timer) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const absl::Duration resolution_;
+  const absl::Time origin_;
+
+  mutable Mutex mutex_;
+  ConditionVariable timer_done_{&mutex_};
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  // The last tick the wheel has been advanced to.
+  std::int64_t current_tick_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::array<std::array<Slot, kSlotsPerLevel>, kLevels> wheel_
+      ABSL_GUARDED_BY(mutex_);
+  std::array<int, kLevels> timers_per_level_ ABSL_GUARDED_BY(mutex_) = {};
+  absl::flat_hash_map<std::string, std::shared_ptr<Timer>> timers_
+      ABSL_GUARDED_BY(mutex_);
+  // Ticks for which a wakeup is pending on |alarm_executor_|. Wakeups are
+  // never cancelled; a superseded one finds nothing to do.
+  absl::btree_set<std::int64_t> pending_wakeups_ ABSL_GUARDED_BY(mutex_);
+  std::int64_t wakeup_count_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  ScheduledExecutor alarm_executor_;
+  MultiThreadExecutor workers_{kNumWorkers};
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_KEEP_ALIVE_SCHEDULER_H_
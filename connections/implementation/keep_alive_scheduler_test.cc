@@ -0,0 +1,158 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/keep_alive_scheduler.h"
+
+#include <atomic>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kResolution = absl::Milliseconds(10);
+
+TEST(KeepAliveSchedulerTest, RunsTaskAfterDelay) {
+  KeepAliveScheduler scheduler(kResolution);
+  CountDownLatch ran(1);
+  absl::Time start = SystemClock::ElapsedRealtime();
+  absl::Time ran_at;
+
+  EXPECT_TRUE(scheduler.Schedule("endpoint", absl::Milliseconds(50),
+                                 [&ran, &ran_at]() {
+                                   ran_at = SystemClock::ElapsedRealtime();
+                                   ran.CountDown();
+                                   return absl::InfiniteDuration();
+                                 }));
+
+  EXPECT_TRUE(ran.Await(absl::Seconds(1)).result());
+  EXPECT_GE(ran_at - start, absl::Milliseconds(50));
+}
+
+TEST(KeepAliveSchedulerTest, RejectsDuplicateId) {
+  KeepAliveScheduler scheduler(kResolution);
+  auto task = []() { return absl::InfiniteDuration(); };
+
+  EXPECT_TRUE(scheduler.Schedule("endpoint", absl::Seconds(10), task));
+  EXPECT_FALSE(scheduler.Schedule("endpoint", absl::Seconds(10), task));
+}
+
+TEST(KeepAliveSchedulerTest, ReschedulesUntilTaskStops) {
+  KeepAliveScheduler scheduler(kResolution);
+  CountDownLatch ran(3);
+  std::atomic_int runs = 0;
+
+  scheduler.Schedule("endpoint", absl::ZeroDuration(), [&ran, &runs]() {
+    ran.CountDown();
+    return ++runs < 3 ? absl::Milliseconds(20) : absl::InfiniteDuration();
+  });
+
+  EXPECT_TRUE(ran.Await(absl::Seconds(1)).result());
+  SystemClock::Sleep(absl::Milliseconds(100));
+  EXPECT_EQ(runs, 3);
+  EXPECT_FALSE(scheduler.IsScheduled("endpoint"));
+}
+
+TEST(KeepAliveSchedulerTest, CancelledTaskDoesNotRun) {
+  KeepAliveScheduler scheduler(kResolution);
+  CountDownLatch ran(1);
+
+  scheduler.Schedule("endpoint", absl::Milliseconds(50), [&ran]() {
+    ran.CountDown();
+    return absl::InfiniteDuration();
+  });
+  scheduler.Cancel("endpoint");
+
+  EXPECT_FALSE(scheduler.IsScheduled("endpoint"));
+  EXPECT_FALSE(ran.Await(absl::Milliseconds(200)).result());
+}
+
+TEST(KeepAliveSchedulerTest, CancelWaitsForRunningTask) {
+  KeepAliveScheduler scheduler(kResolution);
+  CountDownLatch started(1);
+  std::atomic_bool finished = false;
+
+  scheduler.Schedule("endpoint", absl::ZeroDuration(), [&started, &finished]() {
+    started.CountDown();
+    SystemClock::Sleep(absl::Milliseconds(100));
+    finished = true;
+    return absl::Milliseconds(10);
+  });
+  EXPECT_TRUE(started.Await(absl::Seconds(1)).result());
+  scheduler.Cancel("endpoint");
+
+  EXPECT_TRUE(finished);
+  EXPECT_FALSE(scheduler.IsScheduled("endpoint"));
+}
+
+TEST(KeepAliveSchedulerTest, FiresTimersSpanningSeveralLevels) {
+  // With a 1ms resolution, level 0 covers 64ms and level 1 covers 4s.
+  KeepAliveScheduler scheduler(absl::Milliseconds(1));
+  constexpr int kTimers = 4;
+  const absl::Duration delays[kTimers] = {
+      absl::Milliseconds(5), absl::Milliseconds(70), absl::Milliseconds(300),
+      absl::Milliseconds(4200)};
+  CountDownLatch ran(kTimers);
+  absl::Time start = SystemClock::ElapsedRealtime();
+  absl::Duration elapsed[kTimers];
+
+  for (int i = 0; i < kTimers; ++i) {
+    scheduler.Schedule(absl::StrCat("endpoint-", i), delays[i],
+                       [&ran, &elapsed, start, i]() {
+                         elapsed[i] = SystemClock::ElapsedRealtime() - start;
+                         ran.CountDown();
+                         return absl::InfiniteDuration();
+                       });
+  }
+
+  EXPECT_TRUE(ran.Await(absl::Seconds(6)).result());
+  for (int i = 0; i < kTimers; ++i) {
+    EXPECT_GE(elapsed[i], delays[i]);
+    EXPECT_LT(elapsed[i], delays[i] + absl::Milliseconds(500));
+  }
+}
+
+TEST(KeepAliveSchedulerTest, DoesNotWakeUpWhileNothingIsDue) {
+  KeepAliveScheduler scheduler(kResolution);
+  CountDownLatch ran(1);
+
+  // Far enough out to land on the second level of the wheel.
+  for (int i = 0; i < 100; ++i) {
+    scheduler.Schedule(absl::StrCat("endpoint-", i), absl::Seconds(30),
+                       []() { return absl::InfiniteDuration(); });
+  }
+  scheduler.Schedule("due", absl::Milliseconds(100), [&ran]() {
+    ran.CountDown();
+    return absl::InfiniteDuration();
+  });
+
+  EXPECT_TRUE(ran.Await(absl::Seconds(1)).result());
+  SystemClock::Sleep(absl::Milliseconds(200));
+  // One wakeup for the due timer; a ticking wheel would have woken up ~30
+  // times by now.
+  EXPECT_LE(scheduler.GetWakeupCount(), 2);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
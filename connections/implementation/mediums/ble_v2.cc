@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/escaping.h"
 #include "absl/types/optional.h"
@@ -30,6 +31,7 @@
 #include "connections/power_level.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 
@@ -267,32 +269,27 @@ bool BleV2::StartScanning(const std::string& service_id, PowerLevel power_level,
               .advertisement_found_cb =
                   [this](BleV2Peripheral peripheral,
                          BleAdvertisementData advertisement_data) {
+                    if (FeatureFlags::GetInstance()
+                            .GetFlags()
+                            .enable_ble_scan_batching) {
+                      MutexLock lock(&scan_window_mutex_);
+                      // Only the first advertisement found since the window
+                      // was last processed needs to wake up the BLE thread.
+                      bool was_empty = scan_window_.IsEmpty();
+                      scan_window_.Add(std::move(peripheral),
+                                       std::move(advertisement_data));
+                      if (was_empty) {
+                        RunOnBleThread([this]() { ProcessScanWindow(); });
+                      }
+                      return;
+                    }
                     RunOnBleThread([this, peripheral = std::move(peripheral),
                                     advertisement_data]() {
                       MutexLock lock(&mutex_);
                       discovered_peripheral_tracker_
                           .ProcessFoundBleAdvertisement(
                               std::move(peripheral), advertisement_data,
-                              {
-                                  .fetch_advertisements =
-                                      [&](BleV2Peripheral peripheral,
-                                          int num_slots, int psm,
-                                          const std::vector<std::string>&
-                                              interesting_service_ids,
-                                          mediums::AdvertisementReadResult&
-                                              advertisement_read_result) {
-                                        // Th`mutex_` is already held here. Use
-                                        // `AssumeHeld` tell the thread
-                                        // annotation static analysis that
-                                        // `mutex_` is already exclusively
-                                        // locked.
-                                        AssumeHeld(mutex_);
-                                        ProcessFetchGattAdvertisementsRequest(
-                                            std::move(peripheral), num_slots,
-                                            psm, interesting_service_ids,
-                                            advertisement_read_result);
-                                      },
-                              });
+                              GetAdvertisementFetcher());
                     });
                   },
           })) {
@@ -897,6 +894,42 @@ TxPowerLevel BleV2::PowerLevelToTxPowerLevel(PowerLevel power_level) {
   }
 }
 
+void BleV2::ProcessScanWindow() {
+  while (true) {
+    std::vector<mediums::DiscoveredPeripheralTracker::FoundBleAdvertisement>
+        batch;
+    {
+      MutexLock lock(&scan_window_mutex_);
+      batch = scan_window_.Take(
+          mediums::DiscoveredPeripheralTracker::kMaxAdvertisementsPerLock);
+    }
+    if (batch.empty()) return;
+    // Let go of `mutex_` between batches, so that a scan storm does not hold
+    // up the other calls.
+    MutexLock lock(&mutex_);
+    discovered_peripheral_tracker_.ProcessFoundBleAdvertisements(
+        std::move(batch), GetAdvertisementFetcher());
+  }
+}
+
+mediums::DiscoveredPeripheralTracker::AdvertisementFetcher
+BleV2::GetAdvertisementFetcher() {
+  return {
+      .fetch_advertisements =
+          [this](BleV2Peripheral peripheral, int num_slots, int psm,
+                 const std::vector<std::string>& interesting_service_ids,
+                 mediums::AdvertisementReadResult& advertisement_read_result) {
+            // The tracker calls back while the caller of the tracker still
+            // holds `mutex_`. Use `AssumeHeld` to tell the thread annotation
+            // static analysis that `mutex_` is already exclusively locked.
+            AssumeHeld(mutex_);
+            ProcessFetchGattAdvertisementsRequest(
+                std::move(peripheral), num_slots, psm, interesting_service_ids,
+                advertisement_read_result);
+          },
+  };
+}
+
 void BleV2::RunOnBleThread(Runnable runnable) {
   serial_executor_.Execute(std::move(runnable));
 }
@@ -194,6 +194,15 @@ class BleV2 final {
 
   void RunOnBleThread(Runnable runnable);
 
+  // Processes the advertisements in `scan_window_` on the BLE thread, a few at
+  // a time.
+  void ProcessScanWindow() ABSL_LOCKS_EXCLUDED(mutex_, scan_window_mutex_);
+
+  // Fetches GATT advertisements for the tracker. Must be called with `mutex_`
+  // held.
+  mediums::DiscoveredPeripheralTracker::AdvertisementFetcher
+  GetAdvertisementFetcher() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   static constexpr int kMaxConcurrentAcceptLoops = 5;
 
   SingleThreadExecutor serial_executor_;
@@ -214,6 +223,12 @@ class BleV2 final {
   std::unique_ptr<CancelableAlarm> lost_alarm_;
   mediums::DiscoveredPeripheralTracker discovered_peripheral_tracker_
       ABSL_GUARDED_BY(mutex_);
+  // The advertisements found since the BLE thread last processed them. Held
+  // apart from `mutex_`, so that scan results can be reported while it is
+  // busy.
+  Mutex scan_window_mutex_;
+  mediums::DiscoveredPeripheralTracker::ScanWindow scan_window_
+      ABSL_GUARDED_BY(scan_window_mutex_);
 
   // A thread pool dedicated to running all the accept loops from
   // StartAcceptingConnections().
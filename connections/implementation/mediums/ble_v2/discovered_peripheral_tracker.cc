@@ -19,7 +19,9 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/escaping.h"
 #include "connections/implementation/mediums/ble_v2/advertisement_read_result.h"
 #include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
@@ -34,10 +36,26 @@ namespace nearby {
 namespace connections {
 namespace mediums {
 
+namespace {
+
+// Returns true if a higher version advertisement was already found for
+// `service_id`; there's no point in comparing `gatt_advertisement` against it.
+bool HasHigherVersion(
+    const absl::flat_hash_map<std::string, BleAdvertisement>&
+        parsed_gatt_advertisements,
+    const std::string& service_id, const BleAdvertisement& gatt_advertisement) {
+  const auto pga_it = parsed_gatt_advertisements.find(service_id);
+  return pga_it != parsed_gatt_advertisements.end() &&
+         pga_it->second.GetVersion() > gatt_advertisement.GetVersion();
+}
+
+}  // namespace
+
 void DiscoveredPeripheralTracker::StartTracking(
     const std::string& service_id,
     const DiscoveredPeripheralCallback& discovered_peripheral_callback,
     const Uuid& fast_advertisement_service_uuid) {
+  ByteArray service_id_hash = bleutils::GenerateServiceIdHash(service_id);
   MutexLock lock(&mutex_);
 
   ServiceIdInfo service_id_info = {
@@ -45,10 +63,12 @@ void DiscoveredPeripheralTracker::StartTracking(
           std::move(discovered_peripheral_callback),
       .lost_entity_tracker =
           std::make_unique<LostEntityTracker<BleAdvertisement>>(),
-      .fast_advertisement_service_uuid = fast_advertisement_service_uuid};
+      .fast_advertisement_service_uuid = fast_advertisement_service_uuid,
+      .service_id_hash = service_id_hash};
 
   // Replace if key exists.
   service_id_infos_.insert_or_assign(service_id, std::move(service_id_info));
+  service_id_hashes_.insert({service_id_hash, service_id});
 
   // Clear all of the GATT read results. With this cleared, we will now attempt
   // to reconnect to every peripheral we see, giving us a chance to search for
@@ -63,7 +83,25 @@ void DiscoveredPeripheralTracker::StartTracking(
 void DiscoveredPeripheralTracker::StopTracking(const std::string& service_id) {
   MutexLock lock(&mutex_);
 
-  service_id_infos_.erase(service_id);
+  const auto sii_it = service_id_infos_.find(service_id);
+  if (sii_it == service_id_infos_.end()) {
+    return;
+  }
+  ByteArray service_id_hash = sii_it->second.service_id_hash;
+  service_id_infos_.erase(sii_it);
+
+  const auto sih_it = service_id_hashes_.find(service_id_hash);
+  if (sih_it == service_id_hashes_.end() || sih_it->second != service_id) {
+    return;
+  }
+  service_id_hashes_.erase(sih_it);
+  // Hand the hash over to another tracked service ID that shares it, if any.
+  for (const auto& item : service_id_infos_) {
+    if (item.second.service_id_hash == service_id_hash) {
+      service_id_hashes_.insert({service_id_hash, item.first});
+      break;
+    }
+  }
 }
 
 void DiscoveredPeripheralTracker::ProcessFoundBleAdvertisement(
@@ -72,6 +110,63 @@ void DiscoveredPeripheralTracker::ProcessFoundBleAdvertisement(
     AdvertisementFetcher advertisement_fetcher) {
   MutexLock lock(&mutex_);
 
+  ProcessFoundBleAdvertisementLocked(std::move(peripheral), advertisement_data,
+                                     std::move(advertisement_fetcher));
+}
+
+void DiscoveredPeripheralTracker::ScanWindow::Add(
+    BleV2Peripheral peripheral,
+    api::ble_v2::BleAdvertisementData advertisement_data) {
+  advertisements_.push_back(
+      {std::move(peripheral), std::move(advertisement_data)});
+  FoundBleAdvertisement* found_advertisement = &advertisements_.back();
+  auto result = advertisements_by_data_.insert(
+      {{&found_advertisement->advertisement_data}, found_advertisement});
+  if (!result.second) {
+    result.first->second->peripheral =
+        std::move(found_advertisement->peripheral);
+    advertisements_.pop_back();
+  }
+}
+
+std::vector<DiscoveredPeripheralTracker::FoundBleAdvertisement>
+DiscoveredPeripheralTracker::ScanWindow::Take(int max_count) {
+  std::vector<FoundBleAdvertisement> taken;
+  while (!advertisements_.empty() &&
+         taken.size() < static_cast<std::size_t>(max_count)) {
+    advertisements_by_data_.erase(
+        {&advertisements_.front().advertisement_data});
+    taken.push_back(std::move(advertisements_.front()));
+    advertisements_.pop_front();
+  }
+  return taken;
+}
+
+void DiscoveredPeripheralTracker::ProcessFoundBleAdvertisements(
+    std::vector<FoundBleAdvertisement> found_advertisements,
+    AdvertisementFetcher advertisement_fetcher) {
+  ScanWindow scan_window;
+  for (auto& found_advertisement : found_advertisements) {
+    scan_window.Add(std::move(found_advertisement.peripheral),
+                    std::move(found_advertisement.advertisement_data));
+  }
+
+  while (!scan_window.IsEmpty()) {
+    std::vector<FoundBleAdvertisement> batch =
+        scan_window.Take(kMaxAdvertisementsPerLock);
+    MutexLock lock(&mutex_);
+    for (FoundBleAdvertisement& found_advertisement : batch) {
+      ProcessFoundBleAdvertisementLocked(
+          std::move(found_advertisement.peripheral),
+          found_advertisement.advertisement_data, advertisement_fetcher);
+    }
+  }
+}
+
+void DiscoveredPeripheralTracker::ProcessFoundBleAdvertisementLocked(
+    BleV2Peripheral peripheral,
+    const api::ble_v2::BleAdvertisementData& advertisement_data,
+    AdvertisementFetcher advertisement_fetcher) {
   if (service_id_infos_.empty()) {
     NEARBY_LOGS(INFO) << "Ignoring BLE advertisement header because we are not "
                          "tracking any service IDs.";
@@ -373,47 +468,43 @@ DiscoveredPeripheralTracker::ParseRawGattAdvertisements(
       continue;
     }
 
-    // Make sure the advertisement belongs to a service ID we're tracking.
-    for (const auto& item : service_id_infos_) {
-      const std::string& service_id = item.first;
-      // If we already found a higher version advertisement for this service ID,
-      // there's no point in comparing this advertisement against it.
-      const auto pga_it = parsed_gatt_advertisements.find(service_id);
-      if (pga_it != parsed_gatt_advertisements.end()) {
-        if (pga_it->second.GetVersion() > gatt_advertisement.GetVersion()) {
+    // service_id_hash is null here (mediums advertisement) because we already
+    // have a UUID in the fast advertisement.
+    if (gatt_advertisement.IsFastAdvertisement() && !service_uuid.IsEmpty()) {
+      for (const auto& item : service_id_infos_) {
+        const std::string& service_id = item.first;
+        if (!(item.second.fast_advertisement_service_uuid == service_uuid) ||
+            HasHigherVersion(parsed_gatt_advertisements, service_id,
+                             gatt_advertisement)) {
           continue;
         }
-      }
-
-      // service_id_hash is null here (mediums advertisement) because we already
-      // have a UUID in the fast advertisement.
-      if (gatt_advertisement.IsFastAdvertisement() && !service_uuid.IsEmpty()) {
-        const auto sii_it = service_id_infos_.find(service_id);
-        if (sii_it != service_id_infos_.end()) {
-          if (sii_it->second.fast_advertisement_service_uuid == service_uuid) {
-            NEARBY_LOGS(INFO)
-                << "This GATT advertisement:"
-                << absl::BytesToHexString(gatt_advertisement_bytes->data())
-                << " is a fast advertisement and matched UUID="
-                << service_uuid.Get16BitAsString()
-                << " in a map with service_id=" << service_id;
-            parsed_gatt_advertisements.insert({service_id, gatt_advertisement});
-          }
-        }
-        continue;
-      }
-
-      // Map the service ID to the advertisement if the service_id_hash match.
-      if (bleutils::GenerateServiceIdHash(service_id) ==
-          gatt_advertisement.GetServiceIdHash()) {
-        NEARBY_LOGS(INFO) << "Matched service_id=" << service_id
-                          << " to GATT advertisement="
-                          << absl::BytesToHexString(
-                                 gatt_advertisement_bytes->data());
+        NEARBY_LOGS(INFO)
+            << "This GATT advertisement:"
+            << absl::BytesToHexString(gatt_advertisement_bytes->data())
+            << " is a fast advertisement and matched UUID="
+            << service_uuid.Get16BitAsString()
+            << " in a map with service_id=" << service_id;
         parsed_gatt_advertisements.insert({service_id, gatt_advertisement});
-        break;
       }
+      continue;
+    }
+
+    // Map the service ID to the advertisement if the service_id_hash match.
+    const auto sih_it =
+        service_id_hashes_.find(gatt_advertisement.GetServiceIdHash());
+    if (sih_it == service_id_hashes_.end()) {
+      continue;
     }
+    const std::string& service_id = sih_it->second;
+    if (HasHigherVersion(parsed_gatt_advertisements, service_id,
+                         gatt_advertisement)) {
+      continue;
+    }
+    NEARBY_LOGS(INFO) << "Matched service_id=" << service_id
+                      << " to GATT advertisement="
+                      << absl::BytesToHexString(
+                             gatt_advertisement_bytes->data());
+    parsed_gatt_advertisements.insert({service_id, gatt_advertisement});
   }
 
   return parsed_gatt_advertisements;
@@ -15,9 +15,13 @@
 #ifndef CORE_INTERNAL_MEDIUMS_BLE_V2_DISCOVERED_PERIPHERAL_TRACKER_H_
 #define CORE_INTERNAL_MEDIUMS_BLE_V2_DISCOVERED_PERIPHERAL_TRACKER_H_
 
+#include <deque>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "connections/implementation/mediums//lost_entity_tracker.h"
 #include "connections/implementation/mediums/ble_v2/advertisement_read_result.h"
@@ -25,6 +29,8 @@
 #include "connections/implementation/mediums/ble_v2/ble_advertisement_header.h"
 #include "connections/implementation/mediums/ble_v2/discovered_peripheral_callback.h"
 #include "connections/implementation/mediums/lost_entity_tracker.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/mutex.h"
@@ -59,6 +65,63 @@ class DiscoveredPeripheralTracker {
                             mediums::AdvertisementReadResult&>();
   };
 
+  // A BLE advertisement found by a scan.
+  struct FoundBleAdvertisement {
+    BleV2Peripheral peripheral;
+    api::ble_v2::BleAdvertisementData advertisement_data;
+  };
+
+  // The BLE advertisements found during a scan window, in the order they were
+  // first found. Scanners report the same advertisement many times per scan
+  // window; identical advertisement data is kept once, with the peripheral it
+  // was last found on. Not thread safe.
+  class ScanWindow {
+   public:
+    void Add(BleV2Peripheral peripheral,
+             api::ble_v2::BleAdvertisementData advertisement_data);
+    bool IsEmpty() const { return advertisements_.empty(); }
+    // Removes and returns up to `max_count` advertisements, the ones found
+    // first first.
+    std::vector<FoundBleAdvertisement> Take(int max_count);
+
+   private:
+    // Refers to the data of a found advertisement, to tell identical ones
+    // apart.
+    struct DataRef {
+      const api::ble_v2::BleAdvertisementData* advertisement_data;
+
+      template <typename H>
+      friend H AbslHashValue(H h, const DataRef& ref) {
+        // The order of service_data is unspecified, so combine the hashes of
+        // its entries in an order independent way.
+        std::size_t service_data_hash = 0;
+        for (const auto& item : ref.advertisement_data->service_data) {
+          service_data_hash += absl::Hash<Uuid>()(item.first) ^
+                               absl::Hash<ByteArray>()(item.second);
+        }
+        return H::combine(std::move(h),
+                          ref.advertisement_data->is_extended_advertisement,
+                          service_data_hash);
+      }
+
+      friend bool operator==(const DataRef& lhs, const DataRef& rhs) {
+        return lhs.advertisement_data->is_extended_advertisement ==
+                   rhs.advertisement_data->is_extended_advertisement &&
+               lhs.advertisement_data->service_data ==
+                   rhs.advertisement_data->service_data;
+      }
+    };
+
+    // A deque, so that the references into it stay valid as it grows.
+    std::deque<FoundBleAdvertisement> advertisements_;
+    absl::flat_hash_map<DataRef, FoundBleAdvertisement*>
+        advertisements_by_data_;
+  };
+
+  // The most advertisements ProcessFoundBleAdvertisements() processes per hold
+  // of the tracker's lock.
+  static constexpr int kMaxAdvertisementsPerLock = 16;
+
   explicit DiscoveredPeripheralTracker(
       bool is_extended_advertisement_available = false)
       : is_extended_advertisement_available_(
@@ -96,6 +159,16 @@ class DiscoveredPeripheralTracker {
       api::ble_v2::BleAdvertisementData advertisement_data,
       AdvertisementFetcher advertisement_fetcher) ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Processes the BLE advertisements found during a scan window, as
+  // ProcessFoundBleAdvertisement() would one after the other. Advertisements
+  // with identical data are processed once, with the peripheral they were
+  // last found on (see ScanWindow). Lets go of the lock every
+  // kMaxAdvertisementsPerLock advertisements, so that a scan storm does not
+  // hold up StartTracking() and the like.
+  void ProcessFoundBleAdvertisements(
+      std::vector<FoundBleAdvertisement> found_advertisements,
+      AdvertisementFetcher advertisement_fetcher) ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Processes the set of lost GATT advertisements and notifies the client of
   // any lost peripherals.
   void ProcessLostGattAdvertisements() ABSL_LOCKS_EXCLUDED(mutex_);
@@ -116,6 +189,9 @@ class DiscoveredPeripheralTracker {
     // Used to check for fast advertisements delivered through BLE advertisement
     // service data, under the given UUID.
     Uuid fast_advertisement_service_uuid;
+
+    // The hash GATT advertisements for this service ID carry.
+    ByteArray service_id_hash;
   };
 
   // A container to hold the related informations for a GATT advertisement.
@@ -139,6 +215,12 @@ class DiscoveredPeripheralTracker {
     BleV2Peripheral peripheral;
   };
 
+  void ProcessFoundBleAdvertisementLocked(
+      BleV2Peripheral peripheral,
+      const api::ble_v2::BleAdvertisementData& advertisement_data,
+      AdvertisementFetcher advertisement_fetcher)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Clears stale data from any previous sessions.
   void ClearDataForServiceId(const std::string& service_id)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -257,6 +339,13 @@ class DiscoveredPeripheralTracker {
   absl::flat_hash_map<std::string, ServiceIdInfo> service_id_infos_
       ABSL_GUARDED_BY(mutex_);
 
+  // Maps the service ID hashes of the tracked service IDs back to the service
+  // IDs, so that GATT advertisements can be matched to them without hashing
+  // every tracked service ID for every advertisement. If service IDs share a
+  // hash, the one that was tracked first wins.
+  absl::flat_hash_map<ByteArray, std::string> service_id_hashes_
+      ABSL_GUARDED_BY(mutex_);
+
   // ------------ ADVERTISEMENT HEADER MAPS ------------
   // Maps advertisement headers to AdvertisementReadResult. Tells us when to
   // retry reading a GATT advertisement. If no entry exists for a particular
@@ -0,0 +1,139 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Feeds DiscoveredPeripheralTracker a synthetic scan storm: every advertiser
+// in range is reported kReportsPerScanWindow times per scan window, as
+// scanners in dense environments do. Compares processing the reports one by
+// one against processing each scan window as a batch.
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement_header.h"
+#include "connections/implementation/mediums/ble_v2/ble_utils.h"
+#include "connections/implementation/mediums/ble_v2/discovered_peripheral_tracker.h"
+#include "internal/platform/bluetooth_adapter.h"
+#include "internal/platform/byte_array.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace {
+
+constexpr int kNumTrackedServiceIds = 8;
+constexpr int kReportsPerScanWindow = 4;
+
+class BlePeripheralStub : public api::ble_v2::BlePeripheral {
+ public:
+  explicit BlePeripheralStub(std::string mac_address)
+      : mac_address_(std::move(mac_address)) {}
+
+  std::string GetAddress() const override { return mac_address_; }
+
+ private:
+  std::string mac_address_;
+};
+
+std::string GetServiceId(int index) { return absl::StrCat("service-", index); }
+
+// Advertisers of the tracked service IDs, advertising over extended
+// advertisements, so that every report is parsed.
+struct ScanStorm {
+  explicit ScanStorm(int num_advertisers) {
+    for (int i = 0; i < num_advertisers; ++i) {
+      peripherals.push_back(std::make_unique<BlePeripheralStub>(
+          absl::StrCat("4C:8B:1D:CE:", i / 256, ":", i % 256)));
+      api::ble_v2::BleAdvertisementData advertisement_data;
+      advertisement_data.is_extended_advertisement = true;
+      advertisement_data.service_data.insert(
+          {bleutils::kCopresenceServiceUuid,
+           ByteArray(BleAdvertisement(
+               BleAdvertisement::Version::kV2,
+               BleAdvertisement::SocketVersion::kV2,
+               bleutils::GenerateServiceIdHash(
+                   GetServiceId(i % kNumTrackedServiceIds)),
+               ByteArray(absl::StrCat("endpoint-", i)),
+               bleutils::GenerateDeviceToken(),
+               BleAdvertisementHeader::kDefaultPsmValue))});
+      advertisement_datas.push_back(std::move(advertisement_data));
+    }
+  }
+
+  std::vector<DiscoveredPeripheralTracker::FoundBleAdvertisement>
+  GetScanWindow() const {
+    std::vector<DiscoveredPeripheralTracker::FoundBleAdvertisement> reports;
+    for (int report = 0; report < kReportsPerScanWindow; ++report) {
+      for (std::size_t i = 0; i < peripherals.size(); ++i) {
+        reports.push_back({BleV2Peripheral(peripherals[i].get()),
+                           advertisement_datas[i]});
+      }
+    }
+    return reports;
+  }
+
+  std::vector<std::unique_ptr<BlePeripheralStub>> peripherals;
+  std::vector<api::ble_v2::BleAdvertisementData> advertisement_datas;
+};
+
+void StartTracking(DiscoveredPeripheralTracker& tracker) {
+  for (int i = 0; i < kNumTrackedServiceIds; ++i) {
+    tracker.StartTracking(GetServiceId(i), {},
+                          bleutils::kCopresenceServiceUuid);
+  }
+}
+
+void BM_ProcessOneByOne(benchmark::State& state) {
+  ScanStorm storm(state.range(0));
+  DiscoveredPeripheralTracker tracker(
+      /*is_extended_advertisement_available=*/true);
+  StartTracking(tracker);
+  for (auto _ : state) {
+    for (auto& report : storm.GetScanWindow()) {
+      tracker.ProcessFoundBleAdvertisement(std::move(report.peripheral),
+                                           std::move(report.advertisement_data),
+                                           {});
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kReportsPerScanWindow);
+}
+
+void BM_ProcessScanWindow(benchmark::State& state) {
+  ScanStorm storm(state.range(0));
+  DiscoveredPeripheralTracker tracker(
+      /*is_extended_advertisement_available=*/true);
+  StartTracking(tracker);
+  for (auto _ : state) {
+    tracker.ProcessFoundBleAdvertisements(storm.GetScanWindow(), {});
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kReportsPerScanWindow);
+}
+
+BENCHMARK(BM_ProcessOneByOne)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_ProcessScanWindow)->RangeMultiplier(4)->Range(16, 1024);
+
+}  // namespace
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+BENCHMARK_MAIN();
@@ -37,6 +37,7 @@ constexpr absl::string_view kFastAdvertisementServiceUuid = "FE2C";
 constexpr absl::string_view kServiceIdA = "A";
 constexpr absl::string_view kServiceIdB = "B";
 constexpr absl::string_view kMacAddress1 = "4C:8B:1D:CE:BA:D1";
+constexpr absl::string_view kMacAddress2 = "4C:8B:1D:CE:BA:D2";
 constexpr absl::string_view kData = "\x04\x02\x00";
 constexpr absl::string_view kData2 = "\x07\x00\x07";
 constexpr absl::string_view kDeviceToken = "\x04\x20";
@@ -962,6 +963,126 @@ TEST_F(DiscoveredPeripheralTrackerTest,
   EXPECT_FALSE(lost_latch.Await(kWaitDuration).result());
 }
 
+TEST_F(DiscoveredPeripheralTrackerTest,
+       FoundBleAdvertisementsProcessesIdenticalDataOnce) {
+  std::vector<std::string> service_ids = {std::string(kServiceIdA)};
+  ByteArray advertisement_header_bytes = CreateBleAdvertisementHeader(
+      GenerateRandomAdvertisementHash(), service_ids);
+  ByteArray advertisement_bytes = CreateBleAdvertisement(
+      std::string(kServiceIdA), ByteArray(std::string(kData)),
+      ByteArray(std::string(kDeviceToken)));
+  CountDownLatch found_latch(1);
+  CountDownLatch fetch_latch(1);
+  std::string found_address;
+
+  discovered_peripheral_tracker_.StartTracking(
+      std::string(kServiceIdA),
+      {
+          .peripheral_discovered_cb =
+              [&found_latch, &found_address](
+                  BleV2Peripheral peripheral, const std::string& service_id,
+                  const ByteArray& advertisement_bytes,
+                  bool fast_advertisement) {
+                found_address = peripheral.GetAddress();
+                found_latch.CountDown();
+              },
+      },
+      {});
+
+  api::ble_v2::BleAdvertisementData advertisement_data;
+  advertisement_data.service_data.insert(
+      {bleutils::kCopresenceServiceUuid, advertisement_header_bytes});
+  BlePeripheralStub peripheral_1(kMacAddress1);
+  BlePeripheralStub peripheral_2(kMacAddress2);
+  std::vector<ByteArray> advertisement_bytes_list = {advertisement_bytes};
+
+  discovered_peripheral_tracker_.ProcessFoundBleAdvertisements(
+      {
+          {BleV2Peripheral(&peripheral_1), advertisement_data},
+          {BleV2Peripheral(&peripheral_1), advertisement_data},
+          {BleV2Peripheral(&peripheral_2), advertisement_data},
+      },
+      GetAdvertisementFetcher(fetch_latch, advertisement_bytes_list));
+
+  // The advertisement is reported once, on the peripheral it was last found
+  // on.
+  EXPECT_TRUE(found_latch.Await(kWaitDuration).result());
+  EXPECT_EQ(GetFetchAdvertisementCallbackCount(), 1);
+  EXPECT_EQ(found_address, kMacAddress2);
+}
+
+TEST_F(DiscoveredPeripheralTrackerTest,
+       ScanWindowKeepsIdenticalAdvertisementsOnce) {
+  api::ble_v2::BleAdvertisementData advertisement_data_a;
+  advertisement_data_a.service_data.insert(
+      {bleutils::kCopresenceServiceUuid, ByteArray(std::string(kData))});
+  api::ble_v2::BleAdvertisementData advertisement_data_b;
+  advertisement_data_b.service_data.insert(
+      {bleutils::kCopresenceServiceUuid, ByteArray(std::string(kDeviceToken))});
+  BlePeripheralStub peripheral_1(kMacAddress1);
+  BlePeripheralStub peripheral_2(kMacAddress2);
+  DiscoveredPeripheralTracker::ScanWindow scan_window;
+
+  scan_window.Add(BleV2Peripheral(&peripheral_1), advertisement_data_a);
+  scan_window.Add(BleV2Peripheral(&peripheral_1), advertisement_data_b);
+  scan_window.Add(BleV2Peripheral(&peripheral_2), advertisement_data_a);
+
+  // In the order first found, on the peripheral last found on.
+  std::vector<DiscoveredPeripheralTracker::FoundBleAdvertisement> first =
+      scan_window.Take(1);
+  ASSERT_EQ(first.size(), 1u);
+  EXPECT_EQ(first[0].peripheral.GetAddress(), kMacAddress2);
+  EXPECT_EQ(first[0].advertisement_data.service_data,
+            advertisement_data_a.service_data);
+  std::vector<DiscoveredPeripheralTracker::FoundBleAdvertisement> rest =
+      scan_window.Take(DiscoveredPeripheralTracker::kMaxAdvertisementsPerLock);
+  ASSERT_EQ(rest.size(), 1u);
+  EXPECT_EQ(rest[0].advertisement_data.service_data,
+            advertisement_data_b.service_data);
+  EXPECT_TRUE(scan_window.IsEmpty());
+
+  // Taken advertisements are found anew.
+  scan_window.Add(BleV2Peripheral(&peripheral_1), advertisement_data_a);
+  EXPECT_EQ(scan_window.Take(2).size(), 1u);
+}
+
+TEST_F(DiscoveredPeripheralTrackerTest,
+       FoundBleAdvertisementAfterStopTrackingOtherServiceId) {
+  std::vector<std::string> service_ids = {std::string(kServiceIdA)};
+  ByteArray advertisement_header_bytes = CreateBleAdvertisementHeader(
+      GenerateRandomAdvertisementHash(), service_ids);
+  ByteArray advertisement_bytes = CreateBleAdvertisement(
+      std::string(kServiceIdA), ByteArray(std::string(kData)),
+      ByteArray(std::string(kDeviceToken)));
+  CountDownLatch found_latch(1);
+  CountDownLatch fetch_latch(1);
+
+  discovered_peripheral_tracker_.StartTracking(
+      std::string(kServiceIdA),
+      {
+          .peripheral_discovered_cb =
+              [&found_latch](BleV2Peripheral peripheral,
+                             const std::string& service_id,
+                             const ByteArray& advertisement_bytes,
+                             bool fast_advertisement) {
+                EXPECT_EQ(service_id, kServiceIdA);
+                found_latch.CountDown();
+              },
+      },
+      {});
+  discovered_peripheral_tracker_.StartTracking(std::string(kServiceIdB), {},
+                                               {});
+  discovered_peripheral_tracker_.StopTracking(std::string(kServiceIdB));
+
+  api::ble_v2::BleAdvertisementData advertisement_data;
+  advertisement_data.service_data.insert(
+      {bleutils::kCopresenceServiceUuid, advertisement_header_bytes});
+
+  FindAdvertisement(advertisement_data, {advertisement_bytes}, fetch_latch);
+
+  EXPECT_TRUE(found_latch.Await(kWaitDuration).result());
+}
+
 }  // namespace
 
 }  // namespace mediums
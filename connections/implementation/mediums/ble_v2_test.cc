@@ -533,6 +533,51 @@ TEST_F(BleV2Test, StartScanningDiscoverAndLostPeripheral) {
   env_.Stop();
 }
 
+TEST_F(BleV2Test, StartScanningWithBatchingDiscoversPeripherals) {
+  FeatureFlags feature_flags;
+  feature_flags.enable_ble_scan_batching = true;
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  BluetoothRadio radio_a;
+  BluetoothRadio radio_b;
+  BluetoothRadio radio_c;
+  BleV2 ble_a(radio_a);
+  BleV2 ble_b(radio_b);
+  BleV2 ble_c(radio_c);
+  radio_a.Enable();
+  radio_b.Enable();
+  radio_c.Enable();
+  ByteArray advertisement_bytes((std::string(kAdvertisementString)));
+  CountDownLatch found_latch(2);
+
+  ble_b.StartAdvertising(std::string(kServiceIDA), advertisement_bytes,
+                         PowerLevel::kHighPower,
+                         /*is_fast_advertisement=*/false);
+  ble_c.StartAdvertising(std::string(kServiceIDA), advertisement_bytes,
+                         PowerLevel::kHighPower,
+                         /*is_fast_advertisement=*/true);
+
+  ble_a.StartScanning(
+      std::string(kServiceIDA), PowerLevel::kHighPower,
+      mediums::DiscoveredPeripheralCallback{
+          .peripheral_discovered_cb =
+              [&found_latch](BleV2Peripheral peripheral,
+                             const std::string& service_id,
+                             const ByteArray& advertisement_bytes,
+                             bool fast_advertisement) {
+                found_latch.CountDown();
+              },
+      });
+
+  EXPECT_TRUE(found_latch.Await(kWaitDuration).result());
+
+  ble_a.StopScanning(std::string(kServiceIDA));
+  ble_b.StopAdvertising(std::string(kServiceIDA));
+  ble_c.StopAdvertising(std::string(kServiceIDA));
+  env_.Stop();
+  env_.SetFeatureFlags(FeatureFlags{});
+}
+
 TEST_F(BleV2Test, StartScanningDiscoverButNoPeripheralLostAfterStopScanning) {
   env_.Start();
   BluetoothRadio radio_a;
@@ -14,8 +14,12 @@
 
 #include "connections/implementation/mediums/webrtc/webrtc_socket_impl.h"
 
+#include <algorithm>
+
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 
 namespace location {
 namespace nearby {
@@ -29,22 +33,13 @@ Exception WebRtcSocket::OutputStreamImpl::Write(const ByteArray& data) {
     return {Exception::kIo};
   }
 
-  socket_->BlockUntilSufficientSpaceInBuffer(data.size());
-
-  if (socket_->IsClosed()) {
-    NEARBY_LOG(WARNING, "Tried sending message while socket is closed");
-    return {Exception::kIo};
-  }
-
-  if (!socket_->SendMessage(data)) {
-    NEARBY_LOG(INFO, "Unable to write data to socket.");
-    return {Exception::kIo};
-  }
-  return {Exception::kSuccess};
+  if (socket_->batch_messages_) return socket_->BatchMessage(data);
+  return socket_->SendWhenWritable(absl::string_view(data.data(), data.size()));
 }
 
 Exception WebRtcSocket::OutputStreamImpl::Flush() {
-  // Java implementation is empty.
+  // Java implementation is empty; here, batched writes are sent.
+  if (socket_->batch_messages_) return socket_->SendBatchedMessages();
   return {Exception::kSuccess};
 }
 
@@ -60,6 +55,15 @@ WebRtcSocket::WebRtcSocket(
     : name_(name), data_channel_(std::move(data_channel)) {
   NEARBY_LOGS(INFO) << "WebRtcSocket::WebRtcSocket(" << name_
                     << ") this: " << this;
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_webrtc_send_batching) {
+    batch_messages_ = true;
+    max_message_bytes_ = std::max(flags.webrtc_max_message_bytes, 1);
+    high_watermark_ = flags.webrtc_send_high_watermark;
+    low_watermark_ = std::min(flags.webrtc_send_low_watermark,
+                              flags.webrtc_send_high_watermark);
+    send_timeout_ = flags.webrtc_send_timeout;
+  }
   data_channel_->RegisterObserver(this);
 }
 
@@ -137,13 +141,62 @@ void WebRtcSocket::OnMessage(const webrtc::DataBuffer& buffer) {
 
 void WebRtcSocket::OnBufferedAmountChange(uint64_t sent_data_size) {
   // This is a data channel callback on the signaling thread, lets off load so
-  // we don't block signaling.
+  // we don't block signaling. Writers waiting on the buffer only resume once
+  // it drains below the low watermark, so don't wake them up before that.
+  if (data_channel_->buffered_amount() > low_watermark_) return;
   OffloadFromSignalingThread([this] { WakeUpWriter(); });
 }
 
-bool WebRtcSocket::SendMessage(const ByteArray& data) {
-  return data_channel_->Send(
-      webrtc::DataBuffer(std::string(data.data(), data.size())));
+bool WebRtcSocket::SendMessage(absl::string_view data) {
+  return data_channel_->Send(webrtc::DataBuffer(std::string(data)));
+}
+
+Exception WebRtcSocket::SendWhenWritable(absl::string_view data) {
+  if (!BlockUntilSufficientSpaceInBuffer(data.size())) {
+    NEARBY_LOGS(WARNING) << "WebRtcSocket::SendWhenWritable(" << name_
+                         << ") timed out waiting for the data channel to "
+                            "drain its buffer.";
+    return {Exception::kTimeout};
+  }
+
+  if (IsClosed()) {
+    NEARBY_LOG(WARNING, "Tried sending message while socket is closed");
+    return {Exception::kIo};
+  }
+
+  if (!SendMessage(data)) {
+    NEARBY_LOG(INFO, "Unable to write data to socket.");
+    return {Exception::kIo};
+  }
+  return {Exception::kSuccess};
+}
+
+Exception WebRtcSocket::BatchMessage(const ByteArray& data) {
+  MutexLock lock(&batch_mutex_);
+  batched_message_.append(data.data(), data.size());
+  if (batched_message_.size() < max_message_bytes_) {
+    return {Exception::kSuccess};
+  }
+  return SendBatchedMessagesLocked();
+}
+
+Exception WebRtcSocket::SendBatchedMessages() {
+  MutexLock lock(&batch_mutex_);
+  return SendBatchedMessagesLocked();
+}
+
+Exception WebRtcSocket::SendBatchedMessagesLocked() {
+  // The remote device reads the data channel as a stream of bytes, so the
+  // batch can be split up at any point.
+  absl::string_view remaining = batched_message_;
+  Exception result = {Exception::kSuccess};
+  while (!remaining.empty() && result.Ok()) {
+    absl::string_view message = remaining.substr(0, max_message_bytes_);
+    remaining.remove_prefix(message.size());
+    result = SendWhenWritable(message);
+  }
+  batched_message_.clear();
+  return result;
 }
 
 bool WebRtcSocket::IsClosed() { return closed_.Get(); }
@@ -171,13 +224,28 @@ void WebRtcSocket::SetSocketListener(SocketListener&& listener) {
   socket_listener_ = std::move(listener);
 }
 
-void WebRtcSocket::BlockUntilSufficientSpaceInBuffer(int length) {
+bool WebRtcSocket::BlockUntilSufficientSpaceInBuffer(int length) {
   MutexLock lock(&backpressure_mutex_);
-  while (!IsClosed() &&
-         (data_channel_->buffered_amount() + length > kMaxDataSize)) {
-    // TODO(himanshujaju): Add wait with timeout.
-    buffer_variable_.Wait();
+  std::uint64_t buffered_amount = data_channel_->buffered_amount();
+  if (buffered_amount + length <= high_watermark_) return true;
+
+  // Past the high watermark, wait for the buffer to drain below the low
+  // watermark, so that writers resume with room for a burst of messages
+  // rather than one at a time. An empty buffer always makes room.
+  absl::Time deadline = SystemClock::ElapsedRealtime() + send_timeout_;
+  while (!IsClosed() && (buffered_amount > low_watermark_ ||
+                          (buffered_amount > 0 &&
+                           buffered_amount + length > high_watermark_))) {
+    if (send_timeout_ == absl::InfiniteDuration()) {
+      buffer_variable_.Wait();
+    } else {
+      absl::Duration remaining = deadline - SystemClock::ElapsedRealtime();
+      if (remaining <= absl::ZeroDuration()) return false;
+      buffer_variable_.Wait(remaining);
+    }
+    buffered_amount = data_channel_->buffered_amount();
   }
+  return true;
 }
 
 void WebRtcSocket::OffloadFromSignalingThread(Runnable runnable) {
@@ -15,8 +15,13 @@
 #ifndef CORE_INTERNAL_MEDIUMS_WEBRTC_WEBRTC_SOCKET_IMPL_H_
 #define CORE_INTERNAL_MEDIUMS_WEBRTC_WEBRTC_SOCKET_IMPL_H_
 
+#include <cstdint>
 #include <memory>
+#include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "connections/listeners.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/output_stream.h"
@@ -92,8 +97,18 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
   void WakeUpWriter();
   bool IsClosed();
   void ClosePipe();
-  bool SendMessage(const ByteArray& data);
-  void BlockUntilSufficientSpaceInBuffer(int length);
+  bool SendMessage(absl::string_view data);
+  // Returns false if the data channel did not make room for |length| more
+  // bytes within |send_timeout_|.
+  bool BlockUntilSufficientSpaceInBuffer(int length);
+  Exception SendWhenWritable(absl::string_view data);
+  // Adds |data| to the message being batched up, sending it once it reaches
+  // |max_message_bytes_|.
+  Exception BatchMessage(const ByteArray& data)
+      ABSL_LOCKS_EXCLUDED(batch_mutex_);
+  Exception SendBatchedMessages() ABSL_LOCKS_EXCLUDED(batch_mutex_);
+  Exception SendBatchedMessagesLocked()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(batch_mutex_);
   void OffloadFromSignalingThread(Runnable runnable);
 
   std::string name_;
@@ -107,9 +122,21 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
 
   SocketListener socket_listener_;
 
+  // Send path tuning; see FeatureFlags::enable_webrtc_send_batching. Without
+  // it, every write is sent as a message of its own, once the data channel
+  // buffers no more than kMaxDataSize bytes.
+  bool batch_messages_ = false;
+  std::size_t max_message_bytes_ = kMaxDataSize;
+  std::uint64_t high_watermark_ = kMaxDataSize;
+  std::uint64_t low_watermark_ = kMaxDataSize;
+  absl::Duration send_timeout_ = absl::InfiniteDuration();
+
   mutable Mutex backpressure_mutex_;
   ConditionVariable buffer_variable_{&backpressure_mutex_};
 
+  Mutex batch_mutex_;
+  std::string batched_message_ ABSL_GUARDED_BY(batch_mutex_);
+
   // This should be destroyed first to ensure any remaining tasks flushed on
   // shutdown get run while the other members are still alive.
   SingleThreadExecutor single_thread_executor_;
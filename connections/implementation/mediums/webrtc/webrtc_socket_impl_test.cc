@@ -19,7 +19,9 @@
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/time/time.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
 #include "webrtc/api/data_channel_interface.h"
 
 namespace location {
@@ -56,6 +58,30 @@ class MockDataChannel
   MOCK_METHOD(bool, Send, (const webrtc::DataBuffer&));
 };
 
+// Enables FeatureFlags::enable_webrtc_send_batching for the sockets created
+// while it is in scope.
+class ScopedSendBatching {
+ public:
+  ScopedSendBatching() : saved_(FeatureFlags::GetInstance().GetFlags()) {
+    FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+    flags.enable_webrtc_send_batching = true;
+    flags.webrtc_max_message_bytes = 10;
+    flags.webrtc_send_high_watermark = 100;
+    flags.webrtc_send_low_watermark = 50;
+    flags.webrtc_send_timeout = absl::Milliseconds(100);
+  }
+  ~ScopedSendBatching() { FeatureFlags::GetMutableFlagsForTesting() = saved_; }
+
+ private:
+  FeatureFlags::Flags saved_;
+};
+
+testing::Matcher<const webrtc::DataBuffer&> HasSize(std::size_t size) {
+  return testing::Truly([size](const webrtc::DataBuffer& buffer) {
+    return buffer.size() == size;
+  });
+}
+
 }  // namespace
 
 TEST(WebRtcSocketTest, ReadFromSocket) {
@@ -124,6 +150,45 @@ TEST(WebRtcSocketTest, WriteToDataChannelFails) {
             Exception{Exception::kIo});
 }
 
+TEST(WebRtcSocketTest, BatchesWritesUntilFlush) {
+  ScopedSendBatching send_batching;
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  EXPECT_CALL(*mock_data_channel, Send(HasSize(7)))
+      .WillOnce(testing::Return(true));
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Write(ByteArray{"Mes"}).Ok());
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Write(ByteArray{"sage"}).Ok());
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Flush().Ok());
+}
+
+TEST(WebRtcSocketTest, SplitsBatchesIntoMaxSizedMessages) {
+  ScopedSendBatching send_batching;
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  EXPECT_CALL(*mock_data_channel, Send(HasSize(10)))
+      .Times(2)
+      .WillRepeatedly(testing::Return(true));
+  EXPECT_CALL(*mock_data_channel, Send(HasSize(5)))
+      .WillOnce(testing::Return(true));
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Write(ByteArray(25)).Ok());
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Flush().Ok());
+}
+
+TEST(WebRtcSocketTest, WriteTimesOutWhileBufferIsFull) {
+  ScopedSendBatching send_batching;
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  ON_CALL(*mock_data_channel, buffered_amount())
+      .WillByDefault(testing::Return(100));
+  EXPECT_CALL(*mock_data_channel, Send(testing::_)).Times(0);
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Write(ByteArray{"Message"}).Ok());
+  EXPECT_EQ(webrtc_socket.GetOutputStream().Flush(),
+            Exception{Exception::kTimeout});
+}
+
 TEST(WebRtcSocketTest, Close) {
   rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
   WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
@@ -36,6 +36,7 @@ ByteArray ToBytes(OfflineFrame&& frame) {
   ByteArray bytes(frame.ByteSizeLong());
   frame.set_version(OfflineFrame::V1);
   frame.SerializeToArray(bytes.data(), bytes.size());
+  ByteCopyCounter::Record(bytes.size());
   return bytes;
 }
 
@@ -44,7 +45,8 @@ ByteArray ToBytes(OfflineFrame&& frame) {
 ExceptionOrOfflineFrame FromBytes(const ByteArray& bytes) {
   OfflineFrame frame;
 
-  if (frame.ParseFromString(std::string(bytes))) {
+  ByteCopyCounter::Record(bytes.size());
+  if (frame.ParseFromArray(bytes.data(), bytes.size())) {
     Exception validation_exception = EnsureValidOfflineFrame(frame);
     if (validation_exception.Raised()) {
       return ExceptionOrOfflineFrame(validation_exception);
@@ -103,7 +105,11 @@ ByteArray ForConnectionRequest(const ConnectionInfo& conection_info) {
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForConnectionResponse(std::int32_t status) {
+ByteArray ForConnectionResponse(std::int32_t status,
+                                bool supports_aead_frame_cipher,
+                                bool supports_payload_compression,
+                                bool supports_delta_transfer,
+                                bool supports_chunked_bytes_payloads) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -118,13 +124,25 @@ ByteArray ForConnectionResponse(std::int32_t status) {
   sub_frame->set_response(status == Status::kSuccess
                               ? ConnectionResponseFrame::ACCEPT
                               : ConnectionResponseFrame::REJECT);
+  if (supports_aead_frame_cipher) {
+    sub_frame->set_supports_aead_frame_cipher(true);
+  }
+  if (supports_payload_compression) {
+    sub_frame->set_supports_payload_compression(true);
+  }
+  if (supports_delta_transfer) {
+    sub_frame->set_supports_delta_transfer(true);
+  }
+  if (supports_chunked_bytes_payloads) {
+    sub_frame->set_supports_chunked_bytes_payloads(true);
+  }
 
   return ToBytes(std::move(frame));
 }
 
 ByteArray ForDataPayloadTransfer(
     const PayloadTransferFrame::PayloadHeader& header,
-    const PayloadTransferFrame::PayloadChunk& chunk) {
+    PayloadTransferFrame::PayloadChunk chunk) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -133,7 +151,7 @@ ByteArray ForDataPayloadTransfer(
   auto* sub_frame = v1_frame->mutable_payload_transfer();
   sub_frame->set_packet_type(PayloadTransferFrame::DATA);
   *sub_frame->mutable_payload_header() = header;
-  *sub_frame->mutable_payload_chunk() = chunk;
+  *sub_frame->mutable_payload_chunk() = std::move(chunk);
 
   return ToBytes(std::move(frame));
 }
@@ -298,7 +316,7 @@ ByteArray ForBwuWebrtcPathAvailable(const std::string& peer_id,
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForBwuLastWrite() {
+ByteArray ForBwuLastWrite(bool make_before_break) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -307,6 +325,9 @@ ByteArray ForBwuLastWrite() {
   auto* sub_frame = v1_frame->mutable_bandwidth_upgrade_negotiation();
   sub_frame->set_event_type(
       BandwidthUpgradeNegotiationFrame::LAST_WRITE_TO_PRIOR_CHANNEL);
+  if (make_before_break) {
+    sub_frame->mutable_last_write_info()->set_make_before_break(true);
+  }
 
   return ToBytes(std::move(frame));
 }
@@ -325,7 +346,8 @@ ByteArray ForBwuSafeToClose() {
 }
 
 ByteArray ForBwuIntroduction(const std::string& endpoint_id,
-                             bool supports_disabling_encryption) {
+                             bool supports_disabling_encryption,
+                             bool supports_make_before_break) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -338,11 +360,14 @@ ByteArray ForBwuIntroduction(const std::string& endpoint_id,
   client_introduction->set_endpoint_id(endpoint_id);
   client_introduction->set_supports_disabling_encryption(
       supports_disabling_encryption);
+  if (supports_make_before_break) {
+    client_introduction->set_supports_make_before_break(true);
+  }
 
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForBwuIntroductionAck() {
+ByteArray ForBwuIntroductionAck(bool supports_make_before_break) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -351,6 +376,10 @@ ByteArray ForBwuIntroductionAck() {
   auto* sub_frame = v1_frame->mutable_bandwidth_upgrade_negotiation();
   sub_frame->set_event_type(
       BandwidthUpgradeNegotiationFrame::CLIENT_INTRODUCTION_ACK);
+  if (supports_make_before_break) {
+    sub_frame->mutable_client_introduction_ack()->set_supports_make_before_break(
+        true);
+  }
 
   return ToBytes(std::move(frame));
 }
@@ -369,13 +398,14 @@ ByteArray ForBwuFailure(const UpgradePathInfo& info) {
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForKeepAlive() {
+ByteArray ForKeepAlive(bool ack) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
   auto* v1_frame = frame.mutable_v1();
   v1_frame->set_type(V1Frame::KEEP_ALIVE);
-  v1_frame->mutable_keep_alive();
+  auto* keep_alive = v1_frame->mutable_keep_alive();
+  if (ack) keep_alive->set_ack(true);
 
   return ToBytes(std::move(frame));
 }
@@ -44,20 +44,26 @@ V1Frame::FrameType GetFrameType(const OfflineFrame& offline_frame);
 
 // Builds Connection Request / Response messages.
 ByteArray ForConnectionRequest(const ConnectionInfo& conection_info);
-ByteArray ForConnectionResponse(std::int32_t status);
-
-// Builds Payload transfer messages.
+ByteArray ForConnectionResponse(std::int32_t status,
+                                bool supports_aead_frame_cipher,
+                                bool supports_payload_compression = false,
+                                bool supports_delta_transfer = false,
+                                bool supports_chunked_bytes_payloads = false);
+
+// Builds Payload transfer messages. The chunk is taken by value, so that the
+// caller can move its body into the frame instead of copying it.
 ByteArray ForDataPayloadTransfer(
     const PayloadTransferFrame::PayloadHeader& header,
-    const PayloadTransferFrame::PayloadChunk& chunk);
+    PayloadTransferFrame::PayloadChunk chunk);
 ByteArray ForControlPayloadTransfer(
     const PayloadTransferFrame::PayloadHeader& header,
     const PayloadTransferFrame::ControlMessage& control);
 
 // Builds Bandwidth Upgrade [BWU] messages.
 ByteArray ForBwuIntroduction(const std::string& endpoint_id,
-                             bool supports_disabling_encryption);
-ByteArray ForBwuIntroductionAck();
+                             bool supports_disabling_encryption,
+                             bool supports_make_before_break = false);
+ByteArray ForBwuIntroductionAck(bool supports_make_before_break = false);
 ByteArray ForBwuWifiHotspotPathAvailable(const std::string& ssid,
                                          const std::string& password,
                                          std::int32_t port,
@@ -79,10 +85,10 @@ ByteArray ForBwuBluetoothPathAvailable(const std::string& service_id,
 ByteArray ForBwuWebrtcPathAvailable(const std::string& peer_id,
                                     const LocationHint& location_hint_a);
 ByteArray ForBwuFailure(const UpgradePathInfo& info);
-ByteArray ForBwuLastWrite();
+ByteArray ForBwuLastWrite(bool make_before_break = false);
 ByteArray ForBwuSafeToClose();
 
-ByteArray ForKeepAlive();
+ByteArray ForKeepAlive(bool ack = false);
 ByteArray ForDisconnection();
 
 UpgradePathInfo::Medium MediumToUpgradePathInfoMedium(Medium medium);
@@ -139,7 +139,94 @@ TEST(OfflineFramesTest, CanGenerateConnectionResponse) {
       type: CONNECTION_RESPONSE
       connection_response: < status: 1 response: REJECT >
     >)pb";
-  ByteArray bytes = ForConnectionResponse(1);
+  ByteArray bytes =
+      ForConnectionResponse(1, /*supports_aead_frame_cipher=*/false);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
+TEST(OfflineFramesTest, CanGenerateConnectionResponseWithFrameCipher) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: CONNECTION_RESPONSE
+      connection_response: <
+        status: 0
+        response: ACCEPT
+        supports_aead_frame_cipher: true
+      >
+    >)pb";
+  ByteArray bytes =
+      ForConnectionResponse(0, /*supports_aead_frame_cipher=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
+TEST(OfflineFramesTest, CanGenerateConnectionResponseWithPayloadCompression) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: CONNECTION_RESPONSE
+      connection_response: <
+        status: 0
+        response: ACCEPT
+        supports_payload_compression: true
+      >
+    >)pb";
+  ByteArray bytes =
+      ForConnectionResponse(0, /*supports_aead_frame_cipher=*/false,
+                            /*supports_payload_compression=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
+TEST(OfflineFramesTest, CanGenerateConnectionResponseWithDeltaTransfer) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: CONNECTION_RESPONSE
+      connection_response: <
+        status: 0
+        response: ACCEPT
+        supports_delta_transfer: true
+      >
+    >)pb";
+  ByteArray bytes =
+      ForConnectionResponse(0, /*supports_aead_frame_cipher=*/false,
+                            /*supports_payload_compression=*/false,
+                            /*supports_delta_transfer=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
+TEST(OfflineFramesTest, CanGenerateConnectionResponseWithChunkedBytes) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: CONNECTION_RESPONSE
+      connection_response: <
+        status: 0
+        response: ACCEPT
+        supports_chunked_bytes_payloads: true
+      >
+    >)pb";
+  ByteArray bytes =
+      ForConnectionResponse(0, /*supports_aead_frame_cipher=*/false,
+                            /*supports_payload_compression=*/false,
+                            /*supports_delta_transfer=*/false,
+                            /*supports_chunked_bytes_payloads=*/true);
   auto response = FromBytes(bytes);
   ASSERT_TRUE(response.ok());
   OfflineFrame message = FromBytes(bytes).result();
@@ -350,6 +437,24 @@ TEST(OfflineFramesTest, CanGenerateBwuLastWrite) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateBwuMakeBeforeBreakLastWrite) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: BANDWIDTH_UPGRADE_NEGOTIATION
+      bandwidth_upgrade_negotiation: <
+        event_type: LAST_WRITE_TO_PRIOR_CHANNEL
+        last_write_info: < make_before_break: true >
+      >
+    >)pb";
+  ByteArray bytes = ForBwuLastWrite(/*make_before_break=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 TEST(OfflineFramesTest, CanGenerateBwuSafeToClose) {
   constexpr char kExpected[] =
       R"pb(
@@ -387,6 +492,25 @@ TEST(OfflineFramesTest, CanGenerateBwuIntroduction) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateBwuIntroductionAckWithMakeBeforeBreak) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: BANDWIDTH_UPGRADE_NEGOTIATION
+      bandwidth_upgrade_negotiation: <
+        event_type: CLIENT_INTRODUCTION_ACK
+        client_introduction_ack: < supports_make_before_break: true >
+      >
+    >)pb";
+  ByteArray bytes =
+      ForBwuIntroductionAck(/*supports_make_before_break=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 TEST(OfflineFramesTest, CanGenerateKeepAlive) {
   constexpr char kExpected[] =
       R"pb(
@@ -402,6 +526,21 @@ TEST(OfflineFramesTest, CanGenerateKeepAlive) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateKeepAliveAck) {
+  constexpr char kExpected[] =
+      R"pb(
+    version: V1
+    v1: <
+      type: KEEP_ALIVE
+      keep_alive: < ack: true >
+    >)pb";
+  ByteArray bytes = ForKeepAlive(/*ack=*/true);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = FromBytes(bytes).result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 }  // namespace
 }  // namespace parser
 }  // namespace connections
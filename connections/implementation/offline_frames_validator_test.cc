@@ -152,7 +152,8 @@ TEST(OfflineFramesValidatorTest,
      ValidatesAsOkWithValidConnectionResponseFrame) {
   OfflineFrame offline_frame;
 
-  ByteArray bytes = ForConnectionResponse(kStatusAccepted);
+  ByteArray bytes = ForConnectionResponse(
+      kStatusAccepted, /*supports_aead_frame_cipher=*/false);
   offline_frame.ParseFromString(std::string(bytes));
 
   auto ret_value = EnsureValidOfflineFrame(offline_frame);
@@ -164,7 +165,8 @@ TEST(OfflineFramesValidatorTest,
      ValidatesAsFailWithNullConnectionResponseFrame) {
   OfflineFrame offline_frame;
 
-  ByteArray bytes = ForConnectionResponse(kStatusAccepted);
+  ByteArray bytes = ForConnectionResponse(
+      kStatusAccepted, /*supports_aead_frame_cipher=*/false);
   offline_frame.ParseFromString(std::string(bytes));
   auto* v1_frame = offline_frame.mutable_v1();
 
@@ -179,7 +181,8 @@ TEST(OfflineFramesValidatorTest,
      ValidatesAsFailWithUnexpectedStatusInConnectionResponseFrame) {
   OfflineFrame offline_frame;
 
-  ByteArray bytes = ForConnectionResponse(-1);
+  ByteArray bytes =
+      ForConnectionResponse(-1, /*supports_aead_frame_cipher=*/false);
   offline_frame.ParseFromString(std::string(bytes));
 
   auto ret_value = EnsureValidOfflineFrame(offline_frame);
@@ -1037,7 +1037,8 @@ Status P2pClusterPcpHandler::InjectEndpointImpl(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
-    ClientProxy* client, BasePcpHandler::DiscoveredEndpoint* endpoint) {
+    ClientProxy* client, BasePcpHandler::DiscoveredEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   if (!endpoint) {
     return BasePcpHandler::ConnectImplResult{
         .status = {Status::kError},
@@ -1047,7 +1048,8 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
     case proto::connections::Medium::BLUETOOTH: {
       auto* bluetooth_endpoint = down_cast<BluetoothEndpoint*>(endpoint);
       if (bluetooth_endpoint) {
-        return BluetoothConnectImpl(client, bluetooth_endpoint);
+        return BluetoothConnectImpl(client, bluetooth_endpoint,
+                                    cancellation_flag);
       }
       break;
     }
@@ -1055,13 +1057,14 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
       if (FeatureFlags::GetInstance().GetFlags().support_ble_v2) {
         auto* ble_v2_endpoint = down_cast<BleV2Endpoint*>(endpoint);
         if (ble_v2_endpoint) {
-          return BleV2ConnectImpl(client, ble_v2_endpoint);
+          return BleV2ConnectImpl(client, ble_v2_endpoint,
+                                  cancellation_flag);
         }
 
       } else {
         auto* ble_endpoint = down_cast<BleEndpoint*>(endpoint);
         if (ble_endpoint) {
-          return BleConnectImpl(client, ble_endpoint);
+          return BleConnectImpl(client, ble_endpoint, cancellation_flag);
         }
       }
       break;
@@ -1069,7 +1072,8 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
     case proto::connections::Medium::WIFI_LAN: {
       auto* wifi_lan_endpoint = down_cast<WifiLanEndpoint*>(endpoint);
       if (wifi_lan_endpoint) {
-        return WifiLanConnectImpl(client, wifi_lan_endpoint);
+        return WifiLanConnectImpl(client, wifi_lan_endpoint,
+                                  cancellation_flag);
       }
       break;
     }
@@ -1211,15 +1215,15 @@ proto::connections::Medium P2pClusterPcpHandler::StartBluetoothDiscovery(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BluetoothConnectImpl(
-    ClientProxy* client, BluetoothEndpoint* endpoint) {
+    ClientProxy* client, BluetoothEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_LOGS(VERBOSE) << "Client " << client->GetClientId()
                        << " is attempting to connect to endpoint(id="
                        << endpoint->endpoint_id << ") over Bluetooth Classic.";
   BluetoothDevice& device = endpoint->bluetooth_device;
 
   BluetoothSocket bluetooth_socket = bluetooth_medium_.Connect(
-      device, endpoint->service_id,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+      device, endpoint->service_id, cancellation_flag);
   if (!bluetooth_socket.IsValid()) {
     NEARBY_LOGS(ERROR)
         << "In BluetoothConnectImpl(), failed to connect to Bluetooth device "
@@ -1446,7 +1450,8 @@ proto::connections::Medium P2pClusterPcpHandler::StartBleScanning(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleConnectImpl(
-    ClientProxy* client, BleEndpoint* endpoint) {
+    ClientProxy* client, BleEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_LOGS(VERBOSE) << "Client " << client->GetClientId()
                        << " is attempting to connect to endpoint(id="
                        << endpoint->endpoint_id << ") over BLE.";
@@ -1454,8 +1459,7 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleConnectImpl(
   BlePeripheral& peripheral = endpoint->ble_peripheral;
 
   BleSocket ble_socket =
-      ble_medium_.Connect(peripheral, endpoint->service_id,
-                          client->GetCancellationFlag(endpoint->endpoint_id));
+      ble_medium_.Connect(peripheral, endpoint->service_id, cancellation_flag);
   if (!ble_socket.IsValid()) {
     NEARBY_LOGS(ERROR)
         << "In BleConnectImpl(), failed to connect to BLE device "
@@ -1674,7 +1678,8 @@ proto::connections::Medium P2pClusterPcpHandler::StartBleV2Scanning(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleV2ConnectImpl(
-    ClientProxy* client, BleV2Endpoint* endpoint) {
+    ClientProxy* client, BleV2Endpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_LOGS(VERBOSE) << "Client " << client->GetClientId()
                        << " is attempting to connect to endpoint(id="
                        << endpoint->endpoint_id << ") over BLE.";
@@ -1682,8 +1687,7 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleV2ConnectImpl(
   BleV2Peripheral& peripheral = endpoint->ble_peripheral;
 
   BleV2Socket ble_socket = ble_v2_medium_.Connect(
-      endpoint->service_id, peripheral,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+      endpoint->service_id, peripheral, cancellation_flag);
   if (!ble_socket.IsValid()) {
     NEARBY_LOGS(ERROR)
         << "In BleConnectImpl(), failed to connect to BLE device "
@@ -1830,13 +1834,13 @@ proto::connections::Medium P2pClusterPcpHandler::StartWifiLanDiscovery(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::WifiLanConnectImpl(
-    ClientProxy* client, WifiLanEndpoint* endpoint) {
+    ClientProxy* client, WifiLanEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_LOGS(INFO) << "Client " << client->GetClientId()
                     << " is attempting to connect to endpoint(id="
                     << endpoint->endpoint_id << ") over WifiLan.";
   WifiLanSocket socket = wifi_lan_medium_.Connect(
-      endpoint->service_id, endpoint->service_info,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+      endpoint->service_id, endpoint->service_info, cancellation_flag);
   NEARBY_LOGS(ERROR) << "In WifiLanConnectImpl(), connect to service "
                      << " socket=" << &socket.GetImpl()
                      << " for endpoint(id=" << endpoint->endpoint_id << ").";
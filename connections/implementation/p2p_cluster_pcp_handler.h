@@ -91,10 +91,10 @@ class P2pClusterPcpHandler : public BasePcpHandler {
       ClientProxy* client, const std::string& service_id,
       const OutOfBandConnectionMetadata& metadata) override;
 
-  // @PCPHandlerThread
+  // May run on a connect-attempt thread (see BasePcpHandler).
   BasePcpHandler::ConnectImplResult ConnectImpl(
-      ClientProxy* client,
-      BasePcpHandler::DiscoveredEndpoint* endpoint) override;
+      ClientProxy* client, BasePcpHandler::DiscoveredEndpoint* endpoint,
+      CancellationFlag* cancellation_flag) override;
 
  private:
   // Holds the state required to re-create a BleEndpoint we see on a
@@ -155,7 +155,8 @@ class P2pClusterPcpHandler : public BasePcpHandler {
       BluetoothDiscoveredDeviceCallback callback, ClientProxy* client,
       const std::string& service_id);
   BasePcpHandler::ConnectImplResult BluetoothConnectImpl(
-      ClientProxy* client, BluetoothEndpoint* endpoint);
+      ClientProxy* client, BluetoothEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // Ble
   bool IsRecognizedBleEndpoint(const std::string& service_id,
@@ -176,8 +177,9 @@ class P2pClusterPcpHandler : public BasePcpHandler {
       BleDiscoveredPeripheralCallback callback, ClientProxy* client,
       const std::string& service_id,
       const std::string& fast_advertisement_service_uuid);
-  BasePcpHandler::ConnectImplResult BleConnectImpl(ClientProxy* client,
-                                                   BleEndpoint* endpoint);
+  BasePcpHandler::ConnectImplResult BleConnectImpl(
+      ClientProxy* client, BleEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // BleV2
   bool IsRecognizedBleV2Endpoint(absl::string_view service_id,
@@ -200,8 +202,9 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   proto::connections::Medium StartBleV2Scanning(
       BleV2DiscoveredPeripheralCallback callback, ClientProxy* client,
       const std::string& service_id, const DiscoveryOptions& discovery_options);
-  BasePcpHandler::ConnectImplResult BleV2ConnectImpl(ClientProxy* client,
-                                                     BleV2Endpoint* endpoint);
+  BasePcpHandler::ConnectImplResult BleV2ConnectImpl(
+      ClientProxy* client, BleV2Endpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // WifiLan
   bool IsRecognizedWifiLanEndpoint(
@@ -221,7 +224,8 @@ class P2pClusterPcpHandler : public BasePcpHandler {
       WifiLanDiscoveredServiceCallback callback, ClientProxy* client,
       const std::string& service_id);
   BasePcpHandler::ConnectImplResult WifiLanConnectImpl(
-      ClientProxy* client, WifiLanEndpoint* endpoint);
+      ClientProxy* client, WifiLanEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   BluetoothRadio& bluetooth_radio_;
   BluetoothClassic& bluetooth_medium_;
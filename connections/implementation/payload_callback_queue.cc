@@ -0,0 +1,104 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_callback_queue.h"
+
+#include <string>
+#include <utility>
+
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+PayloadCallbackQueue::PayloadCallbackQueue(absl::Duration min_progress_interval,
+                                           std::int64_t min_progress_bytes)
+    : min_progress_interval_(min_progress_interval),
+      min_progress_bytes_(min_progress_bytes) {}
+
+PayloadCallbackQueue::~PayloadCallbackQueue() { Shutdown(); }
+
+void PayloadCallbackQueue::Post(Runnable callback) {
+  executor_.Execute(std::move(callback));
+}
+
+void PayloadCallbackQueue::PostProgress(const std::string& endpoint_id,
+                                        const PayloadProgressInfo& info,
+                                        ProgressCallback callback) {
+  Key key(endpoint_id, info.payload_id);
+  {
+    MutexLock lock(&mutex_);
+    if (info.status != PayloadProgressInfo::Status::kInProgress) {
+      // Supersedes any update still waiting to run, which then finds its
+      // payload gone.
+      progress_.erase(key);
+      executor_.Execute(
+          [callback = std::move(callback), info]() { callback(info); });
+      return;
+    }
+
+    Progress& progress = progress_[key];
+    if (progress.pending) {
+      progress.latest = info;
+      return;
+    }
+    if (SystemClock::ElapsedRealtime() - progress.last_delivered_time <
+            min_progress_interval_ &&
+        info.bytes_transferred - progress.last_delivered_bytes <
+            min_progress_bytes_) {
+      return;
+    }
+    progress.pending = true;
+    progress.latest = info;
+  }
+  executor_.Execute([this, key = std::move(key),
+                     callback = std::move(callback)]() {
+    DeliverProgress(key, callback);
+  });
+}
+
+void PayloadCallbackQueue::DeliverProgress(const Key& key,
+                                           const ProgressCallback& callback) {
+  PayloadProgressInfo info;
+  {
+    MutexLock lock(&mutex_);
+    auto item = progress_.find(key);
+    if (item == progress_.end() || !item->second.pending) return;
+    Progress& progress = item->second;
+    progress.pending = false;
+    progress.last_delivered_time = SystemClock::ElapsedRealtime();
+    progress.last_delivered_bytes = progress.latest.bytes_transferred;
+    info = progress.latest;
+  }
+  callback(info);
+}
+
+void PayloadCallbackQueue::ForgetEndpoint(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  for (auto item = progress_.begin(); item != progress_.end();) {
+    if (item->first.first == endpoint_id) {
+      progress_.erase(item++);
+    } else {
+      ++item;
+    }
+  }
+}
+
+void PayloadCallbackQueue::Shutdown() { executor_.Shutdown(); }
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,98 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PAYLOAD_CALLBACK_QUEUE_H_
+#define CORE_INTERNAL_PAYLOAD_CALLBACK_QUEUE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/runnable.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Runs a client's callbacks on a thread of its own, in the order they were
+// posted in, so that they are not called with any of the caller's locks held
+// and a slow listener does not hold back reading from the endpoints.
+//
+// Payload progress updates are coalesced: an in-progress update for an
+// (endpoint, payload) pair is dropped unless at least |min_progress_interval|
+// has passed or |min_progress_bytes| have been transferred since the last one
+// delivered, and an update still waiting to run is replaced by newer ones.
+// Updates with a terminal status (success, failure, canceled) are always
+// delivered, after any update posted before them.
+class PayloadCallbackQueue {
+ public:
+  using ProgressCallback = std::function<void(const PayloadProgressInfo&)>;
+
+  PayloadCallbackQueue(absl::Duration min_progress_interval,
+                       std::int64_t min_progress_bytes);
+  // Waits for the callbacks posted so far to run.
+  ~PayloadCallbackQueue();
+
+  // Runs |callback| after the callbacks posted before it.
+  void Post(Runnable callback);
+
+  // Runs |callback| with |info|, or with a later update for the same payload,
+  // unless the update is coalesced away (see above).
+  void PostProgress(const std::string& endpoint_id,
+                    const PayloadProgressInfo& info, ProgressCallback callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets the progress of |endpoint_id|'s payloads, eg. once it is
+  // disconnected. Updates still waiting to run are dropped.
+  void ForgetEndpoint(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Waits for the callbacks posted so far to run; later ones are dropped.
+  void Shutdown();
+
+ private:
+  using Key = std::pair<std::string, std::int64_t>;
+
+  struct Progress {
+    // Set while an update is waiting to run; holds the latest update.
+    bool pending = false;
+    PayloadProgressInfo latest;
+    absl::Time last_delivered_time = absl::InfinitePast();
+    std::int64_t last_delivered_bytes = 0;
+  };
+
+  void DeliverProgress(const Key& key, const ProgressCallback& callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const absl::Duration min_progress_interval_;
+  const std::int64_t min_progress_bytes_;
+
+  Mutex mutex_;
+  absl::flat_hash_map<Key, Progress> progress_ ABSL_GUARDED_BY(mutex_);
+
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_PAYLOAD_CALLBACK_QUEUE_H_
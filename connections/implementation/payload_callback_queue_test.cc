@@ -0,0 +1,172 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_callback_queue.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr char kEndpointId[] = "ABCD";
+constexpr char kOtherEndpointId[] = "EFGH";
+constexpr std::int64_t kPayloadId = 1;
+constexpr std::int64_t kTotalBytes = 1000;
+
+PayloadProgressInfo MakeProgress(std::int64_t bytes_transferred,
+                                 PayloadProgressInfo::Status status =
+                                     PayloadProgressInfo::Status::kInProgress) {
+  return {kPayloadId, status, kTotalBytes, bytes_transferred};
+}
+
+// Records the bytes_transferred of the updates delivered to it.
+class ProgressRecorder {
+ public:
+  PayloadCallbackQueue::ProgressCallback Callback() {
+    return [this](const PayloadProgressInfo& info) {
+      MutexLock lock(&mutex_);
+      delivered_.push_back(info.bytes_transferred);
+    };
+  }
+
+  std::vector<std::int64_t> GetDelivered() {
+    MutexLock lock(&mutex_);
+    return delivered_;
+  }
+
+ private:
+  Mutex mutex_;
+  std::vector<std::int64_t> delivered_;
+};
+
+// Blocks the queue until |released| is counted down.
+void Block(PayloadCallbackQueue& queue, CountDownLatch& released) {
+  queue.Post([&released]() { released.Await(); });
+}
+
+TEST(PayloadCallbackQueueTest, RunsCallbacksInOrder) {
+  PayloadCallbackQueue queue(absl::ZeroDuration(), 0);
+  Mutex mutex;
+  std::vector<int> order;
+
+  for (int i = 0; i < 5; ++i) {
+    queue.Post([&, i]() {
+      MutexLock lock(&mutex);
+      order.push_back(i);
+    });
+  }
+  queue.Shutdown();
+
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(PayloadCallbackQueueTest, ReplacesPendingUpdateWithLatest) {
+  PayloadCallbackQueue queue(absl::ZeroDuration(), 0);
+  ProgressRecorder recorder;
+  CountDownLatch released(1);
+
+  Block(queue, released);
+  queue.PostProgress(kEndpointId, MakeProgress(100), recorder.Callback());
+  queue.PostProgress(kEndpointId, MakeProgress(200), recorder.Callback());
+  queue.PostProgress(kEndpointId, MakeProgress(300), recorder.Callback());
+  released.CountDown();
+  queue.Shutdown();
+
+  EXPECT_THAT(recorder.GetDelivered(), ElementsAre(300));
+}
+
+TEST(PayloadCallbackQueueTest, DropsUpdatesBelowIntervalAndBytes) {
+  PayloadCallbackQueue queue(absl::Hours(1), 500);
+  ProgressRecorder recorder;
+
+  queue.PostProgress(kEndpointId, MakeProgress(100), recorder.Callback());
+  // Wait for the first update to be delivered before posting more.
+  CountDownLatch delivered(1);
+  queue.Post([&delivered]() { delivered.CountDown(); });
+  delivered.Await();
+  queue.PostProgress(kEndpointId, MakeProgress(200), recorder.Callback());
+  queue.PostProgress(kEndpointId, MakeProgress(599), recorder.Callback());
+  queue.PostProgress(kEndpointId, MakeProgress(600), recorder.Callback());
+  queue.Shutdown();
+
+  EXPECT_THAT(recorder.GetDelivered(), ElementsAre(100, 600));
+}
+
+TEST(PayloadCallbackQueueTest, AlwaysDeliversTerminalUpdates) {
+  PayloadCallbackQueue queue(absl::Hours(1), kTotalBytes);
+  ProgressRecorder recorder;
+  CountDownLatch released(1);
+
+  Block(queue, released);
+  queue.PostProgress(kEndpointId, MakeProgress(100), recorder.Callback());
+  queue.PostProgress(
+      kEndpointId,
+      MakeProgress(kTotalBytes, PayloadProgressInfo::Status::kSuccess),
+      recorder.Callback());
+  released.CountDown();
+  queue.Shutdown();
+
+  // The terminal update supersedes the one still waiting to run.
+  EXPECT_THAT(recorder.GetDelivered(), ElementsAre(kTotalBytes));
+}
+
+TEST(PayloadCallbackQueueTest, CoalescesPerEndpoint) {
+  PayloadCallbackQueue queue(absl::ZeroDuration(), 0);
+  ProgressRecorder recorder;
+  ProgressRecorder other_recorder;
+  CountDownLatch released(1);
+
+  Block(queue, released);
+  queue.PostProgress(kEndpointId, MakeProgress(100), recorder.Callback());
+  queue.PostProgress(kOtherEndpointId, MakeProgress(200),
+                     other_recorder.Callback());
+  queue.PostProgress(kEndpointId, MakeProgress(300), recorder.Callback());
+  released.CountDown();
+  queue.Shutdown();
+
+  EXPECT_THAT(recorder.GetDelivered(), ElementsAre(300));
+  EXPECT_THAT(other_recorder.GetDelivered(), ElementsAre(200));
+}
+
+TEST(PayloadCallbackQueueTest, ForgetEndpointDropsPendingUpdates) {
+  PayloadCallbackQueue queue(absl::ZeroDuration(), 0);
+  ProgressRecorder recorder;
+  CountDownLatch released(1);
+
+  Block(queue, released);
+  queue.PostProgress(kEndpointId, MakeProgress(100), recorder.Callback());
+  queue.ForgetEndpoint(kEndpointId);
+  released.CountDown();
+  queue.Shutdown();
+
+  EXPECT_TRUE(recorder.GetDelivered().empty());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -24,11 +24,14 @@
 #include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/throughput_recorder.h"
+#include "connections/implementation/chunk_compression.h"
 #include "connections/implementation/internal_payload_factory.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/system_clock.h"
 
 namespace location {
 namespace nearby {
@@ -37,6 +40,21 @@ namespace connections {
 using analytics::PacketMetaData;
 using analytics::ThroughputRecorderContainer;
 
+namespace {
+
+// How many received FILE payloads are remembered as bases for deltas.
+constexpr std::size_t kMaxReceivedFiles = 64;
+
+// Returns the name that the sender of a FILE payload gave it, the same each
+// time it sends the file.
+std::string GetSentFileName(const PayloadTransferFrame::PayloadHeader& header) {
+  return absl::StrCat(header.parent_folder(), "/",
+                      header.has_file_name() ? header.file_name()
+                                             : absl::StrCat(header.id()));
+}
+
+}  // namespace
+
 // C++14 requires to declare this.
 // TODO(apolyudov): remove when migration to c++17 is possible.
 constexpr const absl::Duration PayloadManager::kWaitCloseTimeout;
@@ -44,7 +62,10 @@ constexpr const absl::Duration PayloadManager::kWaitCloseTimeout;
 bool PayloadManager::SendPayloadLoop(
     ClientProxy* client, PendingPayload& pending_payload,
     PayloadTransferFrame::PayloadHeader& payload_header,
-    std::int64_t& next_chunk_offset, size_t resume_offset) {
+    std::int64_t& next_chunk_offset, size_t resume_offset,
+    std::unique_ptr<ChunkReadAhead>& read_ahead,
+    std::unique_ptr<block_delta::DeltaEncoder>& delta_encoder,
+    EndpointManager::WrittenChannels& written_channels) {
   // in lieu of structured binding:
   auto pair = GetAvailableAndUnavailableEndpoints(pending_payload);
   const EndpointIds& available_endpoint_ids =
@@ -108,16 +129,55 @@ bool PayloadManager::SendPayloadLoop(
     pending_payload.SetOffsetForEndpoint(endpoint_id, next_chunk_offset);
   }
 
+  int chunk_size = GetOptimalChunkSize(available_endpoint_ids);
+  // Files are read ahead, so that reading the next chunk overlaps with
+  // encrypting and writing this one. Streams are left alone: a read from a
+  // stream may block until the app writes to it.
+  const auto& flags = FeatureFlags::GetInstance().GetFlags();
+  if (!read_ahead && flags.enable_pipelined_payload_send &&
+      payload_header.type() == PayloadTransferFrame::PayloadHeader::FILE) {
+    read_ahead = std::make_unique<ChunkReadAhead>(
+        pending_payload.GetInternalPayload(),
+        flags.payload_send_pipeline_depth, chunk_size);
+  }
+
   // This will block if there is no data to transfer.
   // It will resume when new data arrives, or if Close() is called.
-  int chunk_size = GetOptimalChunkSize(available_endpoint_ids);
+  auto detach_next_chunk = [&]() {
+    return read_ahead ? read_ahead->GetNextChunk(chunk_size)
+                      : pending_payload.GetInternalPayload()->DetachNextChunk(
+                            chunk_size);
+  };
   packet_meta_data.StartFileIo();
-  ByteArray next_chunk =
-      pending_payload.GetInternalPayload()->DetachNextChunk(chunk_size);
+  ByteArray next_chunk;
+  // Save chunk size. We'll need it after we move next_chunk. For a delta, this
+  // is the size of the part of the file that it covers.
+  size_t next_chunk_size = 0;
+  if (delta_encoder) {
+    // The deltas of unchanged parts of the file are tiny; gather them up to
+    // about the size of a chunk, as long as the receiver takes what they
+    // cover in one piece.
+    std::string delta;
+    const std::int64_t encoded_size = delta_encoder->GetEncodedSize();
+    while (!delta_encoder->IsFinished() &&
+           (delta.empty() ||
+            (delta.size() < static_cast<size_t>(chunk_size) &&
+             delta_encoder->GetEncodedSize() - encoded_size + chunk_size +
+                     block_delta::kMaxBlockSize <=
+                 static_cast<std::int64_t>(block_delta::kMaxDecodedSize)))) {
+      ByteArray chunk = detach_next_chunk();
+      if (shutdown_.Get()) return false;
+      ByteArray piece = delta_encoder->Encode(chunk, /*last=*/chunk.Empty());
+      delta.append(piece.data(), piece.size());
+    }
+    next_chunk = ByteArray(std::move(delta));
+    next_chunk_size = delta_encoder->GetEncodedSize() - encoded_size;
+  } else {
+    next_chunk = detach_next_chunk();
+    next_chunk_size = next_chunk.size();
+  }
   packet_meta_data.StopFileIo();
   if (shutdown_.Get()) return false;
-  // Save chunk size. We'll need it after we move next_chunk.
-  auto next_chunk_size = next_chunk.size();
   if (!next_chunk_size &&
       pending_payload.GetInternalPayload()->GetTotalSize() > 0 &&
       pending_payload.GetInternalPayload()->GetTotalSize() <
@@ -130,14 +190,68 @@ bool PayloadManager::SendPayloadLoop(
     return false;
   }
 
+  // Compress the chunk if every endpoint it goes to can decompress it. The
+  // offsets keep counting uncompressed bytes.
+  bool compressed = false;
+  if (next_chunk_size > 0 &&
+      IsPayloadCompressionEnabled(client, available_endpoint_ids)) {
+    ByteArray compressed_chunk = chunk_compression::Compress(next_chunk);
+    if (!compressed_chunk.Empty()) {
+      next_chunk = std::move(compressed_chunk);
+      compressed = true;
+    }
+  }
+
   // Only need to handle outgoing data chunk offset, because the offset will be
   // used to decide if the received chunk is the initial payload chunk.
   // In other cases, the offset should only be used in both side logs when error
   // happened.
   PayloadTransferFrame::PayloadChunk payload_chunk(CreatePayloadChunk(
       next_chunk_offset - resume_offset, std::move(next_chunk)));
+  if (payload_header.type() == PayloadTransferFrame::PayloadHeader::BYTES &&
+      next_chunk_offset == 0 && next_chunk_size > 0 &&
+      static_cast<std::int64_t>(next_chunk_size) <
+          payload_header.total_size()) {
+    payload_chunk.set_flags(payload_chunk.flags() |
+                            PayloadTransferFrame::PayloadChunk::MORE_CHUNKS);
+  }
+  if (compressed) {
+    payload_chunk.set_flags(payload_chunk.flags() |
+                            PayloadTransferFrame::PayloadChunk::COMPRESSED);
+  }
+  if (delta_encoder && next_chunk_size > 0) {
+    payload_chunk.set_flags(payload_chunk.flags() |
+                            PayloadTransferFrame::PayloadChunk::DELTA);
+  }
+  // The chunk body is moved into the outgoing frame; keep what we report.
+  const std::int32_t payload_chunk_flags = payload_chunk.flags();
+  const std::int64_t payload_chunk_offset = payload_chunk.offset();
+  // The bytes that go on the wire: fewer than next_chunk_size for a
+  // compressed or DELTA chunk.
+  const size_t payload_chunk_body_size = payload_chunk.body().size();
+  absl::Time send_start = SystemClock::ElapsedRealtime();
+  // Progress is reported for each endpoint as it writes the chunk.
+  auto on_written = [gate = chunk_written_gate_, client, payload_header,
+                     payload_chunk_flags, payload_chunk_offset,
+                     next_chunk_size, payload_chunk_body_size, send_start,
+                     adaptive = flags.enable_adaptive_chunk_size](
+                        const std::string& endpoint_id) {
+    MutexLock lock(&gate->mutex);
+    PayloadManager* self = gate->payload_manager;
+    if (self == nullptr) return;
+    self->HandleSuccessfulOutgoingChunk(client, endpoint_id, payload_header,
+                                        payload_chunk_flags,
+                                        payload_chunk_offset, next_chunk_size);
+    if (payload_chunk_body_size && adaptive) {
+      self->chunk_sizer_.OnChunkSent(
+          self->endpoint_manager_->GetMedium(endpoint_id),
+          payload_chunk_body_size,
+          SystemClock::ElapsedRealtime() - send_start);
+    }
+  };
   const EndpointIds& failed_endpoint_ids = endpoint_manager_->SendPayloadChunk(
-      payload_header, payload_chunk, available_endpoint_ids, packet_meta_data);
+      payload_header, std::move(payload_chunk), available_endpoint_ids,
+      packet_meta_data, std::move(on_written), &written_channels);
   // Check whether at least one endpoint failed.
   if (!failed_endpoint_ids.empty()) {
     NEARBY_LOGS(INFO) << "Payload xfer: endpoints failed: payload_id="
@@ -152,14 +266,6 @@ bool PayloadManager::SendPayloadLoop(
   // we'll just go right back to the top of the loop and break out when
   // availableEndpointIds is re-synced and found to be empty at that point.
   if (failed_endpoint_ids.size() < available_endpoint_ids.size()) {
-    for (const auto& endpoint_id : available_endpoint_ids) {
-      if (std::find(failed_endpoint_ids.begin(), failed_endpoint_ids.end(),
-                    endpoint_id) == failed_endpoint_ids.end()) {
-        HandleSuccessfulOutgoingChunk(
-            client, endpoint_id, payload_header, payload_chunk.flags(),
-            payload_chunk.offset(), payload_chunk.body().size());
-      }
-    }
     NEARBY_LOGS(VERBOSE) << "PayloadManager done sending chunk at offset "
                          << next_chunk_offset << " of payload_id="
                          << pending_payload.GetInternalPayload()->GetId();
@@ -180,6 +286,44 @@ bool PayloadManager::SendPayloadLoop(
   return true;
 }
 
+bool PayloadManager::OfferDeltaTransfer(
+    ClientProxy* client, const EndpointIds& endpoint_ids,
+    const PayloadTransferFrame::PayloadHeader& payload_header,
+    size_t resume_offset) {
+  const auto& flags = FeatureFlags::GetInstance().GetFlags();
+  // A delta is decoded against the receiver's copy of the file, so a payload
+  // sent to several endpoints is sent as is.
+  if (!flags.enable_delta_transfer ||
+      payload_header.type() != PayloadTransferFrame::PayloadHeader::FILE ||
+      resume_offset != 0 ||
+      payload_header.total_size() < flags.delta_transfer_min_bytes ||
+      endpoint_ids.size() != 1 ||
+      !client->IsDeltaTransferEnabled(endpoint_ids.front())) {
+    return false;
+  }
+
+  SendControlMessage(endpoint_ids, payload_header, /*offset=*/0,
+                     PayloadTransferFrame::ControlMessage::PAYLOAD_DELTA_OFFER);
+  return true;
+}
+
+std::unique_ptr<block_delta::DeltaEncoder> PayloadManager::CreateDeltaEncoder(
+    const PayloadTransferFrame::PayloadHeader& payload_header,
+    ExceptionOr<block_delta::Signatures> signatures) {
+  if (!signatures.ok() || signatures.result().blocks.empty()) {
+    NEARBY_LOGS(INFO) << "PayloadManager sending payload_id="
+                      << payload_header.id() << " as is: "
+                      << (signatures.ok() ? "no basis to send a delta against"
+                                          : "no reply to delta offer");
+    return nullptr;
+  }
+  NEARBY_LOGS(INFO) << "PayloadManager sending payload_id="
+                    << payload_header.id() << " as a delta against "
+                    << signatures.result().blocks.size() << " blocks";
+  return absl::make_unique<block_delta::DeltaEncoder>(
+      std::move(signatures.result()));
+}
+
 std::pair<PayloadManager::Endpoints, PayloadManager::Endpoints>
 PayloadManager::GetAvailableAndUnavailableEndpoints(
     const PendingPayload& pending_payload) {
@@ -264,8 +408,9 @@ std::string PayloadManager::ToString(EndpointInfo::Status status) {
 
 // Creates and starts tracking a PendingPayload for this Payload.
 Payload::Id PayloadManager::CreateOutgoingPayload(
-    Payload payload, const EndpointIds& endpoint_ids) {
-  auto internal_payload{CreateOutgoingInternalPayload(std::move(payload))};
+    Payload payload, const EndpointIds& endpoint_ids, bool chunk_bytes) {
+  auto internal_payload{
+      CreateOutgoingInternalPayload(std::move(payload), chunk_bytes)};
   Payload::Id payload_id = internal_payload->GetId();
   NEARBY_LOGS(INFO) << "CreateOutgoingPayload: payload_id=" << payload_id;
   MutexLock lock(&mutex_);
@@ -279,6 +424,10 @@ Payload::Id PayloadManager::CreateOutgoingPayload(
 
 PayloadManager::PayloadManager(EndpointManager& endpoint_manager)
     : endpoint_manager_(&endpoint_manager) {
+  {
+    MutexLock lock(&chunk_written_gate_->mutex);
+    chunk_written_gate_->payload_manager = this;
+  }
   endpoint_manager_->RegisterFrameProcessor(V1Frame::PAYLOAD_TRANSFER, this);
 }
 
@@ -317,12 +466,20 @@ PayloadManager::~PayloadManager() {
   NEARBY_LOG(INFO, "PayloadManager: going down; self=%p", this);
   ThroughputRecorderContainer::GetInstance().Shutdown();
   DisconnectFromEndpointManager();
+  {
+    MutexLock lock(&chunk_written_gate_->mutex);
+    chunk_written_gate_->payload_manager = nullptr;
+  }
   CancelAllPayloads();
   NEARBY_LOG(INFO, "PayloadManager: turn down payload executors; self=%p",
              this);
   bytes_payload_executor_.Shutdown();
   stream_payload_executor_.Shutdown();
   file_payload_executor_.Shutdown();
+  scheduled_payload_executor_.Shutdown();
+  scheduled_transfers_.clear();
+  delta_offer_timer_.Shutdown();
+  delta_basis_executor_.Shutdown();
 
   CountDownLatch stop_latch(1);
   // Clear our tracked pending payloads.
@@ -395,19 +552,32 @@ void PayloadManager::SendPayload(ClientProxy* client,
 
   // Each payload is sent in FCFS order within each Payload type, blocking any
   // other payload of the same type from even starting until this one is
-  // completely done with. If we ever want to provide isolation across
-  // ClientProxy objects this will need to be significantly re-architected.
+  // completely done with; unless it is scheduled, in which case its chunks
+  // are sent from scheduled_payload_executor_ once it has started. If we ever
+  // want to provide isolation across ClientProxy objects this will need to be
+  // significantly re-architected.
   PayloadType payload_type = payload.GetType();
+  const auto& flags = FeatureFlags::GetInstance().GetFlags();
   size_t resume_offset =
-      FeatureFlags::GetInstance().GetFlags().enable_send_payload_offset
-          ? payload.GetOffset()
-          : 0;
+      flags.enable_send_payload_offset ? payload.GetOffset() : 0;
+  // Only files: a read from a stream may block until the app writes to it,
+  // and bytes keep their own thread, so that a message is not held up behind
+  // the chunk of a file being written to a slow endpoint.
+  bool scheduled =
+      flags.enable_payload_scheduler && payload_type == PayloadType::kFile;
+  std::int32_t priority = payload.GetPriority();
+  std::int32_t weight = payload.GetWeight();
+  // An older receiver would take the first chunk for the whole payload.
+  bool chunk_bytes = flags.enable_bytes_payload_chunking &&
+                     payload_type == PayloadType::kBytes &&
+                     IsChunkedBytesPayloadsEnabled(client, endpoint_ids);
 
   Payload::Id payload_id =
-      CreateOutgoingPayload(std::move(payload), endpoint_ids);
+      CreateOutgoingPayload(std::move(payload), endpoint_ids, chunk_bytes);
   executor->Execute(
-      "send-payload", [this, client, endpoint_ids, payload_id, payload_type,
-                       resume_offset, payload_total_size]() {
+      "send-payload",
+      [this, client, endpoint_ids, payload_id, payload_type, resume_offset,
+       payload_total_size, scheduled, priority, weight]() {
         if (shutdown_.Get()) return;
         PendingPayload* pending_payload = GetPayload(payload_id);
         if (!pending_payload) {
@@ -428,35 +598,155 @@ void PayloadManager::SendPayload(ClientProxy* client,
                                       payload_type, resume_offset,
                                       internal_payload->GetTotalSize());
 
-        PayloadTransferFrame::PayloadHeader payload_header{
+        auto transfer = std::make_shared<OutgoingTransfer>();
+        transfer->client = client;
+        transfer->pending_payload = pending_payload;
+        transfer->payload_header =
             CreatePayloadHeader(*internal_payload, resume_offset,
                                 internal_payload->GetParentFolder(),
-                                internal_payload->GetFileName())};
-
-        bool should_continue = true;
-        std::int64_t next_chunk_offset = 0;
-
-        ThroughputRecorderContainer::GetInstance()
-            .GetTPRecorder(payload_id)
-            ->Start(payload_type, /*isIncoming=*/false);
-        while (should_continue && !shutdown_.Get()) {
-          should_continue =
-              SendPayloadLoop(client, *pending_payload, payload_header,
-                              next_chunk_offset, resume_offset);
+                                internal_payload->GetFileName());
+        transfer->resume_offset = resume_offset;
+        if (!OfferDeltaTransfer(client, endpoint_ids, transfer->payload_header,
+                                resume_offset)) {
+          SendOutgoingTransfer(transfer, scheduled, priority, weight);
+          return;
         }
 
-        ThroughputRecorderContainer::GetInstance().StopTPRecorder(payload_id);
-        RunOnStatusUpdateThread("destroy-payload",
-                                [this, payload_id]()
-                                    RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
-                                      DestroyPendingPayload(payload_id);
-                                    });
+        // The executor sends other payloads while the receiver signs its copy
+        // of the file.
+        // Signing reads the receiver's copy, which is likely the size of this
+        // one.
+        const auto& flags = FeatureFlags::GetInstance().GetFlags();
+        absl::Duration timeout = flags.delta_signature_timeout;
+        if (flags.delta_signature_bytes_per_second > 0) {
+          timeout += absl::Seconds(internal_payload->GetTotalSize()) /
+                     flags.delta_signature_bytes_per_second;
+        }
+        Future<block_delta::Signatures> signatures =
+            pending_payload->GetDeltaSignatures();
+        delta_offer_timer_.Schedule(
+            [signatures]() mutable {
+              signatures.SetException({Exception::kTimeout});
+            },
+            timeout);
+        signatures.AddListener(
+            [this, transfer, scheduled, priority, weight]() {
+              transfer->delta_encoder = CreateDeltaEncoder(
+                  transfer->payload_header,
+                  transfer->pending_payload->GetDeltaSignatures().Get());
+              SendOutgoingTransfer(transfer, scheduled, priority, weight);
+            },
+            GetOutgoingPayloadExecutor(payload_type));
       });
   NEARBY_LOGS(INFO) << "PayloadManager: xfer scheduled: self=" << this
                     << "; payload_id=" << payload_id
                     << ", payload_type=" << ToString(payload_type);
 }
 
+void PayloadManager::SendOutgoingTransfer(
+    std::shared_ptr<OutgoingTransfer> transfer, bool scheduled,
+    std::int32_t priority, std::int32_t weight) {
+  ThroughputRecorderContainer::GetInstance()
+      .GetTPRecorder(transfer->payload_header.id())
+      ->Start(FramePayloadTypeToPayloadType(transfer->payload_header.type()),
+              /*isIncoming=*/false);
+  if (scheduled) {
+    scheduled_payload_executor_.Execute(
+        "schedule-payload", [this, transfer, priority, weight]() {
+          ScheduleOutgoingTransfer(transfer, priority, weight);
+        });
+    return;
+  }
+
+  bool should_continue = true;
+  while (should_continue && !shutdown_.Get()) {
+    should_continue = SendPayloadLoop(
+        transfer->client, *transfer->pending_payload, transfer->payload_header,
+        transfer->next_chunk_offset, transfer->resume_offset,
+        transfer->read_ahead, transfer->delta_encoder,
+        transfer->written_channels);
+  }
+  FinishOutgoingTransfer(*transfer);
+}
+
+void PayloadManager::FinishOutgoingTransfer(OutgoingTransfer& transfer) {
+  Payload::Id payload_id = transfer.payload_header.id();
+  // Stop reading ahead before the payload goes away, and let its channels go.
+  transfer.read_ahead.reset();
+  transfer.written_channels = EndpointManager::WrittenChannels();
+
+  ThroughputRecorderContainer::GetInstance().StopTPRecorder(payload_id);
+  RunOnStatusUpdateThread(
+      "destroy-payload",
+      [this, payload_id]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+        DestroyPendingPayload(payload_id);
+      });
+}
+
+// @PayloadManagerScheduledPayloadThread
+void PayloadManager::ScheduleOutgoingTransfer(
+    std::shared_ptr<OutgoingTransfer> transfer, std::int32_t priority,
+    std::int32_t weight) {
+  Payload::Id payload_id = transfer->payload_header.id();
+  scheduled_transfers_[payload_id] = std::move(transfer);
+  payload_scheduler_.Add(payload_id, priority, weight,
+                         SystemClock::ElapsedRealtime());
+  PostScheduledChunk();
+}
+
+// @PayloadManagerScheduledPayloadThread
+void PayloadManager::SendScheduledChunk() {
+  scheduled_chunk_posted_ = false;
+  Payload::Id payload_id;
+  if (!payload_scheduler_.Pick(SystemClock::ElapsedRealtime(), &payload_id)) {
+    return;
+  }
+
+  OutgoingTransfer& transfer = *scheduled_transfers_[payload_id];
+  // The first chunk of a resumed payload starts at the resume offset.
+  std::int64_t offset = std::max<std::int64_t>(transfer.next_chunk_offset,
+                                               transfer.resume_offset);
+  bool should_continue =
+      !shutdown_.Get() &&
+      SendPayloadLoop(transfer.client, *transfer.pending_payload,
+                      transfer.payload_header, transfer.next_chunk_offset,
+                      transfer.resume_offset, transfer.read_ahead,
+                      transfer.delta_encoder, transfer.written_channels);
+  payload_scheduler_.OnChunkSent(payload_id,
+                                 transfer.next_chunk_offset - offset,
+                                 SystemClock::ElapsedRealtime());
+  if (!should_continue) {
+    for (const auto& payload : GetPayloadSchedulerSnapshot().payloads) {
+      if (payload.id != payload_id) continue;
+      ThroughputRecorderContainer::GetInstance()
+          .GetTPRecorder(payload_id)
+          ->RecordScheduling({.priority = payload.priority,
+                              .weight = payload.weight,
+                              .chunks_sent = payload.chunks_sent,
+                              .longest_wait = payload.longest_wait});
+    }
+    payload_scheduler_.Remove(payload_id);
+    FinishOutgoingTransfer(transfer);
+    scheduled_transfers_.erase(payload_id);
+  }
+  // Queued behind any payloads scheduled meanwhile, so that they get picked
+  // for the next chunk.
+  PostScheduledChunk();
+}
+
+// @PayloadManagerScheduledPayloadThread
+void PayloadManager::PostScheduledChunk() {
+  if (scheduled_chunk_posted_ || payload_scheduler_.IsEmpty()) return;
+  scheduled_chunk_posted_ = true;
+  scheduled_payload_executor_.Execute("send-scheduled-chunk",
+                                      [this]() { SendScheduledChunk(); });
+}
+
+PayloadScheduler::Snapshot PayloadManager::GetPayloadSchedulerSnapshot()
+    const {
+  return payload_scheduler_.GetSnapshot(SystemClock::ElapsedRealtime());
+}
+
 PayloadManager::PendingPayload* PayloadManager::GetPayload(
     Payload::Id payload_id) const {
   MutexLock lock(&mutex_);
@@ -526,6 +816,25 @@ void PayloadManager::OnEndpointDisconnect(ClientProxy* client,
             // Iterate through all our payloads and look for payloads associated
             // with this endpoint.
             MutexLock lock(&mutex_);
+            // Including the ones offered as deltas that did not start.
+            for (auto item = delta_bases_.begin(); item != delta_bases_.end();) {
+              if (item->second.endpoint_id == endpoint_id) {
+                delta_bases_.erase(item++);
+              } else {
+                ++item;
+              }
+            }
+            // And the files it sent, which are never signed for another.
+            for (auto item = received_file_keys_.begin();
+                 item != received_file_keys_.end();) {
+              if (std::get<0>(*item) == client &&
+                  std::get<1>(*item) == endpoint_id) {
+                received_files_.erase(*item);
+                item = received_file_keys_.erase(item);
+              } else {
+                ++item;
+              }
+            }
             for (const auto& payload_id : pending_payloads_.GetAllPayloads()) {
               auto* pending_payload = pending_payloads_.GetPayload(payload_id);
               if (!pending_payload) continue;
@@ -625,14 +934,37 @@ SingleThreadExecutor* PayloadManager::GetOutgoingPayloadExecutor(
 }
 
 int PayloadManager::GetOptimalChunkSize(EndpointIds endpoint_ids) {
+  const bool adaptive =
+      FeatureFlags::GetInstance().GetFlags().enable_adaptive_chunk_size;
   int minChunkSize = std::numeric_limits<int>::max();
   for (const auto& endpoint_id : endpoint_ids) {
+    int max_chunk_size =
+        endpoint_manager_->GetMaxTransmitPacketSize(endpoint_id);
     minChunkSize = std::min(
-        minChunkSize, endpoint_manager_->GetMaxTransmitPacketSize(endpoint_id));
+        minChunkSize,
+        adaptive ? chunk_sizer_.GetChunkSize(
+                       endpoint_manager_->GetMedium(endpoint_id), max_chunk_size)
+                 : max_chunk_size);
   }
   return minChunkSize;
 }
 
+bool PayloadManager::IsPayloadCompressionEnabled(
+    ClientProxy* client, const EndpointIds& endpoint_ids) {
+  for (const auto& endpoint_id : endpoint_ids) {
+    if (!client->IsPayloadCompressionEnabled(endpoint_id)) return false;
+  }
+  return !endpoint_ids.empty();
+}
+
+bool PayloadManager::IsChunkedBytesPayloadsEnabled(
+    ClientProxy* client, const EndpointIds& endpoint_ids) {
+  for (const auto& endpoint_id : endpoint_ids) {
+    if (!client->IsChunkedBytesPayloadsEnabled(endpoint_id)) return false;
+  }
+  return !endpoint_ids.empty();
+}
+
 PayloadTransferFrame::PayloadHeader PayloadManager::CreatePayloadHeader(
     const InternalPayload& internal_payload, size_t offset,
     const std::string& parent_folder, const std::string& file_name) {
@@ -672,7 +1004,8 @@ PayloadTransferFrame::PayloadChunk PayloadManager::CreatePayloadChunk(
 }
 
 PayloadManager::PendingPayload* PayloadManager::CreateIncomingPayload(
-    const PayloadTransferFrame& frame, const std::string& endpoint_id) {
+    const PayloadTransferFrame& frame, ClientProxy* client,
+    const std::string& endpoint_id) {
   auto internal_payload = CreateIncomingInternalPayload(frame);
   if (!internal_payload) {
     return nullptr;
@@ -680,7 +1013,20 @@ PayloadManager::PendingPayload* PayloadManager::CreateIncomingPayload(
 
   Payload::Id payload_id = internal_payload->GetId();
   NEARBY_LOGS(INFO) << "CreateIncomingPayload: payload_id=" << payload_id;
+  std::string file_path = internal_payload->GetFilePath();
   MutexLock lock(&mutex_);
+  if (!file_path.empty()) {
+    ReceivedFileKey key{client, endpoint_id,
+                        GetSentFileName(frame.payload_header())};
+    if (received_files_.find(key) == received_files_.end()) {
+      received_file_keys_.push_back(key);
+      if (received_file_keys_.size() > kMaxReceivedFiles) {
+        received_files_.erase(received_file_keys_.front());
+        received_file_keys_.pop_front();
+      }
+    }
+    received_files_[key] = std::move(file_path);
+  }
   pending_payloads_.StartTrackingPayload(
       payload_id,
       absl::make_unique<PendingPayload>(std::move(internal_payload),
@@ -909,6 +1255,7 @@ void PayloadManager::DestroyPendingPayload(Payload::Id payload_id) {
     auto pending = pending_payloads_.StopTrackingPayload(payload_id);
     if (!pending) return;
     is_incoming = pending->IsIncoming();
+    if (is_incoming) delta_bases_.erase(payload_id);
     const char* direction = is_incoming ? "incoming" : "outgoing";
     NEARBY_LOGS(INFO) << "PayloadManager: destroying " << direction
                       << " pending payload: self=" << this
@@ -960,6 +1307,22 @@ void PayloadManager::HandleSuccessfulIncomingChunk(
       });
 }
 
+void PayloadManager::NotifyClientOfIncomingPayload(
+    ClientProxy* to_client, const std::string& from_endpoint_id,
+    PendingPayload* pending_payload) {
+  RunOnStatusUpdateThread(
+      "process-data-packet",
+      [to_client, from_endpoint_id,
+       pending_payload]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+        NEARBY_LOGS(INFO) << "PayloadManager received new payload_id="
+                          << pending_payload->GetInternalPayload()->GetId()
+                          << " from endpoint_id=" << from_endpoint_id;
+        to_client->OnPayload(
+            from_endpoint_id,
+            pending_payload->GetInternalPayload()->ReleasePayload());
+      });
+}
+
 // @EndpointManagerDataPool
 void PayloadManager::ProcessDataPacket(
     ClientProxy* to_client, const std::string& from_endpoint_id,
@@ -974,8 +1337,43 @@ void PayloadManager::ProcessDataPacket(
                        << " from endpoint_id=" << from_endpoint_id
                        << " at offset " << payload_chunk.offset();
 
+  // Decompress the chunk, then expand it if it is a delta, before anything
+  // looks at its body. A chunk that fails to decode fails its payload, once
+  // that is looked up.
+  bool decoding_failed = false;
+  if ((payload_chunk.flags() &
+       PayloadTransferFrame::PayloadChunk::COMPRESSED) != 0) {
+    ExceptionOr<ByteArray> body = chunk_compression::Decompress(
+        ByteArray(std::move(*payload_chunk.mutable_body())));
+    decoding_failed = !body.ok();
+    payload_chunk.set_body(decoding_failed ? std::string()
+                                           : std::string(body.result()));
+    payload_chunk.set_flags(payload_chunk.flags() &
+                            ~PayloadTransferFrame::PayloadChunk::COMPRESSED);
+  }
+  bool is_delta = (payload_chunk.flags() &
+                   PayloadTransferFrame::PayloadChunk::DELTA) != 0;
+  if (!decoding_failed && is_delta) {
+    if (payload_chunk.offset() == 0) {
+      MoveDeltaBasisAside(payload_header.id(), from_endpoint_id);
+    }
+    ExceptionOr<ByteArray> body =
+        DecodeDelta(payload_header.id(), from_endpoint_id,
+                    ByteArray(std::move(*payload_chunk.mutable_body())));
+    decoding_failed = !body.ok();
+    payload_chunk.set_body(decoding_failed ? std::string()
+                                           : std::string(body.result()));
+    payload_chunk.set_flags(payload_chunk.flags() &
+                            ~PayloadTransferFrame::PayloadChunk::DELTA);
+  }
+
   PendingPayload* pending_payload;
   if (payload_chunk.offset() == 0) {
+    if (!is_delta) {
+      // The sender did not wait for the signatures; they are dropped once
+      // signed.
+      DropDeltaBasis(payload_header.id(), from_endpoint_id);
+    }
     ThroughputRecorderContainer::GetInstance()
         .GetTPRecorder(payload_header.id())
         ->Start((PayloadType)payload_header.type(), /*isIncoming=*/true);
@@ -992,7 +1390,10 @@ void PayloadManager::ProcessDataPacket(
         });
 
     pending_payload =
-        CreateIncomingPayload(payload_transfer_frame, from_endpoint_id);
+        decoding_failed
+            ? nullptr
+            : CreateIncomingPayload(payload_transfer_frame, to_client,
+                                    from_endpoint_id);
     if (!pending_payload) {
       NEARBY_LOGS(WARNING)
           << "PayloadManager failed to create InternalPayload from "
@@ -1007,18 +1408,10 @@ void PayloadManager::ProcessDataPacket(
     }
 
     // Also, let the client know of this new incoming payload.
-    RunOnStatusUpdateThread(
-        "process-data-packet",
-        [to_client, from_endpoint_id, pending_payload]()
-            RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
-              NEARBY_LOGS(INFO)
-                  << "PayloadManager received new payload_id="
-                  << pending_payload->GetInternalPayload()->GetId()
-                  << " from endpoint_id=" << from_endpoint_id;
-              to_client->OnPayload(
-                  from_endpoint_id,
-                  pending_payload->GetInternalPayload()->ReleasePayload());
-            });
+    if (pending_payload->GetInternalPayload()->IsReadyForClient()) {
+      NotifyClientOfIncomingPayload(to_client, from_endpoint_id,
+                                    pending_payload);
+    }
   } else {
     pending_payload = GetPayload(payload_header.id());
     if (!pending_payload) {
@@ -1041,6 +1434,17 @@ void PayloadManager::ProcessDataPacket(
     return;
   }
 
+  if (decoding_failed) {
+    NEARBY_LOGS(ERROR) << "ProcessDataPacket: [decoding error] "
+                          "endpoint_id="
+                       << from_endpoint_id
+                       << "; payload_id=" << pending_payload->GetId();
+    HandleFinishedIncomingPayload(
+        to_client, from_endpoint_id, payload_header, payload_chunk.offset(),
+        proto::connections::PayloadStatus::LOCAL_ERROR);
+    return;
+  }
+
   // Update the offset for this payload. An endpoint disconnection might occur
   // from another thread and we would need to know the current offset to report
   // back to the client. For the sake of accuracy, we update the pending payload
@@ -1051,6 +1455,11 @@ void PayloadManager::ProcessDataPacket(
 
   // Save size of packet before we move it.
   std::int64_t payload_body_size = payload_chunk.body().size();
+  // A BYTES payload sent in several chunks is only handed to the client once
+  // it is complete; until then, there is nothing to report progress on.
+  bool was_ready_for_client =
+      payload_chunk.offset() != 0 &&
+      pending_payload->GetInternalPayload()->IsReadyForClient();
   packet_meta_data.StartFileIo();
   if (pending_payload->GetInternalPayload()
           ->AttachNextChunk(ByteArray(std::move(*payload_chunk.mutable_body())))
@@ -1065,9 +1474,15 @@ void PayloadManager::ProcessDataPacket(
   }
   packet_meta_data.StopFileIo();
 
-  HandleSuccessfulIncomingChunk(to_client, from_endpoint_id, payload_header,
-                                payload_chunk.flags(), payload_chunk.offset(),
-                                payload_body_size);
+  if (pending_payload->GetInternalPayload()->IsReadyForClient()) {
+    if (!was_ready_for_client && payload_chunk.offset() != 0) {
+      NotifyClientOfIncomingPayload(to_client, from_endpoint_id,
+                                    pending_payload);
+    }
+    HandleSuccessfulIncomingChunk(to_client, from_endpoint_id, payload_header,
+                                  payload_chunk.flags(), payload_chunk.offset(),
+                                  payload_body_size);
+  }
 
   ThroughputRecorderContainer::GetInstance()
       .GetTPRecorder(payload_header.id())
@@ -1075,6 +1490,7 @@ void PayloadManager::ProcessDataPacket(
   bool is_last_chunk = (payload_chunk.flags() &
                         PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
   if (is_last_chunk) {
+    DropDeltaBasis(payload_header.id(), from_endpoint_id);
     ThroughputRecorderContainer::GetInstance()
         .GetTPRecorder(payload_header.id())
         ->MarkAsSuccess();
@@ -1092,6 +1508,12 @@ void PayloadManager::ProcessControlPacket(
       payload_transfer_frame.payload_header();
   const PayloadTransferFrame::ControlMessage& control_message =
       payload_transfer_frame.control_message();
+  // The offer comes before the first chunk of the payload it is for.
+  if (control_message.event() ==
+      PayloadTransferFrame::ControlMessage::PAYLOAD_DELTA_OFFER) {
+    ProcessDeltaOffer(to_client, from_endpoint_id, payload_header);
+    return;
+  }
   PendingPayload* pending_payload = GetPayload(payload_header.id());
   if (!pending_payload) {
     NEARBY_LOGS(INFO) << "Got ControlMessage for unknown payload_id="
@@ -1136,6 +1558,24 @@ void PayloadManager::ProcessControlPacket(
                                                              control_message);
       }
       break;
+    case PayloadTransferFrame::ControlMessage::PAYLOAD_DELTA_SIGNATURES: {
+      if (pending_payload->IsIncoming()) break;
+      block_delta::Signatures signatures;
+      if (control_message.has_block_signatures()) {
+        ExceptionOr<block_delta::Signatures> parsed =
+            block_delta::SignaturesFromProto(
+                control_message.block_signatures());
+        if (parsed.ok()) {
+          signatures = std::move(parsed.result());
+        } else {
+          NEARBY_LOGS(WARNING)
+              << "Got malformed delta signatures for payload_id="
+              << payload_header.id();
+        }
+      }
+      pending_payload->SetDeltaSignatures(std::move(signatures));
+      break;
+    }
     default:
       NEARBY_LOGS(INFO) << "Unhandled control message "
                         << control_message.event() << " for payload_id="
@@ -1144,6 +1584,128 @@ void PayloadManager::ProcessControlPacket(
   }
 }
 
+// @EndpointManagerDataPool
+void PayloadManager::ProcessDeltaOffer(
+    ClientProxy* to_client, const std::string& from_endpoint_id,
+    const PayloadTransferFrame::PayloadHeader& payload_header) {
+  // Only a file that this device wrote when it received the payload before is
+  // signed, never one at a path of the sender's choosing.
+  std::string file_path;
+  if (FeatureFlags::GetInstance().GetFlags().enable_delta_transfer &&
+      to_client->IsDeltaTransferEnabled(from_endpoint_id)) {
+    MutexLock lock(&mutex_);
+    auto item = received_files_.find(ReceivedFileKey{
+        to_client, from_endpoint_id, GetSentFileName(payload_header)});
+    if (item != received_files_.end() &&
+        delta_bases_.find(payload_header.id()) == delta_bases_.end()) {
+      file_path = item->second;
+      delta_bases_[payload_header.id()] = {from_endpoint_id, file_path,
+                                           nullptr};
+    }
+  }
+  if (file_path.empty()) {
+    // The sender waits for a reply either way.
+    ReplyToDeltaOffer(from_endpoint_id, payload_header, nullptr);
+    return;
+  }
+
+  // Signing reads the whole file; keep it off the endpoint's reader.
+  delta_basis_executor_.Execute(
+      "delta-basis", [this, from_endpoint_id, payload_header, file_path]() {
+        std::shared_ptr<DeltaBasis> basis = DeltaBasis::Create(file_path);
+        {
+          MutexLock lock(&mutex_);
+          auto item = delta_bases_.find(payload_header.id());
+          if (item == delta_bases_.end()) {
+            NEARBY_LOGS(INFO) << "PayloadManager dropping the delta basis for "
+                                 "payload_id="
+                              << payload_header.id()
+                              << ": the payload went ahead without it";
+            return;
+          }
+          if (basis) {
+            item->second.basis = basis;
+          } else {
+            delta_bases_.erase(item);
+          }
+        }
+        ReplyToDeltaOffer(from_endpoint_id, payload_header, basis.get());
+      });
+}
+
+void PayloadManager::ReplyToDeltaOffer(
+    const std::string& endpoint_id,
+    const PayloadTransferFrame::PayloadHeader& payload_header,
+    const DeltaBasis* basis) {
+  PayloadTransferFrame::ControlMessage control_message;
+  control_message.set_event(
+      PayloadTransferFrame::ControlMessage::PAYLOAD_DELTA_SIGNATURES);
+  control_message.set_offset(0);
+  if (basis) {
+    *control_message.mutable_block_signatures() =
+        block_delta::SignaturesToProto(basis->GetSignatures());
+  }
+  NEARBY_LOGS(INFO) << "PayloadManager replying to delta offer for payload_id="
+                    << payload_header.id() << " with "
+                    << (basis ? "signatures" : "no basis");
+  endpoint_manager_->SendControlMessage(payload_header, control_message,
+                                        {endpoint_id});
+}
+
+ExceptionOr<ByteArray> PayloadManager::DecodeDelta(
+    Payload::Id payload_id, const std::string& from_endpoint_id,
+    const ByteArray& delta) {
+  std::shared_ptr<DeltaBasis> basis;
+  {
+    MutexLock lock(&mutex_);
+    auto item = delta_bases_.find(payload_id);
+    // Payload IDs are picked by the senders; another endpoint may use the
+    // same one.
+    if (item != delta_bases_.end() &&
+        item->second.endpoint_id == from_endpoint_id) {
+      basis = item->second.basis;
+    }
+  }
+  if (!basis) {
+    NEARBY_LOGS(WARNING) << "Got a delta for payload_id=" << payload_id
+                         << " without a basis to decode it against";
+    return ExceptionOr<ByteArray>(Exception::kInvalidProtocolBuffer);
+  }
+  return basis->Decode(delta);
+}
+
+void PayloadManager::MoveDeltaBasisAside(Payload::Id payload_id,
+                                         const std::string& from_endpoint_id) {
+  std::shared_ptr<DeltaBasis> basis;
+  std::string file_path;
+  {
+    MutexLock lock(&mutex_);
+    auto item = delta_bases_.find(payload_id);
+    if (item == delta_bases_.end() ||
+        item->second.endpoint_id != from_endpoint_id) {
+      return;
+    }
+    basis = item->second.basis;
+    file_path = item->second.file_path;
+  }
+  // The sender only sends deltas once the file is signed.
+  if (basis && basis->MoveAside(absl::StrCat(file_path, ".", payload_id,
+                                             DeltaBasis::kAsideSuffix))) {
+    return;
+  }
+  DropDeltaBasis(payload_id, from_endpoint_id);
+}
+
+void PayloadManager::DropDeltaBasis(Payload::Id payload_id,
+                                    const std::string& from_endpoint_id) {
+  MutexLock lock(&mutex_);
+  auto item = delta_bases_.find(payload_id);
+  if (item != delta_bases_.end() &&
+      item->second.endpoint_id == from_endpoint_id) {
+    delta_bases_.erase(item);
+  }
+}
+
 // @PayloadManagerStatusUpdateThread
 void PayloadManager::NotifyClientOfIncomingPayloadProgressInfo(
     ClientProxy* client, const std::string& endpoint_id,
@@ -1247,10 +1809,16 @@ bool PayloadManager::PendingPayload::IsLocallyCanceled() const {
 
 void PayloadManager::PendingPayload::MarkLocallyCanceled() {
   is_locally_canceled_.Set(true);
+  delta_signatures_.SetException({Exception::kInterrupted});
 }
 
 bool PayloadManager::PendingPayload::IsIncoming() const { return is_incoming_; }
 
+void PayloadManager::PendingPayload::SetDeltaSignatures(
+    block_delta::Signatures signatures) {
+  delta_signatures_.Set(std::move(signatures));
+}
+
 std::vector<const PayloadManager::EndpointInfo*>
 PayloadManager::PendingPayload::GetEndpoints() const {
   MutexLock lock(&mutex_);
@@ -1307,6 +1875,7 @@ void PayloadManager::PendingPayload::SetOffsetForEndpoint(
 void PayloadManager::PendingPayload::Close() {
   if (internal_payload_) internal_payload_->Close();
   close_event_.CountDown();
+  delta_signatures_.SetException({Exception::kInterrupted});
 }
 
 bool PayloadManager::PendingPayload::WaitForClose() {
@@ -16,16 +16,23 @@
 #define CORE_INTERNAL_PAYLOAD_MANAGER_H_
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "connections/implementation/adaptive_chunk_sizer.h"
+#include "connections/implementation/block_delta.h"
+#include "connections/implementation/chunk_read_ahead.h"
 #include "connections/implementation/client_proxy.h"
+#include "connections/implementation/delta_basis.h"
 #include "connections/implementation/endpoint_manager.h"
 #include "connections/implementation/internal_payload.h"
+#include "connections/implementation/payload_scheduler.h"
 #include "connections/listeners.h"
 #include "connections/payload.h"
 #include "connections/status.h"
@@ -33,7 +40,10 @@
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/atomic_reference.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/feature_flags.h"
+#include "internal/platform/future.h"
 #include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
 
 namespace location {
 namespace nearby {
@@ -73,6 +83,10 @@ class PayloadManager : public EndpointManager::FrameProcessor {
 
   void DisconnectFromEndpointManager();
 
+  // Returns the state of the outgoing payloads that are scheduled chunk by
+  // chunk (see FeatureFlags::enable_payload_scheduler).
+  PayloadScheduler::Snapshot GetPayloadSchedulerSnapshot() const;
+
  private:
   // Information about an endpoint for a particular payload.
   struct EndpointInfo {
@@ -113,6 +127,15 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     void MarkLocallyCanceled();
     bool IsIncoming() const;
 
+    // Hands the sender the signatures the receiver replied to a delta offer
+    // with; they are empty if it has no basis to offer.
+    void SetDeltaSignatures(block_delta::Signatures signatures);
+    // Returns the signatures set by SetDeltaSignatures(). They fail with
+    // Exception::kInterrupted once the payload is canceled or closed.
+    Future<block_delta::Signatures> GetDeltaSignatures() const {
+      return delta_signatures_;
+    }
+
     // Gets the EndpointInfo objects for the endpoints (still) associated with
     // this payload.
     std::vector<const EndpointInfo*> GetEndpoints() const
@@ -151,6 +174,7 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     bool is_incoming_;
     AtomicBoolean is_locally_canceled_{false};
     CountDownLatch close_event_{1};
+    Future<block_delta::Signatures> delta_signatures_;
     std::unique_ptr<InternalPayload> internal_payload_;
     absl::flat_hash_map<std::string, EndpointInfo> endpoints_
         ABSL_GUARDED_BY(mutex_);
@@ -177,6 +201,19 @@ class PayloadManager : public EndpointManager::FrameProcessor {
         pending_payloads_ ABSL_GUARDED_BY(mutex_);
   };
 
+  // The state of an outgoing payload that SendPayloadLoop() carries from one
+  // chunk to the next.
+  struct OutgoingTransfer {
+    ClientProxy* client = nullptr;
+    PendingPayload* pending_payload = nullptr;
+    PayloadTransferFrame::PayloadHeader payload_header;
+    std::int64_t next_chunk_offset = 0;
+    size_t resume_offset = 0;
+    std::unique_ptr<ChunkReadAhead> read_ahead;
+    std::unique_ptr<block_delta::DeltaEncoder> delta_encoder;
+    EndpointManager::WrittenChannels written_channels;
+  };
+
   using Endpoints = std::vector<const EndpointInfo*>;
   static std::string ToString(const EndpointIds& endpoint_ids);
   static std::string ToString(const Endpoints& endpoints);
@@ -193,9 +230,41 @@ class PayloadManager : public EndpointManager::FrameProcessor {
   // Returns list of endpoint ids.
   static EndpointIds EndpointsToEndpointIds(const Endpoints& endpoints);
 
-  bool SendPayloadLoop(ClientProxy* client, PendingPayload& pending_payload,
-                       PayloadTransferFrame::PayloadHeader& payload_header,
-                       std::int64_t& next_chunk_offset, size_t resume_offset);
+  bool SendPayloadLoop(
+      ClientProxy* client, PendingPayload& pending_payload,
+      PayloadTransferFrame::PayloadHeader& payload_header,
+      std::int64_t& next_chunk_offset, size_t resume_offset,
+      std::unique_ptr<ChunkReadAhead>& read_ahead,
+      std::unique_ptr<block_delta::DeltaEncoder>& delta_encoder,
+      EndpointManager::WrittenChannels& written_channels);
+  // Stops tracking an outgoing payload once its last chunk was sent, or its
+  // transfer was cut short.
+  // Sends |transfer|, on the executor for its payload type or, if
+  // |scheduled|, with payload_scheduler_.
+  void SendOutgoingTransfer(std::shared_ptr<OutgoingTransfer> transfer,
+                            bool scheduled, std::int32_t priority,
+                            std::int32_t weight);
+  void FinishOutgoingTransfer(OutgoingTransfer& transfer);
+  // Hands |transfer| to payload_scheduler_. Runs on
+  // scheduled_payload_executor_, as do the two below.
+  void ScheduleOutgoingTransfer(std::shared_ptr<OutgoingTransfer> transfer,
+                                std::int32_t priority, std::int32_t weight);
+  // Sends a chunk of the payload that payload_scheduler_ picks.
+  void SendScheduledChunk();
+  // Queues SendScheduledChunk(), unless it is queued already, or there is
+  // nothing to send.
+  void PostScheduledChunk();
+  // Offers the receiver of an outgoing FILE payload to send it as a delta,
+  // if it qualifies. Returns false if the payload is to be sent as is.
+  bool OfferDeltaTransfer(
+      ClientProxy* client, const EndpointIds& endpoint_ids,
+      const PayloadTransferFrame::PayloadHeader& payload_header,
+      size_t resume_offset);
+  // Returns the encoder to send a payload with, given the receiver's reply to
+  // its delta offer, or null if the payload is to be sent as is.
+  static std::unique_ptr<block_delta::DeltaEncoder> CreateDeltaEncoder(
+      const PayloadTransferFrame::PayloadHeader& payload_header,
+      ExceptionOr<block_delta::Signatures> signatures);
   void SendClientCallbacksForFinishedIncomingPayloadRunnable(
       ClientProxy* client, const std::string& endpoint_id,
       const PayloadTransferFrame::PayloadHeader& payload_header,
@@ -215,6 +284,13 @@ class PayloadManager : public EndpointManager::FrameProcessor {
       proto::connections::PayloadStatus status);
 
   int GetOptimalChunkSize(EndpointIds endpoint_ids);
+  // Returns true if every one of |endpoint_ids| agreed to compressed chunks.
+  static bool IsPayloadCompressionEnabled(ClientProxy* client,
+                                          const EndpointIds& endpoint_ids);
+  // Returns true if every one of |endpoint_ids| reassembles chunked BYTES
+  // payloads.
+  static bool IsChunkedBytesPayloadsEnabled(ClientProxy* client,
+                                            const EndpointIds& endpoint_ids);
 
   PayloadTransferFrame::PayloadHeader CreatePayloadHeader(
       const InternalPayload& internal_payload, size_t offset,
@@ -224,11 +300,13 @@ class PayloadManager : public EndpointManager::FrameProcessor {
                                                         ByteArray body);
 
   PendingPayload* CreateIncomingPayload(const PayloadTransferFrame& frame,
+                                        ClientProxy* client,
                                         const std::string& endpoint_id)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
   Payload::Id CreateOutgoingPayload(Payload payload,
-                                    const EndpointIds& endpoint_ids)
+                                    const EndpointIds& endpoint_ids,
+                                    bool chunk_bytes)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
   void SendClientCallbacksForFinishedOutgoingPayload(
@@ -260,6 +338,9 @@ class PayloadManager : public EndpointManager::FrameProcessor {
       const PayloadTransferFrame::PayloadHeader& payload_header,
       std::int64_t offset_bytes, proto::connections::PayloadStatus status);
 
+  // Called once |endpoint_id| has written the chunk, not when the chunk is
+  // handed to the EndpointManager: with FeatureFlags::enable_parallel_fan_out,
+  // every endpoint writes it at its own pace.
   void HandleSuccessfulOutgoingChunk(
       ClientProxy* client, const std::string& endpoint_id,
       const PayloadTransferFrame::PayloadHeader& payload_header,
@@ -271,6 +352,10 @@ class PayloadManager : public EndpointManager::FrameProcessor {
       std::int32_t payload_chunk_flags, std::int64_t payload_chunk_offset,
       std::int64_t payload_chunk_body_size);
 
+  // Hands the payload of |pending_payload| to the client.
+  void NotifyClientOfIncomingPayload(ClientProxy* to_client,
+                                     const std::string& from_endpoint_id,
+                                     PendingPayload* pending_payload);
   void ProcessDataPacket(ClientProxy* to_client,
                          const std::string& from_endpoint_id,
                          PayloadTransferFrame& payload_transfer_frame,
@@ -278,6 +363,31 @@ class PayloadManager : public EndpointManager::FrameProcessor {
   void ProcessControlPacket(ClientProxy* to_client,
                             const std::string& from_endpoint_id,
                             PayloadTransferFrame& payload_transfer_frame);
+  // Signs the file that an earlier transfer of an incoming payload wrote, if
+  // any, and replies to the sender's delta offer with the signatures.
+  void ProcessDeltaOffer(
+      ClientProxy* to_client, const std::string& from_endpoint_id,
+      const PayloadTransferFrame::PayloadHeader& payload_header);
+  void ReplyToDeltaOffer(
+      const std::string& endpoint_id,
+      const PayloadTransferFrame::PayloadHeader& payload_header,
+      const DeltaBasis* basis);
+  // Returns the payload bytes that a DELTA chunk of an incoming payload
+  // stands for. Fails unless the basis was signed for |from_endpoint_id|.
+  ExceptionOr<ByteArray> DecodeDelta(Payload::Id payload_id,
+                                     const std::string& from_endpoint_id,
+                                     const ByteArray& delta)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Moves the basis of an incoming payload out of the way of the payload, which
+  // is written over it. Drops the basis if it could not be moved.
+  void MoveDeltaBasisAside(Payload::Id payload_id,
+                           const std::string& from_endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Drops the basis of an incoming payload, if it was signed for
+  // |from_endpoint_id|.
+  void DropDeltaBasis(Payload::Id payload_id,
+                      const std::string& from_endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   void NotifyClientOfIncomingPayloadProgressInfo(
       ClientProxy* client, const std::string& endpoint_id,
@@ -320,6 +430,51 @@ class PayloadManager : public EndpointManager::FrameProcessor {
   SingleThreadExecutor file_payload_executor_;
   SingleThreadExecutor stream_payload_executor_;
   SingleThreadExecutor payload_status_update_executor_;
+  // Sends the chunks of the payloads that payload_scheduler_ schedules.
+  SingleThreadExecutor scheduled_payload_executor_;
+  PayloadScheduler payload_scheduler_{
+      FeatureFlags::GetInstance().GetFlags().payload_scheduler_max_wait};
+  // Only used on scheduled_payload_executor_.
+  absl::flat_hash_map<Payload::Id, std::shared_ptr<OutgoingTransfer>>
+      scheduled_transfers_;
+  bool scheduled_chunk_posted_ = false;
+  // Fails the delta offers of outgoing payloads that get no reply.
+  ScheduledExecutor delta_offer_timer_;
+  // Signs the files that incoming payloads may be sent as deltas against.
+  SingleThreadExecutor delta_basis_executor_;
+  struct IncomingDeltaBasis {
+    std::string endpoint_id;
+    std::string file_path;
+    // Null while the file is being signed.
+    std::shared_ptr<DeltaBasis> basis;
+  };
+  // Incoming payloads that a delta offer was replied to with signatures, or
+  // is being replied to. A basis signed after its payload is erased from here
+  // is dropped.
+  absl::flat_hash_map<Payload::Id, IncomingDeltaBasis> delta_bases_
+      ABSL_GUARDED_BY(mutex_);
+  // The client a FILE payload was received for, the endpoint that sent it
+  // and the name that endpoint gave it. Signatures of a file are only ever
+  // sent back to that same endpoint, for that same client.
+  using ReceivedFileKey =
+      std::tuple<const ClientProxy*, std::string, std::string>;
+  // The paths that the FILE payloads received so far were written to, oldest
+  // first: the only files that signatures are sent for. Forgotten once their
+  // sender disconnects, as another device may reuse its endpoint ID.
+  absl::flat_hash_map<ReceivedFileKey, std::string> received_files_
+      ABSL_GUARDED_BY(mutex_);
+  std::deque<ReceivedFileKey> received_file_keys_ ABSL_GUARDED_BY(mutex_);
+  AdaptiveChunkSizer chunk_sizer_;
+
+  // Lets the callbacks that report chunks as written, which the EndpointManager
+  // may call after a payload is done with, reach this object only while it is
+  // alive.
+  struct ChunkWrittenGate {
+    Mutex mutex;
+    PayloadManager* payload_manager ABSL_GUARDED_BY(mutex) = nullptr;
+  };
+  std::shared_ptr<ChunkWrittenGate> chunk_written_gate_ =
+      std::make_shared<ChunkWrittenGate>();
 
   EndpointManager* endpoint_manager_;
 };
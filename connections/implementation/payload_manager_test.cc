@@ -14,12 +14,20 @@
 
 #include "connections/implementation/payload_manager.h"
 
+#include <random>
+#include <string>
+
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "connections/implementation/delta_basis.h"
 #include "connections/implementation/simulation_user.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
+#include "internal/platform/file.h"
+#include "internal/platform/implementation/platform.h"
 #include "internal/platform/pipe.h"
 #include "internal/platform/system_clock.h"
 
@@ -34,6 +42,7 @@ constexpr absl::string_view kDeviceB = "device-b";
 constexpr absl::string_view kMessage = "message";
 constexpr absl::Duration kProgressTimeout = absl::Milliseconds(1000);
 constexpr absl::Duration kDefaultTimeout = absl::Milliseconds(1000);
+constexpr absl::Duration kFileTimeout = absl::Seconds(5);
 
 constexpr BooleanMediumSelector kTestCases[] = {
     BooleanMediumSelector{
@@ -64,6 +73,49 @@ constexpr BooleanMediumSelector kTestCases[] = {
     },
 };
 
+std::string MakeRandom(std::size_t size) {
+  std::mt19937 generator(42);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes) byte = static_cast<char>(generator());
+  return bytes;
+}
+
+void WriteFile(const std::string& path, const std::string& contents) {
+  OutputFile file(path);
+  EXPECT_TRUE(file.Write(ByteArray(contents)).Ok());
+  EXPECT_TRUE(file.Close().Ok());
+}
+
+std::string ReadFile(const std::string& path) {
+  InputFile file(path, 0);
+  std::string contents;
+  while (true) {
+    ExceptionOr<ByteArray> data = file.Read(64 * 1024);
+    if (!data.ok() || data.result().Empty()) break;
+    contents.append(data.result().data(), data.result().size());
+  }
+  file.Close();
+  return contents;
+}
+
+// Waits for the file at |path| to hold |contents|.
+bool WaitForFile(const std::string& path, const std::string& contents,
+                 absl::Duration timeout) {
+  absl::Time deadline = SystemClock::ElapsedRealtime() + timeout;
+  while (ReadFile(path) != contents) {
+    if (SystemClock::ElapsedRealtime() > deadline) return false;
+    SystemClock::Sleep(absl::Milliseconds(10));
+  }
+  return true;
+}
+
+std::int64_t GetFileSize(const std::string& path) {
+  InputFile file(path, 0);
+  std::int64_t size = file.GetTotalSize();
+  file.Close();
+  return size;
+}
+
 class PayloadSimulationUser : public SimulationUser {
  public:
   explicit PayloadSimulationUser(
@@ -93,6 +145,10 @@ class PayloadSimulationUser : public SimulationUser {
     return client_.IsConnectedToEndpoint(discovered_.endpoint_id);
   }
 
+  PayloadScheduler::Snapshot GetPayloadSchedulerSnapshot() const {
+    return pm_.GetPayloadSchedulerSnapshot();
+  }
+
  protected:
   Payload::Id sender_payload_id_ = 0;
 };
@@ -381,6 +437,98 @@ TEST_P(PayloadManagerTest, SendPayloadWithSkip_StreamPayload) {
   env_.Stop();
 }
 
+TEST_P(PayloadManagerTest, SendsRepeatedFileAsDelta) {
+  constexpr char kFileName[] = "payload_manager_test_delta";
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_delta_transfer = true;
+  feature_flags.delta_transfer_min_bytes = 0;
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  PayloadSimulationUser user_a(kDeviceA, GetParam());
+  PayloadSimulationUser user_b(kDeviceB, GetParam());
+  ASSERT_TRUE(SetupConnection(user_a, user_b));
+  std::string source_path =
+      absl::StrCat(::testing::TempDir(), "/payload_manager_test_source");
+  std::string contents = MakeRandom(64 * 1024);
+  auto send_file = [&]() {
+    CountDownLatch latch(1);
+    user_a.ExpectPayload(latch);
+    WriteFile(source_path, contents);
+    Payload payload("", kFileName, InputFile(source_path, contents.size()));
+    Payload::Id payload_id = payload.GetId();
+    user_b.SendPayload(std::move(payload));
+    EXPECT_TRUE(latch.Await(kFileTimeout).result());
+    EXPECT_TRUE(user_a.WaitForProgress(
+        [payload_id](const PayloadProgressInfo& info) {
+          return info.payload_id == payload_id &&
+                 info.status == PayloadProgressInfo::Status::kSuccess;
+        },
+        kFileTimeout));
+    return payload_id;
+  };
+
+  // Offered as a delta, but there is nothing to sign.
+  send_file();
+  // Sent again with a few bytes changed: the receiver signs the file the first
+  // transfer wrote, and the rest is sent as references to its blocks.
+  contents.replace(contents.size() / 2, 4, "edit");
+  Payload::Id payload_id = send_file();
+
+  ASSERT_NE(user_a.GetPayload().AsFile(), nullptr);
+  EXPECT_EQ(ReadFile(user_a.GetPayload().AsFile()->GetFilePath()), contents);
+  // The file was signed in place, and moved aside once the payload started;
+  // it is deleted once the payload is done with it.
+  EXPECT_LT(GetFileSize(absl::StrCat(
+                user_a.GetPayload().AsFile()->GetFilePath(), ".", payload_id,
+                DeltaBasis::kAsideSuffix)),
+            0);
+  user_a.Stop();
+  user_b.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+  env_.Stop();
+}
+
+TEST_P(PayloadManagerTest, SchedulesFilesChunkByChunk) {
+  constexpr char kLargeFileName[] = "payload_manager_test_large";
+  constexpr char kSmallFileName[] = "payload_manager_test_small";
+  FeatureFlags::Flags feature_flags;
+  feature_flags.enable_payload_scheduler = true;
+  env_.SetFeatureFlags(feature_flags);
+  env_.Start();
+  PayloadSimulationUser user_a(kDeviceA, GetParam());
+  PayloadSimulationUser user_b(kDeviceB, GetParam());
+  ASSERT_TRUE(SetupConnection(user_a, user_b));
+  std::string large_path =
+      absl::StrCat(::testing::TempDir(), "/payload_manager_test_large");
+  std::string small_path =
+      absl::StrCat(::testing::TempDir(), "/payload_manager_test_small");
+  std::string large = MakeRandom(1024 * 1024);
+  std::string small = MakeRandom(1024);
+  WriteFile(large_path, large);
+  WriteFile(small_path, small);
+  Payload small_payload("", kSmallFileName,
+                        InputFile(small_path, small.size()));
+  small_payload.SetPriority(2);
+
+  user_b.SendPayload(
+      Payload("", kLargeFileName, InputFile(large_path, large.size())));
+  user_b.SendPayload(std::move(small_payload));
+
+  EXPECT_TRUE(WaitForFile(
+      api::ImplementationPlatform::GetDownloadPath("", kSmallFileName), small,
+      kFileTimeout));
+  EXPECT_TRUE(WaitForFile(
+      api::ImplementationPlatform::GetDownloadPath("", kLargeFileName), large,
+      kFileTimeout));
+  PayloadScheduler::Snapshot snapshot = user_b.GetPayloadSchedulerSnapshot();
+  // At least a chunk of each went through the scheduler.
+  EXPECT_GE(snapshot.chunks_scheduled, 2);
+  user_a.Stop();
+  user_b.Stop();
+  env_.SetFeatureFlags(FeatureFlags::Flags{});
+  env_.Stop();
+}
+
 INSTANTIATE_TEST_SUITE_P(ParametrisedPayloadManagerTest, PayloadManagerTest,
                          ::testing::ValuesIn(kTestCases));
 
@@ -0,0 +1,125 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_scheduler.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include "internal/platform/mutex_lock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+PayloadScheduler::PayloadScheduler(absl::Duration max_wait)
+    : max_wait_(max_wait) {}
+
+void PayloadScheduler::Add(Payload::Id id, std::int32_t priority,
+                           std::int32_t weight, absl::Time now) {
+  MutexLock lock(&mutex_);
+  Entry entry;
+  entry.priority = priority;
+  entry.weight = std::max(weight, 1);
+  entry.start_time = virtual_times_[priority];
+  entry.sequence = next_sequence_++;
+  entry.waiting_since = now;
+  entries_[id] = entry;
+}
+
+void PayloadScheduler::Remove(Payload::Id id) {
+  MutexLock lock(&mutex_);
+  entries_.erase(id);
+}
+
+bool PayloadScheduler::IsEmpty() const {
+  MutexLock lock(&mutex_);
+  return entries_.empty();
+}
+
+bool PayloadScheduler::Pick(absl::Time now, Payload::Id* id) {
+  MutexLock lock(&mutex_);
+  const std::pair<const Payload::Id, Entry>* fair = nullptr;
+  const std::pair<const Payload::Id, Entry>* starved = nullptr;
+  for (const auto& item : entries_) {
+    const Entry& entry = item.second;
+    if (now - entry.waiting_since >= max_wait_ &&
+        (starved == nullptr ||
+         entry.waiting_since < starved->second.waiting_since)) {
+      starved = &item;
+    }
+    if (fair == nullptr ||
+        std::make_tuple(-entry.priority, entry.start_time, entry.sequence) <
+            std::make_tuple(-fair->second.priority, fair->second.start_time,
+                            fair->second.sequence)) {
+      fair = &item;
+    }
+  }
+  if (fair == nullptr) return false;
+
+  const auto* picked = starved != nullptr ? starved : fair;
+  if (starved != nullptr && starved != fair) ++starvation_picks_;
+  ++chunks_scheduled_;
+  Entry& entry = entries_[picked->first];
+  entry.longest_wait = std::max(entry.longest_wait, now - entry.waiting_since);
+  longest_wait_ = std::max(longest_wait_, entry.longest_wait);
+  double& virtual_time = virtual_times_[entry.priority];
+  virtual_time = std::max(virtual_time, entry.start_time);
+  *id = picked->first;
+  return true;
+}
+
+void PayloadScheduler::OnChunkSent(Payload::Id id, std::int64_t bytes,
+                                   absl::Time now) {
+  MutexLock lock(&mutex_);
+  auto item = entries_.find(id);
+  if (item == entries_.end()) return;
+
+  Entry& entry = item->second;
+  // Even an empty chunk takes a turn.
+  entry.start_time +=
+      static_cast<double>(std::max<std::int64_t>(bytes, 1)) / entry.weight;
+  entry.bytes_sent += bytes;
+  ++entry.chunks_sent;
+  entry.waiting_since = now;
+}
+
+PayloadScheduler::Snapshot PayloadScheduler::GetSnapshot(absl::Time now) const {
+  MutexLock lock(&mutex_);
+  Snapshot snapshot;
+  for (const auto& item : entries_) {
+    const Entry& entry = item.second;
+    PayloadState state;
+    state.id = item.first;
+    state.priority = entry.priority;
+    state.weight = entry.weight;
+    state.bytes_sent = entry.bytes_sent;
+    state.chunks_sent = entry.chunks_sent;
+    state.waiting = now - entry.waiting_since;
+    state.longest_wait = entry.longest_wait;
+    snapshot.payloads.push_back(state);
+  }
+  std::sort(snapshot.payloads.begin(), snapshot.payloads.end(),
+            [](const PayloadState& a, const PayloadState& b) {
+              return a.priority > b.priority;
+            });
+  snapshot.chunks_scheduled = chunks_scheduled_;
+  snapshot.starvation_picks = starvation_picks_;
+  snapshot.longest_wait = longest_wait_;
+  return snapshot;
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
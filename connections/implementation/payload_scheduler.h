@@ -0,0 +1,117 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PAYLOAD_SCHEDULER_H_
+#define CORE_INTERNAL_PAYLOAD_SCHEDULER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/payload.h"
+#include "internal/platform/mutex.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Picks which of the outgoing payloads being sent gets to send its next
+// chunk.
+//
+// Payloads of a higher priority go first. Payloads of the same priority share
+// the link in proportion to their weight, by start-time fair queueing: each
+// payload carries a virtual start time, which advances by the bytes of each
+// chunk it sends over its weight, and the one with the earliest start time
+// goes next. A payload that is added starts at the virtual time of its
+// priority, so a small payload added while a large one is being sent goes
+// next, rather than after it.
+//
+// A payload that has not sent a chunk for |max_wait|, whatever its priority,
+// goes next; the one that has waited the longest first.
+//
+// Only keeps the books: the caller sends the chunks. Thread safe.
+class PayloadScheduler {
+ public:
+  struct PayloadState {
+    Payload::Id id = 0;
+    std::int32_t priority = 0;
+    std::int32_t weight = 1;
+    std::int64_t bytes_sent = 0;
+    std::int64_t chunks_sent = 0;
+    // Since the payload was added, or sent its last chunk.
+    absl::Duration waiting = absl::ZeroDuration();
+    // The longest the payload has waited for its turn.
+    absl::Duration longest_wait = absl::ZeroDuration();
+  };
+
+  struct Snapshot {
+    // The payloads being scheduled, highest priority first.
+    std::vector<PayloadState> payloads;
+    std::int64_t chunks_scheduled = 0;
+    // How many of them went to a payload that had waited for |max_wait|.
+    std::int64_t starvation_picks = 0;
+    // The longest a payload has waited for its turn.
+    absl::Duration longest_wait = absl::ZeroDuration();
+  };
+
+  explicit PayloadScheduler(absl::Duration max_wait);
+
+  // Starts scheduling |id|. A |weight| below 1 counts as 1.
+  void Add(Payload::Id id, std::int32_t priority, std::int32_t weight,
+           absl::Time now) ABSL_LOCKS_EXCLUDED(mutex_);
+  void Remove(Payload::Id id) ABSL_LOCKS_EXCLUDED(mutex_);
+  bool IsEmpty() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the payload to send the next chunk of. Returns false if there is
+  // none.
+  bool Pick(absl::Time now, Payload::Id* id) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Records that the payload that was picked sent a chunk of |bytes|.
+  void OnChunkSent(Payload::Id id, std::int64_t bytes, absl::Time now)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  Snapshot GetSnapshot(absl::Time now) const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    std::int32_t priority = 0;
+    std::int32_t weight = 1;
+    double start_time = 0;
+    // Breaks ties between payloads with the same start time: the one added
+    // first goes first.
+    std::int64_t sequence = 0;
+    std::int64_t bytes_sent = 0;
+    std::int64_t chunks_sent = 0;
+    absl::Time waiting_since;
+    absl::Duration longest_wait = absl::ZeroDuration();
+  };
+
+  const absl::Duration max_wait_;
+  mutable Mutex mutex_;
+  absl::flat_hash_map<Payload::Id, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // Priority -> start time of the payload of that priority picked last.
+  absl::flat_hash_map<std::int32_t, double> virtual_times_
+      ABSL_GUARDED_BY(mutex_);
+  std::int64_t next_sequence_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::int64_t chunks_scheduled_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::int64_t starvation_picks_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Duration longest_wait_ ABSL_GUARDED_BY(mutex_) = absl::ZeroDuration();
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_PAYLOAD_SCHEDULER_H_
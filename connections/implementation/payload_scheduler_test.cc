@@ -0,0 +1,138 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_scheduler.h"
+
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr std::int64_t kChunkSize = 64 * 1024;
+constexpr absl::Duration kChunkDuration = absl::Milliseconds(10);
+
+class PayloadSchedulerTest : public ::testing::Test {
+ protected:
+  // Sends |count| chunks, picking the payload for each with the scheduler.
+  // Returns how many chunks each payload sent.
+  absl::flat_hash_map<Payload::Id, int> SendChunks(int count) {
+    absl::flat_hash_map<Payload::Id, int> chunks;
+    for (int i = 0; i < count; ++i) {
+      Payload::Id id;
+      if (!scheduler_.Pick(now_, &id)) break;
+      now_ += kChunkDuration;
+      scheduler_.OnChunkSent(id, kChunkSize, now_);
+      ++chunks[id];
+    }
+    return chunks;
+  }
+
+  absl::Time now_ = absl::UnixEpoch();
+  PayloadScheduler scheduler_{absl::Seconds(1)};
+};
+
+TEST_F(PayloadSchedulerTest, PicksNothingWhenEmpty) {
+  Payload::Id id;
+
+  EXPECT_TRUE(scheduler_.IsEmpty());
+  EXPECT_FALSE(scheduler_.Pick(now_, &id));
+}
+
+TEST_F(PayloadSchedulerTest, InterleavesPayloadsOfSamePriority) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/1, now_);
+  scheduler_.Add(2, /*priority=*/0, /*weight=*/1, now_);
+
+  auto chunks = SendChunks(100);
+
+  EXPECT_EQ(chunks[1], 50);
+  EXPECT_EQ(chunks[2], 50);
+}
+
+TEST_F(PayloadSchedulerTest, SharesInProportionToWeight) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/3, now_);
+  scheduler_.Add(2, /*priority=*/0, /*weight=*/1, now_);
+
+  auto chunks = SendChunks(100);
+
+  EXPECT_EQ(chunks[1], 75);
+  EXPECT_EQ(chunks[2], 25);
+}
+
+TEST_F(PayloadSchedulerTest, NewPayloadGoesNext) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/1, now_);
+  SendChunks(1000);
+  scheduler_.Add(2, /*priority=*/0, /*weight=*/1, now_);
+
+  Payload::Id id;
+  ASSERT_TRUE(scheduler_.Pick(now_, &id));
+
+  EXPECT_EQ(id, 2);
+}
+
+TEST_F(PayloadSchedulerTest, HigherPriorityGoesFirst) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/1, now_);
+  scheduler_.Add(2, /*priority=*/1, /*weight=*/1, now_);
+
+  // 50 chunks take less than max_wait.
+  auto chunks = SendChunks(50);
+
+  EXPECT_EQ(chunks[1], 0);
+  EXPECT_EQ(chunks[2], 50);
+}
+
+TEST_F(PayloadSchedulerTest, StarvedPayloadGetsATurn) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/1, now_);
+  scheduler_.Add(2, /*priority=*/1, /*weight=*/1, now_);
+
+  // One chunk out of every 101: a second's worth of the other's chunks.
+  auto chunks = SendChunks(303);
+
+  EXPECT_EQ(chunks[1], 3);
+  EXPECT_EQ(chunks[2], 300);
+  PayloadScheduler::Snapshot snapshot = scheduler_.GetSnapshot(now_);
+  EXPECT_EQ(snapshot.starvation_picks, 3);
+  EXPECT_EQ(snapshot.longest_wait, absl::Seconds(1));
+  ASSERT_EQ(snapshot.payloads.size(), 2u);
+  EXPECT_EQ(snapshot.payloads[1].id, 1);
+  EXPECT_EQ(snapshot.payloads[1].longest_wait, absl::Seconds(1));
+  EXPECT_EQ(snapshot.payloads[0].longest_wait, kChunkDuration);
+}
+
+TEST_F(PayloadSchedulerTest, ReportsPayloadState) {
+  scheduler_.Add(1, /*priority=*/0, /*weight=*/1, now_);
+  scheduler_.Add(2, /*priority=*/1, /*weight=*/2, now_);
+  SendChunks(2);
+  scheduler_.Remove(1);
+
+  PayloadScheduler::Snapshot snapshot = scheduler_.GetSnapshot(now_);
+
+  EXPECT_EQ(snapshot.chunks_scheduled, 2);
+  ASSERT_EQ(snapshot.payloads.size(), 1u);
+  EXPECT_EQ(snapshot.payloads[0].id, 2);
+  EXPECT_EQ(snapshot.payloads[0].priority, 1);
+  EXPECT_EQ(snapshot.payloads[0].weight, 2);
+  EXPECT_EQ(snapshot.payloads[0].bytes_sent, 2 * kChunkSize);
+  EXPECT_EQ(snapshot.payloads[0].chunks_sent, 2);
+  EXPECT_EQ(snapshot.payloads[0].waiting, absl::ZeroDuration());
+  EXPECT_EQ(snapshot.payloads[0].longest_wait, absl::ZeroDuration());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,111 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/rcu_pointer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+namespace {
+
+// The read state of one thread. Readers are never freed; a thread that exits
+// leaves its reader to the next thread that needs one.
+struct alignas(64) Reader {
+  // The epoch in which the outermost open section started, or 0 if no
+  // section is open. Written by the owning thread only.
+  std::atomic<std::uint64_t> epoch{0};
+  std::atomic<bool> in_use{false};
+  // Open sections; only touched by the owning thread.
+  int depth = 0;
+  Reader* next = nullptr;
+};
+
+std::atomic<Reader*> readers{nullptr};
+std::atomic<std::uint64_t> current_epoch{1};
+
+Reader* AcquireReader() {
+  for (Reader* reader = readers.load(std::memory_order_acquire);
+       reader != nullptr; reader = reader->next) {
+    bool in_use = false;
+    if (!reader->in_use.load(std::memory_order_relaxed) &&
+        reader->in_use.compare_exchange_strong(in_use, true)) {
+      return reader;
+    }
+  }
+  Reader* reader = new Reader();
+  reader->in_use.store(true, std::memory_order_relaxed);
+  reader->next = readers.load(std::memory_order_relaxed);
+  while (!readers.compare_exchange_weak(reader->next, reader,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+  return reader;
+}
+
+class ThreadReader {
+ public:
+  ThreadReader() : reader_(AcquireReader()) {}
+  ~ThreadReader() { reader_->in_use.store(false, std::memory_order_release); }
+
+  Reader& Get() { return *reader_; }
+
+ private:
+  Reader* const reader_;
+};
+
+Reader& GetThreadReader() {
+  static thread_local ThreadReader reader;
+  return reader.Get();
+}
+
+}  // namespace
+
+RcuReadSection::RcuReadSection() {
+  Reader& reader = GetThreadReader();
+  if (reader.depth++ > 0) return;
+  // Sequentially consistent, so that a writer that misses this store has
+  // published its new value before the section reads it.
+  reader.epoch.store(current_epoch.load(std::memory_order_seq_cst),
+                     std::memory_order_seq_cst);
+}
+
+RcuReadSection::~RcuReadSection() {
+  Reader& reader = GetThreadReader();
+  if (--reader.depth > 0) return;
+  reader.epoch.store(0, std::memory_order_release);
+}
+
+void RcuSynchronize() {
+  // Sections that start from now on see the epoch after |epoch|, along with
+  // whatever the caller published before.
+  std::uint64_t epoch = current_epoch.fetch_add(1, std::memory_order_seq_cst);
+  for (Reader* reader = readers.load(std::memory_order_acquire);
+       reader != nullptr; reader = reader->next) {
+    while (true) {
+      std::uint64_t reader_epoch =
+          reader->epoch.load(std::memory_order_seq_cst);
+      if (reader_epoch == 0 || reader_epoch > epoch) break;
+      std::this_thread::yield();
+    }
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
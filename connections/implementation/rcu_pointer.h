@@ -0,0 +1,100 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_RCU_POINTER_H_
+#define CORE_INTERNAL_RCU_POINTER_H_
+
+#include <atomic>
+#include <memory>
+
+namespace location {
+namespace nearby {
+namespace connections {
+
+// Marks the calling thread as reading values published through RcuPointer,
+// until it goes out of scope. While a section is open, the values it read
+// stay alive. Sections may nest.
+//
+// Opening and closing a section only touch memory private to the thread: no
+// lock is taken, and no reference count shared with other readers is changed.
+// Sections are meant to be short; do not block in one.
+class RcuReadSection {
+ public:
+  RcuReadSection();
+  ~RcuReadSection();
+  RcuReadSection(const RcuReadSection&) = delete;
+  RcuReadSection& operator=(const RcuReadSection&) = delete;
+};
+
+// Blocks until every RcuReadSection that was open on any thread when it was
+// called has been closed. Must not be called from within a section.
+void RcuSynchronize();
+
+// Holds an immutable value that is read without locks and replaced as a
+// whole (read-copy-update).
+//
+// Readers pin the current value with Read(). Update() publishes a new value
+// and then waits for the readers that may still see the old one, before
+// deleting it; writers are expected to be rare, and to be serialized by the
+// caller.
+template <typename T>
+class RcuPointer {
+ public:
+  // The value current when Read() was called, kept alive for as long as this
+  // lives.
+  class Reader {
+   public:
+    explicit Reader(const RcuPointer& pointer)
+        : value_(pointer.value_.load(std::memory_order_seq_cst)) {}
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    const T* get() const { return value_; }
+    const T& operator*() const { return *value_; }
+    const T* operator->() const { return value_; }
+
+   private:
+    // Opened before |value_| is read.
+    RcuReadSection section_;
+    const T* value_;
+  };
+
+  explicit RcuPointer(std::unique_ptr<const T> value = nullptr)
+      : value_(value.release()) {}
+  // No reader may be left.
+  ~RcuPointer() { delete value_.load(); }
+  RcuPointer(const RcuPointer&) = delete;
+  RcuPointer& operator=(const RcuPointer&) = delete;
+
+  Reader Read() const { return Reader(*this); }
+
+  // Publishes |value|, and deletes the previous one once no reader can see
+  // it anymore.
+  void Update(std::unique_ptr<const T> value) {
+    const T* old_value =
+        value_.exchange(value.release(), std::memory_order_seq_cst);
+    if (old_value == nullptr) return;
+    RcuSynchronize();
+    delete old_value;
+  }
+
+ private:
+  std::atomic<const T*> value_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+#endif  // CORE_INTERNAL_RCU_POINTER_H_
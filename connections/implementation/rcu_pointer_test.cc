@@ -0,0 +1,150 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/rcu_pointer.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/system_clock.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+// Counts its instances, and poisons itself when destroyed.
+struct Value {
+  explicit Value(int value) : value(value) { ++instances; }
+  ~Value() {
+    value = -1;
+    --instances;
+  }
+
+  int value;
+  static std::atomic_int instances;
+};
+
+std::atomic_int Value::instances = 0;
+
+TEST(RcuPointerTest, ReadsPublishedValue) {
+  RcuPointer<Value> pointer;
+  EXPECT_EQ(pointer.Read().get(), nullptr);
+
+  pointer.Update(std::make_unique<Value>(1));
+  EXPECT_EQ(pointer.Read()->value, 1);
+  pointer.Update(std::make_unique<Value>(2));
+  EXPECT_EQ(pointer.Read()->value, 2);
+}
+
+TEST(RcuPointerTest, DeletesReplacedValues) {
+  {
+    RcuPointer<Value> pointer(std::make_unique<Value>(1));
+    pointer.Update(std::make_unique<Value>(2));
+    EXPECT_EQ(Value::instances, 1);
+  }
+  EXPECT_EQ(Value::instances, 0);
+}
+
+TEST(RcuPointerTest, NestedReadsKeepValueAlive) {
+  RcuPointer<Value> pointer(std::make_unique<Value>(1));
+  SingleThreadExecutor writer;
+  CountDownLatch updated(1);
+  {
+    auto outer = pointer.Read();
+    {
+      auto inner = pointer.Read();
+      EXPECT_EQ(inner->value, 1);
+    }
+    writer.Execute([&pointer, &updated]() {
+      pointer.Update(std::make_unique<Value>(2));
+      updated.CountDown();
+    });
+    // Closing the inner section must not let the writer through.
+    EXPECT_FALSE(updated.Await(absl::Milliseconds(100)).result());
+    EXPECT_EQ(outer->value, 1);
+  }
+  EXPECT_TRUE(updated.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(pointer.Read()->value, 2);
+}
+
+TEST(RcuPointerTest, UpdateWaitsForReadersOnOtherThreads) {
+  RcuPointer<Value> pointer(std::make_unique<Value>(1));
+  SingleThreadExecutor reader;
+  CountDownLatch reading(1);
+  CountDownLatch release(1);
+  std::atomic_int value_read = 0;
+  reader.Execute([&]() {
+    auto value = pointer.Read();
+    reading.CountDown();
+    release.Await();
+    value_read = value->value;
+  });
+  EXPECT_TRUE(reading.Await(absl::Seconds(1)).result());
+
+  SingleThreadExecutor writer;
+  CountDownLatch updated(1);
+  writer.Execute([&pointer, &updated]() {
+    pointer.Update(std::make_unique<Value>(2));
+    updated.CountDown();
+  });
+  EXPECT_FALSE(updated.Await(absl::Milliseconds(100)).result());
+  // New readers already see the new value.
+  EXPECT_EQ(pointer.Read()->value, 2);
+
+  release.CountDown();
+  EXPECT_TRUE(updated.Await(absl::Seconds(1)).result());
+  EXPECT_EQ(value_read, 1);
+}
+
+TEST(RcuPointerTest, ReadersNeverSeeDeletedValues) {
+  constexpr int kReaders = 3;
+  constexpr int kUpdates = 2000;
+  RcuPointer<Value> pointer(std::make_unique<Value>(0));
+  std::atomic_bool done = false;
+  std::atomic_int bad_reads = 0;
+  MultiThreadExecutor readers(kReaders);
+  CountDownLatch readers_done(kReaders);
+  for (int i = 0; i < kReaders; ++i) {
+    readers.Execute([&]() {
+      int last = 0;
+      while (!done) {
+        auto value = pointer.Read();
+        // Values only go up, and are never poisoned while read.
+        if (value->value < last) ++bad_reads;
+        last = value->value;
+      }
+      readers_done.CountDown();
+    });
+  }
+
+  for (int i = 1; i <= kUpdates; ++i) {
+    pointer.Update(std::make_unique<Value>(i));
+  }
+  done = true;
+  EXPECT_TRUE(readers_done.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(bad_reads, 0);
+  EXPECT_EQ(pointer.Read()->value, kUpdates);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
@@ -131,6 +131,14 @@ void Payload::SetOffset(size_t offset) {
 
 size_t Payload::GetOffset() { return offset_; }
 
+void Payload::SetPriority(std::int32_t priority) { priority_ = priority; }
+
+std::int32_t Payload::GetPriority() const { return priority_; }
+
+void Payload::SetWeight(std::int32_t weight) { weight_ = weight; }
+
+std::int32_t Payload::GetWeight() const { return weight_; }
+
 // Generate Payload Id; to be passed to outgoing file constructor.
 Payload::Id Payload::GenerateId() { return Prng().NextInt64(); }
 
@@ -101,6 +101,16 @@ class Payload {
 
   size_t GetOffset();
 
+  // Set how an outgoing FILE payload shares the connection with the other
+  // files being sent, when they are scheduled chunk by chunk (see
+  // FeatureFlags::enable_payload_scheduler): payloads of a higher priority
+  // are sent first, and payloads of the same priority get shares in
+  // proportion to their weight. Both default to 1.
+  void SetPriority(std::int32_t priority);
+  std::int32_t GetPriority() const;
+  void SetWeight(std::int32_t weight);
+  std::int32_t GetWeight() const;
+
   // Generate Payload Id; to be passed to outgoing file constructor.
   static Id GenerateId();
 
@@ -112,6 +122,8 @@ class Payload {
 
   Id id_{GenerateId()};
   size_t offset_{0};
+  std::int32_t priority_{1};
+  std::int32_t weight_{1};
 
   std::string parent_folder_;
   std::string file_name_;
@@ -0,0 +1,301 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Streams a payload between two processes over WifiLan, using the
+// standalone Linux platform, and reports the throughput seen by each side.
+//
+// Start the receiving side first:
+//   wifi_lan_throughput advertise
+// and then the sending side, optionally with the payload size in megabytes:
+//   wifi_lan_throughput discover 64
+//
+// Both processes have to use the same $NEARBY_WIFI_LAN_REGISTRY_DIR; to run
+// them on different hosts, point it at a shared directory and set
+// $NEARBY_WIFI_LAN_ADDRESS to the address of each host.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "connections/advertising_options.h"
+#include "connections/connection_options.h"
+#include "connections/core.h"
+#include "connections/discovery_options.h"
+#include "connections/implementation/service_controller_router.h"
+#include "connections/listeners.h"
+#include "connections/medium_selector.h"
+#include "connections/params.h"
+#include "connections/payload.h"
+#include "connections/payload_type.h"
+#include "connections/strategy.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+
+namespace location {
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr char kServiceId[] = "com.google.nearby.samples.wifi_lan_throughput";
+constexpr int kDefaultPayloadMegabytes = 16;
+constexpr absl::Duration kTimeout = absl::Minutes(5);
+
+BooleanMediumSelector WifiLanOnly() {
+  BooleanMediumSelector allowed;
+  allowed.SetAll(false);
+  allowed.wifi_lan = true;
+  return allowed;
+}
+
+void ReportThroughput(absl::string_view direction, std::int64_t bytes,
+                      absl::Duration elapsed) {
+  double seconds = absl::ToDoubleSeconds(elapsed);
+  printf("%.*s %lld bytes in %.3f s: %.1f MB/s\n",
+         static_cast<int>(direction.size()), direction.data(),
+         static_cast<long long>(bytes), seconds,
+         seconds > 0 ? bytes / seconds / 1e6 : 0.0);
+}
+
+// Disconnects from everyone, and waits until Core is done with the payloads,
+// which are torn down along with their endpoints.
+void Disconnect(Core& core) {
+  CountDownLatch stopped(1);
+  core.StopAllEndpoints(
+      {.result_cb = [&stopped](Status status) { stopped.CountDown(); }});
+  stopped.Await(kTimeout);
+}
+
+// Produces |size| bytes of filler without holding them in memory.
+class FillerInputStream : public InputStream {
+ public:
+  explicit FillerInputStream(std::int64_t size) : remaining_(size) {}
+
+  ExceptionOr<ByteArray> Read(std::int64_t size) override {
+    size = std::min(size, remaining_);
+    remaining_ -= size;
+    // An empty read marks the end of the stream.
+    return ExceptionOr<ByteArray>(
+        ByteArray(std::string(static_cast<size_t>(size), 'x')));
+  }
+  Exception Close() override { return {Exception::kSuccess}; }
+
+ private:
+  std::int64_t remaining_;
+};
+
+// Tracks a single payload from its first progress update to its last.
+class TransferMonitor {
+ public:
+  explicit TransferMonitor(absl::string_view direction)
+      : direction_(direction) {}
+
+  ~TransferMonitor() {
+    if (reader_.joinable()) reader_.join();
+  }
+
+  PayloadListener GetListener() {
+    return {
+        .payload_cb =
+            [this](const std::string& endpoint_id, Payload payload) {
+              OnPayload(std::move(payload));
+            },
+        .payload_progress_cb =
+            [this](const std::string& endpoint_id,
+                   const PayloadProgressInfo& info) { OnProgress(info); },
+    };
+  }
+
+  // Returns true if the transfer succeeded.
+  bool Await() { return done_.Await(kTimeout).result() && succeeded_; }
+
+ private:
+  // Drains an incoming stream, so that it does not pile up in memory.
+  void OnPayload(Payload payload) {
+    if (payload.GetType() != PayloadType::kStream || reader_.joinable()) return;
+    // Core keeps writing to the stream until it is done with the payload, so
+    // it has to stay around for as long as Core does.
+    payload_ = std::move(payload);
+    reader_ = std::thread([this]() {
+      while (true) {
+        ExceptionOr<ByteArray> data = payload_.AsStream()->Read(64 * 1024);
+        if (!data.ok() || data.result().Empty()) break;
+      }
+    });
+  }
+
+  void OnProgress(const PayloadProgressInfo& info) {
+    if (start_ == absl::InfinitePast()) start_ = absl::Now();
+    // Tearing the connection down fails payloads, including finished ones.
+    if (info.status == PayloadProgressInfo::Status::kInProgress || finished_) {
+      return;
+    }
+    finished_ = true;
+    succeeded_ = info.status == PayloadProgressInfo::Status::kSuccess;
+    if (succeeded_) {
+      ReportThroughput(direction_, info.bytes_transferred,
+                       absl::Now() - start_);
+    }
+    done_.CountDown();
+  }
+
+  const std::string direction_;
+  absl::Time start_ = absl::InfinitePast();
+  bool finished_ = false;
+  bool succeeded_ = false;
+  CountDownLatch done_{1};
+  Payload payload_;
+  std::thread reader_;
+};
+
+int Advertise(Core& core, TransferMonitor& monitor) {
+  AdvertisingOptions options;
+  options.strategy = Strategy::kP2pPointToPoint;
+  options.allowed = WifiLanOnly();
+  options.auto_upgrade_bandwidth = false;
+  ConnectionRequestInfo info{
+      .endpoint_info = ByteArray("advertiser"),
+      .listener =
+          {
+              .initiated_cb =
+                  [&core, &monitor](const std::string& endpoint_id,
+                                    const ConnectionResponseInfo&) {
+                    core.AcceptConnection(endpoint_id, monitor.GetListener(),
+                                          {});
+                  },
+          },
+  };
+  core.StartAdvertising(kServiceId, options, std::move(info),
+                        {.result_cb = [](Status status) {
+                          if (!status.Ok()) {
+                            printf("advertising failed: %s\n",
+                                   status.ToString().c_str());
+                            exit(EXIT_FAILURE);
+                          }
+                          printf("advertising\n");
+                        }});
+  bool succeeded = monitor.Await();
+  Disconnect(core);
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int Discover(Core& core, TransferMonitor& monitor, int megabytes) {
+  CountDownLatch accepted(1);
+  CountDownLatch disconnected(1);
+  std::string remote_endpoint_id;
+  ConnectionRequestInfo info{
+      .endpoint_info = ByteArray("discoverer"),
+      .listener =
+          {
+              .initiated_cb =
+                  [&core, &monitor](const std::string& endpoint_id,
+                                    const ConnectionResponseInfo&) {
+                    core.AcceptConnection(endpoint_id, monitor.GetListener(),
+                                          {});
+                  },
+              .accepted_cb =
+                  [&accepted, &remote_endpoint_id](
+                      const std::string& endpoint_id) {
+                    remote_endpoint_id = endpoint_id;
+                    accepted.CountDown();
+                  },
+              .disconnected_cb =
+                  [&disconnected](const std::string& endpoint_id) {
+                    disconnected.CountDown();
+                  },
+          },
+  };
+  ConnectionOptions connection_options;
+  connection_options.strategy = Strategy::kP2pPointToPoint;
+  connection_options.allowed = WifiLanOnly();
+  connection_options.auto_upgrade_bandwidth = false;
+  CountDownLatch found(1);
+  DiscoveryOptions options;
+  options.strategy = Strategy::kP2pPointToPoint;
+  options.allowed = WifiLanOnly();
+  options.auto_upgrade_bandwidth = false;
+  core.StartDiscovery(
+      kServiceId, options,
+      {
+          .endpoint_found_cb =
+              [&core, &info, &connection_options, &found](
+                  const std::string& endpoint_id, const ByteArray&,
+                  const std::string&) {
+                // Only the first advertiser found is connected to.
+                if (found.Await(absl::ZeroDuration()).result()) return;
+                found.CountDown();
+                core.RequestConnection(endpoint_id, info, connection_options,
+                                       {});
+              },
+      },
+      {});
+  if (!accepted.Await(kTimeout).result()) {
+    printf("no connection to an advertiser\n");
+    return EXIT_FAILURE;
+  }
+  core.StopDiscovery({});
+
+  // The stream is closed by Core once done with it, which may be after the
+  // transfer has been reported; the payload keeps it alive until then.
+  auto stream =
+      std::make_shared<FillerInputStream>(std::int64_t{megabytes} << 20);
+  core.SendPayload({remote_endpoint_id},
+                   Payload([stream]() -> InputStream& { return *stream; }),
+                   {});
+  bool succeeded = monitor.Await();
+  // Having sent the last chunk does not mean it has arrived; the receiving
+  // side hangs up once it has everything.
+  if (succeeded) disconnected.Await(kTimeout);
+  Disconnect(core);
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
+}  // namespace location
+
+int main(int argc, char** argv) {
+  using ::location::nearby::connections::Core;
+  using ::location::nearby::connections::ServiceControllerRouter;
+  using ::location::nearby::connections::TransferMonitor;
+
+  std::string mode = argc > 1 ? argv[1] : "";
+  int megabytes = location::nearby::connections::kDefaultPayloadMegabytes;
+  bool valid_size =
+      argc <= 2 || (absl::SimpleAtoi(argv[2], &megabytes) && megabytes > 0);
+  if ((mode != "advertise" && mode != "discover") || !valid_size) {
+    fprintf(stderr, "usage: %s advertise | discover [megabytes]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Outlives |core|, which may still be closing the payload's stream while
+  // it goes down.
+  TransferMonitor monitor(mode == "advertise" ? "received" : "sent");
+  ServiceControllerRouter router;
+  Core core(&router);
+  return mode == "advertise"
+             ? location::nearby::connections::Advertise(core, monitor)
+             : location::nearby::connections::Discover(core, monitor,
+                                                       megabytes);
+}
@@ -133,8 +133,34 @@ bool Aead::Open(absl::string_view ciphertext, absl::string_view nonce,
   return true;
 }
 
+absl::optional<size_t> Aead::Seal(absl::Span<const uint8_t> plaintext,
+                                  absl::Span<const uint8_t> nonce,
+                                  absl::Span<const uint8_t> additional_data,
+                                  absl::Span<uint8_t> out) const {
+  size_t output_length;
+  if (!Seal(plaintext, nonce, additional_data, out.data(), &output_length,
+            out.size())) {
+    return absl::nullopt;
+  }
+  return output_length;
+}
+
+absl::optional<size_t> Aead::Open(absl::Span<const uint8_t> ciphertext,
+                                  absl::Span<const uint8_t> nonce,
+                                  absl::Span<const uint8_t> additional_data,
+                                  absl::Span<uint8_t> out) const {
+  size_t output_length;
+  if (!Open(ciphertext, nonce, additional_data, out.data(), &output_length,
+            out.size())) {
+    return absl::nullopt;
+  }
+  return output_length;
+}
+
 size_t Aead::KeyLength() const { return EVP_AEAD_key_length(aead_); }
 
+size_t Aead::MaxOverhead() const { return EVP_AEAD_max_overhead(aead_); }
+
 size_t Aead::NonceLength() const { return EVP_AEAD_nonce_length(aead_); }
 
 bool Aead::Seal(absl::Span<const uint8_t> plaintext,
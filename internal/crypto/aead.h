@@ -71,8 +71,27 @@ class CRYPTO_EXPORT Aead {
   bool Open(absl::string_view ciphertext, absl::string_view nonce,
             absl::string_view additional_data, std::string* plaintext) const;
 
+  // Seals |plaintext| into |out|, which must be at least |plaintext.size()| +
+  // MaxOverhead() bytes long, and returns the length of the ciphertext.
+  // |out| may start at the same address as |plaintext|, to seal in place.
+  absl::optional<size_t> Seal(absl::Span<const uint8_t> plaintext,
+                              absl::Span<const uint8_t> nonce,
+                              absl::Span<const uint8_t> additional_data,
+                              absl::Span<uint8_t> out) const;
+
+  // Opens |ciphertext| into |out|, which must be at least |ciphertext.size()|
+  // bytes long, and returns the length of the plaintext. |out| may start at
+  // the same address as |ciphertext|, to open in place.
+  absl::optional<size_t> Open(absl::Span<const uint8_t> ciphertext,
+                              absl::Span<const uint8_t> nonce,
+                              absl::Span<const uint8_t> additional_data,
+                              absl::Span<uint8_t> out) const;
+
   size_t KeyLength() const;
 
+  // Returns the number of bytes sealing adds to the plaintext at most.
+  size_t MaxOverhead() const;
+
   size_t NonceLength() const;
 
  private:
@@ -76,6 +76,38 @@ TEST_P(AeadTest, SealOpenSpan) {
   EXPECT_FALSE(decrypted);
 }
 
+TEST_P(AeadTest, SealOpenInPlace) {
+  crypto::Aead::AeadAlgorithm alg = GetParam();
+  crypto::Aead aead(alg);
+  std::vector<uint8_t> key(aead.KeyLength(), 0u);
+  aead.Init(key);
+  std::vector<uint8_t> nonce(aead.NonceLength(), 0u);
+  static constexpr uint8_t kPlaintext[] = "plaintext";
+  static constexpr uint8_t kAdditionalData[] = "additional data input";
+  std::vector<uint8_t> buffer(kPlaintext, kPlaintext + sizeof(kPlaintext));
+  buffer.resize(sizeof(kPlaintext) + aead.MaxOverhead());
+
+  absl::optional<size_t> sealed = aead.Seal(
+      absl::MakeConstSpan(buffer.data(), sizeof(kPlaintext)), nonce,
+      kAdditionalData, absl::MakeSpan(buffer));
+  ASSERT_TRUE(sealed);
+  EXPECT_LT(sizeof(kPlaintext), *sealed);
+  EXPECT_EQ(aead.Seal(kPlaintext, nonce, kAdditionalData),
+            std::vector<uint8_t>(buffer.begin(), buffer.begin() + *sealed));
+
+  absl::optional<size_t> opened =
+      aead.Open(absl::MakeConstSpan(buffer.data(), *sealed), nonce,
+                kAdditionalData, absl::MakeSpan(buffer));
+  ASSERT_TRUE(opened);
+  ASSERT_EQ(*opened, sizeof(kPlaintext));
+  EXPECT_EQ(0, memcmp(buffer.data(), kPlaintext, sizeof(kPlaintext)));
+
+  // Too small an output buffer.
+  std::vector<uint8_t> out(sizeof(kPlaintext));
+  EXPECT_FALSE(aead.Seal(kPlaintext, nonce, kAdditionalData,
+                         absl::MakeSpan(out)));
+}
+
 TEST_P(AeadTest, SealOpenWrongKey) {
   crypto::Aead::AeadAlgorithm alg = GetParam();
   crypto::Aead aead(alg);
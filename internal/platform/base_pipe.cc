@@ -14,6 +14,10 @@
 
 #include "internal/platform/base_pipe.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "internal/platform/base_mutex_lock.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/output_stream.h"
@@ -21,6 +25,38 @@
 namespace location {
 namespace nearby {
 
+namespace {
+// Slots an unbounded pipe starts out with.
+constexpr size_t kInitialRingSlots = 16;
+}  // namespace
+
+void BasePipe::ChunkRing::PushBack(ByteArray chunk) {
+  if (size_ == slots_.size()) {
+    Reserve(std::max(kInitialRingSlots, slots_.size() * 2));
+  }
+  slots_[(head_ + size_) % slots_.size()] = std::move(chunk);
+  ++size_;
+}
+
+ByteArray BasePipe::ChunkRing::PopFront() {
+  ByteArray chunk = std::move(slots_[head_]);
+  // Do not hold on to the storage of a chunk that has been read.
+  slots_[head_] = ByteArray();
+  head_ = (head_ + 1) % slots_.size();
+  --size_;
+  return chunk;
+}
+
+void BasePipe::ChunkRing::Reserve(size_t capacity) {
+  if (capacity <= slots_.size()) return;
+  std::vector<ByteArray> slots(capacity);
+  for (size_t i = 0; i < size_; ++i) {
+    slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+  }
+  slots_.swap(slots);
+  head_ = 0;
+}
+
 ExceptionOr<ByteArray> BasePipe::Read(size_t size) {
   BaseMutexLock lock(mutex_.get());
 
@@ -31,7 +67,7 @@ ExceptionOr<ByteArray> BasePipe::Read(size_t size) {
     return ExceptionOr<ByteArray>{ByteArray{}};
   }
 
-  while (buffer_.empty() && !input_stream_closed_) {
+  while (buffer_.Empty() && !input_stream_closed_) {
     Exception wait_exception = cond_->Wait();
 
     if (wait_exception.Raised()) {
@@ -43,46 +79,97 @@ ExceptionOr<ByteArray> BasePipe::Read(size_t size) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
 
-  ByteArray first_chunk{buffer_.front()};
-  buffer_.pop_front();
+  ByteArray& first_chunk = buffer_.Front();
 
   // If we received our sentinel chunk, mark the fact that there cannot
   // possibly be any more chunks to read here on in, and return an empty chunk
   // to serve as an EOF indication to callers.
   if (first_chunk.Empty()) {
+    buffer_.PopFront();
     read_all_chunks_ = true;
     return ExceptionOr<ByteArray>{ByteArray{}};
   }
 
+  ByteArray next_chunk;
   // If first_chunk is small enough to not overshoot the requested 'size', just
   // return that.
   if (first_chunk.size() <= size) {
-    return ExceptionOr<ByteArray>{first_chunk};
+    next_chunk = buffer_.PopFront();
   } else {
     // Break first_chunk into 2 parts -- the first one of which (next_chunk)
     // will be 'size' bytes long, and will be returned, and the second one of
-    // which (overflow_chunk) will be re-inserted into buffer_, at the head of
-    // the queue, to be served up in the next call to read().
-    ByteArray next_chunk(first_chunk.data(), size);
-    buffer_.push_front(
-        ByteArray(first_chunk.data() + size, first_chunk.size() - size));
-    return ExceptionOr<ByteArray>{next_chunk};
+    // which (the overflow) stays at the head of the queue, to be served up in
+    // the next call to read(). Both are slices of first_chunk, so no bytes
+    // are copied.
+    next_chunk = first_chunk.Slice(0, size);
+    first_chunk = first_chunk.Slice(size, first_chunk.size() - size);
   }
+  buffered_bytes_ -= next_chunk.size();
+  if (IsBounded()) {
+    // Wake up writers waiting for room in the pipe.
+    cond_->Notify();
+  }
+  return ExceptionOr<ByteArray>{std::move(next_chunk)};
 }
 
 Exception BasePipe::Write(const ByteArray& data) {
   BaseMutexLock lock(mutex_.get());
 
+  if (!data.Empty()) {
+    Exception wait_exception = WaitForCapacityLocked(data.size(), 1);
+    if (!wait_exception.Ok()) return wait_exception;
+  }
   return WriteLocked(data);
 }
 
+Exception BasePipe::WriteV(const std::vector<ByteArray>& data) {
+  BaseMutexLock lock(mutex_.get());
+
+  if (input_stream_closed_ || output_stream_closed_) {
+    return {Exception::kIo};
+  }
+
+  size_t bytes = 0;
+  size_t chunks = 0;
+  for (const auto& part : data) {
+    bytes += part.size();
+    if (!part.Empty()) ++chunks;
+  }
+  if (chunks == 0) return {Exception::kSuccess};
+  Exception wait_exception = WaitForCapacityLocked(bytes, chunks);
+  if (!wait_exception.Ok()) return wait_exception;
+
+  for (const auto& part : data) {
+    // An empty chunk would mark the end of the stream.
+    if (part.Empty()) continue;
+    buffer_.PushBack(part);
+  }
+  buffered_bytes_ += bytes;
+  cond_->Notify();
+  NotifyReadableLocked();
+  return {Exception::kSuccess};
+}
+
+bool BasePipe::IsReadable() {
+  BaseMutexLock lock(mutex_.get());
+
+  return read_all_chunks_ || input_stream_closed_ || !buffer_.Empty();
+}
+
+void BasePipe::SetReadinessListener(std::function<void()> listener) {
+  BaseMutexLock lock(mutex_.get());
+
+  readiness_listener_ = std::move(listener);
+}
+
 void BasePipe::MarkInputStreamClosed() {
   BaseMutexLock lock(mutex_.get());
 
   input_stream_closed_ = true;
-  // Trigger cond_ to unblock a potentially-blocked call to read(), and to let
-  // it know to return Exception::IO.
+  // Trigger cond_ to unblock a potentially-blocked call to read() (or write(),
+  // on a full pipe), and to let it know to return Exception::IO.
   cond_->Notify();
+  NotifyReadableLocked();
 }
 
 void BasePipe::MarkOutputStreamClosed() {
@@ -98,12 +185,60 @@ Exception BasePipe::WriteLocked(const ByteArray& data) {
     return {Exception::kIo};
   }
 
-  buffer_.push_back(data);
+  buffer_.PushBack(data);
+  buffered_bytes_ += data.size();
   // Trigger cond_ to unblock a potentially-blocked call to read(), now that
   // there's more data for it to consume.
   cond_->Notify();
+  NotifyReadableLocked();
   return {Exception::kSuccess};
 }
 
+Exception BasePipe::WaitForCapacityLocked(size_t bytes, size_t chunks) {
+  const absl::Time deadline = absl::Now() + options_.write_timeout;
+  while (!input_stream_closed_ && !output_stream_closed_ &&
+         !HasCapacityLocked(bytes, chunks)) {
+    Exception wait_exception{Exception::kSuccess};
+    if (options_.write_timeout == absl::InfiniteDuration()) {
+      wait_exception = cond_->Wait();
+    } else {
+      absl::Duration remaining = deadline - absl::Now();
+      if (remaining <= absl::ZeroDuration()) {
+        return {Exception::kTimeout};
+      }
+      wait_exception = cond_->Wait(remaining);
+    }
+
+    if (wait_exception.Raised()) {
+      return wait_exception;
+    }
+  }
+
+  if (input_stream_closed_ || output_stream_closed_) {
+    return {Exception::kIo};
+  }
+  return {Exception::kSuccess};
+}
+
+bool BasePipe::HasCapacityLocked(size_t bytes, size_t chunks) const {
+  // However large, a write goes through once the pipe has been drained;
+  // otherwise it would never go through at all.
+  if (!IsBounded() || buffer_.Empty()) return true;
+  if (options_.max_bytes > 0 && buffered_bytes_ + bytes > options_.max_bytes) {
+    return false;
+  }
+  if (options_.max_chunks > 0 &&
+      buffer_.Size() + chunks > options_.max_chunks) {
+    return false;
+  }
+  return true;
+}
+
+void BasePipe::NotifyReadableLocked() {
+  if (readiness_listener_) {
+    readiness_listener_();
+  }
+}
+
 }  // namespace nearby
 }  // namespace location
@@ -15,11 +15,14 @@
 #ifndef PLATFORM_BASE_BASE_PIPE_H_
 #define PLATFORM_BASE_BASE_PIPE_H_
 
+#include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/time/time.h"
 #include "internal/platform/implementation/condition_variable.h"
 #include "internal/platform/implementation/mutex.h"
 #include "internal/platform/byte_array.h"
@@ -37,10 +40,10 @@ namespace nearby {
 //
 // class DerivedPipe : public BasePipe {
 //  public:
-//   DerivedPipe() {
+//   explicit DerivedPipe(const Options& options = {}) {
 //     auto mutex = /* construct platform-dependent mutex */;
 //     auto cond = /* construct platform-dependent condition variable */;
-//     Setup(std::move(mutex), std::move(cond));
+//     Setup(std::move(mutex), std::move(cond), options);
 //   }
 //   ~DerivedPipe() override = default;
 //   DerivedPipe(DerivedPipe&&) = default;
@@ -49,6 +52,17 @@ namespace nearby {
 class BasePipe {
  public:
   static constexpr const size_t kChunkSize = 64 * 1024;
+
+  // Limits the data a pipe holds on to. Once either limit is reached, writes
+  // block until the reader catches up, or fail with Exception::kTimeout after
+  // |write_timeout|. A write larger than |max_bytes| is let through once the
+  // pipe has been drained. Zero means no limit.
+  struct Options {
+    size_t max_bytes = 0;
+    size_t max_chunks = 0;
+    absl::Duration write_timeout = absl::InfiniteDuration();
+  };
+
   virtual ~BasePipe() = default;
 
   // Pipe is not copyable or movable, because copy/move will invalidate
@@ -66,12 +80,35 @@ class BasePipe {
   BasePipe() = default;
 
   void Setup(std::unique_ptr<api::Mutex> mutex,
-             std::unique_ptr<api::ConditionVariable> cond) {
+             std::unique_ptr<api::ConditionVariable> cond,
+             const Options& options) {
     mutex_ = std::move(mutex);
     cond_ = std::move(cond);
+    options_ = options;
+    if (options_.max_chunks > 0) {
+      // One more for the end of stream marker, which is never held back.
+      buffer_.Reserve(options_.max_chunks + 1);
+    }
   }
 
  private:
+  // Queue of chunks on top of a ring of slots, which only grows (by doubling)
+  // when an unbounded pipe runs out of them.
+  class ChunkRing {
+   public:
+    bool Empty() const { return size_ == 0; }
+    size_t Size() const { return size_; }
+    ByteArray& Front() { return slots_[head_]; }
+    void PushBack(ByteArray chunk);
+    ByteArray PopFront();
+    void Reserve(size_t capacity);
+
+   private:
+    std::vector<ByteArray> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
+
   class BasePipeInputStream : public InputStream {
    public:
     explicit BasePipeInputStream(BasePipe* pipe) : pipe_(pipe) {}
@@ -81,6 +118,11 @@ class BasePipe {
       return pipe_->Read(size);
     }
     Exception Close() override { return DoClose(); }
+    bool IsReadable() override { return pipe_->IsReadable(); }
+    bool SetReadinessListener(std::function<void()> listener) override {
+      pipe_->SetReadinessListener(std::move(listener));
+      return true;
+    }
 
    private:
     Exception DoClose() {
@@ -97,6 +139,9 @@ class BasePipe {
     Exception Write(const ByteArray& data) override {
       return pipe_->Write(data);
     }
+    Exception WriteV(const std::vector<ByteArray>& data) override {
+      return pipe_->WriteV(data);
+    }
     Exception Flush() override { return {Exception::kSuccess}; }
     Exception Close() override { return DoClose(); }
 
@@ -110,12 +155,29 @@ class BasePipe {
 
   ExceptionOr<ByteArray> Read(size_t size) ABSL_LOCKS_EXCLUDED(mutex_);
   Exception Write(const ByteArray& data) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Queues all non-empty parts of |data| at once, so that a reader sees either
+  // none or all of them.
+  Exception WriteV(const std::vector<ByteArray>& data)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  bool IsReadable() ABSL_LOCKS_EXCLUDED(mutex_);
+  void SetReadinessListener(std::function<void()> listener)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   void MarkInputStreamClosed() ABSL_LOCKS_EXCLUDED(mutex_);
   void MarkOutputStreamClosed() ABSL_LOCKS_EXCLUDED(mutex_);
 
   Exception WriteLocked(const ByteArray& data)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Blocks until |bytes| in |chunks| more chunks fit into the pipe. Returns
+  // Exception::kIo if either stream is closed in the meantime.
+  Exception WaitForCapacityLocked(size_t bytes, size_t chunks)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool HasCapacityLocked(size_t bytes, size_t chunks) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool IsBounded() const {
+    return options_.max_bytes > 0 || options_.max_chunks > 0;
+  }
+  void NotifyReadableLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   // Order of declaration matters:
   // - mutex must be defined before condvar;
@@ -124,7 +186,13 @@ class BasePipe {
   bool output_stream_closed_ ABSL_GUARDED_BY(mutex_) = false;
   bool read_all_chunks_ ABSL_GUARDED_BY(mutex_) = false;
 
-  std::deque<ByteArray> ABSL_GUARDED_BY(mutex_) buffer_;
+  Options options_;
+  ChunkRing ABSL_GUARDED_BY(mutex_) buffer_;
+  // Sum of the sizes of the chunks in |buffer_|.
+  size_t ABSL_GUARDED_BY(mutex_) buffered_bytes_ = 0;
+  // Invoked with mutex_ held, so that removing the listener synchronizes with
+  // any notification in flight.
+  std::function<void()> ABSL_GUARDED_BY(mutex_) readiness_listener_;
   std::unique_ptr<api::Mutex> mutex_;
   std::unique_ptr<api::ConditionVariable> cond_;
 
@@ -17,17 +17,63 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 
 namespace location {
 namespace nearby {
 
+// Counts the bytes copied from one buffer into another on the data path, so
+// that the cost of moving a payload through the stack can be measured.
+//
+// The counter is process-wide and is never reset implicitly; callers measuring
+// a transfer either Reset() it first or compare two GetCopiedBytes() values.
+class ByteCopyCounter {
+ public:
+  // Records that |size| bytes were copied.
+  static void Record(size_t size) {
+    copied_bytes_.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  // Returns the number of bytes copied since the last Reset().
+  static std::int64_t GetCopiedBytes() {
+    return copied_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Returns the number of bytes copied since the last Reset() for every
+  // megabyte in |transferred_bytes|, in megabytes. E.g. 2.0 means that every
+  // transferred byte was copied twice.
+  static double GetCopiesPerMegabyte(std::int64_t transferred_bytes) {
+    if (transferred_bytes <= 0) return 0;
+    return static_cast<double>(GetCopiedBytes()) / transferred_bytes;
+  }
+
+  static void Reset() { copied_bytes_.store(0, std::memory_order_relaxed); }
+
+ private:
+  static std::atomic<std::int64_t> copied_bytes_;
+};
+
+// An immutable-by-default sequence of bytes.
+//
+// Copies of a ByteArray, and slices taken with Slice(), share the underlying
+// storage instead of copying it; the storage is reference counted and freed
+// with the last ByteArray that refers to it. The bytes are only copied when a
+// ByteArray whose storage is shared is modified through data() (copy on
+// write), or when they are explicitly copied into another buffer. Such copies
+// are recorded in ByteCopyCounter.
+//
+// A pointer obtained from the non-const data() is invalidated by copying or
+// slicing the ByteArray; do not write through it afterwards.
 class ByteArray {
  public:
   // Create an empty ByteArray
@@ -38,12 +84,19 @@ class ByteArray {
   }
   ByteArray(const ByteArray&) = default;
   ByteArray& operator=(const ByteArray&) = default;
-  ByteArray(ByteArray&&) = default;
-  ByteArray& operator=(ByteArray&&) = default;
+  ByteArray(ByteArray&& other) noexcept { *this = std::move(other); }
+  ByteArray& operator=(ByteArray&& other) noexcept {
+    storage_ = std::move(other.storage_);
+    offset_ = std::exchange(other.offset_, 0);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
 
   // Moves string out of temporary, allowing for a zero-copy constructions.
   // This is an optimization for very large strings.
-  explicit ByteArray(std::string&& source) : data_(std::move(source)) {}
+  explicit ByteArray(std::string&& source)
+      : storage_(std::make_shared<std::string>(std::move(source))),
+        size_(storage_->size()) {}
 
   // Create ByteArray by copy of a std::string. This can't be a string_view,
   // because it will conflict with std::string&& version of constructor.
@@ -60,39 +113,99 @@ class ByteArray {
   // Assign a new value to this ByteArray, as a copy of data, with a given size.
   void SetData(const char* data, size_t size) {
     if (data == nullptr) {
-      size = 0;
+      Reset(std::make_shared<std::string>());
+      return;
     }
-    data_.assign(data, size);
+    Reset(std::make_shared<std::string>(data, size));
+    ByteCopyCounter::Record(size);
   }
 
   // Assign a new value of a given size to this ByteArray
   // (as a repeated char value).
-  void SetData(size_t size, char value = 0) { data_.assign(size, value); }
+  void SetData(size_t size, char value = 0) {
+    Reset(std::make_shared<std::string>(size, value));
+  }
 
   // Returns true, if changes were performed to container, false otherwise.
   bool CopyAt(size_t offset, const ByteArray& from, size_t source_offset = 0) {
     if (offset >= size()) return false;
     if (source_offset >= from.size()) return false;
-    memcpy(data() + offset, from.data() + source_offset,
-           std::min(size() - offset, from.size() - source_offset));
+    size_t size = std::min(this->size() - offset, from.size() - source_offset);
+    memcpy(data() + offset, from.data() + source_offset, size);
+    ByteCopyCounter::Record(size);
     return true;
   }
 
-  char* data() { return &data_[0]; }
-  const char* data() const { return data_.data(); }
-  size_t size() const { return data_.size(); }
-  bool Empty() const { return data_.empty(); }
+  // Returns a ByteArray of up to |size| bytes starting at |offset|, sharing
+  // storage with this one.
+  ByteArray Slice(size_t offset, size_t size) const {
+    ByteArray slice;
+    if (offset >= size_) return slice;
+    slice.storage_ = storage_;
+    slice.offset_ = offset_ + offset;
+    slice.size_ = std::min(size, size_ - offset);
+    return slice;
+  }
+
+  // Returns the concatenation of |parts|. A single part is returned as is,
+  // without copying.
+  static ByteArray Concat(const std::vector<ByteArray>& parts) {
+    if (parts.size() == 1) return parts.front();
+    size_t total_size = 0;
+    for (const auto& part : parts) total_size += part.size();
+    ByteArray result(total_size);
+    size_t offset = 0;
+    for (const auto& part : parts) {
+      result.CopyAt(offset, part);
+      offset += part.size();
+    }
+    return result;
+  }
+
+  char* data() {
+    if (storage_ == nullptr || storage_.use_count() > 1) Detach();
+    return &(*storage_)[offset_];
+  }
+  const char* data() const {
+    return storage_ != nullptr ? storage_->data() + offset_ : "";
+  }
+  size_t size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
 
   friend bool operator==(const ByteArray& lhs, const ByteArray& rhs);
   friend bool operator!=(const ByteArray& lhs, const ByteArray& rhs);
   friend bool operator<(const ByteArray& lhs, const ByteArray& rhs);
 
   // Returns a copy of internal representation as std::string.
-  explicit operator std::string() const& { return data_; }
+  explicit operator std::string() const& {
+    ByteCopyCounter::Record(size_);
+    return std::string(data(), size_);
+  }
 
   // Moves string out of temporary ByteArray, allowing for a zero-copy
-  // operation.
-  explicit operator std::string() && { return std::move(data_); }
+  // operation. Falls back to a copy if the storage is shared or if this is a
+  // slice of a larger buffer.
+  explicit operator std::string() && {
+    if (storage_ == nullptr) return std::string();
+    if (storage_.use_count() > 1 || offset_ != 0 ||
+        size_ != storage_->size()) {
+      return static_cast<const ByteArray&>(*this).operator std::string();
+    }
+    std::string result = std::move(*storage_);
+    Reset(nullptr);
+    return result;
+  }
+
+  // Returns the bytes as a std::string, for APIs that take one by reference.
+  // No copy is made if this ByteArray spans all of its storage; otherwise the
+  // bytes are copied into |scratch|, which backs the returned reference.
+  const std::string& AsString(std::string* scratch) const {
+    if (storage_ != nullptr && offset_ == 0 && size_ == storage_->size()) {
+      return *storage_;
+    }
+    *scratch = static_cast<std::string>(*this);
+    return *scratch;
+  }
 
   // Returns the representation of the underlying data as a string view.
   absl::string_view AsStringView() const {
@@ -102,15 +215,30 @@ class ByteArray {
   // Hashable
   template <typename H>
   friend H AbslHashValue(H h, const ByteArray& m) {
-    return H::combine(std::move(h), m.data_);
+    return H::combine(std::move(h), m.AsStringView());
   }
 
  private:
-  std::string data_;
+  void Reset(std::shared_ptr<std::string> storage) {
+    storage_ = std::move(storage);
+    offset_ = 0;
+    size_ = storage_ != nullptr ? storage_->size() : 0;
+  }
+
+  // Gives this ByteArray a private copy of its bytes.
+  void Detach() {
+    const char* bytes = static_cast<const ByteArray&>(*this).data();
+    Reset(std::make_shared<std::string>(bytes, size_));
+    ByteCopyCounter::Record(size_);
+  }
+
+  std::shared_ptr<std::string> storage_;
+  size_t offset_ = 0;
+  size_t size_ = 0;
 };
 
 inline bool operator==(const ByteArray& lhs, const ByteArray& rhs) {
-  return lhs.data_ == rhs.data_;
+  return lhs.AsStringView() == rhs.AsStringView();
 }
 
 inline bool operator!=(const ByteArray& lhs, const ByteArray& rhs) {
@@ -118,7 +246,7 @@ inline bool operator!=(const ByteArray& lhs, const ByteArray& rhs) {
 }
 
 inline bool operator<(const ByteArray& lhs, const ByteArray& rhs) {
-  return lhs.data_ < rhs.data_;
+  return lhs.AsStringView() < rhs.AsStringView();
 }
 
 }  // namespace nearby
@@ -14,7 +14,10 @@
 
 #include "internal/platform/byte_array.h"
 
+#include <cstdint>
 #include <cstring>
+#include <string>
+#include <utility>
 
 #include "gtest/gtest.h"
 #include "absl/hash/hash_testing.h"
@@ -22,6 +25,7 @@
 namespace {
 
 using location::nearby::ByteArray;
+using location::nearby::ByteCopyCounter;
 
 TEST(ByteArrayTest, DefaultSizeIsZero) {
   ByteArray bytes;
@@ -96,6 +100,96 @@ TEST(ByteArrayTest, CreateFromAbslStringReturnsTheSame) {
   EXPECT_EQ(bytes.AsStringView(), kTestString);
 }
 
+TEST(ByteArrayTest, CopiesShareStorage) {
+  const ByteArray bytes{std::string("shared")};
+  ByteCopyCounter::Reset();
+
+  const ByteArray copy = bytes;
+
+  EXPECT_EQ(copy.data(), bytes.data());
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 0);
+}
+
+TEST(ByteArrayTest, WriteToSharedCopyDoesNotChangeOriginal) {
+  ByteArray bytes("ABCDEFGH");
+  ByteArray copy = bytes;
+  ByteCopyCounter::Reset();
+
+  copy.data()[0] = 'Z';
+
+  EXPECT_EQ(bytes, ByteArray("ABCDEFGH"));
+  EXPECT_EQ(copy, ByteArray("ZBCDEFGH"));
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), bytes.size());
+}
+
+TEST(ByteArrayTest, SliceSharesStorage) {
+  const ByteArray bytes("ABCDEFGH");
+  ByteCopyCounter::Reset();
+
+  const ByteArray slice = bytes.Slice(/*offset=*/2, /*size=*/3);
+
+  EXPECT_EQ(slice, ByteArray("CDE"));
+  EXPECT_EQ(slice.data(), bytes.data() + 2);
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 0);
+}
+
+TEST(ByteArrayTest, SliceIsClampedToBounds) {
+  const ByteArray bytes("ABCDEFGH");
+
+  EXPECT_EQ(bytes.Slice(/*offset=*/6, /*size=*/10), ByteArray("GH"));
+  EXPECT_TRUE(bytes.Slice(/*offset=*/8, /*size=*/1).Empty());
+}
+
+TEST(ByteArrayTest, MoveToStringDoesNotCopyUniqueStorage) {
+  ByteArray bytes{std::string(1024, 'x')};
+  const char* data = static_cast<const ByteArray&>(bytes).data();
+  ByteCopyCounter::Reset();
+
+  std::string moved = std::string(std::move(bytes));
+
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 0);
+}
+
+TEST(ByteArrayTest, MoveToStringCopiesSlice) {
+  ByteArray bytes("ABCDEFGH");
+  ByteCopyCounter::Reset();
+
+  std::string moved = std::string(bytes.Slice(/*offset=*/4, /*size=*/4));
+
+  EXPECT_EQ(moved, "EFGH");
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 4);
+}
+
+TEST(ByteArrayTest, ConcatJoinsParts) {
+  EXPECT_EQ(ByteArray::Concat({ByteArray(std::string("ABC")), ByteArray(),
+                               ByteArray(std::string("DE"))}),
+            ByteArray("ABCDE"));
+  EXPECT_TRUE(ByteArray::Concat({}).Empty());
+}
+
+TEST(ByteArrayTest, ConcatOfSinglePartDoesNotCopy) {
+  ByteArray bytes{std::string("ABCDE")};
+  ByteCopyCounter::Reset();
+
+  ByteArray joined = ByteArray::Concat({bytes});
+
+  EXPECT_EQ(joined, bytes);
+  EXPECT_EQ(ByteCopyCounter::GetCopiedBytes(), 0);
+}
+
+TEST(ByteArrayTest, CopyCounterReportsCopiesPerMegabyte) {
+  constexpr std::int64_t kMegabyte = 1024 * 1024;
+  std::string data(kMegabyte, 'x');
+  ByteCopyCounter::Reset();
+
+  ByteArray first(data);
+  ByteArray second(data);
+
+  EXPECT_DOUBLE_EQ(ByteCopyCounter::GetCopiesPerMegabyte(kMegabyte), 2.0);
+  EXPECT_EQ(ByteCopyCounter::GetCopiesPerMegabyte(0), 0);
+}
+
 TEST(ByteArrayTest, Hash) {
   EXPECT_TRUE(absl::VerifyTypeImplementsAbslHashCorrectly({
       ByteArray(),
@@ -50,6 +50,119 @@ class FeatureFlags {
     bool support_ble_v2 = false;
     // Allows the code to change the bluetooth radio state
     bool enable_set_radio_state = false;
+    // Read from endpoints on a fixed pool of worker threads, woken up by
+    // channel readiness, instead of on a dedicated thread per endpoint.
+    // Channels whose medium can not signal readiness keep a dedicated thread.
+    bool enable_endpoint_reader_pool = false;
+    std::int32_t endpoint_reader_pool_size = 4;
+    // Let an endpoint channel write the frames that queued up behind a write
+    // in progress with a single call, as long as they add up to no more than
+    // max_coalesced_frame_bytes.
+    bool enable_frame_coalescing = false;
+    std::int32_t max_coalesced_frame_bytes = 4096;
+    // Read the chunks of outgoing file payloads on a thread of their own, up
+    // to payload_send_pipeline_depth chunks ahead of the one being sent.
+    bool enable_pipelined_payload_send = false;
+    std::int32_t payload_send_pipeline_depth = 2;
+    // Write payload frames to each endpoint from a queue and writer of its
+    // own, so that a slow endpoint does not hold back the others. An endpoint
+    // with fan_out_max_lagging_frames frames queued up fails the payload that
+    // is being sent.
+    bool enable_parallel_fan_out = false;
+    std::int32_t fan_out_max_lagging_frames = 64;
+    // Send BYTES payloads in chunks, like files, to peers that said, in their
+    // connection responses, that they reassemble them. Receivers do so
+    // regardless of this flag.
+    bool enable_bytes_payload_chunking = false;
+    // Size outgoing payload chunks per medium from the throughput measured
+    // while sending, instead of always using the largest packet size.
+    bool enable_adaptive_chunk_size = false;
+    // Offer to encrypt connections with an AES-256-GCM frame cipher keyed from
+    // the UKEY2 session, instead of wrapping every frame in a SecureMessage.
+    // Used only with peers that offer it too.
+    bool enable_aead_frame_cipher = false;
+    // Connect over all the mediums an endpoint was discovered on at once,
+    // starting one attempt every parallel_connect_stagger (or right away, once
+    // all attempts so far failed). The first medium to connect wins; the
+    // other attempts are cancelled. Needs enable_cancellation_flag; without
+    // it, the mediums are tried one after the other.
+    bool enable_parallel_connect = false;
+    absl::Duration parallel_connect_stagger = absl::Milliseconds(300);
+    // Set up connections with up to connection_setup_concurrency endpoints at
+    // once: connecting, reading the connection request and running UKEY2 on a
+    // pool of worker threads, instead of one endpoint after the other. Changes
+    // to the connection state still happen on the PCP handler thread.
+    bool enable_concurrent_connection_setup = false;
+    std::int32_t connection_setup_concurrency = 8;
+    // Call a client's payload and connection listeners from a queue of its
+    // own, in order, without holding the client's lock. In-progress payload
+    // updates are delivered at most once per payload_progress_min_interval,
+    // unless payload_progress_min_bytes more bytes were transferred since the
+    // last one; updates with a terminal status are always delivered.
+    bool enable_async_payload_callbacks = false;
+    absl::Duration payload_progress_min_interval = absl::Milliseconds(100);
+    std::int64_t payload_progress_min_bytes = 512 * 1024;
+    // Switch to the upgraded channel make-before-break, if the remote device
+    // supports it too: writers move to the new channel right after the
+    // LAST_WRITE frame instead of waiting for SAFE_TO_CLOSE, while the prior
+    // channel is drained and closed in the background, or after
+    // make_before_break_drain_timeout.
+    bool enable_make_before_break_bwu = false;
+    absl::Duration make_before_break_drain_timeout = absl::Seconds(10);
+    // Pick the upgrade medium from measured link quality (see
+    // analytics::LinkQualityEstimator) instead of the order of preference
+    // alone: the one expected to transfer the most data within
+    // upgrade_gain_horizon, upgrade setup included, or none if that is less
+    // than upgrade_min_expected_gain times what the current medium would.
+    bool enable_measured_upgrade_selection = false;
+    absl::Duration upgrade_gain_horizon = absl::Seconds(30);
+    double upgrade_min_expected_gain = 1.5;
+    // Ack the remote device's KeepAlive frames, and time the acks of ours to
+    // estimate the round trip time of each medium.
+    bool enable_keep_alive_rtt_probes = false;
+    // Batch the writes to WebRTC data channels into messages of up to
+    // webrtc_max_message_bytes, sent on Flush(). Once the data channel buffers
+    // more than webrtc_send_high_watermark bytes, writers wait for it to drain
+    // below webrtc_send_low_watermark, for at most webrtc_send_timeout before
+    // the write fails.
+    bool enable_webrtc_send_batching = false;
+    std::int32_t webrtc_max_message_bytes = 64 * 1024;
+    std::int64_t webrtc_send_high_watermark = 4 * 1024 * 1024;
+    std::int64_t webrtc_send_low_watermark = 1024 * 1024;
+    absl::Duration webrtc_send_timeout = absl::Seconds(15);
+    // Write the chunks of incoming file payloads on a thread of their own, up
+    // to file_write_behind_queue_bytes behind the endpoint's reader, in
+    // writes of up to file_write_behind_write_bytes.
+    bool enable_file_write_behind = false;
+    std::int64_t file_write_behind_queue_bytes = 8 * 1024 * 1024;
+    std::int64_t file_write_behind_write_bytes = 1024 * 1024;
+    // Offer to compress payload chunks with DEFLATE. Chunks are compressed
+    // only for peers that offer it too, and only if a sample of their bytes
+    // looks compressible.
+    bool enable_payload_compression = false;
+    // Offer to send FILE payloads of at least delta_transfer_min_bytes as
+    // deltas against the file the receiver wrote when it received the same
+    // payload, by name, before, if any (see block_delta.h). The payload waits
+    // up to delta_signature_timeout, plus the time to read a file its size at
+    // delta_signature_bytes_per_second, for the receiver to sign its copy,
+    // and is sent whole if it does not.
+    bool enable_delta_transfer = false;
+    std::int64_t delta_transfer_min_bytes = 1024 * 1024;
+    absl::Duration delta_signature_timeout = absl::Seconds(30);
+    std::int64_t delta_signature_bytes_per_second = 20 * 1024 * 1024;
+    // Send the chunks of FILE payloads from a single thread, in the order a
+    // PayloadScheduler picks by payload priority and weight, instead of
+    // sending one file at a time, to completion. BYTES and STREAM payloads
+    // keep their own threads. A payload that has not sent a chunk for
+    // payload_scheduler_max_wait goes next whatever its priority. A chunk
+    // holds the thread until it is written, so this is best paired with
+    // enable_adaptive_chunk_size.
+    bool enable_payload_scheduler = false;
+    absl::Duration payload_scheduler_max_wait = absl::Seconds(2);
+    // Hand the BLE advertisements found while the BLE thread is busy to the
+    // discovered peripheral tracker together, parsing identical ones once,
+    // instead of one report at a time.
+    bool enable_ble_scan_batching = false;
   };
 
   static const FeatureFlags& GetInstance() {
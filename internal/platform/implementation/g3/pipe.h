@@ -27,14 +27,22 @@ namespace g3 {
 
 class Pipe : public BasePipe {
  public:
-  Pipe() {
+  explicit Pipe(const Options& options = {}) {
     auto mutex = std::make_unique<g3::Mutex>(/*check=*/true);
     auto cond = std::make_unique<g3::ConditionVariable>(mutex.get());
-    Setup(std::move(mutex), std::move(cond));
+    Setup(std::move(mutex), std::move(cond), options);
   }
   ~Pipe() override = default;
   Pipe(Pipe&&) = delete;
   Pipe& operator=(Pipe&&) = delete;
+
+  // Like the buffers of a real socket, the pipes behind simulated sockets hold
+  // a limited amount of data; writes block while the peer is behind.
+  static Options SocketOptions() {
+    Options options;
+    options.max_bytes = 1024 * 1024;
+    return options;
+  }
 };
 
 }  // namespace g3
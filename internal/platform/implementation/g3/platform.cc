@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <string>
 
@@ -68,6 +69,21 @@ std::string ImplementationPlatform::GetDownloadPath(
   return file::JoinPath("/tmp", file_name);
 }
 
+std::string ImplementationPlatform::GetAppDataPath(
+    absl::string_view file_name) {
+  return file::JoinPath("/tmp", file_name);
+}
+
+bool ImplementationPlatform::RenameFile(absl::string_view from_path,
+                                        absl::string_view to_path) {
+  return std::rename(std::string(from_path).c_str(),
+                     std::string(to_path).c_str()) == 0;
+}
+
+bool ImplementationPlatform::RemoveFile(absl::string_view file_path) {
+  return std::remove(std::string(file_path).c_str()) == 0;
+}
+
 OSName ImplementationPlatform::GetCurrentOS() { return OSName::kLinux; }
 
 int GetCurrentTid() {
@@ -83,7 +83,7 @@ class WifiLanSocket : public api::WifiLanSocket {
   // Output pipe is initialized by constructor, it remains always valid, until
   // it is closed. it represents output part of a local socket. Input part of a
   // local socket comes from the peer socket, after connection.
-  std::shared_ptr<Pipe> output_{new Pipe};
+  std::shared_ptr<Pipe> output_{new Pipe(Pipe::SocketOptions())};
   std::shared_ptr<Pipe> input_;
   mutable absl::Mutex mutex_;
   WifiLanSocket* remote_socket_ ABSL_GUARDED_BY(mutex_) = nullptr;
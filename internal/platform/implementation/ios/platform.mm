@@ -14,6 +14,7 @@
 
 #include "internal/platform/implementation/platform.h"
 
+#include <cstdio>
 #include <string>
 
 #include "internal/platform/implementation/ios/atomic_boolean.h"
@@ -48,6 +49,19 @@ std::string ImplementationPlatform::GetDownloadPath(absl::string_view parent_fol
   return CppStringFromObjCString([NSTemporaryDirectory() stringByAppendingPathComponent:fileName]);
 }
 
+std::string ImplementationPlatform::GetAppDataPath(absl::string_view file_name) {
+  NSString* fileName = ObjCStringFromCppString(file_name);
+  return CppStringFromObjCString([NSTemporaryDirectory() stringByAppendingPathComponent:fileName]);
+}
+
+bool ImplementationPlatform::RenameFile(absl::string_view from_path, absl::string_view to_path) {
+  return std::rename(std::string(from_path).c_str(), std::string(to_path).c_str()) == 0;
+}
+
+bool ImplementationPlatform::RemoveFile(absl::string_view file_path) {
+  return std::remove(std::string(file_path).c_str()) == 0;
+}
+
 OSName ImplementationPlatform::GetCurrentOS() { return OSName::kiOS; }
 
 // Atomics:
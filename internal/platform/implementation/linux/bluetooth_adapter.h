@@ -0,0 +1,49 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_BLUETOOTH_ADAPTER_H_
+#define PLATFORM_IMPL_LINUX_BLUETOOTH_ADAPTER_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "internal/platform/implementation/bluetooth_adapter.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// The Linux platform has no Bluetooth support; its adapter is permanently
+// disabled, so that the Bluetooth and BLE mediums report themselves as
+// unavailable.
+class BluetoothAdapter : public api::BluetoothAdapter {
+ public:
+  ~BluetoothAdapter() override = default;
+
+  bool SetStatus(Status status) override {
+    return status == Status::kDisabled;
+  }
+  bool IsEnabled() const override { return false; }
+  ScanMode GetScanMode() const override { return ScanMode::kNone; }
+  bool SetScanMode(ScanMode scan_mode) override { return false; }
+  std::string GetName() const override { return {}; }
+  bool SetName(absl::string_view name) override { return false; }
+  bool SetName(absl::string_view name, bool persist) override { return false; }
+  std::string GetMacAddress() const override { return {}; }
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_BLUETOOTH_ADAPTER_H_
@@ -0,0 +1,110 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/log_message.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+namespace {
+
+std::atomic<api::LogMessage::Severity> g_min_log_severity =
+    api::LogMessage::Severity::kInfo;
+
+char SeverityToChar(api::LogMessage::Severity severity) {
+  switch (severity) {
+    case api::LogMessage::Severity::kVerbose:
+      return 'V';
+    case api::LogMessage::Severity::kInfo:
+      return 'I';
+    case api::LogMessage::Severity::kWarning:
+      return 'W';
+    case api::LogMessage::Severity::kError:
+      return 'E';
+    case api::LogMessage::Severity::kFatal:
+      return 'F';
+  }
+  return '?';
+}
+
+absl::string_view Basename(absl::string_view file) {
+  auto slash = file.find_last_of('/');
+  return slash == absl::string_view::npos ? file : file.substr(slash + 1);
+}
+
+}  // namespace
+
+LogMessage::LogMessage(const char* file, int line, Severity severity)
+    : severity_(severity) {
+  stream_ << SeverityToChar(severity)
+          << absl::FormatTime("%m%d %H:%M:%E6S ", absl::Now(),
+                              absl::LocalTimeZone())
+          << syscall(SYS_gettid) << " " << Basename(file) << ":" << line
+          << "] ";
+}
+
+LogMessage::~LogMessage() {
+  stream_ << "\n";
+  // One write per message, so that lines from several threads do not
+  // interleave.
+  std::string line = stream_.str();
+  fwrite(line.data(), 1, line.size(), stderr);
+  if (severity_ == Severity::kFatal) {
+    fflush(stderr);
+    abort();
+  }
+}
+
+void LogMessage::Print(const char* format, ...) {
+  char buffer[1024];
+  va_list ap;
+  va_start(ap, format);
+  int result = vsnprintf(buffer, sizeof(buffer), format, ap);
+  va_end(ap);
+  if (result > 0) {
+    stream_.write(buffer, std::min<int>(result, sizeof(buffer) - 1));
+  }
+}
+
+std::ostream& LogMessage::Stream() { return stream_; }
+
+}  // namespace linux_platform
+
+namespace api {
+
+void LogMessage::SetMinLogSeverity(Severity severity) {
+  linux_platform::g_min_log_severity = severity;
+}
+
+bool LogMessage::ShouldCreateLogMessage(Severity severity) {
+  return severity >= linux_platform::g_min_log_severity;
+}
+
+}  // namespace api
+}  // namespace nearby
+}  // namespace location
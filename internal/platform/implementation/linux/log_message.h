@@ -0,0 +1,45 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_LOG_MESSAGE_H_
+#define PLATFORM_IMPL_LINUX_LOG_MESSAGE_H_
+
+#include <sstream>
+
+#include "internal/platform/implementation/log_message.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// Writes a single line to stderr once destroyed. A kFatal message aborts the
+// process after it is written.
+class LogMessage : public api::LogMessage {
+ public:
+  LogMessage(const char* file, int line, Severity severity);
+  ~LogMessage() override;
+
+  void Print(const char* format, ...) override;
+
+  std::ostream& Stream() override;
+
+ private:
+  Severity severity_;
+  std::ostringstream stream_;
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_LOG_MESSAGE_H_
@@ -0,0 +1,52 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_MULTI_THREAD_EXECUTOR_H_
+#define PLATFORM_IMPL_LINUX_MULTI_THREAD_EXECUTOR_H_
+
+#include <utility>
+
+#include "internal/platform/implementation/linux/thread_pool.h"
+#include "internal/platform/implementation/submittable_executor.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// An Executor that reuses a fixed number of threads operating off a shared
+// unbounded queue.
+class MultiThreadExecutor : public api::SubmittableExecutor {
+ public:
+  explicit MultiThreadExecutor(int max_parallelism)
+      : thread_pool_(max_parallelism) {}
+  ~MultiThreadExecutor() override { thread_pool_.Shutdown(); }
+
+  void Execute(Runnable&& runnable) override {
+    thread_pool_.Schedule(std::move(runnable));
+  }
+  bool DoSubmit(Runnable&& runnable) override {
+    return thread_pool_.Schedule(std::move(runnable));
+  }
+  void Shutdown() override { thread_pool_.Shutdown(); }
+
+  bool InShutdown() const { return thread_pool_.InShutdown(); }
+
+ private:
+  ThreadPool thread_pool_;
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_MULTI_THREAD_EXECUTOR_H_
@@ -0,0 +1,232 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/platform.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "internal/platform/implementation/atomic_boolean.h"
+#include "internal/platform/implementation/atomic_reference.h"
+#include "internal/platform/implementation/bluetooth_adapter.h"
+#include "internal/platform/implementation/bluetooth_classic.h"
+#include "internal/platform/implementation/condition_variable.h"
+#include "internal/platform/implementation/linux/atomic_boolean.h"
+#include "internal/platform/implementation/linux/atomic_reference.h"
+#include "internal/platform/implementation/linux/bluetooth_adapter.h"
+#include "internal/platform/implementation/linux/condition_variable.h"
+#include "internal/platform/implementation/linux/log_message.h"
+#include "internal/platform/implementation/linux/multi_thread_executor.h"
+#include "internal/platform/implementation/linux/mutex.h"
+#include "internal/platform/implementation/linux/scheduled_executor.h"
+#include "internal/platform/implementation/linux/single_thread_executor.h"
+#include "internal/platform/implementation/linux/wifi_lan.h"
+#include "internal/platform/implementation/log_message.h"
+#include "internal/platform/implementation/mutex.h"
+#include "internal/platform/implementation/scheduled_executor.h"
+#include "internal/platform/implementation/server_sync.h"
+#include "internal/platform/implementation/shared/count_down_latch.h"
+#include "internal/platform/implementation/shared/file.h"
+#include "internal/platform/implementation/submittable_executor.h"
+#include "internal/platform/implementation/wifi.h"
+#ifndef NO_WEBRTC
+#include "internal/platform/implementation/webrtc.h"
+#endif
+
+namespace location {
+namespace nearby {
+namespace api {
+
+namespace {
+
+constexpr char kDownloadDir[] = "/tmp";
+
+std::string GetAppDataDir() {
+  const char* data_home = getenv("XDG_DATA_HOME");
+  if (data_home != nullptr && *data_home != '\0') {
+    return absl::StrCat(data_home, "/nearby");
+  }
+  const char* home = getenv("HOME");
+  if (home != nullptr && *home != '\0') {
+    return absl::StrCat(home, "/.local/share/nearby");
+  }
+  return "/tmp/nearby";
+}
+
+}  // namespace
+
+std::string ImplementationPlatform::GetDownloadPath(
+    absl::string_view parent_folder, absl::string_view file_name) {
+  if (parent_folder.empty()) return GetDownloadPath(file_name);
+  return absl::StrCat(kDownloadDir, "/", parent_folder, "/", file_name);
+}
+
+std::string ImplementationPlatform::GetDownloadPath(
+    absl::string_view file_name) {
+  return absl::StrCat(kDownloadDir, "/", file_name);
+}
+
+std::string ImplementationPlatform::GetAppDataPath(
+    absl::string_view file_name) {
+  return absl::StrCat(GetAppDataDir(), "/", file_name);
+}
+
+bool ImplementationPlatform::RenameFile(absl::string_view from_path,
+                                        absl::string_view to_path) {
+  return std::rename(std::string(from_path).c_str(),
+                     std::string(to_path).c_str()) == 0;
+}
+
+bool ImplementationPlatform::RemoveFile(absl::string_view file_path) {
+  return std::remove(std::string(file_path).c_str()) == 0;
+}
+
+OSName ImplementationPlatform::GetCurrentOS() { return OSName::kLinux; }
+
+int GetCurrentTid() { return static_cast<int>(syscall(SYS_gettid)); }
+
+std::unique_ptr<SubmittableExecutor>
+ImplementationPlatform::CreateSingleThreadExecutor() {
+  return std::make_unique<linux_platform::SingleThreadExecutor>();
+}
+
+std::unique_ptr<SubmittableExecutor>
+ImplementationPlatform::CreateMultiThreadExecutor(int max_concurrency) {
+  return std::make_unique<linux_platform::MultiThreadExecutor>(
+      max_concurrency);
+}
+
+std::unique_ptr<ScheduledExecutor>
+ImplementationPlatform::CreateScheduledExecutor() {
+  return std::make_unique<linux_platform::ScheduledExecutor>();
+}
+
+std::unique_ptr<AtomicUint32> ImplementationPlatform::CreateAtomicUint32(
+    std::uint32_t value) {
+  return std::make_unique<linux_platform::AtomicUint32>(value);
+}
+
+std::unique_ptr<BluetoothAdapter>
+ImplementationPlatform::CreateBluetoothAdapter() {
+  return std::make_unique<linux_platform::BluetoothAdapter>();
+}
+
+std::unique_ptr<CountDownLatch> ImplementationPlatform::CreateCountDownLatch(
+    std::int32_t count) {
+  return std::make_unique<shared::CountDownLatch>(count);
+}
+
+std::unique_ptr<AtomicBoolean> ImplementationPlatform::CreateAtomicBoolean(
+    bool initial_value) {
+  return std::make_unique<linux_platform::AtomicBoolean>(initial_value);
+}
+
+std::unique_ptr<InputFile> ImplementationPlatform::CreateInputFile(
+    PayloadId payload_id, std::int64_t total_size) {
+  return shared::IOFile::CreateInputFile(
+      GetDownloadPath(std::to_string(payload_id)), total_size);
+}
+
+std::unique_ptr<InputFile> ImplementationPlatform::CreateInputFile(
+    absl::string_view file_path, size_t size) {
+  return shared::IOFile::CreateInputFile(file_path, size);
+}
+
+std::unique_ptr<OutputFile> ImplementationPlatform::CreateOutputFile(
+    PayloadId payload_id) {
+  return shared::IOFile::CreateOutputFile(
+      GetDownloadPath(std::to_string(payload_id)));
+}
+
+std::unique_ptr<OutputFile> ImplementationPlatform::CreateOutputFile(
+    absl::string_view file_path) {
+  return shared::IOFile::CreateOutputFile(file_path);
+}
+
+std::unique_ptr<LogMessage> ImplementationPlatform::CreateLogMessage(
+    const char* file, int line, LogMessage::Severity severity) {
+  return std::make_unique<linux_platform::LogMessage>(file, line, severity);
+}
+
+// Bluetooth is not supported; the adapter reports itself as disabled, and the
+// Bluetooth based mediums are not available.
+std::unique_ptr<BluetoothClassicMedium>
+ImplementationPlatform::CreateBluetoothClassicMedium(
+    api::BluetoothAdapter& adapter) {
+  return nullptr;
+}
+
+std::unique_ptr<BleMedium> ImplementationPlatform::CreateBleMedium(
+    api::BluetoothAdapter& adapter) {
+  return nullptr;
+}
+
+std::unique_ptr<api::ble_v2::BleMedium>
+ImplementationPlatform::CreateBleV2Medium(api::BluetoothAdapter& adapter) {
+  return nullptr;
+}
+
+std::unique_ptr<api::CredentialStorage>
+ImplementationPlatform::CreateCredentialStorage() {
+  return nullptr;
+}
+
+std::unique_ptr<ServerSyncMedium>
+ImplementationPlatform::CreateServerSyncMedium() {
+  return nullptr;
+}
+
+std::unique_ptr<WifiMedium> ImplementationPlatform::CreateWifiMedium() {
+  return nullptr;
+}
+
+std::unique_ptr<WifiLanMedium> ImplementationPlatform::CreateWifiLanMedium() {
+  return std::make_unique<linux_platform::WifiLanMedium>();
+}
+
+std::unique_ptr<WifiHotspotMedium>
+ImplementationPlatform::CreateWifiHotspotMedium() {
+  return nullptr;
+}
+
+#ifndef NO_WEBRTC
+std::unique_ptr<WebRtcMedium> ImplementationPlatform::CreateWebRtcMedium() {
+  return nullptr;
+}
+#endif
+
+std::unique_ptr<Mutex> ImplementationPlatform::CreateMutex(Mutex::Mode mode) {
+  if (mode == Mutex::Mode::kRecursive)
+    return std::make_unique<linux_platform::RecursiveMutex>();
+  else
+    return std::make_unique<linux_platform::Mutex>(mode ==
+                                                   Mutex::Mode::kRegular);
+}
+
+std::unique_ptr<ConditionVariable>
+ImplementationPlatform::CreateConditionVariable(Mutex* mutex) {
+  return std::make_unique<linux_platform::ConditionVariable>(
+      static_cast<linux_platform::Mutex*>(mutex));
+}
+
+}  // namespace api
+}  // namespace nearby
+}  // namespace location
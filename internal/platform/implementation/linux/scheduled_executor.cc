@@ -0,0 +1,106 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/scheduled_executor.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "absl/time/clock.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+class ScheduledExecutor::ScheduledCancelable : public api::Cancelable {
+ public:
+  bool Cancel() override {
+    Status expected = kNotRun;
+    return status_.compare_exchange_strong(expected, kCanceled);
+  }
+  bool MarkExecuted() {
+    Status expected = kNotRun;
+    return status_.compare_exchange_strong(expected, kExecuted);
+  }
+  bool IsCanceled() const { return status_ == kCanceled; }
+
+ private:
+  enum Status {
+    kNotRun,
+    kExecuted,
+    kCanceled,
+  };
+  std::atomic<Status> status_ = kNotRun;
+};
+
+ScheduledExecutor::ScheduledExecutor()
+    : timer_thread_(&ScheduledExecutor::RunTimers, this) {}
+
+ScheduledExecutor::~ScheduledExecutor() { Shutdown(); }
+
+std::shared_ptr<api::Cancelable> ScheduledExecutor::Schedule(
+    Runnable&& runnable, absl::Duration delay) {
+  auto cancelable = std::make_shared<ScheduledCancelable>();
+  absl::MutexLock lock(&mutex_);
+  if (shutdown_) return cancelable;
+  absl::Time deadline = absl::Now() + delay;
+  if (timers_.empty() || deadline < timers_.begin()->first) {
+    timers_changed_.Signal();
+  }
+  timers_.emplace(deadline, Timer{cancelable, std::move(runnable)});
+  return cancelable;
+}
+
+void ScheduledExecutor::Shutdown() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (shutdown_) return;
+    shutdown_ = true;
+    timers_.clear();
+    timers_changed_.Signal();
+  }
+  if (timer_thread_.get_id() == std::this_thread::get_id()) {
+    timer_thread_.detach();
+  } else if (timer_thread_.joinable()) {
+    timer_thread_.join();
+  }
+  executor_.Shutdown();
+}
+
+void ScheduledExecutor::RunTimers() {
+  absl::MutexLock lock(&mutex_);
+  while (!shutdown_) {
+    if (timers_.empty()) {
+      timers_changed_.Wait(&mutex_);
+      continue;
+    }
+    absl::Time deadline = timers_.begin()->first;
+    if (deadline > absl::Now()) {
+      // Woken up early if a sooner timer is added.
+      timers_changed_.WaitWithDeadline(&mutex_, deadline);
+      continue;
+    }
+    Timer timer = std::move(timers_.begin()->second);
+    timers_.erase(timers_.begin());
+    if (timer.cancelable->IsCanceled()) continue;
+    executor_.Execute([cancelable = std::move(timer.cancelable),
+                       runnable = std::move(timer.runnable)]() {
+      if (cancelable->MarkExecuted()) runnable();
+    });
+  }
+}
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,70 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_SCHEDULED_EXECUTOR_H_
+#define PLATFORM_IMPL_LINUX_SCHEDULED_EXECUTOR_H_
+
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/btree_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/implementation/cancelable.h"
+#include "internal/platform/implementation/linux/single_thread_executor.h"
+#include "internal/platform/implementation/scheduled_executor.h"
+#include "internal/platform/runnable.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// Runs tasks on a single worker thread, either right away or after a delay.
+// A separate timer thread hands delayed tasks to the worker once they are
+// due, so tasks run one at a time and in order.
+class ScheduledExecutor final : public api::ScheduledExecutor {
+ public:
+  ScheduledExecutor();
+  ~ScheduledExecutor() override;
+
+  void Execute(Runnable&& runnable) override {
+    executor_.Execute(std::move(runnable));
+  }
+  std::shared_ptr<api::Cancelable> Schedule(Runnable&& runnable,
+                                            absl::Duration delay) override;
+  void Shutdown() override;
+
+ private:
+  class ScheduledCancelable;
+
+  struct Timer {
+    std::shared_ptr<ScheduledCancelable> cancelable;
+    Runnable runnable;
+  };
+
+  void RunTimers();
+
+  SingleThreadExecutor executor_;
+  absl::Mutex mutex_;
+  absl::CondVar timers_changed_;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  absl::btree_multimap<absl::Time, Timer> timers_ ABSL_GUARDED_BY(mutex_);
+  std::thread timer_thread_;
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_SCHEDULED_EXECUTOR_H_
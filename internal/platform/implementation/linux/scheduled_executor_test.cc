@@ -0,0 +1,137 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/scheduled_executor.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/implementation/linux/multi_thread_executor.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+namespace {
+
+TEST(MultiThreadExecutorTest, RunsTasksInParallel) {
+  MultiThreadExecutor executor(2);
+  absl::BlockingCounter started(2);
+  absl::Notification release;
+
+  for (int i = 0; i < 2; ++i) {
+    executor.Execute([&started, &release]() {
+      started.DecrementCount();
+      release.WaitForNotification();
+    });
+  }
+
+  // Only returns if both tasks are running at the same time.
+  started.Wait();
+  release.Notify();
+}
+
+TEST(MultiThreadExecutorTest, ShutdownRunsQueuedTasks) {
+  MultiThreadExecutor executor(1);
+  std::atomic_int runs = 0;
+
+  for (int i = 0; i < 10; ++i) {
+    executor.Execute([&runs]() { ++runs; });
+  }
+  executor.Shutdown();
+
+  EXPECT_EQ(runs, 10);
+  EXPECT_TRUE(executor.InShutdown());
+  EXPECT_FALSE(executor.DoSubmit([]() {}));
+}
+
+TEST(MultiThreadExecutorTest, ShutdownFromOwnTask) {
+  auto executor = std::make_unique<MultiThreadExecutor>(1);
+  absl::Notification done;
+
+  executor->Execute([&executor, &done]() {
+    executor->Shutdown();
+    done.Notify();
+  });
+
+  EXPECT_TRUE(done.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  executor.reset();
+}
+
+TEST(ScheduledExecutorTest, RunsTaskAfterDelay) {
+  ScheduledExecutor executor;
+  absl::Notification ran;
+  absl::Time start = absl::Now();
+  absl::Time ran_at;
+
+  executor.Schedule(
+      [&ran, &ran_at]() {
+        ran_at = absl::Now();
+        ran.Notify();
+      },
+      absl::Milliseconds(50));
+
+  EXPECT_TRUE(ran.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  EXPECT_GE(ran_at - start, absl::Milliseconds(50));
+}
+
+TEST(ScheduledExecutorTest, RunsTasksInDeadlineOrder) {
+  ScheduledExecutor executor;
+  absl::BlockingCounter ran(3);
+  std::vector<int> order;
+
+  for (int i : {3, 1, 2}) {
+    executor.Schedule(
+        [&ran, &order, i]() {
+          order.push_back(i);
+          ran.DecrementCount();
+        },
+        absl::Milliseconds(20 * i));
+  }
+
+  ran.Wait();
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(ScheduledExecutorTest, CancelledTaskDoesNotRun) {
+  ScheduledExecutor executor;
+  std::atomic_bool ran = false;
+
+  auto cancelable =
+      executor.Schedule([&ran]() { ran = true; }, absl::Milliseconds(50));
+
+  EXPECT_TRUE(cancelable->Cancel());
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_FALSE(ran);
+  EXPECT_FALSE(cancelable->Cancel());
+}
+
+TEST(ScheduledExecutorTest, ShutdownDropsPendingTasks) {
+  std::atomic_bool ran = false;
+  {
+    ScheduledExecutor executor;
+    executor.Schedule([&ran]() { ran = true; }, absl::Seconds(10));
+    executor.Shutdown();
+  }
+
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
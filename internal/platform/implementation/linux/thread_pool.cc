@@ -0,0 +1,79 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/thread_pool.h"
+
+#include <utility>
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+ThreadPool::ThreadPool(int num_threads) : state_(std::make_shared<State>()) {
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(&ThreadPool::RunTasks, state_);
+  }
+}
+
+ThreadPool::~ThreadPool() { Shutdown(); }
+
+bool ThreadPool::Schedule(Runnable&& runnable) {
+  absl::MutexLock lock(&state_->mutex);
+  if (state_->shutdown) return false;
+  state_->tasks.push_back(std::move(runnable));
+  return true;
+}
+
+void ThreadPool::Shutdown() {
+  {
+    absl::MutexLock lock(&state_->mutex);
+    state_->shutdown = true;
+  }
+  for (auto& thread : threads_) {
+    if (!thread.joinable()) continue;
+    if (thread.get_id() == std::this_thread::get_id()) {
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+}
+
+bool ThreadPool::InShutdown() const {
+  absl::MutexLock lock(&state_->mutex);
+  return state_->shutdown;
+}
+
+void ThreadPool::RunTasks(std::shared_ptr<State> state) {
+  while (true) {
+    Runnable task;
+    {
+      absl::MutexLock lock(&state->mutex);
+      state->mutex.Await(absl::Condition(
+          +[](State* state) ABSL_EXCLUSIVE_LOCKS_REQUIRED(state->mutex) {
+            return state->shutdown || !state->tasks.empty();
+          },
+          state.get()));
+      // Queued tasks still run after shutdown; only new ones are refused.
+      if (state->tasks.empty()) return;
+      task = std::move(state->tasks.front());
+      state->tasks.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
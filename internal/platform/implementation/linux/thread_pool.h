@@ -0,0 +1,66 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_THREAD_POOL_H_
+#define PLATFORM_IMPL_LINUX_THREAD_POOL_H_
+
+#include <deque>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "internal/platform/runnable.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// A fixed number of threads running tasks off a shared, unbounded FIFO queue.
+//
+// Threads are started by the constructor. Shutdown() stops accepting tasks,
+// lets the queued ones run, and joins the threads. It may be called from one
+// of the pool's own tasks; that thread is then left to finish on its own.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Returns false, dropping |runnable|, once the pool is shutting down.
+  bool Schedule(Runnable&& runnable);
+  void Shutdown();
+  bool InShutdown() const;
+
+ private:
+  // Shared with the threads, so that a thread that shut its own pool down
+  // does not outlive what it is using.
+  struct State {
+    mutable absl::Mutex mutex;
+    std::deque<Runnable> tasks ABSL_GUARDED_BY(mutex);
+    bool shutdown ABSL_GUARDED_BY(mutex) = false;
+  };
+
+  static void RunTasks(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> state_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_THREAD_POOL_H_
@@ -0,0 +1,593 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/wifi_lan.h"
+
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/macros.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/clock.h"
+#include "internal/platform/logging.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+namespace {
+
+constexpr char kRegistryDirName[] = "nearby_wifi_lan";
+constexpr char kDefaultIpAddress[] = "127.0.0.1";
+constexpr int kListenBacklog = 16;
+constexpr absl::Duration kConnectPollInterval = absl::Milliseconds(100);
+
+std::string GetEnvOr(const char* name, const std::string& default_value) {
+  const char* value = getenv(name);
+  return value != nullptr && *value != '\0' ? value : default_value;
+}
+
+// The registry lives in the user's runtime directory, or in a directory of
+// the user's own under /tmp.
+std::string GetDefaultRegistryDir() {
+  const char* runtime_dir = getenv("XDG_RUNTIME_DIR");
+  if (runtime_dir != nullptr && *runtime_dir != '\0') {
+    return absl::StrCat(runtime_dir, "/", kRegistryDirName);
+  }
+  return absl::StrCat("/tmp/", kRegistryDirName, "-", getuid());
+}
+
+// Creates |dir| if needed. Returns false unless it is a directory that only
+// this user can write to: anyone else who could would be able to plant
+// advertisements in it.
+bool MakePrivateDir(const std::string& dir) {
+  if (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return false;
+  struct stat info;
+  return lstat(dir.c_str(), &info) == 0 && S_ISDIR(info.st_mode) &&
+         info.st_uid == getuid() && (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+// Returns the address as 4 bytes in network order, or an empty string.
+std::string ToIpAddressBytes(const std::string& dotted_address) {
+  in_addr address;
+  if (inet_pton(AF_INET, dotted_address.c_str(), &address) != 1) return {};
+  return std::string(reinterpret_cast<const char*>(&address), sizeof(address));
+}
+
+std::string GetHostName() {
+  char host_name[HOST_NAME_MAX + 1] = {};
+  gethostname(host_name, sizeof(host_name) - 1);
+  return host_name;
+}
+
+void SetNoDelay(int fd) {
+  int enable = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+}
+
+std::string SerializeServiceInfo(const NsdServiceInfo& info) {
+  std::ostringstream out;
+  out << "name " << absl::BytesToHexString(info.GetServiceName()) << "\n"
+      << "type " << absl::BytesToHexString(info.GetServiceType()) << "\n"
+      << "ip " << absl::BytesToHexString(info.GetIPAddress()) << "\n"
+      << "port " << info.GetPort() << "\n"
+      << "host " << GetHostName() << "\n"
+      << "pid " << getpid() << "\n";
+  for (const auto& record : info.GetTxtRecords()) {
+    out << "txt " << absl::BytesToHexString(record.first) << " "
+        << absl::BytesToHexString(record.second) << "\n";
+  }
+  return out.str();
+}
+
+// Returns an invalid NsdServiceInfo if |path| can not be parsed, or was
+// written by a process on this host that is gone.
+NsdServiceInfo ReadServiceInfo(const std::string& path) {
+  std::ifstream in(path);
+  NsdServiceInfo info;
+  info.SetPort(0);
+  std::string host;
+  int pid = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    std::vector<std::string> fields = absl::StrSplit(line, ' ');
+    if (fields.size() == 2) {
+      if (fields[0] == "name") {
+        info.SetServiceName(absl::HexStringToBytes(fields[1]));
+      } else if (fields[0] == "type") {
+        info.SetServiceType(absl::HexStringToBytes(fields[1]));
+      } else if (fields[0] == "ip") {
+        info.SetIPAddress(absl::HexStringToBytes(fields[1]));
+      } else if (fields[0] == "port") {
+        int port = 0;
+        if (absl::SimpleAtoi(fields[1], &port)) info.SetPort(port);
+      } else if (fields[0] == "host") {
+        host = fields[1];
+      } else if (fields[0] == "pid") {
+        if (!absl::SimpleAtoi(fields[1], &pid)) pid = 0;
+      }
+    } else if (fields.size() == 3 && fields[0] == "txt") {
+      info.SetTxtRecord(absl::HexStringToBytes(fields[1]),
+                        absl::HexStringToBytes(fields[2]));
+    }
+  }
+  if (host == GetHostName() && pid > 0 && kill(pid, 0) != 0 &&
+      errno == ESRCH) {
+    return {};
+  }
+  return info;
+}
+
+// Calls the readiness listeners of sockets, from one thread that waits on all
+// of them with epoll. Sockets are watched edge-triggered: a listener is called
+// when data arrives, not for as long as there is data to read.
+class ReadinessWatcher {
+ public:
+  // Never destroyed: sockets may be closed during static destruction.
+  static ReadinessWatcher& Get() {
+    static ReadinessWatcher* watcher = new ReadinessWatcher();
+    return *watcher;
+  }
+
+  bool Watch(int fd, std::function<void()> listener)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    if (epoll_fd_ < 0) return false;
+    absl::MutexLock lock(&mutex_);
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.fd = fd;
+    bool watched = listeners_.contains(fd);
+    if (epoll_ctl(epoll_fd_, watched ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd,
+                  &event) != 0) {
+      return false;
+    }
+    listeners_[fd] = std::move(listener);
+    return true;
+  }
+
+  // Once this returns, the listener of |fd| is not running, and is not
+  // called again.
+  void Unwatch(int fd) ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    if (listeners_.erase(fd) == 0) return;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  }
+
+ private:
+  ReadinessWatcher() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {
+    if (epoll_fd_ < 0) {
+      NEARBY_LOGS(ERROR) << "WifiLan can not create an epoll instance: "
+                         << strerror(errno);
+      return;
+    }
+    std::thread(&ReadinessWatcher::Run, this).detach();
+  }
+
+  void Run() {
+    epoll_event events[64];
+    while (true) {
+      int count = epoll_wait(epoll_fd_, events, ABSL_ARRAYSIZE(events), -1);
+      if (count < 0) {
+        if (errno == EINTR) continue;
+        NEARBY_LOGS(ERROR) << "WifiLan stops watching sockets: "
+                           << strerror(errno);
+        return;
+      }
+      for (int i = 0; i < count; ++i) {
+        // Listeners are called under the lock, so that Unwatch() can wait for
+        // them. An event for a descriptor that was unwatched, and reused, in
+        // the meantime only makes a spurious call.
+        absl::MutexLock lock(&mutex_);
+        auto item = listeners_.find(events[i].data.fd);
+        if (item != listeners_.end()) item->second();
+      }
+    }
+  }
+
+  const int epoll_fd_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<int, std::function<void()>> listeners_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+constexpr absl::Duration WifiLanMedium::kDiscoveryInterval;
+constexpr absl::Duration WifiLanMedium::kConnectTimeout;
+
+// WifiLanSocket
+
+WifiLanSocket::WifiLanSocket(int fd) : fd_(fd) {}
+
+WifiLanSocket::~WifiLanSocket() {
+  Close();
+  // The descriptor must not be watched once it can be reused.
+  ReadinessWatcher::Get().Unwatch(fd_);
+  close(fd_);
+}
+
+Exception WifiLanSocket::Close() {
+  if (shutdown(fd_, SHUT_RDWR) != 0 && errno != ENOTCONN) {
+    return {Exception::kIo};
+  }
+  return {Exception::kSuccess};
+}
+
+ExceptionOr<ByteArray> WifiLanSocket::SocketInputStream::Read(
+    std::int64_t size) {
+  if (size <= 0) return ExceptionOr<ByteArray>(ByteArray());
+  ByteArray buffer(static_cast<size_t>(size));
+  ssize_t result;
+  do {
+    result = recv(socket_->fd_, buffer.data(), buffer.size(), 0);
+  } while (result < 0 && errno == EINTR);
+  // A closed connection is an error to the caller; it expected more data.
+  if (result <= 0) return {Exception::kIo};
+  if (result == size) return ExceptionOr<ByteArray>(std::move(buffer));
+  return ExceptionOr<ByteArray>(buffer.Slice(0, result));
+}
+
+bool WifiLanSocket::SocketInputStream::IsReadable() {
+  pollfd poll_fd{};
+  poll_fd.fd = socket_->fd_;
+  poll_fd.events = POLLIN;
+  int result;
+  do {
+    result = poll(&poll_fd, 1, 0);
+  } while (result < 0 && errno == EINTR);
+  // Errors and hang-ups count too: Read() fails right away on them.
+  return result > 0;
+}
+
+bool WifiLanSocket::SocketInputStream::SetReadinessListener(
+    std::function<void()> listener) {
+  if (listener == nullptr) {
+    ReadinessWatcher::Get().Unwatch(socket_->fd_);
+    return true;
+  }
+  return ReadinessWatcher::Get().Watch(socket_->fd_, std::move(listener));
+}
+
+Exception WifiLanSocket::SocketOutputStream::Write(const ByteArray& data) {
+  return WriteV({data});
+}
+
+Exception WifiLanSocket::SocketOutputStream::WriteV(
+    const std::vector<ByteArray>& data) {
+  std::vector<iovec> iovecs;
+  iovecs.reserve(data.size());
+  for (const auto& part : data) {
+    if (part.Empty()) continue;
+    iovecs.push_back({const_cast<char*>(part.data()), part.size()});
+  }
+  size_t next = 0;
+  while (next < iovecs.size()) {
+    msghdr message = {};
+    message.msg_iov = &iovecs[next];
+    message.msg_iovlen = std::min<size_t>(iovecs.size() - next, IOV_MAX);
+    ssize_t written = sendmsg(socket_->fd_, &message, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return {Exception::kIo};
+    }
+    // Skip over what was written; the rest of a partly written buffer goes
+    // out with the next call.
+    while (next < iovecs.size() &&
+           static_cast<size_t>(written) >= iovecs[next].iov_len) {
+      written -= iovecs[next].iov_len;
+      ++next;
+    }
+    if (written > 0) {
+      iovecs[next].iov_base = static_cast<char*>(iovecs[next].iov_base) +
+                              written;
+      iovecs[next].iov_len -= written;
+    }
+  }
+  return {Exception::kSuccess};
+}
+
+// WifiLanServerSocket
+
+WifiLanServerSocket::WifiLanServerSocket(int fd, std::string ip_address,
+                                         int port)
+    : fd_(fd), ip_address_(std::move(ip_address)), port_(port) {}
+
+WifiLanServerSocket::~WifiLanServerSocket() {
+  Close();
+  close(fd_);
+}
+
+std::unique_ptr<api::WifiLanSocket> WifiLanServerSocket::Accept() {
+  int fd;
+  do {
+    fd = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+  } while (fd < 0 && (errno == EINTR || errno == ECONNABORTED));
+  if (fd < 0) return nullptr;
+  SetNoDelay(fd);
+  return std::make_unique<WifiLanSocket>(fd);
+}
+
+Exception WifiLanServerSocket::Close() {
+  // Wakes up a blocked Accept().
+  shutdown(fd_, SHUT_RDWR);
+  return {Exception::kSuccess};
+}
+
+// WifiLanMedium
+
+WifiLanMedium::WifiLanMedium()
+    : registry_dir_(
+          GetEnvOr("NEARBY_WIFI_LAN_REGISTRY_DIR", GetDefaultRegistryDir())),
+      registry_usable_(MakePrivateDir(registry_dir_)),
+      ip_address_(ToIpAddressBytes(
+          GetEnvOr("NEARBY_WIFI_LAN_ADDRESS", kDefaultIpAddress))) {
+  if (!registry_usable_) {
+    NEARBY_LOGS(ERROR) << "WifiLan registry " << registry_dir_
+                       << " is not a directory private to this user; "
+                          "advertising and discovery are disabled";
+  }
+}
+
+WifiLanMedium::~WifiLanMedium() {
+  scan_executor_.Shutdown();
+  absl::MutexLock lock(&mutex_);
+  for (const auto& advertisement : advertisements_) {
+    unlink(advertisement.second.c_str());
+  }
+}
+
+std::string WifiLanMedium::GetRegistryPath(
+    const std::string& service_type, const std::string& service_name) const {
+  return absl::StrCat(registry_dir_, "/", absl::BytesToHexString(service_type),
+                      "-", absl::BytesToHexString(service_name));
+}
+
+bool WifiLanMedium::StartAdvertising(const NsdServiceInfo& nsd_service_info) {
+  if (!registry_usable_) return false;
+  const std::string service_type = nsd_service_info.GetServiceType();
+  std::string path =
+      GetRegistryPath(service_type, nsd_service_info.GetServiceName());
+  absl::MutexLock lock(&mutex_);
+  if (advertisements_.contains(service_type)) {
+    NEARBY_LOGS(WARNING) << "WifiLan is already advertising service type "
+                         << service_type;
+    return false;
+  }
+  // Written aside and renamed into place, so that scans never see a partly
+  // written file.
+  std::string temp_path = absl::StrCat(path, ".tmp");
+  {
+    std::ofstream out(temp_path, std::ios::trunc);
+    out << SerializeServiceInfo(nsd_service_info);
+    if (!out) return false;
+  }
+  if (rename(temp_path.c_str(), path.c_str()) != 0) {
+    unlink(temp_path.c_str());
+    return false;
+  }
+  advertisements_.emplace(service_type, path);
+  return true;
+}
+
+bool WifiLanMedium::StopAdvertising(const NsdServiceInfo& nsd_service_info) {
+  absl::MutexLock lock(&mutex_);
+  auto item = advertisements_.find(nsd_service_info.GetServiceType());
+  if (item == advertisements_.end()) return false;
+  unlink(item->second.c_str());
+  advertisements_.erase(item);
+  return true;
+}
+
+bool WifiLanMedium::StartDiscovery(const std::string& service_type,
+                                   DiscoveredServiceCallback callback) {
+  if (!registry_usable_) return false;
+  absl::MutexLock lock(&mutex_);
+  if (discoveries_.contains(service_type)) return false;
+  discoveries_.emplace(service_type, Discovery{std::move(callback), {}});
+  if (!scan_scheduled_) {
+    scan_scheduled_ = true;
+    scan_executor_.Execute([this]() { ScanRegistry(); });
+  }
+  return true;
+}
+
+bool WifiLanMedium::StopDiscovery(const std::string& service_type) {
+  absl::MutexLock lock(&mutex_);
+  return discoveries_.erase(service_type) > 0;
+}
+
+void WifiLanMedium::ScanRegistry() {
+  // The files are read without holding mutex_, so that advertising and
+  // discovery calls do not wait for the file system.
+  std::vector<std::string> prefixes;
+  absl::flat_hash_set<std::string> own_paths;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (const auto& item : discoveries_) {
+      prefixes.push_back(absl::StrCat(absl::BytesToHexString(item.first), "-"));
+    }
+    for (const auto& advertisement : advertisements_) {
+      own_paths.insert(advertisement.second);
+    }
+  }
+
+  absl::flat_hash_map<std::string, NsdServiceInfo> found;
+  if (DIR* dir = opendir(registry_dir_.c_str())) {
+    while (dirent* entry = readdir(dir)) {
+      std::string file_name = entry->d_name;
+      if (file_name[0] == '.' || absl::EndsWith(file_name, ".tmp")) continue;
+      bool wanted = std::any_of(prefixes.begin(), prefixes.end(),
+                                [&file_name](const std::string& prefix) {
+                                  return absl::StartsWith(file_name, prefix);
+                                });
+      std::string path = absl::StrCat(registry_dir_, "/", file_name);
+      if (!wanted || own_paths.contains(path)) continue;
+      NsdServiceInfo info = ReadServiceInfo(path);
+      if (info.IsValid()) found.emplace(std::move(file_name), std::move(info));
+    }
+    closedir(dir);
+  }
+
+  std::vector<std::function<void()>> events;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (auto& item : discoveries_) {
+      const std::string prefix =
+          absl::StrCat(absl::BytesToHexString(item.first), "-");
+      Discovery& discovery = item.second;
+      absl::flat_hash_map<std::string, NsdServiceInfo> services;
+      for (const auto& service : found) {
+        const std::string& file_name = service.first;
+        if (!absl::StartsWith(file_name, prefix)) continue;
+        // Advertising may have started since the files were listed.
+        std::string path = absl::StrCat(registry_dir_, "/", file_name);
+        bool own = std::any_of(
+            advertisements_.begin(), advertisements_.end(),
+            [&path](const auto& advertisement) {
+              return advertisement.second == path;
+            });
+        if (own) continue;
+        if (!discovery.services.contains(file_name)) {
+          events.push_back([callback = discovery.callback.service_discovered_cb,
+                            info = service.second]() { callback(info); });
+        }
+        services.emplace(file_name, service.second);
+      }
+      for (const auto& service : discovery.services) {
+        if (!services.contains(service.first)) {
+          events.push_back([callback = discovery.callback.service_lost_cb,
+                            info = service.second]() { callback(info); });
+        }
+      }
+      discovery.services = std::move(services);
+    }
+    if (discoveries_.empty()) {
+      scan_scheduled_ = false;
+    } else {
+      scan_executor_.Schedule([this]() { ScanRegistry(); },
+                              kDiscoveryInterval);
+    }
+  }
+  for (auto& event : events) event();
+}
+
+std::unique_ptr<api::WifiLanSocket> WifiLanMedium::ConnectToService(
+    const NsdServiceInfo& remote_service_info,
+    CancellationFlag* cancellation_flag) {
+  return ConnectToService(remote_service_info.GetIPAddress(),
+                          remote_service_info.GetPort(), cancellation_flag);
+}
+
+std::unique_ptr<api::WifiLanSocket> WifiLanMedium::ConnectToService(
+    const std::string& ip_address, int port,
+    CancellationFlag* cancellation_flag) {
+  if (ip_address.size() != sizeof(in_addr) || port <= 0) {
+    NEARBY_LOGS(ERROR) << "WifiLan can not connect to an invalid address";
+    return nullptr;
+  }
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  memcpy(&address.sin_addr, ip_address.data(), sizeof(in_addr));
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return nullptr;
+  int result =
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  if (result != 0 && errno != EINPROGRESS) {
+    close(fd);
+    return nullptr;
+  }
+  // Connect in the background, so that a cancellation is noticed.
+  absl::Time deadline = absl::Now() + kConnectTimeout;
+  while (result != 0) {
+    if ((cancellation_flag != nullptr && cancellation_flag->Cancelled()) ||
+        absl::Now() > deadline) {
+      close(fd);
+      return nullptr;
+    }
+    pollfd poll_fd = {fd, POLLOUT, 0};
+    int ready = poll(&poll_fd, 1,
+                     absl::ToInt64Milliseconds(kConnectPollInterval));
+    if (ready < 0 && errno != EINTR) break;
+    if (ready <= 0) continue;
+    int error = 0;
+    socklen_t error_size = sizeof(error);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_size);
+    if (error != 0) break;
+    result = 0;
+  }
+  if (result != 0) {
+    close(fd);
+    return nullptr;
+  }
+  // Back to blocking I/O for the streams.
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+  SetNoDelay(fd);
+  return std::make_unique<WifiLanSocket>(fd);
+}
+
+std::unique_ptr<api::WifiLanServerSocket> WifiLanMedium::ListenForService(
+    int port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return nullptr;
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  socklen_t address_size = sizeof(address);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&address), address_size) != 0 ||
+      listen(fd, kListenBacklog) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr*>(&address), &address_size) !=
+          0) {
+    NEARBY_LOGS(ERROR) << "WifiLan failed to listen on port " << port << ": "
+                       << strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  return std::make_unique<WifiLanServerSocket>(fd, ip_address_,
+                                               ntohs(address.sin_port));
+}
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
@@ -0,0 +1,181 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PLATFORM_IMPL_LINUX_WIFI_LAN_H_
+#define PLATFORM_IMPL_LINUX_WIFI_LAN_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/implementation/linux/scheduled_executor.h"
+#include "internal/platform/implementation/wifi_lan.h"
+#include "internal/platform/input_stream.h"
+#include "internal/platform/nsd_service_info.h"
+#include "internal/platform/output_stream.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+
+// A connected TCP socket.
+class WifiLanSocket : public api::WifiLanSocket {
+ public:
+  // Takes ownership of |fd|.
+  explicit WifiLanSocket(int fd);
+  ~WifiLanSocket() override;
+
+  InputStream& GetInputStream() override { return input_stream_; }
+  OutputStream& GetOutputStream() override { return output_stream_; }
+  // Shuts the connection down, failing reads and writes in progress. The
+  // descriptor itself is only released by the destructor, so that it cannot
+  // be reused while another thread is still about to use it.
+  Exception Close() override;
+
+ private:
+  class SocketInputStream : public InputStream {
+   public:
+    explicit SocketInputStream(WifiLanSocket* socket) : socket_(socket) {}
+    ExceptionOr<ByteArray> Read(std::int64_t size) override;
+    Exception Close() override { return socket_->Close(); }
+    bool IsReadable() override;
+    // The listener is called from a thread shared by all sockets.
+    bool SetReadinessListener(std::function<void()> listener) override;
+
+   private:
+    WifiLanSocket* socket_;
+  };
+
+  class SocketOutputStream : public OutputStream {
+   public:
+    explicit SocketOutputStream(WifiLanSocket* socket) : socket_(socket) {}
+    Exception Write(const ByteArray& data) override;
+    // Hands all of |data| to the kernel with as few sendmsg() calls as it
+    // takes.
+    Exception WriteV(const std::vector<ByteArray>& data) override;
+    Exception Flush() override { return {Exception::kSuccess}; }
+    Exception Close() override { return socket_->Close(); }
+
+   private:
+    WifiLanSocket* socket_;
+  };
+
+  const int fd_;
+  SocketInputStream input_stream_{this};
+  SocketOutputStream output_stream_{this};
+};
+
+// A listening TCP socket.
+class WifiLanServerSocket : public api::WifiLanServerSocket {
+ public:
+  // Takes ownership of |fd|. |ip_address| is what GetIPAddress() reports, in
+  // network order.
+  WifiLanServerSocket(int fd, std::string ip_address, int port);
+  ~WifiLanServerSocket() override;
+
+  std::string GetIPAddress() const override { return ip_address_; }
+  int GetPort() const override { return port_; }
+  std::unique_ptr<api::WifiLanSocket> Accept() override;
+  Exception Close() override;
+
+ private:
+  const int fd_;
+  const std::string ip_address_;
+  const int port_;
+};
+
+// WifiLan over real TCP sockets.
+//
+// Linux hosts are not expected to run an mDNS responder, so services are
+// "advertised" by writing them to a registry directory, and discovered by
+// polling it. The directory is $NEARBY_WIFI_LAN_REGISTRY_DIR, or
+// $XDG_RUNTIME_DIR/nearby_wifi_lan, or /tmp/nearby_wifi_lan-<uid>; processes
+// of the same user sharing it (on one host, or over a shared filesystem) see
+// each other. It must be writable by that user alone. The address put into
+// advertisements is $NEARBY_WIFI_LAN_ADDRESS, or 127.0.0.1.
+class WifiLanMedium : public api::WifiLanMedium {
+ public:
+  static constexpr absl::Duration kDiscoveryInterval = absl::Milliseconds(250);
+  static constexpr absl::Duration kConnectTimeout = absl::Seconds(10);
+
+  WifiLanMedium();
+  ~WifiLanMedium() override;
+
+  bool IsNetworkConnected() const override { return true; }
+
+  bool StartAdvertising(const NsdServiceInfo& nsd_service_info) override
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  bool StopAdvertising(const NsdServiceInfo& nsd_service_info) override
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  bool StartDiscovery(const std::string& service_type,
+                      DiscoveredServiceCallback callback) override
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  bool StopDiscovery(const std::string& service_type) override
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  std::unique_ptr<api::WifiLanSocket> ConnectToService(
+      const NsdServiceInfo& remote_service_info,
+      CancellationFlag* cancellation_flag) override;
+  std::unique_ptr<api::WifiLanSocket> ConnectToService(
+      const std::string& ip_address, int port,
+      CancellationFlag* cancellation_flag) override;
+
+  std::unique_ptr<api::WifiLanServerSocket> ListenForService(
+      int port) override;
+
+  absl::optional<std::pair<std::int32_t, std::int32_t>> GetDynamicPortRange()
+      override {
+    return absl::nullopt;
+  }
+
+ private:
+  struct Discovery {
+    DiscoveredServiceCallback callback;
+    // Services seen by the last scan, by registry file name.
+    absl::flat_hash_map<std::string, NsdServiceInfo> services;
+  };
+
+  std::string GetRegistryPath(const std::string& service_type,
+                              const std::string& service_name) const;
+  void ScanRegistry() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const std::string registry_dir_;
+  const bool registry_usable_;
+  const std::string ip_address_;
+
+  absl::Mutex mutex_;
+  // Registry files written by this medium, by service type.
+  absl::flat_hash_map<std::string, std::string> advertisements_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<std::string, Discovery> discoveries_
+      ABSL_GUARDED_BY(mutex_);
+  bool scan_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+  ScheduledExecutor scan_executor_;
+};
+
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
+
+#endif  // PLATFORM_IMPL_LINUX_WIFI_LAN_H_
@@ -0,0 +1,204 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "internal/platform/implementation/linux/wifi_lan.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/feature_flags.h"
+#include "internal/platform/nsd_service_info.h"
+
+namespace location {
+namespace nearby {
+namespace linux_platform {
+namespace {
+
+constexpr char kServiceType[] = "_FC9F5ED42C8A._tcp.";
+constexpr char kServiceName[] = "service name";
+
+class WifiLanMediumTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char registry_dir[] = "/tmp/wifi_lan_test.XXXXXX";
+    ASSERT_NE(mkdtemp(registry_dir), nullptr);
+    registry_dir_ = registry_dir;
+    setenv("NEARBY_WIFI_LAN_REGISTRY_DIR", registry_dir_.c_str(), 1);
+  }
+
+  void TearDown() override {
+    unsetenv("NEARBY_WIFI_LAN_REGISTRY_DIR");
+    rmdir(registry_dir_.c_str());
+  }
+
+  std::string registry_dir_;
+};
+
+TEST_F(WifiLanMediumTest, ConnectsOverLoopback) {
+  WifiLanMedium server_medium;
+  WifiLanMedium client_medium;
+  auto server_socket = server_medium.ListenForService(0);
+  ASSERT_NE(server_socket, nullptr);
+  EXPECT_GT(server_socket->GetPort(), 0);
+
+  std::unique_ptr<api::WifiLanSocket> accepted;
+  std::thread acceptor(
+      [&server_socket, &accepted]() { accepted = server_socket->Accept(); });
+  CancellationFlag flag;
+  auto client = client_medium.ConnectToService(
+      server_socket->GetIPAddress(), server_socket->GetPort(), &flag);
+  acceptor.join();
+  ASSERT_NE(client, nullptr);
+  ASSERT_NE(accepted, nullptr);
+
+  EXPECT_TRUE(client->GetOutputStream()
+                  .WriteV({ByteArray("ab"), ByteArray("cd")})
+                  .Ok());
+  std::string received;
+  while (received.size() < 4) {
+    ExceptionOr<ByteArray> data = accepted->GetInputStream().Read(4);
+    ASSERT_TRUE(data.ok());
+    received += std::string(data.result());
+  }
+  EXPECT_EQ(received, "abcd");
+
+  client->Close();
+  EXPECT_FALSE(accepted->GetInputStream().Read(1).ok());
+}
+
+TEST_F(WifiLanMediumTest, SignalsReadinessWhenDataArrives) {
+  WifiLanMedium medium;
+  auto server_socket = medium.ListenForService(0);
+  ASSERT_NE(server_socket, nullptr);
+  std::unique_ptr<api::WifiLanSocket> accepted;
+  std::thread acceptor(
+      [&server_socket, &accepted]() { accepted = server_socket->Accept(); });
+  CancellationFlag flag;
+  auto client = medium.ConnectToService(server_socket->GetIPAddress(),
+                                        server_socket->GetPort(), &flag);
+  acceptor.join();
+  ASSERT_NE(client, nullptr);
+  ASSERT_NE(accepted, nullptr);
+  InputStream& input = accepted->GetInputStream();
+  absl::Notification readable;
+
+  ASSERT_TRUE(input.SetReadinessListener([&readable]() {
+    if (!readable.HasBeenNotified()) readable.Notify();
+  }));
+  EXPECT_FALSE(input.IsReadable());
+  EXPECT_TRUE(client->GetOutputStream().Write(ByteArray("data")).Ok());
+
+  EXPECT_TRUE(readable.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  EXPECT_TRUE(input.IsReadable());
+  EXPECT_TRUE(input.SetReadinessListener(nullptr));
+}
+
+TEST_F(WifiLanMediumTest, CloseUnblocksAccept) {
+  WifiLanMedium medium;
+  auto server_socket = medium.ListenForService(0);
+  ASSERT_NE(server_socket, nullptr);
+  absl::Notification accept_returned;
+
+  std::thread acceptor([&server_socket, &accept_returned]() {
+    EXPECT_EQ(server_socket->Accept(), nullptr);
+    accept_returned.Notify();
+  });
+  server_socket->Close();
+
+  EXPECT_TRUE(
+      accept_returned.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  acceptor.join();
+}
+
+TEST_F(WifiLanMediumTest, CancelledConnectFails) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_cancellation_flag = true;
+  WifiLanMedium medium;
+  CancellationFlag flag(true);
+
+  // A non-routable address; only the cancellation can end the attempt early.
+  EXPECT_EQ(medium.ConnectToService(std::string("\x0a\xff\xff\x01", 4), 1234,
+                                    &flag),
+            nullptr);
+  FeatureFlags::GetMutableFlagsForTesting().enable_cancellation_flag = false;
+}
+
+TEST_F(WifiLanMediumTest, DiscoversAndLosesAdvertisedService) {
+  WifiLanMedium advertiser;
+  WifiLanMedium discoverer;
+  NsdServiceInfo advertised;
+  advertised.SetServiceName(kServiceName);
+  advertised.SetServiceType(kServiceType);
+  advertised.SetIPAddress(std::string("\x7f\x00\x00\x01", 4));
+  advertised.SetPort(4321);
+  advertised.SetTxtRecord("key", "value");
+  absl::Notification found;
+  absl::Notification lost;
+  NsdServiceInfo discovered;
+
+  ASSERT_TRUE(advertiser.StartAdvertising(advertised));
+  ASSERT_TRUE(discoverer.StartDiscovery(
+      kServiceType,
+      {
+          .service_discovered_cb =
+              [&found, &discovered](NsdServiceInfo info) {
+                discovered = info;
+                found.Notify();
+              },
+          .service_lost_cb = [&lost](NsdServiceInfo) { lost.Notify(); },
+      }));
+
+  ASSERT_TRUE(found.WaitForNotificationWithTimeout(absl::Seconds(2)));
+  EXPECT_EQ(discovered.GetServiceName(), kServiceName);
+  EXPECT_EQ(discovered.GetIPAddress(), advertised.GetIPAddress());
+  EXPECT_EQ(discovered.GetPort(), 4321);
+  EXPECT_EQ(discovered.GetTxtRecord("key"), "value");
+
+  EXPECT_TRUE(advertiser.StopAdvertising(advertised));
+  EXPECT_TRUE(lost.WaitForNotificationWithTimeout(absl::Seconds(2)));
+  EXPECT_TRUE(discoverer.StopDiscovery(kServiceType));
+}
+
+TEST_F(WifiLanMediumTest, DoesNotDiscoverOwnAdvertisement) {
+  WifiLanMedium medium;
+  NsdServiceInfo advertised;
+  advertised.SetServiceName(kServiceName);
+  advertised.SetServiceType(kServiceType);
+  advertised.SetPort(4321);
+  absl::Notification found;
+
+  ASSERT_TRUE(medium.StartAdvertising(advertised));
+  ASSERT_TRUE(medium.StartDiscovery(
+      kServiceType, {
+                        .service_discovered_cb =
+                            [&found](NsdServiceInfo) { found.Notify(); },
+                    }));
+
+  EXPECT_FALSE(found.WaitForNotificationWithTimeout(
+      3 * WifiLanMedium::kDiscoveryInterval));
+  medium.StopDiscovery(kServiceType);
+  medium.StopAdvertising(advertised);
+}
+
+}  // namespace
+}  // namespace linux_platform
+}  // namespace nearby
+}  // namespace location
@@ -72,6 +72,14 @@ class ImplementationPlatform {
 
   static std::string GetAppDataPath(absl::string_view file_name);
 
+  // Renames the file at |from_path| to |to_path|, replacing the file there,
+  // if any. Returns false on failure.
+  static bool RenameFile(absl::string_view from_path,
+                         absl::string_view to_path);
+
+  // Deletes the file at |file_path|. Returns false on failure.
+  static bool RemoveFile(absl::string_view file_path);
+
   static OSName GetCurrentOS();
 
   // Atomics:
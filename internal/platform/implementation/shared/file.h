@@ -36,6 +36,9 @@ class IOFile final : public api::InputFile, public api::OutputFile {
   static std::unique_ptr<IOFile> CreateOutputFile(const absl::string_view path);
 
   ExceptionOr<ByteArray> Read(std::int64_t size) override;
+  // Seeks past |offset| bytes, up to the end of the file, instead of reading
+  // through them.
+  ExceptionOr<size_t> Skip(size_t offset) override;
 
   std::string GetFilePath() const override { return path_; }
 
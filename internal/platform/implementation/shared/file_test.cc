@@ -105,6 +105,25 @@ TEST_F(FileTest, IOFile_ReadWithSize) {
   AssertEmpty(io_file->Read(kMaxSize));
 }
 
+TEST_F(FileTest, IOFile_Skip) {
+  WriteToFile("abcdef");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  AssertEquals(io_file->Read(1), "a");
+  ExceptionOr<size_t> skip_result = io_file->Skip(3);
+  EXPECT_TRUE(skip_result.ok());
+  EXPECT_EQ(skip_result.result(), 3u);
+  AssertEquals(io_file->Read(kMaxSize), "ef");
+}
+
+TEST_F(FileTest, IOFile_SkipStopsAtEOF) {
+  WriteToFile("abc");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  ExceptionOr<size_t> skip_result = io_file->Skip(10);
+  EXPECT_TRUE(skip_result.ok());
+  EXPECT_EQ(skip_result.result(), 3u);
+  AssertEmpty(io_file->Read(kMaxSize));
+}
+
 TEST_F(FileTest, IOFile_GetTotalSize) {
   WriteToFile("abc");
   auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
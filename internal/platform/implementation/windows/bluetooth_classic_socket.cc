@@ -16,6 +16,7 @@
 
 #include <exception>
 #include <utility>
+#include <vector>
 
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Networking.Sockets.h"
 #include "internal/platform/implementation/windows/generated/winrt/base.h"
@@ -186,6 +187,34 @@ Exception BluetoothSocket::BluetoothOutputStream::Write(const ByteArray& data) {
   }
 }
 
+Exception BluetoothSocket::BluetoothOutputStream::WriteV(
+    const std::vector<ByteArray>& data) {
+  try {
+    if (winrt_stream_ == nullptr) {
+      return {Exception::kIo};
+    }
+
+    // Gather all parts into one buffer, so that they go out in a single write.
+    size_t size = 0;
+    for (const auto& part : data) size += part.size();
+    Buffer buffer = Buffer(size);
+    size_t offset = 0;
+    for (const auto& part : data) {
+      std::memcpy(buffer.data() + offset, part.data(), part.size());
+      offset += part.size();
+    }
+    buffer.Length(size);
+
+    winrt_stream_.WriteAsync(buffer).get();
+    return {Exception::kSuccess};
+  } catch (winrt::hresult_error const& ex) {
+    NEARBY_LOGS(ERROR) << __func__ << ": winrt exception: " << ex.code() << ": "
+                       << winrt::to_string(ex.message());
+
+    return {Exception::kIo};
+  }
+}
+
 Exception BluetoothSocket::BluetoothOutputStream::Flush() {
   try {
     if (winrt_stream_ == nullptr) {
@@ -15,6 +15,8 @@
 #ifndef PLATFORM_IMPL_WINDOWS_BLUETOOTH_CLASSIC_SOCKET_H_
 #define PLATFORM_IMPL_WINDOWS_BLUETOOTH_CLASSIC_SOCKET_H_
 
+#include <vector>
+
 #include "internal/platform/implementation/bluetooth_classic.h"
 #include "internal/platform/implementation/windows/bluetooth_classic_device.h"
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Foundation.h"
@@ -118,6 +120,7 @@ class BluetoothSocket : public api::BluetoothSocket {
     ~BluetoothOutputStream() override = default;
 
     Exception Write(const ByteArray& data) override;
+    Exception WriteV(const std::vector<ByteArray>& data) override;
     Exception Flush() override;
 
     Exception Close() override;
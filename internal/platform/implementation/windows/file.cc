@@ -69,15 +69,34 @@ ExceptionOr<ByteArray> IOFile::Read(std::int64_t size) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
 
+  // Read straight into the returned buffer; a short read at the end of the
+  // file is returned as a slice of it.
   ByteArray bytes(size);
-  std::unique_ptr<char[]> read_bytes{new char[size]};
-  file_.read(read_bytes.get(), static_cast<ptrdiff_t>(size));
+  file_.read(bytes.data(), static_cast<ptrdiff_t>(size));
   auto num_bytes_read = file_.gcount();
   if (num_bytes_read == 0) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
 
-  return ExceptionOr<ByteArray>(ByteArray(read_bytes.get(), num_bytes_read));
+  return ExceptionOr<ByteArray>(bytes.Slice(0, num_bytes_read));
+}
+
+ExceptionOr<size_t> IOFile::Skip(size_t offset) {
+  if (!file_.is_open() || !file_.good()) {
+    return ExceptionOr<size_t>{Exception::kIo};
+  }
+
+  std::int64_t position = file_.tellg();
+  if (position < 0) {
+    return ExceptionOr<size_t>{Exception::kIo};
+  }
+  std::int64_t remaining = std::max<std::int64_t>(total_size_ - position, 0);
+  std::int64_t skipped = std::min(static_cast<std::int64_t>(offset), remaining);
+  file_.seekg(skipped, std::ios::cur);
+  if (!file_.good()) {
+    return ExceptionOr<size_t>{Exception::kIo};
+  }
+  return ExceptionOr<size_t>(static_cast<size_t>(skipped));
 }
 
 Exception IOFile::Close() {
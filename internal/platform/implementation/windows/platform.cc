@@ -284,6 +284,18 @@ std::string ImplementationPlatform::GetAppDataPath(
   return path.str();
 }
 
+bool ImplementationPlatform::RenameFile(absl::string_view from_path,
+                                        absl::string_view to_path) {
+  // Unlike std::rename(), replaces the file at |to_path|.
+  return MoveFileExA(std::string(from_path).c_str(),
+                     std::string(to_path).c_str(),
+                     MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+bool ImplementationPlatform::RemoveFile(absl::string_view file_path) {
+  return DeleteFileA(std::string(file_path).c_str()) != 0;
+}
+
 OSName ImplementationPlatform::GetCurrentOS() { return OSName::kWindows; }
 
 std::unique_ptr<AtomicBoolean> ImplementationPlatform::CreateAtomicBoolean(
@@ -23,6 +23,7 @@
 #include <functional>
 #include <optional>
 #include <string>
+#include <vector>
 
 // Nearby connections headers
 #include "internal/platform/implementation/wifi_hotspot.h"
@@ -144,6 +145,7 @@ class WifiHotspotSocket : public api::WifiHotspotSocket {
     ~SocketOutputStream() override = default;
 
     Exception Write(const ByteArray& data) override;
+    Exception WriteV(const std::vector<ByteArray>& data) override;
     Exception Flush() override;
     Exception Close() override;
 
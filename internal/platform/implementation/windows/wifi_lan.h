@@ -24,6 +24,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Nearby connections headers
 #include "absl/base/thread_annotations.h"
@@ -131,6 +132,7 @@ class WifiLanSocket : public api::WifiLanSocket {
     ~SocketOutputStream() = default;
 
     Exception Write(const ByteArray& data) override;
+    Exception WriteV(const std::vector<ByteArray>& data) override;
     Exception Flush() override;
     Exception Close() override;
 
@@ -117,6 +117,28 @@ Exception WifiLanSocket::SocketOutputStream::Write(const ByteArray& data) {
   return {Exception::kSuccess};
 }
 
+Exception WifiLanSocket::SocketOutputStream::WriteV(
+    const std::vector<ByteArray>& data) {
+  // Gather all parts into one buffer, so that they go out in a single write.
+  size_t size = 0;
+  for (const auto& part : data) size += part.size();
+  Buffer buffer = Buffer(size);
+  size_t offset = 0;
+  for (const auto& part : data) {
+    std::memcpy(buffer.data() + offset, part.data(), part.size());
+    offset += part.size();
+  }
+  buffer.Length(size);
+
+  try {
+    output_stream_.WriteAsync(buffer).get();
+  } catch (...) {
+    return {Exception::kIo};
+  }
+
+  return {Exception::kSuccess};
+}
+
 Exception WifiLanSocket::SocketOutputStream::Flush() {
   try {
     output_stream_.FlushAsync().get();
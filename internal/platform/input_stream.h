@@ -16,6 +16,7 @@
 #define PLATFORM_BASE_INPUT_STREAM_H_
 
 #include <cstdint>
+#include <functional>
 
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
@@ -38,6 +39,22 @@ class InputStream {
 
   // throws Exception::kIo
   virtual Exception Close() = 0;
+
+  // Returns true if a subsequent Read() is guaranteed to return without
+  // blocking, because either data is buffered or the stream was closed.
+  // Streams which can not tell always return false.
+  virtual bool IsReadable() { return false; }
+
+  // Installs |listener| to be called every time the stream may have become
+  // readable (see IsReadable()). The listener is called from the thread that
+  // made the data available and must not block. Passing nullptr removes the
+  // listener; once that call returns, the previous listener is guaranteed not
+  // to be running.
+  // Returns false if the stream does not support readiness notifications, in
+  // which case the caller has to use blocking Read() calls.
+  virtual bool SetReadinessListener(std::function<void()> listener) {
+    return false;
+  }
 };
 
 }  // namespace nearby
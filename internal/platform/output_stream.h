@@ -15,6 +15,8 @@
 #ifndef PLATFORM_BASE_OUTPUT_STREAM_H_
 #define PLATFORM_BASE_OUTPUT_STREAM_H_
 
+#include <vector>
+
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 
@@ -29,6 +31,21 @@ class OutputStream {
   virtual ~OutputStream() = default;
 
   virtual Exception Write(const ByteArray& data) = 0;  // throws Exception::kIo
+
+  // Writes |data| in order, as if it were one contiguous buffer.
+  // throws Exception::kIo
+  //
+  // Streams that can hand several buffers to the transport in a single write
+  // should override this; by default the parts are written one at a time.
+  virtual Exception WriteV(const std::vector<ByteArray>& data) {
+    for (const auto& part : data) {
+      if (part.Empty()) continue;
+      Exception exception = Write(part);
+      if (exception.Raised()) return exception;
+    }
+    return {Exception::kSuccess};
+  }
+
   virtual Exception Flush() = 0;                       // throws Exception::kIo
   virtual Exception Close() = 0;                       // throws Exception::kIo
 };
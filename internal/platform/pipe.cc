@@ -25,10 +25,10 @@ namespace {
 using Platform = api::ImplementationPlatform;
 }
 
-Pipe::Pipe() {
+Pipe::Pipe(const Options& options) {
   auto mutex = Platform::CreateMutex(api::Mutex::Mode::kRegular);
   auto cond = Platform::CreateConditionVariable(mutex.get());
-  Setup(std::move(mutex), std::move(cond));
+  Setup(std::move(mutex), std::move(cond), options);
 }
 
 }  // namespace nearby
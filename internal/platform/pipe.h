@@ -24,7 +24,7 @@ namespace nearby {
 // http://google3/platform/base/base_pipe.h
 class Pipe final : public BasePipe {
  public:
-  Pipe();
+  explicit Pipe(const Options& options = {});
   ~Pipe() override = default;
   Pipe(Pipe&&) = delete;
   Pipe& operator=(Pipe&&) = delete;
@@ -154,6 +154,77 @@ TEST(PipeTest, RepeatedClose) {
   EXPECT_TRUE(input_stream.Close().Ok());
 }
 
+TEST(PipeTest, ReadinessListenerNotifiedOnWriteAndClose) {
+  Pipe pipe;
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+  int notifications = 0;
+
+  EXPECT_TRUE(input_stream.SetReadinessListener(
+      [&notifications]() { notifications++; }));
+  EXPECT_FALSE(input_stream.IsReadable());
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCD"))).Ok());
+  EXPECT_EQ(notifications, 1);
+  EXPECT_TRUE(input_stream.IsReadable());
+
+  EXPECT_TRUE(input_stream.Read(Pipe::kChunkSize).ok());
+  EXPECT_FALSE(input_stream.IsReadable());
+
+  // EOF is also a readable state, since Read() will not block.
+  EXPECT_TRUE(output_stream.Close().Ok());
+  EXPECT_EQ(notifications, 2);
+  EXPECT_TRUE(input_stream.IsReadable());
+}
+
+TEST(PipeTest, ReadinessListenerRemoved) {
+  Pipe pipe;
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+  int notifications = 0;
+
+  EXPECT_TRUE(input_stream.SetReadinessListener(
+      [&notifications]() { notifications++; }));
+  EXPECT_TRUE(input_stream.SetReadinessListener(nullptr));
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCD"))).Ok());
+  EXPECT_EQ(notifications, 0);
+  EXPECT_TRUE(input_stream.IsReadable());
+}
+
+TEST(PipeTest, WriteVQueuesAllPartsWithOneNotification) {
+  Pipe pipe;
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+  int notifications = 0;
+
+  EXPECT_TRUE(input_stream.SetReadinessListener(
+      [&notifications]() { notifications++; }));
+  EXPECT_TRUE(output_stream
+                  .WriteV({ByteArray(std::string("AB")), ByteArray(),
+                           ByteArray(std::string("CD"))})
+                  .Ok());
+  EXPECT_EQ(notifications, 1);
+
+  ExceptionOr<ByteArray> read_data = input_stream.Read(Pipe::kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "AB");
+  // The empty part is skipped rather than taken for the end of the stream.
+  read_data = input_stream.Read(Pipe::kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "CD");
+}
+
+TEST(PipeTest, WriteVAfterOutputStreamClosed) {
+  Pipe pipe;
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  output_stream.Close();
+
+  EXPECT_TRUE(output_stream.WriteV({ByteArray(std::string("AB"))})
+                  .Raised(Exception::kIo));
+}
+
 class Thread {
  public:
   Thread() : thread_(), attr_(), runnable_() {
@@ -181,6 +252,125 @@ class Thread {
   Runnable runnable_;
 };
 
+Pipe::Options BoundedOptions(size_t max_bytes, size_t max_chunks,
+                             absl::Duration write_timeout) {
+  Pipe::Options options;
+  options.max_bytes = max_bytes;
+  options.max_chunks = max_chunks;
+  options.write_timeout = write_timeout;
+  return options;
+}
+
+TEST(PipeTest, WriteToFullPipeTimesOut) {
+  Pipe pipe(BoundedOptions(4, 0, absl::Milliseconds(50)));
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCD"))).Ok());
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("E")))
+                  .Raised(Exception::kTimeout));
+}
+
+TEST(PipeTest, WriteToPipeWithTooManyChunksTimesOut) {
+  Pipe pipe(BoundedOptions(0, 2, absl::Milliseconds(50)));
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("A"))).Ok());
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("B"))).Ok());
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("C")))
+                  .Raised(Exception::kTimeout));
+  EXPECT_TRUE(output_stream.WriteV({ByteArray(std::string("C"))})
+                  .Raised(Exception::kTimeout));
+}
+
+TEST(PipeTest, OversizedWriteGoesThroughOnceDrained) {
+  Pipe pipe(BoundedOptions(4, 0, absl::Milliseconds(50)));
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCDEFGH"))).Ok());
+  EXPECT_EQ(std::string(input_stream.Read(2).result()), "AB");
+  // Still over the limit.
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("I")))
+                  .Raised(Exception::kTimeout));
+  EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()),
+            "CDEFGH");
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("IJKLMN"))).Ok());
+  EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()),
+            "IJKLMN");
+}
+
+TEST(PipeTest, WriteToFullPipeBlocksUntilRead) {
+  Pipe pipe(BoundedOptions(4, 0, absl::InfiniteDuration()));
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+  std::atomic_bool written = false;
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCD"))).Ok());
+  Thread writer;
+  writer.Start([&output_stream, &written]() {
+    EXPECT_TRUE(output_stream.Write(ByteArray(std::string("EF"))).Ok());
+    written = true;
+  });
+
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_FALSE(written);
+  EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()), "ABCD");
+  writer.Join();
+  EXPECT_TRUE(written);
+  EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()), "EF");
+}
+
+TEST(PipeTest, ClosingInputStreamUnblocksWriter) {
+  Pipe pipe(BoundedOptions(4, 0, absl::InfiniteDuration()));
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("ABCD"))).Ok());
+  Thread writer;
+  writer.Start([&output_stream]() {
+    EXPECT_TRUE(
+        output_stream.Write(ByteArray(std::string("EF"))).Raised(Exception::kIo));
+  });
+
+  absl::SleepFor(absl::Milliseconds(100));
+  pipe.GetInputStream().Close();
+  writer.Join();
+}
+
+TEST(PipeTest, CloseOfFullPipeIsNotHeldBack) {
+  Pipe pipe(BoundedOptions(0, 1, absl::Milliseconds(50)));
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  EXPECT_TRUE(output_stream.Write(ByteArray(std::string("AB"))).Ok());
+  EXPECT_TRUE(output_stream.Close().Ok());
+
+  EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()), "AB");
+  ExceptionOr<ByteArray> read_data = input_stream.Read(Pipe::kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_TRUE(read_data.result().Empty());
+}
+
+TEST(PipeTest, ManyChunksWrapAroundTheRing) {
+  Pipe pipe;
+  InputStream& input_stream{pipe.GetInputStream()};
+  OutputStream& output_stream{pipe.GetOutputStream()};
+
+  // Interleave writes and reads so the queue wraps around, and grows while
+  // wrapped.
+  int next_read = 0;
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(output_stream.Write(ByteArray(std::to_string(i))).Ok());
+    if (i % 3 == 0) {
+      EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()),
+                std::to_string(next_read++));
+    }
+  }
+  while (next_read < 100) {
+    EXPECT_EQ(std::string(input_stream.Read(Pipe::kChunkSize).result()),
+              std::to_string(next_read++));
+  }
+}
+
 TEST(PipeTest, ReadBlockedUntilWrite) {
   using CrossThreadBool = std::atomic_bool;
 